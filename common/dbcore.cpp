@@ -10,6 +10,7 @@
 #include <errmsg.h>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mysqld_error.h>
 #include <string.h>
 
@@ -41,6 +42,7 @@ DBcore::DBcore() {
 }
 
 DBcore::~DBcore() {
+	StopAsyncWorkers();
 	mysql_close(&mysql);
 	safe_delete_array(pHost);
 	safe_delete_array(pUser);
@@ -128,11 +130,93 @@ MySQLRequestResult DBcore::QueryDatabase(const char* query, uint32 querylen, boo
 	MySQLRequestResult requestResult(res, (uint32)mysql_affected_rows(&mysql), rowCount, (uint32)mysql_field_count(&mysql), (uint32)mysql_insert_id(&mysql));
 	
 	if (Log.log_settings[Logs::MySQLQuery].is_category_enabled == 1)
-		Log.Out(Logs::General, Logs::MySQLQuery, "%s (%u rows returned)", query, rowCount, requestResult.RowCount());
+		Log.Out(Logs::General, Logs::MySQLQuery, "%s (%u rows returned)", query, requestResult.RowCount());
 
 	return requestResult;
 }
 
+bool DBcore::StartAsyncWorkers(int count) {
+	if (count < 1 || !async_connections.empty() || !pHost)
+		return false;
+
+	for (int i = 0; i < count; ++i) {
+		DBcore *conn = new DBcore;
+		uint32 errnum = 0;
+		char errbuf[MYSQL_ERRMSG_SIZE];
+		if (!conn->Open(pHost, pUser, pPassword, pDatabase, pPort, &errnum, errbuf, pCompress, pSSL)) {
+			Log.Out(Logs::General, Logs::Error, "Unable to open async database connection %d: %s", i, errbuf);
+			delete conn;
+			break;
+		}
+		async_connections.push_back(conn);
+	}
+
+	if (async_connections.empty())
+		return false;
+
+	async_pool.Start((int)async_connections.size(),
+		[](int) { mysql_thread_init(); },
+		[](int) { mysql_thread_end(); });
+
+	Log.Out(Logs::General, Logs::Status, "Started %u async database workers", (uint32)async_connections.size());
+	return true;
+}
+
+void DBcore::StopAsyncWorkers() {
+	async_pool.Stop();
+
+	for (auto conn : async_connections)
+		delete conn;
+	async_connections.clear();
+}
+
+void DBcore::QueryDatabaseAsync(std::string query, uint32 order_key, AsyncQueryCallback callback) {
+	// the result is filled in on the worker and handed to the callback on our thread
+	std::shared_ptr<MySQLRequestResult> result = std::make_shared<MySQLRequestResult>();
+
+	async_pool.Queue(order_key,
+		[this, result, query](int worker) {
+			DBcore *conn = worker < 0 ? this : async_connections[worker];
+			*result = conn->QueryDatabase(query);
+		},
+		[result, callback]() {
+			if (callback)
+				callback(*result);
+		});
+}
+
+void DBcore::QueryDatabaseBatchAsync(std::vector<std::string> queries, uint32 order_key, AsyncQueryCallback callback) {
+	if (queries.empty())
+		return;
+
+	std::shared_ptr<MySQLRequestResult> result = std::make_shared<MySQLRequestResult>();
+	std::shared_ptr<std::vector<std::string>> batch = std::make_shared<std::vector<std::string>>(std::move(queries));
+
+	async_pool.Queue(order_key,
+		[this, result, batch](int worker) {
+			DBcore *conn = worker < 0 ? this : async_connections[worker];
+
+			if (batch->size() == 1) {
+				*result = conn->QueryDatabase(batch->front());
+				return;
+			}
+
+			conn->TransactionBegin();
+			for (auto &query : *batch) {
+				*result = conn->QueryDatabase(query);
+				if (!result->Success()) {
+					conn->TransactionRollback();
+					return;
+				}
+			}
+			conn->TransactionCommit();
+		},
+		[result, callback]() {
+			if (callback)
+				callback(*result);
+		});
+}
+
 void DBcore::TransactionBegin() {
 	QueryDatabase("START TRANSACTION");
 }
@@ -9,9 +9,12 @@
 #include "../common/mutex.h"
 #include "../common/mysql_request_result.h"
 #include "../common/types.h"
+#include "../common/worker_pool.h"
 
+#include <functional>
 #include <mysql.h>
 #include <string.h>
+#include <vector>
 
 class DBcore {
 public:
@@ -22,6 +25,22 @@ public:
 	eStatus	GetStatus() { return pStatus; }
 	MySQLRequestResult	QueryDatabase(const char* query, uint32 querylen, bool retryOnFailureOnce = true);
 	MySQLRequestResult	QueryDatabase(std::string query, bool retryOnFailureOnce = true);
+
+	/*
+		Async queries run on a pool of extra connections. The callback (if any) runs on the thread that
+		calls ProcessAsyncQueries. Queries with the same order key (a character id, say) run in the
+		order they were queued; key 0 means no ordering. Without workers they run right away.
+	*/
+	typedef std::function<void(MySQLRequestResult &)> AsyncQueryCallback;
+	bool	StartAsyncWorkers(int count);
+	void	StopAsyncWorkers();
+	void	QueryDatabaseAsync(std::string query, uint32 order_key = 0, AsyncQueryCallback callback = nullptr);
+	// runs the queries in one transaction, the callback gets the first failure or the last result
+	void	QueryDatabaseBatchAsync(std::vector<std::string> queries, uint32 order_key = 0, AsyncQueryCallback callback = nullptr);
+	uint32	ProcessAsyncQueries() { return async_pool.Process(); }
+	void	FlushAsyncQueries(uint32 order_key = 0) { async_pool.Flush(order_key); }
+	void	SetAsyncWakeup(EQEmu::EventWaiter *waiter) { async_pool.SetWakeup(waiter); }
+	int		GetAsyncWorkerCount() const { return async_pool.GetWorkerCount(); }
 	void TransactionBegin();
 	void TransactionCommit();
 	void TransactionRollback();
@@ -46,6 +65,8 @@ private:
 	uint32	pPort;
 	bool	pSSL;
 
+	EQEmu::WorkerPool async_pool;
+	std::vector<DBcore*> async_connections;
 };
 
 
@@ -29,6 +29,7 @@ tremendously.
 #include <string.h>
 
 #include "emu_tcp_connection.h"
+#include "event_waiter.h"
 #include "emu_tcp_server.h"
 #include "../common/servertalk.h"
 
@@ -48,7 +49,8 @@ tremendously.
 EmuTCPConnection::EmuTCPConnection(uint32 ID, EmuTCPServer* iServer, SOCKET in_socket, uint32 irIP, uint16 irPort, bool iOldFormat)
 :	TCPConnection(ID, in_socket, irIP, irPort),
 	keepalive_timer(SERVER_TIMEOUT),
-	timeout_timer(SERVER_TIMEOUT * 2)
+	timeout_timer(SERVER_TIMEOUT * 2),
+	wakeup(nullptr)
 {
 	id = 0;
 	Server = nullptr;
@@ -74,7 +76,8 @@ EmuTCPConnection::EmuTCPConnection(uint32 ID, EmuTCPServer* iServer, SOCKET in_s
 EmuTCPConnection::EmuTCPConnection(bool iOldFormat, EmuTCPServer* iRelayServer, eTCPMode iMode)
 :	TCPConnection(),
 	keepalive_timer(SERVER_TIMEOUT),
-	timeout_timer(SERVER_TIMEOUT * 2)
+	timeout_timer(SERVER_TIMEOUT * 2),
+	wakeup(nullptr)
 {
 	Server = iRelayServer;
 	if (Server)
@@ -96,7 +99,8 @@ EmuTCPConnection::EmuTCPConnection(bool iOldFormat, EmuTCPServer* iRelayServer,
 EmuTCPConnection::EmuTCPConnection(uint32 ID, EmuTCPServer* iServer, EmuTCPConnection* iRelayLink, uint32 iRemoteID, uint32 irIP, uint16 irPort)
 :	TCPConnection(ID, 0, irIP, irPort),
 	keepalive_timer(SERVER_TIMEOUT),
-	timeout_timer(SERVER_TIMEOUT * 2)
+	timeout_timer(SERVER_TIMEOUT * 2),
+	wakeup(nullptr)
 {
 	Server = iServer;
 	RelayLink = iRelayLink;
@@ -113,10 +117,16 @@ EmuTCPConnection::EmuTCPConnection(uint32 ID, EmuTCPServer* iServer, EmuTCPConne
 }
 
 EmuTCPConnection::~EmuTCPConnection() {
-	//the queues free their content right now I believe.
+	//stop the reactor before our part of the object goes away
+	ReactorDetach();
+
+	LockMutex lock(&MOutQueueLock);
+	ServerPacket* pack = 0;
+	while (OutQueue.Pop(pack))
+		safe_delete(pack);
 }
 
-EmuTCPNetPacket_Struct* EmuTCPConnection::MakePacket(ServerPacket* pack, uint32 iDestination) {
+static int32 FrameSize(ServerPacket* pack, uint32 iDestination) {
 	int32 size = sizeof(EmuTCPNetPacket_Struct) + pack->size;
 	if (pack->compressed) {
 		size += 4;
@@ -124,7 +134,10 @@ EmuTCPNetPacket_Struct* EmuTCPConnection::MakePacket(ServerPacket* pack, uint32
 	if (iDestination) {
 		size += 4;
 	}
-	EmuTCPNetPacket_Struct* tnps = (EmuTCPNetPacket_Struct*) new uchar[size];
+	return size;
+}
+
+static void WriteFrame(EmuTCPNetPacket_Struct* tnps, int32 size, ServerPacket* pack, uint32 iDestination) {
 	tnps->size = size;
 	tnps->opcode = pack->opcode;
 	*((uint8*) &tnps->flags) = 0;
@@ -139,10 +152,24 @@ EmuTCPNetPacket_Struct* EmuTCPConnection::MakePacket(ServerPacket* pack, uint32
 		*((int32*) buffer) = iDestination;
 		buffer += 4;
 	}
-	memcpy(buffer, pack->pBuffer, pack->size);
+	if (pack->size)
+		memcpy(buffer, pack->pBuffer, pack->size);
+}
+
+EmuTCPNetPacket_Struct* EmuTCPConnection::MakePacket(ServerPacket* pack, uint32 iDestination) {
+	int32 size = FrameSize(pack, iDestination);
+	EmuTCPNetPacket_Struct* tnps = (EmuTCPNetPacket_Struct*) new uchar[size];
+	WriteFrame(tnps, size, pack, iDestination);
 	return tnps;
 }
 
+EQEmu::PacketBuffer* EmuTCPConnection::MakeFrame(ServerPacket* pack, uint32 iDestination) {
+	int32 size = FrameSize(pack, iDestination);
+	EQEmu::PacketBuffer* frame = EQEmu::PacketBuffer::Create(size);
+	WriteFrame((EmuTCPNetPacket_Struct*) frame->Data(), size, pack, iDestination);
+	return frame;
+}
+
 SPackSendQueue* EmuTCPConnection::MakeOldPacket(ServerPacket* pack) {
 	SPackSendQueue* spsq = (SPackSendQueue*) new uchar[sizeof(SPackSendQueue) + pack->size + 4];
 	if (pack->pBuffer != 0 && pack->size != 0)
@@ -185,9 +212,8 @@ bool EmuTCPConnection::SendPacket(ServerPacket* pack, uint32 iDestination) {
 		safe_delete_array(spsq);
 	}
 	else {
-		EmuTCPNetPacket_Struct* tnps = MakePacket(pack, iDestination);
 		if (tmp == modeTransition) {
-			InModeQueuePush(tnps);
+			InModeQueuePush(MakePacket(pack, iDestination));
 		}
 		else {
 			#if TCPN_LOG_PACKETS >= 1
@@ -207,7 +233,9 @@ bool EmuTCPConnection::SendPacket(ServerPacket* pack, uint32 iDestination) {
 					#endif
 				}
 			#endif
-			ServerSendQueuePushEnd((uchar**) &tnps, tnps->size);
+			EQEmu::PacketBuffer* frame = MakeFrame(pack, iDestination);
+			ServerSendQueuePushEnd(frame, ((EmuTCPNetPacket_Struct*) frame->Data())->size);
+			frame->Unref();
 		}
 	}
 	return true;
@@ -253,12 +281,30 @@ bool EmuTCPConnection::SendPacket(EmuTCPNetPacket_Struct* tnps) {
 	return true;
 }
 
+bool EmuTCPConnection::SendFrame(EQEmu::PacketBuffer* frame) {
+	if (RemoteID)
+		return false;
+	if (!Connected())
+		return false;
+	if (GetMode() != modePacket)
+		return false;
+
+	LockMutex lock(&MState);
+	ServerSendQueuePushEnd(frame, ((EmuTCPNetPacket_Struct*) frame->Data())->size);
+	return true;
+}
+
+bool EmuTCPConnection::SendSharedPacket(ServerPacket* pack, EQEmu::PacketBuffer* frame) {
+	//relays, old format links and connections still switching modes frame packets their own way
+	if (RemoteID || pOldFormat || GetMode() != modePacket)
+		return SendPacket(pack);
+	return SendFrame(frame);
+}
+
 ServerPacket* EmuTCPConnection::PopPacket() {
-	ServerPacket* ret;
-	if (!MOutQueueLock.trylock())
-		return nullptr;
-	ret = OutQueue.pop();
-	MOutQueueLock.unlock();
+	ServerPacket* ret = nullptr;
+	LockMutex lock(&MOutQueueLock);
+	OutQueue.Pop(ret);
 	return ret;
 }
 
@@ -269,9 +315,9 @@ void EmuTCPConnection::InModeQueuePush(EmuTCPNetPacket_Struct* tnps) {
 }
 
 void EmuTCPConnection::OutQueuePush(ServerPacket* pack) {
-	MOutQueueLock.lock();
-	OutQueue.push(pack);
-	MOutQueueLock.unlock();
+	OutQueue.Push(pack);
+	if (wakeup)
+		wakeup->Signal();
 }
 
 
@@ -285,7 +331,7 @@ bool EmuTCPConnection::LineOutQueuePush(char* line) {
 	if(line[0] == '*') {
 		if (strcmp(line, "**PACKETMODE**") == 0) {
 			MSendQueue.lock();
-			safe_delete_array(sendbuf);
+			ServerSendQueueClear();
 			if (TCPMode == modeConsole)
 				Send((const uchar*) "\0**PACKETMODE**\r", 16);
 			TCPMode = modePacket;
@@ -301,7 +347,7 @@ bool EmuTCPConnection::LineOutQueuePush(char* line) {
 		}
 		if (strcmp(line, "**PACKETMODEZONE**") == 0) {
 			MSendQueue.lock();
-			safe_delete_array(sendbuf);
+			ServerSendQueueClear();
 			if (TCPMode == modeConsole)
 				Send((const uchar*) "\0**PACKETMODEZONE**\r", 20);
 			TCPMode = modePacket;
@@ -317,7 +363,7 @@ bool EmuTCPConnection::LineOutQueuePush(char* line) {
 		}
 		if (strcmp(line, "**PACKETMODELAUNCHER**") == 0) {
 			MSendQueue.lock();
-			safe_delete_array(sendbuf);
+			ServerSendQueueClear();
 			if (TCPMode == modeConsole)
 				Send((const uchar*) "\0**PACKETMODELAUNCHER**\r", 24);
 			TCPMode = modePacket;
@@ -333,7 +379,7 @@ bool EmuTCPConnection::LineOutQueuePush(char* line) {
 		}
 		if (strcmp(line, "**PACKETMODEUCS**") == 0) {
 			MSendQueue.lock();
-			safe_delete_array(sendbuf);
+			ServerSendQueueClear();
 			if (TCPMode == modeConsole)
 				Send((const uchar*) "\0**PACKETMODEUCS**\r", 19);
 			TCPMode = modePacket;
@@ -349,7 +395,7 @@ bool EmuTCPConnection::LineOutQueuePush(char* line) {
 		}
 		if (strcmp(line, "**PACKETMODEQS**") == 0) {
 			MSendQueue.lock();
-			safe_delete_array(sendbuf);
+			ServerSendQueueClear();
 			if (TCPMode == modeConsole)
 				Send((const uchar*) "\0**PACKETMODEQS**\r", 18);
 			TCPMode = modePacket;
@@ -390,39 +436,20 @@ bool EmuTCPConnection::ConnectIP(uint32 irIP, uint16 irPort, char* errbuf) {
 		}
 		else if (TCPMode == modePacket || TCPMode == modeTransition) {
 			TCPMode = modeTransition;
+			ServerSendQueueClear();
 			if(PacketMode == packetModeLauncher) {
-				safe_delete_array(sendbuf);
-				sendbuf_size = 24;
-				sendbuf_used = sendbuf_size;
-				sendbuf = new uchar[sendbuf_size];
-				memcpy(sendbuf, "\0**PACKETMODELAUNCHER**\r", sendbuf_size);
+				ServerSendQueuePushEnd((const uchar*) "\0**PACKETMODELAUNCHER**\r", 24);
 			} else if(PacketMode == packetModeLogin) {
-				safe_delete_array(sendbuf);
-				sendbuf_size = 16;
-				sendbuf_used = sendbuf_size;
-				sendbuf = new uchar[sendbuf_size];
-				memcpy(sendbuf, "\0**PACKETMODE**\r", sendbuf_size);
+				ServerSendQueuePushEnd((const uchar*) "\0**PACKETMODE**\r", 16);
 			} else if(PacketMode == packetModeUCS) {
-				safe_delete_array(sendbuf);
-				sendbuf_size = 19;
-				sendbuf_used = sendbuf_size;
-				sendbuf = new uchar[sendbuf_size];
-				memcpy(sendbuf, "\0**PACKETMODEUCS**\r", sendbuf_size);
+				ServerSendQueuePushEnd((const uchar*) "\0**PACKETMODEUCS**\r", 19);
 			}
 			else if(PacketMode == packetModeQueryServ) {
-				safe_delete_array(sendbuf);
-				sendbuf_size = 18;
-				sendbuf_used = sendbuf_size;
-				sendbuf = new uchar[sendbuf_size];
-				memcpy(sendbuf, "\0**PACKETMODEQS**\r", sendbuf_size);
-			} 
+				ServerSendQueuePushEnd((const uchar*) "\0**PACKETMODEQS**\r", 18);
+			}
 			else {
 				//default: packetModeZone
-				safe_delete_array(sendbuf);
-				sendbuf_size = 20;
-				sendbuf_used = sendbuf_size;
-				sendbuf = new uchar[sendbuf_size];
-				memcpy(sendbuf, "\0**PACKETMODEZONE**\r", sendbuf_size);
+				ServerSendQueuePushEnd((const uchar*) "\0**PACKETMODEZONE**\r", 20);
 			}
 		}
 	#endif
@@ -436,7 +463,7 @@ void EmuTCPConnection::ClearBuffers() {
 
 	LockMutex lock2(&MOutQueueLock);
 	ServerPacket* pack = 0;
-	while ((pack = OutQueue.pop()))
+	while (OutQueue.Pop(pack))
 		safe_delete(pack);
 
 	EmuTCPNetPacket_Struct* tnps = 0;
@@ -546,11 +573,11 @@ bool EmuTCPConnection::ProcessReceivedDataAsPackets(char* errbuf) {
 				if (tnps->flags.compressed) {
 					// Lets decompress the packet here
 					pack->compressed = false;
-					pack->pBuffer = new uchar[pack->InflatedSize];
+					pack->AllocateBuffer(pack->InflatedSize);
 					pack->size = InflatePacket(buffer, pack->size, pack->pBuffer, pack->InflatedSize);
 				}
 				else {
-					pack->pBuffer = new uchar[pack->size];
+					pack->AllocateBuffer(pack->size);
 					memcpy(pack->pBuffer, buffer, pack->size);
 				}
 			}
@@ -647,7 +674,7 @@ bool EmuTCPConnection::ProcessReceivedDataAsOldPackets(char* errbuf) {
 				return false;
 			}*/
 			if (pack->size > 0) {
-				pack->pBuffer = new uchar[pack->size];
+				pack->AllocateBuffer(pack->size);
 				memcpy(pack->pBuffer, &buffer[4], pack->size);
 			}
 			if (pack->opcode == 0) {
@@ -779,6 +806,19 @@ void EmuTCPConnection::ProcessNetworkLayerPacket(ServerPacket* pack) {
 	}
 }
 
+bool EmuTCPConnection::ReactorService() {
+	//same as TCPConnection's, but an incoming relay link has to be torn down by our Disconnect
+	if (ConnectionType == Incoming) {
+		State_t state = GetState();
+		if (state == TCPS_Closing || state == TCPS_Error)
+			return true;
+		if (!Process() && state == TCPS_Connected)
+			Disconnect();
+		return true;
+	}
+	return TCPConnection::ReactorService();
+}
+
 bool EmuTCPConnection::SendData(bool &sent_something, char* errbuf) {
 	sent_something = false;
 	if(!TCPConnection::SendData(sent_something, errbuf))
@@ -800,7 +840,8 @@ bool EmuTCPConnection::SendData(bool &sent_something, char* errbuf) {
 
 bool EmuTCPConnection::RecvData(char* errbuf) {
 	if(!TCPConnection::RecvData(errbuf)) {
-		if (OutQueue.count())
+		LockMutex lock(&MOutQueueLock);
+		if (!OutQueue.Empty())
 			return(true);
 		else
 			return(false);
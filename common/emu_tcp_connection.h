@@ -26,6 +26,7 @@
 
 struct SPackSendQueue;
 class EmuTCPServer;
+namespace EQEmu { class EventWaiter; }
 class ServerPacket;
 
 class EmuTCPConnection : public TCPConnection {
@@ -42,12 +43,20 @@ public:
 	virtual void	Disconnect(bool iSendRelayDisconnect = true);
 
 	static EmuTCPNetPacket_Struct* MakePacket(ServerPacket* pack, uint32 iDestination = 0);
+	//the same bytes as MakePacket in a pooled buffer that send queues share, caller holds one reference
+	static EQEmu::PacketBuffer* MakeFrame(ServerPacket* pack, uint32 iDestination = 0);
 	static SPackSendQueue* MakeOldPacket(ServerPacket* pack);
 
 	virtual bool	SendPacket(ServerPacket* pack, uint32 iDestination = 0);
 	virtual bool	SendPacket(EmuTCPNetPacket_Struct* tnps);
+	//queues a reference to frame (from MakeFrame) rather than a copy, same rules as SendPacket(tnps)
+	bool			SendFrame(EQEmu::PacketBuffer* frame);
+	//for broadcasts: frame is MakeFrame(pack), shared when this connection would send those exact bytes
+	bool			SendSharedPacket(ServerPacket* pack, EQEmu::PacketBuffer* frame);
 	ServerPacket*	PopPacket(); // OutQueuePop()
 	void SetPacketMode(ePacketMode mode) { PacketMode = mode; }
+	//signaled whenever a received packet is queued for PopPacket
+	void SetWakeup(EQEmu::EventWaiter *waiter) { wakeup = waiter; }
 
 	eTCPMode		GetMode()	const		{ return TCPMode; }
 	ePacketMode		GetPacketMode() const	{ return(PacketMode); }
@@ -63,6 +72,7 @@ protected:
 
 	void	SendNetErrorPacket(const char* reason = 0);
 
+	virtual bool ReactorService();
 	virtual bool SendData(bool &sent_something, char* errbuf = 0);
 	virtual bool RecvData(char* errbuf = 0);
 
@@ -93,9 +103,11 @@ protected:
 	void	InModeQueuePush(EmuTCPNetPacket_Struct* tnps);
 	MyQueue<EmuTCPNetPacket_Struct> InModeQueue;
 
-	//output queue...
-	MyQueue<ServerPacket> OutQueue;
+	//output queue, filled by the reactor thread and popped by the owner's loop.
+	//MOutQueueLock is only taken by the poppers (PopPacket and ClearBuffers).
+	EQEmu::HandoffQueue<ServerPacket*> OutQueue;
 	Mutex	MOutQueueLock;
+	EQEmu::EventWaiter *wakeup;
 };
 
 #endif /*EmuTCPCONNECTION_H_*/
@@ -9,9 +9,10 @@ EmuTCPServer::EmuTCPServer(uint16 iPort, bool iOldFormat)
 }
 
 EmuTCPServer::~EmuTCPServer() {
+	StopLoopAndWait();
 	MInQueue.lock();
 	while(!m_InQueue.empty()) {
-		delete m_InQueue.front();
+		m_InQueue.front()->Unref();
 		m_InQueue.pop();
 	}
 	MInQueue.unlock();
@@ -30,34 +31,42 @@ void EmuTCPServer::CreateNewConnection(uint32 ID, SOCKET in_socket, uint32 irIP,
 
 
 void EmuTCPServer::SendPacket(ServerPacket* pack) {
-	EmuTCPNetPacket_Struct* tnps = EmuTCPConnection::MakePacket(pack);
-	SendPacket(&tnps);
+	QueueFrame(EmuTCPConnection::MakeFrame(pack));
 }
 
 void EmuTCPServer::SendPacket(EmuTCPNetPacket_Struct** tnps) {
+	EQEmu::PacketBuffer* frame = EQEmu::PacketBuffer::Create((*tnps)->size);
+	memcpy(frame->Data(), *tnps, (*tnps)->size);
+	uchar* tmp = (uchar*) *tnps;
+	safe_delete_array(tmp);
+	*tnps = nullptr;
+	QueueFrame(frame);
+}
+
+void EmuTCPServer::QueueFrame(EQEmu::PacketBuffer* frame) {
 	MInQueue.lock();
-	m_InQueue.push(*tnps);
+	m_InQueue.push(frame);
 	MInQueue.unlock();
-	tnps = nullptr;
+	EQEmu::TCPReactor::Get().Wake(this);
 }
 
 void EmuTCPServer::CheckInQueue() {
-	EmuTCPNetPacket_Struct* tnps = 0;
+	EQEmu::PacketBuffer* frame = nullptr;
 
-	while (( tnps = InQueuePop() )) {
+	while (( frame = InQueuePop() )) {
 		vitr cur, end;
 		cur = m_list.begin();
 		end = m_list.end();
 		for(; cur != end; cur++) {
 			if ((*cur)->GetMode() != EmuTCPConnection::modeConsole && (*cur)->GetRemoteID() == 0)
-				(*cur)->SendPacket(tnps);
+				(*cur)->SendFrame(frame);
 		}
-		safe_delete(tnps);
+		frame->Unref();
 	}
 }
 
-EmuTCPNetPacket_Struct* EmuTCPServer::InQueuePop() {
-	EmuTCPNetPacket_Struct* ret = nullptr;
+EQEmu::PacketBuffer* EmuTCPServer::InQueuePop() {
+	EQEmu::PacketBuffer* ret = nullptr;
 	MInQueue.lock();
 	if(!m_InQueue.empty()) {
 		ret = m_InQueue.front();
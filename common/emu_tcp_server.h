@@ -6,6 +6,7 @@
 class EmuTCPConnection;
 struct EmuTCPNetPacket_Struct;
 class ServerPacket;
+namespace EQEmu { class PacketBuffer; }
 
 class EmuTCPServer : public TCPServer<EmuTCPConnection> {
 public:
@@ -14,7 +15,7 @@ public:
 
 	//packet broadcast routines.
 	void	SendPacket(ServerPacket* pack);
-	void	SendPacket(EmuTCPNetPacket_Struct** tnps);
+	void	SendPacket(EmuTCPNetPacket_Struct** tnps);	//takes ownership of *tnps
 
 	//special crap for relay management
 	EmuTCPConnection *FindConnection(uint32 iID);
@@ -29,10 +30,11 @@ protected:
 
 	bool pOldFormat;
 
-	//broadcast packet queue..
+	//broadcast packet queue, each packet is framed once and every connection queues the same frame
 	void	CheckInQueue();
+	void	QueueFrame(EQEmu::PacketBuffer* frame);	//takes over the caller's reference
 	Mutex	MInQueue;
-	EmuTCPNetPacket_Struct*	InQueuePop();	//returns ownership
-	std::queue<EmuTCPNetPacket_Struct *> m_InQueue;
+	EQEmu::PacketBuffer*	InQueuePop();	//returns ownership
+	std::queue<EQEmu::PacketBuffer *> m_InQueue;
 };
 #endif /*EmuTCPSERVER_H_*/
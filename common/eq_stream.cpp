@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <errno.h>
 
 #ifdef _WINDOWS
 	#include <time.h>
@@ -82,11 +83,11 @@ void EQStream::init(bool resetSession) {
 
 	OpMgr = nullptr;
 	if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-		Log.Out(Logs::Detail, Logs::Netcode, _L "init Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+		Log.Out(Logs::Detail, Logs::Netcode, _L "init Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 	}
 	
 	if(NextSequencedSend > SequencedQueue.size()) {
-		Log.Out(Logs::Detail, Logs::Netcode, _L "init Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+		Log.Out(Logs::Detail, Logs::Netcode, _L "init Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 	}
 }
 
@@ -188,7 +189,7 @@ void EQStream::ProcessPacket(EQProtocolPacket *p)
 					// _raw(NET__DEBUG, seq, p);
 
 					PacketQueue[seq]=p->Copy();
-					Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Packet Queue size=%d" __L, PacketQueue.size());
+					Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Packet Queue size=%d" __L, (int)PacketQueue.size());
 
 				//SendOutOfOrderAck(seq);
 
@@ -238,7 +239,7 @@ void EQStream::ProcessPacket(EQProtocolPacket *p)
 				// _raw(NET__DEBUG, seq, p);
 
 				PacketQueue[seq]=p->Copy();
-				Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Fragment Queue size=%d" __L, PacketQueue.size());
+				Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Fragment Queue size=%d" __L, (int)PacketQueue.size());
 
 				//SendOutOfOrderAck(seq);
 
@@ -415,15 +416,15 @@ void EQStream::ProcessPacket(EQProtocolPacket *p)
 			MOutboundQueue.lock();
 
 			if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-OOA Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-OOA Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 			}
 			
 			if(NextSequencedSend > SequencedQueue.size()) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-OOA Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-OOA Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 			}
 			//if the packet they got out of order is between our last acked packet and the last sent packet, then its valid.
 			if (CompareSequence(SequencedBase,seq) != SeqPast && CompareSequence(NextOutSeq,seq) == SeqPast) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Received OP_OutOfOrderAck for sequence %d, starting retransmit at the start of our unacked buffer (seq %d, was %d)." __L,
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Received OP_OutOfOrderAck for sequence %d, starting retransmit at the start of our unacked buffer (seq %d, was %ld)." __L,
 					seq, SequencedBase, SequencedBase+NextSequencedSend);
 
 				bool retransmit_acked_packets = false;
@@ -453,11 +454,11 @@ void EQStream::ProcessPacket(EQProtocolPacket *p)
 			}
 
 			if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Post-OOA Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Post-OOA Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 			}
 
 			if(NextSequencedSend > SequencedQueue.size()) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Post-OOA Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Post-OOA Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 			}
 			MOutboundQueue.unlock();
 #endif
@@ -519,42 +520,39 @@ void EQStream::QueuePacket(const EQApplicationPacket *p, bool ack_req)
 	if(p == nullptr)
 		return;
 
-	EQApplicationPacket *newp = p->Copy();
-
-	if (newp != nullptr)
-		FastQueuePacket(&newp, ack_req);
-}
-
-void EQStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
-{
-	EQApplicationPacket *pack=*p;
-	*p = nullptr;		//clear caller's pointer.. effectively takes ownership
-
-	if(pack == nullptr)
-		return;
-
 	if(OpMgr == nullptr || *OpMgr == nullptr) {
 		Log.Out(Logs::Detail, Logs::Netcode, _L "Packet enqueued into a stream with no opcode manager, dropping." __L);
-		delete pack;
 		return;
 	}
 
 	uint16 opcode = 0;
-	if(pack->GetOpcodeBypass() != 0) {
-		opcode = pack->GetOpcodeBypass();
+	if(p->GetOpcodeBypass() != 0) {
+		opcode = p->GetOpcodeBypass();
 	} else {
-		opcode = (*OpMgr)->EmuToEQ(pack->emu_opcode);
+		opcode = (*OpMgr)->EmuToEQ(p->emu_opcode);
 	}
 
+	//the protocol packets copy out of the app packet, so we never need our own copy of it
 	if (!ack_req) {
-		NonSequencedPush(new EQProtocolPacket(opcode, pack->pBuffer, pack->size));
-		delete pack;
+		NonSequencedPush(new EQProtocolPacket(opcode, p->pBuffer, p->size));
 	} else {
-		SendPacket(opcode, pack);
+		SendPacket(opcode, p);
 	}
 }
 
-void EQStream::SendPacket(uint16 opcode, EQApplicationPacket *p)
+void EQStream::FastQueuePacket(EQApplicationPacket **p, bool ack_req)
+{
+	EQApplicationPacket *pack=*p;
+	*p = nullptr;		//clear caller's pointer.. effectively takes ownership
+
+	if(pack == nullptr)
+		return;
+
+	QueuePacket(pack, ack_req);
+	delete pack;
+}
+
+void EQStream::SendPacket(uint16 opcode, const EQApplicationPacket *p)
 {
 	uint32 chunksize, used;
 	uint32 length;
@@ -595,7 +593,6 @@ void EQStream::SendPacket(uint16 opcode, EQApplicationPacket *p)
 			used+=chunksize;
 			Log.Out(Logs::Detail, Logs::Netcode, _L "Subsequent fragment: len %d, used %d/%d." __L, chunksize, used, p->size);
 		}
-		delete p;
 		delete[] tmpbuff;
 	} else {
 
@@ -606,7 +603,6 @@ void EQStream::SendPacket(uint16 opcode, EQApplicationPacket *p)
 
 		delete[] tmpbuff;
 		SequencedPush(out);
-		delete p;
 	}
 }
 
@@ -617,10 +613,10 @@ void EQStream::SequencedPush(EQProtocolPacket *p)
 #else
 	MOutboundQueue.lock();
 if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Push Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Push Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 }
 if(NextSequencedSend > SequencedQueue.size()) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Push Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Push Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 }
 
 	Log.Out(Logs::Detail, Logs::Netcode, _L "Pushing sequenced packet %d of length %d. Base Seq is %d." __L, NextOutSeq, p->size, SequencedBase);
@@ -629,10 +625,10 @@ if(NextSequencedSend > SequencedQueue.size()) {
 	NextOutSeq++;
 
 if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Push Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Push Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 }
 if(NextSequencedSend > SequencedQueue.size()) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Push Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Push Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 }
 	MOutboundQueue.unlock();
 #endif
@@ -665,7 +661,7 @@ uint16 Seq=htons(seq);
 	NonSequencedPush(new EQProtocolPacket(OP_OutOfOrderAck,(unsigned char *)&Seq,sizeof(uint16)));
 }
 
-void EQStream::Write(int eq_fd)
+void EQStream::Write(int eq_fd, EQStreamSendBatch *batch)
 {
 	std::queue<EQProtocolPacket *> ReadyToSend;
 	bool SeqEmpty=false, NonSeqEmpty=false;
@@ -696,7 +692,7 @@ void EQStream::Write(int eq_fd)
 		if (RETRANSMIT_TIMEOUT_MULT && !SequencedQueue.empty() && NextSequencedSend &&
 			(GetState()==ESTABLISHED) && ((retransmittimer+retransmittimeout) < Timer::GetCurrentTime())) {
 			Log.Out(Logs::Detail, Logs::Netcode, _L "Timeout since last ack received, starting retransmit at the start of our unacked "
-				"buffer (seq %d, was %d)." __L, SequencedBase, SequencedBase+NextSequencedSend);
+				"buffer (seq %d, was %ld)." __L, SequencedBase, SequencedBase+NextSequencedSend);
 			NextSequencedSend = 0;
 			retransmittimer = Timer::GetCurrentTime(); // don't want to endlessly retransmit the first packet
 		}
@@ -744,11 +740,11 @@ void EQStream::Write(int eq_fd)
 
 		if (sitr!=SequencedQueue.end()) {
 			if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Send Seq NSS=%d Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, NextSequencedSend, SequencedBase, SequencedQueue.size(), NextOutSeq);
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Send Seq NSS=%ld Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, NextSequencedSend, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 			}
 
 			if(NextSequencedSend > SequencedQueue.size()) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Send Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Send Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 			}
 			uint16 seq_send = SequencedBase + NextSequencedSend;	//just for logging...
 			
@@ -819,10 +815,10 @@ void EQStream::Write(int eq_fd)
 			}
 
 			if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Post send Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Post send Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 			}
 			if(NextSequencedSend > SequencedQueue.size()) {
-				Log.Out(Logs::Detail, Logs::Netcode, _L "Post send Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+				Log.Out(Logs::Detail, Logs::Netcode, _L "Post send Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 			}
 		} else {
 			// No more sequenced packets
@@ -842,7 +838,7 @@ void EQStream::Write(int eq_fd)
 	// Send all the packets we "made"
 	while(!ReadyToSend.empty()) {
 		p = ReadyToSend.front();
-		WritePacket(eq_fd,p);
+		WritePacket(eq_fd,p,batch);
 		delete p;
 		ReadyToSend.pop();
 	}
@@ -860,7 +856,7 @@ void EQStream::Write(int eq_fd)
 	}
 }
 
-void EQStream::WritePacket(int eq_fd, EQProtocolPacket *p)
+void EQStream::WritePacket(int eq_fd, EQProtocolPacket *p, EQStreamSendBatch *batch)
 {
 uint32 length;
 sockaddr_in address;
@@ -894,7 +890,10 @@ sockaddr_in address;
 		length+=2;
 	}
 	//dump_message_column(buffer,length,"Writer: ");
-	sendto(eq_fd,(char *)buffer,length,0,(sockaddr *)&address,sizeof(address));
+	if (batch)
+		batch->Add(buffer,length,address);
+	else
+		sendto(eq_fd,(char *)buffer,length,0,(sockaddr *)&address,sizeof(address));
 	AddBytesSent(length);
 }
 
@@ -1101,7 +1100,8 @@ EQProtocolPacket *p=nullptr;
 
 void EQStream::Process(const unsigned char *buffer, const uint32 length)
 {
-static unsigned char newbuffer[2048];
+//not static, several reader threads may be processing different streams at once
+unsigned char newbuffer[2048];
 uint32 newlength=0;
 	if (EQProtocolPacket::ValidateCRC(buffer,length,Key)) {
 		if (compressed) {
@@ -1148,10 +1148,10 @@ std::deque<EQProtocolPacket *>::iterator itr, tmp;
 	MOutboundQueue.lock();
 //do a bit of sanity checking.
 if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Ack Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, SequencedQueue.size(), NextOutSeq);
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Ack Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 }
 if(NextSequencedSend > SequencedQueue.size()) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Ack Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Pre-Ack Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 }
 
 	SeqOrder ord = CompareSequence(SequencedBase, seq);
@@ -1169,12 +1169,12 @@ if(NextSequencedSend > SequencedQueue.size()) {
 		seq++;	//we stop at the block right after their ack, counting on the wrap of both numbers.
 		while(SequencedBase != seq) {
 if(SequencedQueue.empty()) {
-Log.Out(Logs::Detail, Logs::Netcode, _L "OUT OF PACKETS acked packet with sequence %lu. Next send is %d before this." __L, (unsigned long)SequencedBase, NextSequencedSend);
+Log.Out(Logs::Detail, Logs::Netcode, _L "OUT OF PACKETS acked packet with sequence %lu. Next send is %ld before this." __L, (unsigned long)SequencedBase, NextSequencedSend);
 	SequencedBase = NextOutSeq;
 	NextSequencedSend = 0;
 	break;
 }
-			Log.Out(Logs::Detail, Logs::Netcode, _L "Removing acked packet with sequence %lu. Next send is %d before this." __L, (unsigned long)SequencedBase, NextSequencedSend);
+			Log.Out(Logs::Detail, Logs::Netcode, _L "Removing acked packet with sequence %lu. Next send is %ld before this." __L, (unsigned long)SequencedBase, NextSequencedSend);
 			//clean out the acked packet
 			delete SequencedQueue.front();
 			SequencedQueue.pop_front();
@@ -1185,10 +1185,10 @@ Log.Out(Logs::Detail, Logs::Netcode, _L "OUT OF PACKETS acked packet with sequen
 			SequencedBase++;
 		}
 if(uint16(SequencedBase + SequencedQueue.size()) != NextOutSeq) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Post-Ack on %d Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, seq, SequencedBase, SequencedQueue.size(), NextOutSeq);
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Post-Ack on %d Invalid Sequenced queue: BS %d + SQ %d != NOS %d" __L, seq, SequencedBase, (int)SequencedQueue.size(), NextOutSeq);
 }
 if(NextSequencedSend > SequencedQueue.size()) {
-	Log.Out(Logs::Detail, Logs::Netcode, _L "Post-Ack Next Send Sequence is beyond the end of the queue NSS %d > SQ %d" __L, NextSequencedSend, SequencedQueue.size());
+	Log.Out(Logs::Detail, Logs::Netcode, _L "Post-Ack Next Send Sequence is beyond the end of the queue NSS %ld > SQ %d" __L, NextSequencedSend, (int)SequencedQueue.size());
 }
 	}
 
@@ -1222,7 +1222,7 @@ void EQStream::ProcessQueue()
 		Log.Out(Logs::Detail, Logs::Netcode, _L "Processing Queued Packet: Seq=%d" __L, NextInSeq);
 		ProcessPacket(qp);
 		delete qp;
-		Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Packet Queue size=%d" __L, PacketQueue.size());
+		Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Packet Queue size=%d" __L, (int)PacketQueue.size());
 	}
 }
 
@@ -1233,7 +1233,7 @@ EQProtocolPacket *qp=nullptr;
 	if ((itr=PacketQueue.find(seq))!=PacketQueue.end()) {
 		qp=itr->second;
 		PacketQueue.erase(itr);
-		Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Packet Queue size=%d" __L, PacketQueue.size());
+		Log.Out(Logs::Detail, Logs::Netcode, _L "OP_Packet Queue size=%d" __L, (int)PacketQueue.size());
 	}
 	return qp;
 }
@@ -1452,3 +1452,81 @@ EQStream::MatchState EQStream::CheckSignature(const Signature *sig) {
 	return(res);
 }
 
+EQStreamSendBatch::EQStreamSendBatch(int fd)
+:	fd(fd),
+	count(0),
+	packets_sent(0),
+	send_calls(0),
+	buffers(EQSTREAM_SEND_BATCH * EQSTREAM_SEND_SLOT),
+	lengths(EQSTREAM_SEND_BATCH),
+	addresses(EQSTREAM_SEND_BATCH)
+{
+}
+
+EQStreamSendBatch::~EQStreamSendBatch()
+{
+	Flush();
+}
+
+void EQStreamSendBatch::Add(const unsigned char *data, uint32 length, const sockaddr_in &to)
+{
+#ifdef __linux__
+	if (length > EQSTREAM_SEND_SLOT) {
+		// too big to hold on to, this never happens with real stream max lengths
+		sendto(fd,(char *)data,length,0,(sockaddr *)&to,sizeof(to));
+		packets_sent++;
+		send_calls++;
+		return;
+	}
+
+	memcpy(&buffers[count * EQSTREAM_SEND_SLOT], data, length);
+	lengths[count] = length;
+	addresses[count] = to;
+	count++;
+
+	if (count == EQSTREAM_SEND_BATCH)
+		Flush();
+#else
+	sendto(fd,(char *)data,length,0,(sockaddr *)&to,sizeof(to));
+	packets_sent++;
+	send_calls++;
+#endif
+}
+
+void EQStreamSendBatch::Flush()
+{
+#ifdef __linux__
+	if (count == 0)
+		return;
+
+	struct mmsghdr msgs[EQSTREAM_SEND_BATCH];
+	struct iovec iovs[EQSTREAM_SEND_BATCH];
+	memset(msgs, 0, sizeof(struct mmsghdr) * count);
+
+	for (uint32 i = 0; i < count; ++i) {
+		iovs[i].iov_base = &buffers[i * EQSTREAM_SEND_SLOT];
+		iovs[i].iov_len = lengths[i];
+		msgs[i].msg_hdr.msg_name = &addresses[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	uint32 sent = 0;
+	while (sent < count) {
+		int res = sendmmsg(fd, msgs + sent, count - sent, 0);
+		send_calls++;
+		if (res <= 0) {
+			if (res < 0 && errno == EINTR)
+				continue;
+			// the socket is full or gone, drop what's left just like a failed sendto would
+			Log.Out(Logs::Detail, Logs::Netcode, "sendmmsg failed with %d packets left to send", count - sent);
+			break;
+		}
+		sent += res;
+	}
+
+	packets_sent += sent;
+	count = 0;
+#endif
+}
@@ -53,6 +53,10 @@ class EQProtocolPacket;
 #define MAX_SESSION_RETRIES 30
 #endif
 
+//number of datagrams EQStreamSendBatch holds before it has to go to the kernel
+#define EQSTREAM_SEND_BATCH 64
+#define EQSTREAM_SEND_SLOT 2048
+
 #pragma pack(1)
 struct SessionRequest {
 	uint32 UnknownA;
@@ -88,6 +92,32 @@ struct SessionStats {
 class OpcodeManager;
 class EQRawApplicationPacket;
 
+//Collects the datagrams written by EQStream::Write so the factory can hand them to the kernel
+//with a single sendmmsg. Where sendmmsg isn't available every datagram is sent as it is added.
+class EQStreamSendBatch {
+public:
+	EQStreamSendBatch(int fd = -1);
+	~EQStreamSendBatch();
+
+	//sends whatever is still held to the old socket first
+	void SetSocket(int in_fd) { Flush(); fd = in_fd; }
+
+	void Add(const unsigned char *data, uint32 length, const sockaddr_in &to);
+	void Flush();
+
+	uint32 GetPacketsSent() const { return packets_sent; }
+	uint32 GetSendCalls() const { return send_calls; }
+
+private:
+	int fd;
+	uint32 count;
+	uint32 packets_sent;
+	uint32 send_calls;
+	std::vector<unsigned char> buffers;
+	std::vector<uint32> lengths;
+	std::vector<sockaddr_in> addresses;
+};
+
 class EQStream : public EQStreamInterface {
 	friend class EQStreamPair;	//for collector.
 	protected:
@@ -168,7 +198,7 @@ class EQStream : public EQStreamInterface {
 		EQRawApplicationPacket *MakeApplicationPacket(EQProtocolPacket *p);
 		EQRawApplicationPacket *MakeApplicationPacket(const unsigned char *buf, uint32 len);
 		EQProtocolPacket *MakeProtocolPacket(const unsigned char *buf, uint32 len);
-		void SendPacket(uint16 opcode, EQApplicationPacket *p);
+		void SendPacket(uint16 opcode, const EQApplicationPacket *p);
 
 		void SetState(EQStreamState state);
 
@@ -180,7 +210,7 @@ class EQStream : public EQStreamInterface {
 		void SendPacket(EQProtocolPacket *p);
 		void NonSequencedPush(EQProtocolPacket *p);
 		void SequencedPush(EQProtocolPacket *p);
-		void WritePacket(int fd,EQProtocolPacket *p);
+		void WritePacket(int fd,EQProtocolPacket *p, EQStreamSendBatch *batch=nullptr);
 
 
 		uint32 GetKey() { return Key; }
@@ -235,7 +265,7 @@ class EQStream : public EQStreamInterface {
 		bool HasOutgoingData();
 		void Process(const unsigned char *data, const uint32 length);
 		void SetLastPacketTime(uint32 t) {LastPacket=t;}
-		void Write(int eq_fd);
+		void Write(int eq_fd, EQStreamSendBatch *batch=nullptr);
 
 		// whether or not the stream has been assigned (we passed our stream match)
 		void SetActive(bool val) { streamactive = val; }
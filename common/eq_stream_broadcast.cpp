@@ -0,0 +1,131 @@
+#include "global_define.h"
+#include "eq_stream_broadcast.h"
+#include "eq_packet.h"
+#include "eq_stream.h"
+#include "struct_strategy.h"
+
+//Stands in for a real stream while an encoder runs, holding on to whatever the encoder queues.
+class EQCaptureStream : public EQStream {
+public:
+	struct Captured {
+		std::shared_ptr<EQApplicationPacket> packet;
+		bool ack_req;
+	};
+
+	virtual void QueuePacket(const EQApplicationPacket *p, bool ack_req = true) {
+		if(p == nullptr)
+			return;
+
+		EQApplicationPacket *newp = p->Copy();
+		FastQueuePacket(&newp, ack_req);
+	}
+
+	virtual void FastQueuePacket(EQApplicationPacket **p, bool ack_req = true) {
+		if(p == nullptr || *p == nullptr)
+			return;
+
+		Captured c;
+		c.packet.reset(*p);
+		c.ack_req = ack_req;
+		captured.push_back(c);
+		*p = nullptr;
+	}
+
+	virtual std::string Describe() const { return("Broadcast Capture Stream"); }
+
+	std::vector<Captured> captured;
+};
+
+EQStreamBroadcast::EQStreamBroadcast()
+:	m_group_count(0),
+	m_stream_count(0),
+	m_capture(new EQCaptureStream())
+{
+	ResetStats();
+}
+
+void EQStreamBroadcast::AddStream(EQStreamInterface *stream) {
+	if(stream == nullptr)
+		return;
+
+	++m_stream_count;
+
+	const StructStrategy *structs = stream->GetStructStrategy();
+	if(structs == nullptr) {
+		m_plain.push_back(stream);
+		return;
+	}
+
+	//there are only ever a handful of client versions so a linear search beats a map here.
+	ClientVersion version = structs->GetClientVersion();
+	for(size_t i = 0; i < m_group_count; ++i) {
+		if(m_groups[i].version == version) {
+			m_groups[i].streams.push_back(stream);
+			return;
+		}
+	}
+
+	if(m_group_count == m_groups.size())
+		m_groups.push_back(Group());
+
+	Group &g = m_groups[m_group_count++];
+	g.version = version;
+	g.structs = structs;
+	g.streams.clear();
+	g.streams.push_back(stream);
+}
+
+void EQStreamBroadcast::Send(const EQApplicationPacket *p, bool ack_req) {
+	if(p == nullptr)
+		return;
+
+	for(size_t i = 0; i < m_group_count; ++i) {
+		Group &g = m_groups[i];
+		if(g.streams.empty())
+			continue;
+
+		//the encoders take ownership of (and are free to modify) the packet they are given
+		EQApplicationPacket *copy = p->Copy();
+		if(copy == nullptr)
+			continue;
+
+		std::shared_ptr<EQStream> dest = m_capture;
+		m_stats.bytes_allocated += copy->size;
+		m_stats.encodes++;
+		g.structs->Encode(&copy, dest, ack_req);
+
+		auto iter = m_capture->captured.begin();
+		while(iter != m_capture->captured.end()) {
+			m_stats.bytes_allocated += iter->packet->size;
+			for(size_t s = 0; s < g.streams.size(); ++s)
+				g.streams[s]->QueueEncodedPacket(iter->packet.get(), iter->ack_req);
+			++iter;
+		}
+		m_capture->captured.clear();
+
+		m_stats.streams += g.streams.size();
+	}
+
+	auto iter = m_plain.begin();
+	while(iter != m_plain.end()) {
+		(*iter)->QueuePacket(p, ack_req);
+		m_stats.bytes_allocated += p->size;
+		m_stats.streams++;
+		++iter;
+	}
+}
+
+void EQStreamBroadcast::Clear() {
+	for(size_t i = 0; i < m_group_count; ++i)
+		m_groups[i].streams.clear();
+
+	m_group_count = 0;
+	m_plain.clear();
+	m_stream_count = 0;
+}
+
+void EQStreamBroadcast::ResetStats() {
+	m_stats.encodes = 0;
+	m_stats.bytes_allocated = 0;
+	m_stats.streams = 0;
+}
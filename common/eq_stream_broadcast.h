@@ -0,0 +1,54 @@
+#ifndef EQSTREAMBROADCAST_H_
+#define EQSTREAMBROADCAST_H_
+
+#include "types.h"
+#include "clientversions.h"
+#include <memory>
+#include <vector>
+
+class EQApplicationPacket;
+class EQCaptureStream;
+class EQStreamInterface;
+class StructStrategy;
+
+//Queues a single packet to many streams at once.
+//Streams are grouped by client version, the version's encoder runs once per group and
+//every stream in the group queues the same encoded packets. Streams do not copy the
+//encoded packets, they serialize their own protocol packets straight out of them.
+class EQStreamBroadcast {
+public:
+	struct Stats {
+		uint32 encodes;			//number of times a StructStrategy encoder was run
+		uint32 bytes_allocated;	//application packet bytes allocated for copies and encoder output
+		uint32 streams;			//number of streams the packet was queued to
+	};
+
+	EQStreamBroadcast();
+
+	void AddStream(EQStreamInterface *stream);
+	void Send(const EQApplicationPacket *p, bool ack_req = true);
+	void Clear();
+
+	size_t StreamCount() const { return m_stream_count; }
+	const Stats &GetStats() const { return m_stats; }
+	void ResetStats();
+
+protected:
+	struct Group {
+		ClientVersion version;
+		const StructStrategy *structs;	//we do not own this object.
+		std::vector<EQStreamInterface *> streams;
+	};
+
+	//groups are reused between broadcasts so we don't reallocate the stream lists every time.
+	std::vector<Group> m_groups;
+	size_t m_group_count;
+	//streams that don't run a struct strategy, these just get a regular QueuePacket.
+	std::vector<EQStreamInterface *> m_plain;
+	size_t m_stream_count;
+	//every group's encoder queues into this one, it's emptied after each group is sent.
+	std::shared_ptr<EQCaptureStream> m_capture;
+	Stats m_stats;
+};
+
+#endif /*EQSTREAMBROADCAST_H_*/
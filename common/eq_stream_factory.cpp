@@ -1,6 +1,7 @@
 #include "global_define.h"
 #include "eqemu_logsys.h"
 #include "eq_stream_factory.h"
+#include "event_waiter.h"
 
 #ifdef _WINDOWS
 	#include <winsock.h>
@@ -16,25 +17,40 @@
 	#include <pthread.h>
 #endif
 
+#ifdef __linux__
+	#include <sys/epoll.h>
+#endif
+
 #include <iostream>
 #include <fcntl.h>
 
 #include "op_codes.h"
 
-ThreadReturnType EQStreamFactoryReaderLoop(void *eqfs)
+struct EQStreamFactoryReaderArgs {
+	EQStreamFactory *factory;
+	int fd;
+};
+
+ThreadReturnType EQStreamFactoryReaderLoop(void *args)
 {
-EQStreamFactory *fs=(EQStreamFactory *)eqfs;
+EQStreamFactoryReaderArgs *reader=(EQStreamFactoryReaderArgs *)args;
+EQStreamFactory *fs=reader->factory;
+int fd=reader->fd;
+	delete reader;
 
 #ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Starting EQStreamFactoryReaderLoop with thread ID %d", pthread_self());
+	Log.Out(Logs::Detail, Logs::None,  "Starting EQStreamFactoryReaderLoop with thread ID %lu", (unsigned long)pthread_self());
 #endif
 
-	fs->ReaderLoop();
+	fs->ReaderLoop(fd);
 
 #ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Ending EQStreamFactoryReaderLoop with thread ID %d", pthread_self());
+	Log.Out(Logs::Detail, Logs::None,  "Ending EQStreamFactoryReaderLoop with thread ID %lu", (unsigned long)pthread_self());
 #endif
 
+	//last touch of the factory, Close may free it right after this
+	fs->running_threads--;
+
 	THREAD_RETURN(nullptr);
 }
 
@@ -43,15 +59,17 @@ ThreadReturnType EQStreamFactoryWriterLoop(void *eqfs)
 	EQStreamFactory *fs=(EQStreamFactory *)eqfs;
 
 #ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Starting EQStreamFactoryWriterLoop with thread ID %d", pthread_self());
+	Log.Out(Logs::Detail, Logs::None,  "Starting EQStreamFactoryWriterLoop with thread ID %lu", (unsigned long)pthread_self());
 #endif
 
 	fs->WriterLoop();
 
 #ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Ending EQStreamFactoryWriterLoop with thread ID %d", pthread_self());
+	Log.Out(Logs::Detail, Logs::None,  "Ending EQStreamFactoryWriterLoop with thread ID %lu", (unsigned long)pthread_self());
 #endif
 
+	fs->running_threads--;
+
 	THREAD_RETURN(nullptr);
 }
 
@@ -61,26 +79,42 @@ EQStreamFactory::EQStreamFactory(EQStreamType type, int port, uint32 timeout)
 	StreamType=type;
 	Port=port;
 	sock=-1;
+	reader_threads=1;
+	wakeup=nullptr;
+	ReaderRunning=false;
+	WriterRunning=false;
+	running_threads=0;
 }
 
 void EQStreamFactory::Close()
 {
 	Stop();
 
+	//the readers notice within a second, don't pull the sockets out from under them. The writer can miss
+	//the signal from Stop if it was between its stream count and its Wait, so keep signaling it.
+	for (int i = 0; i < 300 && running_threads > 0; ++i) {
+		SignalWriter();
+		Sleep(10);
+	}
+	if (running_threads > 0)
+		Log.Out(Logs::General, Logs::Error, "EQStreamFactory on port %d closed with %d threads still running", Port, (int)running_threads);
+
+	if (sock != -1)
+		reader_socks.push_back(sock);
+	for (auto fd : reader_socks) {
 #ifdef _WINDOWS
-	closesocket(sock);
+		closesocket(fd);
 #else
-	close(sock);
+		close(fd);
 #endif
+	}
+	reader_socks.clear();
 	sock=-1;
 }
 
-bool EQStreamFactory::Open()
+int EQStreamFactory::OpenSocket(bool reuse_port)
 {
 struct sockaddr_in address;
-#ifndef WIN32
-	pthread_t t1,t2;
-#endif
 	/* Setup internet address information.
 	This is used with the bind() call */
 	memset((char *) &address, 0, sizeof(address));
@@ -89,28 +123,110 @@ struct sockaddr_in address;
 	address.sin_addr.s_addr = htonl(INADDR_ANY);
 
 	/* Setting up UDP port for new clients */
-	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0) {
+		return -1;
+	}
+
+#ifdef SO_REUSEPORT
+	if (reuse_port) {
+		int on = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (char *)&on, sizeof(on));
+	}
+#endif
+
+	if (bind(fd, (struct sockaddr *) &address, sizeof(address)) < 0) {
+#ifdef _WINDOWS
+		closesocket(fd);
+#else
+		close(fd);
+#endif
+		return -1;
+	}
+	#ifdef _WINDOWS
+		unsigned long nonblock = 1;
+		ioctlsocket(fd, FIONBIO, &nonblock);
+	#else
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+	#endif
+	return fd;
+}
+
+bool EQStreamFactory::Open()
+{
+#ifndef WIN32
+	pthread_t t1,t2;
+#endif
+	int threads = 1;
+#ifdef SO_REUSEPORT
+	threads = reader_threads;
+#endif
+
+	//SO_REUSEPORT would let a second server share this port without an error, so the port is claimed
+	//with a plain bind first. Once our sockets hold it, a plain bind like this one fails for anybody else.
+	sock = OpenSocket(false);
 	if (sock < 0) {
+		sock=-1;
 		return false;
 	}
 
-	if (bind(sock, (struct sockaddr *) &address, sizeof(address)) < 0) {
+	//port 0 lets the system pick, the extra reader sockets have to share whatever it picked
+	if (Port == 0) {
+		struct sockaddr_in bound;
+#ifdef _WINDOWS
+		int bound_len = sizeof(bound);
+#else
+		socklen_t bound_len = sizeof(bound);
+#endif
+		if (getsockname(sock, (struct sockaddr *) &bound, &bound_len) == 0)
+			Port = ntohs(bound.sin_port);
+	}
+
+	//the extra reader sockets can only join a port whose first socket also has SO_REUSEPORT
+	if (threads > 1) {
+#ifdef _WINDOWS
+		closesocket(sock);
+#else
 		close(sock);
-		sock=-1;
-		return false;
+#endif
+		sock = OpenSocket(true);
+		if (sock < 0) {
+			sock=-1;
+			return false;
+		}
+	}
+
+	//the kernel spreads clients over these by address, so a given stream is always read by the same thread
+	for (int i = 1; i < threads; ++i) {
+		int fd = OpenSocket(true);
+		if (fd < 0) {
+			Log.Out(Logs::General, Logs::Error, "Unable to open extra reader socket on port %d, continuing with %d reader threads", Port, i);
+			break;
+		}
+		reader_socks.push_back(fd);
 	}
+
+	ReaderRunning = true;
+	WriterRunning = true;
+
+	std::vector<int> fds(1, sock);
+	fds.insert(fds.end(), reader_socks.begin(), reader_socks.end());
+	running_threads = fds.size() + 1;
+
+	//moved these because on windows the output was delayed and causing the console window to look bad
+	for (auto fd : fds) {
+		EQStreamFactoryReaderArgs *args = new EQStreamFactoryReaderArgs;
+		args->factory = this;
+		args->fd = fd;
 	#ifdef _WINDOWS
-		unsigned long nonblock = 1;
-		ioctlsocket(sock, FIONBIO, &nonblock);
+		_beginthread(EQStreamFactoryReaderLoop,0, args);
 	#else
-		fcntl(sock, F_SETFL, O_NONBLOCK);
+		pthread_create(&t1,nullptr,EQStreamFactoryReaderLoop,args);
 	#endif
-	//moved these because on windows the output was delayed and causing the console window to look bad
+	}
 	#ifdef _WINDOWS
-		_beginthread(EQStreamFactoryReaderLoop,0, this);
 		_beginthread(EQStreamFactoryWriterLoop,0, this);
 	#else
-		pthread_create(&t1,nullptr,EQStreamFactoryReaderLoop,this);
 		pthread_create(&t2,nullptr,EQStreamFactoryWriterLoop,this);
 	#endif
 	return true;
@@ -135,180 +251,250 @@ void EQStreamFactory::Push(std::shared_ptr<EQStream> s)
 	MNewStreams.lock();
 	NewStreams.push(s);
 	MNewStreams.unlock();
+	if (wakeup)
+		wakeup->Signal();
+}
+
+bool EQStreamFactory::IsReaderRunning()
+{
+	MReaderRunning.lock();
+	bool running = ReaderRunning;
+	MReaderRunning.unlock();
+	return running;
+}
+
+bool EQStreamFactory::IsWriterRunning()
+{
+	MWriterRunning.lock();
+	bool running = WriterRunning;
+	MWriterRunning.unlock();
+	return running;
+}
+
+uint32 EQStreamFactory::GetStreamCount()
+{
+	uint32 count = 0;
+	for (int i = 0; i < EQSTREAM_FACTORY_SHARDS; ++i) {
+		Shards[i].lock.lock();
+		count += Shards[i].streams.size();
+		Shards[i].lock.unlock();
+	}
+	return count;
+}
+
+void EQStreamFactory::HandleDatagram(const unsigned char *buffer, int length, const sockaddr_in &from)
+{
+	uint64 key = StreamKey(from.sin_addr.s_addr, from.sin_port);
+	StreamShard &shard = GetShard(key);
+
+	shard.lock.lock();
+	auto stream_itr = shard.streams.find(key);
+	if (stream_itr == shard.streams.end()) {
+		if (buffer[1]!=OP_SessionRequest) {
+			shard.lock.unlock();
+			return;
+		}
+
+		std::shared_ptr<EQStream> s = std::make_shared<EQStream>(from);
+		s->SetStreamType(StreamType);
+		shard.streams[key]=s;
+		shard.lock.unlock();
+
+		WriterWork.Signal();
+		Push(s);
+		s->AddBytesRecv(length);
+		s->Process(buffer,length);
+		s->SetLastPacketTime(Timer::GetCurrentTime());
+		return;
+	}
+
+	std::shared_ptr<EQStream> curstream = stream_itr->second;
+	//dont bother processing incoming packets for closed connections
+	if(curstream->CheckClosed()) {
+		shard.lock.unlock();
+		return;
+	}
+
+	//the in use flag prevents the stream from being deleted while we are using it.
+	curstream->PutInUse();
+	shard.lock.unlock();
+
+	curstream->AddBytesRecv(length);
+	curstream->Process(buffer,length);
+	curstream->SetLastPacketTime(Timer::GetCurrentTime());
+	curstream->ReleaseFromUse();
 }
 
-void EQStreamFactory::ReaderLoop()
+#ifdef __linux__
+void EQStreamFactory::ReaderLoop(int fd)
+{
+	unsigned char buffers[EQSTREAM_FACTORY_RECV_BATCH][2048];
+	struct mmsghdr msgs[EQSTREAM_FACTORY_RECV_BATCH];
+	struct iovec iovs[EQSTREAM_FACTORY_RECV_BATCH];
+	sockaddr_in froms[EQSTREAM_FACTORY_RECV_BATCH];
+	struct epoll_event ev;
+
+	int epfd = epoll_create(1);
+	if (epfd < 0) {
+		Log.Out(Logs::General, Logs::Error, "Unable to create epoll instance for EQStreamFactory reader");
+		return;
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+
+	memset(msgs, 0, sizeof(msgs));
+	for (int i = 0; i < EQSTREAM_FACTORY_RECV_BATCH; ++i) {
+		iovs[i].iov_base = buffers[i];
+		iovs[i].iov_len = sizeof(buffers[i]);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &froms[i];
+	}
+
+	while(IsReaderRunning()) {
+		//short timeout so a Stop is noticed quickly
+		if (epoll_wait(epfd, &ev, 1, 1000) <= 0)
+			continue;
+
+		//drain everything that is queued on the socket
+		int count;
+		do {
+			for (int i = 0; i < EQSTREAM_FACTORY_RECV_BATCH; ++i)
+				msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+
+			count = recvmmsg(fd, msgs, EQSTREAM_FACTORY_RECV_BATCH, MSG_DONTWAIT, nullptr);
+			for (int i = 0; i < count; ++i) {
+				if (msgs[i].msg_len < 2)
+					continue;
+				HandleDatagram(buffers[i], msgs[i].msg_len, froms[i]);
+			}
+		} while (count == EQSTREAM_FACTORY_RECV_BATCH);
+	}
+
+	close(epfd);
+}
+#else
+void EQStreamFactory::ReaderLoop(int fd)
 {
 	fd_set readset;
-	std::map<std::pair<uint32, uint16>, std::shared_ptr<EQStream>>::iterator stream_itr;
 	int num;
 	int length;
 	unsigned char buffer[2048];
 	sockaddr_in from;
 	int socklen = sizeof(sockaddr_in);
 	timeval sleep_time;
-	ReaderRunning = true;
-
-	while(sock!=-1) {
-		MReaderRunning.lock();
-		if (!ReaderRunning)
-			break;
-		MReaderRunning.unlock();
 
+	while(IsReaderRunning()) {
 		FD_ZERO(&readset);
-		FD_SET(sock,&readset);
+		FD_SET(fd,&readset);
 
-		sleep_time.tv_sec=30;
+		sleep_time.tv_sec=1;
 		sleep_time.tv_usec=0;
-		if ((num=select(sock+1,&readset,nullptr,nullptr,&sleep_time))<0) {
+		if ((num=select(fd+1,&readset,nullptr,nullptr,&sleep_time))<0) {
 			// What do we wanna do?
 			continue;
 		} else if (num==0)
 			continue;
 
-		if(sock == -1)
-			break;		//somebody closed us while we were sleeping.
-
-		if (FD_ISSET(sock,&readset)) {
+		if (FD_ISSET(fd,&readset)) {
 #ifdef _WINDOWS
-			if ((length=recvfrom(sock,(char*)buffer,sizeof(buffer),0,(struct sockaddr*)&from,(int *)&socklen)) < 2)
+			if ((length=recvfrom(fd,(char*)buffer,sizeof(buffer),0,(struct sockaddr*)&from,(int *)&socklen)) < 2)
 #else
-			if ((length=recvfrom(sock,buffer,2048,0,(struct sockaddr *)&from,(socklen_t *)&socklen)) < 2)
+			if ((length=recvfrom(fd,buffer,2048,0,(struct sockaddr *)&from,(socklen_t *)&socklen)) < 2)
 #endif
 			{
 				// What do we wanna do?
 			} else {
-				MStreams.lock();
-				stream_itr = Streams.find(std::make_pair(from.sin_addr.s_addr, from.sin_port));
-				if (stream_itr == Streams.end()) {
-					if (buffer[1]==OP_SessionRequest) {
-						std::shared_ptr<EQStream> s = std::make_shared<EQStream>(from);
-						s->SetStreamType(StreamType);
-						Streams[std::make_pair(from.sin_addr.s_addr, from.sin_port)]=s;
-						WriterWork.Signal();
-						Push(s);
-						s->AddBytesRecv(length);
-						s->Process(buffer,length);
-						s->SetLastPacketTime(Timer::GetCurrentTime());
-					}
-					MStreams.unlock();
-				} else {
-					std::shared_ptr<EQStream> curstream = stream_itr->second;
-					//dont bother processing incoming packets for closed connections
-					if(curstream->CheckClosed())
-						curstream = nullptr;
-					else
-						curstream->PutInUse();
-						//the in use flag prevents the stream from being deleted while we are using it.
-
-					if(curstream) {
-						curstream->AddBytesRecv(length);
-						curstream->Process(buffer,length);
-						curstream->SetLastPacketTime(Timer::GetCurrentTime());
-						curstream->ReleaseFromUse();
-					}
-					MStreams.unlock();
-				}
+				HandleDatagram(buffer,length,from);
 			}
 		}
 	}
 }
+#endif
 
 void EQStreamFactory::CheckTimeout()
 {
-	//lock streams the entire time were checking timeouts, it should be fast.
-	MStreams.lock();
-
 	unsigned long now=Timer::GetCurrentTime();
-	std::map<std::pair<uint32, uint16>, std::shared_ptr<EQStream>>::iterator stream_itr;
 
-	for(stream_itr = Streams.begin(); stream_itr != Streams.end();) {
-		std::shared_ptr<EQStream> s = stream_itr->second;
+	//lock each shard the entire time were checking its timeouts, it should be fast.
+	for (int i = 0; i < EQSTREAM_FACTORY_SHARDS; ++i) {
+		StreamShard &shard = Shards[i];
+		shard.lock.lock();
 
-		s->CheckTimeout(now, stream_timeout);
+		auto stream_itr = shard.streams.begin();
+		while (stream_itr != shard.streams.end()) {
+			std::shared_ptr<EQStream> s = stream_itr->second;
 
-		EQStreamState state = s->GetState();
+			s->CheckTimeout(now, stream_timeout);
 
-		//not part of the else so we check it right away on state change
-		if (state==CLOSED) {
-			if (s->IsInUse()) {
-				//give it a little time for everybody to finish with it
-			} else {
-				//everybody is done, we can delete it now
-				std::map<std::pair<uint32, uint16>, std::shared_ptr<EQStream>>::iterator temp = stream_itr;
-				++stream_itr;
-				temp->second = nullptr;
-				Streams.erase(temp);
-				continue;
+			EQStreamState state = s->GetState();
+
+			//not part of the else so we check it right away on state change
+			if (state==CLOSED) {
+				if (s->IsInUse()) {
+					//give it a little time for everybody to finish with it
+				} else {
+					//everybody is done, we can delete it now
+					stream_itr = shard.streams.erase(stream_itr);
+					continue;
+				}
 			}
-		}
 
-		++stream_itr;
+			++stream_itr;
+		}
+		shard.lock.unlock();
 	}
-	MStreams.unlock();
 }
 
 void EQStreamFactory::WriterLoop()
 {
-	std::map<std::pair<uint32, uint16>, std::shared_ptr<EQStream>>::iterator stream_itr;
-	bool havework=true;
 	std::vector<std::shared_ptr<EQStream>> wants_write;
 	std::vector<std::shared_ptr<EQStream>>::iterator cur, end;
 	bool decay = false;
-	uint32 stream_count;
 	Timer DecayTimer(20);
-	WriterRunning = true;
 	DecayTimer.Enable();
+	send_batch.SetSocket(sock);
 
-	while(sock!=-1) {
-		MWriterRunning.lock();
-		if (!WriterRunning)
-			break;
-		MWriterRunning.unlock();
-
-		havework = false;
+	while(sock!=-1 && IsWriterRunning()) {
 		wants_write.clear();
 
 		decay=DecayTimer.Check();
 
 		//copy streams into a seperate list so we dont have to keep
-		//MStreams locked while we are writting
-		MStreams.lock();
-		for(stream_itr=Streams.begin();stream_itr!=Streams.end();++stream_itr) {
-			// If it's time to decay the bytes sent, then let's do it before we try to write
-			if (decay)
-				stream_itr->second->Decay();
-
-			//bullshit checking, to see if this is really happening, GDB seems to think so...
-			if(stream_itr->second == nullptr) {
-				fprintf(stderr, "ERROR: nullptr Stream encountered in EQStreamFactory::WriterLoop for: %i:%i", stream_itr->first.first, stream_itr->first.second);
-				continue;
-			}
-
-			if (stream_itr->second->HasOutgoingData()) {
-				havework=true;
-				stream_itr->second->PutInUse();
-				wants_write.push_back(stream_itr->second);
+		//the shards locked while we are writting
+		for (int i = 0; i < EQSTREAM_FACTORY_SHARDS; ++i) {
+			StreamShard &shard = Shards[i];
+			shard.lock.lock();
+			for (auto stream_itr = shard.streams.begin(); stream_itr != shard.streams.end(); ++stream_itr) {
+				// If it's time to decay the bytes sent, then let's do it before we try to write
+				if (decay)
+					stream_itr->second->Decay();
+
+				if (stream_itr->second->HasOutgoingData()) {
+					stream_itr->second->PutInUse();
+					wants_write.push_back(stream_itr->second);
+				}
 			}
+			shard.lock.unlock();
 		}
-		MStreams.unlock();
 
-		//do the actual writes
+		//do the actual writes, every stream's datagrams go out together in as few sendmmsg calls as possible
 		cur = wants_write.begin();
 		end = wants_write.end();
 		for(; cur != end; ++cur) {
-			(*cur)->Write(sock);
+			(*cur)->Write(sock, &send_batch);
 			(*cur)->ReleaseFromUse();
 		}
+		send_batch.Flush();
 
 		Sleep(10);
 
-		MStreams.lock();
-		stream_count = Streams.size();
-		MStreams.unlock();
-		if (!stream_count) {
+		//count again after sleeping, streams opened while we slept have already signaled
+		if (!GetStreamCount()) {
 			WriterWork.Wait();
 		}
 	}
 }
-
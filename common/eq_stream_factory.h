@@ -2,22 +2,38 @@
 
 #define _EQSTREAMFACTORY_H
 
+#include <atomic>
 #include <memory>
 #include <queue>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "../common/eq_stream.h"
 #include "../common/condition.h"
 #include "../common/timeoutmgr.h"
 
+//the stream table is split into this many independently locked shards, keyed on ip:port
+#define EQSTREAM_FACTORY_SHARDS 16
+#define EQSTREAM_FACTORY_RECV_BATCH 32
+
 class EQStream;
 class Timer;
+namespace EQEmu { class EventWaiter; }
 
 class EQStreamFactory : private Timeoutable {
 	private:
+		struct StreamShard {
+			std::unordered_map<uint64, std::shared_ptr<EQStream>> streams;
+			Mutex lock;
+		};
+
 		int sock;
 		int Port;
 
+		//extra sockets bound to the same port with SO_REUSEPORT, each gets its own reader thread
+		std::vector<int> reader_socks;
+		int reader_threads;
+
 		bool ReaderRunning;
 		Mutex MReaderRunning;
 		bool WriterRunning;
@@ -30,8 +46,7 @@ class EQStreamFactory : private Timeoutable {
 		std::queue<std::shared_ptr<EQStream>> NewStreams;
 		Mutex MNewStreams;
 
-		std::map<std::pair<uint32, uint16>, std::shared_ptr<EQStream>> Streams;
-		Mutex MStreams;
+		StreamShard Shards[EQSTREAM_FACTORY_SHARDS];
 
 		virtual void CheckTimeout();
 
@@ -39,8 +54,26 @@ class EQStreamFactory : private Timeoutable {
 
 		uint32 stream_timeout;
 
+		EQEmu::EventWaiter *wakeup;
+
+		//the writer's datagram buffers, kept between passes instead of being allocated for each one
+		EQStreamSendBatch send_batch;
+
+		//reader and writer threads that haven't returned yet, Close waits for these
+		std::atomic<int> running_threads;
+		friend ThreadReturnType EQStreamFactoryReaderLoop(void *args);
+		friend ThreadReturnType EQStreamFactoryWriterLoop(void *eqfs);
+
+		static uint64 StreamKey(uint32 ip, uint16 port) { return (static_cast<uint64>(ip) << 16) | port; }
+		StreamShard &GetShard(uint64 key) { return Shards[(key ^ (key >> 17)) % EQSTREAM_FACTORY_SHARDS]; }
+
+		int OpenSocket(bool reuse_port);
+		bool IsReaderRunning();
+		bool IsWriterRunning();
+		void HandleDatagram(const unsigned char *buffer, int length, const sockaddr_in &from);
+
 	public:
-		EQStreamFactory(EQStreamType type, uint32 timeout = 135000) : Timeoutable(5000), stream_timeout(timeout) { ReaderRunning=false; WriterRunning=false; StreamType=type; sock=-1; }
+		EQStreamFactory(EQStreamType type, uint32 timeout = 135000) : Timeoutable(5000), stream_timeout(timeout) { ReaderRunning=false; WriterRunning=false; StreamType=type; sock=-1; reader_threads=1; wakeup=nullptr; running_threads=0; }
 		EQStreamFactory(EQStreamType type, int port, uint32 timeout = 135000);
 
 		std::shared_ptr<EQStream> Pop();
@@ -49,13 +82,22 @@ class EQStreamFactory : private Timeoutable {
 		bool Open();
 		bool Open(unsigned long port) { Port=port; return Open(); }
 		bool IsOpen() { return sock!=-1; }
+		//the port actually bound, once Open has picked one for port 0
+		int GetPort() const { return Port; }
 		void Close();
-		void ReaderLoop();
+		void ReaderLoop(int fd);
 		void WriterLoop();
 		void Stop() { StopReader(); StopWriter(); }
 		void StopReader() { MReaderRunning.lock(); ReaderRunning=false; MReaderRunning.unlock(); }
 		void StopWriter() { MWriterRunning.lock(); WriterRunning=false; MWriterRunning.unlock(); WriterWork.Signal(); }
 		void SignalWriter() { WriterWork.Signal(); }
+
+		//must be called before Open, values above 1 only take effect where SO_REUSEPORT exists
+		void SetReaderThreads(int count) { reader_threads = count < 1 ? 1 : count; }
+		int GetReaderThreads() const { return reader_threads; }
+		//signaled from the reader threads whenever a new stream is ready to Pop
+		void SetWakeup(EQEmu::EventWaiter *waiter) { wakeup = waiter; }
+		uint32 GetStreamCount();
 };
 
 #endif
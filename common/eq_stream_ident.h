@@ -24,6 +24,7 @@ public:
 	void Process();
 	void AddStream(std::shared_ptr<EQStream> &eqs);
 	EQStreamInterface *PopIdentified();
+	inline bool HasPending() const { return !m_streams.empty(); }
 
 protected:
 
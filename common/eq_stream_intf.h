@@ -15,6 +15,7 @@ typedef enum {
 } EQStreamState;
 
 class EQApplicationPacket;
+class StructStrategy;
 
 class EQStreamInterface {
 public:
@@ -36,6 +37,12 @@ public:
 	virtual const uint32 GetBytesSentPerSecond() const { return 0; }
 	virtual const uint32 GetBytesRecvPerSecond() const { return 0; }
 	virtual const ClientVersion GetClientVersion() const { return ClientVersion::Unknown; }
+
+	//used by EQStreamBroadcast to share one encode between every stream of a client version.
+	//streams without a struct strategy return nullptr and are sent to with QueuePacket instead.
+	virtual const StructStrategy *GetStructStrategy() const { return nullptr; }
+	//queues a packet which has already been through GetStructStrategy()'s encoder, does not take ownership.
+	virtual void QueueEncodedPacket(const EQApplicationPacket *p, bool ack_req=true) { QueuePacket(p, ack_req); }
 };
 
 #endif /*EQSTREAMINTF_H_*/
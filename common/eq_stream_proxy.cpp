@@ -40,6 +40,13 @@ void EQStreamProxy::FastQueuePacket(EQApplicationPacket **p, bool ack_req) {
 	m_structs->Encode(p, m_stream, ack_req);
 }
 
+void EQStreamProxy::QueueEncodedPacket(const EQApplicationPacket *p, bool ack_req) {
+	if(p == nullptr)
+		return;
+	//already encoded for our client version, goes straight to the stream
+	m_stream->QueuePacket(p, ack_req);
+}
+
 EQApplicationPacket *EQStreamProxy::PopPacket() {
 	EQApplicationPacket *pack = m_stream->PopPacket();
 	if(pack == nullptr)
@@ -29,6 +29,8 @@ public:
 	virtual bool CheckState(EQStreamState state);
 	virtual std::string Describe() const;
 	virtual const ClientVersion GetClientVersion() const;
+	virtual const StructStrategy *GetStructStrategy() const { return m_structs; }
+	virtual void QueueEncodedPacket(const EQApplicationPacket *p, bool ack_req=true);
 
 	virtual const uint32 GetBytesSent() const;
 	virtual const uint32 GetBytesRecieved() const;
@@ -22,6 +22,9 @@
 #include "string_util.h"
 #include "database.h"
 #include "misc.h"
+#include "mutex.h"
+#include "event_waiter.h"
+#include "log_ring_buffer.h"
 
 #include <iostream>
 #include <fstream>
@@ -42,8 +45,52 @@ std::ofstream process_log;
 #else
 	#include <unistd.h>
 	#include <sys/stat.h>
+	#include <pthread.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/* Bytes of queued log lines per thread, lines that don't fit are dropped rather than stalling the thread */
+#define LOG_QUEUE_SIZE (512 * 1024)
+/* Bytes a thread's queue starts out with, it grows up to LOG_QUEUE_SIZE when a thread logs faster than that */
+#define LOG_QUEUE_INITIAL_SIZE (4 * 1024)
+/* How often (ms) the writer thread writes out the queues */
+#define LOG_WRITER_INTERVAL 20
+
+/* A thread's queue of lines for the writer */
+struct LogQueue {
+	LogQueue() : ring(LOG_QUEUE_SIZE, LOG_QUEUE_INITIAL_SIZE), retired(false) { }
+
+	EQEmu::LogRingBuffer ring;
+	std::atomic<bool> retired; /* Set when the thread exits, whoever drains it next deletes it */
+};
+
+struct EQEmuLogSys::AsyncWriter {
+	Mutex lock; /* Held while writing, the writer thread and Flush take turns emptying the queues */
+	Mutex queues_lock; /* Guards queues */
+	std::vector<LogQueue*> queues; /* One per thread that has logged, removed once the thread has exited and it is drained */
+	EQEmu::EventWaiter wakeup;
+	std::atomic<bool> running;
+	std::atomic<bool> thread_running;
+};
+
+/* Retires the thread's queue when the thread exits */
+struct LogQueueOwner {
+	LogQueueOwner() : queue(nullptr) { }
+	~LogQueueOwner() {
+		if (queue)
+			queue->retired.store(true, std::memory_order_release);
+		queue = nullptr;
+	}
+
+	LogQueue *queue;
+};
+
+/* The calling thread's queue, created the first time it logs */
+static thread_local LogQueueOwner thread_log_queue;
+
 /* Linux ANSI console color defines */
 #define LC_RESET   "\033[0m"
 #define LC_BLACK   "\033[30m"      /* Black */
@@ -79,12 +126,28 @@ namespace Console {
 EQEmuLogSys::EQEmuLogSys()
 {
 	on_log_gmsay_hook = [](uint16 log_type, const std::string&) {};
-	bool file_logs_enabled = false;
-	int log_platform = 0;
+	file_logs_enabled = false;
+	log_platform = 0;
+	time_stamp_time = 0;
+	time_stamp_cache[0] = 0;
+
+	writer = new AsyncWriter;
+	writer->running = false;
+	writer->thread_running = false;
 }
 
 EQEmuLogSys::~EQEmuLogSys()
 {
+	if (writer->running) {
+		writer->running = false;
+		writer->wakeup.Signal();
+		while (writer->thread_running)
+			Sleep(1);
+	}
+
+	Flush();
+
+	/* The writer and the queues are left alone, other threads can still be logging while the process exits */
 }
 
 void EQEmuLogSys::LoadLogSettingsDefaults()
@@ -147,7 +210,7 @@ void EQEmuLogSys::ProcessGMSay(uint16 debug_level, uint16 log_category, const st
 		on_log_gmsay_hook(log_category, message);
 }
 
-void EQEmuLogSys::ProcessLogWrite(uint16 debug_level, uint16 log_category, const std::string &message)
+void EQEmuLogSys::ProcessLogWrite(uint16 debug_level, uint16 log_category, const std::string &message, uint32 time)
 {
 	if (log_category == Logs::Crash) {
 		char time_stamp[80];
@@ -167,11 +230,9 @@ void EQEmuLogSys::ProcessLogWrite(uint16 debug_level, uint16 log_category, const
 	if (log_settings[log_category].log_to_file < debug_level)
 		return;
 
-	char time_stamp[80];
-	EQEmuLogSys::SetCurrentTimeStamp(time_stamp);
-
+	/* Flushed by the writer once it has written what was queued */
 	if (process_log)
-		process_log << time_stamp << " " << message << std::endl;
+		process_log << GetTimeStamp(time) << " " << message << "\n";
 }
 
 uint16 EQEmuLogSys::GetWindowsConsoleColorFromCategory(uint16 log_category) {
@@ -266,29 +327,199 @@ void EQEmuLogSys::ProcessConsoleMessage(uint16 debug_level, uint16 log_category,
 		std::cout << message << "\n";
 		SetConsoleTextAttribute(console_handle, Console::Color::White);
 	#else
-		std::cout << EQEmuLogSys::GetLinuxConsoleColorFromCategory(log_category) << message << LC_RESET << std::endl;
+		std::cout << EQEmuLogSys::GetLinuxConsoleColorFromCategory(log_category) << message << LC_RESET << "\n";
 	#endif
 }
 
-void EQEmuLogSys::Out(Logs::DebugLevel debug_level, uint16 log_category, std::string message, ...)
+void EQEmuLogSys::Out(Logs::DebugLevel debug_level, uint16 log_category, const char *message, ...)
 {
-	const bool log_to_console = log_settings[log_category].log_to_console > 0;
-	const bool log_to_file = log_settings[log_category].log_to_file > 0;
-	const bool log_to_gmsay = log_settings[log_category].log_to_gmsay > 0;
-	const bool nothing_to_log = !log_to_console && !log_to_file && !log_to_gmsay;
+	if (!IsLogEnabled(debug_level, log_category))
+		return;
 
-	if (nothing_to_log) return;
+	va_list args;
+	va_start(args, message);
+	OutV(debug_level, log_category, message, args);
+	va_end(args);
+}
+
+void EQEmuLogSys::Out(Logs::DebugLevel debug_level, uint16 log_category, std::string message, ...)
+{
+	if (!IsLogEnabled(debug_level, log_category))
+		return;
 
 	va_list args;
 	va_start(args, message);
-	std::string output_message = vStringFormat(message.c_str(), args);
+	OutV(debug_level, log_category, message.c_str(), args);
 	va_end(args);
+}
+
+void EQEmuLogSys::OutV(Logs::DebugLevel debug_level, uint16 log_category, const char *message, va_list args)
+{
+	if (!IsLogEnabled(debug_level, log_category))
+		return;
+
+	/* Format '[Category] message' on the stack, only lines that don't fit go through the heap */
+	char buffer[4096];
+	int length = 0;
+	if (log_category > 0 && Logs::LogCategoryName[log_category])
+		length = snprintf(buffer, sizeof(buffer), "[%s] ", Logs::LogCategoryName[log_category]);
+
+	va_list args_copy;
+	va_copy(args_copy, args);
+	int message_length = vsnprintf(buffer + length, sizeof(buffer) - length, message, args_copy);
+	va_end(args_copy);
+
+	std::string long_line;
+	const char *line = buffer;
+	if (message_length < 0) {
+		buffer[length] = 0;
+	}
+	else if (length + message_length >= (int)sizeof(buffer)) {
+		long_line = EQEmuLogSys::FormatOutMessageString(log_category, vStringFormat(message, args));
+		line = long_line.c_str();
+		length = long_line.length();
+	}
+	else {
+		length += message_length;
+	}
+
+	const LogSettings &settings = log_settings[log_category];
+	if (settings.log_to_gmsay >= debug_level)
+		EQEmuLogSys::ProcessGMSay(debug_level, log_category, std::string(line, length));
+
+	if (settings.log_to_console < debug_level && settings.log_to_file < debug_level)
+		return;
+
+	/* Crash logs are written right away, after whatever was queued before them */
+	if (log_category != Logs::Crash && QueueLine(debug_level, log_category, line, length))
+		return;
+
+	if (writer->lock.trylock()) {
+		DrainQueues();
+		WriteLine(debug_level, log_category, std::string(line, length), time(nullptr));
+		std::cout.flush();
+		if (process_log)
+			process_log.flush();
+		writer->lock.unlock();
+	}
+	else {
+		/* Only when crashing while the writer is busy, better out of order than lost */
+		WriteLine(debug_level, log_category, std::string(line, length), time(nullptr));
+	}
+}
+
+bool EQEmuLogSys::QueueLine(uint16 debug_level, uint16 log_category, const char *line, uint32 length)
+{
+	LogQueue *queue = thread_log_queue.queue;
+	if (!queue) {
+		writer->queues_lock.lock();
+		if (!writer->running && !writer->thread_running) {
+			writer->running = true;
+			writer->thread_running = true;
+#ifdef _WINDOWS
+			_beginthread(WriterLoop, 0, this);
+#else
+			pthread_t thread;
+			pthread_create(&thread, nullptr, WriterLoop, this);
+			pthread_detach(thread);
+#endif
+		}
+
+		queue = new LogQueue;
+		writer->queues.push_back(queue);
+		writer->queues_lock.unlock();
+		thread_log_queue.queue = queue;
+	}
+
+	if (!writer->running)
+		return false;
+
+	/* A full queue counts the line as dropped, the writer reports how many */
+	queue->ring.Push(debug_level, log_category, (uint32)time(nullptr), line, length);
+	return true;
+}
+
+ThreadReturnType EQEmuLogSys::WriterLoop(void *arg)
+{
+	EQEmuLogSys *log = (EQEmuLogSys*)arg;
+	AsyncWriter *writer = log->writer;
+
+	while (writer->running) {
+		writer->wakeup.Wait(LOG_WRITER_INTERVAL);
+
+		writer->lock.lock();
+		log->DrainQueues();
+		writer->lock.unlock();
+	}
+
+	writer->thread_running = false;
+	THREAD_RETURN(nullptr);
+}
+
+void EQEmuLogSys::DrainQueues()
+{
+	writer->queues_lock.lock();
+	std::vector<LogQueue*> queues = writer->queues;
+	writer->queues_lock.unlock();
+
+	uint32 written = 0;
+	uint32 dropped = 0;
+	std::vector<LogQueue*> retired;
+	for (auto queue : queues) {
+		/* Checked first, a thread's last lines are queued before it retires the queue */
+		bool exited = queue->retired.load(std::memory_order_acquire);
+
+		written += queue->ring.Pop([this](const EQEmu::LogRingBuffer::Line &line) {
+			WriteLine(line.debug_level, line.log_category, std::string(line.text, line.length), line.time);
+		});
+		dropped += queue->ring.TakeDropped();
+
+		if (exited)
+			retired.push_back(queue);
+	}
+
+	if (!retired.empty()) {
+		writer->queues_lock.lock();
+		for (auto queue : retired) {
+			writer->queues.erase(std::find(writer->queues.begin(), writer->queues.end(), queue));
+			delete queue;
+		}
+		writer->queues_lock.unlock();
+	}
+
+	if (dropped > 0) {
+		std::string message = FormatOutMessageString(Logs::Status, StringFormat("%u log lines were dropped, the log queue was full", dropped));
+		WriteLine(Logs::General, Logs::Status, message, (uint32)time(nullptr));
+	}
+
+	if (written > 0 || dropped > 0) {
+		std::cout.flush();
+		if (process_log)
+			process_log.flush();
+	}
+}
 
-	std::string output_debug_message = EQEmuLogSys::FormatOutMessageString(log_category, output_message);
+void EQEmuLogSys::WriteLine(uint16 debug_level, uint16 log_category, const std::string &message, uint32 time)
+{
+	EQEmuLogSys::ProcessConsoleMessage(debug_level, log_category, message);
+	EQEmuLogSys::ProcessLogWrite(debug_level, log_category, message, time);
+}
 
-	if (log_to_console) EQEmuLogSys::ProcessConsoleMessage(debug_level, log_category, output_debug_message);
-	if (log_to_gmsay) EQEmuLogSys::ProcessGMSay(debug_level, log_category, output_debug_message);
-	if (log_to_file) EQEmuLogSys::ProcessLogWrite(debug_level, log_category, output_debug_message);
+void EQEmuLogSys::Flush()
+{
+	writer->lock.lock();
+	DrainQueues();
+	writer->lock.unlock();
+}
+
+const char *EQEmuLogSys::GetTimeStamp(uint32 time)
+{
+	if (time != time_stamp_time || time_stamp_cache[0] == 0) {
+		time_t raw_time = time;
+		strftime(time_stamp_cache, sizeof(time_stamp_cache), "[%m-%d-%Y :: %H:%M:%S]", localtime(&raw_time));
+		time_stamp_time = time;
+	}
+	return time_stamp_cache;
 }
 
 void EQEmuLogSys::SetCurrentTimeStamp(char* time_stamp)
@@ -317,9 +548,12 @@ void EQEmuLogSys::MakeDirectory(const std::string &directory_name)
 
 void EQEmuLogSys::CloseFileLogs()
 {
+	writer->lock.lock();
+	DrainQueues();
 	if (process_log.is_open()) {
 		process_log.close();
 	}
+	writer->lock.unlock();
 }
 
 void EQEmuLogSys::StartFileLogs(const std::string &log_name)
@@ -339,12 +573,16 @@ void EQEmuLogSys::StartFileLogs(const std::string &log_name)
 
 		EQEmuLogSys::Out(Logs::General, Logs::Status, "Starting File Log 'logs/%s_%i.log'", platform_file_name.c_str(), getpid());
 		EQEmuLogSys::MakeDirectory("logs/zone");
+		writer->lock.lock();
 		process_log.open(StringFormat("logs/zone/%s_%i.log", platform_file_name.c_str(), getpid()), std::ios_base::app | std::ios_base::out);
+		writer->lock.unlock();
 	} else {
 		if (platform_file_name.empty())
 			return;
 
 		EQEmuLogSys::Out(Logs::General, Logs::Status, "Starting File Log 'logs/%s_%i.log'", platform_file_name.c_str(), getpid());
+		writer->lock.lock();
 		process_log.open(StringFormat("logs/%s_%i.log", platform_file_name.c_str(), getpid()), std::ios_base::app | std::ios_base::out);
+		writer->lock.unlock();
 	}
 }
@@ -22,10 +22,18 @@
 #include <iostream>
 #include <fstream>
 #include <stdio.h>
+#include <stdarg.h>
 #include <functional>
 
 #include "types.h"
 
+/* Lets the compiler check Log.Out format strings against their arguments */
+#ifdef __GNUC__
+	#define EQEMU_LOG_FORMAT(fmt_index, args_index) __attribute__((format(printf, fmt_index, args_index)))
+#else
+	#define EQEMU_LOG_FORMAT(fmt_index, args_index)
+#endif
+
 namespace Logs {
 	enum DebugLevel {
 		General = 1,	/* 1 - Low-Level general debugging, useful info on single line */
@@ -150,7 +158,19 @@ public:
 			- This would pipe the same category and debug level to all output formats, but the internal memory reference of log_settings would
 				be checked against to see if that piped output is set to actually process it for the category and debug level
 	*/
-	void Out(Logs::DebugLevel debug_level, uint16 log_category, std::string message, ...);
+	void Out(Logs::DebugLevel debug_level, uint16 log_category, const char *message, ...) EQEMU_LOG_FORMAT(4, 5);
+	void Out(Logs::DebugLevel debug_level, uint16 log_category, std::string message, ...); /* For messages built at runtime, e.g. quest logs */
+	/*
+		Console and file output is queued and written by a background thread, each thread that logs gets
+		its own lock free queue for that. GMSay output and crash logs are still written by the caller.
+		Flush blocks until everything queued so far has been written.
+	*/
+	void Flush();
+	/* Cheap check for whether a log line would go anywhere, to skip building expensive arguments */
+	inline bool IsLogEnabled(Logs::DebugLevel debug_level, uint16 log_category) const {
+		const LogSettings &settings = log_settings[log_category];
+		return settings.log_to_console >= debug_level || settings.log_to_file >= debug_level || settings.log_to_gmsay >= debug_level;
+	}
 	void SetCurrentTimeStamp(char* time_stamp); /* Used in file logs to prepend a timestamp entry for logs */ 
 	void StartFileLogs(const std::string &log_name = ""); /* Used to declare the processes file log and to keep it open for later use */
 
@@ -194,9 +214,22 @@ private:
 
 	uint16 GetWindowsConsoleColorFromCategory(uint16 log_category); /* Windows console color messages mapped by category */
 
-	void ProcessConsoleMessage(uint16 debug_level, uint16 log_category, const std::string &message); /* ProcessConsoleMessage called via Log.Out */
+	void ProcessConsoleMessage(uint16 debug_level, uint16 log_category, const std::string &message); /* ProcessConsoleMessage called by the log writer */
 	void ProcessGMSay(uint16 debug_level, uint16 log_category, const std::string &message); /* ProcessGMSay called via Log.Out */
-	void ProcessLogWrite(uint16 debug_level, uint16 log_category, const std::string &message); /* ProcessLogWrite called via Log.Out */
+	void ProcessLogWrite(uint16 debug_level, uint16 log_category, const std::string &message, uint32 time); /* ProcessLogWrite called by the log writer */
+
+	void OutV(Logs::DebugLevel debug_level, uint16 log_category, const char *message, va_list args); /* Formats and dispatches for both Out overloads */
+	bool QueueLine(uint16 debug_level, uint16 log_category, const char *line, uint32 length); /* Queues for the writer thread, false if it isn't running or the queue is full */
+	void WriteLine(uint16 debug_level, uint16 log_category, const std::string &message, uint32 time); /* Console and file output, the writer lock must be held */
+	void DrainQueues(); /* Writes everything queued, the writer lock must be held */
+	const char *GetTimeStamp(uint32 time); /* SetCurrentTimeStamp, redone only when the second changes */
+
+	static ThreadReturnType WriterLoop(void *arg);
+
+	struct AsyncWriter;
+	AsyncWriter *writer;
+	char time_stamp_cache[80];
+	uint32 time_stamp_time;
 };
 
 extern EQEmuLogSys Log;
@@ -0,0 +1,143 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "event_waiter.h"
+
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#else
+#include <poll.h>
+#endif
+#endif
+
+namespace EQEmu {
+
+#ifdef _WINDOWS
+
+	EventWaiter::EventWaiter() : pending_(false) {
+		event_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	}
+
+	EventWaiter::~EventWaiter() {
+		CloseHandle((HANDLE)event_);
+	}
+
+	void EventWaiter::Signal() {
+		if (!pending_.exchange(true))
+			SetEvent((HANDLE)event_);
+	}
+
+	bool EventWaiter::AddDescriptor(int fd) {
+		return false;
+	}
+
+	bool EventWaiter::Wait(uint32 timeout) {
+		bool woken = WaitForSingleObject((HANDLE)event_, timeout) == WAIT_OBJECT_0;
+		pending_ = false;
+		return woken;
+	}
+
+#else
+
+	EventWaiter::EventWaiter() : pending_(false), poll_fd_(-1), signal_fd_(-1), signal_write_fd_(-1) {
+#ifdef __linux__
+		signal_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		signal_write_fd_ = signal_fd_;
+		poll_fd_ = epoll_create(4);
+		AddDescriptor(signal_fd_);
+#else
+		int fds[2];
+		if (pipe(fds) == 0) {
+			fcntl(fds[0], F_SETFL, O_NONBLOCK);
+			fcntl(fds[1], F_SETFL, O_NONBLOCK);
+			signal_fd_ = fds[0];
+			signal_write_fd_ = fds[1];
+		}
+#endif
+	}
+
+	EventWaiter::~EventWaiter() {
+		if (poll_fd_ != -1)
+			close(poll_fd_);
+		if (signal_write_fd_ != -1 && signal_write_fd_ != signal_fd_)
+			close(signal_write_fd_);
+		if (signal_fd_ != -1)
+			close(signal_fd_);
+	}
+
+	void EventWaiter::Signal() {
+		// only the first signal since the last wakeup needs to reach the kernel
+		if (pending_.exchange(true))
+			return;
+
+#ifdef __linux__
+		uint64 one = 1;
+		ssize_t ret = write(signal_write_fd_, &one, sizeof(one));
+#else
+		char one = 1;
+		ssize_t ret = write(signal_write_fd_, &one, sizeof(one));
+#endif
+		(void)ret;
+	}
+
+	bool EventWaiter::AddDescriptor(int fd) {
+#ifdef __linux__
+		if (poll_fd_ == -1 || fd == -1)
+			return false;
+
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.fd = fd;
+		return epoll_ctl(poll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+#else
+		return false;
+#endif
+	}
+
+	bool EventWaiter::Wait(uint32 timeout) {
+		int ready;
+#ifdef __linux__
+		struct epoll_event events[8];
+		ready = epoll_wait(poll_fd_, events, 8, (int)timeout);
+#else
+		struct pollfd pfd;
+		pfd.fd = signal_fd_;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		ready = poll(&pfd, 1, (int)timeout);
+#endif
+
+		// clear the flag before draining so a signal racing with us costs a spurious wakeup, not a lost one
+		pending_ = false;
+		char drain[64];
+		while (read(signal_fd_, drain, sizeof(drain)) > 0)
+			;
+
+		return ready > 0;
+	}
+
+#endif
+
+} // EQEmu
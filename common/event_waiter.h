@@ -0,0 +1,63 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_EVENT_WAITER_H
+#define _EQEMU_EVENT_WAITER_H
+
+#include "types.h"
+#include <atomic>
+
+namespace EQEmu {
+
+	//! Lets a main loop sleep until it has work
+	/*!
+		Other threads call Signal() when they queue something for the loop, the loop calls Wait() with
+		the time until its next timer is due. On Linux this is an eventfd in an epoll set, so sockets
+		the loop reads itself can be added to the same set. Signals that come in while one is already
+		pending are folded into it, so a busy producer doesn't make a syscall for every item.
+	*/
+	class EventWaiter {
+	public:
+		EventWaiter();
+		~EventWaiter();
+
+		//! Wakes Wait(), safe to call from any thread.
+		void Signal();
+
+		//! Also wake up when this descriptor becomes readable; only supported on Linux.
+		bool AddDescriptor(int fd);
+
+		//! Waits until signaled, a descriptor is readable or the timeout (ms) passes. Returns false on timeout.
+		bool Wait(uint32 timeout);
+	private:
+		EventWaiter(const EventWaiter&);
+		const EventWaiter& operator=(const EventWaiter&);
+
+		std::atomic<bool> pending_;
+#ifdef _WINDOWS
+		void *event_;
+#else
+		int poll_fd_;
+		int signal_fd_;
+		int signal_write_fd_;
+#endif
+	};
+
+} // EQEmu
+
+#endif
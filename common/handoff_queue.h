@@ -0,0 +1,100 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEmu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_HANDOFF_QUEUE_H
+#define _EQEMU_HANDOFF_QUEUE_H
+
+#include <atomic>
+
+namespace EQEmu {
+
+	//! Many producer, one consumer queue that never makes a producer wait
+	/*!
+		Push links a node onto a shared list with a single compare and swap. When the consumer runs
+		out of items it swaps the whole shared list out at once and reverses it, so items still come
+		out in the order they went in. Only one thread may pop at a time, code that pops from more
+		than one thread keeps its own lock around Pop, which producers never touch.
+
+		Items are copied in and out, a queue of pointers does not own what they point to.
+	*/
+	template<typename T>
+	class HandoffQueue {
+	public:
+		HandoffQueue() : head_(nullptr), first_(nullptr) {
+		}
+
+		~HandoffQueue() {
+			T value;
+			while (Pop(value))
+				;
+		}
+
+		//! Safe from any thread. Returns true if the shared list was empty, ie this is the first push since the consumer last looked.
+		bool Push(const T &value) {
+			Node *node = new Node(value);
+			Node *head = head_.load(std::memory_order_relaxed);
+			do {
+				node->next = head;
+			} while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+			return head == nullptr;
+		}
+
+		//! Consumer only, returns false when there is nothing queued.
+		bool Pop(T &value) {
+			if (!first_) {
+				Node *node = head_.exchange(nullptr, std::memory_order_acquire);
+				while (node) {
+					Node *next = node->next;
+					node->next = first_;
+					first_ = node;
+					node = next;
+				}
+
+				if (!first_)
+					return false;
+			}
+
+			Node *node = first_;
+			first_ = node->next;
+			value = node->value;
+			delete node;
+			return true;
+		}
+
+		//! Consumer only.
+		bool Empty() const {
+			return first_ == nullptr && head_.load(std::memory_order_acquire) == nullptr;
+		}
+	private:
+		HandoffQueue(const HandoffQueue&);
+		const HandoffQueue& operator=(const HandoffQueue&);
+
+		struct Node {
+			Node(const T &v) : value(v), next(nullptr) { }
+			T value;
+			Node *next;
+		};
+
+		std::atomic<Node*> head_; // pushed onto by producers, newest first
+		Node *first_; // owned by the consumer, oldest first
+	};
+
+} // EQEmu
+
+#endif
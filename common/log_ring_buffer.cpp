@@ -0,0 +1,108 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "log_ring_buffer.h"
+#include <string.h>
+
+namespace EQEmu {
+
+	static uint32 RoundCapacity(uint32 size) {
+		uint32 capacity = 1024;
+		while (capacity < size)
+			capacity <<= 1;
+		return capacity;
+	}
+
+	LogRingBuffer::Block::Block(uint32 capacity) : buffer(capacity), mask(capacity - 1), head(0), tail(0), next(nullptr) {
+	}
+
+	LogRingBuffer::LogRingBuffer(uint32 size, uint32 initial_size) : dropped_(0) {
+		max_size_ = RoundCapacity(size);
+		max_length_ = max_size_ / 4 - sizeof(Header);
+
+		uint32 capacity = initial_size ? RoundCapacity(initial_size) : max_size_;
+		if (capacity > max_size_)
+			capacity = max_size_;
+
+		write_ = read_ = new Block(capacity);
+	}
+
+	LogRingBuffer::~LogRingBuffer() {
+		while (read_) {
+			Block *next = read_->next.load(std::memory_order_acquire);
+			delete read_;
+			read_ = next;
+		}
+	}
+
+	bool LogRingBuffer::Push(uint16 debug_level, uint16 log_category, uint32 time, const char *text, uint32 length) {
+		if (length > max_length_)
+			length = max_length_;
+
+		if (PushBlock(write_, debug_level, log_category, time, text, length))
+			return true;
+
+		uint32 capacity = (uint32)write_->buffer.size();
+		if (capacity >= max_size_) {
+			dropped_++;
+			return false;
+		}
+
+		// a quarter of the full size always fits in an empty block of at least twice the old one
+		uint32 need = RecordSize(length);
+		capacity <<= 1;
+		while (capacity < need)
+			capacity <<= 1;
+
+		Block *block = new Block(capacity);
+		PushBlock(block, debug_level, log_category, time, text, length);
+		write_->next.store(block, std::memory_order_release);
+		write_ = block;
+		return true;
+	}
+
+	bool LogRingBuffer::PushBlock(Block *block, uint16 debug_level, uint16 log_category, uint32 time, const char *text, uint32 length) {
+		uint32 head = block->head.load(std::memory_order_relaxed);
+		uint32 tail = block->tail.load(std::memory_order_acquire);
+		uint32 need = RecordSize(length);
+		uint32 size = (uint32)block->buffer.size();
+
+		// records never wrap, if this one won't fit before the end it starts over at the front
+		uint32 to_end = size - (head & block->mask);
+		uint32 skip = to_end < need ? to_end : 0;
+
+		if (size - (head - tail) < skip + need)
+			return false;
+
+		if (skip) {
+			((Header*)&block->buffer[head & block->mask])->length = WrapMarker;
+			head += skip;
+		}
+
+		Header *h = (Header*)&block->buffer[head & block->mask];
+		h->length = length;
+		h->debug_level = debug_level;
+		h->log_category = log_category;
+		h->time = time;
+		memcpy(h + 1, text, length);
+
+		block->head.store(head + need, std::memory_order_release);
+		return true;
+	}
+
+} // EQEmu
@@ -0,0 +1,147 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_LOG_RING_BUFFER_H
+#define _EQEMU_LOG_RING_BUFFER_H
+
+#include "types.h"
+#include <atomic>
+#include <vector>
+
+namespace EQEmu {
+
+	//! Single producer, single consumer queue of log lines
+	/*!
+		One thread pushes, one thread pops, neither takes a lock. Lines are copied into one block of
+		memory back to back, a header followed by the text, so pushing rarely allocates. The queue
+		starts out small and when a line doesn't fit the producer moves on to a block twice the size,
+		the consumer frees the old block once it has read it. When the queue is at its full size and
+		still has no room the line is dropped and counted instead of making the producer wait. Lines
+		longer than a quarter of the full size are cut short.
+	*/
+	class LogRingBuffer {
+	public:
+		struct Line {
+			uint16 debug_level;
+			uint16 log_category;
+			uint32 time; //!< time() when the line was pushed
+			const char *text; //!< not null terminated, only valid during the Pop() callback
+			uint32 length;
+		};
+
+		//! Constructor
+		/*!
+		\param size Most bytes of line storage, rounded up to a power of two.
+		\param initial_size Bytes to start out with, 0 to start at the full size.
+		*/
+		LogRingBuffer(uint32 size, uint32 initial_size = 0);
+		~LogRingBuffer();
+
+		//! Copies a line in, returns false (and counts it) if there was no room. Producer thread only.
+		bool Push(uint16 debug_level, uint16 log_category, uint32 time, const char *text, uint32 length);
+
+		//! Calls f(const Line&) for every line queued so far, returns how many. Consumer thread only.
+		template<typename F>
+		uint32 Pop(F f) {
+			uint32 count = 0;
+			for (;;) {
+				// the producer doesn't touch a block again once it has linked the next one, so once
+				// the link is seen what is left in the block is all it will ever hold
+				Block *next = read_->next.load(std::memory_order_acquire);
+				count += PopBlock(read_, f);
+				if (!next)
+					return count;
+
+				delete read_;
+				read_ = next;
+			}
+		}
+
+		//! Lines dropped because the buffer was full, since the last call.
+		uint32 TakeDropped() { return dropped_.exchange(0); }
+
+		//! Bytes of the block lines are being pushed to. Producer thread only.
+		uint32 Capacity() const { return (uint32)write_->buffer.size(); }
+	private:
+		LogRingBuffer(const LogRingBuffer&);
+		const LogRingBuffer& operator=(const LogRingBuffer&);
+
+		struct Header {
+			uint32 length;
+			uint16 debug_level;
+			uint16 log_category;
+			uint32 time;
+			uint32 unused;
+		};
+
+		struct Block {
+			Block(uint32 capacity);
+
+			std::vector<char> buffer;
+			uint32 mask;
+			// positions only ever grow, the index into buffer is position & mask
+			std::atomic<uint32> head; // written by the producer
+			std::atomic<uint32> tail; // written by the consumer
+			std::atomic<Block*> next; // set by the producer when it moves on to a bigger block
+		};
+
+		enum { WrapMarker = 0xFFFFFFFF };
+
+		static inline uint32 RecordSize(uint32 length) { return (sizeof(Header) + length + 7) & ~7; }
+
+		static bool PushBlock(Block *block, uint16 debug_level, uint16 log_category, uint32 time, const char *text, uint32 length);
+
+		template<typename F>
+		static uint32 PopBlock(Block *block, F &f) {
+			uint32 tail = block->tail.load(std::memory_order_relaxed);
+			uint32 head = block->head.load(std::memory_order_acquire);
+			uint32 count = 0;
+
+			while (tail != head) {
+				const Header *h = (const Header*)&block->buffer[tail & block->mask];
+				if (h->length == WrapMarker) {
+					tail += (uint32)block->buffer.size() - (tail & block->mask);
+					continue;
+				}
+
+				Line line;
+				line.debug_level = h->debug_level;
+				line.log_category = h->log_category;
+				line.time = h->time;
+				line.text = (const char*)(h + 1);
+				line.length = h->length;
+				f(line);
+
+				tail += RecordSize(h->length);
+				++count;
+			}
+
+			block->tail.store(tail, std::memory_order_release);
+			return count;
+		}
+
+		Block *write_; // the producer's block
+		Block *read_; // the consumer's block, the same one or an older one
+		uint32 max_size_;
+		uint32 max_length_;
+		std::atomic<uint32> dropped_;
+	};
+
+} // EQEmu
+
+#endif
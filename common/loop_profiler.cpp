@@ -0,0 +1,128 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "loop_profiler.h"
+#include "scope_profiler.h"
+#include "string_util.h"
+
+namespace EQEmu {
+
+	LoopProfiler::LoopProfiler(const char *const *names, int count)
+		: names_(names), phases_(count), current_(-1), in_loop_(false), waiting_(false), scopes_(nullptr), tick_scope_(0) {
+		phase_start_ = clock::now();
+		loop_start_ = phase_start_;
+		Reset();
+	}
+
+	void LoopProfiler::Reset() {
+		for (auto &p : phases_) {
+			p.total_us = 0;
+			p.max_us = 0;
+			p.count = 0;
+		}
+
+		loops_ = 0;
+		max_loop_us_ = 0;
+		wait_us_ = 0;
+		reset_at_ = clock::now();
+	}
+
+	void LoopProfiler::Phase(int phase) {
+		clock::time_point now = clock::now();
+
+		if (current_ >= 0) {
+			uint64 took = std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start_).count();
+			PhaseStats &p = phases_[current_];
+			p.total_us += took;
+			p.count++;
+			if (took > p.max_us)
+				p.max_us = took;
+
+			if (scopes_ && scopes_->IsEnabled())
+				scopes_->Record(phase_scopes_[current_], took);
+		}
+
+		if (waiting_) {
+			wait_us_ += std::chrono::duration_cast<std::chrono::microseconds>(now - phase_start_).count();
+			waiting_ = false;
+		}
+
+		if (!in_loop_) {
+			in_loop_ = true;
+			loop_start_ = now;
+		}
+
+		current_ = phase;
+		phase_start_ = now;
+	}
+
+	void LoopProfiler::EndLoop() {
+		Phase(-1);
+
+		uint64 took = std::chrono::duration_cast<std::chrono::microseconds>(phase_start_ - loop_start_).count();
+		if (took > max_loop_us_)
+			max_loop_us_ = took;
+
+		if (scopes_ && scopes_->IsEnabled())
+			scopes_->Record(tick_scope_, took);
+
+		in_loop_ = false;
+		loops_++;
+	}
+
+	void LoopProfiler::Wait() {
+		EndLoop();
+		waiting_ = true;
+	}
+
+	void LoopProfiler::SetScopeProfiler(ScopeProfiler *scopes) {
+		scopes_ = scopes;
+		phase_scopes_.clear();
+		if (!scopes_)
+			return;
+
+		tick_scope_ = scopes_->GetScope("tick");
+		for (size_t i = 0; i < phases_.size(); ++i)
+			phase_scopes_.push_back(scopes_->GetScope(std::string("phase ") + names_[i]));
+	}
+
+	uint64 LoopProfiler::GetElapsedUS() const {
+		return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - reset_at_).count();
+	}
+
+	std::string LoopProfiler::Report() const {
+		uint64 elapsed = GetElapsedUS();
+		if (elapsed == 0)
+			elapsed = 1;
+
+		std::string out = StringFormat("%llu loops in %.1fs, longest %lluus, waiting %.1f%%", (unsigned long long)loops_,
+			elapsed / 1000000.0, (unsigned long long)max_loop_us_, wait_us_ * 100.0 / elapsed);
+
+		for (size_t i = 0; i < phases_.size(); ++i) {
+			const PhaseStats &p = phases_[i];
+			if (p.count == 0)
+				continue;
+
+			out += StringFormat(" | %s %.1fus avg %lluus max %.1f%%", names_[i], (double)p.total_us / p.count,
+				(unsigned long long)p.max_us, p.total_us * 100.0 / elapsed);
+		}
+
+		return out;
+	}
+
+} // EQEmu
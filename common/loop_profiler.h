@@ -0,0 +1,98 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_LOOP_PROFILER_H
+#define _EQEMU_LOOP_PROFILER_H
+
+#include "types.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace EQEmu {
+
+	class ScopeProfiler;
+
+	//! Times the phases of a main loop
+	/*!
+		The loop calls Phase() as it moves from one stage to the next and EndLoop() when it is done,
+		the time between two calls is charged to the phase that was running. Cheap enough to leave
+		on: one clock read per phase.
+	*/
+	class LoopProfiler {
+	public:
+		struct PhaseStats {
+			uint64 total_us;
+			uint64 max_us;
+			uint64 count;
+		};
+
+		//! Constructor
+		/*!
+		\param names One name per phase id, the array must outlive the profiler.
+		\param count Number of phases.
+		*/
+		LoopProfiler(const char *const *names, int count);
+
+		//! Ends the running phase (if any) and starts the given one.
+		void Phase(int phase);
+
+		//! Ends the running phase and counts the loop.
+		void EndLoop();
+
+		//! Ends the loop, the time until the next Phase() is counted as waiting instead of as part of a loop.
+		void Wait();
+
+		//! Clears all the numbers, a phase or wait that is running keeps being timed.
+		void Reset();
+
+		const PhaseStats &GetPhase(int phase) const { return phases_[phase]; }
+		const char *GetPhaseName(int phase) const { return names_[phase]; }
+		int GetPhaseCount() const { return (int)phases_.size(); }
+		uint64 GetLoops() const { return loops_; }
+		uint64 GetMaxLoopUS() const { return max_loop_us_; }
+		uint64 GetWaitUS() const { return wait_us_; }
+		uint64 GetElapsedUS() const;
+
+		//! One line summary: loops, time spent waiting, and average/max/share of the time for each phase.
+		std::string Report() const;
+
+		//! Also records every loop as "tick" and every phase as "phase <name>" in scopes while it is enabled.
+		void SetScopeProfiler(ScopeProfiler *scopes);
+	private:
+		typedef std::chrono::steady_clock clock;
+
+		const char *const *names_;
+		std::vector<PhaseStats> phases_;
+		int current_;
+		clock::time_point phase_start_;
+		clock::time_point loop_start_;
+		clock::time_point reset_at_;
+		bool in_loop_;
+		bool waiting_;
+		uint64 loops_;
+		uint64 max_loop_us_;
+		uint64 wait_us_;
+		ScopeProfiler *scopes_;
+		uint32 tick_scope_;
+		std::vector<uint32> phase_scopes_;
+	};
+
+} // EQEmu
+
+#endif
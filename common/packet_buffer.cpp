@@ -0,0 +1,146 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEmu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "packet_buffer.h"
+#include "mutex.h"
+#include <new>
+#include <vector>
+
+#ifdef _WINDOWS
+	#define PACKET_BUFFER_THREAD_LOCAL __declspec(thread)
+#else
+	#define PACKET_BUFFER_THREAD_LOCAL __thread
+#endif
+
+/* Number of size classes, MinPooledSize << (PACKET_BUFFER_CLASSES - 1) == MaxPooledSize */
+#define PACKET_BUFFER_CLASSES 8
+/* Free buffers each thread keeps per size class, half of them move to or from the shared list at once */
+#define PACKET_BUFFER_THREAD_CACHE 32
+/* Bytes of free buffers kept per size class in the shared list, past that they go back to the heap */
+#define PACKET_BUFFER_SHARED_BYTES (1024 * 1024)
+
+/* The calling thread's free buffers, a thread that exits leaves these behind */
+static PACKET_BUFFER_THREAD_LOCAL EQEmu::PacketBuffer *thread_cache[PACKET_BUFFER_CLASSES][PACKET_BUFFER_THREAD_CACHE];
+static PACKET_BUFFER_THREAD_LOCAL uint32 thread_cache_count[PACKET_BUFFER_CLASSES];
+
+namespace EQEmu {
+
+	const uint32 PacketBuffer::MinPooledSize;
+	const uint32 PacketBuffer::MaxPooledSize;
+
+	struct PacketBufferPool {
+		Mutex lock;
+		std::vector<PacketBuffer*> shared[PACKET_BUFFER_CLASSES];
+		std::atomic<uint64> created;
+		std::atomic<uint64> heap_allocs;
+
+		PacketBufferPool() : created(0), heap_allocs(0) { }
+
+		static PacketBufferPool &Get() {
+			// never destroyed, buffers can still be released while the process exits
+			static PacketBufferPool *pool = new PacketBufferPool();
+			return *pool;
+		}
+
+		static uint32 SizeClass(uint32 size) {
+			uint32 size_class = 0;
+			for (uint32 capacity = PacketBuffer::MinPooledSize; capacity < size; capacity <<= 1)
+				++size_class;
+			return size_class;
+		}
+
+		static PacketBuffer *Allocate(uint32 capacity, uint32 size_class) {
+			void *block = ::operator new(sizeof(PacketBuffer) + capacity);
+			return new (block) PacketBuffer(capacity, size_class);
+		}
+
+		static void Free(PacketBuffer *buffer) {
+			buffer->~PacketBuffer();
+			::operator delete(buffer);
+		}
+
+		void Refill(uint32 size_class) {
+			LockMutex l(&lock);
+			std::vector<PacketBuffer*> &list = shared[size_class];
+			while (!list.empty() && thread_cache_count[size_class] < PACKET_BUFFER_THREAD_CACHE / 2) {
+				thread_cache[size_class][thread_cache_count[size_class]++] = list.back();
+				list.pop_back();
+			}
+		}
+
+		void Spill(uint32 size_class) {
+			LockMutex l(&lock);
+			std::vector<PacketBuffer*> &list = shared[size_class];
+			size_t limit = PACKET_BUFFER_SHARED_BYTES / (PacketBuffer::MinPooledSize << size_class);
+			while (thread_cache_count[size_class] > PACKET_BUFFER_THREAD_CACHE / 2) {
+				PacketBuffer *buffer = thread_cache[size_class][--thread_cache_count[size_class]];
+				if (list.size() < limit)
+					list.push_back(buffer);
+				else
+					Free(buffer);
+			}
+		}
+	};
+
+	PacketBuffer *PacketBuffer::Create(uint32 size) {
+		PacketBufferPool &pool = PacketBufferPool::Get();
+		pool.created.fetch_add(1, std::memory_order_relaxed);
+
+		uint32 size_class = PacketBufferPool::SizeClass(size);
+		if (size_class >= PACKET_BUFFER_CLASSES) {
+			pool.heap_allocs.fetch_add(1, std::memory_order_relaxed);
+			return PacketBufferPool::Allocate(size, PACKET_BUFFER_CLASSES);
+		}
+
+		if (thread_cache_count[size_class] == 0)
+			pool.Refill(size_class);
+
+		if (thread_cache_count[size_class] > 0) {
+			PacketBuffer *buffer = thread_cache[size_class][--thread_cache_count[size_class]];
+			buffer->refs_.store(1, std::memory_order_relaxed);
+			return buffer;
+		}
+
+		pool.heap_allocs.fetch_add(1, std::memory_order_relaxed);
+		return PacketBufferPool::Allocate(MinPooledSize << size_class, size_class);
+	}
+
+	void PacketBuffer::Unref() {
+		if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		if (size_class_ >= PACKET_BUFFER_CLASSES) {
+			PacketBufferPool::Free(this);
+			return;
+		}
+
+		// buffers go back to the cache of whichever thread dropped the last reference
+		if (thread_cache_count[size_class_] == PACKET_BUFFER_THREAD_CACHE)
+			PacketBufferPool::Get().Spill(size_class_);
+		thread_cache[size_class_][thread_cache_count[size_class_]++] = this;
+	}
+
+	PacketBuffer::Stats PacketBuffer::GetStats() {
+		PacketBufferPool &pool = PacketBufferPool::Get();
+		Stats stats;
+		stats.created = pool.created.load(std::memory_order_relaxed);
+		stats.heap_allocs = pool.heap_allocs.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+} // EQEmu
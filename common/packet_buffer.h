@@ -0,0 +1,71 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEmu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_PACKET_BUFFER_H
+#define _EQEMU_PACKET_BUFFER_H
+
+#include "types.h"
+#include <atomic>
+
+namespace EQEmu {
+
+	//! Reference counted byte buffer whose memory is recycled instead of going back to the heap
+	/*!
+		ServerPacket payloads and the frames ServerTalk writes to sockets live in these. Sizes are
+		rounded up to a power of two between MinPooledSize and MaxPooledSize, and released buffers
+		of each size are kept in a small per thread cache backed by a shared list, so steady traffic
+		stops allocating once the caches are warm. Bigger buffers come from and go back to the heap.
+
+		A buffer starts with one reference. Anything that keeps it around, like a send queue holding
+		a frame broadcast to many connections, takes its own with Ref() and drops it with Unref().
+	*/
+	class PacketBuffer {
+	public:
+		//! Returns a buffer of at least size bytes holding one reference, the contents are not cleared.
+		static PacketBuffer *Create(uint32 size);
+
+		void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+		void Unref();
+
+		uchar *Data() { return reinterpret_cast<uchar*>(this + 1); }
+		uint32 Capacity() const { return capacity_; }
+
+		struct Stats {
+			uint64 created; //!< buffers handed out by Create
+			uint64 heap_allocs; //!< of those, how many had to come from the heap
+		};
+		static Stats GetStats();
+
+		static const uint32 MinPooledSize = 64;
+		static const uint32 MaxPooledSize = 8192;
+	private:
+		PacketBuffer(uint32 capacity, uint32 size_class) : refs_(1), capacity_(capacity), size_class_(size_class) { }
+		PacketBuffer(const PacketBuffer&);
+		const PacketBuffer& operator=(const PacketBuffer&);
+
+		friend struct PacketBufferPool;
+
+		std::atomic<uint32> refs_;
+		uint32 capacity_;
+		uint32 size_class_;
+		uint32 pad_; // keeps Data() 16 byte aligned
+	};
+
+} // EQEmu
+
+#endif
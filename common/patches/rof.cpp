@@ -10,6 +10,7 @@
 #include "../misc_functions.h"
 #include "../string_util.h"
 #include "../item.h"
+#include "../serialized_item_cache.h"
 #include "rof_structs.h"
 #include "../rulesys.h"
 
@@ -25,6 +26,8 @@ namespace RoF
 	static Strategy struct_strategy;
 
 	char* SerializeItem(const ItemInst *inst, int16 slot_id, uint32 *length, uint8 depth);
+	static std::string SerializeItemBody(const Item_Struct *item);
+	static EQEmu::SerializedItemCache item_cache;
 
 	// server to client inventory location converters
 	static inline structs::ItemSlotStruct ServerToRoFSlot(uint32 serverSlot);
@@ -318,7 +321,7 @@ namespace RoF
 
 		if (EntryCount == 0 || (in->size % sizeof(BazaarSearchResults_Struct)) != 0)
 		{
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(BazaarSearchResults_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(BazaarSearchResults_Struct));
 			delete in;
 			return;
 		}
@@ -554,7 +557,7 @@ namespace RoF
 		if (ItemCount == 0 || (in->size % sizeof(InternalSerializedItem_Struct)) != 0) {
 
 			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d",
-				opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(InternalSerializedItem_Struct));
+				opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(InternalSerializedItem_Struct));
 
 			delete in;
 
@@ -3474,7 +3477,7 @@ namespace RoF
 
 		if (EntryCount == 0 || ((in->size % sizeof(Track_Struct))) != 0)
 		{
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(Track_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(Track_Struct));
 			delete in;
 			return;
 		}
@@ -3822,7 +3825,7 @@ namespace RoF
 		//determine and verify length
 		int entrycount = in->size / sizeof(Spawn_Struct);
 		if (entrycount == 0 || (in->size % sizeof(Spawn_Struct)) != 0) {
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(Spawn_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(Spawn_Struct));
 			delete in;
 			return;
 		}
@@ -4070,7 +4073,7 @@ namespace RoF
 			Buffer += 29;
 			if (Buffer != (BufferStart + PacketSize))
 			{
-				Log.Out(Logs::General, Logs::Netcode, "[ERROR] SPAWN ENCODE LOGIC PROBLEM: Buffer pointer is now %i from end", Buffer - (BufferStart + PacketSize));
+				Log.Out(Logs::General, Logs::Netcode, "[ERROR] SPAWN ENCODE LOGIC PROBLEM: Buffer pointer is now %i from end", (int)(Buffer - (BufferStart + PacketSize)));
 			}
 			//Log.LogDebugType(Logs::General, Logs::Netcode, "[ERROR] Sending zone spawn for %s packet is %i bytes", emu->name, outapp->size);
 			//Log.Hex(Logs::Netcode, outapp->pBuffer, outapp->size);
@@ -5102,6 +5105,77 @@ namespace RoF
 
 		ss.write((const char*)&hdrf, sizeof(RoF::structs::ItemSerializationHeaderFinish));
 		
+		item_cache.Write(ss, item, SerializeItemBody);
+
+		uint32 subitem_count = 0;
+
+		char *SubSerializations[10]; // <watch>
+
+		uint32 SubLengths[10];
+
+		for (int x = SUB_BEGIN; x < EmuConstants::ITEM_CONTAINER_SIZE; ++x) {
+
+			SubSerializations[x] = nullptr;
+
+			const ItemInst* subitem = ((const ItemInst*)inst)->GetItem(x);
+
+			if (subitem) {
+
+				int SubSlotNumber;
+
+				subitem_count++;
+
+				if (slot_id_in >= EmuConstants::GENERAL_BEGIN && slot_id_in <= EmuConstants::GENERAL_END) // (< 30) - no cursor?
+					//SubSlotNumber = (((slot_id_in + 3) * 10) + x + 1);
+					SubSlotNumber = (((slot_id_in + 3) * EmuConstants::ITEM_CONTAINER_SIZE) + x + 1);
+				else if (slot_id_in >= EmuConstants::BANK_BEGIN && slot_id_in <= EmuConstants::BANK_END)
+					//SubSlotNumber = (((slot_id_in - 2000) * 10) + 2030 + x + 1);
+					SubSlotNumber = (((slot_id_in - EmuConstants::BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::BANK_BAGS_BEGIN + x);
+				else if (slot_id_in >= EmuConstants::SHARED_BANK_BEGIN && slot_id_in <= EmuConstants::SHARED_BANK_END)
+					//SubSlotNumber = (((slot_id_in - 2500) * 10) + 2530 + x + 1);
+					SubSlotNumber = (((slot_id_in - EmuConstants::SHARED_BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::SHARED_BANK_BAGS_BEGIN + x);
+				else
+					SubSlotNumber = slot_id_in; // ???????
+
+				/*
+				// TEST CODE: <watch>
+				SubSlotNumber = Inventory::CalcSlotID(slot_id_in, x);
+				*/
+
+				SubSerializations[x] = SerializeItem(subitem, SubSlotNumber, &SubLengths[x], depth + 1);
+			}
+		}
+
+		ss.write((const char*)&subitem_count, sizeof(uint32));
+
+		for (int x = SUB_BEGIN; x < EmuConstants::ITEM_CONTAINER_SIZE; ++x) {
+
+			if (SubSerializations[x]) {
+
+				ss.write((const char*)&x, sizeof(uint32));
+
+				ss.write(SubSerializations[x], SubLengths[x]);
+
+				safe_delete_array(SubSerializations[x]);
+			}
+		}
+
+		char* item_serial = new char[ss.tellp()];
+		memset(item_serial, 0, ss.tellp());
+		memcpy(item_serial, ss.str().c_str(), ss.tellp());
+
+		*length = ss.tellp();
+		return item_serial;
+	}
+
+	// everything from the name on, except the sub item count, depends only on the item
+	static std::string SerializeItemBody(const Item_Struct *item)
+	{
+		uint8 null_term = 0;
+		bool stackable = item->Stackable;
+
+		std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+
 		if (strlen(item->Name) > 0)
 		{
 			ss.write(item->Name, strlen(item->Name));
@@ -5493,65 +5567,10 @@ namespace RoF
 		iqbs.unknown30 = 0;
 		iqbs.unknown39 = 1;
 
-		iqbs.subitem_count = 0;
-
-		char *SubSerializations[10]; // <watch>
-
-		uint32 SubLengths[10];
-
-		for (int x = SUB_BEGIN; x < EmuConstants::ITEM_CONTAINER_SIZE; ++x) {
-
-			SubSerializations[x] = nullptr;
-
-			const ItemInst* subitem = ((const ItemInst*)inst)->GetItem(x);
-
-			if (subitem) {
-
-				int SubSlotNumber;
-
-				iqbs.subitem_count++;
+		// the sub item count at the end of the struct is written by SerializeItem
+		ss.write((const char*)&iqbs, sizeof(RoF::structs::ItemQuaternaryBodyStruct) - sizeof(uint32));
 
-				if (slot_id_in >= EmuConstants::GENERAL_BEGIN && slot_id_in <= EmuConstants::GENERAL_END) // (< 30) - no cursor?
-					//SubSlotNumber = (((slot_id_in + 3) * 10) + x + 1);
-					SubSlotNumber = (((slot_id_in + 3) * EmuConstants::ITEM_CONTAINER_SIZE) + x + 1);
-				else if (slot_id_in >= EmuConstants::BANK_BEGIN && slot_id_in <= EmuConstants::BANK_END)
-					//SubSlotNumber = (((slot_id_in - 2000) * 10) + 2030 + x + 1);
-					SubSlotNumber = (((slot_id_in - EmuConstants::BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::BANK_BAGS_BEGIN + x);
-				else if (slot_id_in >= EmuConstants::SHARED_BANK_BEGIN && slot_id_in <= EmuConstants::SHARED_BANK_END)
-					//SubSlotNumber = (((slot_id_in - 2500) * 10) + 2530 + x + 1);
-					SubSlotNumber = (((slot_id_in - EmuConstants::SHARED_BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::SHARED_BANK_BAGS_BEGIN + x);
-				else
-					SubSlotNumber = slot_id_in; // ???????
-
-				/*
-				// TEST CODE: <watch>
-				SubSlotNumber = Inventory::CalcSlotID(slot_id_in, x);
-				*/
-
-				SubSerializations[x] = SerializeItem(subitem, SubSlotNumber, &SubLengths[x], depth + 1);
-			}
-		}
-
-		ss.write((const char*)&iqbs, sizeof(RoF::structs::ItemQuaternaryBodyStruct));
-
-		for (int x = SUB_BEGIN; x < EmuConstants::ITEM_CONTAINER_SIZE; ++x) {
-
-			if (SubSerializations[x]) {
-
-				ss.write((const char*)&x, sizeof(uint32));
-
-				ss.write(SubSerializations[x], SubLengths[x]);
-
-				safe_delete_array(SubSerializations[x]);
-			}
-		}
-
-		char* item_serial = new char[ss.tellp()];
-		memset(item_serial, 0, ss.tellp());
-		memcpy(item_serial, ss.str().c_str(), ss.tellp());
-
-		*length = ss.tellp();
-		return item_serial;
+		return ss.str();
 	}
 
 	static inline structs::ItemSlotStruct ServerToRoFSlot(uint32 serverSlot)
@@ -10,6 +10,7 @@
 #include "../misc_functions.h"
 #include "../string_util.h"
 #include "../item.h"
+#include "../serialized_item_cache.h"
 #include "sod_structs.h"
 #include "../rulesys.h"
 
@@ -23,6 +24,8 @@ namespace SoD
 	static Strategy struct_strategy;
 
 	char* SerializeItem(const ItemInst *inst, int16 slot_id, uint32 *length, uint8 depth);
+	static std::string SerializeItemBody(const Item_Struct *item);
+	static EQEmu::SerializedItemCache item_cache;
 
 	// server to client inventory location converters
 	static inline uint32 ServerToSoDSlot(uint32 ServerSlot);
@@ -247,7 +250,7 @@ namespace SoD
 
 		if (EntryCount == 0 || (in->size % sizeof(BazaarSearchResults_Struct)) != 0)
 		{
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(BazaarSearchResults_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(BazaarSearchResults_Struct));
 			delete in;
 			return;
 		}
@@ -360,7 +363,7 @@ namespace SoD
 		if (ItemCount == 0 || (in->size % sizeof(InternalSerializedItem_Struct)) != 0) {
 
 			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d",
-				opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(InternalSerializedItem_Struct));
+				opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(InternalSerializedItem_Struct));
 
 			delete in;
 			return;
@@ -2277,7 +2280,7 @@ namespace SoD
 
 		if (EntryCount == 0 || ((in->size % sizeof(Track_Struct))) != 0)
 		{
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(Track_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(Track_Struct));
 			delete in;
 			return;
 		}
@@ -2513,7 +2516,7 @@ namespace SoD
 		//determine and verify length
 		int entrycount = in->size / sizeof(Spawn_Struct);
 		if (entrycount == 0 || (in->size % sizeof(Spawn_Struct)) != 0) {
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(Spawn_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(Spawn_Struct));
 			delete in;
 			return;
 		}
@@ -3582,6 +3585,77 @@ namespace SoD
 
 		ss.write((const char*)&hdr, sizeof(SoD::structs::ItemSerializationHeader));
 
+		item_cache.Write(ss, item, SerializeItemBody);
+
+		uint32 subitem_count = 0;
+
+		char *SubSerializations[10]; // <watch>
+
+		uint32 SubLengths[10];
+
+		for (int x = SUB_BEGIN; x < EmuConstants::ITEM_CONTAINER_SIZE; ++x) {
+
+			SubSerializations[x] = nullptr;
+
+			const ItemInst* subitem = ((const ItemInst*)inst)->GetItem(x);
+
+			if (subitem) {
+
+				int SubSlotNumber;
+
+				subitem_count++;
+
+				if (slot_id_in >= EmuConstants::GENERAL_BEGIN && slot_id_in <= EmuConstants::GENERAL_END) // (< 30) - no cursor?
+					//SubSlotNumber = (((slot_id_in + 3) * 10) + x + 1);
+					SubSlotNumber = (((slot_id_in + 3) * EmuConstants::ITEM_CONTAINER_SIZE) + x + 1);
+				else if (slot_id_in >= EmuConstants::BANK_BEGIN && slot_id_in <= EmuConstants::BANK_END)
+					//SubSlotNumber = (((slot_id_in - 2000) * 10) + 2030 + x + 1);
+					SubSlotNumber = (((slot_id_in - EmuConstants::BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::BANK_BAGS_BEGIN + x);
+				else if (slot_id_in >= EmuConstants::SHARED_BANK_BEGIN && slot_id_in <= EmuConstants::SHARED_BANK_END)
+					//SubSlotNumber = (((slot_id_in - 2500) * 10) + 2530 + x + 1);
+					SubSlotNumber = (((slot_id_in - EmuConstants::SHARED_BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::SHARED_BANK_BAGS_BEGIN + x);
+				else
+					SubSlotNumber = slot_id_in; // ???????
+
+				/*
+				// TEST CODE: <watch>
+				SubSlotNumber = Inventory::CalcSlotID(slot_id_in, x);
+				*/
+
+				SubSerializations[x] = SerializeItem(subitem, SubSlotNumber, &SubLengths[x], depth + 1);
+			}
+		}
+
+		ss.write((const char*)&subitem_count, sizeof(uint32));
+
+		for (int x = 0; x < 10; ++x) {
+
+			if (SubSerializations[x]) {
+
+				ss.write((const char*)&x, sizeof(uint32));
+
+				ss.write(SubSerializations[x], SubLengths[x]);
+
+				safe_delete_array(SubSerializations[x]);
+			}
+		}
+
+		char* item_serial = new char[ss.tellp()];
+		memset(item_serial, 0, ss.tellp());
+		memcpy(item_serial, ss.str().c_str(), ss.tellp());
+
+		*length = ss.tellp();
+		return item_serial;
+	}
+
+	// everything from the name on, except the sub item count, depends only on the item
+	static std::string SerializeItemBody(const Item_Struct *item)
+	{
+		uint8 null_term = 0;
+		bool stackable = item->Stackable;
+
+		std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+
 		if (strlen(item->Name) > 0)
 		{
 			ss.write(item->Name, strlen(item->Name));
@@ -3920,65 +3994,10 @@ namespace SoD
 		iqbs.SpellDmg = item->SpellDmg;
 		iqbs.clairvoyance = item->Clairvoyance;
 
-		iqbs.subitem_count = 0;
-
-		char *SubSerializations[10]; // <watch>
-
-		uint32 SubLengths[10];
-
-		for (int x = SUB_BEGIN; x < EmuConstants::ITEM_CONTAINER_SIZE; ++x) {
-
-			SubSerializations[x] = nullptr;
-
-			const ItemInst* subitem = ((const ItemInst*)inst)->GetItem(x);
-
-			if (subitem) {
-
-				int SubSlotNumber;
-
-				iqbs.subitem_count++;
+		// the sub item count at the end of the struct is written by SerializeItem
+		ss.write((const char*)&iqbs, sizeof(SoD::structs::ItemQuaternaryBodyStruct) - sizeof(uint32));
 
-				if (slot_id_in >= EmuConstants::GENERAL_BEGIN && slot_id_in <= EmuConstants::GENERAL_END) // (< 30) - no cursor?
-					//SubSlotNumber = (((slot_id_in + 3) * 10) + x + 1);
-					SubSlotNumber = (((slot_id_in + 3) * EmuConstants::ITEM_CONTAINER_SIZE) + x + 1);
-				else if (slot_id_in >= EmuConstants::BANK_BEGIN && slot_id_in <= EmuConstants::BANK_END)
-					//SubSlotNumber = (((slot_id_in - 2000) * 10) + 2030 + x + 1);
-					SubSlotNumber = (((slot_id_in - EmuConstants::BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::BANK_BAGS_BEGIN + x);
-				else if (slot_id_in >= EmuConstants::SHARED_BANK_BEGIN && slot_id_in <= EmuConstants::SHARED_BANK_END)
-					//SubSlotNumber = (((slot_id_in - 2500) * 10) + 2530 + x + 1);
-					SubSlotNumber = (((slot_id_in - EmuConstants::SHARED_BANK_BEGIN) * EmuConstants::ITEM_CONTAINER_SIZE) + EmuConstants::SHARED_BANK_BAGS_BEGIN + x);
-				else
-					SubSlotNumber = slot_id_in; // ???????
-
-				/*
-				// TEST CODE: <watch>
-				SubSlotNumber = Inventory::CalcSlotID(slot_id_in, x);
-				*/
-
-				SubSerializations[x] = SerializeItem(subitem, SubSlotNumber, &SubLengths[x], depth + 1);
-			}
-		}
-
-		ss.write((const char*)&iqbs, sizeof(SoD::structs::ItemQuaternaryBodyStruct));
-
-		for (int x = 0; x < 10; ++x) {
-
-			if (SubSerializations[x]) {
-
-				ss.write((const char*)&x, sizeof(uint32));
-
-				ss.write(SubSerializations[x], SubLengths[x]);
-
-				safe_delete_array(SubSerializations[x]);
-			}
-		}
-
-		char* item_serial = new char[ss.tellp()];
-		memset(item_serial, 0, ss.tellp());
-		memcpy(item_serial, ss.str().c_str(), ss.tellp());
-
-		*length = ss.tellp();
-		return item_serial;
+		return ss.str();
 	}
 
 	static inline uint32 ServerToSoDSlot(uint32 serverSlot)
@@ -11,6 +11,7 @@
 #include "../misc_functions.h"
 #include "../string_util.h"
 #include "../item.h"
+#include "../serialized_item_cache.h"
 #include "titanium_structs.h"
 #include <sstream>
 
@@ -21,6 +22,8 @@ namespace Titanium
 	static Strategy struct_strategy;
 
 	char* SerializeItem(const ItemInst *inst, int16 slot_id_in, uint32 *length, uint8 depth);
+	static std::string SerializeItemBody(const Item_Struct *item);
+	static EQEmu::SerializedItemCache item_cache;
 
 	// server to client inventory location converters
 	static inline int16 ServerToTitaniumSlot(uint32 serverSlot);
@@ -188,7 +191,7 @@ namespace Titanium
 		int entrycount = in->size / sizeof(BazaarSearchResults_Struct);
 		if (entrycount == 0 || (in->size % sizeof(BazaarSearchResults_Struct)) != 0) {
 			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d",
-				opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(BazaarSearchResults_Struct));
+				opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(BazaarSearchResults_Struct));
 			delete in;
 			return;
 		}
@@ -268,7 +271,7 @@ namespace Titanium
 
 		int itemcount = in->size / sizeof(InternalSerializedItem_Struct);
 		if (itemcount == 0 || (in->size % sizeof(InternalSerializedItem_Struct)) != 0) {
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(InternalSerializedItem_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(InternalSerializedItem_Struct));
 			delete in;
 			return;
 		}
@@ -1368,7 +1371,7 @@ namespace Titanium
 
 		if (EntryCount == 0 || ((in->size % sizeof(Track_Struct))) != 0)
 		{
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(Track_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(Track_Struct));
 			delete in;
 			return;
 		}
@@ -1485,7 +1488,7 @@ namespace Titanium
 		//determine and verify length
 		int entrycount = in->size / sizeof(Spawn_Struct);
 		if (entrycount == 0 || (in->size % sizeof(Spawn_Struct)) != 0) {
-			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, sizeof(Spawn_Struct));
+			Log.Out(Logs::General, Logs::Netcode, "[STRUCTS] Wrong size on outbound %s: Got %d, expected multiple of %d", opcodes->EmuToName(in->GetOpcode()), in->size, (int)sizeof(Spawn_Struct));
 			delete in;
 			return;
 		}
@@ -2098,28 +2101,21 @@ namespace Titanium
 			}
 		}
 
+		std::string body;
+		item_cache.Append(body, item, SerializeItemBody);
+
 		*length = MakeAnyLenString(&serialization,
 			"%.*s%s"	// For leading quotes (and protection) if a subitem;
 			"%s"		// Instance data
 			"%.*s\""	// Quotes (and protection, if needed) around static data
-			"%i"		// item->ItemClass so we can do |%s instead of %s|
-#define I(field) "|%i"
-#define C(field) "|%s"
-#define S(field) "|%s"
-#define F(field) "|%f"
-#include "titanium_itemfields.h"
+			"%s"		// Static data
 			"%.*s\""	// Quotes (and protection, if needed) around static data
 			"|%s|%s|%s|%s|%s|%s|%s|%s|%s|%s"	// Sub items
 			"%.*s%s"	// For trailing quotes (and protection) if a subitem;
 			, depth ? depth - 1 : 0, protection, (depth) ? "\"" : ""
 			, instance
 			, depth, protection
-			, item->ItemClass
-#define I(field) ,item->field
-#define C(field) ,field
-#define S(field) ,item->field
-#define F(field) ,item->field
-#include "titanium_itemfields.h"
+			, body.c_str()
 			, depth, protection
 			, sub_items[0] ? sub_items[0] : ""
 			, sub_items[1] ? sub_items[1] : ""
@@ -2143,6 +2139,31 @@ namespace Titanium
 		return serialization;
 	}
 
+	// the fields between the quotes only depend on the item
+	static std::string SerializeItemBody(const Item_Struct *item)
+	{
+		char *body = nullptr;
+
+		MakeAnyLenString(&body,
+			"%i"		// item->ItemClass so we can do |%s instead of %s|
+#define I(field) "|%i"
+#define C(field) "|%s"
+#define S(field) "|%s"
+#define F(field) "|%f"
+#include "titanium_itemfields.h"
+			, item->ItemClass
+#define I(field) ,item->field
+#define C(field) ,field
+#define S(field) ,item->field
+#define F(field) ,item->field
+#include "titanium_itemfields.h"
+			);
+
+		std::string ret = body;
+		safe_delete_array(body);
+		return ret;
+	}
+
 	static inline int16 ServerToTitaniumSlot(uint32 serverSlot)
 	{
 		//int16 TitaniumSlot;
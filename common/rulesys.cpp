@@ -248,7 +248,7 @@ void RuleManager::SaveRules(Database *db, const char *ruleset) {
 		}
 		Log.Out(Logs::Detail, Logs::Rules, "Saving running rules into rule set %s (%d)", ruleset, m_activeRuleset);
 	} else {
-		Log.Out(Logs::Detail, Logs::Rules, "Saving running rules into running rule set %s", m_activeName.c_str(), m_activeRuleset);
+		Log.Out(Logs::Detail, Logs::Rules, "Saving running rules into running rule set %s (%d)", m_activeName.c_str(), m_activeRuleset);
 	}
 
 	int r;
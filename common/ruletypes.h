@@ -101,6 +101,7 @@ RULE_INT ( Character, FoodLossPerUpdate, 35) // How much food/water you lose per
 RULE_INT ( Character, BaseInstrumentSoftCap, 36) // Softcap for instrument mods, 36 commonly referred to as "3.6" as well.
 RULE_INT ( Character, BaseRunSpeedCap, 158) // Base Run Speed Cap, on live it's 158% which will give you a runspeed of 1.580 hard capped to 225.
 RULE_INT ( Character, OrnamentationAugmentType, 20) //Ornamentation Augment Type
+RULE_BOOL ( Character, CheckBuffBonuses, false) // Debug: after a buff only bonus recalc also do the full one and log any difference
 RULE_REAL(Character, EnvironmentDamageMulipliter, 1)
 RULE_BOOL(Character, UnmemSpellsOnDeath, true)
 RULE_CATEGORY_END()
@@ -208,6 +209,11 @@ RULE_BOOL ( Zone, LevelBasedEXPMods, false) // Allows you to use the level_exp_m
 RULE_INT ( Zone, WeatherTimer, 600) // Weather timer when no duration is available
 RULE_BOOL ( Zone, EnableLoggedOffReplenishments, true)
 RULE_INT ( Zone, MinOfflineTimeToReplenishments, 21600) // 21600 seconds is 6 Hours
+RULE_BOOL ( Zone, EventDrivenLoop, true ) // Main loop waits for network events or its next timer instead of sleeping ZoneTimerResolution every run
+RULE_INT ( Zone, LoopMaxWait, 100 ) // Longest the event driven main loop sleeps without being woken (ms)
+RULE_INT ( Zone, LoopProfileInterval, 0 ) // Seconds between main loop phase timing reports in the log, 0 to disable
+RULE_BOOL ( Zone, ProfileScopes, false ) // Keep tick, main loop phase, packet handler and quest event timings for #profile from boot
+RULE_INT ( Zone, AsyncDatabaseWorkers, 2 ) // Extra database connections that run fire and forget writes (buffs, trader, temp merchant) off the main loop, 0 runs them inline
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Map )
@@ -221,6 +227,8 @@ RULE_REAL ( Map, FixPathingZMaxDeltaWaypoint, 20 )	//at runtime at each waypoint
 RULE_REAL ( Map, FixPathingZMaxDeltaSendTo, 20 )	//at runtime in SendTo: max change in Z to allow the BestZ code to apply.
 RULE_REAL ( Map, FixPathingZMaxDeltaLoading, 45 )	//while loading each waypoint: max change in Z to allow the BestZ code to apply.
 RULE_INT ( Map, FindBestZHeightAdjust, 1)		// Adds this to the current Z before seeking the best Z position
+RULE_BOOL ( Map, UseCompiledMaps, true )		// Map a zone's precompiled .cmap into memory instead of parsing its .map when one is present.
+RULE_BOOL ( Map, WriteCompiledMaps, false )		// Write a .cmap after parsing a .map so the next boot of that zone can skip parsing.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Pathing )
@@ -252,6 +260,9 @@ RULE_INT ( Pathing, CullNodesFromStart, 1)		// Checks LOS from Start point to se
 RULE_INT ( Pathing, CullNodesFromEnd, 1)		// Checks LOS from End point to second to last node for this many nodes and removes last node if there is LOS
 RULE_REAL ( Pathing, CandidateNodeRangeXY, 400)		// When searching for path start/end nodes, only nodes within this range will be considered.
 RULE_REAL ( Pathing, CandidateNodeRangeZ, 10)		// When searching for path start/end nodes, only nodes within this range will be considered.
+RULE_INT ( Pathing, RouteCacheSize, 512)		// Number of node to node routes remembered per zone, 0 disables the route cache.
+RULE_BOOL ( Pathing, UseNextHopTable, true)		// Use maps/<zone>.nexthop (built with #path nexthop) for routes instead of searching, when it matches the .path file.
+RULE_INT ( Pathing, NextHopMaxNodes, 3000)		// Largest path file #path nexthop will build a table for (at most 32767), the table takes nodes * nodes * 2 bytes.
 RULE_CATEGORY_END()
 
 RULE_CATEGORY( Watermap )
@@ -603,6 +614,10 @@ RULE_CATEGORY( Client )
 RULE_BOOL( Client, UseLiveFactionMessage, false) // Allows players to see faction adjustments like Live
 RULE_CATEGORY_END()
 
+RULE_CATEGORY( Network )
+RULE_INT( Network, StreamReaderThreads, 1) // Number of UDP reader threads per client port, more than 1 uses SO_REUSEPORT (Linux only)
+RULE_CATEGORY_END()
+
 #undef RULE_CATEGORY
 #undef RULE_INT
 #undef RULE_REAL
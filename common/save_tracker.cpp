@@ -0,0 +1,97 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "save_tracker.h"
+
+EQEmu::SaveTracker::SaveTracker(int sections)
+: sections_(sections), saves_(0), written_(0), total_(0) {
+	Reset();
+}
+
+void EQEmu::SaveTracker::Begin() {
+	batch_.clear();
+	for (auto &section : sections_)
+		section.changed = false;
+}
+
+bool EQEmu::SaveTracker::Add(int section, const std::vector<std::string> &statements) {
+	if (section < 0 || section >= (int)sections_.size())
+		return false;
+
+	Section &s = sections_[section];
+	uint64 fingerprint = Fingerprint(statements);
+	total_ += (uint32)statements.size();
+
+	if (s.known && s.last == fingerprint)
+		return false;
+
+	s.pending = fingerprint;
+	s.changed = true;
+	batch_.insert(batch_.end(), statements.begin(), statements.end());
+	return true;
+}
+
+bool EQEmu::SaveTracker::Add(int section, const std::string &statement) {
+	std::vector<std::string> statements;
+	if (!statement.empty())
+		statements.push_back(statement);
+	return Add(section, statements);
+}
+
+std::vector<std::string> EQEmu::SaveTracker::Take() {
+	for (auto &section : sections_) {
+		if (!section.changed)
+			continue;
+
+		section.last = section.pending;
+		section.known = true;
+		section.changed = false;
+	}
+
+	++saves_;
+	written_ += (uint32)batch_.size();
+
+	std::vector<std::string> batch;
+	batch.swap(batch_);
+	return batch;
+}
+
+void EQEmu::SaveTracker::Reset() {
+	for (auto &section : sections_) {
+		section.known = false;
+		section.last = 0;
+		section.pending = 0;
+		section.changed = false;
+	}
+}
+
+uint64 EQEmu::SaveTracker::Fingerprint(const std::vector<std::string> &statements) {
+	// FNV-1a, with the statement count mixed in so an empty section differs from a missing one
+	uint64 hash = 14695981039346656037ULL;
+	for (auto &statement : statements) {
+		for (unsigned char c : statement) {
+			hash ^= c;
+			hash *= 1099511628211ULL;
+		}
+		hash ^= 0xff;
+		hash *= 1099511628211ULL;
+	}
+	hash ^= statements.size();
+	hash *= 1099511628211ULL;
+	return hash;
+}
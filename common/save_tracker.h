@@ -0,0 +1,76 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_SAVE_TRACKER_H
+#define _EQEMU_SAVE_TRACKER_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+namespace EQEmu {
+
+	//! Remembers what the last save of a record wrote, so the next save only sends what changed
+	/*!
+		A record (a character, say) is saved as a number of sections, each written by its own
+		statements. Every save hands the tracker the statements for every section; sections whose
+		statements are the same as the ones last queued are dropped and the rest end up in one
+		batch for the caller to run. If a batch fails to write, Reset() makes the next save write
+		everything again.
+	*/
+	class SaveTracker {
+	public:
+		SaveTracker(int sections);
+
+		//! Starts a new save, dropping anything added since the last Take().
+		void Begin();
+
+		//! Adds a section's statements to the save unless they are the same as last time. Returns true if they were added.
+		bool Add(int section, const std::vector<std::string> &statements);
+		bool Add(int section, const std::string &statement);
+
+		//! Hands over the statements of the save, the tracker takes them as written.
+		std::vector<std::string> Take();
+
+		//! Forgets everything, the next save writes all sections.
+		void Reset();
+
+		inline uint32 GetSaves() const { return saves_; }
+		inline uint32 GetStatementsWritten() const { return written_; }
+		//! What the saves so far would have written without the tracker.
+		inline uint32 GetStatementsTotal() const { return total_; }
+	private:
+		static uint64 Fingerprint(const std::vector<std::string> &statements);
+
+		struct Section {
+			bool known;
+			uint64 last;
+			uint64 pending;
+			bool changed;
+		};
+
+		std::vector<Section> sections_;
+		std::vector<std::string> batch_;
+		uint32 saves_;
+		uint32 written_;
+		uint32 total_;
+	};
+
+} // EQEmu
+
+#endif
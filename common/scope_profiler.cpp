@@ -0,0 +1,192 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "scope_profiler.h"
+#include "string_util.h"
+#include <algorithm>
+#include <string.h>
+
+namespace EQEmu {
+
+	LatencyHistogram::LatencyHistogram() {
+		Reset();
+	}
+
+	int LatencyHistogram::Bucket(uint64 us) {
+		if (us < 16)
+			return (int)us;
+
+		if (us >> 32)
+			return BucketCount - 1;
+
+		// us is in [2^exp, 2^(exp+1)), the three bits after the top one pick the bucket
+		int exp = 4;
+		while (us >> (exp + 1))
+			++exp;
+
+		return 16 + (exp - 4) * 8 + (int)((us >> (exp - 3)) & 7);
+	}
+
+	uint64 LatencyHistogram::BucketTop(int bucket) {
+		if (bucket < 16)
+			return (uint64)bucket;
+
+		int exp = 4 + (bucket - 16) / 8;
+		uint64 sub = (bucket - 16) % 8;
+		return ((8 + sub + 1) << (exp - 3)) - 1;
+	}
+
+	void LatencyHistogram::Record(uint64 us) {
+		buckets_[Bucket(us)]++;
+		count_++;
+		total_ += us;
+		if (us > max_)
+			max_ = us;
+	}
+
+	void LatencyHistogram::Reset() {
+		memset(buckets_, 0, sizeof(buckets_));
+		count_ = 0;
+		total_ = 0;
+		max_ = 0;
+	}
+
+	uint64 LatencyHistogram::Percentile(double percent) const {
+		if (count_ == 0)
+			return 0;
+
+		uint64 rank = (uint64)(count_ * percent / 100.0 + 0.5);
+		if (rank < 1)
+			rank = 1;
+
+		uint64 seen = 0;
+		for (int i = 0; i < BucketCount; ++i) {
+			seen += buckets_[i];
+			if (seen >= rank)
+				return i == BucketCount - 1 ? max_ : std::min(BucketTop(i), max_);
+		}
+
+		return max_;
+	}
+
+	const uint32 ScopeProfiler::NoScope;
+
+	ScopeProfiler::ScopeProfiler() : enabled_(false) {
+		reset_at_ = clock::now();
+	}
+
+	void ScopeProfiler::SetEnabled(bool enabled) {
+		if (enabled && !enabled_)
+			Reset();
+
+		enabled_ = enabled;
+	}
+
+	uint32 ScopeProfiler::GetScope(const std::string &name) {
+		auto iter = names_.find(name);
+		if (iter != names_.end())
+			return iter->second;
+
+		uint32 id = (uint32)scopes_.size();
+		scopes_.push_back(Scope());
+		scopes_.back().name = name;
+		names_[name] = id;
+		return id;
+	}
+
+	uint32 ScopeProfiler::AddFamily() {
+		families_.push_back(std::vector<uint32>());
+		return (uint32)families_.size() - 1;
+	}
+
+	void ScopeProfiler::Reset() {
+		for (auto &s : scopes_)
+			s.histogram.Reset();
+
+		reset_at_ = clock::now();
+	}
+
+	uint64 ScopeProfiler::GetElapsedUS() const {
+		return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - reset_at_).count();
+	}
+
+	std::vector<uint32> ScopeProfiler::Sorted() const {
+		std::vector<uint32> ids;
+		for (uint32 i = 0; i < scopes_.size(); ++i) {
+			if (scopes_[i].histogram.Count() > 0)
+				ids.push_back(i);
+		}
+
+		std::sort(ids.begin(), ids.end(), [this](uint32 a, uint32 b) {
+			return scopes_[a].histogram.Total() > scopes_[b].histogram.Total();
+		});
+		return ids;
+	}
+
+	std::vector<std::string> ScopeProfiler::Report(size_t max_lines) const {
+		std::vector<std::string> lines;
+		uint64 elapsed = std::max(GetElapsedUS(), (uint64)1);
+
+		std::vector<uint32> ids = Sorted();
+		for (auto id : ids) {
+			if (max_lines > 0 && lines.size() >= max_lines)
+				break;
+
+			const LatencyHistogram &h = scopes_[id].histogram;
+			lines.push_back(StringFormat("%s: %llu calls, %.1fms total (%.2f%%), avg %.1fus, p50 %lluus, p99 %lluus, max %lluus",
+				scopes_[id].name.c_str(), (unsigned long long)h.Count(), h.Total() / 1000.0, h.Total() * 100.0 / elapsed,
+				(double)h.Total() / h.Count(), (unsigned long long)h.Percentile(50), (unsigned long long)h.Percentile(99),
+				(unsigned long long)h.Max()));
+		}
+
+		return lines;
+	}
+
+	static std::string JSONString(const std::string &s) {
+		std::string out = "\"";
+		for (char c : s) {
+			if (c == '"' || c == '\\')
+				out += '\\';
+
+			if ((unsigned char)c < 0x20)
+				out += StringFormat("\\u%04x", c);
+			else
+				out += c;
+		}
+		out += "\"";
+		return out;
+	}
+
+	std::string ScopeProfiler::ReportJSON(const std::string &title) const {
+		std::string out = StringFormat("{\"title\":%s,\"elapsed_us\":%llu,\"scopes\":[", JSONString(title).c_str(),
+			(unsigned long long)GetElapsedUS());
+
+		std::vector<uint32> ids = Sorted();
+		for (size_t i = 0; i < ids.size(); ++i) {
+			const LatencyHistogram &h = scopes_[ids[i]].histogram;
+			out += StringFormat("%s{\"name\":%s,\"count\":%llu,\"total_us\":%llu,\"p50_us\":%llu,\"p99_us\":%llu,\"max_us\":%llu}",
+				i > 0 ? "," : "", JSONString(scopes_[ids[i]].name).c_str(), (unsigned long long)h.Count(),
+				(unsigned long long)h.Total(), (unsigned long long)h.Percentile(50), (unsigned long long)h.Percentile(99),
+				(unsigned long long)h.Max());
+		}
+
+		out += "]}";
+		return out;
+	}
+
+} // EQEmu
@@ -0,0 +1,145 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_SCOPE_PROFILER_H
+#define _EQEMU_SCOPE_PROFILER_H
+
+#include "types.h"
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace EQEmu {
+
+	//! Counts durations in log-linear microsecond buckets
+	/*!
+		Exact below 16us, above that eight buckets per power of two, so a percentile is off by at most
+		12.5%. Recording is a few shifts and an increment.
+	*/
+	class LatencyHistogram {
+	public:
+		LatencyHistogram();
+
+		void Record(uint64 us);
+		void Reset();
+
+		//! Upper bound of the bucket the given percentile (0-100) falls in, never more than Max().
+		uint64 Percentile(double percent) const;
+
+		uint64 Count() const { return count_; }
+		uint64 Total() const { return total_; }
+		uint64 Max() const { return max_; }
+	private:
+		static const int BucketCount = 16 + 28 * 8;
+
+		static int Bucket(uint64 us);
+		static uint64 BucketTop(int bucket);
+
+		uint32 buckets_[BucketCount];
+		uint64 count_;
+		uint64 total_;
+		uint64 max_;
+	};
+
+	//! Named timing scopes with a histogram each
+	/*!
+		Callers look up a scope id once and time work against it, reports list every scope that was hit
+		with its count, total, p50, p99 and max. Disabled it costs a branch per timed scope, enabled two
+		clock reads and a histogram update. Not thread safe, everything is timed from one thread.
+	*/
+	class ScopeProfiler {
+	public:
+		typedef std::chrono::steady_clock clock;
+
+		static const uint32 NoScope = 0xFFFFFFFFU;
+
+		//! Times from construction to destruction, does nothing if scope is NoScope or the profiler is off.
+		class Timer {
+		public:
+			Timer(ScopeProfiler &profiler, uint32 scope) : profiler_(profiler), scope_(profiler.IsEnabled() ? scope : NoScope) {
+				if (scope_ != NoScope)
+					start_ = clock::now();
+			}
+
+			~Timer() {
+				if (scope_ != NoScope)
+					profiler_.Record(scope_, std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start_).count());
+			}
+		private:
+			Timer(const Timer&);
+			const Timer& operator=(const Timer&);
+
+			ScopeProfiler &profiler_;
+			uint32 scope_;
+			clock::time_point start_;
+		};
+
+		ScopeProfiler();
+
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const { return enabled_; }
+
+		//! Id of the scope called name, added the first time it's asked for.
+		uint32 GetScope(const std::string &name);
+
+		//! Starts a family of scopes keyed by small integers, opcodes or quest event ids.
+		uint32 AddFamily();
+
+		//! Id of key's scope in a family, name(key) is only called the first time the key is seen.
+		template<typename F>
+		uint32 GetScope(uint32 family, uint32 key, F name) {
+			std::vector<uint32> &ids = families_[family];
+			if (key >= ids.size())
+				ids.resize(key + 1, NoScope);
+
+			if (ids[key] == NoScope)
+				ids[key] = GetScope(name(key));
+
+			return ids[key];
+		}
+
+		void Record(uint32 scope, uint64 us) { scopes_[scope].histogram.Record(us); }
+
+		//! Clears every histogram, scope ids stay valid.
+		void Reset();
+
+		const LatencyHistogram &GetHistogram(uint32 scope) const { return scopes_[scope].histogram; }
+		uint64 GetElapsedUS() const;
+
+		//! One line per scope that was hit, highest total first, at most max_lines of them (0 for all).
+		std::vector<std::string> Report(size_t max_lines = 0) const;
+		std::string ReportJSON(const std::string &title) const;
+	private:
+		struct Scope {
+			std::string name;
+			LatencyHistogram histogram;
+		};
+
+		std::vector<uint32> Sorted() const;
+
+		bool enabled_;
+		clock::time_point reset_at_;
+		std::vector<Scope> scopes_;
+		std::unordered_map<std::string, uint32> names_;
+		std::vector<std::vector<uint32>> families_;
+	};
+
+} // EQEmu
+
+#endif
@@ -0,0 +1,41 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "serialized_item_cache.h"
+
+namespace EQEmu {
+
+	SerializedItemCache::SerializedItemCache(uint32 max_items) : max_items_(max_items > 0 ? max_items : 1), builds_(0) {
+	}
+
+	void SerializedItemCache::Clear() {
+		LockMutex lock(&mutex_);
+		segments_.clear();
+	}
+
+	uint32 SerializedItemCache::Size() {
+		LockMutex lock(&mutex_);
+		return (uint32)segments_.size();
+	}
+
+	uint32 SerializedItemCache::Builds() {
+		LockMutex lock(&mutex_);
+		return builds_;
+	}
+
+} // EQEmu
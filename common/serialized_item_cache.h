@@ -0,0 +1,103 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_SERIALIZED_ITEM_CACHE_H
+#define _EQEMU_SERIALIZED_ITEM_CACHE_H
+
+#include "types.h"
+#include "mutex.h"
+#include "item_struct.h"
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace EQEmu {
+
+	//! Wire format of the parts of an item that only depend on its Item_Struct
+	/*!
+		Each patch keeps one of these for its SerializeItem. The bulk of a serialized item (name, lore,
+		stats, effects) comes straight from the Item_Struct, which never changes once loaded, so it is
+		built the first time an item is sent and copied out on every later send. The patch still writes
+		the instance fields (charges, slot, attunement, ornamentation, bag contents) around it.
+
+		Segments are keyed by item id. The Item_Struct pointer is kept with each segment, if an item
+		with the same id shows up at a different address the segment is built again. When max_items
+		segments are held the cache empties itself and starts over.
+	*/
+	class SerializedItemCache {
+	public:
+		//! Constructor
+		/*!
+		\param max_items Segments to hold before starting over.
+		*/
+		SerializedItemCache(uint32 max_items = 20000);
+
+		//! Writes the segment for item to out, calling build(item) for a std::string of it if it isn't cached.
+		template<typename F>
+		void Write(std::ostream &out, const Item_Struct *item, F build) {
+			LockMutex lock(&mutex_);
+			const std::string &segment = Find(item, build);
+			out.write(segment.c_str(), segment.length());
+		}
+
+		//! Appends the segment for item to out, calling build(item) for a std::string of it if it isn't cached.
+		template<typename F>
+		void Append(std::string &out, const Item_Struct *item, F build) {
+			LockMutex lock(&mutex_);
+			out.append(Find(item, build));
+		}
+
+		void Clear();
+		uint32 Size();
+
+		//! Number of segments built so far.
+		uint32 Builds();
+	private:
+		SerializedItemCache(const SerializedItemCache&);
+		const SerializedItemCache& operator=(const SerializedItemCache&);
+
+		struct Segment {
+			const Item_Struct *item;
+			std::string data;
+		};
+
+		template<typename F>
+		const std::string &Find(const Item_Struct *item, F build) {
+			auto iter = segments_.find(item->ID);
+			if (iter != segments_.end() && iter->second.item == item)
+				return iter->second.data;
+
+			if (iter == segments_.end() && segments_.size() >= max_items_)
+				segments_.clear();
+
+			Segment &segment = segments_[item->ID];
+			segment.item = item;
+			segment.data = build(item);
+			++builds_;
+			return segment.data;
+		}
+
+		Mutex mutex_;
+		std::unordered_map<uint32, Segment> segments_;
+		uint32 max_items_;
+		uint32 builds_;
+	};
+
+} // EQEmu
+
+#endif
@@ -4,6 +4,7 @@
 #include "../common/types.h"
 #include "../common/packet_functions.h"
 #include "../common/eq_packet_structs.h"
+#include "../common/packet_buffer.h"
 
 #define SERVER_TIMEOUT	45000	// how often keepalive gets sent
 #define INTERSERVER_TIMER					10000
@@ -203,16 +204,16 @@ enum {	QSG_LFGuild_PlayerMatches = 0, QSG_LFGuild_UpdatePlayerInfo, QSG_LFGuild_
 class ServerPacket
 {
 public:
-	~ServerPacket() { safe_delete_array(pBuffer); }
+	~ServerPacket() { FreeBuffer(); }
 	ServerPacket(uint16 in_opcode = 0, uint32 in_size = 0) {
 		this->compressed = false;
 		size = in_size;
 		opcode = in_opcode;
-		if (size == 0) {
-			pBuffer = 0;
-		}
-		else {
-			pBuffer = new uchar[size];
+		pBuffer = 0;
+		payload = nullptr;
+		owns_heap = true;
+		if (size != 0) {
+			AllocateBuffer(size);
 			memset(pBuffer, 0, size);
 		}
 		_wpos = 0;
@@ -222,9 +223,12 @@ public:
 		if (this == 0) {
 			return 0;
 		}
-		ServerPacket* ret = new ServerPacket(this->opcode, this->size);
-		if (this->size)
+		ServerPacket* ret = new ServerPacket(this->opcode);
+		if (this->size) {
+			ret->AllocateBuffer(this->size);
 			memcpy(ret->pBuffer, this->pBuffer, this->size);
+		}
+		ret->size = this->size;
 		ret->compressed = this->compressed;
 		ret->InflatedSize = this->InflatedSize;
 		return ret;
@@ -234,18 +238,16 @@ public:
 			return false;
 		if ((!this->pBuffer) || (!this->size))
 			return false;
-		uchar* tmp = new uchar[this->size + 128];
-		uint32 tmpsize = DeflatePacket(this->pBuffer, this->size, tmp, this->size + 128);
+		EQEmu::PacketBuffer* tmp = EQEmu::PacketBuffer::Create(this->size + 128);
+		uint32 tmpsize = DeflatePacket(this->pBuffer, this->size, tmp->Data(), this->size + 128);
 		if (!tmpsize) {
-			safe_delete_array(tmp);
+			tmp->Unref();
 			return false;
 		}
 		this->compressed = true;
 		this->InflatedSize = this->size;
 		this->size = tmpsize;
-		uchar* tmpdel = this->pBuffer;
-		this->pBuffer = tmp;
-		safe_delete_array(tmpdel);
+		UsePayload(tmp);
 		return true;
 	}
 	bool Inflate() {
@@ -253,20 +255,45 @@ public:
 			return false;
 		if ((!this->pBuffer) || (!this->size))
 			return false;
-		uchar* tmp = new uchar[InflatedSize];
-		uint32 tmpsize = InflatePacket(this->pBuffer, this->size, tmp, InflatedSize);
+		EQEmu::PacketBuffer* tmp = EQEmu::PacketBuffer::Create(InflatedSize);
+		uint32 tmpsize = InflatePacket(this->pBuffer, this->size, tmp->Data(), InflatedSize);
 		if (!tmpsize) {
-			safe_delete_array(tmp);
+			tmp->Unref();
 			return false;
 		}
 		compressed = false;
 		this->size = tmpsize;
-		uchar* tmpdel = this->pBuffer;
-		this->pBuffer = tmp;
-		safe_delete_array(tmpdel);
+		UsePayload(tmp);
 		return true;
 	}
 
+	//replaces pBuffer with an uncleared pooled buffer of at least in_size bytes, size is left alone
+	void AllocateBuffer(uint32 in_size) {
+		UsePayload(EQEmu::PacketBuffer::Create(in_size));
+	}
+	//moves the contents to a pooled buffer of in_size bytes, anything past the old size is zeroed.
+	//pointers into the old pBuffer are left dangling.
+	void Resize(uint32 in_size) {
+		EQEmu::PacketBuffer* tmp = EQEmu::PacketBuffer::Create(in_size);
+		uint32 keep = pBuffer ? (size < in_size ? size : in_size) : 0;
+		if (keep)
+			memcpy(tmp->Data(), pBuffer, keep);
+		if (in_size > keep)
+			memset(tmp->Data() + keep, 0, in_size - keep);
+		UsePayload(tmp);
+		size = in_size;
+	}
+	void FreeBuffer() {
+		if (owns_heap)
+			safe_delete_array(pBuffer);
+		if (payload) {
+			payload->Unref();
+			payload = nullptr;
+		}
+		pBuffer = 0;
+		owns_heap = true;
+	}
+
 	void WriteUInt8(uint8 value) { *(uint8 *)(pBuffer + _wpos) = value; _wpos += sizeof(uint8); }
 	void WriteUInt32(uint32 value) { *(uint32 *)(pBuffer + _wpos) = value; _wpos += sizeof(uint32); }
 	void WriteString(const char * str) { uint32 len = static_cast<uint32>(strlen(str)) + 1; memcpy(pBuffer + _wpos, str, len); _wpos += len; }
@@ -290,6 +317,22 @@ public:
 	bool	compressed;
 	uint32	InflatedSize;
 	uint32	destination;
+	EQEmu::PacketBuffer*	payload;	//backs pBuffer unless owns_heap is set
+
+private:
+	ServerPacket(const ServerPacket&);
+	const ServerPacket& operator=(const ServerPacket&);
+
+	void UsePayload(EQEmu::PacketBuffer* in_payload) {
+		FreeBuffer();
+		payload = in_payload;
+		pBuffer = payload->Data();
+		owns_heap = false;
+	}
+
+	//pBuffer is a new[] array the packet deletes. Set while there is no pooled buffer, so code that
+	//makes an empty packet and assigns pBuffer itself keeps working; never assign pBuffer otherwise.
+	bool	owns_heap;
 };
 
 #pragma pack(1)
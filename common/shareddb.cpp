@@ -11,20 +11,23 @@
 #include "loottable.h"
 #include "memory_mapped_file.h"
 #include "mysql.h"
+#include "npc_type_struct.h"
 #include "rulesys.h"
 #include "shareddb.h"
 #include "string_util.h"
 
 SharedDatabase::SharedDatabase()
 : Database(), skill_caps_mmf(nullptr), items_mmf(nullptr), items_hash(nullptr), faction_mmf(nullptr), faction_hash(nullptr),
-	loot_table_mmf(nullptr), loot_table_hash(nullptr), loot_drop_mmf(nullptr), loot_drop_hash(nullptr), base_data_mmf(nullptr)
+	loot_table_mmf(nullptr), loot_table_hash(nullptr), loot_drop_mmf(nullptr), loot_drop_hash(nullptr), base_data_mmf(nullptr),
+	npc_types_mmf(nullptr), npc_types_hash(nullptr), content_version_triggers(false)
 {
 }
 
 SharedDatabase::SharedDatabase(const char* host, const char* user, const char* passwd, const char* database, uint32 port)
 : Database(host, user, passwd, database, port), skill_caps_mmf(nullptr), items_mmf(nullptr), items_hash(nullptr),
 	faction_mmf(nullptr), faction_hash(nullptr), loot_table_mmf(nullptr), loot_table_hash(nullptr), loot_drop_mmf(nullptr),
-	loot_drop_hash(nullptr), base_data_mmf(nullptr)
+	loot_drop_hash(nullptr), base_data_mmf(nullptr), npc_types_mmf(nullptr), npc_types_hash(nullptr),
+	content_version_triggers(false)
 {
 }
 
@@ -39,6 +42,8 @@ SharedDatabase::~SharedDatabase() {
 	safe_delete(loot_table_hash);
 	safe_delete(loot_drop_hash);
 	safe_delete(base_data_mmf);
+	safe_delete(npc_types_mmf);
+	safe_delete(npc_types_hash);
 }
 
 bool SharedDatabase::SetHideMe(uint32 account_id, uint8 hideme)
@@ -1259,6 +1264,571 @@ bool SharedDatabase::LoadNPCFactionLists() {
 	return true;
 }
 
+void SharedDatabase::GetNPCTypesCount(int32 &npc_type_count, uint32 &max_id)
+{
+	npc_type_count = -1;
+	max_id = 0;
+
+	const std::string query = "SELECT MAX(id), count(*) FROM npc_types";
+	auto results = QueryDatabase(query);
+	if (!results.Success()) {
+		return;
+	}
+
+	if (results.RowCount() == 0)
+		return;
+
+	auto row = results.begin();
+
+	if (row[0])
+		max_id = atoi(row[0]);
+
+	if (row[1])
+		npc_type_count = atoi(row[1]);
+}
+
+bool SharedDatabase::LoadNPCTypes() {
+	if(npc_types_hash) {
+		return true;
+	}
+
+	try {
+		EQEmu::IPCMutex mutex("npc_types");
+		mutex.Lock();
+		npc_types_mmf = new EQEmu::MemoryMappedFile("shared/npc_types");
+
+		int32 npc_types = -1;
+		uint32 max_npc_type = 0;
+		GetNPCTypesCount(npc_types, max_npc_type);
+		if(npc_types == -1) {
+			EQ_EXCEPT("SharedDatabase", "Database returned no result");
+		}
+		uint32 size = static_cast<uint32>(EQEmu::FixedMemoryHashSet<NPCType>::estimated_size(npc_types, max_npc_type));
+		if(npc_types_mmf->Size() != size) {
+			EQ_EXCEPT("SharedDatabase", "Couldn't load npc types because npc_types_mmf->Size() != size");
+		}
+
+		npc_types_hash = new EQEmu::FixedMemoryHashSet<NPCType>(reinterpret_cast<uint8*>(npc_types_mmf->Get()), size);
+		mutex.Unlock();
+	} catch(std::exception& ex) {
+		Log.Out(Logs::General, Logs::Error, "Error Loading npc types: %s", ex.what());
+		safe_delete(npc_types_mmf);
+		return false;
+	}
+
+	return true;
+}
+
+void SharedDatabase::LoadNPCTypes(void *data, uint32 size, int32 npc_types, uint32 max_npc_type_id) {
+	EQEmu::FixedMemoryHashSet<NPCType> hash(reinterpret_cast<uint8*>(data), size, npc_types, max_npc_type_id);
+
+	auto results = QueryDatabase(GetNPCTypesQuery("ORDER BY npc_types.id"));
+	if (!results.Success()) {
+		return;
+	}
+
+	NPCType npc;
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		LoadNPCTypeRow(&npc, row);
+
+		try {
+			hash.insert(npc.npc_id, npc);
+		} catch(std::exception &ex) {
+			Log.Out(Logs::General, Logs::Error, "Database::LoadNPCTypes: %s", ex.what());
+			break;
+		}
+	}
+}
+
+const NPCType* SharedDatabase::GetNPCType(uint32 id) {
+	if(!npc_types_hash || id > npc_types_hash->max_key()) {
+		return nullptr;
+	}
+
+	if(npc_types_hash->exists(id)) {
+		return &(npc_types_hash->at(id));
+	}
+
+	return nullptr;
+}
+
+std::string SharedDatabase::GetNPCTypesQuery(const std::string &condition) {
+	return StringFormat("SELECT "
+		"npc_types.id, "
+		"npc_types.name, "
+		"npc_types.level, "
+		"npc_types.race, "
+		"npc_types.class, "
+		"npc_types.hp, "
+		"npc_types.mana, "
+		"npc_types.gender, "
+		"npc_types.texture, "
+		"npc_types.helmtexture, "
+		"npc_types.herosforgemodel, "
+		"npc_types.size, "
+		"npc_types.loottable_id, "
+		"npc_types.merchant_id, "
+		"npc_types.alt_currency_id, "
+		"npc_types.adventure_template_id, "
+		"npc_types.trap_template, "
+		"npc_types.attack_speed, "
+		"npc_types.STR, "
+		"npc_types.STA, "
+		"npc_types.DEX, "
+		"npc_types.AGI, "
+		"npc_types._INT, "
+		"npc_types.WIS, "
+		"npc_types.CHA, "
+		"npc_types.MR, "
+		"npc_types.CR, "
+		"npc_types.DR, "
+		"npc_types.FR, "
+		"npc_types.PR, "
+		"npc_types.Corrup, "
+		"npc_types.PhR, "
+		"npc_types.mindmg, "
+		"npc_types.maxdmg, "
+		"npc_types.attack_count, "
+		"npc_types.special_abilities, "
+		"npc_types.npc_spells_id, "
+		"npc_types.npc_spells_effects_id, "
+		"npc_types.d_melee_texture1, "
+		"npc_types.d_melee_texture2, "
+		"npc_types.ammo_idfile, "
+		"npc_types.prim_melee_type, "
+		"npc_types.sec_melee_type, "
+		"npc_types.ranged_type, "
+		"npc_types.runspeed, "
+		"npc_types.findable, "
+		"npc_types.trackable, "
+		"npc_types.hp_regen_rate, "
+		"npc_types.mana_regen_rate, "
+		"npc_types.aggroradius, "
+		"npc_types.assistradius, "
+		"npc_types.bodytype, "
+		"npc_types.npc_faction_id, "
+		"npc_types.face, "
+		"npc_types.luclin_hairstyle, "
+		"npc_types.luclin_haircolor, "
+		"npc_types.luclin_eyecolor, "
+		"npc_types.luclin_eyecolor2, "
+		"npc_types.luclin_beardcolor, "
+		"npc_types.luclin_beard, "
+		"npc_types.drakkin_heritage, "
+		"npc_types.drakkin_tattoo, "
+		"npc_types.drakkin_details, "
+		"npc_types.armortint_id, "
+		"npc_types.armortint_red, "
+		"npc_types.armortint_green, "
+		"npc_types.armortint_blue, "
+		"npc_types.see_invis, "
+		"npc_types.see_invis_undead, "
+		"npc_types.lastname, "
+		"npc_types.qglobal, "
+		"npc_types.AC, "
+		"npc_types.npc_aggro, "
+		"npc_types.spawn_limit, "
+		"npc_types.see_hide, "
+		"npc_types.see_improved_hide, "
+		"npc_types.ATK, "
+		"npc_types.Accuracy, "
+		"npc_types.Avoidance, "
+		"npc_types.slow_mitigation, "
+		"npc_types.maxlevel, "
+		"npc_types.scalerate, "
+		"npc_types.private_corpse, "
+		"npc_types.unique_spawn_by_name, "
+		"npc_types.underwater, "
+		"npc_types.emoteid, "
+		"npc_types.spellscale, "
+		"npc_types.healscale, "
+		"npc_types.no_target_hotkey, "
+		"npc_types.raid_target, "
+		"npc_types.attack_delay, "
+		"npc_types.light, "
+		"npc_types.armtexture, "
+		"npc_types.bracertexture, "
+		"npc_types.handtexture, "
+		"npc_types.legtexture, "
+		"npc_types.feettexture, "
+		"npc_types_tint.id, "
+		"npc_types_tint.red1h, npc_types_tint.grn1h, npc_types_tint.blu1h, "
+		"npc_types_tint.red2c, npc_types_tint.grn2c, npc_types_tint.blu2c, "
+		"npc_types_tint.red3a, npc_types_tint.grn3a, npc_types_tint.blu3a, "
+		"npc_types_tint.red4b, npc_types_tint.grn4b, npc_types_tint.blu4b, "
+		"npc_types_tint.red5g, npc_types_tint.grn5g, npc_types_tint.blu5g, "
+		"npc_types_tint.red6l, npc_types_tint.grn6l, npc_types_tint.blu6l, "
+		"npc_types_tint.red7f, npc_types_tint.grn7f, npc_types_tint.blu7f, "
+		"npc_types_tint.red8x, npc_types_tint.grn8x, npc_types_tint.blu8x, "
+		"npc_types_tint.red9x, npc_types_tint.grn9x, npc_types_tint.blu9x "
+		"FROM npc_types LEFT JOIN npc_types_tint ON npc_types.armortint_id = npc_types_tint.id %s",
+		condition.c_str()
+	);
+}
+
+void SharedDatabase::LoadNPCTypeRow(NPCType *npc, MySQLRequestRow &row) {
+	memset(npc, 0, sizeof(NPCType));
+
+	npc->npc_id = atoi(row[0]);
+
+	strn0cpy(npc->name, row[1], 50);
+
+	npc->level = atoi(row[2]);
+	npc->race = atoi(row[3]);
+	npc->class_ = atoi(row[4]);
+	npc->max_hp = atoi(row[5]);
+	npc->cur_hp = npc->max_hp;
+	npc->Mana = atoi(row[6]);
+	npc->gender = atoi(row[7]);
+	npc->texture = atoi(row[8]);
+	npc->helmtexture = atoi(row[9]);
+	npc->herosforgemodel = atoul(row[10]);
+	npc->size = atof(row[11]);
+	npc->loottable_id = atoi(row[12]);
+	npc->merchanttype = atoi(row[13]);
+	npc->alt_currency_type = atoi(row[14]);
+	npc->adventure_template = atoi(row[15]);
+	npc->trap_template = atoi(row[16]);
+	npc->attack_speed = atof(row[17]);
+	npc->STR = atoi(row[18]);
+	npc->STA = atoi(row[19]);
+	npc->DEX = atoi(row[20]);
+	npc->AGI = atoi(row[21]);
+	npc->INT = atoi(row[22]);
+	npc->WIS = atoi(row[23]);
+	npc->CHA = atoi(row[24]);
+	npc->MR = atoi(row[25]);
+	npc->CR = atoi(row[26]);
+	npc->DR = atoi(row[27]);
+	npc->FR = atoi(row[28]);
+	npc->PR = atoi(row[29]);
+	npc->Corrup = atoi(row[30]);
+	npc->PhR = atoi(row[31]);
+	npc->min_dmg = atoi(row[32]);
+	npc->max_dmg = atoi(row[33]);
+	npc->attack_count = atoi(row[34]);
+
+	if (row[35] != nullptr)
+		strn0cpy(npc->special_abilities, row[35], 512);
+	else
+		npc->special_abilities[0] = '\0';
+
+	npc->npc_spells_id = atoi(row[36]);
+	npc->npc_spells_effects_id = atoi(row[37]);
+	npc->d_melee_texture1 = atoi(row[38]);
+	npc->d_melee_texture2 = atoi(row[39]);
+	strn0cpy(npc->ammo_idfile, row[40], 30);
+	npc->prim_melee_type = atoi(row[41]);
+	npc->sec_melee_type = atoi(row[42]);
+	npc->ranged_type = atoi(row[43]);
+	npc->runspeed= atof(row[44]);
+	npc->findable = atoi(row[45]) == 0? false : true;
+	npc->trackable = atoi(row[46]) == 0? false : true;
+	npc->hp_regen = atoi(row[47]);
+	npc->mana_regen = atoi(row[48]);
+
+	// set default value for aggroradius
+	npc->aggroradius = (int32)atoi(row[49]);
+	if (npc->aggroradius <= 0)
+		npc->aggroradius = 70;
+
+	npc->assistradius = (int32)atoi(row[50]);
+	if (npc->assistradius <= 0)
+		npc->assistradius = npc->aggroradius;
+
+	if (row[51] && strlen(row[51]))
+	npc->bodytype = (uint8)atoi(row[51]);
+	else
+	npc->bodytype = 0;
+
+	npc->npc_faction_id = atoi(row[52]);
+
+	npc->luclinface = atoi(row[53]);
+	npc->hairstyle = atoi(row[54]);
+	npc->haircolor = atoi(row[55]);
+	npc->eyecolor1 = atoi(row[56]);
+	npc->eyecolor2 = atoi(row[57]);
+	npc->beardcolor = atoi(row[58]);
+	npc->beard = atoi(row[59]);
+	npc->drakkin_heritage = atoi(row[60]);
+	npc->drakkin_tattoo = atoi(row[61]);
+	npc->drakkin_details = atoi(row[62]);
+
+	uint32 armor_tint_id = atoi(row[63]);
+
+	npc->armor_tint[0] = (atoi(row[64]) & 0xFF) << 16;
+	npc->armor_tint[0] |= (atoi(row[65]) & 0xFF) << 8;
+	npc->armor_tint[0] |= (atoi(row[66]) & 0xFF);
+	npc->armor_tint[0] |= (npc->armor_tint[0]) ? (0xFF << 24) : 0;
+
+	// npc_types_tint is left joined, its id is null when there is no matching row
+	if (armor_tint_id != 0 && row[97] != nullptr) {
+		for (int index = EmuConstants::MATERIAL_BEGIN; index <= EmuConstants::MATERIAL_END; index++) {
+			npc->armor_tint[index] = atoi(row[98 + index * 3]) << 16;
+			npc->armor_tint[index] |= atoi(row[98 + index * 3 + 1]) << 8;
+			npc->armor_tint[index] |= atoi(row[98 + index * 3 + 2]);
+			npc->armor_tint[index] |= (npc->armor_tint[index]) ? (0xFF << 24) : 0;
+		}
+	}
+	else {
+		// use the npc_types tint fields if there is no tint set
+		for (int index = MaterialChest; index < _MaterialCount; index++) {
+			npc->armor_tint[index] = npc->armor_tint[0];
+		}
+	}
+
+	npc->see_invis = atoi(row[67]);
+	npc->see_invis_undead = atoi(row[68]) == 0? false: true;	// Set see_invis_undead flag
+
+	if (row[69] != nullptr)
+		strn0cpy(npc->lastname, row[69], 32);
+
+	npc->qglobal = atoi(row[70]) == 0? false: true;	// qglobal
+	npc->AC = atoi(row[71]);
+	npc->npc_aggro = atoi(row[72]) == 0? false: true;
+	npc->spawn_limit = atoi(row[73]);
+	npc->see_hide = atoi(row[74]) == 0? false: true;
+	npc->see_improved_hide = atoi(row[75]) == 0? false: true;
+	npc->ATK = atoi(row[76]);
+	npc->accuracy_rating = atoi(row[77]);
+	npc->avoidance_rating = atoi(row[78]);
+	npc->slow_mitigation = atoi(row[79]);
+	npc->maxlevel = atoi(row[80]);
+	npc->scalerate = atoi(row[81]);
+	npc->private_corpse = atoi(row[82]) == 1 ? true: false;
+	npc->unique_spawn_by_name = atoi(row[83]) == 1 ? true: false;
+	npc->underwater = atoi(row[84]) == 1 ? true: false;
+	npc->emoteid = atoi(row[85]);
+	npc->spellscale = atoi(row[86]);
+	npc->healscale = atoi(row[87]);
+	npc->no_target_hotkey = atoi(row[88]) == 1 ? true: false;
+	npc->raid_target = atoi(row[89]) == 0 ? false: true;
+	npc->attack_delay = atoi(row[90]);
+	npc->light = (atoi(row[91]) & 0x0F);
+
+	npc->armtexture = atoi(row[92]);
+	npc->bracertexture = atoi(row[93]);
+	npc->handtexture = atoi(row[94]);
+	npc->legtexture = atoi(row[95]);
+	npc->feettexture = atoi(row[96]);
+}
+
+std::string SharedDatabase::GetZoneContentGroupsQuery(const char *zone_name, int32 version) {
+	return StringFormat("SELECT spawngroupID FROM spawn2 WHERE zone = '%s' AND version = %d", zone_name, version);
+}
+
+bool SharedDatabase::GetZoneContentVersions(std::vector<std::pair<std::string, int32>> &zones) {
+	// doors with version -1 show up in every version, they get a version 0 pack if nothing else does
+	std::string query = "SELECT zone, version FROM spawn2 "
+		"UNION SELECT zone, GREATEST(version, 0) FROM doors "
+		"ORDER BY zone, version";
+	auto results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		if (row[0] && GetZoneID(row[0]) != 0)
+			zones.push_back(std::make_pair(std::string(row[0]), atoi(row[1])));
+	}
+
+	return true;
+}
+
+// triggers utils/sql/git/required/2015_03_01_content_version.sql puts on the content tables
+static const int ZoneContentTriggerCount = 19;
+
+bool SharedDatabase::CheckContentVersionTriggers() {
+	// the versions are only worth anything while every trigger that bumps them is there, restoring a dump of
+	// one of the tables drops its triggers
+	std::string query = "SELECT COUNT(*) FROM information_schema.TRIGGERS WHERE TRIGGER_SCHEMA = DATABASE() "
+		"AND TRIGGER_NAME LIKE 'content\\_version\\_%'";
+	auto results = QueryDatabase(query);
+	if (!results.Success() || results.RowCount() != 1) {
+		content_version_triggers = false;
+		return false;
+	}
+
+	auto row = results.begin();
+	content_version_triggers = row[0] && atoi(row[0]) == ZoneContentTriggerCount;
+	return content_version_triggers;
+}
+
+bool SharedDatabase::GetContentVersion(const char *zone_name, uint32 &content_version) {
+	if (!content_version_triggers) {
+		return false;
+	}
+
+	std::string query = StringFormat("SELECT version FROM content_version WHERE zone = '%s'", zone_name);
+	auto results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	// no row yet, nothing in the zone was changed since the triggers went in
+	content_version = 0;
+	if (results.RowCount() == 1) {
+		auto row = results.begin();
+		content_version = (uint32)strtoul(row[0], nullptr, 10);
+	}
+
+	return true;
+}
+
+bool SharedDatabase::LoadZoneContent(const char *zone_name, int32 version, EQEmu::ZoneContentPack::Content &content) {
+	content.zone_id = GetZoneID(zone_name);
+	content.version = version;
+	if (!GetContentVersion(zone_name, content.content_version)) {
+		return false;
+	}
+
+	std::string groups = GetZoneContentGroupsQuery(zone_name, version);
+
+	std::string query = StringFormat("SELECT id, spawngroupID, x, y, z, heading, respawntime, variance, pathgrid, "
+		"_condition, cond_value, enabled, animation FROM spawn2 WHERE zone = '%s' AND version = %d",
+		zone_name, version);
+	auto results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		EQEmu::ZoneContentPack::Spawn2Row s;
+		memset(&s, 0, sizeof(s));
+		s.id = atoi(row[0]);
+		s.spawngroup_id = atoi(row[1]);
+		s.x = atof(row[2]);
+		s.y = atof(row[3]);
+		s.z = atof(row[4]);
+		s.heading = atof(row[5]);
+		s.respawn = atoi(row[6]);
+		s.variance = atoi(row[7]);
+		s.grid = atoi(row[8]);
+		s.condition_id = atoi(row[9]);
+		s.condition_min_value = atoi(row[10]);
+		s.enabled = atoi(row[11]) == 1 ? 1 : 0;
+		s.animation = atoi(row[12]);
+		content.spawn2.push_back(s);
+	}
+
+	query = StringFormat("SELECT id, name, spawn_limit, dist, max_x, min_x, max_y, min_y, delay, despawn, "
+		"despawn_timer, mindelay FROM spawngroup WHERE id IN (%s)", groups.c_str());
+	results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		EQEmu::ZoneContentPack::SpawnGroupRow g;
+		memset(&g, 0, sizeof(g));
+		g.id = atoi(row[0]);
+		strn0cpy(g.name, row[1], sizeof(g.name));
+		g.spawn_limit = atoi(row[2]);
+		g.dist = atof(row[3]);
+		g.max_x = atof(row[4]);
+		g.min_x = atof(row[5]);
+		g.max_y = atof(row[6]);
+		g.min_y = atof(row[7]);
+		g.delay = atoi(row[8]);
+		g.despawn = atoi(row[9]);
+		g.despawn_timer = atoi(row[10]);
+		g.min_delay = atoi(row[11]);
+		content.spawn_groups.push_back(g);
+	}
+
+	query = StringFormat("SELECT se.spawngroupID, se.npcID, se.chance, n.spawn_limit FROM spawnentry se "
+		"JOIN npc_types n ON n.id = se.npcID WHERE se.spawngroupID IN (%s)", groups.c_str());
+	results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		EQEmu::ZoneContentPack::SpawnEntryRow e;
+		e.spawngroup_id = atoi(row[0]);
+		e.npc_id = atoi(row[1]);
+		e.chance = atoi(row[2]);
+		e.npc_spawn_limit = row[3] ? atoi(row[3]) : 0;
+		content.spawn_entries.push_back(e);
+	}
+
+	query = StringFormat("SELECT id, type, type2 FROM grid WHERE zoneid = %u", content.zone_id);
+	results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		EQEmu::ZoneContentPack::GridRow g;
+		g.id = atoi(row[0]);
+		g.wander_type = atoi(row[1]);
+		g.pause_type = atoi(row[2]);
+		content.grids.push_back(g);
+	}
+
+	query = StringFormat("SELECT gridid, number, x, y, z, pause, heading FROM grid_entries WHERE zoneid = %u",
+		content.zone_id);
+	results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		EQEmu::ZoneContentPack::GridEntryRow e;
+		e.grid_id = atoi(row[0]);
+		e.number = atoi(row[1]);
+		e.x = atof(row[2]);
+		e.y = atof(row[3]);
+		e.z = atof(row[4]);
+		e.pause = atoi(row[5]);
+		e.heading = atof(row[6]);
+		content.grid_entries.push_back(e);
+	}
+
+	query = StringFormat("SELECT id, doorid, name, pos_x, pos_y, pos_z, heading, opentype, guild, lockpick, keyitem, "
+		"nokeyring, triggerdoor, triggertype, dest_zone, dest_instance, dest_x, dest_y, dest_z, dest_heading, "
+		"door_param, invert_state, incline, size, is_ldon_door, client_version_mask "
+		"FROM doors WHERE zone = '%s' AND (version = %d OR version = -1)", zone_name, version);
+	results = QueryDatabase(query);
+	if (!results.Success()) {
+		return false;
+	}
+
+	for (auto row = results.begin(); row != results.end(); ++row) {
+		EQEmu::ZoneContentPack::DoorRow d;
+		memset(&d, 0, sizeof(d));
+		d.db_id = atoi(row[0]);
+		d.door_id = atoi(row[1]);
+		strn0cpy(d.name, row[2], sizeof(d.name));
+		d.x = atof(row[3]);
+		d.y = atof(row[4]);
+		d.z = atof(row[5]);
+		d.heading = atof(row[6]);
+		d.open_type = atoi(row[7]);
+		d.guild_id = atoi(row[8]);
+		d.lockpick = atoi(row[9]);
+		d.key_item = atoi(row[10]);
+		d.no_keyring = atoi(row[11]);
+		d.trigger_door = atoi(row[12]);
+		d.trigger_type = atoi(row[13]);
+		strn0cpy(d.dest_zone, row[14], sizeof(d.dest_zone));
+		d.dest_instance_id = atoi(row[15]);
+		d.dest_x = atof(row[16]);
+		d.dest_y = atof(row[17]);
+		d.dest_z = atof(row[18]);
+		d.dest_heading = atof(row[19]);
+		d.door_param = atoi(row[20]);
+		d.invert_state = atoi(row[21]);
+		d.incline = atoi(row[22]);
+		d.size = atoi(row[23]);
+		d.is_ldon_door = atoi(row[24]);
+		d.client_version_mask = (uint32)strtoul(row[25], nullptr, 10);
+		content.doors.push_back(d);
+	}
+
+	return true;
+}
+
 // Create appropriate ItemInst class
 ItemInst* SharedDatabase::CreateItem(uint32 item_id, int16 charges, uint32 aug1, uint32 aug2, uint32 aug3, uint32 aug4, uint32 aug5, uint32 aug6, uint8 attuned)
 {
@@ -1702,6 +2272,9 @@ void SharedDatabase::LoadSpells(void *data, int max_spells) {
     }
 
     LoadDamageShieldTypes(sp, max_spells);
+
+	for (int i = 0; i < max_spells; ++i)
+		CalcSpellClassification(&sp[i]);
 }
 
 int SharedDatabase::GetMaxBaseDataLevel() {
@@ -9,9 +9,12 @@
 #include "base_data.h"
 #include "fixed_memory_hash_set.h"
 #include "fixed_memory_variable_hash_set.h"
+#include "zone_content_pack.h"
 
 #include <list>
 #include <map>
+#include <string>
+#include <vector>
 
 class EvolveInfo;
 class Inventory;
@@ -24,6 +27,8 @@ struct Item_Struct;
 struct NPCFactionList;
 struct LootTable_Struct;
 struct LootDrop_Struct;
+struct NPCType;
+class MySQLRequestRow;
 namespace EQEmu
 {
 	class MemoryMappedFile;
@@ -103,6 +108,18 @@ class SharedDatabase : public Database
 		void LoadNPCFactionLists(void *data, uint32 size, uint32 list_count, uint32 max_lists);
 		bool LoadNPCFactionLists();
 
+		//npc types
+		void GetNPCTypesCount(int32 &npc_type_count, uint32 &max_id);
+		void LoadNPCTypes(void *data, uint32 size, int32 npc_types, uint32 max_npc_type_id);
+		bool LoadNPCTypes();
+		const NPCType* GetNPCType(uint32 id);
+
+		//zone content packs
+		bool GetZoneContentVersions(std::vector<std::pair<std::string, int32>> &zones);
+		bool CheckContentVersionTriggers(); // once at startup, packs are neither written nor used without every trigger
+		bool GetContentVersion(const char *zone_name, uint32 &content_version); // bumped on every change to the zone's content
+		bool LoadZoneContent(const char *zone_name, int32 version, EQEmu::ZoneContentPack::Content &content);
+
 		//loot
 		void GetLootTableInfo(uint32 &loot_table_count, uint32 &max_loot_table, uint32 &loot_table_entries);
 		void GetLootDropInfo(uint32 &loot_drop_count, uint32 &max_loot_drop, uint32 &loot_drop_entries);
@@ -138,6 +155,16 @@ class SharedDatabase : public Database
 		EQEmu::MemoryMappedFile *loot_drop_mmf;
 		EQEmu::FixedMemoryVariableHashSet<LootDrop_Struct> *loot_drop_hash;
 		EQEmu::MemoryMappedFile *base_data_mmf;
+		EQEmu::MemoryMappedFile *npc_types_mmf;
+		EQEmu::FixedMemoryHashSet<NPCType> *npc_types_hash;
+		bool content_version_triggers;
+
+		// the npc_types columns NPCType is built from, shared by the loader and zone lookups
+		std::string GetNPCTypesQuery(const std::string &condition);
+		void LoadNPCTypeRow(NPCType *npc, MySQLRequestRow &row);
+
+		// spawngroup ids used by a zone version, the content pack sections are all keyed off of it
+		std::string GetZoneContentGroupsQuery(const char *zone_name, int32 version);
 };
 
 #endif /*SHAREDDB_H_*/
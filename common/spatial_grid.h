@@ -0,0 +1,195 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_SPATIAL_GRID_H
+#define _EQEMU_SPATIAL_GRID_H
+
+#include "types.h"
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+
+namespace EQEmu {
+
+	/*! Uniform grid over the x/y plane used to answer "what is near this point" without walking
+	every object in a zone. Objects only move between cells when they cross a cell boundary.
+
+	Queries hand back every object in the cells that overlap the query area, so the results are a
+	superset of the real answer: callers are expected to keep doing their own exact range checks.
+	*/
+	template<class T>
+	class SpatialGrid {
+		typedef uint64 cell_key;
+	public:
+		/*!
+			Constructor
+		\param cell_size Width of a cell, should be close to the most common query radius.
+		*/
+		SpatialGrid(float cell_size = 100.0f) {
+			cell_size_ = cell_size > 1.0f ? cell_size : 1.0f;
+			inv_cell_size_ = 1.0f / cell_size_;
+		}
+
+		/*!
+			Adds the object to the grid or moves it if it is already there.
+		*/
+		void Insert(T obj, float x, float y) {
+			if(Relocate(obj, x, y))
+				return;
+
+			Location &loc = locations_[obj];
+			Link(obj, MakeKey(ToCell(x), ToCell(y)), loc);
+		}
+
+		/*!
+			Moves an object that is already in the grid.
+		\return False if the object isn't in the grid, it is not added.
+		*/
+		bool Relocate(T obj, float x, float y) {
+			auto iter = locations_.find(obj);
+			if(iter == locations_.end())
+				return false;
+
+			cell_key key = MakeKey(ToCell(x), ToCell(y));
+			if(iter->second.cell == key)
+				return true;
+
+			Unlink(iter->second);
+			Link(obj, key, iter->second);
+			return true;
+		}
+
+		/*!
+			Removes the object from the grid, does nothing if it isn't in it.
+		*/
+		void Remove(T obj) {
+			auto iter = locations_.find(obj);
+			if(iter == locations_.end())
+				return;
+
+			Unlink(iter->second);
+			locations_.erase(iter);
+		}
+
+		void Clear() {
+			cells_.clear();
+			locations_.clear();
+		}
+
+		bool Contains(T obj) const { return locations_.count(obj) != 0; }
+		size_t Size() const { return locations_.size(); }
+		size_t CellCount() const { return cells_.size(); }
+		float CellSize() const { return cell_size_; }
+
+		/*!
+			Appends every object in a cell overlapping the box to out.
+		*/
+		void QueryBox(float min_x, float min_y, float max_x, float max_y, std::vector<T> &out) const {
+			int32 min_cx = ToCell(min_x);
+			int32 min_cy = ToCell(min_y);
+			int32 max_cx = ToCell(max_x);
+			int32 max_cy = ToCell(max_y);
+
+			//a huge box touches more cells than we actually have, walk the occupied ones instead.
+			uint64 span = uint64(int64(max_cx) - min_cx + 1) * uint64(int64(max_cy) - min_cy + 1);
+			if(span > cells_.size()) {
+				for(auto iter = cells_.begin(); iter != cells_.end(); ++iter) {
+					int32 cx = KeyX(iter->first);
+					int32 cy = KeyY(iter->first);
+					if(cx < min_cx || cx > max_cx || cy < min_cy || cy > max_cy)
+						continue;
+
+					out.insert(out.end(), iter->second.begin(), iter->second.end());
+				}
+				return;
+			}
+
+			for(int32 cx = min_cx; cx <= max_cx; ++cx) {
+				for(int32 cy = min_cy; cy <= max_cy; ++cy) {
+					auto iter = cells_.find(MakeKey(cx, cy));
+					if(iter == cells_.end())
+						continue;
+
+					out.insert(out.end(), iter->second.begin(), iter->second.end());
+				}
+			}
+		}
+
+		/*!
+			Appends every object in a cell overlapping the circle to out.
+		*/
+		void QueryRadius(float x, float y, float radius, std::vector<T> &out) const {
+			QueryBox(x - radius, y - radius, x + radius, y + radius, out);
+		}
+
+	private:
+		struct Location {
+			cell_key cell;
+			size_t index;
+		};
+
+		int32 ToCell(float v) const {
+			float c = floorf(v * inv_cell_size_);
+			//keep bogus coordinates from overflowing the cell index
+			if(c < -1073741824.0f)
+				return -1073741824;
+			if(c > 1073741823.0f)
+				return 1073741823;
+			return static_cast<int32>(c);
+		}
+
+		static cell_key MakeKey(int32 cx, int32 cy) {
+			return (static_cast<cell_key>(static_cast<uint32>(cx)) << 32) | static_cast<uint32>(cy);
+		}
+
+		static int32 KeyX(cell_key key) { return static_cast<int32>(static_cast<uint32>(key >> 32)); }
+		static int32 KeyY(cell_key key) { return static_cast<int32>(static_cast<uint32>(key & 0xFFFFFFFF)); }
+
+		void Link(T obj, cell_key key, Location &loc) {
+			std::vector<T> &cell = cells_[key];
+			loc.cell = key;
+			loc.index = cell.size();
+			cell.push_back(obj);
+		}
+
+		//swap removes the object from its cell, fixing up the index of whatever took its place
+		void Unlink(const Location &loc) {
+			auto iter = cells_.find(loc.cell);
+			if(iter == cells_.end())
+				return;
+
+			std::vector<T> &cell = iter->second;
+			if(loc.index + 1 != cell.size()) {
+				T moved = cell.back();
+				cell[loc.index] = moved;
+				locations_[moved].index = loc.index;
+			}
+			cell.pop_back();
+
+			if(cell.empty())
+				cells_.erase(iter);
+		}
+
+		float cell_size_;
+		float inv_cell_size_;
+		std::unordered_map<cell_key, std::vector<T>> cells_;
+		std::unordered_map<T, Location> locations_;
+	};
+} // EQEmu
+
+#endif
@@ -85,6 +85,17 @@
 ///////////////////////////////////////////////////////////////////////////////
 // spell property testing functions
 
+// the effect and classification bits are filled in by CalcSpellClassification (spdat_classify.cpp)
+static inline bool SpellHasEffectBit(uint32 spell_id, int effect)
+{
+	return (spells[spell_id].effect_bits[effect >> 5] & (1u << (effect & 31))) != 0;
+}
+
+static inline bool SpellIs(uint16 spell_id, uint32 classification)
+{
+	return (spells[spell_id].classification & classification) != 0;
+}
+
 bool IsTargetableAESpell(uint16 spell_id)
 {
 	if (IsValidSpell(spell_id) && spells[spell_id].targettype == ST_AETarget)
@@ -122,13 +133,8 @@ bool IsStunSpell(uint16 spell_id)
 
 bool IsSummonSpell(uint16 spellid)
 {
-	for (int o = 0; o < EFFECT_COUNT; o++) {
-		uint32 tid = spells[spellid].effectid[o];
-		if (tid == SE_SummonPet || tid == SE_SummonItem || tid == SE_SummonPC)
-			return true;
-	}
-
-	return false;
+	return SpellHasEffectBit(spellid, SE_SummonPet) || SpellHasEffectBit(spellid, SE_SummonItem) ||
+			SpellHasEffectBit(spellid, SE_SummonPC);
 }
 
 bool IsEvacSpell(uint16 spellid)
@@ -138,15 +144,7 @@ bool IsEvacSpell(uint16 spellid)
 
 bool IsDamageSpell(uint16 spellid)
 {
-	for (int o = 0; o < EFFECT_COUNT; o++) {
-		uint32 tid = spells[spellid].effectid[o];
-		if ((tid == SE_CurrentHPOnce || tid == SE_CurrentHP) &&
-				spells[spellid].targettype != ST_Tap && spells[spellid].buffduration < 1 &&
-				spells[spellid].base[o] < 0)
-			return true;
-	}
-
-	return false;
+	return SpellIs(spellid, SpellClass_Damage);
 }
 
 
@@ -157,15 +155,8 @@ bool IsFearSpell(uint16 spell_id)
 
 bool IsCureSpell(uint16 spell_id)
 {
-	const SPDat_Spell_Struct &sp = spells[spell_id];
-
-	bool CureEffect = false;
-
-	for(int i = 0; i < EFFECT_COUNT; i++){
-		if (sp.effectid[i] == SE_DiseaseCounter || sp.effectid[i] == SE_PoisonCounter 
-			|| sp.effectid[i] == SE_CurseCounter || sp.effectid[i] == SE_CorruptionCounter)
-			CureEffect = true;
-	}
+	bool CureEffect = SpellHasEffectBit(spell_id, SE_DiseaseCounter) || SpellHasEffectBit(spell_id, SE_PoisonCounter) ||
+			SpellHasEffectBit(spell_id, SE_CurseCounter) || SpellHasEffectBit(spell_id, SE_CorruptionCounter);
 
 	if (CureEffect && IsBeneficialSpell(spell_id))
 		return true;
@@ -175,25 +166,12 @@ bool IsCureSpell(uint16 spell_id)
 
 bool IsSlowSpell(uint16 spell_id)
 {
-	const SPDat_Spell_Struct &sp = spells[spell_id];
-
-	for(int i = 0; i < EFFECT_COUNT; i++)
-		if ((sp.effectid[i] == SE_AttackSpeed && sp.base[i] < 100) ||
-				(sp.effectid[i] == SE_AttackSpeed4))
-			return true;
-
-	return false;
+	return SpellIs(spell_id, SpellClass_Slow);
 }
 
 bool IsHasteSpell(uint16 spell_id)
 {
-	const SPDat_Spell_Struct &sp = spells[spell_id];
-
-	for(int i = 0; i < EFFECT_COUNT; i++)
-		if(sp.effectid[i] == SE_AttackSpeed)
-			return (sp.base[i] < 100);
-
-	return false;
+	return SpellIs(spell_id, SpellClass_Haste);
 }
 
 bool IsHarmonySpell(uint16 spell_id)
@@ -214,42 +192,8 @@ bool IsGroupOnlySpell(uint16 spell_id)
 
 bool IsBeneficialSpell(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
-		return false;
-
-	// You'd think just checking goodEffect flag would be enough?
-	if (spells[spell_id].goodEffect == 1) {
-		// If the target type is ST_Self or ST_Pet and is a SE_CancleMagic spell
-		// it is not Beneficial
-		SpellTargetType tt = spells[spell_id].targettype;
-		if (tt != ST_Self && tt != ST_Pet &&
-				IsEffectInSpell(spell_id, SE_CancelMagic))
-			return false;
-
-		// When our targettype is ST_Target, ST_AETarget, ST_Aniaml, ST_Undead, or ST_Pet
-		// We need to check more things!
-		if (tt == ST_Target || tt == ST_AETarget || tt == ST_Animal ||
-				tt == ST_Undead || tt == ST_Pet) {
-			uint16 sai = spells[spell_id].SpellAffectIndex;
-
-			// If the resisttype is magic and SpellAffectIndex is Calm/memblur/dispell sight
-			// it's not beneficial
-			if (spells[spell_id].resisttype == RESIST_MAGIC) {
-				if (sai == SAI_Calm || sai == SAI_Dispell_Sight ||
-						sai == SAI_Memory_Blur || sai == SAI_Calm_Song)
-					return false;
-			} else {
-				// If the resisttype is not magic and spell is Bind Sight or Cast Sight
-				// It's not beneficial
-				if (sai == SAI_Dispell_Sight && spells[spell_id].skill == 18 &&
-						!IsEffectInSpell(spell_id, SE_VoiceGraft))
-					return false;
-			}
-		}
-	}
-
-	// And finally, if goodEffect is not 0 or if it's a group spell it's beneficial
-	return spells[spell_id].goodEffect != 0 || IsGroupSpell(spell_id);
+	// goodEffect alone isn't enough, see IsBeneficial in spdat_classify.cpp for the rules
+	return IsValidSpell(spell_id) && SpellIs(spell_id, SpellClass_Beneficial);
 }
 
 bool IsDetrimentalSpell(uint16 spell_id)
@@ -358,20 +302,7 @@ bool IsAEDurationSpell(uint16 spell_id)
 
 bool IsPureNukeSpell(uint16 spell_id)
 {
-	int i, effect_count = 0;
-
-	if (!IsValidSpell(spell_id))
-		return false;
-
-	for (i = 0; i < EFFECT_COUNT; i++)
-		if (!IsBlankSpellEffect(spell_id, i))
-			effect_count++;
-
-	if (effect_count == 1 && IsEffectInSpell(spell_id, SE_CurrentHP) &&
-			spells[spell_id].buffduration == 0 && IsDamageSpell(spell_id))
-		return true;
-
-	return false;
+	return IsValidSpell(spell_id) && SpellIs(spell_id, SpellClass_PureNuke);
 }
 
 bool IsAENukeSpell(uint16 spell_id)
@@ -460,6 +391,9 @@ bool IsEffectInSpell(uint16 spellid, int effect)
 	if (!IsValidSpell(spellid))
 		return false;
 
+	if (effect >= 0 && effect < SPELL_EFFECT_BITS)
+		return SpellHasEffectBit(spellid, effect);
+
 	for (j = 0; j < EFFECT_COUNT; j++)
 		if (spells[spellid].effectid[j] == effect)
 			return true;
@@ -531,7 +465,7 @@ int GetSpellEffectIndex(uint16 spell_id, int effect)
 {
 	int i;
 
-	if (!IsValidSpell(spell_id))
+	if (!IsEffectInSpell(spell_id, effect))
 		return -1;
 
 	for (i = 0; i < EFFECT_COUNT; i++)
@@ -592,7 +526,7 @@ bool GroupOnlySpell(uint16 spell_id)
 
 int32 CalculatePoisonCounters(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
+	if (!IsEffectInSpell(spell_id, SE_PoisonCounter))
 		return 0;
 
 	int32 Counters = 0;
@@ -606,7 +540,7 @@ int32 CalculatePoisonCounters(uint16 spell_id)
 
 int32 CalculateDiseaseCounters(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
+	if (!IsEffectInSpell(spell_id, SE_DiseaseCounter))
 		return 0;
 
 	int32 Counters = 0;
@@ -620,7 +554,7 @@ int32 CalculateDiseaseCounters(uint16 spell_id)
 
 int32 CalculateCurseCounters(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
+	if (!IsEffectInSpell(spell_id, SE_CurseCounter))
 		return 0;
 
 	int32 Counters = 0;
@@ -634,7 +568,7 @@ int32 CalculateCurseCounters(uint16 spell_id)
 
 int32 CalculateCorruptionCounters(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
+	if (!IsEffectInSpell(spell_id, SE_CorruptionCounter))
 		return 0;
 
 	int32 Counters = 0;
@@ -712,33 +646,17 @@ bool IsResurrectionEffects(uint16 spell_id)
 
 bool IsRuneSpell(uint16 spell_id)
 {
-	if (IsValidSpell(spell_id))
-		for (int i = 0; i < EFFECT_COUNT; i++)
-			if (spells[spell_id].effectid[i] == SE_Rune)
-				return true;
-
-	return false;
+	return IsEffectInSpell(spell_id, SE_Rune);
 }
 
 bool IsMagicRuneSpell(uint16 spell_id)
 {
-	if(IsValidSpell(spell_id))
-		for(int i = 0; i < EFFECT_COUNT; i++)
-			if(spells[spell_id].effectid[i] == SE_AbsorbMagicAtt)
-				return true;
-
-	return false;
+	return IsEffectInSpell(spell_id, SE_AbsorbMagicAtt);
 }
 
 bool IsManaTapSpell(uint16 spell_id)
 {
-	if (IsValidSpell(spell_id))
-		for (int i = 0; i < EFFECT_COUNT; i++)
-			if (spells[spell_id].effectid[i] == SE_CurrentMana &&
-					spells[spell_id].targettype == ST_Tap)
-				return true;
-
-	return false;
+	return IsValidSpell(spell_id) && SpellIs(spell_id, SpellClass_ManaTap);
 }
 
 bool IsAllianceSpellLine(uint16 spell_id)
@@ -760,29 +678,13 @@ bool IsDeathSaveSpell(uint16 spell_id)
 // Deathsave spells with base of 1 are partial
 bool IsPartialDeathSaveSpell(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
-		return false;
-
-	for (int i = 0; i < EFFECT_COUNT; i++)
-		if (spells[spell_id].effectid[i] == SE_DeathSave &&
-				spells[spell_id].base[i] == 1)
-			return true;
-
-	return false;
+	return IsValidSpell(spell_id) && SpellIs(spell_id, SpellClass_PartialDeathSave);
 }
 
 // Deathsave spells with base 2 are "full"
 bool IsFullDeathSaveSpell(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
-		return false;
-
-	for (int i = 0; i < EFFECT_COUNT; i++)
-		if (spells[spell_id].effectid[i] == SE_DeathSave &&
-				spells[spell_id].base[i] == 2)
-			return true;
-
-	return false;
+	return IsValidSpell(spell_id) && SpellIs(spell_id, SpellClass_FullDeathSave);
 }
 
 bool IsShadowStepSpell(uint16 spell_id)
@@ -1018,6 +920,9 @@ bool IsSuspendableSpell(uint16 spell_id)
 
 uint32 GetMorphTrigger(uint32 spell_id)
 {
+	if (!SpellHasEffectBit(spell_id, SE_CastOnFadeEffect))
+		return 0;
+
 	for (int i = 0; i < EFFECT_COUNT; ++i)
 		if (spells[spell_id].effectid[i] == SE_CastOnFadeEffect)
 			return spells[spell_id].base[i];
@@ -1027,15 +932,8 @@ uint32 GetMorphTrigger(uint32 spell_id)
 
 bool IsCastonFadeDurationSpell(uint16 spell_id)
 {
-	for (int i = 0; i < EFFECT_COUNT; ++i) {
-		if (spells[spell_id].effectid[i] == SE_CastOnFadeEffect
-			|| spells[spell_id].effectid[i] == SE_CastOnFadeEffectNPC
-			|| spells[spell_id].effectid[i] == SE_CastOnFadeEffectAlways){
-
-		return true;
-		}
-	}
-	return false;
+	return SpellHasEffectBit(spell_id, SE_CastOnFadeEffect) || SpellHasEffectBit(spell_id, SE_CastOnFadeEffectNPC) ||
+			SpellHasEffectBit(spell_id, SE_CastOnFadeEffectAlways);
 }
 
 bool IsPowerDistModSpell(uint16 spell_id)
@@ -1049,6 +947,9 @@ bool IsPowerDistModSpell(uint16 spell_id)
 
 uint32 GetPartialMeleeRuneReduction(uint32 spell_id)
 {
+	if (!SpellHasEffectBit(spell_id, SE_MitigateMeleeDamage))
+		return 0;
+
 	for (int i = 0; i < EFFECT_COUNT; ++i)
 		if (spells[spell_id].effectid[i] == SE_MitigateMeleeDamage)
 			return spells[spell_id].base[i];
@@ -1058,6 +959,9 @@ uint32 GetPartialMeleeRuneReduction(uint32 spell_id)
 
 uint32 GetPartialMagicRuneReduction(uint32 spell_id)
 {
+	if (!SpellHasEffectBit(spell_id, SE_MitigateSpellDamage))
+		return 0;
+
 	for (int i = 0; i < EFFECT_COUNT; ++i)
 		if (spells[spell_id].effectid[i] == SE_MitigateSpellDamage)
 			return spells[spell_id].base[i];
@@ -1067,6 +971,9 @@ uint32 GetPartialMagicRuneReduction(uint32 spell_id)
 
 uint32 GetPartialMeleeRuneAmount(uint32 spell_id)
 {
+	if (!SpellHasEffectBit(spell_id, SE_MitigateMeleeDamage))
+		return 0;
+
 	for (int i = 0; i < EFFECT_COUNT; ++i)
 		if (spells[spell_id].effectid[i] == SE_MitigateMeleeDamage)
 			return spells[spell_id].max[i];
@@ -1076,6 +983,9 @@ uint32 GetPartialMeleeRuneAmount(uint32 spell_id)
 
 uint32 GetPartialMagicRuneAmount(uint32 spell_id)
 {
+	if (!SpellHasEffectBit(spell_id, SE_MitigateSpellDamage))
+		return 0;
+
 	for (int i = 0; i < EFFECT_COUNT; ++i)
 		if (spells[spell_id].effectid[i] == SE_MitigateSpellDamage)
 			return spells[spell_id].max[i];
@@ -1102,7 +1012,7 @@ uint32 GetNimbusEffect(uint16 spell_id)
 
 int32 GetFuriousBash(uint16 spell_id)
 {
-	if (!IsValidSpell(spell_id))
+	if (!IsEffectInSpell(spell_id, SE_SpellHateMod))
 		return 0;
 
 	bool found_effect_limit = false;
@@ -615,6 +615,22 @@ typedef enum {
 
 // LAST
 
+#define SPELL_EFFECT_BITS				512 // effect ids covered by SPDat_Spell_Struct::effect_bits
+
+// flags in SPDat_Spell_Struct::classification, filled in by CalcSpellClassification when the spells are
+// loaded so the predicates below don't have to walk the effects. the ones marked valid only hold for
+// spells that pass IsValidSpell, the predicates check that themselves
+enum SpellClassification {
+	SpellClass_Beneficial		= 1 << 0,	// IsBeneficialSpell (valid)
+	SpellClass_Damage			= 1 << 1,	// IsDamageSpell
+	SpellClass_Slow				= 1 << 2,	// IsSlowSpell
+	SpellClass_Haste			= 1 << 3,	// IsHasteSpell
+	SpellClass_PureNuke			= 1 << 4,	// IsPureNukeSpell (valid)
+	SpellClass_ManaTap			= 1 << 5,	// IsManaTapSpell (valid)
+	SpellClass_PartialDeathSave	= 1 << 6,	// IsPartialDeathSaveSpell (valid)
+	SpellClass_FullDeathSave	= 1 << 7	// IsFullDeathSaveSpell (valid)
+};
+
 
 #define DF_Permanent			50
 
@@ -759,6 +775,8 @@ struct SPDat_Spell_Struct
 /* 231 */   float min_range; //Min casting range 
 /* 232 - 236 */
 			uint8 DamageShieldType; // This field does not exist in spells_us.txt
+			uint32 effect_bits[SPELL_EFFECT_BITS / 32]; // Not in spells_us.txt: a bit for every effect id in effectid
+			uint32 classification; // Not in spells_us.txt: SpellClassification flags
 };
 
 extern const SPDat_Spell_Struct* spells;
@@ -875,4 +893,7 @@ bool IsShortDurationBuff(uint16 spell_id);
 bool IsSpellUsableThisZoneType(uint16 spell_id, uint8 zone_type);
 const char *GetSpellName(int16 spell_id);
 
+// fills in effect_bits and classification from the rest of the spell, run by the loader for every record
+void CalcSpellClassification(SPDat_Spell_Struct *sp);
+
 #endif
@@ -0,0 +1,154 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2002 EQEMu Development Team (http://eqemu.org)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*
+	Works out the per spell flags the spdat.cpp predicates test. These are
+	the loops the predicates used to run on every call, done once per record
+	when the shared memory spell table is built. They only look at the record
+	itself, so this file doesn't need the spells table (shared_memory links it
+	without one); anything that depends on IsValidSpell is checked at call time.
+*/
+
+#include "spdat.h"
+
+#include <string.h>
+
+static bool HasEffect(const SPDat_Spell_Struct &sp, int effect)
+{
+	for (int i = 0; i < EFFECT_COUNT; i++)
+		if (sp.effectid[i] == effect)
+			return true;
+
+	return false;
+}
+
+static bool IsGroupTarget(const SPDat_Spell_Struct &sp)
+{
+	return sp.targettype == ST_AEBard || sp.targettype == ST_Group || sp.targettype == ST_GroupTeleport;
+}
+
+// IsBeneficialSpell for a valid spell
+static bool IsBeneficial(const SPDat_Spell_Struct &sp)
+{
+	if (sp.goodEffect == 1) {
+		SpellTargetType tt = sp.targettype;
+		if (tt != ST_Self && tt != ST_Pet && HasEffect(sp, SE_CancelMagic))
+			return false;
+
+		if (tt == ST_Target || tt == ST_AETarget || tt == ST_Animal ||
+				tt == ST_Undead || tt == ST_Pet) {
+			uint16 sai = sp.SpellAffectIndex;
+
+			if (sp.resisttype == RESIST_MAGIC) {
+				if (sai == SAI_Calm || sai == SAI_Dispell_Sight ||
+						sai == SAI_Memory_Blur || sai == SAI_Calm_Song)
+					return false;
+			} else {
+				if (sai == SAI_Dispell_Sight && sp.skill == 18 && !HasEffect(sp, SE_VoiceGraft))
+					return false;
+			}
+		}
+	}
+
+	return sp.goodEffect != 0 || IsGroupTarget(sp);
+}
+
+static bool IsDamage(const SPDat_Spell_Struct &sp)
+{
+	for (int i = 0; i < EFFECT_COUNT; i++) {
+		int tid = sp.effectid[i];
+		if ((tid == SE_CurrentHPOnce || tid == SE_CurrentHP) &&
+				sp.targettype != ST_Tap && sp.buffduration < 1 && sp.base[i] < 0)
+			return true;
+	}
+
+	return false;
+}
+
+static bool IsSlow(const SPDat_Spell_Struct &sp)
+{
+	for (int i = 0; i < EFFECT_COUNT; i++)
+		if ((sp.effectid[i] == SE_AttackSpeed && sp.base[i] < 100) || sp.effectid[i] == SE_AttackSpeed4)
+			return true;
+
+	return false;
+}
+
+// only the first attack speed effect counts
+static bool IsHaste(const SPDat_Spell_Struct &sp)
+{
+	for (int i = 0; i < EFFECT_COUNT; i++)
+		if (sp.effectid[i] == SE_AttackSpeed)
+			return sp.base[i] < 100;
+
+	return false;
+}
+
+// IsPureNukeSpell for a valid spell, see IsBlankSpellEffect for what counts as blank
+static bool IsPureNuke(const SPDat_Spell_Struct &sp)
+{
+	int effect_count = 0;
+	for (int i = 0; i < EFFECT_COUNT; i++) {
+		int effect = sp.effectid[i];
+		if (effect == SE_Blank || (effect == SE_CHA && sp.base[i] == 0 && sp.formula[i] == 100) ||
+				effect == SE_StackingCommand_Block || effect == SE_StackingCommand_Overwrite)
+			continue;
+		effect_count++;
+	}
+
+	return effect_count == 1 && HasEffect(sp, SE_CurrentHP) && sp.buffduration == 0 && IsDamage(sp);
+}
+
+static bool HasDeathSave(const SPDat_Spell_Struct &sp, int base)
+{
+	for (int i = 0; i < EFFECT_COUNT; i++)
+		if (sp.effectid[i] == SE_DeathSave && sp.base[i] == base)
+			return true;
+
+	return false;
+}
+
+void CalcSpellClassification(SPDat_Spell_Struct *sp)
+{
+	memset(sp->effect_bits, 0, sizeof(sp->effect_bits));
+	for (int i = 0; i < EFFECT_COUNT; i++) {
+		int effect = sp->effectid[i];
+		if (effect >= 0 && effect < SPELL_EFFECT_BITS)
+			sp->effect_bits[effect >> 5] |= 1u << (effect & 31);
+	}
+
+	uint32 flags = 0;
+	if (IsBeneficial(*sp))
+		flags |= SpellClass_Beneficial;
+	if (IsDamage(*sp))
+		flags |= SpellClass_Damage;
+	if (IsSlow(*sp))
+		flags |= SpellClass_Slow;
+	if (IsHaste(*sp))
+		flags |= SpellClass_Haste;
+	if (IsPureNuke(*sp))
+		flags |= SpellClass_PureNuke;
+	if (HasEffect(*sp, SE_CurrentMana) && sp->targettype == ST_Tap)
+		flags |= SpellClass_ManaTap;
+	if (HasDeathSave(*sp, 1))
+		flags |= SpellClass_PartialDeathSave;
+	if (HasDeathSave(*sp, 2))
+		flags |= SpellClass_FullDeathSave;
+
+	sp->classification = flags;
+}
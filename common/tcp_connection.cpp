@@ -25,6 +25,10 @@
 
 #include "tcp_connection.h"
 
+#ifndef _WINDOWS
+	#include <sys/uio.h>
+#endif
+
 #ifdef FREEBSD //Timothy Whitman - January 7, 2003
 	#define MSG_NOSIGNAL 0
 #endif
@@ -37,7 +41,9 @@
 InitWinsock winsock;
 #endif
 
-#define LOOP_GRANULARITY 3	//# of ms between checking our socket/queues
+#define SEND_IOV_MAX	64	//# of queued buffers handed to one writev
+#define SEND_BATCH_SIZE	EQEmu::PacketBuffer::MaxPooledSize	//bytes per batch buffer
+#define SEND_BATCH_COPY_LIMIT	1024	//larger writes are queued as they are, not copied into a batch
 
 #define TCPN_DEBUG				0
 #define TCPN_DEBUG_Console		0
@@ -57,7 +63,10 @@ TCPConnection::TCPConnection()
 	pFree = false;
 	pEcho = false;
 	recvbuf = nullptr;
-	sendbuf = nullptr;
+	sendseg_offset = 0;
+	pBatching = false;
+	batchbuf = nullptr;
+	batchbuf_used = 0;
 	pRunLoop = false;
 	charAsyncConnect = 0;
 	pAsyncConnect = false;
@@ -79,7 +88,10 @@ TCPConnection::TCPConnection(uint32 ID, SOCKET in_socket, uint32 irIP, uint16 ir
 	pFree = false;
 	pEcho = false;
 	recvbuf = nullptr;
-	sendbuf = nullptr;
+	sendseg_offset = 0;
+	pBatching = false;
+	batchbuf = nullptr;
+	batchbuf_used = 0;
 	pRunLoop = false;
 	charAsyncConnect = 0;
 	pAsyncConnect = false;
@@ -90,6 +102,7 @@ TCPConnection::TCPConnection(uint32 ID, SOCKET in_socket, uint32 irIP, uint16 ir
 }
 
 TCPConnection::~TCPConnection() {
+	ReactorDetach();
 	FinishDisconnect();
 	ClearBuffers();
 	if (ConnectionType == Outgoing) {
@@ -108,7 +121,6 @@ TCPConnection::~TCPConnection() {
 	}
 #endif
 	safe_delete_array(recvbuf);
-	safe_delete_array(sendbuf);
 	safe_delete_array(charAsyncConnect);
 }
 
@@ -179,97 +191,112 @@ bool TCPConnection::Send(const uchar* data, int32 size) {
 }
 
 void TCPConnection::ServerSendQueuePushEnd(const uchar* data, int32 size) {
-	MSendQueue.lock();
-	if (sendbuf == nullptr) {
-		sendbuf = new uchar[size];
-		sendbuf_size = size;
-		sendbuf_used = 0;
-	}
-	else if (size > (sendbuf_size - sendbuf_used)) {
-		sendbuf_size += size + 1024;
-		uchar* tmp = new uchar[sendbuf_size];
-		memcpy(tmp, sendbuf, sendbuf_used);
-		safe_delete_array(sendbuf);
-		sendbuf = tmp;
-	}
-	memcpy(&sendbuf[sendbuf_used], data, size);
-	sendbuf_used += size;
-	MSendQueue.unlock();
-}
-
-void TCPConnection::ServerSendQueuePushEnd(uchar** data, int32 size) {
-	MSendQueue.lock();
-	if (sendbuf == 0) {
-		sendbuf = *data;
-		sendbuf_size = size;
-		sendbuf_used = size;
-		MSendQueue.unlock();
-		*data = 0;
+	if (size <= 0)
 		return;
+	if (pBatching && size <= SEND_BATCH_COPY_LIMIT) {
+		LockMutex lock(&MBatch);
+		if (pBatching) {
+			BatchAppend(data, size);
+			return;
+		}
 	}
-	if (size > (sendbuf_size - sendbuf_used)) {
-		sendbuf_size += size;
-		uchar* tmp = new uchar[sendbuf_size];
-		memcpy(tmp, sendbuf, sendbuf_used);
-		safe_delete_array(sendbuf);
-		sendbuf = tmp;
-	}
-	memcpy(&sendbuf[sendbuf_used], *data, size);
-	sendbuf_used += size;
-	MSendQueue.unlock();
-	safe_delete_array(*data);
+	EQEmu::PacketBuffer* buffer = EQEmu::PacketBuffer::Create(size);
+	memcpy(buffer->Data(), data, size);
+	ServerSendQueuePush(buffer, size);
 }
 
-void TCPConnection::ServerSendQueuePushFront(uchar* data, int32 size) {
-	MSendQueue.lock();
-	if (sendbuf == 0) {
-		sendbuf = new uchar[size];
-		sendbuf_size = size;
-		sendbuf_used = 0;
-	}
-	else if (size > (sendbuf_size - sendbuf_used)) {
-		sendbuf_size += size;
-		uchar* tmp = new uchar[sendbuf_size];
-		memcpy(&tmp[size], sendbuf, sendbuf_used);
-		safe_delete_array(sendbuf);
-		sendbuf = tmp;
+void TCPConnection::ServerSendQueuePushEnd(EQEmu::PacketBuffer* buffer, int32 size) {
+	if (size <= 0)
+		return;
+	if (pBatching && size <= SEND_BATCH_COPY_LIMIT) {
+		LockMutex lock(&MBatch);
+		if (pBatching) {
+			BatchAppend(buffer->Data(), size);
+			return;
+		}
 	}
-	memcpy(sendbuf, data, size);
-	sendbuf_used += size;
-	MSendQueue.unlock();
+	buffer->Ref();
+	ServerSendQueuePush(buffer, size);
 }
 
-bool TCPConnection::ServerSendQueuePop(uchar** data, int32* size) {
-	bool ret;
-	if (!MSendQueue.trylock())
-		return false;
-	if (sendbuf) {
-		*data = sendbuf;
-		*size = sendbuf_used;
-		sendbuf = 0;
-		ret = true;
+void TCPConnection::ServerSendQueuePush(EQEmu::PacketBuffer* buffer, int32 size) {
+	SendSegment seg;
+	seg.buffer = buffer;
+	seg.size = size;
+	bool wake;
+	if (pBatching) {
+		//whatever is already batched was queued first
+		LockMutex lock(&MBatch);
+		wake = BatchFlush();
+		wake = SendQueue.Push(seg) || wake;
 	}
 	else {
-		ret = false;
+		wake = SendQueue.Push(seg);
 	}
-	MSendQueue.unlock();
-	return ret;
+	//the first push since the reactor last drained the queue has to wake it
+	if (wake)
+		EQEmu::TCPReactor::Get().Wake(this);
 }
 
-bool TCPConnection::ServerSendQueuePopForce(uchar** data, int32* size) {
-	bool ret;
-	MSendQueue.lock();
-	if (sendbuf) {
-		*data = sendbuf;
-		*size = sendbuf_used;
-		sendbuf = 0;
-		ret = true;
-	}
-	else {
-		ret = false;
+void TCPConnection::BatchAppend(const uchar* data, int32 size) {
+	if (batchbuf && batchbuf_used + size > (int32) batchbuf->Capacity() && BatchFlush())
+		EQEmu::TCPReactor::Get().Wake(this);
+
+	if (!batchbuf) {
+		batchbuf = EQEmu::PacketBuffer::Create(SEND_BATCH_SIZE);
+		batchbuf_used = 0;
+		//SendData flushes the batch, so only a new one needs the reactor's attention
+		EQEmu::TCPReactor::Get().Wake(this);
 	}
-	MSendQueue.unlock();
-	return ret;
+	memcpy(batchbuf->Data() + batchbuf_used, data, size);
+	batchbuf_used += size;
+}
+
+bool TCPConnection::BatchFlush() {
+	if (!batchbuf)
+		return false;
+	SendSegment seg;
+	seg.buffer = batchbuf;
+	seg.size = batchbuf_used;
+	batchbuf = nullptr;
+	batchbuf_used = 0;
+	return SendQueue.Push(seg);
+}
+
+void TCPConnection::SetBatching(bool iValue) {
+	LockMutex lock(&MBatch);
+	if (!iValue && BatchFlush())
+		EQEmu::TCPReactor::Get().Wake(this);
+	pBatching = iValue;
+}
+
+bool TCPConnection::ServerSendQueueEmpty() {
+	LockMutex lock(&MSendQueue);
+	MBatch.lock();
+	BatchFlush();
+	MBatch.unlock();
+	SendSegment seg;
+	while (SendQueue.Pop(seg))
+		sendsegs.push_back(seg);
+	return sendsegs.empty();
+}
+
+void TCPConnection::ServerSendQueueClear() {
+	LockMutex lock(&MSendQueue);
+	MBatch.lock();
+	if (batchbuf) {
+		batchbuf->Unref();
+		batchbuf = nullptr;
+		batchbuf_used = 0;
+	}
+	MBatch.unlock();
+	SendSegment seg;
+	while (SendQueue.Pop(seg))
+		seg.buffer->Unref();
+	for (auto iter = sendsegs.begin(); iter != sendsegs.end(); ++iter)
+		iter->buffer->Unref();
+	sendsegs.clear();
+	sendseg_offset = 0;
 }
 
 char* TCPConnection::PopLine() {
@@ -297,6 +324,7 @@ void TCPConnection::FinishDisconnect() {
 			SendData(sent_something);
 		}
 		pState = TCPS_Closing;
+		EQEmu::TCPReactor::Get().Unwatch(connection_socket);
 		shutdown(connection_socket, 0x01);
 		shutdown(connection_socket, 0x00);
 #ifdef _WINDOWS
@@ -314,11 +342,16 @@ void TCPConnection::FinishDisconnect() {
 }
 
 void TCPConnection::Disconnect() {
+	bool changed = false;
 	MState.lock();
 	if(pState == TCPS_Connected || pState == TCPS_Connecting) {
 		pState = TCPS_Disconnecting;
+		changed = true;
 	}
 	MState.unlock();
+	//waking on every call would have the reactor service a dead link over and over
+	if (changed)
+		EQEmu::TCPReactor::Get().Wake(this);
 }
 
 bool TCPConnection::GetAsyncConnect() {
@@ -381,15 +414,13 @@ void TCPConnection::AsyncConnect(uint32 irIP, uint16 irPort) {
 	rIP = irIP;
 	rPort = irPort;
 	MAsyncConnect.unlock();
-	if (!pRunLoop) {
-		pRunLoop = true;
 #ifdef _WINDOWS
-		_beginthread(TCPConnectionLoop, 0, this);
+	_beginthread(AsyncConnectThread, 0, this);
 #else
-		pthread_t thread;
-		pthread_create(&thread, nullptr, TCPConnectionLoop, this);
+	pthread_t thread;
+	pthread_create(&thread, nullptr, AsyncConnectThread, this);
+	pthread_detach(thread);
 #endif
-	}
 	return;
 }
 
@@ -427,15 +458,6 @@ bool TCPConnection::ConnectIP(uint32 in_ip, uint16 in_port, char* errbuf) {
 		return false;
 	}
 	MState.unlock();
-	if (!pRunLoop) {
-		pRunLoop = true;
-#ifdef _WINDOWS
-		_beginthread(TCPConnectionLoop, 0, this);
-#else
-		pthread_t thread;
-		pthread_create(&thread, nullptr, TCPConnectionLoop, this);
-#endif
-	}
 
 	connection_socket = INVALID_SOCKET;
 	struct sockaddr_in	server_sin;
@@ -494,6 +516,11 @@ bool TCPConnection::ConnectIP(uint32 in_ip, uint16 in_port, char* errbuf) {
 	rIP = in_ip;
 	rPort = in_port;
 	SetState(TCPS_Connected);
+	MRunLoop.lock();
+	pRunLoop = true;
+	MRunLoop.unlock();
+	EQEmu::TCPReactor::Get().Watch(this, connection_socket);
+	EQEmu::TCPReactor::Get().Attach(this);
 	SetAsyncConnect(false);
 	return true;
 }
@@ -503,7 +530,7 @@ void TCPConnection::ClearBuffers() {
 	LockMutex lock3(&MRunLoop);
 	LockMutex lock4(&MState);
 	safe_delete_array(recvbuf);
-	safe_delete_array(sendbuf);
+	ServerSendQueueClear();
 
 	char* line = 0;
 	while ((line = LineOutQueue.pop()))
@@ -520,20 +547,13 @@ bool TCPConnection::CheckNetActive() {
 	return false;
 }
 
-/* This is always called from an IO thread. Either the server socket's thread, or a
- * special thread we create when we make an outbound connection. */
+/* This is always called from the reactor thread, see ReactorService() */
 bool TCPConnection::Process() {
 	char errbuf[TCPConnection_ErrorBufferSize];
 	switch(GetState()) {
 	case TCPS_Ready:
 	case TCPS_Connecting:
-		if (ConnectionType == Outgoing) {
-			if (GetAsyncConnect()) {
-				if (charAsyncConnect)
-					rIP = ResolveIP(charAsyncConnect);
-				ConnectIP(rIP, rPort);
-			}
-		}
+		//async connects are made by AsyncConnectThread
 		return(true);
 
 	case TCPS_Connected:
@@ -548,17 +568,10 @@ bool TCPConnection::Process() {
 
 	case TCPS_Disconnecting: {
 		//waiting for any sending data to go out...
-		MSendQueue.lock();
-		if(sendbuf) {
-			if(sendbuf_used > 0) {
-				//something left to send, keep processing...
-				MSendQueue.unlock();
-				break;
-			}
-			//else, send buffer is empty.
-			safe_delete_array(sendbuf);
-		} //else, no send buffer, we are done.
-		MSendQueue.unlock();
+		if(!ServerSendQueueEmpty()) {
+			//something left to send, keep processing...
+			break;
+		}
 	}
 		/* Fallthrough */
 
@@ -600,65 +613,73 @@ bool TCPConnection::RecvData(char* errbuf) {
 		return false;
 	}
 
-	int	status = 0;
-	if (recvbuf == 0) {
-		recvbuf = new uchar[5120];
-		recvbuf_size = 5120;
-		recvbuf_used = 0;
-		recvbuf_echo = 0;
-	}
-	else if ((recvbuf_size - recvbuf_used) < 2048) {
-		uchar* tmpbuf = new uchar[recvbuf_size + 5120];
-		memcpy(tmpbuf, recvbuf, recvbuf_used);
-		recvbuf_size += 5120;
-		safe_delete_array(recvbuf);
-		recvbuf = tmpbuf;
-		if (recvbuf_size >= MaxTCPReceiveBuffferSize) {
-			if (errbuf)
-				snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): recvbuf_size >= MaxTCPReceiveBuffferSize");
-			return false;
+	//the socket is edge triggered, keep reading until it has nothing left
+	for (;;) {
+		if (recvbuf == 0) {
+			recvbuf = new uchar[5120];
+			recvbuf_size = 5120;
+			recvbuf_used = 0;
+			recvbuf_echo = 0;
+		}
+		else if ((recvbuf_size - recvbuf_used) < 2048) {
+			uchar* tmpbuf = new uchar[recvbuf_size + 5120];
+			memcpy(tmpbuf, recvbuf, recvbuf_used);
+			recvbuf_size += 5120;
+			safe_delete_array(recvbuf);
+			recvbuf = tmpbuf;
+			if (recvbuf_size >= MaxTCPReceiveBuffferSize) {
+				if (errbuf)
+					snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): recvbuf_size >= MaxTCPReceiveBuffferSize");
+				return false;
+			}
 		}
-	}
 
-	status = recv(connection_socket, (char *) &recvbuf[recvbuf_used], (recvbuf_size - recvbuf_used), 0);
+		int32 space = recvbuf_size - recvbuf_used;
+		int status = recv(connection_socket, (char *) &recvbuf[recvbuf_used], space, 0);
 
-	if (status >= 1) {
+		if (status >= 1) {
 #if TCPN_LOG_RAW_DATA_IN >= 1
-		struct in_addr	in;
-		in.s_addr = GetrIP();
-		CoutTimestamp(true);
-		std::cout << ": Read " << status << " bytes from network. (recvbuf_used = " << recvbuf_used << ") " << inet_ntoa(in) << ":" << GetrPort();
-		std::cout << std::endl;
+			struct in_addr	in;
+			in.s_addr = GetrIP();
+			CoutTimestamp(true);
+			std::cout << ": Read " << status << " bytes from network. (recvbuf_used = " << recvbuf_used << ") " << inet_ntoa(in) << ":" << GetrPort();
+			std::cout << std::endl;
 	#if TCPN_LOG_RAW_DATA_IN == 2
-		int32 tmp = status;
-		if (tmp > 32)
-			tmp = 32;
-		DumpPacket(&recvbuf[recvbuf_used], status);
+			int32 tmp = status;
+			if (tmp > 32)
+				tmp = 32;
+			DumpPacket(&recvbuf[recvbuf_used], status);
 	#elif TCPN_LOG_RAW_DATA_IN >= 3
-		DumpPacket(&recvbuf[recvbuf_used], status);
+			DumpPacket(&recvbuf[recvbuf_used], status);
 	#endif
 #endif
-		recvbuf_used += status;
-		if (!ProcessReceivedData(errbuf))
-			return false;
-	}
-	else if (status == SOCKET_ERROR) {
-#ifdef _WINDOWS
-		if (!(WSAGetLastError() == WSAEWOULDBLOCK)) {
-			if (errbuf)
-				snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): Error: %i", WSAGetLastError());
-			return false;
+			recvbuf_used += status;
+			if (!ProcessReceivedData(errbuf))
+				return false;
+			//a short read means the socket is drained
+			if (status < space)
+				break;
 		}
+		else if (status == SOCKET_ERROR) {
+#ifdef _WINDOWS
+			if (!(WSAGetLastError() == WSAEWOULDBLOCK)) {
+				if (errbuf)
+					snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): Error: %i", WSAGetLastError());
+				return false;
+			}
 #else
-		if (!(errno == EWOULDBLOCK)) {
+			if (!(errno == EWOULDBLOCK)) {
+				if (errbuf)
+					snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): Error: %s", strerror(errno));
+				return false;
+			}
+#endif
+			break;
+		} else if (status == 0) {
 			if (errbuf)
-				snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): Error: %s", strerror(errno));
+				snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): Connection closed");
 			return false;
 		}
-#endif
-	} else if (status == 0) {
-		snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::RecvData(): Connection closed");
-		return false;
 	}
 
 	return true;
@@ -812,123 +833,148 @@ bool TCPConnection::ProcessReceivedData(char* errbuf) {
 bool TCPConnection::SendData(bool &sent_something, char* errbuf) {
 	if (errbuf)
 		errbuf[0] = 0;
-	/************ Get first send packet on queue and send it! ************/
-	uchar* data = 0;
-	int32 size = 0;
-	int status = 0;
-	if (ServerSendQueuePop(&data, &size)) {
+	/************ Write as much of the send queue as the socket will take ************/
+	LockMutex lock(&MSendQueue);
+	if (pBatching) {
+		MBatch.lock();
+		BatchFlush();
+		MBatch.unlock();
+	}
+	SendSegment seg;
+	while (SendQueue.Pop(seg))
+		sendsegs.push_back(seg);
+
+	while (!sendsegs.empty()) {
+		int32 size = 0;
+		int status = 0;
 #ifdef _WINDOWS
-		status = send(connection_socket, (const char *) data, size, 0);
+		size = sendsegs.front().size - sendseg_offset;
+		status = send(connection_socket, (const char *) &sendsegs.front().buffer->Data()[sendseg_offset], size, 0);
 #else
-		status = send(connection_socket, data, size, MSG_NOSIGNAL);
-		if(errno==EPIPE) status = SOCKET_ERROR;
-#endif
-		if (status >= 1) {
-#if TCPN_LOG_RAW_DATA_OUT >= 1
-			struct in_addr	in;
-			in.s_addr = GetrIP();
-			CoutTimestamp(true);
-			std::cout << ": Wrote " << status << " bytes to network. " << inet_ntoa(in) << ":" << GetrPort();
-			std::cout << std::endl;
-	#if TCPN_LOG_RAW_DATA_OUT == 2
-			int32 tmp = status;
-			if (tmp > 32)
-				tmp = 32;
-			DumpPacket(data, status);
-	#elif TCPN_LOG_RAW_DATA_OUT >= 3
-			DumpPacket(data, status);
-	#endif
-#endif
-			sent_something = true;
-			if (status < (signed)size) {
-#if TCPN_LOG_RAW_DATA_OUT >= 1
-				struct in_addr	in;
-				in.s_addr = GetrIP();
-				CoutTimestamp(true);
-				std::cout << ": Pushed " << (size - status) << " bytes back onto the send queue. " << inet_ntoa(in) << ":" << GetrPort();
-				std::cout << std::endl;
-#endif
-				// If there's network congestion, the number of bytes sent can be less than
-				// what we tried to give it... Push the extra back on the queue for later
-				ServerSendQueuePushFront(&data[status], size - status);
-			}
-			else if (status > (signed)size) {
-				return false;
-			}
-			// else if (status == size) {}
-		}
-		else {
-			ServerSendQueuePushFront(data, size);
+		struct iovec iov[SEND_IOV_MAX];
+		int count = 0;
+		for (auto iter = sendsegs.begin(); iter != sendsegs.end() && count < SEND_IOV_MAX; ++iter, ++count) {
+			int32 offset = (count == 0) ? sendseg_offset : 0;
+			iov[count].iov_base = &iter->buffer->Data()[offset];
+			iov[count].iov_len = iter->size - offset;
+			size += iter->size - offset;
 		}
 
-		safe_delete_array(data);
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = count;
+		status = sendmsg(connection_socket, &msg, MSG_NOSIGNAL);
+#endif
 		if (status == SOCKET_ERROR) {
 #ifdef _WINDOWS
-			if (WSAGetLastError() != WSAEWOULDBLOCK)
+			if (WSAGetLastError() == WSAEWOULDBLOCK)
 #else
-			if (errno != EWOULDBLOCK)
+			if (errno == EWOULDBLOCK)
 #endif
 			{
-				if (errbuf) {
+				//the socket is full, the reactor comes back once it drains
+				break;
+			}
+
+			if (errbuf) {
 #ifdef _WINDOWS
-					snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::SendData(): send(): Errorcode: %i", WSAGetLastError());
+				snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::SendData(): send(): Errorcode: %i", WSAGetLastError());
 #else
-					snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::SendData(): send(): Errorcode: %s", strerror(errno));
+				snprintf(errbuf, TCPConnection_ErrorBufferSize, "TCPConnection::SendData(): send(): Errorcode: %s", strerror(errno));
 #endif
-				}
+			}
 
-				//if we get an error while disconnecting, just jump to disconnected
-				MState.lock();
-				if(pState == TCPS_Disconnecting)
-					pState = TCPS_Disconnected;
-				MState.unlock();
+			//if we get an error while disconnecting, just jump to disconnected
+			MState.lock();
+			if(pState == TCPS_Disconnecting)
+				pState = TCPS_Disconnected;
+			MState.unlock();
 
-				return false;
+			return false;
+		}
+		if (status <= 0)
+			break;
+
+#if TCPN_LOG_RAW_DATA_OUT >= 1
+		struct in_addr	in;
+		in.s_addr = GetrIP();
+		CoutTimestamp(true);
+		std::cout << ": Wrote " << status << " of " << size << " bytes to network. " << inet_ntoa(in) << ":" << GetrPort();
+		std::cout << std::endl;
+#endif
+		sent_something = true;
+
+		//drop whatever went out, a partly written buffer stays at the front
+		int32 left = status;
+		while (left > 0) {
+			int32 remaining = sendsegs.front().size - sendseg_offset;
+			if (left < remaining) {
+				sendseg_offset += left;
+				break;
 			}
+			left -= remaining;
+			sendsegs.front().buffer->Unref();
+			sendsegs.pop_front();
+			sendseg_offset = 0;
 		}
+
+		if (status < size)
+			break;
 	}
 	return true;
 }
 
-ThreadReturnType TCPConnection::TCPConnectionLoop(void* tmp) {
-#ifdef _WINDOWS
-	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
-#endif
+void TCPConnection::ReactorAttach() {
+	if (connection_socket != INVALID_SOCKET && connection_socket != 0)
+		EQEmu::TCPReactor::Get().Watch(this, connection_socket);
+	EQEmu::TCPReactor::Get().Attach(this);
+}
+
+void TCPConnection::ReactorDetach() {
+	if (ConnectionType == Outgoing) {
+		//a connect still in progress would attach us again
+		MLoopRunning.lock();
+		MLoopRunning.unlock();
+	}
+	EQEmu::TCPReactor::Get().Detach(this);
+}
+
+bool TCPConnection::ReactorService() {
+	if (ConnectionType == Incoming) {
+		//incoming connections stay attached until their server deletes them, once closed there is nothing left to do
+		State_t state = GetState();
+		if (state == TCPS_Closing || state == TCPS_Error)
+			return true;
+		if (!Process() && state == TCPS_Connected)
+			Disconnect();
+		return true;
+	}
+
+	if (!RunLoop())
+		return false;
+	if (!ConnectReady() && !Process()) {
+		//the processing loop has detecting an error..
+		//we want to drop the link immediately, so we clear buffers too.
+		ClearBuffers();
+		Disconnect();
+	}
+	return RunLoop();
+}
+
+ThreadReturnType TCPConnection::AsyncConnectThread(void* tmp) {
 	if (tmp == 0) {
 		THREAD_RETURN(nullptr);
 	}
 	TCPConnection* tcpc = (TCPConnection*) tmp;
-#ifndef WIN32
-	Log.Out(Logs::Detail, Logs::TCP_Connection, "%s Starting TCPConnectionLoop with thread ID %d", __FUNCTION__, pthread_self());
-#endif
 	tcpc->MLoopRunning.lock();
-	while (tcpc->RunLoop()) {
-		Sleep(LOOP_GRANULARITY);
-		if (!tcpc->ConnectReady()) {
-			if (!tcpc->Process()) {
-				//the processing loop has detecting an error..
-				//we want to drop the link immediately, so we clear buffers too.
-				tcpc->ClearBuffers();
-				tcpc->Disconnect();
-			}
-			Sleep(1);
-		}
-		else if (tcpc->GetAsyncConnect()) {
-			if (tcpc->charAsyncConnect)
-				tcpc->Connect(tcpc->charAsyncConnect, tcpc->GetrPort());
-			else
-				tcpc->ConnectIP(tcpc->GetrIP(), tcpc->GetrPort());
-			tcpc->SetAsyncConnect(false);
-		}
-		else
-			Sleep(10);	//nothing to do.
-	}
+	if (tcpc->charAsyncConnect)
+		tcpc->Connect(tcpc->charAsyncConnect, tcpc->GetrPort());
+	else
+		tcpc->ConnectIP(tcpc->GetrIP(), tcpc->GetrPort());
+	tcpc->SetAsyncConnect(false);
 	tcpc->MLoopRunning.unlock();
 
-#ifndef WIN32
-	Log.Out(Logs::Detail, Logs::TCP_Connection, "%s Ending TCPConnectionLoop with thread ID %d", __FUNCTION__, pthread_self());
-#endif
-
 	THREAD_RETURN(nullptr);
 }
 
@@ -939,4 +985,3 @@ bool TCPConnection::RunLoop() {
 	MRunLoop.unlock();
 	return ret;
 }
-
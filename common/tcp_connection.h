@@ -47,6 +47,9 @@
 #include "mutex.h"
 #include "queue.h"
 #include "misc_functions.h"
+#include "tcp_reactor.h"
+#include "packet_buffer.h"
+#include <deque>
 
 
 #define TCPConnection_ErrorBufferSize	1024
@@ -59,7 +62,7 @@ enum eConnectionType {Incoming, Outgoing};
 #endif
 
 
-class TCPConnection {
+class TCPConnection : public EQEmu::TCPReactor::Handler {
 protected:
 	typedef enum {
 		TCPS_Ready = 0,
@@ -100,18 +103,26 @@ public:
 
 	bool			GetEcho();
 	void			SetEcho(bool iValue);
+	//copy small writes into shared batch buffers so a burst goes out as a few large segments
+	bool			GetBatching() const { return pBatching; }
+	void			SetBatching(bool iValue);
 	bool GetSockName(char *host, uint16 *port);
 
 	//should only be used by TCPServer<T>:
 	bool			CheckNetActive();
 	inline bool		IsFree() const { return pFree; }
 	virtual bool	Process();
+	void			ReactorAttach();	// incoming connections, start being serviced
+	void			ReactorDetach();	// waits for a service call in progress to finish
 
 protected:
 	friend class BaseTCPServer;
 	void			SetState(State_t iState);
 
-	static ThreadReturnType TCPConnectionLoop(void* tmp);
+	//the reactor calls Process() whenever the socket is ready, a send is queued or a tick goes by
+	virtual bool	ReactorService();
+	//outgoing connections resolve and connect here so a slow host doesn't hold up the reactor
+	static ThreadReturnType AsyncConnectThread(void* tmp);
 //	SOCKET			sock;
 	bool			RunLoop();
 	Mutex			MLoopRunning;
@@ -155,18 +166,32 @@ protected:
 	int32	recvbuf_echo;
 	volatile bool	pEcho;
 
+	//outgoing data. Any thread pushes buffers onto SendQueue without locking, whoever writes to the
+	//socket holds MSendQueue, moves them to sendsegs and hands as many as it can to one writev.
+	//With batching on, writes up to SEND_BATCH_COPY_LIMIT bytes are copied into batchbuf under
+	//MBatch instead, which goes onto SendQueue as one segment when it fills or the socket is written.
+	struct SendSegment {
+		EQEmu::PacketBuffer*	buffer;	//one reference, released once written
+		int32	size;
+	};
 	Mutex	MSendQueue;
-	uchar*	sendbuf;
-	int32	sendbuf_size;
-	int32	sendbuf_used;
-	bool	ServerSendQueuePop(uchar** data, int32* size);
-	bool	ServerSendQueuePopForce(uchar** data, int32* size);		//does a lock() instead of a trylock()
+	EQEmu::HandoffQueue<SendSegment> SendQueue;
+	std::deque<SendSegment> sendsegs;
+	int32	sendseg_offset;	//bytes of sendsegs.front() already written
+	Mutex	MBatch;
+	std::atomic<bool>	pBatching;
+	EQEmu::PacketBuffer*	batchbuf;
+	int32	batchbuf_used;
 	void	ServerSendQueuePushEnd(const uchar* data, int32 size);
-	void	ServerSendQueuePushEnd(uchar** data, int32 size);
-	void	ServerSendQueuePushFront(uchar* data, int32 size);
+	void	ServerSendQueuePushEnd(EQEmu::PacketBuffer* buffer, int32 size);	//queues a reference of its own
+	bool	ServerSendQueueEmpty();
+	void	ServerSendQueueClear();
 
 private:
 	void FinishDisconnect();
+	void ServerSendQueuePush(EQEmu::PacketBuffer* buffer, int32 size);	//takes over the caller's reference
+	void BatchAppend(const uchar* data, int32 size);	//MBatch held
+	bool BatchFlush();	//MBatch held, true if the reactor has to be woken
 };
 
 
@@ -0,0 +1,195 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEmu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "global_define.h"
+#include "tcp_reactor.h"
+#include "eqemu_logsys.h"
+#include <chrono>
+#include <string.h>
+
+#ifdef _WINDOWS
+	#include <process.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+#ifdef __linux__
+	#include <sys/epoll.h>
+	#include <sys/eventfd.h>
+#endif
+
+namespace EQEmu {
+
+	const uint32 TCPReactor::TickMS;
+	const uint32 TCPReactor::LoopGranularity;
+
+	TCPReactor &TCPReactor::Get() {
+		// never destroyed, the thread runs until the process exits
+		static TCPReactor *reactor = new TCPReactor();
+		return *reactor;
+	}
+
+	TCPReactor::TCPReactor() : pass_(0) {
+#ifdef __linux__
+		poll_fd_ = epoll_create(64);
+		signal_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		struct epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.ptr = nullptr;
+		if (poll_fd_ == -1 || signal_fd_ == -1 || epoll_ctl(poll_fd_, EPOLL_CTL_ADD, signal_fd_, &ev) != 0) {
+			Log.Out(Logs::General, Logs::Error, "TCP reactor could not set up epoll: %s", strerror(errno));
+		}
+#endif
+
+#ifdef _WINDOWS
+		_beginthread(Loop, 0, this);
+#else
+		pthread_t thread;
+		pthread_create(&thread, nullptr, Loop, this);
+		pthread_detach(thread);
+#endif
+	}
+
+	void TCPReactor::Attach(Handler *h) {
+		LockMutex lock(&MService);
+		attached_.insert(h);
+		h->reactor_wake_ = false;
+		Wake(h);
+	}
+
+	void TCPReactor::Detach(Handler *h) {
+		LockMutex lock(&MService);
+		attached_.erase(h);
+	}
+
+	void TCPReactor::Wake(Handler *h) {
+		if (h->reactor_wake_.exchange(true))
+			return;
+
+		// only the first wake since the reactor last looked has to reach the kernel
+		if (!wakes_.Push(h))
+			return;
+
+#ifdef __linux__
+		uint64 one = 1;
+		ssize_t ret = write(signal_fd_, &one, sizeof(one));
+		(void)ret;
+#else
+		waiter_.Signal();
+#endif
+	}
+
+	bool TCPReactor::Watch(Handler *h, SOCKET sock) {
+#ifdef __linux__
+		struct epoll_event ev;
+		ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+		ev.data.ptr = h;
+		if (epoll_ctl(poll_fd_, EPOLL_CTL_ADD, sock, &ev) == 0)
+			return true;
+		if (errno == EEXIST)
+			return epoll_ctl(poll_fd_, EPOLL_CTL_MOD, sock, &ev) == 0;
+		return false;
+#else
+		return true;
+#endif
+	}
+
+	void TCPReactor::Unwatch(SOCKET sock) {
+#ifdef __linux__
+		struct epoll_event ev;
+		epoll_ctl(poll_fd_, EPOLL_CTL_DEL, sock, &ev);
+#endif
+	}
+
+	ThreadReturnType TCPReactor::Loop(void *tmp) {
+#ifdef _WINDOWS
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+#endif
+		TCPReactor *reactor = (TCPReactor*)tmp;
+#ifndef WIN32
+		Log.Out(Logs::Detail, Logs::TCP_Connection, "Starting TCP reactor with thread ID %lu", (unsigned long)pthread_self());
+#endif
+
+		auto next_tick = std::chrono::steady_clock::now();
+		for (;;) {
+#ifdef __linux__
+			auto now = std::chrono::steady_clock::now();
+			int timeout = 0;
+			if (next_tick > now)
+				timeout = (int)std::chrono::duration_cast<std::chrono::milliseconds>(next_tick - now).count() + 1;
+
+			struct epoll_event events[64];
+			int count = epoll_wait(reactor->poll_fd_, events, 64, timeout);
+
+			LockMutex lock(&reactor->MService);
+			reactor->ready_.clear();
+			for (int i = 0; i < count; ++i) {
+				Handler *h = (Handler*)events[i].data.ptr;
+				if (h) {
+					reactor->ready_.push_back(h);
+				}
+				else {
+					uint64 signals;
+					ssize_t ret = read(reactor->signal_fd_, &signals, sizeof(signals));
+					(void)ret;
+				}
+			}
+#else
+			reactor->waiter_.Wait(LoopGranularity);
+
+			// no readiness here, every handler gets a look each pass
+			LockMutex lock(&reactor->MService);
+			reactor->ready_.assign(reactor->attached_.begin(), reactor->attached_.end());
+#endif
+
+			bool tick = std::chrono::steady_clock::now() >= next_tick;
+			if (tick)
+				next_tick = std::chrono::steady_clock::now() + std::chrono::milliseconds(TickMS);
+
+			reactor->Service(tick);
+		}
+
+		THREAD_RETURN(nullptr);
+	}
+
+	void TCPReactor::Service(bool tick) {
+		Handler *h;
+		while (wakes_.Pop(h))
+			ready_.push_back(h);
+
+		if (tick)
+			ready_.insert(ready_.end(), attached_.begin(), attached_.end());
+
+		// a handler can show up more than once per pass, or be detached (even deleted) by an earlier
+		// one, so only pointers still attached are touched
+		++pass_;
+		for (size_t i = 0; i < ready_.size(); ++i) {
+			h = ready_[i];
+			if (!attached_.count(h) || h->reactor_pass_ == pass_)
+				continue;
+
+			h->reactor_pass_ = pass_;
+			h->reactor_wake_ = false;
+			if (!h->ReactorService())
+				attached_.erase(h);
+		}
+	}
+
+} // EQEmu
@@ -0,0 +1,104 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEmu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_TCP_REACTOR_H
+#define _EQEMU_TCP_REACTOR_H
+
+#include "types.h"
+#include "mutex.h"
+#include "handoff_queue.h"
+#include "event_waiter.h"
+#include <atomic>
+#include <unordered_set>
+#include <vector>
+
+namespace EQEmu {
+
+	//! The one thread that does socket work for every ServerTalk listener and connection in the process
+	/*!
+		BaseTCPServer and TCPConnection used to each run their own thread that slept a few ms between
+		polls of their socket. Now they are handlers of this reactor instead. On Linux their sockets sit
+		in an edge triggered epoll set, so a handler is serviced as soon as its socket has something, and
+		other threads call Wake() after queueing work for it (a send, a disconnect). Every handler is
+		also serviced each TickMS for keepalives, timeouts and cleanup.
+
+		Other platforms have no epoll here, the reactor services every handler each LoopGranularity ms
+		like the old threads did, but from one thread.
+
+		Handlers are serviced one at a time with the service lock held, Detach takes the same lock so
+		once it returns the handler is never called again.
+	*/
+	class TCPReactor {
+	public:
+		class Handler {
+		public:
+			Handler() : reactor_wake_(false), reactor_pass_(0) { }
+			virtual ~Handler() { }
+
+			//! Runs on the reactor thread when the socket is ready, after Wake() and every TickMS. Return false to be detached.
+			virtual bool ReactorService() = 0;
+		private:
+			friend class TCPReactor;
+			std::atomic<bool> reactor_wake_;
+			uint32 reactor_pass_;
+		};
+
+		//! The process wide reactor, its thread is started the first time this is called.
+		static TCPReactor &Get();
+
+		//! Starts servicing h.
+		void Attach(Handler *h);
+
+		//! Stops servicing h, waits for a service call in progress on another thread to finish.
+		void Detach(Handler *h);
+
+		//! Services h soon, from any thread. Wakes that come in before it runs are folded into one.
+		void Wake(Handler *h);
+
+		//! Services h whenever sock becomes readable or writable; sock must be non-blocking.
+		bool Watch(Handler *h, SOCKET sock);
+
+		//! Must be called before closing a watched socket.
+		void Unwatch(SOCKET sock);
+
+		static const uint32 TickMS = 50;
+		static const uint32 LoopGranularity = 3;
+	private:
+		TCPReactor();
+		TCPReactor(const TCPReactor&);
+		const TCPReactor& operator=(const TCPReactor&);
+
+		static ThreadReturnType Loop(void *tmp);
+		void Service(bool tick);
+
+		Mutex MService;
+		std::unordered_set<Handler*> attached_;
+		std::vector<Handler*> ready_;
+		HandoffQueue<Handler*> wakes_;
+		uint32 pass_;
+#ifdef __linux__
+		int poll_fd_;
+		int signal_fd_;
+#else
+		EventWaiter waiter_;
+#endif
+	};
+
+} // EQEmu
+
+#endif
@@ -18,19 +18,10 @@
 	#define SOCKET_ERROR -1
 #endif
 
-#define SERVER_LOOP_GRANULARITY 3	//# of ms between checking our socket/queues
-
 BaseTCPServer::BaseTCPServer(uint16 in_port) {
 	NextID = 1;
 	pPort = in_port;
 	sock = 0;
-	pRunLoop = true;
-#ifdef _WINDOWS
-	_beginthread(BaseTCPServer::TCPServerLoop, 0, this);
-#else
-	pthread_t thread;
-	pthread_create(&thread, nullptr, &BaseTCPServer::TCPServerLoop, this);
-#endif
 }
 
 BaseTCPServer::~BaseTCPServer() {
@@ -38,51 +29,12 @@ BaseTCPServer::~BaseTCPServer() {
 }
 
 void BaseTCPServer::StopLoopAndWait() {
-	MRunLoop.lock();
-	if(pRunLoop) {
-		pRunLoop = false;
-		MRunLoop.unlock();
-		//wait for loop to stop.
-		MLoopRunning.lock();
-		MLoopRunning.unlock();
-	} else {
-		MRunLoop.unlock();
-	}
+	EQEmu::TCPReactor::Get().Detach(this);
 }
 
-bool BaseTCPServer::RunLoop() {
-	bool ret;
-	MRunLoop.lock();
-	ret = pRunLoop;
-	MRunLoop.unlock();
-	return ret;
-}
-
-ThreadReturnType BaseTCPServer::TCPServerLoop(void* tmp) {
-#ifdef _WINDOWS
-	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
-#endif
-	if (tmp == 0) {
-		THREAD_RETURN(nullptr);
-	}
-	BaseTCPServer* tcps = (BaseTCPServer*) tmp;
-
-#ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Starting TCPServerLoop with thread ID %d", pthread_self());
-#endif
-
-	tcps->MLoopRunning.lock();
-	while (tcps->RunLoop()) {
-		Sleep(SERVER_LOOP_GRANULARITY);
-		tcps->Process();
-	}
-	tcps->MLoopRunning.unlock();
-
-#ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Ending TCPServerLoop with thread ID %d", pthread_self());
-#endif
-
-	THREAD_RETURN(nullptr);
+bool BaseTCPServer::ReactorService() {
+	Process();
+	return true;
 }
 
 void BaseTCPServer::Process() {
@@ -205,6 +157,8 @@ bool BaseTCPServer::Open(uint16 in_port, char* errbuf) {
 		return false;
 	}
 
+	EQEmu::TCPReactor::Get().Watch(this, sock);
+	EQEmu::TCPReactor::Get().Attach(this);
 	return true;
 }
 
@@ -213,6 +167,7 @@ void BaseTCPServer::Close() {
 
 	LockMutex lock(&MSock);
 	if (sock) {
+		EQEmu::TCPReactor::Get().Unwatch(sock);
 #ifdef _WINDOWS
 		closesocket(sock);
 #else
@@ -3,13 +3,15 @@
 
 #include "types.h"
 #include "mutex.h"
+#include "tcp_reactor.h"
 #include <vector>
 #include <queue>
 
 #define TCPServer_ErrorBufferSize	1024
 
 //this is the non-connection type specific server.
-class BaseTCPServer {
+//Once open, the listening socket is serviced by the reactor; each connection is serviced on its own.
+class BaseTCPServer : public EQEmu::TCPReactor::Handler {
 public:
 	BaseTCPServer(uint16 iPort = 0);
 	virtual ~BaseTCPServer();
@@ -21,25 +23,21 @@ public:
 	inline uint32	GetNextID() { return NextID++; }
 
 protected:
-	static ThreadReturnType TCPServerLoop(void* tmp);
+	virtual bool ReactorService();
 
 	//factory method:
 	virtual void CreateNewConnection(uint32 ID, SOCKET in_socket, uint32 irIP, uint16 irPort) = 0;
 
 
 	virtual void	Process();
-	bool	RunLoop();
-	Mutex	MLoopRunning;
 
+	//stops the reactor servicing us, waits for a service call in progress
 	void StopLoopAndWait();
 
 	void	ListenNewConnections();
 
 	uint32	NextID;
 
-	Mutex	MRunLoop;
-	bool	pRunLoop;
-
 	Mutex	MSock;
 	SOCKET	sock;
 	uint16	pPort;
@@ -66,6 +64,7 @@ public:
 		cur = m_list.begin();
 		end = m_list.end();
 		for(; cur != end; ++cur) {
+			(*cur)->ReactorDetach();
 			delete *cur;
 		}
 	}
@@ -82,6 +81,7 @@ public:
 	}
 
 protected:
+	//connections do their own socket work, this only accepts new ones and deletes freed ones
 	virtual void Process() {
 		BaseTCPServer::Process();
 
@@ -96,8 +96,6 @@ protected:
 				delete data;
 				cur = m_list.erase(cur);
 			} else {
-				if (!data->Process())
-					data->Disconnect();
 				++cur;
 			}
 		}
@@ -108,6 +106,7 @@ protected:
 		MNewQueue.lock();
 		m_NewQueue.push(con);
 		MNewQueue.unlock();
+		con->ReactorAttach();
 	}
 
 	//queue of new connections, for the app to pull from
@@ -0,0 +1,262 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "timer_wheel.h"
+
+namespace EQEmu {
+
+	static inline void ListInit(TimerWheelLink *head) {
+		head->next_ = head;
+		head->prev_ = head;
+	}
+
+	static inline void ListInsert(TimerWheelLink *head, TimerWheelLink *node) {
+		node->prev_ = head->prev_;
+		node->next_ = head;
+		head->prev_->next_ = node;
+		head->prev_ = node;
+	}
+
+	static inline void ListRemove(TimerWheelLink *node) {
+		node->prev_->next_ = node->next_;
+		node->next_->prev_ = node->prev_;
+		node->next_ = nullptr;
+		node->prev_ = nullptr;
+	}
+
+	// moves every node from one list head to another, leaving the first empty
+	static inline void ListMove(TimerWheelLink *from, TimerWheelLink *to) {
+		if (from->next_ == from) {
+			ListInit(to);
+			return;
+		}
+
+		to->next_ = from->next_;
+		to->prev_ = from->prev_;
+		to->next_->prev_ = to;
+		to->prev_->next_ = to;
+		ListInit(from);
+	}
+
+	TimerWheelEntry::TimerWheelEntry()
+		: wheel_(nullptr), expires_(0), due_flag_(nullptr) {
+		next_ = nullptr;
+		prev_ = nullptr;
+	}
+
+	TimerWheelEntry::~TimerWheelEntry() {
+		Cancel();
+	}
+
+	void TimerWheelEntry::Cancel() {
+		if (wheel_)
+			wheel_->Cancel(this);
+	}
+
+	TimerWheel::TimerWheel(uint32 now)
+		: current_tick_(now), count_(0) {
+		for (int i = 0; i < RootSize; ++i)
+			ListInit(&root_[i]);
+
+		for (int level = 0; level < Levels; ++level) {
+			for (int i = 0; i < LevelSize; ++i)
+				ListInit(&levels_[level][i]);
+		}
+	}
+
+	TimerWheel::~TimerWheel() {
+		// let go of anything still scheduled so the entries don't reach back into us later
+		TimerWheelLink *slots[Levels + 1] = { root_, levels_[0], levels_[1], levels_[2], levels_[3] };
+		int sizes[Levels + 1] = { RootSize, LevelSize, LevelSize, LevelSize, LevelSize };
+		for (int level = 0; level <= Levels; ++level) {
+			for (int i = 0; i < sizes[level]; ++i) {
+				TimerWheelLink *head = &slots[level][i];
+				while (head->next_ != head) {
+					TimerWheelEntry *entry = static_cast<TimerWheelEntry*>(head->next_);
+					ListRemove(entry);
+					entry->wheel_ = nullptr;
+				}
+			}
+		}
+	}
+
+	TimerWheelLink *TimerWheel::SlotFor(uint32 expires) {
+		uint32 delta = expires - current_tick_;
+
+		// already due, it goes out with the next tick we process
+		if ((int32)delta < 0)
+			return &root_[current_tick_ & (RootSize - 1)];
+
+		if (delta < RootSize)
+			return &root_[expires & (RootSize - 1)];
+
+		for (int level = 0; level < Levels - 1; ++level) {
+			if (delta < (1u << (RootBits + (level + 1) * LevelBits)))
+				return &levels_[level][(expires >> (RootBits + level * LevelBits)) & (LevelSize - 1)];
+		}
+
+		return &levels_[Levels - 1][(expires >> (RootBits + (Levels - 1) * LevelBits)) & (LevelSize - 1)];
+	}
+
+	void TimerWheel::Schedule(TimerWheelEntry *entry, uint32 expires) {
+		entry->Cancel();
+
+		entry->expires_ = expires;
+		entry->wheel_ = this;
+		ListInsert(SlotFor(expires), entry);
+		++count_;
+	}
+
+	void TimerWheel::Cancel(TimerWheelEntry *entry) {
+		if (entry->wheel_ != this)
+			return;
+
+		ListRemove(entry);
+		entry->wheel_ = nullptr;
+		--count_;
+	}
+
+	uint32 TimerWheel::Cascade(int level, uint32 index) {
+		TimerWheelLink pending;
+		ListMove(&levels_[level][index], &pending);
+
+		// everything in this slot is now close enough to land in a lower level
+		while (pending.next_ != &pending) {
+			TimerWheelEntry *entry = static_cast<TimerWheelEntry*>(pending.next_);
+			ListRemove(entry);
+			ListInsert(SlotFor(entry->expires_), entry);
+		}
+
+		return index;
+	}
+
+	uint32 TimerWheel::Advance(uint32 now) {
+		uint32 expired = 0;
+
+		while ((int32)(now - current_tick_) >= 0) {
+			if (count_ == 0) {
+				// nothing scheduled, no need to walk the empty ticks
+				current_tick_ = now + 1;
+				break;
+			}
+
+			uint32 index = current_tick_ & (RootSize - 1);
+			if (index == 0) {
+				// the root wrapped, pull the next slot of each level down until one of them hasn't wrapped
+				int level = 0;
+				while (level < Levels && Cascade(level, (current_tick_ >> (RootBits + level * LevelBits)) & (LevelSize - 1)) == 0)
+					++level;
+			}
+
+			TimerWheelLink pending;
+			ListMove(&root_[index], &pending);
+
+			// anything scheduled from a callback as already due goes into the next tick
+			++current_tick_;
+
+			while (pending.next_ != &pending) {
+				TimerWheelEntry *entry = static_cast<TimerWheelEntry*>(pending.next_);
+				ListRemove(entry);
+				entry->wheel_ = nullptr;
+				--count_;
+				++expired;
+
+				if (entry->due_flag_)
+					*entry->due_flag_ = true;
+
+				if (entry->callback_)
+					entry->callback_();
+			}
+		}
+
+		return expired;
+	}
+
+	WheelTimer::WheelTimer(TimerWheel *wheel, uint32 timer_time, bool iUseAcurateTiming)
+		: Timer(timer_time, iUseAcurateTiming), wheel_(wheel), due_(false) {
+		entry_.SetDueFlag(&due_);
+		Reschedule();
+	}
+
+	void WheelTimer::Reschedule() {
+		if (!wheel_)
+			return;
+
+		due_ = false;
+		if (!Enabled()) {
+			entry_.Cancel();
+			return;
+		}
+
+		// Timer::Check() goes off once more than the timer's duration has passed
+		wheel_->Schedule(&entry_, GetStartTime() + GetDuration() + 1);
+	}
+
+	bool WheelTimer::Check(bool iReset) {
+		bool ret = Timer::Check(iReset);
+		if (ret && iReset)
+			Reschedule();
+		return ret;
+	}
+
+	bool WheelTimer::CheckDue(bool iReset) {
+		if (!wheel_)
+			return Check(iReset);
+
+		if (!due_)
+			return false;
+
+		if (Check(iReset))
+			return true;
+
+		// woke up before the timer ran out, the start time was changed behind our back
+		Reschedule();
+		return false;
+	}
+
+	void WheelTimer::Enable() {
+		Timer::Enable();
+		Reschedule();
+	}
+
+	void WheelTimer::Disable() {
+		Timer::Disable();
+		entry_.Cancel();
+	}
+
+	void WheelTimer::Start(uint32 set_timer_time, bool ChangeResetTimer) {
+		Timer::Start(set_timer_time, ChangeResetTimer);
+		Reschedule();
+	}
+
+	void WheelTimer::SetTimer(uint32 set_timer_time) {
+		Timer::SetTimer(set_timer_time);
+		Reschedule();
+	}
+
+	void WheelTimer::Trigger() {
+		Timer::Trigger();
+		Reschedule();
+	}
+
+	void WheelTimer::SetAtTrigger(uint32 set_at_trigger, bool iEnableIfDisabled, bool ChangeTimerTime) {
+		Timer::SetAtTrigger(set_at_trigger, iEnableIfDisabled, ChangeTimerTime);
+		Reschedule();
+	}
+
+} // EQEmu
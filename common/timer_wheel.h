@@ -0,0 +1,160 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_TIMER_WHEEL_H
+#define _EQEMU_TIMER_WHEEL_H
+
+#include "types.h"
+#include "timer.h"
+#include <functional>
+
+namespace EQEmu {
+
+	class TimerWheel;
+
+	//! Links of the circular lists the wheel keeps in each slot
+	struct TimerWheelLink {
+		TimerWheelLink *next_;
+		TimerWheelLink *prev_;
+	};
+
+	//! Something scheduled on a TimerWheel
+	/*!
+		Entries are intrusive: the owner embeds one and the wheel only links it into its slots, so
+		scheduling never allocates. When the entry expires the wheel sets the due flag and/or calls the
+		callback, whichever were given. An entry unschedules itself when destroyed. Non-copyable.
+	*/
+	class TimerWheelEntry : private TimerWheelLink {
+	public:
+		TimerWheelEntry();
+		~TimerWheelEntry();
+
+		//! Called when the entry expires, the entry is already unscheduled at that point.
+		void SetCallback(std::function<void()> cb) { callback_ = cb; }
+
+		//! Set to true when the entry expires; the owner clears it when it handles it.
+		void SetDueFlag(bool *flag) { due_flag_ = flag; }
+
+		inline bool Scheduled() const { return wheel_ != nullptr; }
+		inline uint32 Expires() const { return expires_; }
+
+		//! Removes the entry from whatever wheel it is on.
+		void Cancel();
+	private:
+		friend class TimerWheel;
+		TimerWheelEntry(const TimerWheelEntry&);
+		const TimerWheelEntry& operator=(const TimerWheelEntry&);
+
+		TimerWheel *wheel_;
+		uint32 expires_;
+		bool *due_flag_;
+		std::function<void()> callback_;
+	};
+
+	//! Hierarchical timing wheel
+	/*!
+		Schedules entries on millisecond ticks of Timer::GetCurrentTime(). The first level has a slot
+		per tick for the next 256ms, every further level covers 64 slots of the level below it, so the
+		five levels cover the whole 32 bit clock. Scheduling and cancelling are O(1) and advancing only
+		touches the slots that come due plus, every 256 ticks, one slot of a higher level whose entries
+		get moved down.
+
+		Instead of calling Timer::Check() on every timer every loop, owners schedule an entry for when
+		their timer runs out and only do work when told about it.
+	*/
+	class TimerWheel {
+	public:
+		//! Constructor
+		/*!
+		\param now The current time, the first tick Advance() will process.
+		*/
+		TimerWheel(uint32 now = 0);
+		~TimerWheel();
+
+		//! Schedules (or moves) an entry to expire at the given time; times in the past expire on the next Advance().
+		void Schedule(TimerWheelEntry *entry, uint32 expires);
+
+		//! Removes an entry, does nothing if it isn't scheduled here.
+		void Cancel(TimerWheelEntry *entry);
+
+		//! Expires everything due up to and including now, returns how many entries expired.
+		uint32 Advance(uint32 now);
+
+		inline uint32 Size() const { return count_; }
+		inline uint32 CurrentTick() const { return current_tick_; }
+	private:
+		TimerWheel(const TimerWheel&);
+		const TimerWheel& operator=(const TimerWheel&);
+
+		TimerWheelLink *SlotFor(uint32 expires);
+		uint32 Cascade(int level, uint32 index);
+
+		enum {
+			RootBits = 8,
+			LevelBits = 6,
+			RootSize = 1 << RootBits,
+			LevelSize = 1 << LevelBits,
+			Levels = 4
+		};
+
+		// each slot is the head of a circular list of entries
+		TimerWheelLink root_[RootSize];
+		TimerWheelLink levels_[Levels][LevelSize];
+		uint32 current_tick_;
+		uint32 count_;
+	};
+
+	//! A Timer that keeps an entry on a TimerWheel in step with it
+	/*!
+		Works exactly like Timer, Check() still does the resetting, but every time the timer is
+		started, triggered, reset or disabled the wheel entry is moved so the callback or due flag
+		fires once when the timer runs out. Owners can stop polling Check() until then, CheckDue()
+		does that for them by only looking at the timer once the wheel says it is due.
+
+		The Timer methods it overrides aren't virtual, so it has to be used through a WheelTimer and
+		not a Timer pointer or reference or the wheel won't hear about restarts.
+	*/
+	class WheelTimer : public Timer {
+	public:
+		WheelTimer(TimerWheel *wheel, uint32 timer_time, bool iUseAcurateTiming = false);
+
+		inline TimerWheelEntry &Entry() { return entry_; }
+
+		bool Check(bool iReset = true);
+
+		//! Same as Check(), but cheap when the timer isn't due. Falls back to Check() without a wheel.
+		bool CheckDue(bool iReset = true);
+		inline bool Due() const { return due_; }
+
+		void Enable();
+		void Disable();
+		void Start(uint32 set_timer_time = 0, bool ChangeResetTimer = true);
+		void SetTimer(uint32 set_timer_time = 0);
+		void Trigger();
+		void SetAtTrigger(uint32 set_at_trigger, bool iEnableIfDisabled = false, bool ChangeTimerTime = false);
+	private:
+		void Reschedule();
+
+		TimerWheel *wheel_;
+		TimerWheelEntry entry_;
+		bool due_;
+	};
+
+} // EQEmu
+
+#endif
@@ -0,0 +1,199 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "global_define.h"
+#include "worker_pool.h"
+
+#ifdef _WINDOWS
+#include <process.h>
+#else
+#include <pthread.h>
+#include "unix.h"
+#endif
+
+namespace EQEmu {
+
+	WorkerPool::WorkerPool()
+		: running(false), threads_running(0), next_worker(0), pending(0), wakeup(nullptr) {
+	}
+
+	WorkerPool::~WorkerPool() {
+		Stop();
+	}
+
+	void WorkerPool::Start(int count, Work init, Work shutdown) {
+		if (!workers.empty())
+			return;
+
+		thread_init = init;
+		thread_shutdown = shutdown;
+		running = true;
+
+		for (int i = 0; i < count; ++i) {
+			Worker *w = new Worker;
+			w->pool = this;
+			w->index = i;
+			workers.push_back(w);
+		}
+
+		for (auto w : workers) {
+			threads_running++;
+#ifdef _WINDOWS
+			_beginthread(WorkerLoop, 0, w);
+#else
+			pthread_t thread;
+			pthread_create(&thread, nullptr, WorkerLoop, w);
+			pthread_detach(thread);
+#endif
+		}
+	}
+
+	void WorkerPool::Stop() {
+		if (workers.empty())
+			return;
+
+		running = false;
+		for (auto w : workers)
+			w->work_ready.Signal();
+
+		// the workers drain their queues before they exit
+		while (threads_running > 0)
+			Sleep(1);
+
+		for (auto w : workers)
+			delete w;
+		workers.clear();
+
+		Process();
+	}
+
+	ThreadReturnType WorkerPool::WorkerLoop(void *arg) {
+		Worker *w = (Worker*)arg;
+		w->pool->RunWorker(w);
+		w->pool->threads_running--;
+		THREAD_RETURN(nullptr);
+	}
+
+	void WorkerPool::RunWorker(Worker *w) {
+		if (thread_init)
+			thread_init(w->index);
+
+		for (;;) {
+			w->lock.lock();
+			if (w->queue.empty()) {
+				w->lock.unlock();
+				if (!running)
+					break;
+
+				w->work_ready.Wait(1000);
+				continue;
+			}
+
+			Job job = std::move(w->queue.front());
+			w->queue.pop_front();
+			w->lock.unlock();
+
+			job.work(w->index);
+
+			MCompleted.lock();
+			completed.push_back(std::move(job));
+			MCompleted.unlock();
+
+			if (wakeup)
+				wakeup->Signal();
+		}
+
+		if (thread_shutdown)
+			thread_shutdown(w->index);
+	}
+
+	void WorkerPool::Queue(uint32 key, Work work, Completion done) {
+		if (workers.empty()) {
+			work(-1);
+			if (done)
+				done();
+			return;
+		}
+
+		MCompleted.lock();
+		pending++;
+		if (key != 0)
+			pending_by_key[key]++;
+		MCompleted.unlock();
+
+		Worker *w;
+		if (key != 0)
+			w = workers[key % workers.size()];
+		else
+			w = workers[next_worker++ % workers.size()];
+
+		Job job;
+		job.key = key;
+		job.work = work;
+		job.done = done;
+
+		w->lock.lock();
+		w->queue.push_back(std::move(job));
+		w->lock.unlock();
+		w->work_ready.Signal();
+	}
+
+	uint32 WorkerPool::Process() {
+		std::deque<Job> ready;
+		MCompleted.lock();
+		ready.swap(completed);
+		MCompleted.unlock();
+
+		for (auto &job : ready) {
+			if (job.done)
+				job.done();
+
+			MCompleted.lock();
+			pending--;
+			if (job.key != 0) {
+				auto iter = pending_by_key.find(job.key);
+				if (iter != pending_by_key.end() && --iter->second == 0)
+					pending_by_key.erase(iter);
+			}
+			MCompleted.unlock();
+		}
+
+		return (uint32)ready.size();
+	}
+
+	uint32 WorkerPool::GetPending() {
+		LockMutex lock(&MCompleted);
+		return pending;
+	}
+
+	void WorkerPool::Flush(uint32 key) {
+		for (;;) {
+			Process();
+
+			MCompleted.lock();
+			bool done = key == 0 ? pending == 0 : pending_by_key.find(key) == pending_by_key.end();
+			MCompleted.unlock();
+
+			if (done)
+				return;
+
+			Sleep(1);
+		}
+	}
+
+} // EQEmu
@@ -0,0 +1,105 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_WORKER_POOL_H
+#define _EQEMU_WORKER_POOL_H
+
+#include "types.h"
+#include "mutex.h"
+#include "event_waiter.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace EQEmu {
+
+	//! Runs work on a set of threads and hands the completions back to the owning thread
+	/*!
+		Work runs on a worker thread and gets that worker's index, so callers can keep a resource
+		(a database connection) per worker. The matching completion runs on the owner thread from
+		Process(). Work queued with the same non zero key always goes to the same worker and runs in
+		the order it was queued; key 0 work is spread round robin.
+	*/
+	class WorkerPool {
+	public:
+		typedef std::function<void(int)> Work;
+		typedef std::function<void()> Completion;
+
+		WorkerPool();
+		~WorkerPool();
+
+		//! Starts count threads, init and shutdown (optional) run on each thread with its index.
+		void Start(int count, Work init = nullptr, Work shutdown = nullptr);
+
+		//! Finishes the queued work, then stops and waits for the threads.
+		void Stop();
+
+		//! Queues work; with no threads running it and its completion run right away on the caller.
+		void Queue(uint32 key, Work work, Completion done = nullptr);
+
+		//! Runs the completions of finished work, call from the owner thread. Returns how many ran.
+		uint32 Process();
+
+		//! Blocks until all work with this key (or all work, for key 0) is done and its completions ran.
+		void Flush(uint32 key = 0);
+
+		//! Signaled when finished work is waiting for Process().
+		void SetWakeup(EventWaiter *waiter) { wakeup = waiter; }
+
+		int GetWorkerCount() const { return (int)workers.size(); }
+		uint32 GetPending();
+	private:
+		struct Job {
+			uint32 key;
+			Work work;
+			Completion done;
+		};
+
+		struct Worker {
+			WorkerPool *pool;
+			int index;
+			EventWaiter work_ready;
+			Mutex lock;
+			std::deque<Job> queue;
+		};
+
+		static ThreadReturnType WorkerLoop(void *arg);
+		void RunWorker(Worker *w);
+
+		WorkerPool(const WorkerPool&);
+		const WorkerPool& operator=(const WorkerPool&);
+
+		std::vector<Worker*> workers;
+		Work thread_init;
+		Work thread_shutdown;
+		std::atomic<bool> running;
+		std::atomic<int> threads_running;
+		uint32 next_worker;
+
+		Mutex MCompleted;
+		std::deque<Job> completed;
+		std::map<uint32, uint32> pending_by_key;	// queued or running, by key; guarded by MCompleted
+		uint32 pending;
+		EventWaiter *wakeup;
+	};
+
+} // EQEmu
+
+#endif
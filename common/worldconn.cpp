@@ -29,6 +29,7 @@ WorldConnection::WorldConnection(EmuTCPConnection::ePacketMode mode, const char
 : m_password(password)
 {
 	tcpc.SetPacketMode(mode);
+	tcpc.SetBatching(true);
 	pTryReconnect = true;
 	pConnected = false;
 }
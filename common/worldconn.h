@@ -44,6 +44,7 @@ public:
 	void	AsyncConnect();
 	void	Disconnect();
 	inline bool		TryReconnect() const { return pTryReconnect; }
+	void	SetWakeup(EQEmu::EventWaiter *waiter) { tcpc.SetWakeup(waiter); }
 
 protected:
 	virtual void OnConnected();
@@ -0,0 +1,204 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "zone_content_pack.h"
+#include "eqemu_exception.h"
+#include "string_util.h"
+#include <algorithm>
+#include <string.h>
+
+namespace EQEmu {
+
+	static const uint32 PackMagic = 0x4B50435AU; // "ZCPK"
+
+	static const uint32 RowSize[ZoneContentPack::SectionCount] = {
+		sizeof(ZoneContentPack::Spawn2Row),
+		sizeof(ZoneContentPack::SpawnGroupRow),
+		sizeof(ZoneContentPack::SpawnEntryRow),
+		sizeof(ZoneContentPack::GridRow),
+		sizeof(ZoneContentPack::GridEntryRow),
+		sizeof(ZoneContentPack::DoorRow)
+	};
+
+	static uint32 Align(uint32 v) {
+		return (v + 7) & ~7U;
+	}
+
+	static void SectionCounts(const ZoneContentPack::Content &content, uint32 *count) {
+		count[ZoneContentPack::SectionSpawn2] = (uint32)content.spawn2.size();
+		count[ZoneContentPack::SectionSpawnGroups] = (uint32)content.spawn_groups.size();
+		count[ZoneContentPack::SectionSpawnEntries] = (uint32)content.spawn_entries.size();
+		count[ZoneContentPack::SectionGrids] = (uint32)content.grids.size();
+		count[ZoneContentPack::SectionGridEntries] = (uint32)content.grid_entries.size();
+		count[ZoneContentPack::SectionDoors] = (uint32)content.doors.size();
+	}
+
+	template<typename T>
+	static void WriteSection(uint8 *data, uint32 offset, const std::vector<T> &rows) {
+		if(!rows.empty())
+			memcpy(data + offset, &rows[0], rows.size() * sizeof(T));
+	}
+
+	uint32 ZoneContentPack::EstimatedSize(const Content &content) {
+		uint32 count[SectionCount];
+		SectionCounts(content, count);
+
+		uint32 size = Align(sizeof(Header));
+		for(int i = 0; i < SectionCount; ++i)
+			size += Align(count[i] * RowSize[i]);
+
+		return size;
+	}
+
+	void ZoneContentPack::Write(void *data, uint32 size, Content &content) {
+		if(size < EstimatedSize(content)) {
+			EQ_EXCEPT("Zone Content Pack", "Not enough memory allocated to write pack.");
+		}
+
+		std::sort(content.spawn2.begin(), content.spawn2.end(),
+			[](const Spawn2Row &a, const Spawn2Row &b) { return a.id < b.id; });
+		std::sort(content.spawn_groups.begin(), content.spawn_groups.end(),
+			[](const SpawnGroupRow &a, const SpawnGroupRow &b) { return a.id < b.id; });
+		std::sort(content.spawn_entries.begin(), content.spawn_entries.end(),
+			[](const SpawnEntryRow &a, const SpawnEntryRow &b) {
+				return a.spawngroup_id < b.spawngroup_id || (a.spawngroup_id == b.spawngroup_id && a.npc_id < b.npc_id);
+			});
+		std::sort(content.grids.begin(), content.grids.end(),
+			[](const GridRow &a, const GridRow &b) { return a.id < b.id; });
+		std::sort(content.grid_entries.begin(), content.grid_entries.end(),
+			[](const GridEntryRow &a, const GridEntryRow &b) {
+				return a.grid_id < b.grid_id || (a.grid_id == b.grid_id && a.number < b.number);
+			});
+		std::sort(content.doors.begin(), content.doors.end(),
+			[](const DoorRow &a, const DoorRow &b) { return a.door_id < b.door_id; });
+
+		uint8 *ptr = reinterpret_cast<uint8*>(data);
+		memset(ptr, 0, size);
+
+		Header *header = reinterpret_cast<Header*>(ptr);
+		header->magic = PackMagic;
+		header->format_version = FormatVersion;
+		header->size = size;
+		header->zone_id = content.zone_id;
+		header->version = content.version;
+		header->content_version = content.content_version;
+		SectionCounts(content, header->count);
+
+		uint32 offset = Align(sizeof(Header));
+		for(int i = 0; i < SectionCount; ++i) {
+			header->offset[i] = offset;
+			offset += Align(header->count[i] * RowSize[i]);
+		}
+
+		WriteSection(ptr, header->offset[SectionSpawn2], content.spawn2);
+		WriteSection(ptr, header->offset[SectionSpawnGroups], content.spawn_groups);
+		WriteSection(ptr, header->offset[SectionSpawnEntries], content.spawn_entries);
+		WriteSection(ptr, header->offset[SectionGrids], content.grids);
+		WriteSection(ptr, header->offset[SectionGridEntries], content.grid_entries);
+		WriteSection(ptr, header->offset[SectionDoors], content.doors);
+	}
+
+	std::string ZoneContentPack::FileName(const std::string &zone_name, int32 version) {
+		return StringFormat("shared/zone_content_%s_%d", zone_name.c_str(), version);
+	}
+
+	ZoneContentPack::ZoneContentPack(const void *data, uint32 size) {
+		data_ = reinterpret_cast<const uint8*>(data);
+		header_ = reinterpret_cast<const Header*>(data);
+
+		if(size < sizeof(Header) || header_->magic != PackMagic) {
+			EQ_EXCEPT("Zone Content Pack", "Data is not a zone content pack.");
+		}
+
+		if(header_->format_version != FormatVersion) {
+			EQ_EXCEPT("Zone Content Pack", "Pack was written by a different format version.");
+		}
+
+		if(header_->size > size) {
+			EQ_EXCEPT("Zone Content Pack", "Pack is truncated.");
+		}
+
+		for(int i = 0; i < SectionCount; ++i) {
+			if(header_->offset[i] > header_->size ||
+				(uint64)header_->count[i] * RowSize[i] > header_->size - header_->offset[i]) {
+				EQ_EXCEPT("Zone Content Pack", "Pack section is out of bounds.");
+			}
+		}
+	}
+
+	const ZoneContentPack::Spawn2Row *ZoneContentPack::GetSpawn2(uint32 &count) const {
+		return GetSection<Spawn2Row>(SectionSpawn2, count);
+	}
+
+	const ZoneContentPack::DoorRow *ZoneContentPack::GetDoors(uint32 &count) const {
+		return GetSection<DoorRow>(SectionDoors, count);
+	}
+
+	const ZoneContentPack::SpawnGroupRow *ZoneContentPack::FindSpawnGroup(uint32 id) const {
+		uint32 count;
+		const SpawnGroupRow *begin = GetSection<SpawnGroupRow>(SectionSpawnGroups, count);
+		const SpawnGroupRow *end = begin + count;
+		const SpawnGroupRow *iter = std::lower_bound(begin, end, id,
+			[](const SpawnGroupRow &row, uint32 id) { return row.id < id; });
+
+		if(iter == end || iter->id != id)
+			return nullptr;
+
+		return iter;
+	}
+
+	const ZoneContentPack::GridRow *ZoneContentPack::FindGrid(uint32 id) const {
+		uint32 count;
+		const GridRow *begin = GetSection<GridRow>(SectionGrids, count);
+		const GridRow *end = begin + count;
+		const GridRow *iter = std::lower_bound(begin, end, id,
+			[](const GridRow &row, uint32 id) { return row.id < id; });
+
+		if(iter == end || iter->id != id)
+			return nullptr;
+
+		return iter;
+	}
+
+	const ZoneContentPack::SpawnEntryRow *ZoneContentPack::GetSpawnEntries(uint32 spawngroup_id, uint32 &count) const {
+		uint32 total;
+		const SpawnEntryRow *begin = GetSection<SpawnEntryRow>(SectionSpawnEntries, total);
+		const SpawnEntryRow *end = begin + total;
+		const SpawnEntryRow *first = std::lower_bound(begin, end, spawngroup_id,
+			[](const SpawnEntryRow &row, uint32 id) { return row.spawngroup_id < id; });
+		const SpawnEntryRow *last = std::upper_bound(first, end, spawngroup_id,
+			[](uint32 id, const SpawnEntryRow &row) { return id < row.spawngroup_id; });
+
+		count = (uint32)(last - first);
+		return first;
+	}
+
+	const ZoneContentPack::GridEntryRow *ZoneContentPack::GetGridEntries(uint32 grid_id, uint32 &count) const {
+		uint32 total;
+		const GridEntryRow *begin = GetSection<GridEntryRow>(SectionGridEntries, total);
+		const GridEntryRow *end = begin + total;
+		const GridEntryRow *first = std::lower_bound(begin, end, grid_id,
+			[](const GridEntryRow &row, uint32 id) { return row.grid_id < id; });
+		const GridEntryRow *last = std::upper_bound(first, end, grid_id,
+			[](uint32 id, const GridEntryRow &row) { return id < row.grid_id; });
+
+		count = (uint32)(last - first);
+		return first;
+	}
+
+} // EQEmu
@@ -0,0 +1,207 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef _EQEMU_ZONE_CONTENT_PACK_H
+#define _EQEMU_ZONE_CONTENT_PACK_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+namespace EQEmu {
+
+	//! Static spawn, grid and door content of one zone version
+	/*!
+		The shared memory loader writes one of these per zone version to shared/zone_content_<zone>_<version>
+		and a booting zone maps it instead of running the spawn2, spawngroup, spawnentry, grid, grid_entries
+		and doors queries. Each section is an array sorted by its key so lookups are binary searches straight
+		out of the mapped file.
+
+		The header keeps the zone's content_version row as it was when the pack was written. Triggers on the
+		content tables bump the row of every zone a change touches, so a zone reads its own row back (one single
+		row query) and only uses the pack if it matches, anything else goes back to loading from the database.
+		Edits to one zone leave the packs of every other zone usable.
+	*/
+	class ZoneContentPack {
+	public:
+		enum Section {
+			SectionSpawn2 = 0,
+			SectionSpawnGroups,
+			SectionSpawnEntries,
+			SectionGrids,
+			SectionGridEntries,
+			SectionDoors,
+			SectionCount
+		};
+
+		struct Spawn2Row {
+			uint32 id;
+			uint32 spawngroup_id;
+			float x;
+			float y;
+			float z;
+			float heading;
+			uint32 respawn;
+			uint32 variance;
+			uint32 grid;
+			uint32 condition_id;
+			int32 condition_min_value;
+			uint8 enabled;
+			uint8 animation;
+			uint16 unused;
+		};
+
+		struct SpawnGroupRow {
+			uint32 id;
+			char name[64];
+			int32 spawn_limit;
+			float dist;
+			float max_x;
+			float min_x;
+			float max_y;
+			float min_y;
+			int32 delay;
+			int32 despawn;
+			uint32 despawn_timer;
+			int32 min_delay;
+		};
+
+		struct SpawnEntryRow {
+			uint32 spawngroup_id;
+			uint32 npc_id;
+			int32 chance;
+			uint32 npc_spawn_limit;
+		};
+
+		struct GridRow {
+			uint32 id;
+			int32 wander_type;
+			int32 pause_type;
+		};
+
+		struct GridEntryRow {
+			uint32 grid_id;
+			uint32 number;
+			float x;
+			float y;
+			float z;
+			int32 pause;
+			float heading;
+		};
+
+		struct DoorRow {
+			uint32 db_id;
+			uint32 door_id;
+			char name[32];
+			float x;
+			float y;
+			float z;
+			float heading;
+			int32 incline;
+			uint32 open_type;
+			uint32 guild_id;
+			uint32 lockpick;
+			uint32 key_item;
+			uint32 no_keyring;
+			uint32 trigger_door;
+			uint32 trigger_type;
+			uint32 door_param;
+			int32 invert_state;
+			uint32 size;
+			char dest_zone[32];
+			uint32 dest_instance_id;
+			float dest_x;
+			float dest_y;
+			float dest_z;
+			float dest_heading;
+			uint32 is_ldon_door;
+			uint32 client_version_mask;
+		};
+
+		//! Everything that goes into a pack, rows may be in any order.
+		struct Content {
+			uint32 zone_id;
+			int32 version;
+			uint32 content_version; //!< the zone's content_version.version read before the rows
+			std::vector<Spawn2Row> spawn2;
+			std::vector<SpawnGroupRow> spawn_groups;
+			std::vector<SpawnEntryRow> spawn_entries;
+			std::vector<GridRow> grids;
+			std::vector<GridEntryRow> grid_entries;
+			std::vector<DoorRow> doors;
+		};
+
+		//! Bump whenever a row struct or the header changes, older packs are then refused.
+		static const uint32 FormatVersion = 3;
+
+		//! Bytes needed to Write content.
+		static uint32 EstimatedSize(const Content &content);
+
+		//! Sorts content and writes it to data, which must hold EstimatedSize(content) bytes.
+		static void Write(void *data, uint32 size, Content &content);
+
+		//! Name of the file the pack for a zone version lives in.
+		static std::string FileName(const std::string &zone_name, int32 version);
+
+		//! Constructor
+		/*!
+			Reads a pack written by Write, throws if it isn't one or was written by a different format version.
+		\param data Raw data
+		\param size Raw data size
+		*/
+		ZoneContentPack(const void *data, uint32 size);
+
+		uint32 GetZoneID() const { return header_->zone_id; }
+		int32 GetVersion() const { return header_->version; }
+		uint32 GetContentVersion() const { return header_->content_version; }
+
+		const Spawn2Row *GetSpawn2(uint32 &count) const;
+		const DoorRow *GetDoors(uint32 &count) const;
+		const SpawnGroupRow *FindSpawnGroup(uint32 id) const;
+		const GridRow *FindGrid(uint32 id) const;
+
+		//! Entries of one spawn group, in npc id order.
+		const SpawnEntryRow *GetSpawnEntries(uint32 spawngroup_id, uint32 &count) const;
+
+		//! Entries of one grid, in waypoint number order.
+		const GridEntryRow *GetGridEntries(uint32 grid_id, uint32 &count) const;
+	private:
+		struct Header {
+			uint32 magic;
+			uint32 format_version;
+			uint32 size;
+			uint32 zone_id;
+			int32 version;
+			uint32 content_version;
+			uint32 offset[SectionCount];
+			uint32 count[SectionCount];
+		};
+
+		template<typename T>
+		const T *GetSection(Section section, uint32 &count) const {
+			count = header_->count[section];
+			return reinterpret_cast<const T*>(data_ + header_->offset[section]);
+		}
+
+		const uint8 *data_;
+		const Header *header_;
+	};
+
+} // EQEmu
+
+#endif
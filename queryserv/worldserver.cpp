@@ -148,7 +148,7 @@ void WorldServer::Process()
 						break;
 					}
 					default:
-						Log.Out(Logs::Detail, Logs::QS_Server, "Received unhandled ServerOP_QueryServGeneric", Type);
+						Log.Out(Logs::Detail, Logs::QS_Server, "Received unhandled ServerOP_QueryServGeneric %u", Type);
 						break;
 				}
 				break;
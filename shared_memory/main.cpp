@@ -27,11 +27,13 @@
 #include "../common/rulesys.h"
 #include "../common/eqemu_exception.h"
 #include "items.h"
+#include "npc_types.h"
 #include "npc_faction.h"
 #include "loot.h"
 #include "skill_caps.h"
 #include "spells.h"
 #include "base_data.h"
+#include "zone_content.h"
 
 EQEmuLogSys Log;
 
@@ -63,11 +65,13 @@ int main(int argc, char **argv) {
 
 	bool load_all = true;
 	bool load_items = false;
+	bool load_npc_types = false;
 	bool load_factions = false;
 	bool load_loot = false;
 	bool load_skill_caps = false;
 	bool load_spells = false;
 	bool load_bd = false;
+	bool load_zone_content = false;
 	if(argc > 1) {
 		load_all = false;
 
@@ -91,6 +95,12 @@ int main(int argc, char **argv) {
 				}
 				break;
 
+			case 'n':
+				if(strcasecmp("npc_types", argv[i]) == 0) {
+					load_npc_types = true;
+				}
+				break;
+
 			case 'f':
 				if(strcasecmp("factions", argv[i]) == 0) {
 					load_factions = true;
@@ -110,6 +120,12 @@ int main(int argc, char **argv) {
 					load_spells = true;
 				}
 				break;
+
+			case 'z':
+				if(strcasecmp("zone_content", argv[i]) == 0) {
+					load_zone_content = true;
+				}
+				break;
 			}
 		}
 	}
@@ -124,6 +140,16 @@ int main(int argc, char **argv) {
 		}
 	}
 
+	if(load_all || load_npc_types) {
+		Log.Out(Logs::General, Logs::Status, "Loading npc types...");
+		try {
+			LoadNPCTypes(&database);
+		} catch(std::exception &ex) {
+			Log.Out(Logs::General, Logs::Error, "%s", ex.what());
+			return 1;
+		}
+	}
+
 	if(load_all || load_factions) {
 		Log.Out(Logs::General, Logs::Status, "Loading factions...");
 		try {
@@ -174,6 +200,16 @@ int main(int argc, char **argv) {
 		}
 	}
 
+	if(load_all || load_zone_content) {
+		Log.Out(Logs::General, Logs::Status, "Loading zone content...");
+		try {
+			LoadZoneContent(&database);
+		} catch(std::exception &ex) {
+			Log.Out(Logs::General, Logs::Error, "%s", ex.what());
+			return 1;
+		}
+	}
+
 	Log.CloseFileLogs();
 
 	return 0;
@@ -0,0 +1,66 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#include "zone_content.h"
+#include "../common/global_define.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/shareddb.h"
+#include "../common/ipc_mutex.h"
+#include "../common/memory_mapped_file.h"
+#include "../common/eqemu_exception.h"
+#include "../common/zone_content_pack.h"
+#include <stdio.h>
+
+void LoadZoneContent(SharedDatabase *database) {
+	EQEmu::IPCMutex mutex("zone_content");
+	mutex.Lock();
+
+	database->LoadZoneNames();
+
+	if(!database->CheckContentVersionTriggers()) {
+		Log.Out(Logs::General, Logs::Error, "The content_version triggers are missing, no content packs were written.");
+		mutex.Unlock();
+		return;
+	}
+
+	std::vector<std::pair<std::string, int32>> zones;
+	if(!database->GetZoneContentVersions(zones)) {
+		EQ_EXCEPT("Shared Memory", "Unable to get the zone content list from the database.");
+	}
+
+	for(auto iter = zones.begin(); iter != zones.end(); ++iter) {
+		EQEmu::ZoneContentPack::Content content;
+		if(!database->LoadZoneContent(iter->first.c_str(), iter->second, content)) {
+			Log.Out(Logs::General, Logs::Error, "Unable to load content for %s version %d, it will load from the database.",
+				iter->first.c_str(), iter->second);
+			continue;
+		}
+
+		// running zones keep their pack mapped, a new file leaves the one they have intact
+		std::string file_name = EQEmu::ZoneContentPack::FileName(iter->first, iter->second);
+		remove(file_name.c_str());
+
+		uint32 size = EQEmu::ZoneContentPack::EstimatedSize(content);
+		EQEmu::MemoryMappedFile mmf(file_name, size);
+		mmf.ZeroFile();
+		EQEmu::ZoneContentPack::Write(mmf.Get(), size, content);
+	}
+
+	Log.Out(Logs::General, Logs::Status, "Wrote content packs for %u zone versions.", (uint32)zones.size());
+	mutex.Unlock();
+}
@@ -0,0 +1,63 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+/*
+	The timed runs of the test suites. Each suite built with benchmark set registers only its
+	benchmarks, which print their numbers to stdout; the tests binary never runs them.
+*/
+
+#include <iostream>
+#include <memory>
+#include "timer_wheel_test.h"
+#include "worker_pool_test.h"
+#include "spdat_classify_test.h"
+#include "log_queue_test.h"
+#include "scope_profiler_test.h"
+#include "server_talk_test.h"
+#include "eq_stream_factory_test.h"
+#include "ucs_chat_load_test.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/timeoutmgr.h"
+
+EQEmuLogSys Log;
+TimeoutManager timeout_manager;
+const SPDat_Spell_Struct* spells = nullptr;
+int32 SPDAT_RECORDS = -1;
+
+int main() {
+	try {
+		// only failed assertions are reported, so the lines the benchmarks print stay readable
+		std::unique_ptr<Test::Output> output(new Test::CompilerOutput(Test::CompilerOutput::GCC, std::cout));
+		Test::Suite benchmarks;
+		benchmarks.add(new TimerWheelTest(true));
+		benchmarks.add(new WorkerPoolTest(true));
+		benchmarks.add(new SpellClassificationTest(true));
+		benchmarks.add(new LogQueueTest(true));
+		benchmarks.add(new ScopeProfilerTest(true));
+		benchmarks.add(new UCSChatLoadTest(true));
+#ifndef _WINDOWS
+		benchmarks.add(new ServerTalkTest(true));
+		benchmarks.add(new EQStreamFactoryTest(true));
+#endif
+		if (!benchmarks.run(*output, true))
+			return 1;
+	} catch(...) {
+		return -1;
+	}
+	return 0;
+}
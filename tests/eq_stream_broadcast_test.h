@@ -0,0 +1,203 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_EQ_STREAM_BROADCAST_H
+#define __EQEMU_TESTS_EQ_STREAM_BROADCAST_H
+
+#include "cppunit/cpptest.h"
+#include "../common/eq_packet.h"
+#include "../common/eq_stream.h"
+#include "../common/eq_stream_proxy.h"
+#include "../common/eq_stream_broadcast.h"
+#include "../common/opcodemgr.h"
+#include "../common/struct_strategy.h"
+#include <vector>
+
+//pads every packet it encodes so we can tell encoded packets apart and counts how often it runs
+class BroadcastTestStrategy : public StructStrategy {
+public:
+	BroadcastTestStrategy(ClientVersion version) : m_version(version) {
+		encoders[OP_ChannelMessage] = Encode;
+	}
+
+	virtual std::string Describe() const { return "Broadcast Test"; }
+	virtual const ClientVersion GetClientVersion() const { return m_version; }
+
+	static void Encode(EQApplicationPacket **p, std::shared_ptr<EQStream> dest, bool ack_req) {
+		EQApplicationPacket *in = *p;
+		*p = nullptr;
+
+		EQApplicationPacket *out = new EQApplicationPacket(in->GetOpcode(), in->size + 16);
+		memcpy(out->pBuffer + 16, in->pBuffer, in->size);
+		delete in;
+
+		encode_calls++;
+		encoded_bytes += out->size;
+		dest->FastQueuePacket(&out, ack_req);
+	}
+
+	static uint32 encode_calls;
+	static uint32 encoded_bytes;
+
+private:
+	ClientVersion m_version;
+};
+
+uint32 BroadcastTestStrategy::encode_calls = 0;
+uint32 BroadcastTestStrategy::encoded_bytes = 0;
+
+class EQStreamBroadcastTest : public Test::Suite {
+	typedef void(EQStreamBroadcastTest::*TestFunction)(void);
+public:
+	EQStreamBroadcastTest() : titanium_(ClientVersion::Titanium), rof2_(ClientVersion::RoF2) {
+		opcodes_ = new EmptyOpcodeManager();
+		TEST_ADD(EQStreamBroadcastTest::EncodeOncePerVersionTest);
+		TEST_ADD(EQStreamBroadcastTest::PerStreamBaselineTest);
+		TEST_ADD(EQStreamBroadcastTest::PlainStreamTest);
+		TEST_ADD(EQStreamBroadcastTest::RaidBroadcastTest);
+		TEST_ADD(EQStreamBroadcastTest::RepeatedSendTest);
+	}
+
+	~EQStreamBroadcastTest() {
+		Reset();
+		delete opcodes_;
+	}
+
+	private:
+	void Reset() {
+		for(size_t i = 0; i < proxies_.size(); ++i)
+			delete proxies_[i];
+		proxies_.clear();
+		streams_.clear();
+		BroadcastTestStrategy::encode_calls = 0;
+		BroadcastTestStrategy::encoded_bytes = 0;
+	}
+
+	EQStreamProxy *MakeClient(const StructStrategy *structs) {
+		std::shared_ptr<EQStream> stream(new EQStream());
+		streams_.push_back(stream);
+		EQStreamProxy *proxy = new EQStreamProxy(stream, structs, &opcodes_);
+		proxies_.push_back(proxy);
+		return proxy;
+	}
+
+	void EncodeOncePerVersionTest() {
+		Reset();
+		EQStreamBroadcast broadcast;
+		for(int i = 0; i < 3; ++i)
+			broadcast.AddStream(MakeClient(&titanium_));
+		for(int i = 0; i < 2; ++i)
+			broadcast.AddStream(MakeClient(&rof2_));
+
+		EQApplicationPacket app(OP_ChannelMessage, 64);
+		broadcast.Send(&app);
+
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encode_calls, 2);
+		TEST_ASSERT_EQUALS(broadcast.GetStats().encodes, 2);
+		TEST_ASSERT_EQUALS(broadcast.GetStats().streams, 5);
+		TEST_ASSERT_EQUALS(broadcast.StreamCount(), 5);
+		for(size_t i = 0; i < streams_.size(); ++i)
+			TEST_ASSERT(streams_[i]->HasOutgoingData());
+	}
+
+	void PerStreamBaselineTest() {
+		Reset();
+		for(int i = 0; i < 3; ++i)
+			MakeClient(&titanium_);
+		for(int i = 0; i < 2; ++i)
+			MakeClient(&rof2_);
+
+		EQApplicationPacket app(OP_ChannelMessage, 64);
+		for(size_t i = 0; i < proxies_.size(); ++i)
+			proxies_[i]->QueuePacket(&app);
+
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encode_calls, 5);
+	}
+
+	void PlainStreamTest() {
+		Reset();
+		std::shared_ptr<EQStream> stream(new EQStream());
+		stream->SetOpcodeManager(&opcodes_);
+
+		EQStreamBroadcast broadcast;
+		broadcast.AddStream(stream.get());
+		broadcast.AddStream(MakeClient(&rof2_));
+
+		EQApplicationPacket app(OP_ChannelMessage, 64);
+		broadcast.Send(&app);
+
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encode_calls, 1);
+		TEST_ASSERT_EQUALS(broadcast.GetStats().streams, 2);
+		TEST_ASSERT(stream->HasOutgoingData());
+
+		broadcast.Clear();
+		TEST_ASSERT_EQUALS(broadcast.StreamCount(), 0);
+	}
+
+	//a 150 client raid zone split across two client versions, compares encodes and
+	//application packet bytes allocated against sending to each client individually.
+	void RaidBroadcastTest() {
+		Reset();
+		EQStreamBroadcast broadcast;
+		for(int i = 0; i < 150; ++i)
+			broadcast.AddStream(MakeClient(i % 3 == 0 ? (const StructStrategy *)&titanium_ : &rof2_));
+
+		EQApplicationPacket app(OP_ChannelMessage, 512);
+		broadcast.Send(&app);
+		uint32 broadcast_encodes = BroadcastTestStrategy::encode_calls;
+		uint32 broadcast_bytes = broadcast.GetStats().bytes_allocated;
+
+		BroadcastTestStrategy::encode_calls = 0;
+		BroadcastTestStrategy::encoded_bytes = 0;
+		for(size_t i = 0; i < proxies_.size(); ++i)
+			proxies_[i]->QueuePacket(&app);
+		uint32 single_bytes = proxies_.size() * app.size + BroadcastTestStrategy::encoded_bytes;
+
+		TEST_ASSERT_EQUALS(broadcast_encodes, 2);
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encode_calls, 150);
+		TEST_ASSERT_EQUALS(broadcast_bytes, 2 * (512 + 528));
+		TEST_ASSERT(broadcast_bytes * 50 < single_bytes);
+	}
+
+	//the capture stream is kept between sends, nothing an earlier send captured may go out again
+	void RepeatedSendTest() {
+		Reset();
+		EQStreamBroadcast broadcast;
+		for(int i = 0; i < 3; ++i)
+			broadcast.AddStream(MakeClient(&titanium_));
+		for(int i = 0; i < 2; ++i)
+			broadcast.AddStream(MakeClient(&rof2_));
+
+		EQApplicationPacket app(OP_ChannelMessage, 64);
+		broadcast.Send(&app);
+		broadcast.Send(&app);
+
+		TEST_ASSERT_EQUALS(BroadcastTestStrategy::encode_calls, 4);
+		TEST_ASSERT_EQUALS(broadcast.GetStats().encodes, 4);
+		TEST_ASSERT_EQUALS(broadcast.GetStats().streams, 10);
+		TEST_ASSERT_EQUALS(broadcast.GetStats().bytes_allocated, 2 * 2 * (64 + 80));
+	}
+
+	OpcodeManager *opcodes_;
+	BroadcastTestStrategy titanium_;
+	BroadcastTestStrategy rof2_;
+	std::vector<std::shared_ptr<EQStream>> streams_;
+	std::vector<EQStreamProxy *> proxies_;
+};
+
+#endif
@@ -0,0 +1,225 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_EQ_STREAM_FACTORY_H
+#define __EQEMU_TESTS_EQ_STREAM_FACTORY_H
+
+#include "cppunit/cpptest.h"
+#include "../common/eq_stream_factory.h"
+#include "../common/op_codes.h"
+#include "../common/timer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifndef _WINDOWS
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+//Loopback load generator for EQStreamFactory: a set of fake clients open sessions and then
+//ping the server with keep alives, the factory echoes those back through its reader and writer.
+class EQStreamFactoryTest : public Test::Suite {
+	typedef void(EQStreamFactoryTest::*TestFunction)(void);
+public:
+	explicit EQStreamFactoryTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(EQStreamFactoryTest::Benchmark);
+			return;
+		}
+		TEST_ADD(EQStreamFactoryTest::SessionsAcrossShards);
+		TEST_ADD(EQStreamFactoryTest::PortInUse);
+		TEST_ADD(EQStreamFactoryTest::LoopbackLoad);
+	}
+
+	~EQStreamFactoryTest() {
+	}
+
+private:
+	struct LoadClient {
+		int fd;
+		std::chrono::steady_clock::time_point sent;
+	};
+
+	struct LoadStats {
+		bool opened;
+		uint32 lost;
+		std::vector<double> latencies;
+		double elapsed;
+	};
+
+	void SessionsAcrossShards() {
+		EQStreamFactory factory(ZoneStream, 0);
+		factory.SetReaderThreads(2);
+		TEST_ASSERT(factory.Open());
+		TEST_ASSERT(factory.GetPort() != 0);
+
+		std::vector<LoadClient> clients;
+		TEST_ASSERT(OpenClients(clients, 64, factory.GetPort()));
+
+		uint32 popped = 0;
+		for (int i = 0; i < 200 && popped < clients.size(); ++i) {
+			while (factory.Pop())
+				popped++;
+			Sleep(10);
+		}
+
+		TEST_ASSERT_EQUALS(popped, 64);
+		TEST_ASSERT_EQUALS(factory.GetStreamCount(), 64);
+
+		CloseClients(clients);
+		factory.Close();
+	}
+
+	// the port is held with SO_REUSEPORT for the extra readers, that must not let a second server in
+	void PortInUse() {
+		EQStreamFactory first(ZoneStream, 0);
+		first.SetReaderThreads(2);
+		TEST_ASSERT(first.Open());
+
+		EQStreamFactory sharded(ZoneStream, first.GetPort());
+		sharded.SetReaderThreads(2);
+		TEST_ASSERT(!sharded.Open());
+
+		EQStreamFactory single(ZoneStream, first.GetPort());
+		TEST_ASSERT(!single.Open());
+
+		first.Close();
+	}
+
+	LoadStats RunLoopback(int client_count, int rounds) {
+		LoadStats stats;
+		stats.lost = 0;
+		stats.elapsed = 0.0;
+
+		EQStreamFactory factory(ZoneStream, 0);
+		factory.SetReaderThreads(2);
+		stats.opened = factory.Open();
+		if (!stats.opened)
+			return stats;
+
+		std::vector<LoadClient> clients;
+		stats.opened = OpenClients(clients, client_count, factory.GetPort());
+		if (!stats.opened) {
+			CloseClients(clients);
+			factory.Close();
+			return stats;
+		}
+
+		stats.latencies.reserve(client_count * rounds);
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; ++round) {
+			for (auto &c : clients) {
+				unsigned char ping[8] = { 0x00, OP_KeepAlive, 0x00, 0x00, 0x00, (unsigned char)round, 0x00, 0x00 };
+				c.sent = std::chrono::steady_clock::now();
+				send(c.fd, ping, sizeof(ping), 0);
+			}
+
+			for (auto &c : clients) {
+				if (!WaitFor(c.fd, OP_KeepAlive, 1000)) {
+					stats.lost++;
+					continue;
+				}
+				auto took = std::chrono::steady_clock::now() - c.sent;
+				stats.latencies.push_back(std::chrono::duration<double, std::micro>(took).count());
+			}
+		}
+		stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		CloseClients(clients);
+		factory.Close();
+		return stats;
+	}
+
+	void LoopbackLoad() {
+		LoadStats stats = RunLoopback(256, 20);
+		TEST_ASSERT(stats.opened);
+		TEST_ASSERT_EQUALS(stats.lost, 0);
+	}
+
+	void Benchmark() {
+		const int client_count = 256;
+		LoadStats stats = RunLoopback(client_count, 20);
+		TEST_ASSERT(stats.opened);
+		TEST_ASSERT(!stats.latencies.empty());
+		if (stats.latencies.empty())
+			return;
+
+		std::sort(stats.latencies.begin(), stats.latencies.end());
+		double p99 = stats.latencies[stats.latencies.size() * 99 / 100];
+		// every ping is one datagram in and one out
+		double pps = (stats.latencies.size() * 2) / stats.elapsed;
+		std::cout << "EQStreamFactory loopback: " << client_count << " clients, " << stats.latencies.size() << " round trips, "
+			<< stats.lost << " lost, " << (uint32)pps << " packets/sec, p99 latency " << (uint32)p99 << "us" << std::endl;
+	}
+
+	bool OpenClients(std::vector<LoadClient> &clients, int count, int port) {
+		sockaddr_in server;
+		memset(&server, 0, sizeof(server));
+		server.sin_family = AF_INET;
+		server.sin_port = htons(port);
+		server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		for (int i = 0; i < count; ++i) {
+			LoadClient c;
+			c.fd = socket(AF_INET, SOCK_DGRAM, 0);
+			if (c.fd < 0 || connect(c.fd, (sockaddr *)&server, sizeof(server)) < 0)
+				return false;
+			clients.push_back(c);
+
+			unsigned char request[2 + sizeof(SessionRequest)];
+			memset(request, 0, sizeof(request));
+			request[1] = OP_SessionRequest;
+			SessionRequest *r = (SessionRequest *)(request + 2);
+			r->Session = htonl(1000 + i);
+			r->MaxLength = htonl(512);
+			send(c.fd, request, sizeof(request), 0);
+		}
+
+		for (auto &c : clients) {
+			if (!WaitFor(c.fd, OP_SessionResponse, 2000))
+				return false;
+		}
+		return true;
+	}
+
+	void CloseClients(std::vector<LoadClient> &clients) {
+		for (auto &c : clients)
+			close(c.fd);
+		clients.clear();
+	}
+
+	bool WaitFor(int fd, char opcode, int timeout_ms) {
+		unsigned char buffer[2048];
+		pollfd p;
+		p.fd = fd;
+		p.events = POLLIN;
+		while (poll(&p, 1, timeout_ms) > 0) {
+			int length = recv(fd, buffer, sizeof(buffer), 0);
+			if (length >= 2 && buffer[0] == 0x00 && buffer[1] == opcode)
+				return true;
+		}
+		return false;
+	}
+};
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_EVENT_WAITER_H
+#define __EQEMU_TESTS_EVENT_WAITER_H
+
+#include "cppunit/cpptest.h"
+#include "../common/event_waiter.h"
+#include "../common/loop_profiler.h"
+#include <chrono>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+class EventWaiterTest : public Test::Suite {
+	typedef void(EventWaiterTest::*TestFunction)(void);
+public:
+	EventWaiterTest() {
+		TEST_ADD(EventWaiterTest::TimesOut);
+		TEST_ADD(EventWaiterTest::SignalBeforeWait);
+		TEST_ADD(EventWaiterTest::SignalsFold);
+#ifdef __linux__
+		TEST_ADD(EventWaiterTest::DescriptorWakes);
+#endif
+		TEST_ADD(EventWaiterTest::ProfilerPhases);
+	}
+
+	~EventWaiterTest() {
+	}
+
+private:
+	uint32 WaitMS(EQEmu::EventWaiter &waiter, uint32 timeout, bool &woken) {
+		auto start = std::chrono::steady_clock::now();
+		woken = waiter.Wait(timeout);
+		return (uint32)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void TimesOut() {
+		EQEmu::EventWaiter waiter;
+		bool woken = true;
+		uint32 took = WaitMS(waiter, 20, woken);
+		TEST_ASSERT(!woken);
+		TEST_ASSERT(took >= 15);
+	}
+
+	void SignalBeforeWait() {
+		EQEmu::EventWaiter waiter;
+		waiter.Signal();
+		bool woken = false;
+		uint32 took = WaitMS(waiter, 1000, woken);
+		TEST_ASSERT(woken);
+		TEST_ASSERT(took < 500);
+	}
+
+	void SignalsFold() {
+		EQEmu::EventWaiter waiter;
+		for (int i = 0; i < 100; ++i)
+			waiter.Signal();
+
+		bool woken = false;
+		WaitMS(waiter, 1000, woken);
+		TEST_ASSERT(woken);
+
+		//all of them were handled by that one wakeup
+		WaitMS(waiter, 10, woken);
+		TEST_ASSERT(!woken);
+	}
+
+#ifdef __linux__
+	void DescriptorWakes() {
+		EQEmu::EventWaiter waiter;
+		int fds[2];
+		TEST_ASSERT(pipe(fds) == 0);
+		TEST_ASSERT(waiter.AddDescriptor(fds[0]));
+
+		char c = 1;
+		TEST_ASSERT(write(fds[1], &c, 1) == 1);
+		bool woken = false;
+		WaitMS(waiter, 1000, woken);
+		TEST_ASSERT(woken);
+
+		close(fds[0]);
+		close(fds[1]);
+	}
+#endif
+
+	void ProfilerPhases() {
+		static const char *const names[] = { "first", "second" };
+		EQEmu::LoopProfiler profiler(names, 2);
+
+		for (int i = 0; i < 3; ++i) {
+			profiler.Phase(0);
+			profiler.Phase(1);
+			profiler.Wait();
+		}
+		profiler.Phase(0);
+
+		TEST_ASSERT_EQUALS(profiler.GetLoops(), 3);
+		TEST_ASSERT_EQUALS(profiler.GetPhase(0).count, 3);
+		TEST_ASSERT_EQUALS(profiler.GetPhase(1).count, 3);
+		TEST_ASSERT(profiler.Report().find("second") != std::string::npos);
+
+		profiler.Reset();
+		TEST_ASSERT_EQUALS(profiler.GetLoops(), 0);
+		TEST_ASSERT_EQUALS(profiler.GetPhase(0).count, 0);
+	}
+};
+
+#endif
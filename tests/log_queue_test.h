@@ -0,0 +1,322 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_LOG_QUEUE_H
+#define __EQEMU_TESTS_LOG_QUEUE_H
+
+#include "cppunit/cpptest.h"
+#include "../common/log_ring_buffer.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/string_util.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#ifndef _WINDOWS
+#include <unistd.h>
+#endif
+
+extern EQEmuLogSys Log;
+
+class LogQueueTest : public Test::Suite {
+	typedef void(LogQueueTest::*TestFunction)(void);
+public:
+	explicit LogQueueTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(LogQueueTest::Benchmark);
+			return;
+		}
+		TEST_ADD(LogQueueTest::RingOrder);
+		TEST_ADD(LogQueueTest::RingFull);
+		TEST_ADD(LogQueueTest::RingThreaded);
+		TEST_ADD(LogQueueTest::RingGrows);
+		TEST_ADD(LogQueueTest::RingGrowsThreaded);
+		TEST_ADD(LogQueueTest::FileOutput);
+		TEST_ADD(LogQueueTest::ExitedThreads);
+	}
+
+	~LogQueueTest() {
+	}
+
+private:
+	static std::string MakeLine(uint32 n) {
+		// lengths vary so records land on every offset and wrap at different points
+		return StringFormat("line %u ", n) + std::string(n % 97, 'a' + n % 26);
+	}
+
+	void RingOrder() {
+		EQEmu::LogRingBuffer ring(4096);
+		uint32 pushed = 0;
+		uint32 popped = 0;
+		bool in_order = true;
+
+		for (int round = 0; round < 200; ++round) {
+			for (int i = 0; i < 20; ++i) {
+				std::string line = MakeLine(pushed);
+				if (ring.Push(Logs::General, (uint16)(pushed % Logs::MaxCategoryID), pushed, line.c_str(), line.length()))
+					++pushed;
+			}
+
+			ring.Pop([&](const EQEmu::LogRingBuffer::Line &line) {
+				std::string expected = MakeLine(popped);
+				if (line.time != popped || line.log_category != popped % Logs::MaxCategoryID ||
+					std::string(line.text, line.length) != expected)
+					in_order = false;
+				++popped;
+			});
+		}
+
+		TEST_ASSERT(in_order);
+		TEST_ASSERT_EQUALS(popped, pushed);
+		TEST_ASSERT(pushed > 1000);
+	}
+
+	void RingFull() {
+		EQEmu::LogRingBuffer ring(1024);
+		std::string line(100, 'x');
+		uint32 pushed = 0;
+		while (ring.Push(Logs::General, Logs::Netcode, 0, line.c_str(), line.length()))
+			++pushed;
+
+		// 16 byte header + 100 bytes padded to 8
+		TEST_ASSERT_EQUALS(pushed, 1024u / 120u);
+		TEST_ASSERT(!ring.Push(Logs::General, Logs::Netcode, 0, line.c_str(), line.length()));
+		TEST_ASSERT_EQUALS(ring.TakeDropped(), 2u);
+		TEST_ASSERT_EQUALS(ring.TakeDropped(), 0u);
+
+		uint32 popped = ring.Pop([](const EQEmu::LogRingBuffer::Line &line) { });
+		TEST_ASSERT_EQUALS(popped, pushed);
+		TEST_ASSERT(ring.Push(Logs::General, Logs::Netcode, 0, line.c_str(), line.length()));
+
+		// long lines get cut to a quarter of the buffer
+		std::string long_line(5000, 'y');
+		uint32 length = 0;
+		ring.Pop([](const EQEmu::LogRingBuffer::Line &line) { });
+		TEST_ASSERT(ring.Push(Logs::General, Logs::Netcode, 0, long_line.c_str(), long_line.length()));
+		ring.Pop([&](const EQEmu::LogRingBuffer::Line &line) { length = line.length; });
+		TEST_ASSERT_EQUALS(length, 1024u / 4u - 16u);
+	}
+
+	void RingThreaded() {
+		EQEmu::LogRingBuffer ring(16 * 1024);
+		const uint32 count = 50000;
+		uint32 popped = 0;
+		bool in_order = true;
+
+		std::thread producer([&]() {
+			for (uint32 i = 0; i < count; ++i) {
+				std::string line = MakeLine(i);
+				while (!ring.Push(Logs::General, Logs::Netcode, i, line.c_str(), line.length()))
+					std::this_thread::yield();
+			}
+		});
+
+		while (popped < count) {
+			uint32 n = ring.Pop([&](const EQEmu::LogRingBuffer::Line &line) {
+				if (line.time != popped || std::string(line.text, line.length) != MakeLine(popped))
+					in_order = false;
+				++popped;
+			});
+			if (n == 0)
+				std::this_thread::yield();
+		}
+		producer.join();
+
+		TEST_ASSERT(in_order);
+		TEST_ASSERT_EQUALS(popped, count);
+	}
+
+	void RingGrows() {
+		EQEmu::LogRingBuffer ring(8192, 1024);
+		std::string line(100, 'x');
+		TEST_ASSERT_EQUALS(ring.Capacity(), 1024u);
+
+		uint32 pushed = 0;
+		while (ring.Push(Logs::General, Logs::Netcode, pushed, line.c_str(), line.length()))
+			++pushed;
+
+		// 1k, 2k, 4k and 8k blocks, nothing dropped until the last one is full
+		TEST_ASSERT_EQUALS(ring.Capacity(), 8192u);
+		TEST_ASSERT_EQUALS(pushed, 1024u / 120u + 2048u / 120u + 4096u / 120u + 8192u / 120u);
+		TEST_ASSERT_EQUALS(ring.TakeDropped(), 1u);
+
+		uint32 popped = 0;
+		bool in_order = true;
+		ring.Pop([&](const EQEmu::LogRingBuffer::Line &line) {
+			if (line.time != popped++)
+				in_order = false;
+		});
+		TEST_ASSERT(in_order);
+		TEST_ASSERT_EQUALS(popped, pushed);
+
+		// a line too long for the small block gets a block it fits in
+		EQEmu::LogRingBuffer small(64 * 1024, 1024);
+		std::string long_line(5000, 'y');
+		uint32 length = 0;
+		TEST_ASSERT(small.Push(Logs::General, Logs::Netcode, 0, long_line.c_str(), long_line.length()));
+		TEST_ASSERT_EQUALS(small.Capacity(), 8192u);
+		small.Pop([&](const EQEmu::LogRingBuffer::Line &line) { length = line.length; });
+		TEST_ASSERT_EQUALS(length, 5000u);
+	}
+
+	void RingGrowsThreaded() {
+		const uint32 count = 50000;
+		uint32 popped = 0;
+		bool in_order = true;
+
+		// started over a few times so the blocks are swapped while the consumer is reading
+		for (int round = 0; round < 20; ++round) {
+			EQEmu::LogRingBuffer ring(64 * 1024, 1024);
+			uint32 round_popped = 0;
+
+			std::thread producer([&]() {
+				for (uint32 i = 0; i < count / 20; ++i) {
+					std::string line = MakeLine(i);
+					while (!ring.Push(Logs::General, Logs::Netcode, i, line.c_str(), line.length()))
+						std::this_thread::yield();
+				}
+			});
+
+			while (round_popped < count / 20) {
+				uint32 n = ring.Pop([&](const EQEmu::LogRingBuffer::Line &line) {
+					if (line.time != round_popped || std::string(line.text, line.length) != MakeLine(round_popped))
+						in_order = false;
+					++round_popped;
+				});
+				if (n == 0)
+					std::this_thread::yield();
+			}
+			producer.join();
+			popped += round_popped;
+		}
+
+		TEST_ASSERT(in_order);
+		TEST_ASSERT_EQUALS(popped, count);
+	}
+
+	void StartFileLog(uint16 log_category) {
+		memset(Log.log_settings, 0, sizeof(Log.log_settings));
+		Log.log_settings[log_category].log_to_file = Logs::Detail;
+		Log.file_logs_enabled = true;
+		Log.platform_file_name = "log_queue_test";
+		Log.MakeDirectory("logs");
+		Log.StartFileLogs();
+		file_name = StringFormat("logs/log_queue_test_%i.log", getpid());
+	}
+
+	void StopFileLog() {
+		Log.CloseFileLogs();
+		Log.file_logs_enabled = false;
+		memset(Log.log_settings, 0, sizeof(Log.log_settings));
+		remove(file_name.c_str());
+	}
+
+	void FileOutput() {
+		StartFileLog(Logs::Netcode);
+
+		for (int i = 0; i < 500; ++i)
+			Log.Out(Logs::Detail, Logs::Netcode, "packet %d of %s", i, "500");
+		Log.Out(Logs::Detail, Logs::Spells, "not enabled");
+		Log.Flush();
+
+		std::ifstream in(file_name.c_str());
+		std::string line;
+		int lines = 0;
+		bool formatted = true;
+		while (std::getline(in, line)) {
+			std::string expected = StringFormat("[Netcode] packet %d of 500", lines);
+			if (line.length() < expected.length() || line.compare(line.length() - expected.length(), expected.length(), expected) != 0)
+				formatted = false;
+			++lines;
+		}
+		in.close();
+
+		StopFileLog();
+		TEST_ASSERT_EQUALS(lines, 500);
+		TEST_ASSERT(formatted);
+	}
+
+	void ExitedThreads() {
+		StartFileLog(Logs::Netcode);
+
+		// every thread's queue is retired when it exits, its lines are still written before it goes
+		for (int round = 0; round < 4; ++round) {
+			std::vector<std::thread> threads;
+			for (int t = 0; t < 8; ++t) {
+				threads.push_back(std::thread([t]() {
+					for (int i = 0; i < 50; ++i)
+						Log.Out(Logs::Detail, Logs::Netcode, "thread %d line %d", t, i);
+				}));
+			}
+			for (auto &thread : threads)
+				thread.join();
+			Log.Flush();
+		}
+		Log.Flush();
+
+		std::ifstream in(file_name.c_str());
+		std::string line;
+		int lines = 0;
+		while (std::getline(in, line))
+			++lines;
+		in.close();
+
+		StopFileLog();
+		TEST_ASSERT_EQUALS(lines, 4 * 8 * 50);
+	}
+
+	template<typename F>
+	static double Time(int count, F f) {
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < count; ++i)
+			f(i);
+		return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / count;
+	}
+
+	void Benchmark() {
+		StartFileLog(Logs::Netcode);
+
+		// a burst small enough to fit the queue, the writer catches up after each one
+		const int count = 4000;
+		double enabled_ns = 0.0;
+		for (int burst = 0; burst < 5; ++burst) {
+			enabled_ns += Time(count, [](int i) {
+				Log.Out(Logs::Detail, Logs::Netcode, "Received packet opcode 0x%04x length %d from %s", i & 0xFFFF, i, "127.0.0.1:7000");
+			});
+			Log.Flush();
+		}
+		enabled_ns /= 5;
+
+		double disabled_ns = Time(count * 25, [](int i) {
+			Log.Out(Logs::Detail, Logs::AI, "Received packet opcode 0x%04x length %d from %s", i & 0xFFFF, i, "127.0.0.1:7000");
+		});
+
+		StopFileLog();
+
+		std::cout << "Log.Out: enabled (file, queued) " << enabled_ns << "ns/call, disabled category "
+			<< disabled_ns << "ns/call" << std::endl;
+	}
+
+	std::string file_name;
+};
+
+#endif
@@ -29,6 +29,26 @@
 #include "string_util_test.h"
 #include "data_verification_test.h"
 #include "skills_util_test.h"
+#include "eq_stream_broadcast_test.h"
+#include "spatial_grid_test.h"
+#include "eq_stream_factory_test.h"
+#include "timer_wheel_test.h"
+#include "event_waiter_test.h"
+#include "worker_pool_test.h"
+#include "save_tracker_test.h"
+#include "spdat_classify_test.h"
+#include "log_queue_test.h"
+#include "serialized_item_cache_test.h"
+#include "scope_profiler_test.h"
+#include "zone_content_pack_test.h"
+#include "server_talk_test.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/timeoutmgr.h"
+
+EQEmuLogSys Log;
+TimeoutManager timeout_manager;
+const SPDat_Spell_Struct* spells = nullptr;
+int32 SPDAT_RECORDS = -1;
 
 int main() {
 	try {
@@ -44,6 +64,21 @@ int main() {
 		tests.add(new StringUtilTest());
 		tests.add(new DataVerificationTest());
 		tests.add(new SkillsUtilsTest());
+		tests.add(new EQStreamBroadcastTest());
+		tests.add(new SpatialGridTest());
+		tests.add(new TimerWheelTest());
+		tests.add(new EventWaiterTest());
+		tests.add(new WorkerPoolTest());
+		tests.add(new SaveTrackerTest());
+		tests.add(new SpellClassificationTest());
+		tests.add(new LogQueueTest());
+		tests.add(new SerializedItemCacheTest());
+		tests.add(new ScopeProfilerTest());
+		tests.add(new ZoneContentPackTest());
+#ifndef _WINDOWS
+		tests.add(new EQStreamFactoryTest());
+		tests.add(new ServerTalkTest());
+#endif
 		tests.run(*output, true);
 	} catch(...) {
 		return -1;
@@ -0,0 +1,174 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SAVE_TRACKER_H
+#define __EQEMU_TESTS_SAVE_TRACKER_H
+
+#include "cppunit/cpptest.h"
+#include "../common/save_tracker.h"
+#include "../common/string_util.h"
+#include <string>
+#include <vector>
+
+class SaveTrackerTest : public Test::Suite {
+	typedef void(SaveTrackerTest::*TestFunction)(void);
+public:
+	SaveTrackerTest() {
+		TEST_ADD(SaveTrackerTest::FirstSaveWritesEverything);
+		TEST_ADD(SaveTrackerTest::UnchangedSectionsAreSkipped);
+		TEST_ADD(SaveTrackerTest::EmptySections);
+		TEST_ADD(SaveTrackerTest::ResetWritesEverything);
+		TEST_ADD(SaveTrackerTest::UntakenSaveIsDropped);
+		TEST_ADD(SaveTrackerTest::AutosaveStatements);
+	}
+
+	~SaveTrackerTest() {
+	}
+
+private:
+	void FirstSaveWritesEverything() {
+		EQEmu::SaveTracker tracker(3);
+		tracker.Begin();
+		TEST_ASSERT(tracker.Add(0, std::string("a")));
+		TEST_ASSERT(tracker.Add(1, std::string("b")));
+		TEST_ASSERT(tracker.Add(2, std::string("c")));
+
+		auto batch = tracker.Take();
+		TEST_ASSERT_EQUALS(batch.size(), 3);
+		TEST_ASSERT(batch[0] == "a");
+		TEST_ASSERT(batch[1] == "b");
+		TEST_ASSERT(batch[2] == "c");
+		TEST_ASSERT_EQUALS(tracker.GetSaves(), 1);
+	}
+
+	void UnchangedSectionsAreSkipped() {
+		EQEmu::SaveTracker tracker(2);
+		tracker.Begin();
+		tracker.Add(0, std::string("a"));
+		tracker.Add(1, std::vector<std::string>{ "b1", "b2" });
+		tracker.Take();
+
+		tracker.Begin();
+		TEST_ASSERT(!tracker.Add(0, std::string("a")));
+		TEST_ASSERT(tracker.Add(1, std::vector<std::string>{ "b1", "b3" }));
+		auto batch = tracker.Take();
+		TEST_ASSERT_EQUALS(batch.size(), 2);
+		TEST_ASSERT(batch[0] == "b1");
+		TEST_ASSERT(batch[1] == "b3");
+
+		// the statements are compared as a list, not joined together
+		tracker.Begin();
+		TEST_ASSERT(tracker.Add(1, std::vector<std::string>{ "b", "1b3" }));
+		tracker.Take();
+
+		TEST_ASSERT_EQUALS(tracker.GetStatementsTotal(), 8);
+		TEST_ASSERT_EQUALS(tracker.GetStatementsWritten(), 7);
+	}
+
+	void EmptySections() {
+		EQEmu::SaveTracker tracker(1);
+		tracker.Begin();
+		TEST_ASSERT(tracker.Add(0, std::string()));
+		TEST_ASSERT_EQUALS(tracker.Take().size(), 0);
+
+		tracker.Begin();
+		TEST_ASSERT(!tracker.Add(0, std::vector<std::string>()));
+		TEST_ASSERT(tracker.Add(0, std::string("a")));
+		tracker.Take();
+
+		tracker.Begin();
+		TEST_ASSERT(tracker.Add(0, std::string()));
+		TEST_ASSERT(!tracker.Add(5, std::string("out of range")));
+		TEST_ASSERT_EQUALS(tracker.Take().size(), 0);
+	}
+
+	void ResetWritesEverything() {
+		EQEmu::SaveTracker tracker(2);
+		tracker.Begin();
+		tracker.Add(0, std::string("a"));
+		tracker.Add(1, std::string("b"));
+		tracker.Take();
+
+		tracker.Reset();
+		tracker.Begin();
+		TEST_ASSERT(tracker.Add(0, std::string("a")));
+		TEST_ASSERT(tracker.Add(1, std::string("b")));
+		TEST_ASSERT_EQUALS(tracker.Take().size(), 2);
+	}
+
+	void UntakenSaveIsDropped() {
+		EQEmu::SaveTracker tracker(1);
+		tracker.Begin();
+		tracker.Add(0, std::string("a"));
+
+		// never taken, so it was never written
+		tracker.Begin();
+		TEST_ASSERT(tracker.Add(0, std::string("a")));
+		auto batch = tracker.Take();
+		TEST_ASSERT_EQUALS(batch.size(), 1);
+	}
+
+	void AutosaveStatements() {
+		// a character standing around with a few buffs and a pet: position and play time change every save,
+		// buff timers every other one, the rest never. Before, every save wrote every statement.
+		const int saves = 100;
+		const int buffs = 8;
+		EQEmu::SaveTracker tracker(7);
+
+		uint32 full = 0;
+		for (int i = 0; i < saves; ++i) {
+			tracker.Begin();
+			std::vector<std::string> queries;
+
+			tracker.Add(0, std::string("REPLACE INTO `character_currency` VALUES (1, 100, 10)"));
+			tracker.Add(1, std::string("REPLACE INTO `character_bind` VALUES (1, 202, 0, 0)"));
+			tracker.Add(2, std::string("REPLACE INTO `character_bind` VALUES (1, 202, 0, 1)"));
+
+			queries.push_back("DELETE FROM `character_buffs` WHERE `character_id` = 1");
+			std::string insert = "INSERT INTO `character_buffs` VALUES";
+			for (int b = 0; b < buffs; ++b)
+				insert += StringFormat("%s(1, %d, %d)", b ? "," : "", b, 1000 - i / 2);
+			queries.push_back(insert);
+			tracker.Add(3, queries);
+
+			queries.clear();
+			queries.push_back("DELETE FROM `character_pet_buffs` WHERE `char_id` = 1");
+			queries.push_back("DELETE FROM `character_pet_inventory` WHERE `char_id` = 1");
+			queries.push_back("INSERT INTO `character_pet_info` VALUES (1, 0, 'Gabober')");
+			queries.push_back("INSERT INTO `character_pet_info` VALUES (1, 1, '')");
+			tracker.Add(4, queries);
+
+			queries.clear();
+			queries.push_back("DELETE FROM `character_tribute` WHERE `id` = 1");
+			tracker.Add(5, queries);
+
+			tracker.Add(6, StringFormat("REPLACE INTO `character_data` VALUES (1, %d)", i));
+
+			tracker.Take();
+
+			// what the old Client::Save sent: an INSERT per buff and the same pet/tribute/bind rows every time
+			full += 1 + 2 + 1 + buffs + 4 + 1 + 1;
+		}
+
+		TEST_ASSERT_EQUALS(tracker.GetStatementsTotal(), saves * 11);
+		TEST_ASSERT_EQUALS(tracker.GetStatementsWritten(), 11 + (saves - 1) + (saves / 2 - 1) * 2);
+		TEST_ASSERT(tracker.GetStatementsWritten() * 4 < full);
+	}
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SCOPE_PROFILER_H
+#define __EQEMU_TESTS_SCOPE_PROFILER_H
+
+#include "cppunit/cpptest.h"
+#include "../common/scope_profiler.h"
+#include "../common/loop_profiler.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class ScopeProfilerTest : public Test::Suite {
+	typedef void(ScopeProfilerTest::*TestFunction)(void);
+public:
+	explicit ScopeProfilerTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(ScopeProfilerTest::Benchmark);
+			return;
+		}
+		TEST_ADD(ScopeProfilerTest::Percentiles);
+		TEST_ADD(ScopeProfilerTest::Scopes);
+		TEST_ADD(ScopeProfilerTest::Reports);
+		TEST_ADD(ScopeProfilerTest::LoopPhases);
+	}
+
+	~ScopeProfilerTest() {
+	}
+
+private:
+	void Percentiles() {
+		EQEmu::LatencyHistogram h;
+		TEST_ASSERT_EQUALS(h.Percentile(50), 0u);
+
+		for (uint64 i = 1; i <= 100; ++i)
+			h.Record(i);
+
+		TEST_ASSERT_EQUALS(h.Count(), 100u);
+		TEST_ASSERT_EQUALS(h.Total(), 5050u);
+		TEST_ASSERT_EQUALS(h.Max(), 100u);
+
+		// within one bucket (12.5%) of the exact value, never under it
+		uint64 p50 = h.Percentile(50);
+		uint64 p99 = h.Percentile(99);
+		TEST_ASSERT(p50 >= 50 && p50 <= 57);
+		TEST_ASSERT(p99 >= 99 && p99 <= 100);
+		TEST_ASSERT_EQUALS(h.Percentile(100), 100u);
+
+		h.Reset();
+		h.Record(7);
+		TEST_ASSERT_EQUALS(h.Percentile(50), 7u);
+
+		h.Record(5000000000ull);
+		TEST_ASSERT_EQUALS(h.Max(), 5000000000ull);
+		TEST_ASSERT_EQUALS(h.Percentile(100), 5000000000ull);
+	}
+
+	void Scopes() {
+		EQEmu::ScopeProfiler profiler;
+		uint32 a = profiler.GetScope("a");
+		uint32 b = profiler.GetScope("b");
+		TEST_ASSERT(a != b);
+		TEST_ASSERT_EQUALS(profiler.GetScope("a"), a);
+
+		uint32 opcodes = profiler.AddFamily();
+		uint32 events = profiler.AddFamily();
+		int names = 0;
+		auto name = [&names](uint32 key) { ++names; return std::string("key ") + std::to_string(key); };
+
+		uint32 op7 = profiler.GetScope(opcodes, 7, name);
+		TEST_ASSERT_EQUALS(profiler.GetScope(opcodes, 7, name), op7);
+		TEST_ASSERT_EQUALS(names, 1);
+
+		// same name in another family is the same scope
+		TEST_ASSERT_EQUALS(profiler.GetScope(events, 7, name), op7);
+		TEST_ASSERT(profiler.GetScope(events, 8, name) != op7);
+
+		// off, timers do nothing
+		{
+			EQEmu::ScopeProfiler::Timer t(profiler, a);
+		}
+		TEST_ASSERT_EQUALS(profiler.GetHistogram(a).Count(), 0u);
+
+		profiler.SetEnabled(true);
+		{
+			EQEmu::ScopeProfiler::Timer t(profiler, a);
+			EQEmu::ScopeProfiler::Timer none(profiler, EQEmu::ScopeProfiler::NoScope);
+		}
+		TEST_ASSERT_EQUALS(profiler.GetHistogram(a).Count(), 1u);
+
+		profiler.Reset();
+		TEST_ASSERT_EQUALS(profiler.GetHistogram(a).Count(), 0u);
+		TEST_ASSERT_EQUALS(profiler.GetScope("b"), b);
+	}
+
+	void Reports() {
+		EQEmu::ScopeProfiler profiler;
+		profiler.SetEnabled(true);
+		uint32 small = profiler.GetScope("small");
+		uint32 big = profiler.GetScope("big \"quoted\"");
+		profiler.GetScope("unused");
+
+		profiler.Record(small, 10);
+		profiler.Record(big, 1000);
+		profiler.Record(big, 3000);
+
+		std::vector<std::string> lines = profiler.Report();
+		TEST_ASSERT_EQUALS(lines.size(), 2u);
+		TEST_ASSERT(lines[0].find("big") == 0);
+		TEST_ASSERT(lines[0].find("2 calls") != std::string::npos);
+		TEST_ASSERT(lines[1].find("small") == 0);
+		TEST_ASSERT_EQUALS(profiler.Report(1).size(), 1u);
+
+		std::string json = profiler.ReportJSON("zone");
+		TEST_ASSERT(json.find("{\"title\":\"zone\"") == 0);
+		TEST_ASSERT(json.find("\"name\":\"big \\\"quoted\\\"\",\"count\":2,\"total_us\":4000") != std::string::npos);
+		TEST_ASSERT(json.find("unused") == std::string::npos);
+		TEST_ASSERT(json.rfind("]}") == json.length() - 2);
+	}
+
+	void LoopPhases() {
+		static const char *const names[] = { "first", "second" };
+		EQEmu::ScopeProfiler scopes;
+		EQEmu::LoopProfiler loop(names, 2);
+		loop.SetScopeProfiler(&scopes);
+
+		loop.Phase(0);
+		loop.Wait();
+		TEST_ASSERT_EQUALS(scopes.GetHistogram(scopes.GetScope("tick")).Count(), 0u);
+
+		scopes.SetEnabled(true);
+		for (int i = 0; i < 3; ++i) {
+			loop.Phase(0);
+			loop.Phase(1);
+			loop.Wait();
+		}
+
+		TEST_ASSERT_EQUALS(scopes.GetHistogram(scopes.GetScope("tick")).Count(), 3u);
+		TEST_ASSERT_EQUALS(scopes.GetHistogram(scopes.GetScope("phase first")).Count(), 3u);
+		TEST_ASSERT_EQUALS(scopes.GetHistogram(scopes.GetScope("phase second")).Count(), 3u);
+	}
+
+	void Benchmark() {
+		EQEmu::ScopeProfiler profiler;
+		uint32 family = profiler.AddFamily();
+		auto name = [](uint32 key) { return std::string("opcode ") + std::to_string(key); };
+		const int count = 1000000;
+
+		auto run = [&]() {
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < count; ++i) {
+				EQEmu::ScopeProfiler::Timer t(profiler, profiler.IsEnabled() ? profiler.GetScope(family, i & 63, name) : EQEmu::ScopeProfiler::NoScope);
+			}
+			return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / count;
+		};
+
+		double off_ns = run();
+		profiler.SetEnabled(true);
+		double on_ns = run();
+
+		TEST_ASSERT_EQUALS(profiler.GetHistogram(profiler.GetScope("opcode 0")).Count(), (uint64)count / 64);
+		std::cout << "ScopeProfiler: timed scope " << on_ns << "ns, disabled " << off_ns << "ns" << std::endl;
+	}
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SERIALIZED_ITEM_CACHE_H
+#define __EQEMU_TESTS_SERIALIZED_ITEM_CACHE_H
+
+#include "cppunit/cpptest.h"
+#include "../common/serialized_item_cache.h"
+#include "../common/string_util.h"
+#include <sstream>
+#include <string>
+#include <string.h>
+
+class SerializedItemCacheTest : public Test::Suite {
+	typedef void(SerializedItemCacheTest::*TestFunction)(void);
+public:
+	SerializedItemCacheTest() {
+		TEST_ADD(SerializedItemCacheTest::BuildsOnce);
+		TEST_ADD(SerializedItemCacheTest::MovedItem);
+		TEST_ADD(SerializedItemCacheTest::Full);
+	}
+
+	~SerializedItemCacheTest() {
+	}
+
+private:
+	static void MakeItem(Item_Struct &item, uint32 id) {
+		memset(&item, 0, sizeof(Item_Struct));
+		item.ID = id;
+		snprintf(item.Name, sizeof(item.Name), "Item %u", id);
+	}
+
+	static std::string Build(const Item_Struct *item) {
+		return StringFormat("|%u|%s|", item->ID, item->Name);
+	}
+
+	void BuildsOnce() {
+		EQEmu::SerializedItemCache cache;
+		Item_Struct a, b;
+		MakeItem(a, 1001);
+		MakeItem(b, 1002);
+
+		std::stringstream ss(std::stringstream::in | std::stringstream::out | std::stringstream::binary);
+		std::string out;
+		for (int i = 0; i < 3; ++i) {
+			cache.Write(ss, &a, Build);
+			cache.Append(out, &b, Build);
+		}
+
+		TEST_ASSERT_EQUALS(ss.str(), std::string("|1001|Item 1001||1001|Item 1001||1001|Item 1001|"));
+		TEST_ASSERT_EQUALS(out, std::string("|1002|Item 1002||1002|Item 1002||1002|Item 1002|"));
+		TEST_ASSERT_EQUALS(cache.Builds(), 2u);
+		TEST_ASSERT_EQUALS(cache.Size(), 2u);
+	}
+
+	void MovedItem() {
+		EQEmu::SerializedItemCache cache;
+		Item_Struct a, reloaded;
+		MakeItem(a, 1001);
+		MakeItem(reloaded, 1001);
+		strcpy(reloaded.Name, "Reloaded");
+
+		std::string out;
+		cache.Append(out, &a, Build);
+		cache.Append(out, &reloaded, Build);
+		cache.Append(out, &reloaded, Build);
+
+		TEST_ASSERT_EQUALS(out, std::string("|1001|Item 1001||1001|Reloaded||1001|Reloaded|"));
+		TEST_ASSERT_EQUALS(cache.Builds(), 2u);
+		TEST_ASSERT_EQUALS(cache.Size(), 1u);
+	}
+
+	void Full() {
+		EQEmu::SerializedItemCache cache(4);
+		Item_Struct items[5];
+		std::string out;
+		for (int i = 0; i < 5; ++i) {
+			MakeItem(items[i], 2000 + i);
+			cache.Append(out, &items[i], Build);
+		}
+
+		// the fifth item emptied it
+		TEST_ASSERT_EQUALS(cache.Size(), 1u);
+
+		cache.Append(out, &items[4], Build);
+		TEST_ASSERT_EQUALS(cache.Builds(), 5u);
+
+		cache.Clear();
+		TEST_ASSERT_EQUALS(cache.Size(), 0u);
+		cache.Append(out, &items[4], Build);
+		TEST_ASSERT_EQUALS(cache.Builds(), 6u);
+	}
+};
+
+#endif
@@ -0,0 +1,467 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SERVER_TALK_H
+#define __EQEMU_TESTS_SERVER_TALK_H
+
+#include "cppunit/cpptest.h"
+#include "../common/emu_tcp_server.h"
+#include "../common/emu_tcp_connection.h"
+#include "../common/event_waiter.h"
+#include "../common/servertalk.h"
+#include "../common/packet_buffer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// world and zone over loopback, the test thread plays both main loops
+class ServerTalkTest : public Test::Suite {
+	typedef void(ServerTalkTest::*TestFunction)(void);
+public:
+	explicit ServerTalkTest(bool benchmark = false) : zone_conn(nullptr), world_conn(nullptr) {
+		if (benchmark) {
+			TEST_ADD(ServerTalkTest::Benchmark);
+			TEST_ADD(ServerTalkTest::FanOutBenchmark);
+			return;
+		}
+		TEST_ADD(ServerTalkTest::RoundTrip);
+		TEST_ADD(ServerTalkTest::LargePackets);
+		TEST_ADD(ServerTalkTest::Disconnects);
+		TEST_ADD(ServerTalkTest::PooledPackets);
+		TEST_ADD(ServerTalkTest::Resize);
+		TEST_ADD(ServerTalkTest::BatchedOrder);
+		TEST_ADD(ServerTalkTest::FanOut);
+	}
+
+	~ServerTalkTest() {
+	}
+
+protected:
+	virtual void setup() {
+		char errbuf[TCPServer_ErrorBufferSize];
+		world.reset(new EmuTCPServer());
+		for (port = 17900; port < 17950; ++port) {
+			if (world->Open(port, errbuf))
+				break;
+		}
+
+		zone_conn = new EmuTCPConnection();
+		zone_conn->SetPacketMode(EmuTCPConnection::packetModeZone);
+		zone_conn->SetWakeup(&zone_waiter);
+		zone_conn->Connect("127.0.0.1", port, errbuf);
+
+		world_conn = nullptr;
+		for (int i = 0; i < 5000 && !world_conn; ++i) {
+			world_conn = world->NewQueuePop();
+			if (!world_conn)
+				Sleep(1);
+		}
+		if (world_conn)
+			world_conn->SetWakeup(&world_waiter);
+
+		// the zone sends **PACKETMODEZONE** and world echoes it back
+		for (int i = 0; i < 5000 && !InPacketMode(); ++i)
+			Sleep(1);
+	}
+
+	virtual void tear_down() {
+		if (zone_conn) {
+			zone_conn->Disconnect();
+			delete zone_conn;
+			zone_conn = nullptr;
+		}
+		if (world_conn) {
+			world_conn->Free();
+			world_conn = nullptr;
+		}
+		world.reset();
+	}
+
+private:
+	bool InPacketMode() {
+		return world_conn && world_conn->GetMode() == EmuTCPConnection::modePacket &&
+			zone_conn->GetMode() == EmuTCPConnection::modePacket;
+	}
+
+	static ServerPacket *MakePacket(uint16 opcode, uint32 size, uint32 seed) {
+		ServerPacket *pack = new ServerPacket(opcode, size);
+		for (uint32 i = 0; i < size; ++i)
+			pack->pBuffer[i] = (uchar)(seed + i * 7);
+		return pack;
+	}
+
+	static bool CheckPacket(ServerPacket *pack, uint16 opcode, uint32 size, uint32 seed) {
+		if (!pack || pack->opcode != opcode || pack->size != size)
+			return false;
+		for (uint32 i = 0; i < size; ++i) {
+			if (pack->pBuffer[i] != (uchar)(seed + i * 7))
+				return false;
+		}
+		return true;
+	}
+
+	// waits up to timeout ms for the next packet on conn
+	static ServerPacket *WaitPacket(EmuTCPConnection *conn, EQEmu::EventWaiter &waiter, uint32 timeout = 5000) {
+		auto start = std::chrono::steady_clock::now();
+		for (;;) {
+			ServerPacket *pack = conn->PopPacket();
+			if (pack)
+				return pack;
+			if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeout))
+				return nullptr;
+			waiter.Wait(10);
+		}
+	}
+
+	void RoundTrip() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		for (uint32 i = 0; i < 20; ++i) {
+			std::unique_ptr<ServerPacket> out(MakePacket(ServerOP_ZonePlayer, i * 13, i));
+			TEST_ASSERT(zone_conn->SendPacket(out.get()));
+			std::unique_ptr<ServerPacket> in(WaitPacket(world_conn, world_waiter));
+			TEST_ASSERT(CheckPacket(in.get(), ServerOP_ZonePlayer, i * 13, i));
+
+			out.reset(MakePacket(ServerOP_ChannelMessage, i * 17 + 1, i + 100));
+			TEST_ASSERT(world_conn->SendPacket(out.get()));
+			in.reset(WaitPacket(zone_conn, zone_waiter));
+			TEST_ASSERT(CheckPacket(in.get(), ServerOP_ChannelMessage, i * 17 + 1, i + 100));
+		}
+	}
+
+	void LargePackets() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		// bigger than the socket buffers, so sends complete over several writes
+		const uint32 size = 300000;
+		for (uint32 i = 0; i < 4; ++i) {
+			std::unique_ptr<ServerPacket> out(MakePacket(ServerOP_ZoneToZoneRequest, size, i));
+			TEST_ASSERT(world_conn->SendPacket(out.get()));
+		}
+
+		for (uint32 i = 0; i < 4; ++i) {
+			std::unique_ptr<ServerPacket> in(WaitPacket(zone_conn, zone_waiter));
+			TEST_ASSERT(CheckPacket(in.get(), ServerOP_ZoneToZoneRequest, size, i));
+		}
+	}
+
+	void Disconnects() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		zone_conn->Disconnect();
+		bool closed = false;
+		for (int i = 0; i < 5000 && !closed; ++i) {
+			closed = !world_conn->Connected();
+			if (!closed)
+				Sleep(1);
+		}
+		TEST_ASSERT(closed);
+		TEST_ASSERT(!zone_conn->Connected());
+	}
+
+	void PooledPackets() {
+		// steady create and delete is served from the pool
+		for (int i = 0; i < 100; ++i)
+			delete MakePacket(ServerOP_ZonePlayer, 200, i);
+		EQEmu::PacketBuffer::Stats before = EQEmu::PacketBuffer::GetStats();
+		for (int i = 0; i < 1000; ++i)
+			delete MakePacket(ServerOP_ZonePlayer, 200, i);
+		EQEmu::PacketBuffer::Stats after = EQEmu::PacketBuffer::GetStats();
+		TEST_ASSERT(after.created - before.created >= 1000);
+		TEST_ASSERT_EQUALS(after.heap_allocs - before.heap_allocs, (uint64)0);
+
+		std::unique_ptr<ServerPacket> pack(MakePacket(ServerOP_ZonePlayer, 5000, 3));
+		std::unique_ptr<ServerPacket> copy(pack->Copy());
+		TEST_ASSERT(CheckPacket(copy.get(), ServerOP_ZonePlayer, 5000, 3));
+		TEST_ASSERT(copy->Deflate());
+		TEST_ASSERT(copy->Inflate());
+		TEST_ASSERT(CheckPacket(copy.get(), ServerOP_ZonePlayer, 5000, 3));
+	}
+
+	void Resize() {
+		std::unique_ptr<ServerPacket> pack(MakePacket(ServerOP_ZonePlayer, 500, 9));
+		pack->Resize(700);
+		TEST_ASSERT_EQUALS(pack->size, 700u);
+		TEST_ASSERT(pack->pBuffer == pack->payload->Data());
+		bool kept = true;
+		for (uint32 i = 0; i < 700; ++i) {
+			if (pack->pBuffer[i] != (i < 500 ? (uchar)(9 + i * 7) : 0))
+				kept = false;
+		}
+		TEST_ASSERT(kept);
+
+		pack->Resize(100);
+		TEST_ASSERT(CheckPacket(pack.get(), ServerOP_ZonePlayer, 100, 9));
+
+		// a packet made empty still takes the new[] array callers assign, and gives it up on resize
+		ServerPacket legacy(ServerOP_ZonePlayer);
+		legacy.pBuffer = new uchar[10];
+		legacy.size = 10;
+		memset(legacy.pBuffer, 0xAB, 10);
+		legacy.Resize(20);
+		TEST_ASSERT(legacy.pBuffer == legacy.payload->Data());
+		TEST_ASSERT_EQUALS(legacy.pBuffer[9], (uchar)0xAB);
+		TEST_ASSERT_EQUALS(legacy.pBuffer[10], (uchar)0);
+	}
+
+	void BatchedOrder() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		// small packets are copied into batches, big ones are queued as they are, all in order
+		world_conn->SetBatching(true);
+		const uint32 sizes[] = { 10, 2000, 100, 0, 900, 9000, 30, 1200, 7 };
+		const uint32 count = sizeof(sizes) / sizeof(sizes[0]);
+		for (int round = 0; round < 50; ++round) {
+			for (uint32 i = 0; i < count; ++i) {
+				std::unique_ptr<ServerPacket> out(MakePacket(ServerOP_ChannelMessage, sizes[i], round + i));
+				TEST_ASSERT(world_conn->SendPacket(out.get()));
+			}
+		}
+		for (int round = 0; round < 50; ++round) {
+			for (uint32 i = 0; i < count; ++i) {
+				std::unique_ptr<ServerPacket> in(WaitPacket(zone_conn, zone_waiter));
+				TEST_ASSERT(CheckPacket(in.get(), ServerOP_ChannelMessage, sizes[i], round + i));
+			}
+		}
+		world_conn->SetBatching(false);
+	}
+
+	void Benchmark() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		// round trips: zone sends, world answers as soon as its loop sees it
+		const int pings = 500;
+		std::vector<double> rtt;
+		for (int i = 0; i < pings; ++i) {
+			std::unique_ptr<ServerPacket> ping(MakePacket(ServerOP_KeepAlive, 64, i));
+			auto start = std::chrono::high_resolution_clock::now();
+			zone_conn->SendPacket(ping.get());
+			std::unique_ptr<ServerPacket> got(WaitPacket(world_conn, world_waiter));
+			if (!got)
+				break;
+			world_conn->SendPacket(got.get());
+			got.reset(WaitPacket(zone_conn, zone_waiter));
+			if (!got)
+				break;
+			rtt.push_back(std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count());
+		}
+		TEST_ASSERT_EQUALS((int)rtt.size(), pings);
+		if ((int)rtt.size() != pings)
+			return;
+
+		std::sort(rtt.begin(), rtt.end());
+
+		// throughput: the zone sends as fast as it can, world drains
+		const int count = 200000;
+		std::unique_ptr<ServerPacket> update(MakePacket(ServerOP_ZonePlayer, 48, 0));
+		int received = 0;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < count; ++i) {
+			zone_conn->SendPacket(update.get());
+			ServerPacket *pack;
+			while ((pack = world_conn->PopPacket())) {
+				++received;
+				delete pack;
+			}
+		}
+		while (received < count) {
+			ServerPacket *pack = WaitPacket(world_conn, world_waiter);
+			if (!pack)
+				break;
+			++received;
+			delete pack;
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		TEST_ASSERT_EQUALS(received, count);
+
+		std::cout << "ServerTalk loopback: rtt p50 " << rtt[pings / 2] << "us, p99 " << rtt[pings * 99 / 100]
+			<< "us, " << (uint32)(received / seconds) << " packets/sec" << std::endl;
+	}
+
+	// opens zones - 1 more links next to the fixture's own, false if they don't all reach packet mode
+	bool ConnectZones(int zones, std::vector<EmuTCPConnection*> &zone_side, std::vector<EmuTCPConnection*> &world_side) {
+		char errbuf[TCPConnection_ErrorBufferSize];
+		zone_side.assign(1, zone_conn);
+		world_side.assign(1, world_conn);
+		for (int i = 1; i < zones; ++i) {
+			EmuTCPConnection *conn = new EmuTCPConnection();
+			conn->SetPacketMode(EmuTCPConnection::packetModeZone);
+			conn->Connect("127.0.0.1", port, errbuf);
+			zone_side.push_back(conn);
+
+			EmuTCPConnection *accepted = nullptr;
+			for (int j = 0; j < 5000 && !accepted; ++j) {
+				accepted = world->NewQueuePop();
+				if (!accepted)
+					Sleep(1);
+			}
+			world_side.push_back(accepted);
+		}
+
+		bool ready = false;
+		for (int i = 0; i < 5000 && !ready; ++i) {
+			ready = true;
+			for (int z = 0; z < zones; ++z) {
+				if (!world_side[z] || world_side[z]->GetMode() != EmuTCPConnection::modePacket ||
+					zone_side[z]->GetMode() != EmuTCPConnection::modePacket)
+					ready = false;
+			}
+			if (!ready)
+				Sleep(1);
+		}
+		return ready;
+	}
+
+	static void DisconnectZones(std::vector<EmuTCPConnection*> &zone_side, std::vector<EmuTCPConnection*> &world_side) {
+		for (size_t z = 1; z < zone_side.size(); ++z) {
+			zone_side[z]->Disconnect();
+			delete zone_side[z];
+			if (world_side[z])
+				world_side[z]->Free();
+		}
+	}
+
+	// world broadcasting to several zones, the way ZSList::SendPacket does
+	void FanOut() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		std::vector<EmuTCPConnection*> zone_side, world_side;
+		bool ready = ConnectZones(4, zone_side, world_side);
+		TEST_ASSERT(ready);
+		if (ready) {
+			double rate;
+			uint64 allocs;
+			TEST_ASSERT(RunFanOut(zone_side, world_side, 1000, false, rate, allocs));
+			TEST_ASSERT(RunFanOut(zone_side, world_side, 1000, true, rate, allocs));
+		}
+		DisconnectZones(zone_side, world_side);
+	}
+
+	void FanOutBenchmark() {
+		TEST_ASSERT(InPacketMode());
+		if (!InPacketMode())
+			return;
+
+		const int zones = 8;
+		std::vector<EmuTCPConnection*> zone_side, world_side;
+		bool ready = ConnectZones(zones, zone_side, world_side);
+		TEST_ASSERT(ready);
+		if (ready) {
+			double copied, shared;
+			uint64 copied_allocs, shared_allocs;
+			TEST_ASSERT(RunFanOut(zone_side, world_side, 20000, false, copied, copied_allocs));
+			TEST_ASSERT(RunFanOut(zone_side, world_side, 20000, true, shared, shared_allocs));
+
+			std::cout << "ServerTalk fan-out to " << zones << " zones: copy per zone " << (uint32)copied
+				<< " broadcasts/sec, shared frames + batching " << (uint32)shared << " broadcasts/sec, "
+				<< copied_allocs << " vs " << shared_allocs << " pool heap allocs" << std::endl;
+		}
+		DisconnectZones(zone_side, world_side);
+	}
+
+	static bool RunFanOut(std::vector<EmuTCPConnection*> &zone_side, std::vector<EmuTCPConnection*> &world_side,
+		int count, bool shared, double &broadcasts_per_sec, uint64 &heap_allocs)
+	{
+		const size_t zones = zone_side.size();
+		for (size_t z = 0; z < zones; ++z)
+			world_side[z]->SetBatching(shared);
+
+		std::vector<int> received(zones, 0);
+		bool intact = true;
+		auto drain = [&]() {
+			bool got = false;
+			for (size_t z = 0; z < zones; ++z) {
+				ServerPacket *pack;
+				while ((pack = zone_side[z]->PopPacket())) {
+					if (!CheckPacket(pack, ServerOP_ChannelMessage, 64, received[z]))
+						intact = false;
+					++received[z];
+					got = true;
+					delete pack;
+				}
+			}
+			return got;
+		};
+
+		EQEmu::PacketBuffer::Stats before = EQEmu::PacketBuffer::GetStats();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < count; ++i) {
+			std::unique_ptr<ServerPacket> pack(MakePacket(ServerOP_ChannelMessage, 64, i));
+			if (shared) {
+				EQEmu::PacketBuffer *frame = EmuTCPConnection::MakeFrame(pack.get());
+				for (size_t z = 0; z < zones; ++z)
+					world_side[z]->SendSharedPacket(pack.get(), frame);
+				frame->Unref();
+			}
+			else {
+				for (size_t z = 0; z < zones; ++z)
+					world_side[z]->SendPacket(pack.get());
+			}
+			// zones keep up with world in practice, so only a window of broadcasts is in flight
+			drain();
+			while (i - *std::min_element(received.begin(), received.end()) > 256) {
+				if (!drain())
+					std::this_thread::yield();
+			}
+		}
+
+		auto last = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - last < std::chrono::seconds(5)) {
+			if (drain())
+				last = std::chrono::steady_clock::now();
+			else if (*std::min_element(received.begin(), received.end()) == count)
+				break;
+			else
+				Sleep(1);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		EQEmu::PacketBuffer::Stats after = EQEmu::PacketBuffer::GetStats();
+
+		for (size_t z = 0; z < zones; ++z)
+			world_side[z]->SetBatching(false);
+
+		broadcasts_per_sec = count / seconds;
+		heap_allocs = after.heap_allocs - before.heap_allocs;
+		return intact && *std::min_element(received.begin(), received.end()) == count &&
+			*std::max_element(received.begin(), received.end()) == count;
+	}
+
+	std::unique_ptr<EmuTCPServer> world;
+	uint16 port;
+	EmuTCPConnection *zone_conn;
+	EmuTCPConnection *world_conn;
+	EQEmu::EventWaiter zone_waiter;
+	EQEmu::EventWaiter world_waiter;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2013 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SPATIAL_GRID_H
+#define __EQEMU_TESTS_SPATIAL_GRID_H
+
+#include "cppunit/cpptest.h"
+#include "../common/spatial_grid.h"
+#include <algorithm>
+#include <vector>
+
+class SpatialGridTest : public Test::Suite {
+	typedef void(SpatialGridTest::*TestFunction)(void);
+public:
+	SpatialGridTest() {
+		TEST_ADD(SpatialGridTest::InsertRemoveTest);
+		TEST_ADD(SpatialGridTest::MoveTest);
+		TEST_ADD(SpatialGridTest::HugeQueryTest);
+		TEST_ADD(SpatialGridTest::SyntheticZone500Test);
+		TEST_ADD(SpatialGridTest::SyntheticZone2000Test);
+		TEST_ADD(SpatialGridTest::SyntheticZone10000Test);
+	}
+
+	~SpatialGridTest() {
+	}
+
+	private:
+	struct Point {
+		float x;
+		float y;
+	};
+
+	//deterministic so the synthetic zones are the same every run
+	float NextCoord(uint32 &seed, float extent) {
+		seed = seed * 1103515245 + 12345;
+		return (static_cast<float>((seed >> 8) & 0xFFFF) / 65535.0f) * extent * 2.0f - extent;
+	}
+
+	void InsertRemoveTest() {
+		EQEmu::SpatialGrid<int> grid(100.0f);
+		grid.Insert(1, 10.0f, 10.0f);
+		grid.Insert(2, 50.0f, 50.0f);
+		grid.Insert(3, -250.0f, 10.0f);
+		TEST_ASSERT_EQUALS(grid.Size(), 3);
+		TEST_ASSERT_EQUALS(grid.CellCount(), 2);
+
+		std::vector<int> out;
+		grid.QueryRadius(0.0f, 0.0f, 60.0f, out);
+		TEST_ASSERT_EQUALS(out.size(), 2);
+		TEST_ASSERT(std::find(out.begin(), out.end(), 3) == out.end());
+
+		grid.Remove(1);
+		grid.Remove(1);
+		TEST_ASSERT(!grid.Contains(1));
+		TEST_ASSERT_EQUALS(grid.Size(), 2);
+
+		out.clear();
+		grid.QueryRadius(0.0f, 0.0f, 60.0f, out);
+		TEST_ASSERT_EQUALS(out.size(), 1);
+		TEST_ASSERT_EQUALS(out[0], 2);
+
+		grid.Clear();
+		TEST_ASSERT_EQUALS(grid.Size(), 0);
+		TEST_ASSERT_EQUALS(grid.CellCount(), 0);
+	}
+
+	void MoveTest() {
+		EQEmu::SpatialGrid<int> grid(100.0f);
+		TEST_ASSERT(!grid.Relocate(1, 0.0f, 0.0f));
+		TEST_ASSERT(!grid.Contains(1));
+
+		grid.Insert(1, 10.0f, 10.0f);
+		grid.Insert(2, 20.0f, 20.0f);
+		TEST_ASSERT(grid.Relocate(1, 1010.0f, 10.0f));
+		TEST_ASSERT_EQUALS(grid.CellCount(), 2);
+
+		std::vector<int> out;
+		grid.QueryRadius(1000.0f, 0.0f, 50.0f, out);
+		TEST_ASSERT_EQUALS(out.size(), 1);
+		TEST_ASSERT_EQUALS(out[0], 1);
+
+		out.clear();
+		grid.QueryRadius(0.0f, 0.0f, 50.0f, out);
+		TEST_ASSERT_EQUALS(out.size(), 1);
+		TEST_ASSERT_EQUALS(out[0], 2);
+	}
+
+	void HugeQueryTest() {
+		EQEmu::SpatialGrid<int> grid(100.0f);
+		grid.Insert(1, -40000.0f, 40000.0f);
+		grid.Insert(2, 40000.0f, -40000.0f);
+
+		std::vector<int> out;
+		grid.QueryRadius(0.0f, 0.0f, 1000000.0f, out);
+		TEST_ASSERT_EQUALS(out.size(), 2);
+	}
+
+	//scatters count objects over a 10000 x 10000 zone then checks that radius queries around
+	//a few hundred points find everything brute force does while looking at far fewer objects.
+	void SyntheticZone(uint32 count) {
+		const float extent = 5000.0f;
+		const float radius = 200.0f;
+		uint32 seed = count;
+
+		EQEmu::SpatialGrid<uint32> grid(100.0f);
+		std::vector<Point> points(count);
+		for(uint32 i = 0; i < count; ++i) {
+			points[i].x = NextCoord(seed, extent);
+			points[i].y = NextCoord(seed, extent);
+			grid.Insert(i, points[i].x, points[i].y);
+		}
+		TEST_ASSERT_EQUALS(grid.Size(), count);
+
+		size_t candidates = 0;
+		size_t brute_force = 0;
+		bool all_found = true;
+		std::vector<uint32> out;
+		for(uint32 q = 0; q < 256; ++q) {
+			float x = NextCoord(seed, extent);
+			float y = NextCoord(seed, extent);
+
+			out.clear();
+			grid.QueryRadius(x, y, radius, out);
+			candidates += out.size();
+			std::sort(out.begin(), out.end());
+
+			for(uint32 i = 0; i < count; ++i) {
+				float dx = points[i].x - x;
+				float dy = points[i].y - y;
+				brute_force++;
+				if(dx * dx + dy * dy > radius * radius)
+					continue;
+				if(!std::binary_search(out.begin(), out.end(), i))
+					all_found = false;
+			}
+		}
+
+		TEST_ASSERT(all_found);
+		TEST_ASSERT(candidates * 20 < brute_force);
+
+		//move everything and make sure nothing gets lost along the way
+		for(uint32 i = 0; i < count; ++i) {
+			points[i].x += NextCoord(seed, 150.0f);
+			points[i].y += NextCoord(seed, 150.0f);
+			grid.Relocate(i, points[i].x, points[i].y);
+		}
+		out.clear();
+		grid.QueryRadius(0.0f, 0.0f, extent * 2.0f, out);
+		TEST_ASSERT_EQUALS(out.size(), count);
+	}
+
+	void SyntheticZone500Test() {
+		SyntheticZone(500);
+	}
+
+	void SyntheticZone2000Test() {
+		SyntheticZone(2000);
+	}
+
+	void SyntheticZone10000Test() {
+		SyntheticZone(10000);
+	}
+};
+
+#endif
@@ -0,0 +1,283 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_SPDAT_CLASSIFY_H
+#define __EQEMU_TESTS_SPDAT_CLASSIFY_H
+
+#include "cppunit/cpptest.h"
+#include "../common/spdat.h"
+#include <chrono>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+/*
+	Builds a random spell table, classifies it like the shared memory loader does and checks the
+	bit test predicates against the loops they replaced.
+*/
+class SpellClassificationTest : public Test::Suite {
+	typedef void(SpellClassificationTest::*TestFunction)(void);
+public:
+	explicit SpellClassificationTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(SpellClassificationTest::Benchmark);
+			return;
+		}
+		TEST_ADD(SpellClassificationTest::EffectBits);
+		TEST_ADD(SpellClassificationTest::MatchesLoops);
+	}
+
+	~SpellClassificationTest() {
+		spells = nullptr;
+		SPDAT_RECORDS = -1;
+	}
+
+private:
+	enum { SpellCount = 40000 };
+
+	void Build() {
+		if (!table.empty())
+			return;
+
+		table.resize(SpellCount);
+		memset(&table[0], 0, sizeof(SPDat_Spell_Struct) * SpellCount);
+
+		const int effects[] = { SE_CurrentHP, SE_CurrentHPOnce, SE_CurrentMana, SE_AttackSpeed, SE_AttackSpeed4,
+			SE_CancelMagic, SE_VoiceGraft, SE_SummonPet, SE_SummonItem, SE_SummonPC, SE_DiseaseCounter,
+			SE_PoisonCounter, SE_CurseCounter, SE_CorruptionCounter, SE_DeathSave, SE_Rune, SE_Mez, SE_Stun,
+			SE_CastOnFadeEffect, SE_MitigateMeleeDamage, SE_CHA, SE_StackingCommand_Block, SE_Fear, SE_Root };
+		const int effect_types = sizeof(effects) / sizeof(effects[0]);
+		const SpellTargetType targets[] = { ST_Self, ST_Pet, ST_Target, ST_AETarget, ST_Animal, ST_Undead,
+			ST_Tap, ST_TargetAETap, ST_Group, ST_AEBard, ST_GroupTeleport, ST_AECaster };
+		const int target_types = sizeof(targets) / sizeof(targets[0]);
+
+		for (int id = 0; id < SpellCount; ++id) {
+			SPDat_Spell_Struct &sp = table[id];
+			sp.id = id;
+			if (Random(10) != 0)
+				strcpy(sp.player_1, "PLAYER_1");
+
+			int used = 1 + Random(EFFECT_COUNT);
+			for (int i = 0; i < EFFECT_COUNT; ++i) {
+				sp.effectid[i] = i < used ? effects[Random(effect_types)] : SE_Blank;
+				sp.base[i] = (int)Random(400) - 200;
+				sp.formula[i] = Random(2) ? 100 : 0;
+				if (sp.effectid[i] == SE_CHA && Random(2))
+					sp.base[i] = 0;
+				if (sp.effectid[i] == SE_DeathSave)
+					sp.base[i] = 1 + Random(2);
+			}
+
+			sp.goodEffect = Random(3);
+			sp.targettype = targets[Random(target_types)];
+			sp.buffduration = Random(3) ? 0 : Random(100);
+			sp.resisttype = Random(2) ? RESIST_MAGIC : RESIST_FIRE;
+			sp.SpellAffectIndex = Random(2) ? SAI_Calm : SAI_Dispell_Sight;
+			sp.skill = Random(2) ? (SkillUseTypes)18 : SkillAbjuration;
+
+			CalcSpellClassification(&sp);
+		}
+
+		spells = &table[0];
+		SPDAT_RECORDS = SpellCount;
+	}
+
+	uint32 Random(uint32 n) {
+		seed = seed * 1103515245 + 12345;
+		return ((seed >> 16) & 0x7fff) % n;
+	}
+
+	// the predicates as they were before the classification bits
+	static bool LoopEffectInSpell(uint16 id, int effect) {
+		if (!IsValidSpell(id))
+			return false;
+		for (int i = 0; i < EFFECT_COUNT; i++)
+			if (spells[id].effectid[i] == effect)
+				return true;
+		return false;
+	}
+
+	static bool LoopGroupSpell(uint16 id) {
+		return IsValidSpell(id) && (spells[id].targettype == ST_AEBard || spells[id].targettype == ST_Group ||
+			spells[id].targettype == ST_GroupTeleport);
+	}
+
+	static bool LoopBeneficialSpell(uint16 id) {
+		if (!IsValidSpell(id))
+			return false;
+		if (spells[id].goodEffect == 1) {
+			SpellTargetType tt = spells[id].targettype;
+			if (tt != ST_Self && tt != ST_Pet && LoopEffectInSpell(id, SE_CancelMagic))
+				return false;
+			if (tt == ST_Target || tt == ST_AETarget || tt == ST_Animal || tt == ST_Undead || tt == ST_Pet) {
+				uint16 sai = spells[id].SpellAffectIndex;
+				if (spells[id].resisttype == RESIST_MAGIC) {
+					if (sai == SAI_Calm || sai == SAI_Dispell_Sight || sai == SAI_Memory_Blur || sai == SAI_Calm_Song)
+						return false;
+				} else {
+					if (sai == SAI_Dispell_Sight && spells[id].skill == 18 && !LoopEffectInSpell(id, SE_VoiceGraft))
+						return false;
+				}
+			}
+		}
+		return spells[id].goodEffect != 0 || LoopGroupSpell(id);
+	}
+
+	static bool LoopDamageSpell(uint16 id) {
+		for (int o = 0; o < EFFECT_COUNT; o++) {
+			uint32 tid = spells[id].effectid[o];
+			if ((tid == SE_CurrentHPOnce || tid == SE_CurrentHP) && spells[id].targettype != ST_Tap &&
+					spells[id].buffduration < 1 && spells[id].base[o] < 0)
+				return true;
+		}
+		return false;
+	}
+
+	static bool LoopSlowSpell(uint16 id) {
+		for (int i = 0; i < EFFECT_COUNT; i++)
+			if ((spells[id].effectid[i] == SE_AttackSpeed && spells[id].base[i] < 100) || spells[id].effectid[i] == SE_AttackSpeed4)
+				return true;
+		return false;
+	}
+
+	static bool LoopHasteSpell(uint16 id) {
+		for (int i = 0; i < EFFECT_COUNT; i++)
+			if (spells[id].effectid[i] == SE_AttackSpeed)
+				return spells[id].base[i] < 100;
+		return false;
+	}
+
+	static bool LoopPureNukeSpell(uint16 id) {
+		if (!IsValidSpell(id))
+			return false;
+		int effect_count = 0;
+		for (int i = 0; i < EFFECT_COUNT; i++)
+			if (!IsBlankSpellEffect(id, i))
+				effect_count++;
+		return effect_count == 1 && LoopEffectInSpell(id, SE_CurrentHP) && spells[id].buffduration == 0 && LoopDamageSpell(id);
+	}
+
+	static bool LoopCureSpell(uint16 id) {
+		bool cure = false;
+		for (int i = 0; i < EFFECT_COUNT; i++) {
+			int e = spells[id].effectid[i];
+			if (e == SE_DiseaseCounter || e == SE_PoisonCounter || e == SE_CurseCounter || e == SE_CorruptionCounter)
+				cure = true;
+		}
+		return cure && LoopBeneficialSpell(id);
+	}
+
+	static bool LoopSummonSpell(uint16 id) {
+		for (int o = 0; o < EFFECT_COUNT; o++) {
+			uint32 tid = spells[id].effectid[o];
+			if (tid == SE_SummonPet || tid == SE_SummonItem || tid == SE_SummonPC)
+				return true;
+		}
+		return false;
+	}
+
+	static bool LoopDeathSave(uint16 id, int base) {
+		if (!IsValidSpell(id))
+			return false;
+		for (int i = 0; i < EFFECT_COUNT; i++)
+			if (spells[id].effectid[i] == SE_DeathSave && spells[id].base[i] == base)
+				return true;
+		return false;
+	}
+
+	void EffectBits() {
+		SPDat_Spell_Struct sp;
+		memset(&sp, 0, sizeof(sp));
+		for (int i = 0; i < EFFECT_COUNT; ++i)
+			sp.effectid[i] = SE_Blank;
+		sp.effectid[3] = SE_Mez;
+		sp.effectid[7] = SE_DamageModifier2;
+		sp.effectid[8] = 9999; // out of range ids are left to the loop
+		CalcSpellClassification(&sp);
+
+		int set = 0;
+		for (int e = 0; e < SPELL_EFFECT_BITS; ++e)
+			if (sp.effect_bits[e >> 5] & (1u << (e & 31)))
+				++set;
+		TEST_ASSERT_EQUALS(set, 3);
+		TEST_ASSERT(sp.effect_bits[SE_Mez >> 5] & (1u << (SE_Mez & 31)));
+		TEST_ASSERT(sp.effect_bits[SE_DamageModifier2 >> 5] & (1u << (SE_DamageModifier2 & 31)));
+		TEST_ASSERT(sp.effect_bits[SE_Blank >> 5] & (1u << (SE_Blank & 31)));
+	}
+
+	void MatchesLoops() {
+		Build();
+
+		int mismatches = 0;
+		for (int id = 0; id < SpellCount; ++id) {
+			uint16 s = (uint16)id;
+			if (IsBeneficialSpell(s) != LoopBeneficialSpell(s)) ++mismatches;
+			if (IsDetrimentalSpell(s) != !LoopBeneficialSpell(s)) ++mismatches;
+			if (IsDamageSpell(s) != LoopDamageSpell(s)) ++mismatches;
+			if (IsSlowSpell(s) != LoopSlowSpell(s)) ++mismatches;
+			if (IsHasteSpell(s) != LoopHasteSpell(s)) ++mismatches;
+			if (IsPureNukeSpell(s) != LoopPureNukeSpell(s)) ++mismatches;
+			if (IsCureSpell(s) != LoopCureSpell(s)) ++mismatches;
+			if (IsPartialDeathSaveSpell(s) != LoopDeathSave(s, 1)) ++mismatches;
+			if (IsFullDeathSaveSpell(s) != LoopDeathSave(s, 2)) ++mismatches;
+			if (IsSummonSpell(s) != LoopSummonSpell(s)) ++mismatches;
+			for (int e = 0; e < 70; ++e)
+				if (IsEffectInSpell(s, e) != LoopEffectInSpell(s, e)) ++mismatches;
+			if (IsEffectInSpell(s, SE_Blank) != LoopEffectInSpell(s, SE_Blank)) ++mismatches;
+			if (IsEffectInSpell(s, -1) || IsEffectInSpell(s, 100000)) ++mismatches;
+		}
+
+		TEST_ASSERT_EQUALS(mismatches, 0);
+	}
+
+	template<typename F>
+	double Time(F f, int &hits) {
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int pass = 0; pass < 10; ++pass)
+			for (int id = 0; id < SpellCount; ++id)
+				if (f((uint16)id))
+					++hits;
+		return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / (10.0 * SpellCount);
+	}
+
+	void Benchmark() {
+		Build();
+
+		int loop_hits = 0, bit_hits = 0;
+		double loop_ns = 0.0, bit_ns = 0.0;
+
+		loop_ns += Time(LoopBeneficialSpell, loop_hits);
+		loop_ns += Time(LoopSlowSpell, loop_hits);
+		loop_ns += Time(LoopPureNukeSpell, loop_hits);
+		loop_ns += Time([](uint16 id) { return LoopEffectInSpell(id, SE_Mez); }, loop_hits);
+
+		bit_ns += Time(IsBeneficialSpell, bit_hits);
+		bit_ns += Time(IsSlowSpell, bit_hits);
+		bit_ns += Time(IsPureNukeSpell, bit_hits);
+		bit_ns += Time([](uint16 id) { return IsEffectInSpell(id, SE_Mez); }, bit_hits);
+
+		TEST_ASSERT_EQUALS(loop_hits, bit_hits);
+		std::cout << "Spell predicates: " << SpellCount << " spells, beneficial+slow+purenuke+effect loops " << loop_ns
+			<< "ns/spell, bit tests " << bit_ns << "ns/spell" << std::endl;
+	}
+
+	std::vector<SPDat_Spell_Struct> table;
+	uint32 seed = 42;
+};
+
+#endif
@@ -0,0 +1,329 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_TIMER_WHEEL_H
+#define __EQEMU_TESTS_TIMER_WHEEL_H
+
+#include "cppunit/cpptest.h"
+#include "../common/timer_wheel.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+extern uint32 current_time;
+
+class TimerWheelTest : public Test::Suite {
+	typedef void(TimerWheelTest::*TestFunction)(void);
+public:
+	explicit TimerWheelTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(TimerWheelTest::Benchmark);
+			return;
+		}
+		TEST_ADD(TimerWheelTest::ExpiresOnTime);
+		TEST_ADD(TimerWheelTest::CancelAndMove);
+		TEST_ADD(TimerWheelTest::LongDelays);
+		TEST_ADD(TimerWheelTest::PastTimes);
+		TEST_ADD(TimerWheelTest::RescheduleFromCallback);
+		TEST_ADD(TimerWheelTest::WheelTimerMatchesTimer);
+		TEST_ADD(TimerWheelTest::CheckDueMatchesTimer);
+		TEST_ADD(TimerWheelTest::PollingMatchesWheel);
+	}
+
+	~TimerWheelTest() {
+		//the other suites run on the real clock
+		Timer::SetCurrentTime();
+	}
+
+private:
+	void ExpiresOnTime() {
+		EQEmu::TimerWheel wheel(1000);
+		EQEmu::TimerWheelEntry a, b;
+		bool a_due = false, b_due = false;
+		a.SetDueFlag(&a_due);
+		b.SetDueFlag(&b_due);
+
+		wheel.Schedule(&a, 1010);
+		wheel.Schedule(&b, 1255);
+		TEST_ASSERT_EQUALS(wheel.Size(), 2);
+
+		TEST_ASSERT_EQUALS(wheel.Advance(1009), 0);
+		TEST_ASSERT(!a_due);
+		TEST_ASSERT_EQUALS(wheel.Advance(1010), 1);
+		TEST_ASSERT(a_due);
+		TEST_ASSERT(!a.Scheduled());
+		TEST_ASSERT(!b_due);
+		TEST_ASSERT_EQUALS(wheel.Advance(1300), 1);
+		TEST_ASSERT(b_due);
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+	}
+
+	void CancelAndMove() {
+		EQEmu::TimerWheel wheel(0);
+		EQEmu::TimerWheelEntry a, b;
+		int fired = 0;
+		a.SetCallback([&fired]() { fired++; });
+		b.SetCallback([&fired]() { fired += 10; });
+
+		wheel.Schedule(&a, 50);
+		wheel.Schedule(&b, 60);
+		wheel.Cancel(&a);
+		wheel.Schedule(&b, 5000);
+		TEST_ASSERT_EQUALS(wheel.Size(), 1);
+		TEST_ASSERT_EQUALS(wheel.Advance(4999), 0);
+		TEST_ASSERT_EQUALS(fired, 0);
+		TEST_ASSERT_EQUALS(wheel.Advance(5000), 1);
+		TEST_ASSERT_EQUALS(fired, 10);
+
+		{
+			EQEmu::TimerWheelEntry gone;
+			wheel.Schedule(&gone, 6000);
+			TEST_ASSERT_EQUALS(wheel.Size(), 1);
+		}
+		TEST_ASSERT_EQUALS(wheel.Size(), 0);
+	}
+
+	void LongDelays() {
+		//start close to the wrap so the entries cascade across it
+		uint32 start = 0xFFFFFFFF - 100000;
+		EQEmu::TimerWheel wheel(start);
+		uint32 delays[] = { 255, 256, 257, 16383, 16384, 16385, 1048575, 1048576, 3600000 };
+		const int count = sizeof(delays) / sizeof(delays[0]);
+
+		EQEmu::TimerWheelEntry entries[count];
+		uint32 fired_at[count];
+		uint32 now = start;
+		for (int i = 0; i < count; ++i) {
+			fired_at[i] = 0;
+			entries[i].SetCallback([&fired_at, &now, i]() { fired_at[i] = now; });
+			wheel.Schedule(&entries[i], start + delays[i]);
+		}
+
+		//advance in uneven steps like the zone loop does
+		while (wheel.Size() > 0) {
+			now += 7;
+			wheel.Advance(now);
+		}
+
+		for (int i = 0; i < count; ++i) {
+			uint32 late = fired_at[i] - (start + delays[i]);
+			TEST_ASSERT(late < 7);
+		}
+	}
+
+	void PastTimes() {
+		EQEmu::TimerWheel wheel(500);
+		wheel.Advance(1000);
+		EQEmu::TimerWheelEntry a;
+		bool due = false;
+		a.SetDueFlag(&due);
+		wheel.Schedule(&a, 10);
+		TEST_ASSERT_EQUALS(wheel.Advance(1001), 1);
+		TEST_ASSERT(due);
+	}
+
+	void RescheduleFromCallback() {
+		EQEmu::TimerWheel wheel(0);
+		EQEmu::TimerWheelEntry a;
+		int fired = 0;
+		uint32 now = 0;
+		a.SetCallback([&]() {
+			fired++;
+			//due right away goes out with the next Advance, not a lap of the wheel later
+			wheel.Schedule(&a, fired < 3 ? now : now + 1000);
+		});
+
+		wheel.Schedule(&a, 100);
+		for (now = 100; now < 103; ++now)
+			wheel.Advance(now);
+		TEST_ASSERT_EQUALS(fired, 3);
+		TEST_ASSERT(a.Scheduled());
+		TEST_ASSERT_EQUALS(a.Expires(), 1102);
+		TEST_ASSERT_EQUALS(wheel.Advance(1101), 0);
+		TEST_ASSERT_EQUALS(wheel.Advance(1102), 1);
+	}
+
+	void WheelTimerMatchesTimer() {
+		current_time = 20000;
+		EQEmu::TimerWheel wheel(current_time);
+		EQEmu::WheelTimer wt(&wheel, 1500);
+		Timer t(1500);
+		bool due = false;
+		wt.Entry().SetDueFlag(&due);
+
+		for (uint32 i = 0; i < 10000; ++i) {
+			current_time++;
+			wheel.Advance(current_time);
+			bool polled = t.Check();
+			TEST_ASSERT_EQUALS(due, polled);
+			if (due) {
+				due = false;
+				TEST_ASSERT(wt.Check());
+			}
+
+			if (i == 4000) {
+				t.Disable();
+				wt.Disable();
+			} else if (i == 6000) {
+				t.Start(700);
+				wt.Start(700);
+			} else if (i == 8000) {
+				t.Trigger();
+				wt.Trigger();
+			}
+		}
+		TEST_ASSERT(wheel.Size() == 1);
+	}
+
+	void CheckDueMatchesTimer() {
+		current_time = 50000;
+		EQEmu::TimerWheel wheel(current_time);
+		EQEmu::WheelTimer wt(&wheel, 1000);
+		EQEmu::WheelTimer unwheeled(nullptr, 1000);
+		Timer t(1000);
+
+		for (uint32 i = 0; i < 10000; ++i) {
+			current_time++;
+			wheel.Advance(current_time);
+			bool polled = t.Check();
+			TEST_ASSERT_EQUALS(wt.CheckDue(), polled);
+			TEST_ASSERT_EQUALS(unwheeled.CheckDue(), polled);
+
+			if (i == 3000) {
+				t.Disable();
+				wt.Disable();
+				unwheeled.Disable();
+			} else if (i == 5000) {
+				t.Start(300);
+				wt.Start(300);
+				unwheeled.Start(300);
+			} else if (i == 7000) {
+				t.SetTimer(2500);
+				wt.SetTimer(2500);
+				unwheeled.SetTimer(2500);
+			}
+		}
+
+		//without resetting the timer stays due until somebody does
+		wt.Start(100);
+		current_time += 101;
+		wheel.Advance(current_time);
+		TEST_ASSERT(wt.Due());
+		TEST_ASSERT(wt.CheckDue(false));
+		TEST_ASSERT(wt.CheckDue(false));
+		TEST_ASSERT(wt.CheckDue());
+		TEST_ASSERT(!wt.Due());
+		TEST_ASSERT(!wt.CheckDue());
+
+		//restarted through the base class the wheel wakes it too early, it has to move itself
+		wt.Start(100);
+		static_cast<Timer&>(wt).Start(200);
+		current_time += 101;
+		wheel.Advance(current_time);
+		TEST_ASSERT(!wt.CheckDue());
+		current_time += 100;
+		wheel.Advance(current_time);
+		TEST_ASSERT(wt.CheckDue());
+	}
+
+	struct PollingStats {
+		uint32 polled_fires;
+		uint32 wheel_fires;
+		double polled_us;
+		double wheel_us;
+	};
+
+	//NPCs each with a dozen timers of the usual lengths, the zone loop either checks every one of them
+	//or advances the wheel and only looks at the ones that went off.
+	static PollingStats PollingVsWheel(int npc_count) {
+		const uint32 durations[] = { 100, 250, 500, 1000, 1500, 2000, 3000, 6000, 10000, 12000, 30000, 60000 };
+		const int timers_per_npc = sizeof(durations) / sizeof(durations[0]);
+		const uint32 loops = 1000;
+		const uint32 loop_ms = 10;
+		PollingStats stats;
+
+		current_time = 100000;
+		std::vector<Timer> polled;
+		polled.reserve(npc_count * timers_per_npc);
+		for (int i = 0; i < npc_count; ++i) {
+			for (int j = 0; j < timers_per_npc; ++j) {
+				//spread the start times out the way spawns would be
+				current_time = 100000 - (i * 7 + j * 13) % durations[j];
+				polled.push_back(Timer(durations[j]));
+			}
+		}
+
+		current_time = 100000;
+		stats.polled_fires = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (uint32 l = 0; l < loops; ++l) {
+			current_time += loop_ms;
+			for (auto &t : polled) {
+				if (t.Check())
+					stats.polled_fires++;
+			}
+		}
+		stats.polled_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / loops;
+
+		EQEmu::TimerWheel wheel(100000);
+		std::vector<std::unique_ptr<EQEmu::WheelTimer>> wheeled;
+		std::vector<EQEmu::WheelTimer*> due;
+		wheeled.reserve(npc_count * timers_per_npc);
+		for (int i = 0; i < npc_count; ++i) {
+			for (int j = 0; j < timers_per_npc; ++j) {
+				current_time = 100000 - (i * 7 + j * 13) % durations[j];
+				EQEmu::WheelTimer *t = new EQEmu::WheelTimer(&wheel, durations[j]);
+				t->Entry().SetCallback([&due, t]() { due.push_back(t); });
+				wheeled.push_back(std::unique_ptr<EQEmu::WheelTimer>(t));
+			}
+		}
+
+		current_time = 100000;
+		stats.wheel_fires = 0;
+		start = std::chrono::steady_clock::now();
+		for (uint32 l = 0; l < loops; ++l) {
+			current_time += loop_ms;
+			wheel.Advance(current_time);
+			for (auto t : due) {
+				if (t->Check())
+					stats.wheel_fires++;
+			}
+			due.clear();
+		}
+		stats.wheel_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / loops;
+		return stats;
+	}
+
+	void PollingMatchesWheel() {
+		PollingStats stats = PollingVsWheel(200);
+		TEST_ASSERT_EQUALS(stats.polled_fires, stats.wheel_fires);
+		TEST_ASSERT(stats.polled_fires > 0);
+	}
+
+	void Benchmark() {
+		const int npc_count = 5000;
+		PollingStats stats = PollingVsWheel(npc_count);
+		TEST_ASSERT_EQUALS(stats.polled_fires, stats.wheel_fires);
+
+		std::cout << "Timers: " << npc_count << " npcs x 12 timers, " << stats.polled_fires
+			<< " expirations, polling " << stats.polled_us << "us/loop, wheel " << stats.wheel_us << "us/loop" << std::endl;
+	}
+};
+
+#endif
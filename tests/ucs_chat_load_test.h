@@ -0,0 +1,223 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_UCS_CHAT_LOAD_H
+#define __EQEMU_TESTS_UCS_CHAT_LOAD_H
+
+#include "cppunit/cpptest.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/string_util.h"
+#include "../ucs/chatchannel.h"
+#include "../ucs/clientlist.h"
+#include "../ucs/database.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+extern ChatChannelList *ChannelList;
+extern std::string WorldShortName;
+extern uint32 ChatMessagesSent;
+
+// thousands of chat clients joining, talking in and leaving channels, without sockets
+class UCSChatLoadTest : public Test::Suite {
+	typedef void(UCSChatLoadTest::*TestFunction)(void);
+public:
+	explicit UCSChatLoadTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(UCSChatLoadTest::Benchmark);
+			return;
+		}
+		TEST_ADD(UCSChatLoadTest::Permissions);
+		TEST_ADD(UCSChatLoadTest::LoadTest);
+	}
+
+	~UCSChatLoadTest() {
+	}
+
+protected:
+	virtual void setup() {
+		WorldShortName = "test";
+		ChannelList = new ChatChannelList();
+	}
+
+	virtual void tear_down() {
+		for (auto c : clients)
+			delete c;
+		clients.clear();
+		ChannelList->RemoveAllChannels();
+		delete ChannelList;
+		ChannelList = nullptr;
+	}
+
+private:
+	enum { JoinsEach = 5 };
+
+	Client *MakeClient(int id, bool underfoot) {
+		// no opcode manager, so whatever is queued to the stream is dropped
+		Client *c = new Client(std::make_shared<EQStream>());
+		c->AddCharacter(id, StringFormat("Player%d", id).c_str(), 60);
+		c->SetKarma(1000);
+		c->SetConnectionType(underfoot ? 'U' : 'S');
+		clients.push_back(c);
+		return c;
+	}
+
+	static std::string ChannelName(int n) {
+		return StringFormat("Channel%d", n);
+	}
+
+	void Permissions() {
+		Client *owner = MakeClient(1, false);
+		Client *other = MakeClient(2, true);
+
+		owner->JoinChannels("secret:pass");
+		ChatChannel *channel = ChannelList->FindChannel("SECRET");
+		TEST_ASSERT(channel != nullptr);
+		if (!channel)
+			return;
+		TEST_ASSERT(channel->IsOwner("Player1"));
+		TEST_ASSERT(channel->IsClientInChannel(owner));
+
+		other->JoinChannels("secret:wrong");
+		TEST_ASSERT(!channel->IsClientInChannel(other));
+
+		channel->AddInvitee("Player2");
+		TEST_ASSERT(channel->IsInvitee("Player2"));
+		other->JoinChannels("secret");
+		TEST_ASSERT(channel->IsClientInChannel(other));
+		TEST_ASSERT(!channel->IsInvitee("Player2"));
+
+		channel->AddModerator("Player2");
+		channel->AddModerator("Player2");
+		TEST_ASSERT(channel->IsModerator("Player2"));
+		channel->RemoveModerator("Player2");
+		TEST_ASSERT(!channel->IsModerator("Player2"));
+
+		channel->AddVoice("Player2");
+		TEST_ASSERT(channel->HasVoice("Player2"));
+		channel->RemoveVoice("Player2");
+		TEST_ASSERT(!channel->HasVoice("Player2"));
+
+		TEST_ASSERT_EQUALS(channel->MemberCount(0), 2);
+		other->LeaveAllChannels(false);
+		TEST_ASSERT(!channel->IsClientInChannel(other));
+		TEST_ASSERT_EQUALS(channel->MemberCount(0), 1);
+	}
+
+	struct LoadStats {
+		double join_seconds;
+		double chat_seconds;
+		double leave_seconds;
+		int deliveries;
+		int channels_found;
+		int members;
+		int first_client_channels;
+		uint32 messages_sent;
+		int channels_left;
+	};
+
+	LoadStats RunLoad(int client_count, int channel_count, int messages) {
+		LoadStats stats;
+
+		for (int i = 0; i < client_count; ++i)
+			MakeClient(i + 1, (i & 1) != 0);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < client_count; ++i) {
+			std::string list;
+			for (int j = 0; j < JoinsEach; ++j) {
+				if (j)
+					list += ", ";
+				list += ChannelName((i + j * 211) % channel_count);
+			}
+			clients[i]->JoinChannels(list);
+		}
+		stats.join_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		stats.channels_found = 0;
+		stats.members = 0;
+		for (int n = 0; n < channel_count; ++n) {
+			ChatChannel *channel = ChannelList->FindChannel(ChannelName(n));
+			if (channel) {
+				stats.channels_found++;
+				stats.members += channel->MemberCount(0);
+			}
+		}
+		stats.first_client_channels = clients[0]->ChannelCount();
+
+		uint32 sent = ChatMessagesSent;
+		stats.deliveries = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < messages; ++i) {
+			Client *sender = clients[(i * 7) % client_count];
+			ChatChannel *channel = ChannelList->FindChannel(sender->ChannelSlotName(1 + i % JoinsEach));
+			if (!channel || !channel->IsClientInChannel(sender))
+				continue;
+			if (channel->IsModerated() && !channel->HasVoice(sender->GetName()) && !channel->IsModerator(sender->GetName()))
+				continue;
+			channel->SendMessageToChannel("Anyone selling a Fungi Covered Scale Tunic?", sender);
+			stats.deliveries += channel->MemberCount(0);
+		}
+		stats.chat_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		stats.messages_sent = ChatMessagesSent - sent;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < client_count; ++i)
+			clients[i]->LeaveAllChannels(false);
+		stats.leave_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		// temporary channels go away with their last member
+		stats.channels_left = 0;
+		for (int n = 0; n < channel_count; ++n) {
+			if (ChannelList->FindChannel(ChannelName(n)))
+				stats.channels_left++;
+		}
+		return stats;
+	}
+
+	void LoadTest() {
+		const int client_count = 300;
+		const int channel_count = 100;
+		const int messages = 2000;
+		LoadStats stats = RunLoad(client_count, channel_count, messages);
+
+		TEST_ASSERT_EQUALS(stats.channels_found, channel_count);
+		TEST_ASSERT_EQUALS(stats.members, client_count * JoinsEach);
+		TEST_ASSERT_EQUALS(stats.first_client_channels, JoinsEach);
+		TEST_ASSERT_EQUALS(stats.messages_sent, (uint32)messages);
+		TEST_ASSERT_EQUALS(stats.channels_left, 0);
+	}
+
+	void Benchmark() {
+		const int client_count = 3000;
+		const int channel_count = 1000;
+		const int messages = 20000;
+		LoadStats stats = RunLoad(client_count, channel_count, messages);
+		TEST_ASSERT_EQUALS(stats.messages_sent, (uint32)messages);
+
+		std::cout << "UCS chat: " << client_count << " clients, " << channel_count << " channels: "
+			<< (uint32)(client_count * JoinsEach / stats.join_seconds) << " joins/sec, "
+			<< (uint32)(messages / stats.chat_seconds) << " messages/sec ("
+			<< (uint32)(stats.deliveries / stats.chat_seconds) << " deliveries/sec), "
+			<< (uint32)(client_count * JoinsEach / stats.leave_seconds) << " leaves/sec" << std::endl;
+	}
+
+	std::vector<Client*> clients;
+};
+
+#endif
@@ -0,0 +1,36 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+// what ucs.cpp defines for the chat sources, for the binaries that build them without the server
+
+#include "../common/eqemu_logsys.h"
+#include "../ucs/chatchannel.h"
+#include "../ucs/clientlist.h"
+#include "../ucs/database.h"
+#include <string>
+
+ChatChannelList *ChannelList = nullptr;
+Clientlist *CL = nullptr;
+Database database;
+std::string WorldShortName;
+uint32 ChatMessagesSent = 0;
+uint32 MailMessagesSent = 0;
+
+std::string GetMailPrefix() {
+	return "SOE.EQ." + WorldShortName + ".";
+}
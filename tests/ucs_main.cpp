@@ -0,0 +1,42 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+// the chat server tests, kept apart from tests since they build the ucs sources and link MySQL
+
+#include <fstream>
+#include <memory>
+#include "ucs_chat_load_test.h"
+#include "../common/eqemu_logsys.h"
+#include "../common/timeoutmgr.h"
+
+EQEmuLogSys Log;
+TimeoutManager timeout_manager;
+
+int main() {
+	try {
+		std::ofstream outfile("ucs_test_output.txt");
+		std::unique_ptr<Test::Output> output(new Test::TextOutput(Test::TextOutput::Verbose, outfile));
+		Test::Suite tests;
+		tests.add(new UCSChatLoadTest());
+		if (!tests.run(*output, true))
+			return 1;
+	} catch(...) {
+		return -1;
+	}
+	return 0;
+}
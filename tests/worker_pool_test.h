@@ -0,0 +1,183 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_WORKER_POOL_H
+#define __EQEMU_TESTS_WORKER_POOL_H
+
+#include "cppunit/cpptest.h"
+#include "../common/worker_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+//The pool DBcore runs its async queries on. The jitter test stands in for MySQL with a worker that
+//sleeps for a round trip, the same way a zone tick would stall on a synchronous write.
+class WorkerPoolTest : public Test::Suite {
+	typedef void(WorkerPoolTest::*TestFunction)(void);
+public:
+	explicit WorkerPoolTest(bool benchmark = false) {
+		if (benchmark) {
+			TEST_ADD(WorkerPoolTest::TickJitter);
+			return;
+		}
+		TEST_ADD(WorkerPoolTest::InlineWithoutWorkers);
+		TEST_ADD(WorkerPoolTest::CompletionsOnOwner);
+		TEST_ADD(WorkerPoolTest::OrderedByKey);
+		TEST_ADD(WorkerPoolTest::FlushByKey);
+	}
+
+	~WorkerPoolTest() {
+	}
+
+private:
+	void InlineWithoutWorkers() {
+		EQEmu::WorkerPool pool;
+		int worker = 5;
+		bool done = false;
+		pool.Queue(1, [&worker](int w) { worker = w; }, [&done]() { done = true; });
+		TEST_ASSERT_EQUALS(worker, -1);
+		TEST_ASSERT(done);
+	}
+
+	void CompletionsOnOwner() {
+		EQEmu::WorkerPool pool;
+		pool.Start(2);
+
+		std::thread::id owner = std::this_thread::get_id();
+		std::vector<std::thread::id> ran_on(20);
+		int completions = 0;
+		bool on_owner = true;
+		for (int i = 0; i < 20; ++i) {
+			pool.Queue(0, [&ran_on, i](int) { ran_on[i] = std::this_thread::get_id(); },
+				[&completions, &on_owner, owner]() {
+					completions++;
+					if (std::this_thread::get_id() != owner)
+						on_owner = false;
+				});
+		}
+
+		pool.Flush();
+		TEST_ASSERT_EQUALS(completions, 20);
+		TEST_ASSERT(on_owner);
+		for (auto &id : ran_on)
+			TEST_ASSERT(id != owner);
+		TEST_ASSERT_EQUALS(pool.GetPending(), 0);
+		pool.Stop();
+	}
+
+	void OrderedByKey() {
+		EQEmu::WorkerPool pool;
+		pool.Start(4);
+
+		//each key's work has to land in the order it was queued, however the keys interleave
+		const int keys = 16;
+		const int per_key = 200;
+		std::vector<std::vector<int>> seen(keys + 1);
+		for (int i = 0; i < per_key; ++i) {
+			for (int k = 1; k <= keys; ++k)
+				pool.Queue(k, [&seen, k, i](int) { seen[k].push_back(i); });
+		}
+
+		pool.Flush();
+		for (int k = 1; k <= keys; ++k) {
+			TEST_ASSERT_EQUALS((int)seen[k].size(), per_key);
+			bool ordered = true;
+			for (int i = 0; i < (int)seen[k].size(); ++i) {
+				if (seen[k][i] != i)
+					ordered = false;
+			}
+			TEST_ASSERT(ordered);
+		}
+		pool.Stop();
+	}
+
+	void FlushByKey() {
+		EQEmu::WorkerPool pool;
+		pool.Start(2);
+
+		bool slow_done = false;
+		bool fast_done = false;
+		pool.Queue(2, [](int) { std::this_thread::sleep_for(std::chrono::milliseconds(200)); }, [&slow_done]() { slow_done = true; });
+		pool.Queue(3, [](int) { }, [&fast_done]() { fast_done = true; });
+
+		pool.Flush(3);
+		TEST_ASSERT(fast_done);
+		TEST_ASSERT(!slow_done);
+
+		pool.Stop();
+		TEST_ASSERT(slow_done);
+	}
+
+	struct TickStats {
+		double avg_ms;
+		double p99_ms;
+		double max_ms;
+	};
+
+	//a zone tick doing a little real work plus the writes of a few characters
+	TickStats RunTicks(EQEmu::WorkerPool &pool, int ticks) {
+		std::vector<double> times;
+		uint32 seed = 12345;
+		for (int t = 0; t < ticks; ++t) {
+			auto start = std::chrono::steady_clock::now();
+
+			seed = seed * 1103515245 + 12345;
+			int writes = (seed >> 16) % 4;
+			for (int w = 0; w < writes; ++w) {
+				uint32 char_id = (seed >> 8) % 50 + 1;
+				pool.Queue(char_id, [](int) { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+			}
+			pool.Process();
+
+			times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		pool.Flush();
+
+		std::sort(times.begin(), times.end());
+		TickStats stats;
+		stats.avg_ms = 0.0;
+		for (auto t : times)
+			stats.avg_ms += t;
+		stats.avg_ms /= times.size();
+		stats.p99_ms = times[times.size() * 99 / 100];
+		stats.max_ms = times.back();
+		return stats;
+	}
+
+	void TickJitter() {
+		const int ticks = 300;
+
+		EQEmu::WorkerPool inline_pool;
+		TickStats sync = RunTicks(inline_pool, ticks);
+
+		EQEmu::WorkerPool pool;
+		pool.Start(2);
+		TickStats async = RunTicks(pool, ticks);
+		pool.Stop();
+
+		std::cout << "DB tick jitter (2ms writes): sync avg " << sync.avg_ms << "ms p99 " << sync.p99_ms << "ms max " << sync.max_ms
+			<< "ms, async avg " << async.avg_ms << "ms p99 " << async.p99_ms << "ms max " << async.max_ms << "ms" << std::endl;
+
+		TEST_ASSERT(async.p99_ms < sync.p99_ms);
+	}
+};
+
+#endif
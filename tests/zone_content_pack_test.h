@@ -0,0 +1,212 @@
+/*	EQEMu: Everquest Server Emulator
+	Copyright (C) 2001-2015 EQEMu Development Team (http://eqemulator.net)
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; version 2 of the License.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY except by those people which sell it, which
+	are required to give you total support for your newly bought product;
+	without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+	A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifndef __EQEMU_TESTS_ZONE_CONTENT_PACK_H
+#define __EQEMU_TESTS_ZONE_CONTENT_PACK_H
+
+#include "cppunit/cpptest.h"
+#include "../common/zone_content_pack.h"
+#include <string.h>
+#include <vector>
+
+class ZoneContentPackTest : public Test::Suite {
+	typedef void(ZoneContentPackTest::*TestFunction)(void);
+public:
+	ZoneContentPackTest() {
+		TEST_ADD(ZoneContentPackTest::RoundTrip);
+		TEST_ADD(ZoneContentPackTest::Lookups);
+		TEST_ADD(ZoneContentPackTest::Empty);
+		TEST_ADD(ZoneContentPackTest::BadData);
+	}
+
+	~ZoneContentPackTest() {
+	}
+
+private:
+	static void Fill(EQEmu::ZoneContentPack::Content &content) {
+		content.zone_id = 202;
+		content.version = 1;
+		content.content_version = 0xDEADBEEF;
+
+		// added out of order, Write sorts them
+		uint32 spawn_ids[] = { 30, 10, 20 };
+		for (int i = 0; i < 3; ++i) {
+			EQEmu::ZoneContentPack::Spawn2Row s;
+			memset(&s, 0, sizeof(s));
+			s.id = spawn_ids[i];
+			s.spawngroup_id = 500 + i % 2;
+			s.x = (float)s.id;
+			s.grid = 7;
+			content.spawn2.push_back(s);
+		}
+
+		for (uint32 id = 501; id >= 500; --id) {
+			EQEmu::ZoneContentPack::SpawnGroupRow g;
+			memset(&g, 0, sizeof(g));
+			g.id = id;
+			strcpy(g.name, id == 500 ? "gnolls" : "orcs");
+			g.spawn_limit = id - 500;
+			content.spawn_groups.push_back(g);
+		}
+
+		uint32 entries[][2] = { { 501, 3 }, { 500, 2 }, { 501, 1 }, { 500, 1 }, { 501, 2 } };
+		for (int i = 0; i < 5; ++i) {
+			EQEmu::ZoneContentPack::SpawnEntryRow e;
+			e.spawngroup_id = entries[i][0];
+			e.npc_id = entries[i][1];
+			e.chance = 10 * i;
+			e.npc_spawn_limit = 0;
+			content.spawn_entries.push_back(e);
+		}
+
+		EQEmu::ZoneContentPack::GridRow g = { 7, 3, 1 };
+		content.grids.push_back(g);
+
+		for (uint32 n = 5; n >= 1; --n) {
+			EQEmu::ZoneContentPack::GridEntryRow e;
+			memset(&e, 0, sizeof(e));
+			e.grid_id = 7;
+			e.number = n;
+			e.x = (float)n;
+			content.grid_entries.push_back(e);
+		}
+
+		EQEmu::ZoneContentPack::DoorRow d;
+		memset(&d, 0, sizeof(d));
+		d.db_id = 9001;
+		d.door_id = 4;
+		strcpy(d.name, "POKTELE500");
+		strcpy(d.dest_zone, "poknowledge");
+		content.doors.push_back(d);
+	}
+
+	static std::vector<uint8> Pack(EQEmu::ZoneContentPack::Content &content) {
+		std::vector<uint8> data(EQEmu::ZoneContentPack::EstimatedSize(content));
+		EQEmu::ZoneContentPack::Write(&data[0], (uint32)data.size(), content);
+		return data;
+	}
+
+	void RoundTrip() {
+		EQEmu::ZoneContentPack::Content content;
+		Fill(content);
+		std::vector<uint8> data = Pack(content);
+		EQEmu::ZoneContentPack pack(&data[0], (uint32)data.size());
+
+		TEST_ASSERT_EQUALS(pack.GetZoneID(), 202u);
+		TEST_ASSERT_EQUALS(pack.GetVersion(), 1);
+		TEST_ASSERT_EQUALS(pack.GetContentVersion(), 0xDEADBEEFu);
+
+		uint32 count = 0;
+		const EQEmu::ZoneContentPack::Spawn2Row *spawns = pack.GetSpawn2(count);
+		TEST_ASSERT_EQUALS(count, 3u);
+		TEST_ASSERT_EQUALS(spawns[0].id, 10u);
+		TEST_ASSERT_EQUALS(spawns[1].id, 20u);
+		TEST_ASSERT_EQUALS(spawns[2].id, 30u);
+		TEST_ASSERT_EQUALS(spawns[2].x, 30.0f);
+
+		const EQEmu::ZoneContentPack::DoorRow *doors = pack.GetDoors(count);
+		TEST_ASSERT_EQUALS(count, 1u);
+		TEST_ASSERT_EQUALS(doors[0].db_id, 9001u);
+		TEST_ASSERT_EQUALS(std::string(doors[0].dest_zone), std::string("poknowledge"));
+	}
+
+	void Lookups() {
+		EQEmu::ZoneContentPack::Content content;
+		Fill(content);
+		std::vector<uint8> data = Pack(content);
+		EQEmu::ZoneContentPack pack(&data[0], (uint32)data.size());
+
+		const EQEmu::ZoneContentPack::SpawnGroupRow *group = pack.FindSpawnGroup(501);
+		TEST_ASSERT(group != nullptr);
+		TEST_ASSERT_EQUALS(std::string(group->name), std::string("orcs"));
+		TEST_ASSERT(pack.FindSpawnGroup(502) == nullptr);
+		TEST_ASSERT(pack.FindSpawnGroup(1) == nullptr);
+
+		uint32 count = 0;
+		const EQEmu::ZoneContentPack::SpawnEntryRow *entries = pack.GetSpawnEntries(501, count);
+		TEST_ASSERT_EQUALS(count, 3u);
+		TEST_ASSERT_EQUALS(entries[0].npc_id, 1u);
+		TEST_ASSERT_EQUALS(entries[2].npc_id, 3u);
+		TEST_ASSERT_EQUALS(entries[0].spawngroup_id, 501u);
+
+		pack.GetSpawnEntries(500, count);
+		TEST_ASSERT_EQUALS(count, 2u);
+		pack.GetSpawnEntries(499, count);
+		TEST_ASSERT_EQUALS(count, 0u);
+
+		const EQEmu::ZoneContentPack::GridRow *grid = pack.FindGrid(7);
+		TEST_ASSERT(grid != nullptr);
+		TEST_ASSERT_EQUALS(grid->wander_type, 3);
+		TEST_ASSERT(pack.FindGrid(8) == nullptr);
+
+		const EQEmu::ZoneContentPack::GridEntryRow *wps = pack.GetGridEntries(7, count);
+		TEST_ASSERT_EQUALS(count, 5u);
+		bool in_order = true;
+		for (uint32 i = 0; i < count; ++i) {
+			if (wps[i].number != i + 1 || wps[i].x != (float)(i + 1))
+				in_order = false;
+		}
+		TEST_ASSERT(in_order);
+	}
+
+	void Empty() {
+		EQEmu::ZoneContentPack::Content content;
+		content.zone_id = 1;
+		content.version = 0;
+		content.content_version = 0;
+		std::vector<uint8> data = Pack(content);
+		EQEmu::ZoneContentPack pack(&data[0], (uint32)data.size());
+
+		uint32 count = 1;
+		pack.GetSpawn2(count);
+		TEST_ASSERT_EQUALS(count, 0u);
+		pack.GetGridEntries(1, count);
+		TEST_ASSERT_EQUALS(count, 0u);
+		TEST_ASSERT(pack.FindSpawnGroup(1) == nullptr);
+		TEST_ASSERT(pack.FindGrid(1) == nullptr);
+	}
+
+	static bool Opens(std::vector<uint8> &data, uint32 size) {
+		try {
+			EQEmu::ZoneContentPack pack(&data[0], size);
+		} catch(std::exception &) {
+			return false;
+		}
+		return true;
+	}
+
+	void BadData() {
+		EQEmu::ZoneContentPack::Content content;
+		Fill(content);
+		std::vector<uint8> data = Pack(content);
+		TEST_ASSERT(Opens(data, (uint32)data.size()));
+
+		// truncated
+		TEST_ASSERT(!Opens(data, (uint32)data.size() - 8));
+
+		// another format version
+		std::vector<uint8> old = data;
+		((uint32*)&old[0])[1] = EQEmu::ZoneContentPack::FormatVersion + 1;
+		TEST_ASSERT(!Opens(old, (uint32)old.size()));
+
+		std::vector<uint8> zeroed(data.size(), 0);
+		TEST_ASSERT(!Opens(zeroed, (uint32)zeroed.size()));
+	}
+};
+
+#endif
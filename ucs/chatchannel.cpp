@@ -48,43 +48,34 @@ ChatChannel::ChatChannel(std::string inName, std::string inOwner, std::string in
 }
 
 ChatChannel::~ChatChannel() {
-
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements())
-		iterator.RemoveCurrent(false);
 }
 
 ChatChannel* ChatChannelList::CreateChannel(std::string Name, std::string Owner, std::string Password, bool Permanent, int MinimumStatus) {
 
 	ChatChannel *NewChannel = new ChatChannel(CapitaliseName(Name), Owner, Password, Permanent, MinimumStatus);
 
-	ChatChannels.Insert(NewChannel);
-
-	return NewChannel;
-}
+	auto Result = ChatChannels.insert(std::make_pair(NewChannel->GetName(), NewChannel));
 
-ChatChannel* ChatChannelList::FindChannel(std::string Name) {
+	if(!Result.second) {
 
-	std::string NormalisedName = CapitaliseName(Name);
+		Log.Out(Logs::Detail, Logs::UCS_Server, "Channel %s already exists", NewChannel->GetName().c_str());
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
+		safe_delete(NewChannel);
 
-	iterator.Reset();
+		return Result.first->second;
+	}
 
-	while(iterator.MoreElements()) {
+	return NewChannel;
+}
 
-		ChatChannel *CurrentChannel = iterator.GetData();
+ChatChannel* ChatChannelList::FindChannel(std::string Name) {
 
-		if(CurrentChannel && (CurrentChannel->Name == NormalisedName))
-			return iterator.GetData();
+	auto Iterator = ChatChannels.find(CapitaliseName(Name));
 
-		iterator.Advance();
-	}
+	if(Iterator == ChatChannels.end())
+		return nullptr;
 
-	return nullptr;
+	return Iterator->second;
 }
 
 void ChatChannelList::SendAllChannels(Client *c) {
@@ -100,24 +91,16 @@ void ChatChannelList::SendAllChannels(Client *c) {
 
 	int ChannelsInLine = 0;
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
-
-	iterator.Reset();
-
 	std::string Message;
 
 	char CountString[10];
 
-	while(iterator.MoreElements()) {
-
-		ChatChannel *CurrentChannel = iterator.GetData();
+	for(auto &Entry : ChatChannels) {
 
-		if(!CurrentChannel || (CurrentChannel->GetMinStatus() > c->GetAccountStatus())) {
-
-			iterator.Advance();
+		ChatChannel *CurrentChannel = Entry.second;
 
+		if(CurrentChannel->GetMinStatus() > c->GetAccountStatus())
 			continue;
-		}
 
 		if(ChannelsInLine > 0)
 			Message += ", ";
@@ -138,8 +121,6 @@ void ChatChannelList::SendAllChannels(Client *c) {
 
 			Message.clear();
 		}
-
-		iterator.Advance();
 	}
 
 	if(ChannelsInLine > 0)
@@ -151,51 +132,34 @@ void ChatChannelList::RemoveChannel(ChatChannel *Channel) {
 
 	Log.Out(Logs::Detail, Logs::UCS_Server, "RemoveChannel(%s)", Channel->GetName().c_str());
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
+	auto Iterator = ChatChannels.find(Channel->GetName());
 
-		if(iterator.GetData() == Channel) {
-
-			iterator.RemoveCurrent();
+	if((Iterator == ChatChannels.end()) || (Iterator->second != Channel))
+		return;
 
-			return;
-		}
+	ChatChannels.erase(Iterator);
 
-		iterator.Advance();
-	}
+	safe_delete(Channel);
 }
 
 void ChatChannelList::RemoveAllChannels() {
 
 	Log.Out(Logs::Detail, Logs::UCS_Server, "RemoveAllChannels");
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
+	for(auto &Entry : ChatChannels)
+		safe_delete(Entry.second);
 
-	iterator.Reset();
-
-	while(iterator.MoreElements())
-		iterator.RemoveCurrent();
+	ChatChannels.clear();
 }
 
 int ChatChannel::MemberCount(int Status) {
 
 	int Count = 0;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
+	for(auto ChannelClient : ClientsInChannel) {
 
-		Client *ChannelClient = iterator.GetData();
-
-		if(ChannelClient && (!ChannelClient->GetHideMe() || (ChannelClient->GetAccountStatus() < Status)))
+		if(!ChannelClient->GetHideMe() || (ChannelClient->GetAccountStatus() < Status))
 			Count++;
-
-		iterator.Advance();
 	}
 
 	return Count;
@@ -239,22 +203,14 @@ void ChatChannel::AddClient(Client *c) {
 
 	Log.Out(Logs::Detail, Logs::UCS_Server, "Adding %s to channel %s", c->GetName().c_str(), Name.c_str());
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
+	for(auto CurrentClient : ClientsInChannel) {
 
-		Client *CurrentClient = iterator.GetData();
-
-		if(CurrentClient && CurrentClient->IsAnnounceOn())
+		if(CurrentClient->IsAnnounceOn())
 			if(!HideMe || (CurrentClient->GetAccountStatus() > AccountStatus))
 				CurrentClient->AnnounceJoin(this, c);
-
-		iterator.Advance();
 	}
 
-	ClientsInChannel.Insert(c);
+	ClientsInChannel.insert(c);
 
 }
 
@@ -268,30 +224,15 @@ bool ChatChannel::RemoveClient(Client *c) {
 
 	int AccountStatus = c->GetAccountStatus();
 
-	int PlayersInChannel = 0;
-
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
+	ClientsInChannel.erase(c);
 
-	iterator.Reset();
+	int PlayersInChannel = ClientsInChannel.size();
 
-	while(iterator.MoreElements()) {
-
-		Client *CurrentClient = iterator.GetData();
-
-		if(CurrentClient == c) {
-			iterator.RemoveCurrent(false);
-		}
-		else if(CurrentClient) {
-
-			PlayersInChannel++;
-
-			if(CurrentClient->IsAnnounceOn())
-				if(!HideMe || (CurrentClient->GetAccountStatus() > AccountStatus))
-					CurrentClient->AnnounceLeave(this, c);
-
-			iterator.Advance();
-		}
+	for(auto CurrentClient : ClientsInChannel) {
 
+		if(CurrentClient->IsAnnounceOn())
+			if(!HideMe || (CurrentClient->GetAccountStatus() > AccountStatus))
+				CurrentClient->AnnounceLeave(this, c);
 	}
 
 	if((PlayersInChannel == 0) && !Permanent) {
@@ -313,10 +254,8 @@ void ChatChannel::SendOPList(Client *c) {
 
 	c->GeneralChannelMessage("Channel " + Name + " op-list: (Owner=" + Owner + ")");
 
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Moderators.begin(); Iterator != Moderators.end(); ++Iterator)
-		c->GeneralChannelMessage((*Iterator));
+	for(auto &Moderator : Moderators)
+		c->GeneralChannelMessage(Moderator);
 
 }
 
@@ -342,20 +281,12 @@ void ChatChannel::SendChannelMembers(Client *c) {
 
 	int MembersInLine = 0;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
-
-		Client *ChannelClient = iterator.GetData();
+	for(auto ChannelClient : ClientsInChannel) {
 
 		// Don't list hidden characters with status higher or equal than the character requesting the list.
 		//
-		if(!ChannelClient || (ChannelClient->GetHideMe() && (ChannelClient->GetAccountStatus() >= AccountStatus))) {
-			iterator.Advance();
+		if(ChannelClient->GetHideMe() && (ChannelClient->GetAccountStatus() >= AccountStatus))
 			continue;
-		}
 
 		if(MembersInLine > 0)
 			Message += ", ";
@@ -372,8 +303,6 @@ void ChatChannel::SendChannelMembers(Client *c) {
 
 			Message.clear();
 		}
-
-		iterator.Advance();
 	}
 
 	if(MembersInLine > 0)
@@ -387,46 +316,38 @@ void ChatChannel::SendMessageToChannel(std::string Message, Client* Sender) {
 
 	ChatMessagesSent++;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
+	Log.Out(Logs::Detail, Logs::UCS_Server, "Sending message to %i members of %s from %s",
+			(int)ClientsInChannel.size(), Name.c_str(), Sender->GetName().c_str());
 
-	iterator.Reset();
+	// Members only differ in whether they take the Underfoot+ trailer, so the packet is built at most twice
+	// rather than once per member.
+	//
+	EQApplicationPacket *outapp[2] = { nullptr, nullptr };
 
-	while(iterator.MoreElements()) {
+	for(auto ChannelClient : ClientsInChannel) {
 
-		Client *ChannelClient = iterator.GetData();
+		int Version = ChannelClient->IsUnderfootOrLater() ? 1 : 0;
 
-		if(ChannelClient)
-		{
-			Log.Out(Logs::Detail, Logs::UCS_Server, "Sending message to %s from %s",
-					ChannelClient->GetName().c_str(), Sender->GetName().c_str());
-			ChannelClient->SendChannelMessage(Name, Message, Sender);
-		}
+		if(!outapp[Version])
+			outapp[Version] = Client::MakeChannelMessagePacket(Name, Message, Sender, Version == 1);
 
-		iterator.Advance();
+		ChannelClient->QueuePacket(outapp[Version]);
 	}
+
+	safe_delete(outapp[0]);
+	safe_delete(outapp[1]);
 }
 
 void ChatChannel::SetModerated(bool inModerated) {
 
 	Moderated = inModerated;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
-
-		Client *ChannelClient = iterator.GetData();
-
-		if(ChannelClient) {
+	for(auto ChannelClient : ClientsInChannel) {
 
-			if(Moderated)
-				ChannelClient->GeneralChannelMessage("Channel " + Name + " is now moderated.");
-			else
-				ChannelClient->GeneralChannelMessage("Channel " + Name + " is no longer moderated.");
-		}
-
-		iterator.Advance();
+		if(Moderated)
+			ChannelClient->GeneralChannelMessage("Channel " + Name + " is now moderated.");
+		else
+			ChannelClient->GeneralChannelMessage("Channel " + Name + " is no longer moderated.");
 	}
 
 }
@@ -434,19 +355,7 @@ bool ChatChannel::IsClientInChannel(Client *c) {
 
 	if(!c) return false;
 
-	LinkedListIterator<Client*> iterator(ClientsInChannel);
-
-	iterator.Reset();
-
-	while(iterator.MoreElements()) {
-
-		if(iterator.GetData() == c)
-			return true;
-
-		iterator.Advance();
-	}
-
-	return false;
+	return (ClientsInChannel.count(c) != 0);
 }
 
 ChatChannel *ChatChannelList::AddClientToChannel(std::string ChannelName, Client *c) {
@@ -545,148 +454,80 @@ ChatChannel *ChatChannelList::RemoveClientFromChannel(std::string inChannelName,
 
 void ChatChannelList::Process() {
 
-	LinkedListIterator<ChatChannel*> iterator(ChatChannels);
+	auto Iterator = ChatChannels.begin();
 
-	iterator.Reset();
+	while(Iterator != ChatChannels.end()) {
 
-	while(iterator.MoreElements()) {
+		ChatChannel *CurrentChannel = Iterator->second;
 
-		ChatChannel *CurrentChannel = iterator.GetData();
-
-		if(CurrentChannel && CurrentChannel->ReadyToDelete()) {
+		if(CurrentChannel->ReadyToDelete()) {
 
 			Log.Out(Logs::Detail, Logs::UCS_Server, "Empty temporary password protected channel %s being destroyed.",
 				CurrentChannel->GetName().c_str());
 
-			RemoveChannel(CurrentChannel);
-		}
+			Iterator = ChatChannels.erase(Iterator);
 
-		iterator.Advance();
+			safe_delete(CurrentChannel);
+
+			continue;
+		}
 
+		++Iterator;
 	}
 }
 
-void ChatChannel::AddInvitee(std::string Invitee) {
-
-	if(!IsInvitee(Invitee)) {
-
-		Invitees.push_back(Invitee);
+void ChatChannel::AddInvitee(const std::string &Invitee) {
 
+	if(Invitees.insert(Invitee).second)
 		Log.Out(Logs::Detail, Logs::UCS_Server, "Added %s as invitee to channel %s", Invitee.c_str(), Name.c_str());
-	}
 
 }
 
-void ChatChannel::RemoveInvitee(std::string Invitee) {
-
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Invitees.begin(); Iterator != Invitees.end(); ++Iterator) {
-
-		if((*Iterator) == Invitee) {
-
-			Invitees.erase(Iterator);
+void ChatChannel::RemoveInvitee(const std::string &Invitee) {
 
-			Log.Out(Logs::Detail, Logs::UCS_Server, "Removed %s as invitee to channel %s", Invitee.c_str(), Name.c_str());
-
-			return;
-		}
-	}
+	if(Invitees.erase(Invitee))
+		Log.Out(Logs::Detail, Logs::UCS_Server, "Removed %s as invitee to channel %s", Invitee.c_str(), Name.c_str());
 }
 
-bool ChatChannel::IsInvitee(std::string Invitee) {
-
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Invitees.begin(); Iterator != Invitees.end(); ++Iterator) {
-
-		if((*Iterator) == Invitee)
-			return true;
-	}
+bool ChatChannel::IsInvitee(const std::string &Invitee) {
 
-	return false;
+	return (Invitees.count(Invitee) != 0);
 }
 
-void ChatChannel::AddModerator(std::string Moderator) {
-
-	if(!IsModerator(Moderator)) {
-
-		Moderators.push_back(Moderator);
+void ChatChannel::AddModerator(const std::string &Moderator) {
 
+	if(Moderators.insert(Moderator).second)
 		Log.Out(Logs::Detail, Logs::UCS_Server, "Added %s as moderator to channel %s", Moderator.c_str(), Name.c_str());
-	}
 
 }
 
-void ChatChannel::RemoveModerator(std::string Moderator) {
-
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Moderators.begin(); Iterator != Moderators.end(); ++Iterator) {
-
-		if((*Iterator) == Moderator) {
-
-			Moderators.erase(Iterator);
+void ChatChannel::RemoveModerator(const std::string &Moderator) {
 
-			Log.Out(Logs::Detail, Logs::UCS_Server, "Removed %s as moderator to channel %s", Moderator.c_str(), Name.c_str());
-
-			return;
-		}
-	}
+	if(Moderators.erase(Moderator))
+		Log.Out(Logs::Detail, Logs::UCS_Server, "Removed %s as moderator to channel %s", Moderator.c_str(), Name.c_str());
 }
 
-bool ChatChannel::IsModerator(std::string Moderator) {
-
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Moderators.begin(); Iterator != Moderators.end(); ++Iterator) {
-
-		if((*Iterator) == Moderator)
-			return true;
-	}
+bool ChatChannel::IsModerator(const std::string &Moderator) {
 
-	return false;
+	return (Moderators.count(Moderator) != 0);
 }
 
-void ChatChannel::AddVoice(std::string inVoiced) {
-
-	if(!HasVoice(inVoiced)) {
-
-		Voiced.push_back(inVoiced);
+void ChatChannel::AddVoice(const std::string &inVoiced) {
 
+	if(Voiced.insert(inVoiced).second)
 		Log.Out(Logs::Detail, Logs::UCS_Server, "Added %s as voiced to channel %s", inVoiced.c_str(), Name.c_str());
-	}
 
 }
 
-void ChatChannel::RemoveVoice(std::string inVoiced) {
-
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Voiced.begin(); Iterator != Voiced.end(); ++Iterator) {
-
-		if((*Iterator) == inVoiced) {
-
-			Voiced.erase(Iterator);
+void ChatChannel::RemoveVoice(const std::string &inVoiced) {
 
-			Log.Out(Logs::Detail, Logs::UCS_Server, "Removed %s as voiced to channel %s", inVoiced.c_str(), Name.c_str());
-
-			return;
-		}
-	}
+	if(Voiced.erase(inVoiced))
+		Log.Out(Logs::Detail, Logs::UCS_Server, "Removed %s as voiced to channel %s", inVoiced.c_str(), Name.c_str());
 }
 
-bool ChatChannel::HasVoice(std::string inVoiced) {
-
-	std::list<std::string>::iterator Iterator;
-
-	for(Iterator = Voiced.begin(); Iterator != Voiced.end(); ++Iterator) {
-
-		if((*Iterator) == inVoiced)
-			return true;
-	}
+bool ChatChannel::HasVoice(const std::string &inVoiced) {
 
-	return false;
+	return (Voiced.count(inVoiced) != 0);
 }
 
 std::string CapitaliseName(std::string inString) {
@@ -5,7 +5,9 @@
 #include "../common/linked_list.h"
 #include "../common/timer.h"
 #include <string>
-#include <list>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 class Client;
 
@@ -25,21 +27,21 @@ public:
 	void SendMessageToChannel(std::string Message, Client* Sender);
 	bool CheckPassword(std::string inPassword) { return ((Password.length() == 0) || (Password == inPassword)); }
 	void SetPassword(std::string inPassword);
-	bool IsOwner(std::string Name) { return (Owner == Name); }
+	bool IsOwner(const std::string &Name) { return (Owner == Name); }
 	void SetOwner(std::string inOwner);
 	void SendChannelMembers(Client *c);
 	int GetMinStatus() { return MinimumStatus; }
 	bool ReadyToDelete() { return DeleteTimer.Check(); }
 	void SendOPList(Client *c);
-	void AddInvitee(std::string Invitee);
-	void RemoveInvitee(std::string Invitee);
-	bool IsInvitee(std::string Invitee);
-	void AddModerator(std::string Moderator);
-	void RemoveModerator(std::string Modeerator);
-	bool IsModerator(std::string Moderator);
-	void AddVoice(std::string Voiced);
-	void RemoveVoice(std::string Voiced);
-	bool HasVoice(std::string Voiced);
+	void AddInvitee(const std::string &Invitee);
+	void RemoveInvitee(const std::string &Invitee);
+	bool IsInvitee(const std::string &Invitee);
+	void AddModerator(const std::string &Moderator);
+	void RemoveModerator(const std::string &Moderator);
+	bool IsModerator(const std::string &Moderator);
+	void AddVoice(const std::string &Voiced);
+	void RemoveVoice(const std::string &Voiced);
+	bool HasVoice(const std::string &Voiced);
 	inline bool IsModerated() { return Moderated; }
 	void SetModerated(bool inModerated);
 
@@ -58,11 +60,11 @@ private:
 
 	Timer DeleteTimer;
 
-	LinkedList<Client*> ClientsInChannel;
+	std::unordered_set<Client*> ClientsInChannel;
 
-	std::list<std::string> Moderators;
-	std::list<std::string> Invitees;
-	std::list<std::string> Voiced;
+	std::set<std::string> Moderators;
+	std::set<std::string> Invitees;
+	std::set<std::string> Voiced;
 
 };
 
@@ -81,7 +83,8 @@ public:
 
 private:
 
-	LinkedList<ChatChannel*> ChatChannels;
+	// Keyed by the CapitaliseName'd channel name
+	std::unordered_map<std::string, ChatChannel*> ChatChannels;
 
 };
 
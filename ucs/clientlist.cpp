@@ -551,7 +551,7 @@ void Clientlist::CheckForStaleConnections(Client *c) {
 
 	std::list<Client*>::iterator Iterator;
 
-	for(Iterator = ClientChatConnections.begin(); Iterator != ClientChatConnections.end(); ++Iterator) {
+	for(Iterator = ClientChatConnections.begin(); Iterator != ClientChatConnections.end();) {
 
 		if(((*Iterator) != c) && ((c->GetName() == (*Iterator)->GetName())
 				&& (c->GetConnectionType() == (*Iterator)->GetConnectionType()))) {
@@ -565,10 +565,16 @@ void Clientlist::CheckForStaleConnections(Client *c) {
 			Log.Out(Logs::Detail, Logs::UCS_Server, "Client connection from %s:%d closed.", inet_ntoa(in),
 									ntohs((*Iterator)->ClientStream->GetRemotePort()));
 
+			RemoveFromCharacterIndex((*Iterator));
+
 			safe_delete((*Iterator));
 
 			Iterator = ClientChatConnections.erase(Iterator);
+
+			continue;
 		}
+
+		++Iterator;
 	}
 }
 
@@ -605,6 +611,8 @@ void Clientlist::Process() {
 			Log.Out(Logs::Detail, Logs::UCS_Server, "Client connection from %s:%d closed.", inet_ntoa(in),
 										ntohs((*Iterator)->ClientStream->GetRemotePort()));
 
+			RemoveFromCharacterIndex((*Iterator));
+
 			safe_delete((*Iterator));
 
 			Iterator = ClientChatConnections.erase(Iterator);
@@ -673,8 +681,12 @@ void Clientlist::Process() {
 						break;
 					}
 
+					RemoveFromCharacterIndex((*Iterator));
+
 					(*Iterator)->SetAccountID(database.FindAccount(CharacterName.c_str(), (*Iterator)));
 
+					AddToCharacterIndex((*Iterator));
+
 					database.GetAccountStatus((*Iterator));
 
 					if((*Iterator)->GetConnectionType() == ConnectionTypeCombined)
@@ -717,6 +729,8 @@ void Clientlist::Process() {
 
 			(*Iterator)->ClientStream->Close();
 
+			RemoveFromCharacterIndex((*Iterator));
+
 			safe_delete((*Iterator));
 
 			Iterator = ClientChatConnections.erase(Iterator);
@@ -946,16 +960,42 @@ void Client::SendMailBoxes() {
 
 Client *Clientlist::FindCharacter(std::string CharacterName) {
 
-	std::list<Client*>::iterator Iterator;
+	auto Iterator = CharacterIndex.find(CharacterName);
 
-	for(Iterator = ClientChatConnections.begin(); Iterator != ClientChatConnections.end(); ++Iterator) {
+	if(Iterator == CharacterIndex.end())
+		return nullptr;
+
+	return Iterator->second;
+}
+
+void Clientlist::AddToCharacterIndex(Client *c) {
+
+	std::string CharacterName = c->GetName();
+
+	if(CharacterName.length() > 0)
+		CharacterIndex.insert(std::make_pair(CharacterName, c));
+}
+
+void Clientlist::RemoveFromCharacterIndex(Client *c) {
 
-		if((*Iterator)->GetName() == CharacterName)
-			return ((*Iterator));
+	auto Iterator = CharacterIndex.find(c->GetName());
 
+	if((Iterator == CharacterIndex.end()) || (Iterator->second != c))
+		return;
+
+	// Hand the name to the next connection logged in as the same character, if there is one.
+	//
+	for(auto Other : ClientChatConnections) {
+
+		if((Other != c) && (Other->GetName() == Iterator->first)) {
+
+			Iterator->second = Other;
+
+			return;
+		}
 	}
 
-	return nullptr;
+	CharacterIndex.erase(Iterator);
 }
 
 void Client::AddToChannelList(ChatChannel *JoinedChannel) {
@@ -1487,6 +1527,15 @@ void Client::SendChannelMessage(std::string ChannelName, std::string Message, Cl
 
 	if(!Sender) return;
 
+	auto outapp = MakeChannelMessagePacket(ChannelName, Message, Sender, UnderfootOrLater);
+
+	QueuePacket(outapp);
+
+	safe_delete(outapp);
+}
+
+EQApplicationPacket *Client::MakeChannelMessagePacket(const std::string &ChannelName, const std::string &Message, Client *Sender, bool UnderfootOrLater) {
+
 	std::string FQSenderName = WorldShortName + "." + Sender->GetName();
 
 	int PacketLength = ChannelName.length() + Message.length() + FQSenderName.length() + 3;
@@ -1505,9 +1554,7 @@ void Client::SendChannelMessage(std::string ChannelName, std::string Message, Cl
 	if(UnderfootOrLater)
 		VARSTRUCT_ENCODE_STRING(PacketBuffer, "SPAM:0:");
 
-	QueuePacket(outapp);
-
-	safe_delete(outapp);
+	return outapp;
 }
 
 void Client::ToggleAnnounce(std::string State)
@@ -2359,13 +2406,13 @@ std::string Client::MailBoxName() {
 	if((Characters.size() == 0) || (CurrentMailBox > (Characters.size() - 1)))
 	{
 		Log.Out(Logs::Detail, Logs::UCS_Server, "MailBoxName() called with CurrentMailBox set to %i and Characters.size() is %i",
-				CurrentMailBox, Characters.size());
+				CurrentMailBox, (int)Characters.size());
 
 		return "";
 	}
 
 	Log.Out(Logs::Detail, Logs::UCS_Server, "MailBoxName() called with CurrentMailBox set to %i and Characters.size() is %i",
-			CurrentMailBox, Characters.size());
+			CurrentMailBox, (int)Characters.size());
 
 	return Characters[CurrentMailBox].Name;
 
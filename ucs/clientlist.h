@@ -26,6 +26,7 @@
 #include "../common/rulesys.h"
 #include "chatchannel.h"
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 #define MAX_JOINED_CHANNELS 10
@@ -100,6 +101,7 @@ public:
 	void RemoveFromChannelList(ChatChannel *JoinedChannel);
 	void SendChannelMessage(std::string Message);
 	void SendChannelMessage(std::string ChannelName, std::string Message, Client *Sender);
+	static EQApplicationPacket *MakeChannelMessagePacket(const std::string &ChannelName, const std::string &Message, Client *Sender, bool UnderfootOrLater);
 	void SendChannelMessageByNumber(std::string Message);
 	void SendChannelList();
 	void CloseConnection();
@@ -142,6 +144,7 @@ public:
 	int GetMailBoxNumber(std::string CharacterName);
 	void SetConnectionType(char c);
 	ConnectionType GetConnectionType() { return TypeOfConnection; }
+	inline bool IsUnderfootOrLater() { return UnderfootOrLater; }
 	inline bool IsMailConnection() { return (TypeOfConnection == ConnectionTypeMail) || (TypeOfConnection == ConnectionTypeCombined); }
 	void SendNotification(int MailBoxNumber, std::string From, std::string Subject, int MessageID);
 	void ChangeMailBox(int NewMailBox);
@@ -185,10 +188,16 @@ public:
 
 private:
 
+	void	AddToCharacterIndex(Client *c);
+	void	RemoveFromCharacterIndex(Client *c);
+
 	EQStreamFactory *chatsf;
 
 	std::list<Client*> ClientChatConnections;
 
+	// The first logged in connection for each character name, Titanium clients have separate chat and mail connections.
+	std::unordered_map<std::string, Client*> CharacterIndex;
+
 	OpcodeManager *ChatOpMgr;
 };
 
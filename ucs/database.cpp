@@ -388,7 +388,7 @@ void Database::SendBody(Client *client, int messageNumber) {
 
 	auto row = results.begin();
 
-	Log.Out(Logs::Detail, Logs::UCS_Server, "Message: %i  body (%i bytes)", messageNumber, strlen(row[1]));
+	Log.Out(Logs::Detail, Logs::UCS_Server, "Message: %i  body (%i bytes)", messageNumber, (int)strlen(row[1]));
 
 	int packetLength = 12 + strlen(row[0]) + strlen(row[1]) + strlen(row[2]);
 
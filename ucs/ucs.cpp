@@ -112,7 +112,7 @@ int main() {
 		if(!RuleManager::Instance()->LoadRules(&database, "default")) {
 			Log.Out(Logs::General, Logs::UCS_Server, "No rule set configured, using default rules");
 		} else {
-			Log.Out(Logs::General, Logs::UCS_Server, "Loaded default rule set 'default'", tmp);
+			Log.Out(Logs::General, Logs::UCS_Server, "Loaded default rule set 'default'");
 		}
 	}
 
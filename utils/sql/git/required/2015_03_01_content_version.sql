@@ -0,0 +1,30 @@
+-- One row per zone short name, bumped by the triggers below whenever that zone's spawn, grid or door content changes.
+-- Zones compare their row with the one stamped in their content pack, a zone without a row has never been edited.
+CREATE TABLE `content_version` (
+  `zone` varchar(32) NOT NULL,
+  `version` int(10) unsigned NOT NULL DEFAULT '0',
+  PRIMARY KEY (`zone`)
+) ENGINE=InnoDB DEFAULT CHARSET=latin1;
+
+CREATE TRIGGER `content_version_spawn2_insert` AFTER INSERT ON `spawn2` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT IFNULL(NEW.`zone`, ''), 1 ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawn2_update` AFTER UPDATE ON `spawn2` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT IFNULL(NEW.`zone`, ''), 1 UNION SELECT IFNULL(OLD.`zone`, ''), 1 ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawn2_delete` AFTER DELETE ON `spawn2` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT IFNULL(OLD.`zone`, ''), 1 ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+-- spawn groups and entries count for every zone with a spawn point using them
+CREATE TRIGGER `content_version_spawngroup_insert` AFTER INSERT ON `spawngroup` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`zone`, ''), 1 FROM `spawn2` WHERE `spawngroupID` IN (NEW.`id`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawngroup_update` AFTER UPDATE ON `spawngroup` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`zone`, ''), 1 FROM `spawn2` WHERE `spawngroupID` IN (NEW.`id`, OLD.`id`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawngroup_delete` AFTER DELETE ON `spawngroup` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`zone`, ''), 1 FROM `spawn2` WHERE `spawngroupID` IN (OLD.`id`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawnentry_insert` AFTER INSERT ON `spawnentry` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`zone`, ''), 1 FROM `spawn2` WHERE `spawngroupID` IN (NEW.`spawngroupID`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawnentry_update` AFTER UPDATE ON `spawnentry` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`zone`, ''), 1 FROM `spawn2` WHERE `spawngroupID` IN (NEW.`spawngroupID`, OLD.`spawngroupID`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_spawnentry_delete` AFTER DELETE ON `spawnentry` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`zone`, ''), 1 FROM `spawn2` WHERE `spawngroupID` IN (OLD.`spawngroupID`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+-- grids only know their zone by id
+CREATE TRIGGER `content_version_grid_insert` AFTER INSERT ON `grid` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`short_name`, ''), 1 FROM `zone` WHERE `zoneidnumber` IN (NEW.`zoneid`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_grid_update` AFTER UPDATE ON `grid` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`short_name`, ''), 1 FROM `zone` WHERE `zoneidnumber` IN (NEW.`zoneid`, OLD.`zoneid`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_grid_delete` AFTER DELETE ON `grid` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`short_name`, ''), 1 FROM `zone` WHERE `zoneidnumber` IN (OLD.`zoneid`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_grid_entries_insert` AFTER INSERT ON `grid_entries` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`short_name`, ''), 1 FROM `zone` WHERE `zoneidnumber` IN (NEW.`zoneid`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_grid_entries_update` AFTER UPDATE ON `grid_entries` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`short_name`, ''), 1 FROM `zone` WHERE `zoneidnumber` IN (NEW.`zoneid`, OLD.`zoneid`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_grid_entries_delete` AFTER DELETE ON `grid_entries` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(`short_name`, ''), 1 FROM `zone` WHERE `zoneidnumber` IN (OLD.`zoneid`) ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_doors_insert` AFTER INSERT ON `doors` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT IFNULL(NEW.`zone`, ''), 1 ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_doors_update` AFTER UPDATE ON `doors` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT IFNULL(NEW.`zone`, ''), 1 UNION SELECT IFNULL(OLD.`zone`, ''), 1 ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+CREATE TRIGGER `content_version_doors_delete` AFTER DELETE ON `doors` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT IFNULL(OLD.`zone`, ''), 1 ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
+-- spawn entries carry the npc's spawn_limit
+CREATE TRIGGER `content_version_npc_types_update` AFTER UPDATE ON `npc_types` FOR EACH ROW INSERT INTO `content_version` (`zone`, `version`) SELECT DISTINCT IFNULL(s.`zone`, ''), 1 FROM `spawnentry` e JOIN `spawn2` s ON s.`spawngroupID` = e.`spawngroupID` WHERE e.`npcID` = NEW.`id` AND NEW.`spawn_limit` <> OLD.`spawn_limit` ON DUPLICATE KEY UPDATE `content_version`.`version` = `content_version`.`version` + 1;
@@ -657,7 +657,7 @@ bool Client::HandleCharacterCreatePacket(const EQApplicationPacket *app) {
 		return false;
 	}
 	else if (app->size != sizeof(CharCreate_Struct)) {
-		Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on OP_CharacterCreate. Got: %d, Expected: %d",app->size,sizeof(CharCreate_Struct));
+		Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on OP_CharacterCreate. Got: %d, Expected: %d",app->size,(int)sizeof(CharCreate_Struct));
 		DumpPacket(app);
 		// the previous behavior was essentially returning true here
 		// but that seems a bit odd to me.
@@ -322,7 +322,7 @@ int main(int argc, char** argv) {
 			if(!RuleManager::Instance()->LoadRules(&database, "default")) {
 				Log.Out(Logs::General, Logs::World_Server, "No rule set configured, using default rules");
 			} else {
-				Log.Out(Logs::General, Logs::World_Server, "Loaded default rule set 'default'", tmp);
+				Log.Out(Logs::General, Logs::World_Server, "Loaded default rule set 'default'");
 			}
 		}
 	}
@@ -377,6 +377,7 @@ int main(int argc, char** argv) {
 		Log.Out(Logs::General, Logs::World_Server,"        %s",errbuf);
 		return 1;
 	}
+	eqsf.SetReaderThreads(RuleI(Network, StreamReaderThreads));
 	if (eqsf.Open()) {
 		Log.Out(Logs::General, Logs::World_Server,"Client (UDP) listener started.");
 	} else {
@@ -121,11 +121,14 @@ void ZSList::Process() {
 bool ZSList::SendPacket(ServerPacket* pack) {
 	LinkedListIterator<ZoneServer*> iterator(list);
 
+	//framed once, every zone's send queue holds a reference to the same bytes
+	EQEmu::PacketBuffer* frame = EmuTCPConnection::MakeFrame(pack);
 	iterator.Reset();
 	while(iterator.MoreElements()) {
-		iterator.GetData()->SendPacket(pack);
+		iterator.GetData()->SendSharedPacket(pack, frame);
 		iterator.Advance();
 	}
+	frame->Unref();
 	return true;
 }
 
@@ -62,6 +62,8 @@ ZoneServer::ZoneServer(EmuTCPConnection* itcpc)
 	authenticated = false;
 	staticzone = false;
 	pNumPlayers = 0;
+	//world sends zones lots of small updates, let them go out together
+	tcpc->SetBatching(true);
 }
 
 ZoneServer::~ZoneServer() {
@@ -753,7 +755,7 @@ bool ZoneServer::Process() {
 			}
 			case ServerOP_ClientList: {
 				if (pack->size != sizeof(ServerClientList_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_ClientList. Got: %d, Expected: %d",pack->size,sizeof(ServerClientList_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_ClientList. Got: %d, Expected: %d",pack->size,(int)sizeof(ServerClientList_Struct));
 					break;
 				}
 				client_list.ClientUpdate(this, (ServerClientList_Struct*) pack->pBuffer);
@@ -872,7 +874,7 @@ bool ZoneServer::Process() {
 			}
 			case ServerOP_GMGoto: {
 				if (pack->size != sizeof(ServerGMGoto_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_GMGoto. Got: %d, Expected: %d",pack->size,sizeof(ServerGMGoto_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_GMGoto. Got: %d, Expected: %d",pack->size,(int)sizeof(ServerGMGoto_Struct));
 					break;
 				}
 				ServerGMGoto_Struct* gmg = (ServerGMGoto_Struct*) pack->pBuffer;
@@ -892,7 +894,7 @@ bool ZoneServer::Process() {
 			}
 			case ServerOP_Lock: {
 				if (pack->size != sizeof(ServerLock_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_Lock. Got: %d, Expected: %d",pack->size,sizeof(ServerLock_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_Lock. Got: %d, Expected: %d",pack->size,(int)sizeof(ServerLock_Struct));
 					break;
 				}
 				ServerLock_Struct* slock = (ServerLock_Struct*) pack->pBuffer;
@@ -917,7 +919,7 @@ bool ZoneServer::Process() {
 								}
 			case ServerOP_Motd: {
 				if (pack->size != sizeof(ServerMotd_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_Motd. Got: %d, Expected: %d",pack->size,sizeof(ServerMotd_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_Motd. Got: %d, Expected: %d",pack->size,(int)sizeof(ServerMotd_Struct));
 					break;
 				}
 				ServerMotd_Struct* smotd = (ServerMotd_Struct*) pack->pBuffer;
@@ -928,7 +930,7 @@ bool ZoneServer::Process() {
 			}
 			case ServerOP_Uptime: {
 				if (pack->size != sizeof(ServerUptime_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_Uptime. Got: %d, Expected: %d",pack->size,sizeof(ServerUptime_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_Uptime. Got: %d, Expected: %d",pack->size,(int)sizeof(ServerUptime_Struct));
 					break;
 				}
 				ServerUptime_Struct* sus = (ServerUptime_Struct*) pack->pBuffer;
@@ -972,7 +974,7 @@ bool ZoneServer::Process() {
 			}
 			case ServerOP_IPLookup: {
 				if (pack->size < sizeof(ServerGenericWorldQuery_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_IPLookup. Got: %d, Expected (at least): %d",pack->size,sizeof(ServerGenericWorldQuery_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_IPLookup. Got: %d, Expected (at least): %d",pack->size,(int)sizeof(ServerGenericWorldQuery_Struct));
 					break;
 				}
 				ServerGenericWorldQuery_Struct* sgwq = (ServerGenericWorldQuery_Struct*) pack->pBuffer;
@@ -984,7 +986,7 @@ bool ZoneServer::Process() {
 			}
 			case ServerOP_LockZone: {
 				if (pack->size < sizeof(ServerLockZone_Struct)) {
-					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_LockZone. Got: %d, Expected: %d",pack->size,sizeof(ServerLockZone_Struct));
+					Log.Out(Logs::Detail, Logs::World_Server,"Wrong size on ServerOP_LockZone. Got: %d, Expected: %d",pack->size,(int)sizeof(ServerLockZone_Struct));
 					break;
 				}
 				ServerLockZone_Struct* s = (ServerLockZone_Struct*) pack->pBuffer;
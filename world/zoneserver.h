@@ -35,6 +35,7 @@ public:
 
 	bool		Process();
 	bool		SendPacket(ServerPacket* pack) { return tcpc->SendPacket(pack); }
+	bool		SendSharedPacket(ServerPacket* pack, EQEmu::PacketBuffer* frame) { return tcpc->SendSharedPacket(pack, frame); }
 	void		SendEmoteMessage(const char* to, uint32 to_guilddbid, int16 to_minstatus, uint32 type, const char* message, ...);
 	void		SendEmoteMessageRaw(const char* to, uint32 to_guilddbid, int16 to_minstatus, uint32 type, const char* message);
 	bool		SetZone(uint32 iZoneID, uint32 iInstanceID = 0, bool iStaticZone = false);
@@ -1448,7 +1448,7 @@ void Zone::LoadAAs() {
 	//load AA Effects into aa_effects
 	Log.Out(Logs::General, Logs::Status, "Loading AA Effects...");
 	if (database.LoadAAEffects2())
-		Log.Out(Logs::General, Logs::Status, "Loaded %d AA Effects.", aa_effects.size());
+		Log.Out(Logs::General, Logs::Status, "Loaded %d AA Effects.", (int)aa_effects.size());
 	else
 		Log.Out(Logs::General, Logs::Error, "Failed to load AA Effects!");
 }
@@ -39,8 +39,12 @@ extern Zone* zone;
 //look around a client for things which might aggro the client.
 void EntityList::CheckClientAggro(Client *around)
 {
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
-		Mob *mob = it->second;
+	// nothing outside the largest aggro range in the zone can aggro the client
+	std::vector<Mob *> close_mobs;
+	GetCloseMobs(around->GetX(), around->GetY(), max_aggro_range, close_mobs);
+
+	for (auto it = close_mobs.begin(); it != close_mobs.end(); ++it) {
+		Mob *mob = *it;
 		if (mob->IsClient())	//also ensures that mob != around
 			continue;
 
@@ -362,15 +366,19 @@ Mob* EntityList::AICheckCloseAggro(Mob* sender, float iAggroRange, float iAssist
 	if (!sender || !sender->IsNPC())
 		return(nullptr);
 
+	std::vector<Mob *> close_mobs;
+	GetCloseMobs(sender->GetX(), sender->GetY(), iAggroRange, close_mobs);
+
+	auto it = close_mobs.begin();
+	while (it != close_mobs.end()) {
+		Mob *mob = *it;
 #ifdef REVERSE_AGGRO
-	//with reverse aggro, npc->client is checked elsewhere, no need to check again
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-#else
-	auto it = mob_list.begin();
-	while (it != mob_list.end()) {
+		//with reverse aggro, npc->client is checked elsewhere, no need to check again
+		if (!mob->IsNPC()) {
+			++it;
+			continue;
+		}
 #endif
-		Mob *mob = it->second;
 
 		if (sender->CheckWillAggro(mob))
 			return mob;
@@ -911,6 +919,13 @@ bool Mob::CombatRange(Mob* other)
 	return false;
 }
 
+#define LOS_DEFAULT_HEIGHT 6.0f
+
+//where a mob of the given size sees from (HEAD_POSITION) or is looked at (SEE_POSITION)
+static glm::vec3 LosPoint(float x, float y, float z, float size, float position) {
+	return glm::vec3(x, y, z + (size==0.0?LOS_DEFAULT_HEIGHT:size)/2 * position);
+}
+
 //Father Nitwit's LOS code
 bool Mob::CheckLosFN(Mob* other) {
 	bool Result = false;
@@ -934,18 +949,8 @@ bool Mob::CheckLosFN(float posX, float posY, float posZ, float mobSize) {
 #endif
 	}
 
-	glm::vec3 myloc;
-	glm::vec3 oloc;
-
-#define LOS_DEFAULT_HEIGHT 6.0f
-
-	myloc.x = GetX();
-	myloc.y = GetY();
-	myloc.z = GetZ() + (GetSize()==0.0?LOS_DEFAULT_HEIGHT:GetSize())/2 * HEAD_POSITION;
-
-	oloc.x = posX;
-	oloc.y = posY;
-	oloc.z = posZ + (mobSize==0.0?LOS_DEFAULT_HEIGHT:mobSize)/2 * SEE_POSITION;
+	glm::vec3 myloc = LosPoint(GetX(), GetY(), GetZ(), GetSize(), HEAD_POSITION);
+	glm::vec3 oloc = LosPoint(posX, posY, posZ, mobSize, SEE_POSITION);
 
 #if LOSDEBUG>=5
 	Log.Out(Logs::General, Logs::None, "LOS from (%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f) sizes: (%.2f, %.2f)", myloc.x, myloc.y, myloc.z, oloc.x, oloc.y, oloc.z, GetSize(), mobSize);
@@ -953,6 +958,41 @@ bool Mob::CheckLosFN(float posX, float posY, float posZ, float mobSize) {
 	return zone->zonemap->CheckLoS(myloc, oloc);
 }
 
+//results[i] is what CheckLosFN(others[i]) would return, the rays are traced LOS_BATCH at a time
+void Mob::CheckLosFNBatch(Mob *const *others, uint32 count, bool *results) {
+	if(count == 0)
+		return;
+
+	if(zone->zonemap == nullptr) {
+		for(uint32 i = 0; i < count; ++i) {
+#ifdef LOS_DEFAULT_CAN_SEE
+			results[i] = true;
+#else
+			results[i] = false;
+#endif
+		}
+		SetLastLosState(results[count - 1]);
+		return;
+	}
+
+	glm::vec3 from[LOS_BATCH];
+	glm::vec3 to[LOS_BATCH];
+	glm::vec3 myloc = LosPoint(GetX(), GetY(), GetZ(), GetSize(), HEAD_POSITION);
+	for(uint32 i = 0; i < LOS_BATCH; ++i)
+		from[i] = myloc;
+
+	for(uint32 first = 0; first < count; first += LOS_BATCH) {
+		uint32 n = std::min(count - first, (uint32)LOS_BATCH);
+		for(uint32 i = 0; i < n; ++i) {
+			Mob *other = others[first + i];
+			to[i] = LosPoint(other->GetX(), other->GetY(), other->GetZ(), other->GetSize(), SEE_POSITION);
+		}
+		zone->zonemap->CheckLoSBatch(from, to, n, results + first);
+	}
+
+	SetLastLosState(results[count - 1]);
+}
+
 //offensive spell aggro
 int32 Mob::CheckAggroAmount(uint16 spell_id, bool isproc)
 {
@@ -69,11 +69,19 @@ void NPC::CalcBonuses()
 	Mob::CalcBonuses();
 }
 
+void NPC::CalcBuffBonuses()
+{
+	// item bonuses only change when loot does
+	Mob::CalcBonuses();
+}
+
 void Client::CalcBonuses()
 {
 	memset(&itembonuses, 0, sizeof(StatBonuses));
 	CalcItemBonuses(&itembonuses);
 	CalcEdibleBonuses(&itembonuses);
+	uncapped_itembonuses = itembonuses;
+	item_bonuses_cached = true;
 
 	CalcSpellBonuses(&spellbonuses);
 
@@ -85,6 +93,49 @@ void Client::CalcBonuses()
 
 	RecalcWeight();
 
+	CalcBonusStats();
+}
+
+// Buffs landing and fading only change the spell bonuses, the item and AA bonuses don't depend on
+// them so they are kept. The item caps do depend on spells, so the items start over uncapped.
+void Client::CalcBuffBonuses()
+{
+	if (!item_bonuses_cached) {
+		CalcBonuses();
+		return;
+	}
+
+	itembonuses = uncapped_itembonuses;
+	CalcSpellBonuses(&spellbonuses);
+	ProcessItemCaps();
+	CalcBonusStats();
+
+	if (RuleB(Character, CheckBuffBonuses))
+		CheckBuffBonuses();
+}
+
+// Debug check for CalcBuffBonuses, does the full rebuild and logs what came out different
+void Client::CheckBuffBonuses()
+{
+	StatBonuses items = itembonuses;
+	StatBonuses buffs = spellbonuses;
+	StatBonuses aas = aabonuses;
+	int32 hp = max_hp;
+	int32 mana = max_mana;
+
+	CalcBonuses();
+
+	bool items_ok = memcmp(&items, &itembonuses, sizeof(StatBonuses)) == 0;
+	bool buffs_ok = memcmp(&buffs, &spellbonuses, sizeof(StatBonuses)) == 0;
+	bool aas_ok = memcmp(&aas, &aabonuses, sizeof(StatBonuses)) == 0;
+	if (!items_ok || !buffs_ok || !aas_ok || hp != max_hp || mana != max_mana)
+		Log.Out(Logs::General, Logs::Error, "Buff only bonus recalc for %s differs from a full recalc:%s%s%s%s%s",
+			GetCleanName(), items_ok ? "" : " items", buffs_ok ? "" : " spells", aas_ok ? "" : " aas",
+			hp != max_hp ? " max_hp" : "", mana != max_mana ? " max_mana" : "");
+}
+
+void Client::CalcBonusStats()
+{
 	CalcAC();
 	CalcATK();
 	CalcHaste();
@@ -190,6 +190,7 @@ public:
 	bool CanDoSpecialAttack(Mob *other);
 	virtual int32 CheckAggroAmount(uint16 spellid);
 	virtual void CalcBonuses();
+	virtual void CalcBuffBonuses() { CalcBonuses(); } // NPC's buff only recalc would skip our stat rebuild
 	void CalcItemBonuses();
 	virtual void MakePet(uint16 spell_id, const char* pettype, const char *petname = nullptr);
 	virtual FACTION_VALUE GetReverseFactionCon(Mob* iOther);
@@ -116,7 +116,7 @@ Client::Client(EQStreamInterface* ieqs)
 	),
 	//these must be listed in the order they appear in client.h
 	position_timer(250),
-	hpupdate_timer(1800),
+	hpupdate_timer(GetTimerWheel(), 1800),
 	camp_timer(29000),
 	process_timer(100),
 	stamina_timer(40000),
@@ -159,6 +159,9 @@ Client::Client(EQStreamInterface* ieqs)
 	character_id = 0;
 	conn_state = NoPacketsReceived;
 	client_data_loaded = false;
+	item_bonuses_cached = false;
+	save_tracker = std::make_shared<EQEmu::SaveTracker>(SaveSectionCount);
+	save_tracker_total = 0;
 	feigned = false;
 	berserk = false;
 	dead = false;
@@ -386,6 +389,8 @@ Client::~Client() {
 	// we save right now, because the client might be zoning and the world
 	// will need this data right away
 	Save(2); // This fails when database destructor is called first on shutdown
+	// anything still queued for us has to be in before another zone loads this character
+	database.FlushAsyncQueries(CharacterID());
 
 	safe_delete(taskstate);
 	safe_delete(KarmaUpdateTimer);
@@ -585,17 +590,22 @@ bool Client::Save(uint8 iCommitNow) {
 	m_pp.mana = cur_mana;
 	m_pp.endurance = cur_end;
 
+	/* Only the sections that changed since the last save are written, in one transaction in the background */
+	save_tracker->Begin();
+	std::vector<std::string> queries;
+
 	/* Save Character Currency */
-	database.SaveCharacterCurrency(CharacterID(), &m_pp);
+	save_tracker->Add(SaveCurrencySection, database.CharacterCurrencyQuery(CharacterID(), &m_pp));
 
 	/* Save Current Bind Points */
 	auto regularBindPosition = glm::vec4(m_pp.binds[0].x, m_pp.binds[0].y, m_pp.binds[0].z, 0.0f);
 	auto homeBindPosition = glm::vec4(m_pp.binds[4].x, m_pp.binds[4].y, m_pp.binds[4].z, 0.0f);
-	database.SaveCharacterBindPoint(CharacterID(), m_pp.binds[0].zoneId, m_pp.binds[0].instance_id, regularBindPosition, 0); /* Regular bind */
-	database.SaveCharacterBindPoint(CharacterID(), m_pp.binds[4].zoneId, m_pp.binds[4].instance_id, homeBindPosition, 1); /* Home Bind */
+	save_tracker->Add(SaveRegularBindSection, database.CharacterBindPointQuery(CharacterID(), m_pp.binds[0].zoneId, m_pp.binds[0].instance_id, regularBindPosition, 0)); /* Regular bind */
+	save_tracker->Add(SaveHomeBindSection, database.CharacterBindPointQuery(CharacterID(), m_pp.binds[4].zoneId, m_pp.binds[4].instance_id, homeBindPosition, 1)); /* Home Bind */
 
 	/* Save Character Buffs */
-	database.SaveBuffs(this);
+	database.BuffsQueries(this, queries);
+	save_tracker->Add(SaveBuffsSection, queries);
 
 	/* Total Time Played */
 	TotalSecondsPlayed += (time(nullptr) - m_pp.lastlogin);
@@ -628,7 +638,9 @@ bool Client::Save(uint8 iCommitNow) {
 	} else {
 		memset(&m_petinfo, 0, sizeof(struct PetInfo));
 	}
-	database.SavePetInfo(this);
+	queries.clear();
+	database.PetInfoQueries(this, queries);
+	save_tracker->Add(SavePetsSection, queries);
 
 	if(tribute_timer.Enabled()) {
 		m_pp.tribute_time_remaining = tribute_timer.GetRemainingTime();
@@ -639,16 +651,54 @@ bool Client::Save(uint8 iCommitNow) {
 
 	p_timers.Store(&database);
 
-	database.SaveCharacterTribute(this->CharacterID(), &m_pp);
+	queries.clear();
+	database.CharacterTributeQueries(this->CharacterID(), &m_pp, queries);
+	save_tracker->Add(SaveTributeSection, queries);
 	SaveTaskState(); /* Save Character Task */
 
 	m_pp.hunger_level = EQEmu::Clamp(m_pp.hunger_level, 0, 50000);
 	m_pp.thirst_level = EQEmu::Clamp(m_pp.thirst_level, 0, 50000);
-	database.SaveCharacterData(this->CharacterID(), this->AccountID(), &m_pp, &m_epp); /* Save Character Data */
+	save_tracker->Add(SaveDataSection, database.CharacterDataQuery(this->CharacterID(), this->AccountID(), &m_pp, &m_epp)); /* Save Character Data */
+
+	CommitSave(iCommitNow == 2);
 
 	return true;
 }
 
+bool Client::SaveCurrency() {
+	// goes through the same queue as Save() so the writes land in order
+	save_tracker->Begin();
+	save_tracker->Add(SaveCurrencySection, database.CharacterCurrencyQuery(CharacterID(), &m_pp));
+	CommitSave(false);
+	return true;
+}
+
+void Client::CommitSave(bool wait) {
+	uint32 total = save_tracker->GetStatementsTotal() - save_tracker_total;
+	save_tracker_total = save_tracker->GetStatementsTotal();
+
+	std::vector<std::string> queries = save_tracker->Take();
+	Log.Out(Logs::Detail, Logs::None, "Save of %s writes %u of %u statements (%u of %u over %u saves)",
+		GetName(), (uint32)queries.size(), total, save_tracker->GetStatementsWritten(), save_tracker->GetStatementsTotal(), save_tracker->GetSaves());
+
+	if (!queries.empty()) {
+		std::shared_ptr<EQEmu::SaveTracker> tracker = save_tracker;
+		uint32 character_id = CharacterID();
+		database.QueryDatabaseBatchAsync(queries, character_id,
+			[tracker, character_id](MySQLRequestResult &results) {
+				if (results.Success())
+					return;
+
+				// the transaction was rolled back, the next save writes everything again
+				Log.Out(Logs::General, Logs::Error, "Save of character %u failed: %s", character_id, results.ErrorMessage().c_str());
+				tracker->Reset();
+			});
+	}
+
+	if (wait)
+		database.FlushAsyncQueries(CharacterID());
+}
+
 void Client::SaveBackup() {
 }
 
@@ -735,6 +785,21 @@ void Client::QueuePacket(const EQApplicationPacket* app, bool ack_req, CLIENT_CO
 			eqs->QueuePacket(app, ack_req);
 }
 
+void Client::QueueBroadcastPacket(EQStreamBroadcast &broadcast, const EQApplicationPacket* app, bool ack_req, CLIENT_CONN_STATUS required_state, eqFilterType filter) {
+	if(filter!=FilterNone){
+		if(GetFilter(filter) == FilterHide)
+			return; //Client has this filter on, no need to send packet
+	}
+
+	if (required_state != CLIENT_CONNECTINGALL && client_state != required_state) {
+		// packets for clients that aren't ready yet are held on to the same way QueuePacket does
+		AddPacket(app, ack_req);
+		return;
+	}
+
+	broadcast.AddStream(eqs);
+}
+
 void Client::FastQueuePacket(EQApplicationPacket** app, bool ack_req, CLIENT_CONN_STATUS required_state) {
 	// if the program doesnt care about the status or if the status isnt what we requested
 	if (required_state != CLIENT_CONNECTINGALL && client_state != required_state) {
@@ -2322,10 +2387,10 @@ void Client::CheckLanguageSkillIncrease(uint8 langid, uint8 TeacherSkill) {
 
 		if(zone->random.Real(0,100) < Chance) {	// if they make the roll
 			IncreaseLanguageSkill(langid);	// increase the language skill by 1
-			Log.Out(Logs::Detail, Logs::Skills, "Language %d at value %d successfully gain with %.4f%%chance", langid, LangSkill, Chance);
+			Log.Out(Logs::Detail, Logs::Skills, "Language %d at value %d successfully gain with %d%% chance", langid, LangSkill, Chance);
 		}
 		else
-			Log.Out(Logs::Detail, Logs::Skills, "Language %d at value %d failed to gain with %.4f%%chance", langid, LangSkill, Chance);
+			Log.Out(Logs::Detail, Logs::Skills, "Language %d at value %d failed to gain with %d%% chance", langid, LangSkill, Chance);
 	}
 }
 
@@ -8387,7 +8452,7 @@ std::string Client::TextLink::GenerateLink()
 		m_Error = true;
 		m_Link = "<LINKER ERROR>";
 		Log.Out(Logs::General, Logs::Error, "TextLink::GenerateLink() failed to generate a useable text link (LinkType: %i, Lengths: {link: %u, body: %u, text: %u})",
-			m_LinkType, m_Link.length(), m_LinkBody.length(), m_LinkText.length());
+			m_LinkType, (uint32)m_Link.length(), (uint32)m_LinkBody.length(), (uint32)m_LinkText.length());
 		Log.Out(Logs::General, Logs::Error, ">> LinkBody: %s", m_LinkBody.c_str());
 		Log.Out(Logs::General, Logs::Error, ">> LinkText: %s", m_LinkText.c_str());
 	}
@@ -35,6 +35,7 @@ struct Item_Struct;
 #include "../common/eq_packet_structs.h"
 #include "../common/eq_constants.h"
 #include "../common/eq_stream_intf.h"
+#include "../common/eq_stream_broadcast.h"
 #include "../common/eq_packet.h"
 #include "../common/linked_list.h"
 #include "../common/extprofile.h"
@@ -44,6 +45,7 @@ struct Item_Struct;
 #include "../common/guilds.h"
 #include "../common/item_struct.h"
 #include "../common/clientversions.h"
+#include "../common/save_tracker.h"
 
 #include "aa.h"
 #include "common.h"
@@ -292,6 +294,8 @@ public:
 	void SendPacketQueue(bool Block = true);
 	void QueuePacket(const EQApplicationPacket* app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
 	void FastQueuePacket(EQApplicationPacket** app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL);
+	// same rules as QueuePacket, but a client that can take the packet right away is added to the broadcast instead
+	void QueueBroadcastPacket(EQStreamBroadcast &broadcast, const EQApplicationPacket* app, bool ack_req = true, CLIENT_CONN_STATUS = CLIENT_CONNECTINGALL, eqFilterType filter=FilterNone);
 	void ChannelMessageReceived(uint8 chan_num, uint8 language, uint8 lang_skill, const char* orig_message, const char* targetname=nullptr);
 	void ChannelMessageSend(const char* from, const char* to, uint8 chan_num, uint8 language, const char* message, ...);
 	void ChannelMessageSend(const char* from, const char* to, uint8 chan_num, uint8 language, uint8 lang_skill, const char* message, ...);
@@ -320,7 +324,7 @@ public:
 					void SaveBackup();
 
 	/* New PP Save Functions */
-	bool SaveCurrency(){ return database.SaveCharacterCurrency(this->CharacterID(), &m_pp); }
+	bool SaveCurrency();
 	bool SaveAA();
 
 	inline bool ClientDataLoaded() const { return client_data_loaded; }
@@ -410,6 +414,7 @@ public:
 	*/
 
 	virtual void CalcBonuses();
+	virtual void CalcBuffBonuses();
 	//these are all precalculated now
 	inline virtual int32 GetAC() const { return AC; }
 	inline virtual int32 GetATK() const { return ATK + itembonuses.ATK + spellbonuses.ATK + ((GetSTR() + GetSkill(SkillOffense)) * 9 / 10); }
@@ -1264,6 +1269,10 @@ protected:
 	void CalcAABonuses(StatBonuses* newbon);
 	void ApplyAABonuses(uint32 aaid, uint32 slots, StatBonuses* newbon);
 	void ProcessItemCaps();
+	void CalcBonusStats();
+	void CheckBuffBonuses();
+	StatBonuses uncapped_itembonuses; // item bonuses before ProcessItemCaps, reused by CalcBuffBonuses
+	bool item_bonuses_cached;
 	void MakeBuffFadePacket(uint16 spell_id, int slot_id, bool send_message = true);
 	bool client_data_loaded;
 
@@ -1411,6 +1420,21 @@ private:
 	Object* m_tradeskill_object;
 	PetInfo m_petinfo; // current pet data, used while loading from and saving to DB
 	PetInfo m_suspendedminion; // pet data for our suspended minion.
+
+	/* Parts of the character Save() writes, only the ones that changed since the last save are sent */
+	enum SaveSection {
+		SaveCurrencySection,
+		SaveRegularBindSection,
+		SaveHomeBindSection,
+		SaveBuffsSection,
+		SavePetsSection,
+		SaveTributeSection,
+		SaveDataSection,
+		SaveSectionCount
+	};
+	std::shared_ptr<EQEmu::SaveTracker> save_tracker; // shared with the write callbacks, which can outlive us
+	uint32 save_tracker_total;
+	void CommitSave(bool wait);
 	MercInfo m_mercinfo[MAXMERCS]; // current mercenary
 	InspectMessage_Struct m_inspect_message;
 
@@ -1442,7 +1466,7 @@ private:
 	uint8 position_timer_counter;
 
 	PTimerList p_timers; //persistent timers
-	Timer hpupdate_timer;
+	EQEmu::WheelTimer hpupdate_timer;
 	Timer camp_timer;
 	Timer process_timer;
 	Timer stamina_timer;
@@ -43,6 +43,7 @@
 #include "../common/guilds.h"
 #include "../common/rdtsc.h"
 #include "../common/rulesys.h"
+#include "../common/scope_profiler.h"
 #include "../common/skills.h"
 #include "../common/spdat.h"
 #include "../common/string_util.h"
@@ -401,6 +402,19 @@ void ClearMappedOpcode(EmuOpcode op)
 	}
 }
 
+extern EQEmu::ScopeProfiler zone_profiler;
+
+static uint32 OpcodeScope(EmuOpcode opcode)
+{
+	if (!zone_profiler.IsEnabled())
+		return EQEmu::ScopeProfiler::NoScope;
+
+	static uint32 family = zone_profiler.AddFamily();
+	return zone_profiler.GetScope(family, opcode, [](uint32 key) {
+		return std::string("opcode ") + (key < _maxEmuOpcode ? OpcodeNames[key] : "unknown");
+	});
+}
+
 // client methods
 int Client::HandlePacket(const EQApplicationPacket *app)
 {
@@ -421,6 +435,8 @@ int Client::HandlePacket(const EQApplicationPacket *app)
 		return true;
 	}
 
+	EQEmu::ScopeProfiler::Timer profile_timer(zone_profiler, OpcodeScope(opcode));
+
 	#if EQDEBUG >= 9
 		std::cout << "Received 0x" << std::hex << std::setw(4) << std::setfill('0') << opcode << ", size=" << std::dec << app->size << std::endl;
 	#endif
@@ -972,7 +988,7 @@ void Client::Handle_Connect_OP_ApproveZone(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ApproveZone_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size on OP_ApproveZone: Expected %i, Got %i",
-			sizeof(ApproveZone_Struct), app->size);
+			(int)sizeof(ApproveZone_Struct), app->size);
 		return;
 	}
 	ApproveZone_Struct* azone = (ApproveZone_Struct*)app->pBuffer;
@@ -985,7 +1001,7 @@ void Client::Handle_Connect_OP_ClientError(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ClientError_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size on OP_ClientError: Expected %i, Got %i",
-			sizeof(ClientError_Struct), app->size);
+			(int)sizeof(ClientError_Struct), app->size);
 		return;
 	}
 	// Client reporting error to server
@@ -1141,7 +1157,7 @@ void Client::Handle_Connect_OP_TGB(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(uint32)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size on OP_TGB: Expected %i, Got %i",
-			sizeof(uint32), app->size);
+			(int)sizeof(uint32), app->size);
 		return;
 	}
 	OPTGB(app);
@@ -1200,7 +1216,7 @@ void Client::Handle_Connect_OP_ZoneEntry(const EQApplicationPacket *app)
 	m_ClientVersionBit = ClientBitFromVersion(Connection()->GetClientVersion());
 
 	bool siv = m_inv.SetInventoryVersion(m_ClientVersion);
-	Log.Out(Logs::General, Logs::None, "%s inventory version to %s(%i)", (siv ? "Succeeded in setting" : "Failed to set"), ClientVersionName(m_ClientVersion), m_ClientVersion);
+	Log.Out(Logs::General, Logs::None, "%s inventory version to %s(%i)", (siv ? "Succeeded in setting" : "Failed to set"), ClientVersionName(m_ClientVersion), (int)m_ClientVersion);
 
 	/* Antighost code
 		tmp var is so the search doesnt find this object
@@ -1821,7 +1837,7 @@ void Client::Handle_OP_AcceptNewTask(const EQApplicationPacket *app)
 
 	if (app->size != sizeof(AcceptNewTask_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_AcceptNewTask expected %i got %i",
-			sizeof(AcceptNewTask_Struct), app->size);
+			(int)sizeof(AcceptNewTask_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -1890,7 +1906,7 @@ void Client::Handle_OP_AdventureMerchantPurchase(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Adventure_Purchase_Struct))
 	{
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_AdventureMerchantPurchase expected:%i got:%i", sizeof(Adventure_Purchase_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_AdventureMerchantPurchase expected:%i got:%i", (int)sizeof(Adventure_Purchase_Struct), app->size);
 		return;
 	}
 
@@ -2070,7 +2086,7 @@ void Client::Handle_OP_AdventureMerchantRequest(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(AdventureMerchant_Struct))
 	{
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_AdventureMerchantRequest expected:%i got:%i", sizeof(AdventureMerchant_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_AdventureMerchantRequest expected:%i got:%i", (int)sizeof(AdventureMerchant_Struct), app->size);
 		return;
 	}
 	std::stringstream ss(std::stringstream::in | std::stringstream::out);
@@ -2161,7 +2177,7 @@ void Client::Handle_OP_AdventureMerchantSell(const EQApplicationPacket *app)
 	if (app->size != sizeof(Adventure_Sell_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch on OP_AdventureMerchantSell: got %u expected %u",
-			app->size, sizeof(Adventure_Sell_Struct));
+			app->size, (uint32)sizeof(Adventure_Sell_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -2820,7 +2836,7 @@ void Client::Handle_OP_Animation(const EQApplicationPacket *app)
 	if (app->size != sizeof(Animation_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Received invalid sized "
 			"OP_Animation: got %d, expected %d", app->size,
-			sizeof(Animation_Struct));
+			(int)sizeof(Animation_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -2837,7 +2853,7 @@ void Client::Handle_OP_Animation(const EQApplicationPacket *app)
 void Client::Handle_OP_ApplyPoison(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ApplyPoison_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ApplyPoison, size=%i, expected %i", app->size, sizeof(ApplyPoison_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ApplyPoison, size=%i, expected %i", app->size, (int)sizeof(ApplyPoison_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -2889,7 +2905,7 @@ void Client::Handle_OP_ApplyPoison(const EQApplicationPacket *app)
 void Client::Handle_OP_Assist(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(EntityId_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Assist expected %i got %i", sizeof(EntityId_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Assist expected %i got %i", (int)sizeof(EntityId_Struct), app->size);
 		return;
 	}
 
@@ -2919,7 +2935,7 @@ void Client::Handle_OP_Assist(const EQApplicationPacket *app)
 void Client::Handle_OP_AssistGroup(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(EntityId_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_AssistGroup expected %i got %i", sizeof(EntityId_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_AssistGroup expected %i got %i", (int)sizeof(EntityId_Struct), app->size);
 		return;
 	}
 	QueuePacket(app);
@@ -2933,7 +2949,7 @@ void Client::Handle_OP_AugmentInfo(const EQApplicationPacket *app)
 
 	if (app->size != sizeof(AugmentInfo_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_AugmentInfo expected %i got %i",
-			sizeof(AugmentInfo_Struct), app->size);
+			(int)sizeof(AugmentInfo_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -2952,7 +2968,7 @@ void Client::Handle_OP_AugmentItem(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(AugmentItem_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for AugmentItem_Struct: Expected: %i, Got: %i",
-			sizeof(AugmentItem_Struct), app->size);
+			(int)sizeof(AugmentItem_Struct), app->size);
 		return;
 	}
 
@@ -3160,7 +3176,7 @@ void Client::Handle_OP_AutoAttack2(const EQApplicationPacket *app)
 void Client::Handle_OP_AutoFire(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(bool)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_AutoFire expected %i got %i", sizeof(bool), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_AutoFire expected %i got %i", (int)sizeof(bool), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -3176,7 +3192,7 @@ void Client::Handle_OP_Bandolier(const EQApplicationPacket *app)
 	//
 	if (app->size != sizeof(BandolierCreate_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Bandolier expected %i got %i",
-			sizeof(BandolierCreate_Struct), app->size);
+			(int)sizeof(BandolierCreate_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -3204,7 +3220,7 @@ void Client::Handle_OP_BankerChange(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(BankerChange_Struct) && app->size != 4) //Titanium only sends 4 Bytes for this
 	{
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_BankerChange expected %i got %i", sizeof(BankerChange_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_BankerChange expected %i got %i", (int)sizeof(BankerChange_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -3445,7 +3461,7 @@ void Client::Handle_OP_BazaarInspect(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(BazaarInspect_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for BazaarInspect_Struct: Expected %i, Got %i",
-			sizeof(BazaarInspect_Struct), app->size);
+			(int)sizeof(BazaarInspect_Struct), app->size);
 		return;
 	}
 
@@ -3498,7 +3514,7 @@ void Client::Handle_OP_BazaarSearch(const EQApplicationPacket *app)
 		return;
 	}
 	else {
-		Log.Out(Logs::Detail, Logs::Trading, "Malformed BazaarSearch_Struct packe, Action %it received, ignoring...");
+		Log.Out(Logs::Detail, Logs::Trading, "Malformed BazaarSearch_Struct packet, size %i, ignoring...", app->size);
 		Log.Out(Logs::General, Logs::Error, "Malformed BazaarSearch_Struct packet received, ignoring...\n");
 	}
 
@@ -3607,7 +3623,7 @@ void Client::Handle_OP_BlockedBuffs(const EQApplicationPacket *app)
 	if (app->size != sizeof(BlockedBuffs_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_BlockedBuffs expected %i got %i",
-			sizeof(BlockedBuffs_Struct), app->size);
+			(int)sizeof(BlockedBuffs_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -3722,7 +3738,7 @@ void Client::Handle_OP_Buff(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(SpellBuffFade_Struct))
 	{
-		Log.Out(Logs::General, Logs::Error, "Size mismatch in OP_Buff. expected %i got %i", sizeof(SpellBuffFade_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "Size mismatch in OP_Buff. expected %i got %i", (int)sizeof(SpellBuffFade_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -3805,7 +3821,7 @@ void Client::Handle_OP_CancelTask(const EQApplicationPacket *app)
 
 	if (app->size != sizeof(CancelTask_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_CancelTask expected %i got %i",
-			sizeof(CancelTask_Struct), app->size);
+			(int)sizeof(CancelTask_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -3818,7 +3834,7 @@ void Client::Handle_OP_CancelTask(const EQApplicationPacket *app)
 void Client::Handle_OP_CancelTrade(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(CancelTrade_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_CancelTrade, size=%i, expected %i", app->size, sizeof(CancelTrade_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_CancelTrade, size=%i, expected %i", app->size, (int)sizeof(CancelTrade_Struct));
 		return;
 	}
 	Mob* with = trade->With();
@@ -4081,7 +4097,7 @@ void Client::Handle_OP_ClearSurname(const EQApplicationPacket *app)
 void Client::Handle_OP_ClickDoor(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ClickDoor_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ClickDoor, size=%i, expected %i", app->size, sizeof(ClickDoor_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ClickDoor, size=%i, expected %i", app->size, (int)sizeof(ClickDoor_Struct));
 		return;
 	}
 	ClickDoor_Struct* cd = (ClickDoor_Struct*)app->pBuffer;
@@ -4107,7 +4123,7 @@ void Client::Handle_OP_ClickObject(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ClickObject_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size on ClickObject_Struct: Expected %i, Got %i",
-			sizeof(ClickObject_Struct), app->size);
+			(int)sizeof(ClickObject_Struct), app->size);
 		return;
 	}
 
@@ -4158,7 +4174,7 @@ void Client::Handle_OP_ClickObjectAction(const EQApplicationPacket *app)
 	{
 		if (app->size != sizeof(ClickObjectAction_Struct)) {
 			Log.Out(Logs::General, Logs::Error, "Invalid size on OP_ClickObjectAction: Expected %i, Got %i",
-				sizeof(ClickObjectAction_Struct), app->size);
+				(int)sizeof(ClickObjectAction_Struct), app->size);
 			return;
 		}
 
@@ -4213,7 +4229,7 @@ void Client::Handle_OP_ClientUpdate(const EQApplicationPacket *app)
 	if (app->size != sizeof(PlayerPositionUpdateClient_Struct)
 	&& app->size != (sizeof(PlayerPositionUpdateClient_Struct)+1)
 	) {
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_ClientUpdate expected:%i got:%i", sizeof(PlayerPositionUpdateClient_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_ClientUpdate expected:%i got:%i", (int)sizeof(PlayerPositionUpdateClient_Struct), app->size);
 		return;
 	}
 	PlayerPositionUpdateClient_Struct* ppu = (PlayerPositionUpdateClient_Struct*)app->pBuffer;
@@ -4552,7 +4568,7 @@ void Client::Handle_OP_Consider(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Consider_Struct))
 	{
-		Log.Out(Logs::General, Logs::None, "Size mismatch in Consider expected %i got %i", sizeof(Consider_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in Consider expected %i got %i", (int)sizeof(Consider_Struct), app->size);
 		return;
 	}
 	Consider_Struct* conin = (Consider_Struct*)app->pBuffer;
@@ -4646,7 +4662,7 @@ void Client::Handle_OP_ConsiderCorpse(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Consider_Struct))
 	{
-		Log.Out(Logs::General, Logs::None, "Size mismatch in Consider corpse expected %i got %i", sizeof(Consider_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in Consider corpse expected %i got %i", (int)sizeof(Consider_Struct), app->size);
 		return;
 	}
 	Consider_Struct* conin = (Consider_Struct*)app->pBuffer;
@@ -4706,7 +4722,7 @@ void Client::Handle_OP_Consume(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Consume_Struct))
 	{
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_Consume expected:%i got:%i", sizeof(Consume_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_Consume expected:%i got:%i", (int)sizeof(Consume_Struct), app->size);
 		return;
 	}
 	Consume_Struct* pcs = (Consume_Struct*)app->pBuffer;
@@ -4776,7 +4792,7 @@ void Client::Handle_OP_Consume(const EQApplicationPacket *app)
 void Client::Handle_OP_ControlBoat(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ControlBoat_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ControlBoat, size=%i, expected %i", app->size, sizeof(ControlBoat_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ControlBoat, size=%i, expected %i", app->size, (int)sizeof(ControlBoat_Struct));
 		return;
 	}
 	ControlBoat_Struct* cbs = (ControlBoat_Struct*)app->pBuffer;
@@ -4933,7 +4949,7 @@ void Client::Handle_OP_Damage(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(CombatDamage_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Received invalid sized OP_Damage: got %d, expected %d", app->size,
-			sizeof(CombatDamage_Struct));
+			(int)sizeof(CombatDamage_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -4971,7 +4987,7 @@ void Client::Handle_OP_DelegateAbility(const EQApplicationPacket *app)
 	if (app->size != sizeof(DelegateAbility_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_DelegateAbility expected %i got %i",
-			sizeof(DelegateAbility_Struct), app->size);
+			(int)sizeof(DelegateAbility_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -5147,7 +5163,7 @@ void Client::Handle_OP_DoGroupLeadershipAbility(const EQApplicationPacket *app)
 	if (app->size != sizeof(DoGroupLeadershipAbility_Struct)) {
 
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_DoGroupLeadershipAbility expected %i got %i",
-			sizeof(DoGroupLeadershipAbility_Struct), app->size);
+			(int)sizeof(DoGroupLeadershipAbility_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -5282,7 +5298,7 @@ void Client::Handle_OP_Emote(const EQApplicationPacket *app)
 	if (app->size != sizeof(Emote_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Received invalid sized "
 			"OP_Emote: got %d, expected %d", app->size,
-			sizeof(Emote_Struct));
+			(int)sizeof(Emote_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -5372,7 +5388,7 @@ void Client::Handle_OP_EnvDamage(const EQApplicationPacket *app)
 
 	if (app->size != sizeof(EnvDamage2_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Received invalid sized OP_EnvDamage: got %d, expected %d", app->size,
-			sizeof(EnvDamage2_Struct));
+			(int)sizeof(EnvDamage2_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -5434,7 +5450,7 @@ void Client::Handle_OP_FaceChange(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(FaceChange_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for OP_FaceChange: Expected: %i, Got: %i",
-			sizeof(FaceChange_Struct), app->size);
+			(int)sizeof(FaceChange_Struct), app->size);
 		return;
 	}
 
@@ -5700,7 +5716,7 @@ void Client::Handle_OP_GMBecomeNPC(const EQApplicationPacket *app)
 		return;
 	}
 	if (app->size != sizeof(BecomeNPC_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMBecomeNPC, size=%i, expected %i", app->size, sizeof(BecomeNPC_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMBecomeNPC, size=%i, expected %i", app->size, (int)sizeof(BecomeNPC_Struct));
 		return;
 	}
 	//entity_list.QueueClients(this, app, false);
@@ -5752,7 +5768,7 @@ void Client::Handle_OP_GMEmoteZone(const EQApplicationPacket *app)
 		return;
 	}
 	if (app->size != sizeof(GMEmoteZone_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMEmoteZone, size=%i, expected %i", app->size, sizeof(GMEmoteZone_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMEmoteZone, size=%i, expected %i", app->size, (int)sizeof(GMEmoteZone_Struct));
 		return;
 	}
 	GMEmoteZone_Struct* gmez = (GMEmoteZone_Struct*)app->pBuffer;
@@ -5769,7 +5785,7 @@ void Client::Handle_OP_GMEmoteZone(const EQApplicationPacket *app)
 void Client::Handle_OP_GMEndTraining(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GMTrainEnd_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GMEndTraining expected %i got %i", sizeof(GMTrainEnd_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GMEndTraining expected %i got %i", (int)sizeof(GMTrainEnd_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -5785,7 +5801,7 @@ void Client::Handle_OP_GMFind(const EQApplicationPacket *app)
 		return;
 	}
 	if (app->size != sizeof(GMSummon_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMFind, size=%i, expected %i", app->size, sizeof(GMSummon_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMFind, size=%i, expected %i", app->size, (int)sizeof(GMSummon_Struct));
 		return;
 	}
 	//Break down incoming
@@ -5850,7 +5866,7 @@ void Client::Handle_OP_GMHideMe(const EQApplicationPacket *app)
 		return;
 	}
 	if (app->size != sizeof(SpawnAppearance_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMHideMe, size=%i, expected %i", app->size, sizeof(SpawnAppearance_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMHideMe, size=%i, expected %i", app->size, (int)sizeof(SpawnAppearance_Struct));
 		return;
 	}
 	SpawnAppearance_Struct* sa = (SpawnAppearance_Struct*)app->pBuffer;
@@ -5900,7 +5916,7 @@ void Client::Handle_OP_GMKill(const EQApplicationPacket *app)
 		return;
 	}
 	if (app->size != sizeof(GMKill_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMKill, size=%i, expected %i", app->size, sizeof(GMKill_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMKill, size=%i, expected %i", app->size, (int)sizeof(GMKill_Struct));
 		return;
 	}
 	GMKill_Struct* gmk = (GMKill_Struct *)app->pBuffer;
@@ -5967,7 +5983,7 @@ void Client::Handle_OP_GMLastName(const EQApplicationPacket *app)
 void Client::Handle_OP_GMNameChange(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GMName_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMNameChange, size=%i, expected %i", app->size, sizeof(GMName_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GMNameChange, size=%i, expected %i", app->size, (int)sizeof(GMName_Struct));
 		return;
 	}
 	const GMName_Struct* gmn = (const GMName_Struct *)app->pBuffer;
@@ -6020,7 +6036,7 @@ void Client::Handle_OP_GMSearchCorpse(const EQApplicationPacket *app)
 	if (app->size < sizeof(GMSearchCorpse_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "OP_GMSearchCorpse size lower than expected: got %u expected at least %u",
-			app->size, sizeof(GMSearchCorpse_Struct));
+			app->size, (uint32)sizeof(GMSearchCorpse_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -6141,7 +6157,7 @@ void Client::Handle_OP_GMToggle(const EQApplicationPacket *app)
 void Client::Handle_OP_GMTraining(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GMTrainee_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GMTraining expected %i got %i", sizeof(GMTrainee_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GMTraining expected %i got %i", (int)sizeof(GMTrainee_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -6152,7 +6168,7 @@ void Client::Handle_OP_GMTraining(const EQApplicationPacket *app)
 void Client::Handle_OP_GMTrainSkill(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GMSkillChange_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GMTrainSkill expected %i got %i", sizeof(GMSkillChange_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GMTrainSkill expected %i got %i", (int)sizeof(GMSkillChange_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -6220,7 +6236,7 @@ void Client::Handle_OP_GMZoneRequest2(const EQApplicationPacket *app)
 		return;
 	}
 	if (app->size < sizeof(uint32)) {
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_GMZoneRequest2 expected:%i got:%i", sizeof(uint32), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_GMZoneRequest2 expected:%i got:%i", (int)sizeof(uint32), app->size);
 		return;
 	}
 
@@ -6238,7 +6254,7 @@ void Client::Handle_OP_GroupCancelInvite(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GroupCancel_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for OP_GroupCancelInvite: Expected: %i, Got: %i",
-			sizeof(GroupCancel_Struct), app->size);
+			(int)sizeof(GroupCancel_Struct), app->size);
 		return;
 	}
 
@@ -6282,7 +6298,7 @@ void Client::Handle_OP_GroupDisband(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GroupGeneric_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for GroupGeneric_Struct: Expected: %i, Got: %i",
-			sizeof(GroupGeneric_Struct), app->size);
+			(int)sizeof(GroupGeneric_Struct), app->size);
 		return;
 	}
 
@@ -6449,7 +6465,7 @@ void Client::Handle_OP_GroupFollow2(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GroupGeneric_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for OP_GroupFollow: Expected: %i, Got: %i",
-			sizeof(GroupGeneric_Struct), app->size);
+			(int)sizeof(GroupGeneric_Struct), app->size);
 		return;
 	}
 
@@ -6498,7 +6514,7 @@ void Client::Handle_OP_GroupInvite2(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GroupInvite_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for OP_GroupInvite: Expected: %i, Got: %i",
-			sizeof(GroupInvite_Struct), app->size);
+			(int)sizeof(GroupInvite_Struct), app->size);
 		return;
 	}
 
@@ -6575,7 +6591,7 @@ void Client::Handle_OP_GroupMakeLeader(const EQApplicationPacket *app)
 void Client::Handle_OP_GroupMentor(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GroupMentor_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GroupMentor, size=%i, expected %i", app->size, sizeof(GroupMentor_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GroupMentor, size=%i, expected %i", app->size, (int)sizeof(GroupMentor_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -6611,7 +6627,7 @@ void Client::Handle_OP_GroupMentor(const EQApplicationPacket *app)
 void Client::Handle_OP_GroupRoles(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(GroupRole_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GroupRoles, size=%i, expected %i", app->size, sizeof(GroupRole_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GroupRoles, size=%i, expected %i", app->size, (int)sizeof(GroupRole_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -6658,7 +6674,7 @@ void Client::Handle_OP_GroupUpdate(const EQApplicationPacket *app)
 	if (app->size != sizeof(GroupUpdate_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch on OP_GroupUpdate: got %u expected %u",
-			app->size, sizeof(GroupUpdate_Struct));
+			app->size, (uint32)sizeof(GroupUpdate_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -6705,7 +6721,7 @@ void Client::Handle_OP_GuildBank(const EQApplicationPacket *app)
 	}
 
 	if (app->size < sizeof(uint32)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GuildBank, size=%i, expected %i", app->size, sizeof(uint32));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_GuildBank, size=%i, expected %i", app->size, (int)sizeof(uint32));
 		DumpPacket(app);
 		return;
 	}
@@ -7089,7 +7105,7 @@ void Client::Handle_OP_GuildDemote(const EQApplicationPacket *app)
 	Log.Out(Logs::Detail, Logs::Guilds, "Received OP_GuildDemote");
 
 	if (app->size != sizeof(GuildDemoteStruct)) {
-		Log.Out(Logs::Detail, Logs::Guilds, "Error: app size of %i != size of GuildDemoteStruct of %i\n", app->size, sizeof(GuildDemoteStruct));
+		Log.Out(Logs::Detail, Logs::Guilds, "Error: app size of %i != size of GuildDemoteStruct of %i\n", app->size, (int)sizeof(GuildDemoteStruct));
 		return;
 	}
 
@@ -7429,7 +7445,7 @@ void Client::Handle_OP_GuildManageBanker(const EQApplicationPacket *app)
 
 	Log.Out(Logs::Detail, Logs::Guilds, "Got OP_GuildManageBanker of len %d", app->size);
 	if (app->size != sizeof(GuildManageBanker_Struct)) {
-		Log.Out(Logs::Detail, Logs::Guilds, "Error: app size of %i != size of OP_GuildManageBanker of %i\n", app->size, sizeof(GuildManageBanker_Struct));
+		Log.Out(Logs::Detail, Logs::Guilds, "Error: app size of %i != size of OP_GuildManageBanker of %i\n", app->size, (int)sizeof(GuildManageBanker_Struct));
 		return;
 	}
 	GuildManageBanker_Struct* gmb = (GuildManageBanker_Struct*)app->pBuffer;
@@ -7513,7 +7529,7 @@ void Client::Handle_OP_GuildPromote(const EQApplicationPacket *app)
 	Log.Out(Logs::Detail, Logs::Guilds, "Received OP_GuildPromote");
 
 	if (app->size != sizeof(GuildPromoteStruct)) {
-		Log.Out(Logs::Detail, Logs::Guilds, "Error: app size of %i != size of GuildDemoteStruct of %i\n", app->size, sizeof(GuildPromoteStruct));
+		Log.Out(Logs::Detail, Logs::Guilds, "Error: app size of %i != size of GuildDemoteStruct of %i\n", app->size, (int)sizeof(GuildPromoteStruct));
 		return;
 	}
 
@@ -7670,7 +7686,7 @@ void Client::Handle_OP_GuildStatus(const EQApplicationPacket *app)
 	if (app->size != sizeof(GuildStatus_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GuildStatus expected %i got %i",
-			sizeof(GuildStatus_Struct), app->size);
+			(int)sizeof(GuildStatus_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -7727,7 +7743,7 @@ void Client::Handle_OP_GuildUpdateURLAndChannel(const EQApplicationPacket *app)
 	if (app->size != sizeof(GuildUpdateURLAndChannel_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_GuildUpdateURLAndChannel expected %i got %i",
-			sizeof(GuildUpdateURLAndChannel_Struct), app->size);
+			(int)sizeof(GuildUpdateURLAndChannel_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -7831,7 +7847,7 @@ void Client::Handle_OP_HideCorpse(const EQApplicationPacket *app)
 	if (app->size != sizeof(HideCorpse_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_HideCorpse expected %i got %i",
-			sizeof(HideCorpse_Struct), app->size);
+			(int)sizeof(HideCorpse_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -7860,7 +7876,7 @@ void Client::Handle_OP_Illusion(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Illusion_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Received invalid sized OP_Illusion: got %d, expected %d", app->size,
-			sizeof(Illusion_Struct));
+			(int)sizeof(Illusion_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -7889,7 +7905,7 @@ void Client::Handle_OP_InspectAnswer(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(InspectResponse_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_InspectAnswer, size=%i, expected %i", app->size, sizeof(InspectResponse_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_InspectAnswer, size=%i, expected %i", app->size, (int)sizeof(InspectResponse_Struct));
 		return;
 	}
 
@@ -7944,7 +7960,7 @@ void Client::Handle_OP_InspectMessageUpdate(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(InspectMessage_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_InspectMessageUpdate, size=%i, expected %i", app->size, sizeof(InspectMessage_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_InspectMessageUpdate, size=%i, expected %i", app->size, (int)sizeof(InspectMessage_Struct));
 		return;
 	}
 
@@ -7958,7 +7974,7 @@ void Client::Handle_OP_InspectRequest(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(Inspect_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_InspectRequest, size=%i, expected %i", app->size, sizeof(Inspect_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_InspectRequest, size=%i, expected %i", app->size, (int)sizeof(Inspect_Struct));
 		return;
 	}
 
@@ -7995,7 +8011,7 @@ void Client::Handle_OP_InstillDoubt(const EQApplicationPacket *app)
 void Client::Handle_OP_ItemLinkClick(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ItemViewRequest_Struct)){
-		Log.Out(Logs::General, Logs::Error, "Wrong size on OP_ItemLinkClick. Got: %i, Expected: %i", app->size, sizeof(ItemViewRequest_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size on OP_ItemLinkClick. Got: %i, Expected: %i", app->size, (int)sizeof(ItemViewRequest_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -8095,7 +8111,7 @@ void Client::Handle_OP_ItemLinkClick(const EQApplicationPacket *app)
 void Client::Handle_OP_ItemLinkResponse(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(LDONItemViewRequest_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_ItemLinkResponse expected:%i got:%i", sizeof(LDONItemViewRequest_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_ItemLinkResponse expected:%i got:%i", (int)sizeof(LDONItemViewRequest_Struct), app->size);
 		return;
 	}
 	LDONItemViewRequest_Struct* item = (LDONItemViewRequest_Struct*)app->pBuffer;
@@ -8111,7 +8127,7 @@ void Client::Handle_OP_ItemName(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ItemNamePacket_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for ItemNamePacket_Struct: Expected: %i, Got: %i",
-			sizeof(ItemNamePacket_Struct), app->size);
+			(int)sizeof(ItemNamePacket_Struct), app->size);
 		return;
 	}
 	ItemNamePacket_Struct *p = (ItemNamePacket_Struct*)app->pBuffer;
@@ -8308,7 +8324,7 @@ void Client::Handle_OP_ItemVerifyRequest(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ItemVerifyRequest_Struct))
 	{
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_ItemVerifyRequest expected:%i got:%i", sizeof(ItemVerifyRequest_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_ItemVerifyRequest expected:%i got:%i", (int)sizeof(ItemVerifyRequest_Struct), app->size);
 		return;
 	}
 
@@ -8761,7 +8777,7 @@ void Client::Handle_OP_LFGGetMatchesRequest(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(LFGGetMatchesRequest_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LFGGetMatchesRequest, size=%i, expected %i", app->size, sizeof(LFGGetMatchesRequest_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LFGGetMatchesRequest, size=%i, expected %i", app->size, (int)sizeof(LFGGetMatchesRequest_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -8921,7 +8937,7 @@ void Client::Handle_OP_LFPCommand(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(LFP_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LFPCommand, size=%i, expected %i", app->size, sizeof(LFP_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LFPCommand, size=%i, expected %i", app->size, (int)sizeof(LFP_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -8983,7 +8999,7 @@ void Client::Handle_OP_LFPGetMatchesRequest(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(LFPGetMatchesRequest_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LFPGetMatchesRequest, size=%i, expected %i", app->size, sizeof(LFPGetMatchesRequest_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LFPGetMatchesRequest, size=%i, expected %i", app->size, (int)sizeof(LFPGetMatchesRequest_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -9037,7 +9053,7 @@ void Client::Handle_OP_Logout(const EQApplicationPacket *app)
 void Client::Handle_OP_LootItem(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(LootingItem_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LootItem, size=%i, expected %i", app->size, sizeof(LootingItem_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_LootItem, size=%i, expected %i", app->size, (int)sizeof(LootingItem_Struct));
 		return;
 	}
 
@@ -9214,7 +9230,7 @@ void Client::Handle_OP_MercenaryCommand(const EQApplicationPacket *app)
 	if (app->size != sizeof(MercenaryCommand_Struct))
 	{
 		Message(13, "Size mismatch in OP_MercenaryCommand expected %i got %i", sizeof(MercenaryCommand_Struct), app->size);
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_MercenaryCommand expected %i got %i", sizeof(MercenaryCommand_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_MercenaryCommand expected %i got %i", (int)sizeof(MercenaryCommand_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -9444,7 +9460,7 @@ void Client::Handle_OP_MercenaryHire(const EQApplicationPacket *app)
 	// The payload is 16 bytes. First four bytes are the Merc ID (Template ID)
 	if (app->size != sizeof(MercenaryMerchantRequest_Struct))
 	{
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_MercenaryHire expected %i got %i", sizeof(MercenaryMerchantRequest_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_MercenaryHire expected %i got %i", (int)sizeof(MercenaryMerchantRequest_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -9515,7 +9531,7 @@ void Client::Handle_OP_MercenarySuspendRequest(const EQApplicationPacket *app)
 	if (app->size != sizeof(SuspendMercenary_Struct))
 	{
 		Message(13, "Size mismatch in OP_MercenarySuspendRequest expected %i got %i", sizeof(SuspendMercenary_Struct), app->size);
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_MercenarySuspendRequest expected %i got %i", sizeof(SuspendMercenary_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_MercenarySuspendRequest expected %i got %i", (int)sizeof(SuspendMercenary_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -9575,7 +9591,7 @@ void Client::Handle_OP_MercenaryTimerRequest(const EQApplicationPacket *app)
 void Client::Handle_OP_MoveCoin(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(MoveCoin_Struct)){
-		Log.Out(Logs::General, Logs::Error, "Wrong size on OP_MoveCoin. Got: %i, Expected: %i", app->size, sizeof(MoveCoin_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size on OP_MoveCoin. Got: %i, Expected: %i", app->size, (int)sizeof(MoveCoin_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -9591,7 +9607,7 @@ void Client::Handle_OP_MoveItem(const EQApplicationPacket *app)
 	}
 
 	if (app->size != sizeof(MoveItem_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_MoveItem, size=%i, expected %i", app->size, sizeof(MoveItem_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_MoveItem, size=%i, expected %i", app->size, (int)sizeof(MoveItem_Struct));
 		return;
 	}
 
@@ -9744,7 +9760,7 @@ void Client::Handle_OP_PDeletePetition(const EQApplicationPacket *app)
 void Client::Handle_OP_PetCommands(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(PetCommand_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_PetCommands, size=%i, expected %i", app->size, sizeof(PetCommand_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_PetCommands, size=%i, expected %i", app->size, (int)sizeof(PetCommand_Struct));
 		return;
 	}
 	char val1[20] = { 0 };
@@ -10210,7 +10226,7 @@ void Client::Handle_OP_PetitionBug(const EQApplicationPacket *app)
 void Client::Handle_OP_PetitionCheckIn(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Petition_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_PetitionCheckIn, size=%i, expected %i", app->size, sizeof(Petition_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_PetitionCheckIn, size=%i, expected %i", app->size, (int)sizeof(Petition_Struct));
 		return;
 	}
 	Petition_Struct* inpet = (Petition_Struct*)app->pBuffer;
@@ -10254,7 +10270,7 @@ void Client::Handle_OP_PetitionCheckout(const EQApplicationPacket *app)
 void Client::Handle_OP_PetitionDelete(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(PetitionUpdate_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_PetitionDelete, size=%i, expected %i", app->size, sizeof(PetitionUpdate_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_PetitionDelete, size=%i, expected %i", app->size, (int)sizeof(PetitionUpdate_Struct));
 		return;
 	}
 	EQApplicationPacket* outapp = new EQApplicationPacket(OP_PetitionUpdate, sizeof(PetitionUpdate_Struct));
@@ -10395,7 +10411,7 @@ void Client::Handle_OP_PopupResponse(const EQApplicationPacket *app)
 
 	if (app->size != sizeof(PopupResponse_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_PopupResponse expected %i got %i",
-			sizeof(PopupResponse_Struct), app->size);
+			(int)sizeof(PopupResponse_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -10430,7 +10446,7 @@ void Client::Handle_OP_PotionBelt(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(MovePotionToBelt_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_PotionBelt expected %i got %i",
-			sizeof(MovePotionToBelt_Struct), app->size);
+			(int)sizeof(MovePotionToBelt_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -10551,7 +10567,7 @@ void Client::Handle_OP_PVPLeaderBoardDetailsRequest(const EQApplicationPacket *a
 	if (app->size != sizeof(PVPLeaderBoardDetailsRequest_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_PVPLeaderBoardDetailsRequest expected %i got %i",
-			sizeof(PVPLeaderBoardDetailsRequest_Struct), app->size);
+			(int)sizeof(PVPLeaderBoardDetailsRequest_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -10578,7 +10594,7 @@ void Client::Handle_OP_PVPLeaderBoardRequest(const EQApplicationPacket *app)
 	if (app->size != sizeof(PVPLeaderBoardRequest_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_PVPLeaderBoardRequest expected %i got %i",
-			sizeof(PVPLeaderBoardRequest_Struct), app->size);
+			(int)sizeof(PVPLeaderBoardRequest_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -10598,7 +10614,7 @@ void Client::Handle_OP_PVPLeaderBoardRequest(const EQApplicationPacket *app)
 void Client::Handle_OP_RaidCommand(const EQApplicationPacket *app)
 {
 	if (app->size < sizeof(RaidGeneral_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_RaidCommand, size=%i, expected at least %i", app->size, sizeof(RaidGeneral_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_RaidCommand, size=%i, expected at least %i", app->size, (int)sizeof(RaidGeneral_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -11183,7 +11199,7 @@ void Client::Handle_OP_RaidCommand(const EQApplicationPacket *app)
 void Client::Handle_OP_RandomReq(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(RandomReq_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_RandomReq, size=%i, expected %i", app->size, sizeof(RandomReq_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_RandomReq, size=%i, expected %i", app->size, (int)sizeof(RandomReq_Struct));
 		return;
 	}
 	const RandomReq_Struct* rndq = (const RandomReq_Struct*)app->pBuffer;
@@ -11212,7 +11228,7 @@ void Client::Handle_OP_RandomReq(const EQApplicationPacket *app)
 void Client::Handle_OP_ReadBook(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(BookRequest_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ReadBook, size=%i, expected %i", app->size, sizeof(BookRequest_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ReadBook, size=%i, expected %i", app->size, (int)sizeof(BookRequest_Struct));
 		return;
 	}
 	BookRequest_Struct* book = (BookRequest_Struct*)app->pBuffer;
@@ -11229,7 +11245,7 @@ void Client::Handle_OP_RecipeAutoCombine(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(RecipeAutoCombine_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for RecipeAutoCombine_Struct: Expected: %i, Got: %i",
-			sizeof(RecipeAutoCombine_Struct), app->size);
+			(int)sizeof(RecipeAutoCombine_Struct), app->size);
 		return;
 	}
 
@@ -11243,7 +11259,7 @@ void Client::Handle_OP_RecipeDetails(const EQApplicationPacket *app)
 {
 	if (app->size < sizeof(uint32)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for RecipeDetails Request: Expected: %i, Got: %i",
-			sizeof(uint32), app->size);
+			(int)sizeof(uint32), app->size);
 		return;
 	}
 	uint32 *recipe_id = (uint32*)app->pBuffer;
@@ -11257,7 +11273,7 @@ void Client::Handle_OP_RecipesFavorite(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(TradeskillFavorites_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for TradeskillFavorites_Struct: Expected: %i, Got: %i",
-			sizeof(TradeskillFavorites_Struct), app->size);
+			(int)sizeof(TradeskillFavorites_Struct), app->size);
 		return;
 	}
 
@@ -11316,7 +11332,7 @@ void Client::Handle_OP_RecipesSearch(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(RecipesSearch_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for RecipesSearch_Struct: Expected: %i, Got: %i",
-			sizeof(RecipesSearch_Struct), app->size);
+			(int)sizeof(RecipesSearch_Struct), app->size);
 		return;
 	}
 
@@ -11385,7 +11401,7 @@ void Client::Handle_OP_RemoveBlockedBuffs(const EQApplicationPacket *app)
 	if (app->size != sizeof(BlockedBuffs_Struct))
 	{
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_RemoveBlockedBuffs expected %i got %i",
-			sizeof(BlockedBuffs_Struct), app->size);
+			(int)sizeof(BlockedBuffs_Struct), app->size);
 
 		DumpPacket(app);
 
@@ -11597,7 +11613,7 @@ void Client::Handle_OP_Sacrifice(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(Sacrifice_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Sacrifice expected %i got %i", sizeof(Sacrifice_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Sacrifice expected %i got %i", (int)sizeof(Sacrifice_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -11783,7 +11799,7 @@ void Client::Handle_OP_SetServerFilter(const EQApplicationPacket *app)
 	if (app->size != sizeof(SetServerFilter_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Received invalid sized "
 			"OP_SetServerFilter: got %d, expected %d", app->size,
-			sizeof(SetServerFilter_Struct));
+			(int)sizeof(SetServerFilter_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -11866,7 +11882,7 @@ void Client::Handle_OP_SetStartCity(const EQApplicationPacket *app)
 void Client::Handle_OP_SetTitle(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(SetTitle_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_SetTitle expected %i got %i", sizeof(SetTitle_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_SetTitle expected %i got %i", (int)sizeof(SetTitle_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -11890,7 +11906,7 @@ void Client::Handle_OP_SetTitle(const EQApplicationPacket *app)
 void Client::Handle_OP_Shielding(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Shielding_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_Shielding expected:%i got:%i", sizeof(Shielding_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_Shielding expected:%i got:%i", (int)sizeof(Shielding_Struct), app->size);
 		return;
 	}
 	if (GetClass() != WARRIOR)
@@ -11982,7 +11998,7 @@ void Client::Handle_OP_ShopPlayerBuy(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Merchant_Sell_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size on OP_ShopPlayerBuy: Expected %i, Got %i",
-			sizeof(Merchant_Sell_Struct), app->size);
+			(int)sizeof(Merchant_Sell_Struct), app->size);
 		return;
 	}
 	RDTSC_Timer t1;
@@ -12245,7 +12261,7 @@ void Client::Handle_OP_ShopPlayerSell(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Merchant_Purchase_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size on OP_ShopPlayerSell: Expected %i, Got %i",
-			sizeof(Merchant_Purchase_Struct), app->size);
+			(int)sizeof(Merchant_Purchase_Struct), app->size);
 		return;
 	}
 	RDTSC_Timer t1(true);
@@ -12400,7 +12416,7 @@ void Client::Handle_OP_ShopPlayerSell(const EQApplicationPacket *app)
 void Client::Handle_OP_ShopRequest(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Merchant_Click_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ShopRequest, size=%i, expected %i", app->size, sizeof(Merchant_Click_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_ShopRequest, size=%i, expected %i", app->size, (int)sizeof(Merchant_Click_Struct));
 		return;
 	}
 
@@ -12696,7 +12712,7 @@ void Client::Handle_OP_SpawnAppearance(const EQApplicationPacket *app)
 void Client::Handle_OP_Split(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Split_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_Split, size=%i, expected %i", app->size, sizeof(Split_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_Split, size=%i, expected %i", app->size, (int)sizeof(Split_Struct));
 		return;
 	}
 	// The client removes the money on its own, but we have to
@@ -12733,7 +12749,7 @@ void Client::Handle_OP_Surname(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(Surname_Struct))
 	{
-		Log.Out(Logs::General, Logs::None, "Size mismatch in Surname expected %i got %i", sizeof(Surname_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in Surname expected %i got %i", (int)sizeof(Surname_Struct), app->size);
 		return;
 	}
 
@@ -12823,7 +12839,7 @@ void Client::Handle_OP_SwapSpell(const EQApplicationPacket *app)
 void Client::Handle_OP_TargetCommand(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(ClientTarget_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "OP size error: OP_TargetMouse expected:%i got:%i", sizeof(ClientTarget_Struct), app->size);
+		Log.Out(Logs::General, Logs::Error, "OP size error: OP_TargetMouse expected:%i got:%i", (int)sizeof(ClientTarget_Struct), app->size);
 		return;
 	}
 
@@ -13049,7 +13065,7 @@ void Client::Handle_OP_TaskHistoryRequest(const EQApplicationPacket *app)
 
 	if (app->size != sizeof(TaskHistoryRequest_Struct)) {
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_TaskHistoryRequest expected %i got %i",
-			sizeof(TaskHistoryRequest_Struct), app->size);
+			(int)sizeof(TaskHistoryRequest_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -13116,7 +13132,7 @@ void Client::Handle_OP_TrackTarget(const EQApplicationPacket *app)
 	if (app->size != sizeof(TrackTarget_Struct))
 	{
 		Log.Out(Logs::General, Logs::Error, "Invalid size for OP_TrackTarget: Expected: %i, Got: %i",
-			sizeof(TrackTarget_Struct), app->size);
+			(int)sizeof(TrackTarget_Struct), app->size);
 		return;
 	}
 
@@ -13268,7 +13284,7 @@ void Client::Handle_OP_TradeAcceptClick(const EQApplicationPacket *app)
 void Client::Handle_OP_TradeBusy(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(TradeBusy_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TradeBusy, size=%i, expected %i", app->size, sizeof(TradeBusy_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TradeBusy, size=%i, expected %i", app->size, (int)sizeof(TradeBusy_Struct));
 		return;
 	}
 	// Trade request recipient is cancelling the trade due to being busy
@@ -13461,7 +13477,7 @@ void Client::Handle_OP_TraderBuy(const EQApplicationPacket *app)
 	// Client has elected to buy an item from a Trader
 	//
 	if (app->size != sizeof(TraderBuy_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TraderBuy, size=%i, expected %i", app->size, sizeof(TraderBuy_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TraderBuy, size=%i, expected %i", app->size, (int)sizeof(TraderBuy_Struct));
 		return;
 	}
 
@@ -13482,7 +13498,7 @@ void Client::Handle_OP_TraderBuy(const EQApplicationPacket *app)
 void Client::Handle_OP_TradeRequest(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(TradeRequest_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TradeRequest, size=%i, expected %i", app->size, sizeof(TradeRequest_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TradeRequest, size=%i, expected %i", app->size, (int)sizeof(TradeRequest_Struct));
 		return;
 	}
 	// Client requesting a trade session from an npc/client
@@ -13518,7 +13534,7 @@ void Client::Handle_OP_TradeRequest(const EQApplicationPacket *app)
 void Client::Handle_OP_TradeRequestAck(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(TradeRequest_Struct)) {
-		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TradeRequestAck, size=%i, expected %i", app->size, sizeof(TradeRequest_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size: OP_TradeRequestAck, size=%i, expected %i", app->size, (int)sizeof(TradeRequest_Struct));
 		return;
 	}
 	// Trade request recipient is acknowledging they are able to trade
@@ -13661,7 +13677,7 @@ void Client::Handle_OP_TradeSkillCombine(const EQApplicationPacket *app)
 {
 	if (app->size != sizeof(NewCombine_Struct)) {
 		Log.Out(Logs::General, Logs::Error, "Invalid size for NewCombine_Struct: Expected: %i, Got: %i",
-			sizeof(NewCombine_Struct), app->size);
+			(int)sizeof(NewCombine_Struct), app->size);
 		return;
 	}
 	/*if (m_tradeskill_object == nullptr) {
@@ -13681,7 +13697,7 @@ void Client::Handle_OP_Translocate(const EQApplicationPacket *app)
 {
 
 	if (app->size != sizeof(Translocate_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Translocate expected %i got %i", sizeof(Translocate_Struct), app->size);
+		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_Translocate expected %i got %i", (int)sizeof(Translocate_Struct), app->size);
 		DumpPacket(app);
 		return;
 	}
@@ -13820,7 +13836,7 @@ void Client::Handle_OP_VetClaimRequest(const EQApplicationPacket *app)
 	if (app->size < sizeof(VeteranClaim)) {
 		Log.Out(Logs::General, Logs::None,
 			"OP_VetClaimRequest size lower than expected: got %u expected at least %u", app->size,
-			sizeof(VeteranClaim));
+			(uint32)sizeof(VeteranClaim));
 		DumpPacket(app);
 		return;
 	}
@@ -13851,7 +13867,7 @@ void Client::Handle_OP_VoiceMacroIn(const EQApplicationPacket *app)
 	if (app->size != sizeof(VoiceMacroIn_Struct)) {
 
 		Log.Out(Logs::General, Logs::None, "Size mismatch in OP_VoiceMacroIn expected %i got %i",
-			sizeof(VoiceMacroIn_Struct), app->size);
+			(int)sizeof(VoiceMacroIn_Struct), app->size);
 
 		DumpPacket(app);
 
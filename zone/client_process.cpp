@@ -129,10 +129,10 @@ bool Client::Process() {
 		if(IsTracking() && (GetClientVersion() >= ClientVersion::SoD) && TrackingTimer.Check())
 			DoTracking();
 
-		if(hpupdate_timer.Check())
+		if(hpupdate_timer.CheckDue())
 			SendHPUpdate();
 
-		if(mana_timer.Check())
+		if(mana_timer.CheckDue())
 			SendManaUpdatePacket();
 
 			if(dead && dead_timer.Check()) {
@@ -197,7 +197,7 @@ bool Client::Process() {
 			instalog = true;
 		}
 
-		if (IsStunned() && stunned_timer.Check()) {
+		if (IsStunned() && stunned_timer.CheckDue()) {
 			this->stunned = false;
 			this->stunned_timer.Disable();
 		}
@@ -535,7 +535,7 @@ bool Client::Process() {
 			// Send a position packet every 8 seconds - if not done, other clients
 			// see this char disappear after 10-12 seconds of inactivity
 			if (position_timer_counter >= 36) { // Approx. 4 ticks per second
-				entity_list.SendPositionUpdates(this, pLastUpdateWZ, 500, GetTarget(), true);
+				entity_list.SendPositionUpdates(this);
 				pLastUpdate = Timer::GetCurrentTime();
 				pLastUpdateWZ = pLastUpdate;
 				position_timer_counter = 0;
@@ -600,7 +600,7 @@ bool Client::Process() {
 			DoEnduranceUpkeep();
 		}
 
-		if (tic_timer.Check() && !dead) {
+		if (tic_timer.CheckDue() && !dead) {
 			CalcMaxHP();
 			CalcMaxMana();
 			CalcATK();
@@ -1198,7 +1198,7 @@ void Client::OPMemorizeSpell(const EQApplicationPacket* app)
 {
 	if(app->size != sizeof(MemorizeSpell_Struct))
 	{
-		Log.Out(Logs::General, Logs::Error, "Wrong size on OP_MemorizeSpell. Got: %i, Expected: %i", app->size, sizeof(MemorizeSpell_Struct));
+		Log.Out(Logs::General, Logs::Error, "Wrong size on OP_MemorizeSpell. Got: %i, Expected: %i", app->size, (int)sizeof(MemorizeSpell_Struct));
 		DumpPacket(app);
 		return;
 	}
@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
 #include <ctime>
 
 #ifdef _WINDOWS
@@ -52,6 +53,7 @@
 #include "../common/serverinfo.h"
 #include "../common/string_util.h"
 #include "../common/eqemu_logsys.h"
+#include "../common/scope_profiler.h"
 
 
 #include "command.h"
@@ -274,6 +276,8 @@ int command_init(void) {
 		command_add("makepet", "[level] [class] [race] [texture] - Make a pet", 50, command_makepet) ||
 		command_add("mana", "- Fill your or your target's mana", 50, command_mana) ||
 		command_add("manaburn", "- Use AA Wizard class skill manaburn on target", 10, command_manaburn) ||
+		command_add("mapbench", "[rays|load] - Time line of sight and best z raycasts against this zone's map, or time loading it", 250, command_mapbench) ||
+		command_add("mapcompile", "- Write this zone's map as a precompiled .cmap that later boots map straight into memory", 250, command_mapcompile) ||
 		command_add("maxskills", "Maxes skills for you.",  200, command_max_all_skills) ||
 		command_add("memspell", "[slotid] [spellid] - Memorize spellid in the specified slot", 50, command_memspell) ||
 		command_add("merchant_close_shop",  "Closes a merchant shop",  100, command_merchantcloseshop) ||
@@ -315,9 +319,11 @@ int command_init(void) {
 		command_add("petitioninfo", "[petition number] - Get info about a petition", 20, command_petitioninfo) ||
 		command_add("pf", "- Display additional mob coordinate and wandering data", 0, command_pf) ||
 		command_add("picklock",  "Analog for ldon pick lock for the newer clients since we still don't have it working.",  0, command_picklock) ||
+		command_add("profile", "[on|off|reset|show (count)|dump (json)] - Tick, main loop phase, packet handler and quest event timings for this zone", 250, command_profile) ||
 		command_add("pvp", "[on/off] - Set your or your player target's PVP status", 100, command_pvp) ||
 		command_add("qglobal", "[on/off/view] - Toggles qglobal functionality on an NPC", 100, command_qglobal) ||
 		command_add("questerrors",  "Shows quest errors.",  100, command_questerrors) ||
+		command_add("questbench", "[say|timer|combat|hp] [count] - Times sending your NPC target's quest the event count times", 250, command_questbench) ||
 		command_add("race", "[racenum] - Change your or your target's race. Use racenum 0 to return to normal", 50, command_race) ||
 		command_add("raidloot", "LEADER|GROUPLEADER|SELECTED|ALL - Sets your raid loot settings if you have permission to do so.", 0, command_raidloot) ||
 		command_add("randomfeatures", "- Temporarily randomizes the Facial Features of your target", 80, command_randomfeatures) ||
@@ -1315,7 +1321,7 @@ void command_petitioninfo(Client *c, const Seperator *sep)
     if (!results.Success())
         return;
 
-    Log.Out(Logs::General, Logs::Normal, "Petition information request from %s, petition number:",  c->GetName(), atoi(sep->argplus[1]) );
+    Log.Out(Logs::General, Logs::Normal, "Petition information request from %s, petition number: %i",  c->GetName(), atoi(sep->argplus[1]) );
 
     if (results.RowCount() == 0) {
 		c->Message(13,"There was an error in your request: ID not found! Please check the Id and try again.");
@@ -1341,7 +1347,7 @@ void command_delpetition(Client *c, const Seperator *sep)
 	if (!results.Success())
         return;
 
-    Log.Out(Logs::General, Logs::Normal, "Delete petition request from %s, petition number:",  c->GetName(), atoi(sep->argplus[1]) );
+    Log.Out(Logs::General, Logs::Normal, "Delete petition request from %s, petition number: %i",  c->GetName(), atoi(sep->argplus[1]) );
 
 }
 
@@ -4260,6 +4266,7 @@ void command_spawnfix(Client *c, const Seperator *sep) {
         return;
     }
 
+    zone->DropContentPack();
     c->Message(0, "Updating coordinates successful.");
     targetMob->Depop(false);
 }
@@ -4288,7 +4295,7 @@ void command_iteminfo(Client *c, const Seperator *sep)
 	if (!inst) { c->Message(13, "Error: You need an item on your cursor for this command"); }
 	auto item = inst->GetItem();
 	if (!item) {
-		Log.Out(Logs::General, Logs::Inventory, "(%s) Command #iteminfo processed an item with no data pointer");
+		Log.Out(Logs::General, Logs::Inventory, "(%s) Command #iteminfo processed an item with no data pointer", c->GetName());
 		c->Message(13, "Error: This item has no data reference");
 	}
 
@@ -6467,6 +6474,7 @@ void command_npcedit(Client *c, const Seperator *sep)
         c->Message(15,"NPCID %u now has a spawn limit of %i",  npcTypeID, atoi(sep->arg[2]));
 		std::string query = StringFormat("UPDATE npc_types SET spawn_limit = %i WHERE id = %i",  atoi(sep->argplus[2]), npcTypeID);
 		database.QueryDatabase(query);
+		zone->DropContentPack(); // spawn entries carry the limit
 		return;
 	}
 
@@ -6567,6 +6575,7 @@ void command_npcedit(Client *c, const Seperator *sep)
 		c->Message(15,"NPCID %u now has the animation set to %i on spawn with spawngroup %i",  npcTypeID, animation, c->GetTarget()->CastToNPC()->GetSp2() );
 		std::string query = StringFormat("UPDATE spawn2 SET animation = %i " "WHERE spawngroupID = %i",  animation, c->GetTarget()->CastToNPC()->GetSp2());
 		database.QueryDatabase(query);
+		zone->DropContentPack();
 
 		c->GetTarget()->SetAppearance(EmuAppearance(animation));
 		return;
@@ -6714,6 +6723,9 @@ void command_path(Client *c, const Seperator *sep)
 		c->Message(0, "#path disconnect [all]/disconnect_from_id: Disconnects the currently targeted node to disconnect from disconnect from id's node (requires shownode target), if passed all as the second argument it will disconnect this node from every other node.");
 		c->Message(0, "#path move: Moves your targeted node to your current position");
 		c->Message(0, "#path process file_name: processes the map file and tries to automatically generate a rudimentary path setup and then dumps the current zone->pathing to a file of your naming.");
+		c->Message(0, "#path meshtest bench [max_routes]: times route searches between every pair of path nodes and reports routes per second.");
+		c->Message(0, "#path nearestbench [lookups]: times nearest path node lookups with the node grid against a full sort.");
+		c->Message(0, "#path nexthop: precomputes the shortest route between every pair of nodes and saves it beside the zone's .path file.");
 		c->Message(0, "#path resort [nodes]: resorts the connections/nodes after you've manually altered them so they'll work.");
 		return;
 	}
@@ -6963,6 +6975,12 @@ void command_path(Client *c, const Seperator *sep)
 				zone->pathing->SimpleMeshTest();
 				return;
 			}
+			else if(!strcasecmp(sep->arg[2], "bench"))
+			{
+				c->Message(0, "You may go linkdead. Timing routes between all path nodes.");
+				zone->pathing->RouteBenchmark(c, atoi(sep->arg[3]));
+				return;
+			}
 			else
 			{
 				c->Message(0, "You may go linkdead. Results will be in the log file.");
@@ -6972,6 +6990,33 @@ void command_path(Client *c, const Seperator *sep)
 		}
 	}
 
+	if(!strcasecmp(sep->arg[1], "nearestbench"))
+	{
+		if(zone->pathing)
+		{
+			zone->pathing->NearestNodeBenchmark(c, atoi(sep->arg[2]));
+			return;
+		}
+	}
+
+	if(!strcasecmp(sep->arg[1], "nexthop"))
+	{
+		if(zone->pathing)
+		{
+			if(!zone->pathing->BuildNextHopTable())
+			{
+				c->Message(0, "Unable to build a next hop table, the path file has more than %u nodes.", PathManager::GetNextHopMaxNodes());
+				return;
+			}
+
+			if(zone->pathing->SaveNextHopTable())
+				c->Message(0, "Next hop table built and saved, it is already in use in this zone.");
+			else
+				c->Message(0, "Next hop table built but could not be saved, it is only in use until the zone shuts down.");
+			return;
+		}
+	}
+
 	if(!strcasecmp(sep->arg[1], "allspawns"))
 	{
 		if(zone->pathing)
@@ -7124,6 +7169,73 @@ void command_pf(Client *c, const Seperator *sep)
 	}
 }
 
+void command_mapbench(Client *c, const Seperator *sep)
+{
+	if (zone->zonemap == nullptr) {
+		c->Message(0, "Map not loaded for this zone");
+		return;
+	}
+
+	if (!strcasecmp(sep->arg[1], "load")) {
+		std::string filename = Map::GetMapFileName(zone->GetMapName(), ".map");
+		std::string compiled_filename = Map::GetMapFileName(zone->GetMapName(), ".cmap");
+
+		Map *m = new Map();
+		auto start = std::chrono::steady_clock::now();
+		bool loaded = m->Load(filename);
+		double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		safe_delete(m);
+
+		m = new Map();
+		start = std::chrono::steady_clock::now();
+		bool compiled = m->LoadCompiled(compiled_filename, filename);
+		double compiled_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		safe_delete(m);
+
+		if (loaded)
+			c->Message(0, "%s: parsed and built in %.1f ms.", filename.c_str(), load_seconds * 1000.0);
+		else
+			c->Message(0, "%s: could not be loaded.", filename.c_str());
+
+		if (compiled)
+			c->Message(0, "%s: mapped in %.1f ms.", compiled_filename.c_str(), compiled_seconds * 1000.0);
+		else
+			c->Message(0, "%s: missing or out of date, use #mapcompile to write it.", compiled_filename.c_str());
+		return;
+	}
+
+	uint32 rays = sep->IsNumber(1) ? atoi(sep->arg[1]) : 100000;
+	if (rays == 0) {
+		c->Message(0, "Usage: #mapbench [rays|load]");
+		return;
+	}
+
+	RaycastBenchmarkStats los;
+	RaycastBenchmarkStats best_z;
+	zone->zonemap->RaycastBenchmark(rays, los, best_z);
+
+	c->Message(0, "Line of sight: %u rays, %.0f rays/sec single, %.0f rays/sec batched, %u mismatches.", los.rays,
+		los.scalar_seconds > 0.0 ? los.rays / los.scalar_seconds : 0.0,
+		los.batch_seconds > 0.0 ? los.rays / los.batch_seconds : 0.0, los.mismatches);
+	c->Message(0, "Best Z: %u points, %.0f points/sec single, %.0f points/sec batched, %u mismatches.", best_z.rays,
+		best_z.scalar_seconds > 0.0 ? best_z.rays / best_z.scalar_seconds : 0.0,
+		best_z.batch_seconds > 0.0 ? best_z.rays / best_z.batch_seconds : 0.0, best_z.mismatches);
+}
+
+void command_mapcompile(Client *c, const Seperator *sep)
+{
+	if (zone->zonemap == nullptr) {
+		c->Message(0, "Map not loaded for this zone");
+		return;
+	}
+
+	std::string compiled_filename = Map::GetMapFileName(zone->GetMapName(), ".cmap");
+	if (zone->zonemap->SaveCompiled(compiled_filename, Map::GetMapFileName(zone->GetMapName(), ".map")))
+		c->Message(0, "Wrote %s, it will be used the next time this zone boots.", compiled_filename.c_str());
+	else
+		c->Message(13, "Failed to write %s, check the zone log.", compiled_filename.c_str());
+}
+
 void command_bestz(Client *c, const Seperator *sep) {
 	if (zone->zonemap == nullptr) {
 		c->Message(0,"Map not loaded for this zone");
@@ -7930,6 +8042,9 @@ void command_advnpcspawn(Client *c, const Seperator *sep)
 {
 	Mob *target=c->GetTarget();
 
+	// the subcommands edit spawn rows, the zone's content pack won't have them
+	zone->DropContentPack();
+
     if (strcasecmp(sep->arg[1], "maketype") == 0) {
         if(!target || !target->IsNPC()) {
             c->Message(0, "Target Required!");
@@ -10655,3 +10770,114 @@ void command_mysqltest(Client *c, const Seperator *sep)
 	}
 	Log.Out(Logs::General, Logs::Debug, "MySQL Test... Took %f seconds", ((float)(std::clock() - t)) / CLOCKS_PER_SEC); 
 }
+
+extern EQEmu::ScopeProfiler zone_profiler;
+
+void command_profile(Client *c, const Seperator *sep)
+{
+	if (!strcasecmp(sep->arg[1], "on")) {
+		zone_profiler.SetEnabled(true);
+		c->Message(0, "Profiling started.");
+	}
+	else if (!strcasecmp(sep->arg[1], "off")) {
+		zone_profiler.SetEnabled(false);
+		c->Message(0, "Profiling stopped, the numbers so far are kept until it is started again.");
+	}
+	else if (!strcasecmp(sep->arg[1], "reset")) {
+		zone_profiler.Reset();
+		c->Message(0, "Profile reset.");
+	}
+	else if (!strcasecmp(sep->arg[1], "show")) {
+		size_t count = sep->IsNumber(2) ? atoi(sep->arg[2]) : 15;
+		std::vector<std::string> lines = zone_profiler.Report(count);
+		c->Message(0, "Profile of %s over %.1fs%s:", zone->GetShortName(), zone_profiler.GetElapsedUS() / 1000000.0,
+			zone_profiler.IsEnabled() ? "" : " (stopped)");
+		for (auto &line : lines)
+			c->Message(0, "%s", line.c_str());
+	}
+	else if (!strcasecmp(sep->arg[1], "dump")) {
+		bool json = !strcasecmp(sep->arg[2], "json");
+		std::string file_name = StringFormat("logs/profile_%s_%u.%s", zone->GetShortName(), zone->GetInstanceID(), json ? "json" : "txt");
+
+		Log.MakeDirectory("logs");
+		FILE *f = fopen(file_name.c_str(), "w");
+		if (!f) {
+			c->Message(13, "Unable to open %s.", file_name.c_str());
+			return;
+		}
+
+		std::string title = StringFormat("%s (instance %u)", zone->GetShortName(), zone->GetInstanceID());
+		if (json) {
+			fprintf(f, "%s\n", zone_profiler.ReportJSON(title).c_str());
+		}
+		else {
+			fprintf(f, "Profile of %s over %.1fs\n", title.c_str(), zone_profiler.GetElapsedUS() / 1000000.0);
+			std::vector<std::string> lines = zone_profiler.Report();
+			for (auto &line : lines)
+				fprintf(f, "%s\n", line.c_str());
+		}
+
+		fclose(f);
+		c->Message(0, "Profile written to %s.", file_name.c_str());
+	}
+	else {
+		c->Message(0, "Profiling is %s.", zone_profiler.IsEnabled() ? "on" : "off");
+		c->Message(0, "#profile on|off - Start or stop timing, starting clears the old numbers");
+		c->Message(0, "#profile reset - Clear the numbers");
+		c->Message(0, "#profile show [count] - List the scopes that took the most time, 15 by default");
+		c->Message(0, "#profile dump [json] - Write every scope to logs/profile_<zone>_<instance>.txt or .json");
+	}
+}
+
+void command_questbench(Client *c, const Seperator *sep)
+{
+	Mob *target = c->GetTarget();
+	QuestEventID event = EVENT_SAY;
+	std::string data;
+	uint32 extra_data = 0;
+
+	if (!strcasecmp(sep->arg[1], "say")) {
+		event = EVENT_SAY;
+		data = "Hail";
+	}
+	else if (!strcasecmp(sep->arg[1], "timer")) {
+		event = EVENT_TIMER;
+		data = "questbench";
+	}
+	else if (!strcasecmp(sep->arg[1], "combat")) {
+		event = EVENT_COMBAT;
+		data = "1";
+	}
+	else if (!strcasecmp(sep->arg[1], "hp")) {
+		event = EVENT_HP;
+		data = "50";
+	}
+	else {
+		c->Message(0, "#questbench say|timer|combat|hp [count] - Sends your NPC target's quest the event count times, 1000 by default, and reports events/sec");
+		c->Message(0, "Whatever the quest does for the event it does count times, so use a test NPC.");
+		return;
+	}
+
+	if (!target || !target->IsNPC()) {
+		c->Message(13, "You need an NPC target.");
+		return;
+	}
+
+	NPC *npc = target->CastToNPC();
+	if (!parse->HasQuestSub(npc->GetNPCTypeID(), event)) {
+		c->Message(13, "%s has no quest sub for %s.", npc->GetCleanName(), sep->arg[1]);
+		return;
+	}
+
+	int count = sep->IsNumber(2) ? atoi(sep->arg[2]) : 1000;
+	if (count < 1 || count > 1000000)
+		count = 1000;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < count; ++i)
+		parse->EventNPC(event, npc, c, data, extra_data);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	c->Message(0, "%d %s events to %s in %.3fs: %.0f events/sec, %.2fus each.", count, sep->arg[1], npc->GetCleanName(),
+		seconds, count / seconds, seconds * 1000000.0 / count);
+}
@@ -145,6 +145,8 @@ void command_setskillall(Client *c, const Seperator *sep);
 void command_race(Client *c, const Seperator *sep);
 void command_gender(Client *c, const Seperator *sep);
 void command_makepet(Client *c, const Seperator *sep);
+void command_mapbench(Client *c, const Seperator *sep);
+void command_mapcompile(Client *c, const Seperator *sep);
 void command_level(Client *c, const Seperator *sep);
 void command_spawn(Client *c, const Seperator *sep);
 void command_texture(Client *c, const Seperator *sep);
@@ -325,6 +327,8 @@ void command_tune(Client *c, const Seperator *sep);
 void command_logtest(Client *c, const Seperator *sep);
 void command_mysqltest(Client *c, const Seperator *sep);
 void command_logs(Client *c, const Seperator *sep);
+void command_profile(Client *c, const Seperator *sep);
+void command_questbench(Client *c, const Seperator *sep);
  
 #ifdef EQPROFILE
 void command_profiledump(Client *c, const Seperator *sep);
@@ -705,8 +705,26 @@ void EntityList::AESpell(Mob *caster, Mob *center, uint16 spell_id, bool affect_
 
 	int iCounter = 0;
 
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
-		curmob = it->second;
+	// without a center or ring we have nothing to measure from, so every mob is a candidate
+	std::vector<Mob *> targets;
+	if (spells[spell_id].targettype == ST_Ring) {
+		GetCloseMobs(caster->GetTargetRingX(), caster->GetTargetRingY(), dist, targets);
+	} else if (center) {
+		GetCloseMobs(center->GetX(), center->GetY(), dist, targets);
+	} else {
+		targets.reserve(mob_list.size());
+		for (auto it = mob_list.begin(); it != mob_list.end(); ++it)
+			targets.push_back(it->second);
+	}
+
+	// everything that passes the checks below, with its distance for the power mod; the line of sight
+	// checks from center are left for last and traced together
+	std::vector<Mob *> hits;
+	std::vector<float> hit_dists;
+	bool los_from_center = bad && center && !spells[spell_id].npc_no_los;
+
+	for (auto it = targets.begin(); it != targets.end(); ++it) {
+		curmob = *it;
 		// test to fix possible cause of random zone crashes..external methods accessing client properties before they're initialized
 		if (curmob->IsClient() && !curmob->CastToClient()->ClientFinishedLoading())
 			continue;
@@ -749,8 +767,6 @@ void EntityList::AESpell(Mob *caster, Mob *center, uint16 spell_id, bool affect_
 		if (bad) {
 			if (!caster->IsAttackAllowed(curmob, true))
 				continue;
-			if (center &&  !spells[spell_id].npc_no_los && !center->CheckLosFN(curmob))
-				continue;
 			if (!center && !spells[spell_id].npc_no_los && !caster->CheckLosFN(caster->GetTargetRingX(), caster->GetTargetRingY(), caster->GetTargetRingZ(), curmob->GetSize()))
 				continue;
 		} else { // check to stop casting beneficial ae buffs (to wit: bard songs) on enemies...
@@ -763,7 +779,22 @@ void EntityList::AESpell(Mob *caster, Mob *center, uint16 spell_id, bool affect_
 				continue;
 		}
 
-		curmob->CalcSpellPowerDistanceMod(spell_id, dist_targ);
+		hits.push_back(curmob);
+		hit_dists.push_back(dist_targ);
+	}
+
+	std::unique_ptr<bool[]> los;
+	if (los_from_center && !hits.empty()) {
+		los.reset(new bool[hits.size()]);
+		center->CheckLosFNBatch(&hits[0], hits.size(), los.get());
+	}
+
+	for (size_t i = 0; i < hits.size(); ++i) {
+		if (los && !los[i])
+			continue;
+
+		curmob = hits[i];
+		curmob->CalcSpellPowerDistanceMod(spell_id, hit_dists[i]);
 
 		//if we get here... cast the spell.
 		if (IsTargetableAESpell(spell_id) && bad) {
@@ -833,6 +864,9 @@ void EntityList::AEBardPulse(Mob *caster, Mob *center, uint16 spell_id, bool aff
 	bool bad = IsDetrimentalSpell(spell_id);
 	bool isnpc = caster->IsNPC();
 
+	// the line of sight checks for everything a detrimental pulse would hit are traced together at the end
+	std::vector<Mob *> hits;
+
 	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
 		curmob = it->second;
 		if (curmob == center)	//do not affect center
@@ -855,10 +889,7 @@ void EntityList::AEBardPulse(Mob *caster, Mob *center, uint16 spell_id, bool aff
 			}
 		}
 		//finally, make sure they are within range
-		if (bad) {
-			if (!center->CheckLosFN(curmob))
-				continue;
-		} else { // check to stop casting beneficial ae buffs (to wit: bard songs) on enemies...
+		if (!bad) { // check to stop casting beneficial ae buffs (to wit: bard songs) on enemies...
 			// See notes in AESpell() above for more info. 
 			if (caster->IsAttackAllowed(curmob, true))
 				continue;
@@ -866,8 +897,21 @@ void EntityList::AEBardPulse(Mob *caster, Mob *center, uint16 spell_id, bool aff
 				continue;
 		}
 
+		hits.push_back(curmob);
+	}
+
+	std::unique_ptr<bool[]> los;
+	if (bad && !hits.empty()) {
+		los.reset(new bool[hits.size()]);
+		center->CheckLosFNBatch(&hits[0], hits.size(), los.get());
+	}
+
+	for (size_t i = 0; i < hits.size(); ++i) {
+		if (los && !los[i])
+			continue;
+
 		//if we get here... cast the spell.
-		curmob->BardPulse(spell_id, caster);
+		hits[i]->BardPulse(spell_id, caster);
 	}
 	if (caster->IsClient())
 		caster->CastToClient()->CheckSongSkillIncrease(spell_id);
@@ -883,8 +927,11 @@ void EntityList::AEAttack(Mob *attacker, float dist, int Hand, int count, bool I
 
 	int hit = 0;
 
-	for (auto it = mob_list.begin(); it != mob_list.end(); ++it) {
-		curmob = it->second;
+	std::vector<Mob *> close_mobs;
+	GetCloseMobs(attacker->GetX(), attacker->GetY(), dist, close_mobs);
+
+	for (auto it = close_mobs.begin(); it != close_mobs.end(); ++it) {
+		curmob = *it;
 		if (curmob->IsNPC()
 				&& curmob != attacker //this is not needed unless NPCs can use this
 				&&(attacker->IsAttackAllowed(curmob))
@@ -29,6 +29,7 @@
 #include "qglobals.h"
 #include "zone.h"
 #include <algorithm>
+#include <fstream>
 #include <sstream>
 
 extern Zone* zone;
@@ -127,6 +128,12 @@ PerlembParser::~PerlembParser() {
 }
 
 void PerlembParser::ReloadQuests() {
+	//everything cached points into the interpreter that is about to go away
+	for(auto iter = packages_.begin(); iter != packages_.end(); ++iter)
+		ReleasePackage(iter->second);
+	packages_.clear();
+	clear_vars_.clear();
+
 	try {
 		if(perl == nullptr) {
 			perl = new Embperl;
@@ -168,46 +175,44 @@ int PerlembParser::EventCommon(QuestEventID event, uint32 objid, const char * da
 	bool isGlobalNPC = false;
 	bool isItemQuest = false;
 	bool isSpellQuest = false;
-	std::string package_name;
 
 	GetQuestTypes(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest,
 		event, npcmob, iteminst, mob, global);
-	GetQuestPackageName(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest,
-		package_name, event, objid, data, npcmob, iteminst, global);
+	PerlQuestPackage *pkg = GetQuestPackage(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest,
+		event, objid, data, npcmob, iteminst, global);
 
-	const char *sub_name = QuestEventSubroutines[event];
-	if(!perl->SubExists(package_name.c_str(), sub_name)) {
+	if(!pkg->subs[event]) {
 		return 0;
 	}
 
 	int char_id = 0;
-	ExportCharID(package_name, char_id, npcmob, mob);
+	ExportCharID(pkg, char_id, npcmob, mob);
 	ExportQGlobals(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest,
-		package_name, npcmob, mob, char_id);
+		pkg, npcmob, mob, char_id);
 
 	//ExportGenericVariables();
 	ExportMobVariables(isPlayerQuest, isGlobalPlayerQuest, isGlobalNPC, isItemQuest, isSpellQuest, 
-		package_name, mob, npcmob);
-	ExportZoneVariables(package_name);
-	ExportItemVariables(package_name, mob);
-	ExportEventVariables(package_name, event, objid, data, npcmob, iteminst, mob, extradata, extra_pointers);
+		pkg, mob, npcmob);
+	ExportZoneVariables(pkg);
+	ExportItemVariables(pkg, mob);
+	ExportEventVariables(pkg, event, objid, data, npcmob, iteminst, mob, extradata, extra_pointers);
 
 	if(isPlayerQuest || isGlobalPlayerQuest){
-		return SendCommands(package_name.c_str(), sub_name, 0, mob, mob, nullptr);
+		return SendCommands(pkg, event, 0, mob, mob, nullptr);
 	}
 	else if(isItemQuest) {
-		return SendCommands(package_name.c_str(), sub_name, 0, mob, mob, iteminst);
+		return SendCommands(pkg, event, 0, mob, mob, iteminst);
 	}
 	else if(isSpellQuest)
 	{
 		if(mob) {
-			return SendCommands(package_name.c_str(), sub_name, 0, mob, mob, nullptr);
+			return SendCommands(pkg, event, 0, mob, mob, nullptr);
 		} else {
-			return SendCommands(package_name.c_str(), sub_name, 0, npcmob, mob, nullptr);
+			return SendCommands(pkg, event, 0, npcmob, mob, nullptr);
 		}
 	}
 	else {
-		return SendCommands(package_name.c_str(), sub_name, objid, npcmob, mob, nullptr);
+		return SendCommands(pkg, event, objid, npcmob, mob, nullptr);
 	}
 }
 
@@ -243,23 +248,18 @@ int PerlembParser::EventSpell(QuestEventID evt, NPC* npc, Client *client, uint32
 }
 
 bool PerlembParser::HasQuestSub(uint32 npcid, QuestEventID evt) {
-	std::stringstream package_name;
-	package_name << "qst_npc_" << npcid;
-
 	if(!perl)
 		return false;
 
 	if(evt >= _LargestEventID)
 		return false;
 
-	const char *subname = QuestEventSubroutines[evt];
-
 	auto iter = npc_quest_status_.find(npcid);
 	if(iter == npc_quest_status_.end() || iter->second == QuestFailedToLoad) {
 		return false;
 	}
 
-	return(perl->SubExists(package_name.str().c_str(), subname));
+	return(GetPackage(perlPackageNPC, npcid)->subs[evt] != nullptr);
 }
 
 bool PerlembParser::HasGlobalQuestSub(QuestEventID evt) {
@@ -273,9 +273,7 @@ bool PerlembParser::HasGlobalQuestSub(QuestEventID evt) {
 	if(evt >= _LargestEventID)
 		return false;
 
-	const char *subname = QuestEventSubroutines[evt];
-
-	return(perl->SubExists("qst_global_npc", subname));
+	return(GetPackage(perlPackageGlobalNPC, 0)->subs[evt] != nullptr);
 }
 
 bool PerlembParser::PlayerHasQuestSub(QuestEventID evt) {
@@ -289,9 +287,7 @@ bool PerlembParser::PlayerHasQuestSub(QuestEventID evt) {
 	if(evt >= _LargestEventID)
 		return false;
 
-	const char *subname = QuestEventSubroutines[evt];
-
-	return(perl->SubExists("qst_player", subname));
+	return(GetPackage(perlPackagePlayer, 0)->subs[evt] != nullptr);
 }
 
 bool PerlembParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
@@ -305,15 +301,10 @@ bool PerlembParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
 	if(evt >= _LargestEventID)
 		return false;
 
-	const char *subname = QuestEventSubroutines[evt];
-
-	return(perl->SubExists("qst_global_player", subname));
+	return(GetPackage(perlPackageGlobalPlayer, 0)->subs[evt] != nullptr);
 }
 
 bool PerlembParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
-	std::stringstream package_name;
-	package_name << "qst_spell_" << spell_id;
-
 	if(!perl)
 		return false;
 
@@ -325,15 +316,10 @@ bool PerlembParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
 	if(evt >= _LargestEventID)
 		return false;
 
-	const char *subname = QuestEventSubroutines[evt];
-
-	return(perl->SubExists(package_name.str().c_str(), subname));
+	return(GetPackage(perlPackageSpell, spell_id)->subs[evt] != nullptr);
 }
 
 bool PerlembParser::ItemHasQuestSub(ItemInst *itm, QuestEventID evt) {
-	std::stringstream package_name;
-	package_name << "qst_item_" << itm->GetID();
-
 	if(!perl)
 		return false;
 
@@ -343,14 +329,12 @@ bool PerlembParser::ItemHasQuestSub(ItemInst *itm, QuestEventID evt) {
 	if(evt >= _LargestEventID)
 		return false;
 
-	const char *subname = QuestEventSubroutines[evt];
-
 	auto iter = item_quest_status_.find(itm->GetID());
 	if(iter == item_quest_status_.end() || iter->second == QuestFailedToLoad) {
 		return false;
 	}
 
-	return(perl->SubExists(package_name.str().c_str(), subname));
+	return(GetPackage(perlPackageItem, itm->GetID())->subs[evt] != nullptr);
 }
 
 void PerlembParser::LoadNPCScript(std::string filename, int npc_id) {
@@ -375,10 +359,12 @@ void PerlembParser::LoadNPCScript(std::string filename, int npc_id) {
         error += err;
         AddError(error);
 		npc_quest_status_[npc_id] = questFailedToLoad;
+		ResetPackage(perlPackageNPC, npc_id, filename, false);
 		return;
 	}
 
 	npc_quest_status_[npc_id] = questLoaded;
+	ResetPackage(perlPackageNPC, npc_id, filename, true);
 }
 
 void PerlembParser::LoadGlobalNPCScript(std::string filename) {
@@ -399,10 +385,12 @@ void PerlembParser::LoadGlobalNPCScript(std::string filename) {
         error += err;
         AddError(error);
 		global_npc_quest_status_ = questFailedToLoad;
+		ResetPackage(perlPackageGlobalNPC, 0, filename, false);
 		return;
 	}
 
 	global_npc_quest_status_ = questLoaded;
+	ResetPackage(perlPackageGlobalNPC, 0, filename, true);
 }
 
 void PerlembParser::LoadPlayerScript(std::string filename) {
@@ -423,10 +411,12 @@ void PerlembParser::LoadPlayerScript(std::string filename) {
         error += err;
         AddError(error);
 		player_quest_status_ = questFailedToLoad;
+		ResetPackage(perlPackagePlayer, 0, filename, false);
 		return;
 	}
 
 	player_quest_status_ = questLoaded;
+	ResetPackage(perlPackagePlayer, 0, filename, true);
 }
 
 void PerlembParser::LoadGlobalPlayerScript(std::string filename) {
@@ -447,10 +437,12 @@ void PerlembParser::LoadGlobalPlayerScript(std::string filename) {
         error += err;
         AddError(error);
 		global_player_quest_status_ = questFailedToLoad;
+		ResetPackage(perlPackageGlobalPlayer, 0, filename, false);
 		return;
 	}
 
 	global_player_quest_status_ = questLoaded;
+	ResetPackage(perlPackageGlobalPlayer, 0, filename, true);
 }
 
 void PerlembParser::LoadItemScript(std::string filename, ItemInst *item) {
@@ -478,10 +470,12 @@ void PerlembParser::LoadItemScript(std::string filename, ItemInst *item) {
         error += err;
         AddError(error);
 		item_quest_status_[item->GetID()] = questFailedToLoad;
+		ResetPackage(perlPackageItem, item->GetID(), filename, false);
 		return;
 	}
 	
 	item_quest_status_[item->GetID()] = questLoaded;
+	ResetPackage(perlPackageItem, item->GetID(), filename, true);
 }
 
 void PerlembParser::LoadSpellScript(std::string filename, uint32 spell_id) {
@@ -506,10 +500,12 @@ void PerlembParser::LoadSpellScript(std::string filename, uint32 spell_id) {
         error += err;
         AddError(error);
 		spell_quest_status_[spell_id] = questFailedToLoad;
+		ResetPackage(perlPackageSpell, spell_id, filename, false);
 		return;
 	}
 
 	spell_quest_status_[spell_id] = questLoaded;
+	ResetPackage(perlPackageSpell, spell_id, filename, true);
 }
 
 void PerlembParser::AddVar(std::string name, std::string val) {
@@ -525,69 +521,135 @@ std::string PerlembParser::GetVar(std::string name) {
 	return std::string();
 }
 
-void PerlembParser::ExportHash(const char *pkgprefix, const char *hashname, std::map<std::string, std::string> &vals)
-{
-	if(!perl)
-		return;
+//Scripts that may look variables up by name at run time (plugin::val and friends, string evals,
+//symbolic references, files required later) leave nothing in their package's stash for those
+//variables, so they get every variable exported like before.
+static bool ScriptNeedsAllVariables(const std::string &filename) {
+	static const char *markers[] = { "plugin::", "eval", "require", "$$", "${", "no strict" };
 
-	try
-	{
-		perl->sethash(
-			std::string(pkgprefix).append("::").append(hashname).c_str(),
-			vals
-		);
-	} catch(const char *err) {
-        std::string error = "Error exporting hash: ";
-        error += err;
-        AddError(error);
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if(!file)
+		return true;
+
+	std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	for(size_t i = 0; i < sizeof(markers) / sizeof(markers[0]); ++i) {
+		if(source.find(markers[i]) != std::string::npos)
+			return true;
 	}
+
+	return false;
 }
 
-void PerlembParser::ExportVar(const char * pkgprefix, const char * varname, int value)
-{
+//Packages hold a reference on each sub and glob they point to, so a script redefining a sub
+//can't free one out from under us. Those are dropped here while the interpreter is still around.
+void PerlembParser::ReleasePackage(PerlQuestPackage &pkg) {
+	for(int i = 0; i < _LargestEventID; ++i)
+		SvREFCNT_dec((SV*)pkg.subs[i]);
+	for(auto iter = pkg.vars.begin(); iter != pkg.vars.end(); ++iter)
+		SvREFCNT_dec((SV*)iter->second);
+	SvREFCNT_dec((SV*)pkg.client);
+	SvREFCNT_dec((SV*)pkg.npc);
+	SvREFCNT_dec((SV*)pkg.questitem);
+	SvREFCNT_dec((SV*)pkg.entity_list);
+}
 
-	if(!perl)
-		return;
+PerlQuestPackage *PerlembParser::GetPackage(PerlPackageType type, uint32 id) {
+	uint64 key = (static_cast<uint64>(type) << 32) | id;
+	auto iter = packages_.find(key);
+	if(iter != packages_.end())
+		return &iter->second;
+
+	PerlQuestPackage &pkg = packages_[key];
+	switch(type) {
+		case perlPackageNPC: pkg.name = StringFormat("qst_npc_%d", id); break;
+		case perlPackageGlobalNPC: pkg.name = "qst_global_npc"; break;
+		case perlPackagePlayer: pkg.name = "qst_player"; break;
+		case perlPackageGlobalPlayer: pkg.name = "qst_global_player"; break;
+		case perlPackageItem: pkg.name = StringFormat("qst_item_%d", id); break;
+		case perlPackageSpell: pkg.name = StringFormat("qst_spell_%d", id); break;
+	}
 
-	try {
-		perl->seti(std::string(pkgprefix).append("::").append(varname).c_str(), value);
+	bool has_subs = false;
+	for(int i = 0; i < _LargestEventID; ++i) {
+		pkg.subs[i] = perl ? perl->get_sub(pkg.name.c_str(), QuestEventSubroutines[i]) : nullptr;
+		if(pkg.subs[i]) {
+			SvREFCNT_inc_simple_void_NN(pkg.subs[i]);
+			has_subs = true;
+		}
+	}
 
-	} catch(const char * err) {
-		std::string error = "Error exporting var: ";
-        error += err;
-        AddError(error);
+	pkg.export_all = true;
+	pkg.client = nullptr;
+	pkg.npc = nullptr;
+	pkg.questitem = nullptr;
+	pkg.entity_list = nullptr;
+#ifdef EMBPERL_XS_CLASSES
+	//only packages that can be sent an event need these, looking them up creates the package
+	if(has_subs) {
+		pkg.client = (GV*)SvREFCNT_inc(gv_fetchpv((pkg.name + "::client").c_str(), GV_ADD, SVt_PV));
+		pkg.npc = (GV*)SvREFCNT_inc(gv_fetchpv((pkg.name + "::npc").c_str(), GV_ADD, SVt_PV));
+		pkg.questitem = (GV*)SvREFCNT_inc(gv_fetchpv((pkg.name + "::questitem").c_str(), GV_ADD, SVt_PV));
+		pkg.entity_list = (GV*)SvREFCNT_inc(gv_fetchpv((pkg.name + "::entity_list").c_str(), GV_ADD, SVt_PV));
 	}
+#endif
+
+	return &pkg;
 }
 
-void PerlembParser::ExportVar(const char * pkgprefix, const char * varname, unsigned int value)
-{
+void PerlembParser::ResetPackage(PerlPackageType type, uint32 id, const std::string &filename, bool loaded) {
+	auto iter = packages_.find((static_cast<uint64>(type) << 32) | id);
+	if(iter != packages_.end()) {
+		ReleasePackage(iter->second);
+		packages_.erase(iter);
+	}
 
-	if(!perl)
-		return;
+	PerlQuestPackage *pkg = GetPackage(type, id);
+	pkg->export_all = !loaded || ScriptNeedsAllVariables(filename);
+}
 
-	try {
-		perl->seti(std::string(pkgprefix).append("::").append(varname).c_str(), value);
+//Returns where varname lives in the package, or nullptr if nothing in the package refers to it
+//and it doesn't need to be exported. always skips that check.
+GV *PerlembParser::GetExportGV(PerlQuestPackage *pkg, const char *varname, bool always) {
+	auto iter = pkg->vars.find(varname);
+	if(iter != pkg->vars.end() && (iter->second || !always))
+		return iter->second;
 
-	} catch(const char * err) {
-		std::string error = "Error exporting var: ";
-        error += err;
-        AddError(error);
+	GV *gv = nullptr;
+	if(always || pkg->export_all || perl->VarExists(pkg->name.c_str(), varname)) {
+		std::string full_name = pkg->name;
+		full_name.append("::").append(varname);
+		gv = (GV*)SvREFCNT_inc(gv_fetchpv(full_name.c_str(), GV_ADD, SVt_PV));
+	}
+
+	if(iter != pkg->vars.end()) {
+		iter->second = gv;
+	} else {
+		pkg->var_names.push_back(varname);
+		pkg->vars[pkg->var_names.back().c_str()] = gv;
 	}
+
+	return gv;
 }
 
-void PerlembParser::ExportVar(const char * pkgprefix, const char * varname, float value)
+void PerlembParser::ExportVar(PerlQuestPackage *pkg, const char *varname, int value)
 {
+	GV *gv = GetExportGV(pkg, varname);
+	if(gv)
+		sv_setiv(GvSVn(gv), value);
+}
 
-	if(!perl)
-		return;
+void PerlembParser::ExportVar(PerlQuestPackage *pkg, const char *varname, unsigned int value)
+{
+	GV *gv = GetExportGV(pkg, varname);
+	if(gv)
+		sv_setiv(GvSVn(gv), value);
+}
 
-	try {
-		perl->setd(std::string(pkgprefix).append("::").append(varname).c_str(), value);
-	} catch(const char * err) {
-		std::string error = "Error exporting var: ";
-        error += err;
-        AddError(error);
-	}
+void PerlembParser::ExportVar(PerlQuestPackage *pkg, const char *varname, float value)
+{
+	GV *gv = GetExportGV(pkg, varname);
+	if(gv)
+		sv_setnv(GvSVn(gv), value);
 }
 
 void PerlembParser::ExportVarComplex(const char * pkgprefix, const char *varname, const char *value)
@@ -607,24 +669,14 @@ void PerlembParser::ExportVarComplex(const char * pkgprefix, const char *varname
 	}
 }
 
-void PerlembParser::ExportVar(const char *pkgprefix, const char *varname, const char *value)
+void PerlembParser::ExportVar(PerlQuestPackage *pkg, const char *varname, const char *value)
 {
-	if(!perl)
-		return;
-
-	try
-	{
-		perl->setstr(std::string(pkgprefix).append("::").append(varname).c_str(), value);
-	}
-	catch(const char * err)
-	{
-		std::string error = "Error exporting var: ";
-        error += err;
-        AddError(error);
-	}
+	GV *gv = GetExportGV(pkg, varname);
+	if(gv)
+		sv_setpv(GvSVn(gv), value);
 }
 
-int PerlembParser::SendCommands(const char *pkgprefix, const char *event, uint32 npcid, Mob* other, Mob* mob, ItemInst* iteminst) {
+int PerlembParser::SendCommands(PerlQuestPackage *pkg, QuestEventID event, uint32 npcid, Mob* other, Mob* mob, ItemInst* iteminst) {
 	if(!perl)
 		return 0;
 
@@ -636,89 +688,43 @@ int PerlembParser::SendCommands(const char *pkgprefix, const char *event, uint32
 
 	try {
 
-		std::string cmd = "package " + (std::string)(pkgprefix) + (std::string)(";");
-		perl->eval(cmd.c_str());
-
 #ifdef EMBPERL_XS_CLASSES
-
-		{
-			std::string cl = (std::string)"$" + (std::string)pkgprefix + (std::string)"::client";
-			std::string np = (std::string)"$" + (std::string)pkgprefix + (std::string)"::npc";
-			std::string qi = (std::string)"$" + (std::string)pkgprefix + (std::string)"::questitem";
-			std::string enl = (std::string)"$" + (std::string)pkgprefix + (std::string)"::entity_list";
-			if(clear_vars_.find(cl) != clear_vars_.end()) {
-				std::string eval_str = cl;
-				eval_str += " = undef;";
-				perl->eval(eval_str.c_str());
-			}
-
-			if (clear_vars_.find(np) != clear_vars_.end()) {
-				std::string eval_str = np;
-				eval_str += " = undef;";
-				perl->eval(eval_str.c_str());
-			}
-
-			if (clear_vars_.find(qi) != clear_vars_.end()) {
-				std::string eval_str = qi;
-				eval_str += " = undef;";
-				perl->eval(eval_str.c_str());
-			}
-
-			if (clear_vars_.find(enl) != clear_vars_.end()) {
-				std::string eval_str = enl;
-				eval_str += " = undef;";
-				perl->eval(eval_str.c_str());
-			}
-		}
-
-		char namebuf[64];
-
 		//init a couple special vars: client, npc, entity_list
 		Client *curc = quest_manager.GetInitiator();
-		snprintf(namebuf, 64, "%s::client", pkgprefix);
-		SV *client = get_sv(namebuf, true);
 		if(curc != nullptr) {
-			sv_setref_pv(client, "Client", curc);
+			sv_setref_pv(GvSVn(pkg->client), "Client", curc);
 		} else {
 			//clear out the value, mainly to get rid of blessedness
-			sv_setsv(client, _empty_sv);
+			sv_setsv(GvSVn(pkg->client), _empty_sv);
 		}
 
-		//only export NPC if it's a npc quest
+		//only export NPC if it's a npc quest, a quest still running in this package may have left one behind
 		if(!other->IsClient()){
 			NPC *curn = quest_manager.GetNPC();
-			snprintf(namebuf, 64, "%s::npc", pkgprefix);
-			SV *npc = get_sv(namebuf, true);
-			sv_setref_pv(npc, "NPC", curn);
+			sv_setref_pv(GvSVn(pkg->npc), "NPC", curn);
+		} else if(clear_vars_.count(pkg->npc)) {
+			sv_setsv(GvSVn(pkg->npc), &PL_sv_undef);
 		}
 
 		//only export QuestItem if it's an item quest
 		if(iteminst) {
 			ItemInst* curi = quest_manager.GetQuestItem();
-			snprintf(namebuf, 64, "%s::questitem", pkgprefix);
-			SV *questitem = get_sv(namebuf, true);
-			sv_setref_pv(questitem, "QuestItem", curi);
+			sv_setref_pv(GvSVn(pkg->questitem), "QuestItem", curi);
+		} else if(clear_vars_.count(pkg->questitem)) {
+			sv_setsv(GvSVn(pkg->questitem), &PL_sv_undef);
 		}
 
-		snprintf(namebuf, 64, "%s::entity_list", pkgprefix);
-		SV *el = get_sv(namebuf, true);
-		sv_setref_pv(el, "EntityList", &entity_list);
+		sv_setref_pv(GvSVn(pkg->entity_list), "EntityList", &entity_list);
 #endif
 
 		//now call the requested sub
-		ret_value = perl->dosub(std::string(pkgprefix).append("::").append(event).c_str());
+		ret_value = perl->dosub(pkg->subs[event]);
 
 #ifdef EMBPERL_XS_CLASSES
-		{
-			std::string cl = (std::string)"$" + (std::string)pkgprefix + (std::string)"::client";
-			std::string np = (std::string)"$" + (std::string)pkgprefix + (std::string)"::npc";
-			std::string qi = (std::string)"$" + (std::string)pkgprefix + (std::string)"::questitem";
-			std::string enl = (std::string)"$" + (std::string)pkgprefix + (std::string)"::entity_list";
-			clear_vars_[cl] = 1;
-			clear_vars_[np] = 1;
-			clear_vars_[qi] = 1;
-			clear_vars_[enl] = 1;
-		}
+		clear_vars_.insert(pkg->client);
+		clear_vars_.insert(pkg->npc);
+		clear_vars_.insert(pkg->questitem);
+		clear_vars_.insert(pkg->entity_list);
 #endif
 
 	} catch(const char * err) {
@@ -727,9 +733,9 @@ int PerlembParser::SendCommands(const char *pkgprefix, const char *event, uint32
 		//todo: tweak this to be more accurate at deciding what to filter (we don't want to gag legit errors)
 		if(!strstr(err,"Undefined subroutine")) {
             std::string error = "Script error: ";
-            error += pkgprefix;
+            error += pkg->name;
             error += "::";
-            error += event;
+            error += QuestEventSubroutines[event];
             error += " - ";
 			if(strlen(err) > 0)
 				error += err;
@@ -741,24 +747,10 @@ int PerlembParser::SendCommands(const char *pkgprefix, const char *event, uint32
 
 #ifdef EMBPERL_XS_CLASSES
 	if(!quest_manager.QuestsRunning()) {
-		auto iter = clear_vars_.begin();
-		std::string eval_str;
-		while(iter != clear_vars_.end()) {
-			eval_str += iter->first;
-			eval_str += " = undef;";
-			++iter;
+		for(auto iter = clear_vars_.begin(); iter != clear_vars_.end(); ++iter) {
+			sv_setsv(GvSVn(*iter), &PL_sv_undef);
 		}
 		clear_vars_.clear();
-
-		try {
-			perl->eval(eval_str.c_str());
-		}
-		catch (const char * err) {
-			std::string error = "Script clear error: ";
-			if (strlen(err) > 0)
-				error += err;
-			AddError(error);
-		}
 	}
 #endif
 
@@ -849,39 +841,35 @@ void PerlembParser::GetQuestTypes(bool &isPlayerQuest, bool &isGlobalPlayerQuest
 	}
 }
 
-void PerlembParser::GetQuestPackageName(bool &isPlayerQuest, bool &isGlobalPlayerQuest, bool &isGlobalNPC, bool &isItemQuest, 
-		bool &isSpellQuest, std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
-		NPC* npcmob, ItemInst* iteminst, bool global)
+PerlQuestPackage *PerlembParser::GetQuestPackage(bool &isPlayerQuest, bool &isGlobalPlayerQuest, bool &isGlobalNPC, bool &isItemQuest, 
+		bool &isSpellQuest, QuestEventID event, uint32 objid, const char * data, NPC* npcmob, ItemInst* iteminst, bool global)
 {
 	if(!isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest && !isSpellQuest) {
 		if(global) {
 			isGlobalNPC = true;
-			package_name = "qst_global_npc";
+			return GetPackage(perlPackageGlobalNPC, 0);
 		} else {
-			package_name = "qst_npc_";
-			package_name += itoa(npcmob->GetNPCTypeID());
+			return GetPackage(perlPackageNPC, npcmob->GetNPCTypeID());
 		}
 	}
 	else if(isItemQuest) {
 		// need a valid ItemInst pointer check here..unsure how to cancel this process
 		const Item_Struct* item = iteminst->GetItem();
-		package_name = "qst_item_";
-		package_name += itoa(item->ID);
+		return GetPackage(perlPackageItem, item->ID);
 	}
 	else if(isPlayerQuest) {
-		package_name = "qst_player";
+		return GetPackage(perlPackagePlayer, 0);
 	}
 	else if(isGlobalPlayerQuest) {
-		package_name = "qst_global_player";
+		return GetPackage(perlPackageGlobalPlayer, 0);
 	}
 	else
 	{
-		package_name = "qst_spell_";
-		package_name += data;
+		return GetPackage(perlPackageSpell, atoi(data));
 	}
 }
 
-void PerlembParser::ExportCharID(const std::string &package_name, int &char_id, NPC *npcmob, Mob *mob) {
+void PerlembParser::ExportCharID(PerlQuestPackage *pkg, int &char_id, NPC *npcmob, Mob *mob) {
 	if (mob && mob->IsClient()) {  // some events like waypoint and spawn don't have a player involved
 		char_id = mob->CastToClient()->CharacterID();
 	} else {
@@ -894,137 +882,91 @@ void PerlembParser::ExportCharID(const std::string &package_name, int &char_id,
 			char_id = -static_cast<int>(mob->CastToNPC()->GetNPCTypeID());  // make char id negative npc id as a fudge
 		}
 	}
-	ExportVar(package_name.c_str(), "charid", char_id);
+	ExportVar(pkg, "charid", char_id);
 }
 
 void PerlembParser::ExportQGlobals(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
-	bool isSpellQuest, std::string &package_name, NPC *npcmob, Mob *mob, int char_id) {
+	bool isSpellQuest, PerlQuestPackage *pkg, NPC *npcmob, Mob *mob, int char_id) {
+	QGlobalCache *npc_c = nullptr;
+	QGlobalCache *char_c = nullptr;
+	QGlobalCache *zone_c = nullptr;
+	uint32 npc_id = 0;
+
 	//NPC quest
 	if(!isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest && !isSpellQuest)
 	{
 		//only export for npcs that are global enabled.
-		if(npcmob && npcmob->GetQglobal())
-		{
-			std::map<std::string, std::string> globhash;
-			QGlobalCache *npc_c = nullptr;
-			QGlobalCache *char_c = nullptr;
-			QGlobalCache *zone_c = nullptr;
+		if(!npcmob || !npcmob->GetQglobal())
+			return;
 
-			//retrieve our globals
-			npc_c = npcmob->GetQGlobals();
-			if(mob && mob->IsClient())
-				char_c = mob->CastToClient()->GetQGlobals();
-			zone_c = zone->GetQGlobals();
-
-			if(!npc_c)
-			{
-				npc_c = npcmob->CreateQGlobals();
-				npc_c->LoadByNPCID(npcmob->GetNPCTypeID());
-			}
-
-			if(!char_c)
-			{
-				if(mob && mob->IsClient())
-				{
-					char_c = mob->CastToClient()->CreateQGlobals();
-					char_c->LoadByCharID(mob->CastToClient()->CharacterID());
-				}
-			}
-
-			if(!zone_c)
-			{
-				zone_c = zone->CreateQGlobals();
-				zone_c->LoadByZoneID(zone->GetZoneID());
-				zone_c->LoadByGlobalContext();
-			}
-
-			std::list<QGlobal> globalMap;
-			if(npc_c)
-			{
-				QGlobalCache::Combine(globalMap, npc_c->GetBucket(), npcmob->GetNPCTypeID(), char_id, zone->GetZoneID());
-			}
-
-			if(char_c)
-			{
-				QGlobalCache::Combine(globalMap, char_c->GetBucket(), npcmob->GetNPCTypeID(), char_id, zone->GetZoneID());
-			}
-
-			if(zone_c)
-			{
-				QGlobalCache::Combine(globalMap, zone_c->GetBucket(), npcmob->GetNPCTypeID(), char_id, zone->GetZoneID());
-			}
-			
-			std::list<QGlobal>::iterator iter = globalMap.begin();
-			while(iter != globalMap.end())
-			{
-				globhash[(*iter).name] = (*iter).value;
-				ExportVar(package_name.c_str(), (*iter).name.c_str(), (*iter).value.c_str());
-				++iter;
-			}
-			ExportHash(package_name.c_str(), "qglobals", globhash);
+		npc_id = npcmob->GetNPCTypeID();
+		npc_c = npcmob->GetQGlobals();
+		if(!npc_c)
+		{
+			npc_c = npcmob->CreateQGlobals();
+			npc_c->LoadByNPCID(npc_id);
 		}
 	}
-	else
-	{
-		std::map<std::string, std::string> globhash;
-		QGlobalCache *char_c = nullptr;
-		QGlobalCache *zone_c = nullptr;
-
-		//retrieve our globals
-		if(mob && mob->IsClient())
-			char_c = mob->CastToClient()->GetQGlobals();
-		zone_c = zone->GetQGlobals();
 
+	//retrieve our globals
+	if(mob && mob->IsClient())
+	{
+		char_c = mob->CastToClient()->GetQGlobals();
 		if(!char_c)
 		{
-			if(mob && mob->IsClient())
-			{
-				char_c = mob->CastToClient()->CreateQGlobals();
-				char_c->LoadByCharID(mob->CastToClient()->CharacterID());
-			}
+			char_c = mob->CastToClient()->CreateQGlobals();
+			char_c->LoadByCharID(mob->CastToClient()->CharacterID());
 		}
+	}
 
-		if(!zone_c)
-		{
-			zone_c = zone->CreateQGlobals();
-			zone_c->LoadByZoneID(zone->GetZoneID());
-			zone_c->LoadByGlobalContext();
-		}
+	zone_c = zone->GetQGlobals();
+	if(!zone_c)
+	{
+		zone_c = zone->CreateQGlobals();
+		zone_c->LoadByZoneID(zone->GetZoneID());
+		zone_c->LoadByGlobalContext();
+	}
 
-		std::list<QGlobal> globalMap;
-		if(char_c)
-		{
-			QGlobalCache::Combine(globalMap, char_c->GetBucket(), 0, char_id, zone->GetZoneID());
-		}
+	//the view points into the caches, nothing below changes them
+	qglobal_view_.clear();
+	if(npc_c)
+		QGlobalCache::Combine(qglobal_view_, npc_c->GetBucket(), npc_id, char_id, zone->GetZoneID());
+	if(char_c)
+		QGlobalCache::Combine(qglobal_view_, char_c->GetBucket(), npc_id, char_id, zone->GetZoneID());
+	if(zone_c)
+		QGlobalCache::Combine(qglobal_view_, zone_c->GetBucket(), npc_id, char_id, zone->GetZoneID());
 
-		if(zone_c)
-		{
-			QGlobalCache::Combine(globalMap, zone_c->GetBucket(), 0, char_id, zone->GetZoneID());
-		}
+	for(auto iter = qglobal_view_.begin(); iter != qglobal_view_.end(); ++iter)
+		ExportVar(pkg, (*iter)->name.c_str(), (*iter)->value.c_str());
 
-		std::list<QGlobal>::iterator iter = globalMap.begin();
-		while(iter != globalMap.end())
+	GV *qglobals = GetExportGV(pkg, "qglobals");
+	if(qglobals)
+	{
+		HV *hv = GvHVn(qglobals);
+		hv_clear(hv);
+		for(auto iter = qglobal_view_.begin(); iter != qglobal_view_.end(); ++iter)
 		{
-			globhash[(*iter).name] = (*iter).value;
-			ExportVar(package_name.c_str(), (*iter).name.c_str(), (*iter).value.c_str());
-			++iter;
+			const QGlobal *g = *iter;
+			SV *val = newSVpvn(g->value.c_str(), g->value.length());
+			if(hv_store(hv, g->name.c_str(), static_cast<I32>(g->name.length()), val, 0) == nullptr)
+				SvREFCNT_dec(val);
 		}
-		ExportHash(package_name.c_str(), "qglobals", globhash);
 	}
 }
 
 void PerlembParser::ExportMobVariables(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
-		bool isSpellQuest, std::string &package_name, Mob *mob, NPC *npcmob) 
+		bool isSpellQuest, PerlQuestPackage *pkg, Mob *mob, NPC *npcmob) 
 {
 	uint8 fac = 0;
 	if (mob && mob->IsClient()) {
-		ExportVar(package_name.c_str(), "uguild_id", mob->CastToClient()->GuildID());
-		ExportVar(package_name.c_str(), "uguildrank", mob->CastToClient()->GuildRank());
-		ExportVar(package_name.c_str(), "status", mob->CastToClient()->Admin());
+		ExportVar(pkg, "uguild_id", mob->CastToClient()->GuildID());
+		ExportVar(pkg, "uguildrank", mob->CastToClient()->GuildRank());
+		ExportVar(pkg, "status", mob->CastToClient()->Admin());
 	}
 
 	if(!isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest) {
-		if (mob && npcmob && mob->IsClient()) {
+		//faction is only looked up for scripts that will see it
+		if (mob && npcmob && mob->IsClient() && !isSpellQuest && GetExportGV(pkg, "faction")) {
 			Client* client = mob->CastToClient();
 
 			fac = client->GetFactionLevel(client->CharacterID(), npcmob->GetID(), client->GetRace(), 
@@ -1033,50 +975,50 @@ void PerlembParser::ExportMobVariables(bool isPlayerQuest, bool isGlobalPlayerQu
 	}
 
 	if(mob) {
-		ExportVar(package_name.c_str(), "name", mob->GetName());
-		ExportVar(package_name.c_str(), "race", GetRaceName(mob->GetRace()));
-		ExportVar(package_name.c_str(), "class", GetEQClassName(mob->GetClass()));
-		ExportVar(package_name.c_str(), "ulevel", mob->GetLevel());
-		ExportVar(package_name.c_str(), "userid", mob->GetID());
+		ExportVar(pkg, "name", mob->GetName());
+		ExportVar(pkg, "race", GetRaceName(mob->GetRace()));
+		ExportVar(pkg, "class", GetEQClassName(mob->GetClass()));
+		ExportVar(pkg, "ulevel", mob->GetLevel());
+		ExportVar(pkg, "userid", mob->GetID());
 	}
 
 	if(!isPlayerQuest && !isGlobalPlayerQuest && !isItemQuest && !isSpellQuest)
 	{
 		if (npcmob)
 		{
-			ExportVar(package_name.c_str(), "mname", npcmob->GetName());
-			ExportVar(package_name.c_str(), "mobid", npcmob->GetID());
-			ExportVar(package_name.c_str(), "mlevel", npcmob->GetLevel());
-			ExportVar(package_name.c_str(), "hpratio",npcmob->GetHPRatio());
-			ExportVar(package_name.c_str(), "x", npcmob->GetX() );
-			ExportVar(package_name.c_str(), "y", npcmob->GetY() );
-			ExportVar(package_name.c_str(), "z", npcmob->GetZ() );
-			ExportVar(package_name.c_str(), "h", npcmob->GetHeading() );
+			ExportVar(pkg, "mname", npcmob->GetName());
+			ExportVar(pkg, "mobid", npcmob->GetID());
+			ExportVar(pkg, "mlevel", npcmob->GetLevel());
+			ExportVar(pkg, "hpratio",npcmob->GetHPRatio());
+			ExportVar(pkg, "x", npcmob->GetX() );
+			ExportVar(pkg, "y", npcmob->GetY() );
+			ExportVar(pkg, "z", npcmob->GetZ() );
+			ExportVar(pkg, "h", npcmob->GetHeading() );
 			if(npcmob->GetTarget()) {
-				ExportVar(package_name.c_str(), "targetid", npcmob->GetTarget()->GetID());
-				ExportVar(package_name.c_str(), "targetname", npcmob->GetTarget()->GetName());
+				ExportVar(pkg, "targetid", npcmob->GetTarget()->GetID());
+				ExportVar(pkg, "targetname", npcmob->GetTarget()->GetName());
 			}
 		}
 
 		if (fac) {
-			ExportVar(package_name.c_str(), "faction", itoa(fac));
+			ExportVar(pkg, "faction", itoa(fac));
 		}
 	}
 }
 
-void PerlembParser::ExportZoneVariables(std::string &package_name) {
+void PerlembParser::ExportZoneVariables(PerlQuestPackage *pkg) {
 	if (zone) {
-		ExportVar(package_name.c_str(), "zoneid", zone->GetZoneID());
-		ExportVar(package_name.c_str(), "zoneln", zone->GetLongName());
-		ExportVar(package_name.c_str(), "zonesn", zone->GetShortName());
-		ExportVar(package_name.c_str(), "instanceid", zone->GetInstanceID());
-		ExportVar(package_name.c_str(), "instanceversion", zone->GetInstanceVersion());
+		ExportVar(pkg, "zoneid", zone->GetZoneID());
+		ExportVar(pkg, "zoneln", zone->GetLongName());
+		ExportVar(pkg, "zonesn", zone->GetShortName());
+		ExportVar(pkg, "instanceid", zone->GetInstanceID());
+		ExportVar(pkg, "instanceversion", zone->GetInstanceVersion());
 		TimeOfDay_Struct eqTime;
 		zone->zone_time.getEQTimeOfDay( time(0), &eqTime);
-		ExportVar(package_name.c_str(), "zonehour", eqTime.hour - 1);
-		ExportVar(package_name.c_str(), "zonemin", eqTime.minute);
-		ExportVar(package_name.c_str(), "zonetime", (eqTime.hour - 1) * 100 + eqTime.minute);
-		ExportVar(package_name.c_str(), "zoneweather", zone->zone_weather);
+		ExportVar(pkg, "zonehour", eqTime.hour - 1);
+		ExportVar(pkg, "zonemin", eqTime.minute);
+		ExportVar(pkg, "zonetime", (eqTime.hour - 1) * 100 + eqTime.minute);
+		ExportVar(pkg, "zoneweather", zone->zone_weather);
 	}
 }
 
@@ -1084,37 +1026,50 @@ void PerlembParser::ExportZoneVariables(std::string &package_name) {
 #define HASITEM_LAST 29 // this includes worn plus 8 base slots
 #define HASITEM_ISNULLITEM(item) ((item==-1) || (item==0))
 
-void PerlembParser::ExportItemVariables(std::string &package_name, Mob *mob) {
-	if(mob && mob->IsClient())
-	{
-		std::string hashname = package_name + std::string("::hasitem");
+//push (@{$hash{key}}, value);
+static void PushHashArray(HV *hv, int key, int value) {
+	char key_buf[16];
+	int key_len = snprintf(key_buf, sizeof(key_buf), "%d", key);
+
+	SV **entry = hv_fetch(hv, key_buf, key_len, 1);
+	if(!entry)
+		return;
 
+	if(!SvROK(*entry) || SvTYPE(SvRV(*entry)) != SVt_PVAV) {
+		SV *rv = newRV_noinc((SV*)newAV());
+		sv_setsv(*entry, rv);
+		SvREFCNT_dec(rv);
+	}
+
+	av_push((AV*)SvRV(*entry), newSViv(value));
+}
+
+void PerlembParser::ExportItemVariables(PerlQuestPackage *pkg, Mob *mob) {
+	if(!mob || !mob->IsClient())
+		return;
+
+	GV *hasitem = GetExportGV(pkg, "hasitem");
+	if(hasitem)
+	{
 		//start with an empty hash
-		perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
+		HV *hv = GvHVn(hasitem);
+		hv_clear(hv);
 
 		for(int slot = HASITEM_FIRST; slot <= HASITEM_LAST; slot++)
 		{
-			char *hi_decl=nullptr;
 			int itemid = mob->CastToClient()->GetItemIDAt(slot);
 			if(!HASITEM_ISNULLITEM(itemid))
-			{
-				MakeAnyLenString(&hi_decl, "push (@{$%s{%d}},%d);", hashname.c_str(), itemid, slot);
-				perl->eval(hi_decl);
-				safe_delete_array(hi_decl);
-			}
+				PushHashArray(hv, itemid, slot);
 		}
 	}
 
-	if(mob && mob->IsClient()) {
-		std::string hashname = package_name + std::string("::oncursor");
-		perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
-		char *hi_decl = nullptr;
+	GV *oncursor = GetExportGV(pkg, "oncursor");
+	if(oncursor) {
+		HV *hv = GvHVn(oncursor);
+		hv_clear(hv);
 		int itemid = mob->CastToClient()->GetItemIDAt(30);
-		if(!HASITEM_ISNULLITEM(itemid)) {
-			MakeAnyLenString(&hi_decl, "push (@{$%s{%d}},%d);",hashname.c_str(), itemid, 30);
-			perl->eval(hi_decl);
-			safe_delete_array(hi_decl);
-		}
+		if(!HASITEM_ISNULLITEM(itemid))
+			PushHashArray(hv, itemid, 30);
 	}
 }
 
@@ -1122,7 +1077,7 @@ void PerlembParser::ExportItemVariables(std::string &package_name, Mob *mob) {
 #undef HASITEM_LAST
 #undef HASITEM_ISNULLITEM
 
-void PerlembParser::ExportEventVariables(std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
+void PerlembParser::ExportEventVariables(PerlQuestPackage *pkg, QuestEventID event, uint32 objid, const char * data, 
 	NPC* npcmob, ItemInst* iteminst, Mob* mob, uint32 extradata, std::vector<EQEmu::Any> *extra_pointers) 
 {
 	switch (event) {
@@ -1131,9 +1086,9 @@ void PerlembParser::ExportEventVariables(std::string &package_name, QuestEventID
 				npcmob->DoQuestPause(mob);
 			}
 
-			ExportVar(package_name.c_str(), "data", objid);
-			ExportVar(package_name.c_str(), "text", data);
-			ExportVar(package_name.c_str(), "langid", extradata);
+			ExportVar(pkg, "data", objid);
+			ExportVar(pkg, "text", data);
+			ExportVar(pkg, "langid", extradata);
 			break;
 		}
 
@@ -1147,193 +1102,202 @@ void PerlembParser::ExportEventVariables(std::string &package_name, QuestEventID
 					var_name += std::to_string(i + 1);
 
 					if(inst) {
-						ExportVar(package_name.c_str(), var_name.c_str(), inst->GetItem()->ID);
+						ExportVar(pkg, var_name.c_str(), inst->GetItem()->ID);
 
 						std::string temp_var_name = var_name;
 						temp_var_name += "_charges";
-						ExportVar(package_name.c_str(), temp_var_name.c_str(), inst->GetCharges());
+						ExportVar(pkg, temp_var_name.c_str(), inst->GetCharges());
 
 						temp_var_name = var_name;
 						temp_var_name += "_attuned";
-						ExportVar(package_name.c_str(), temp_var_name.c_str(), inst->IsAttuned());
+						ExportVar(pkg, temp_var_name.c_str(), inst->IsAttuned());
 					} else {
-						ExportVar(package_name.c_str(), var_name.c_str(), 0);
+						ExportVar(pkg, var_name.c_str(), 0);
 
 						std::string temp_var_name = var_name;
 						temp_var_name += "_charges";
-						ExportVar(package_name.c_str(), temp_var_name.c_str(), 0);
+						ExportVar(pkg, temp_var_name.c_str(), 0);
 
 						temp_var_name = var_name;
 						temp_var_name += "_attuned";
-						ExportVar(package_name.c_str(), temp_var_name.c_str(), 0);
+						ExportVar(pkg, temp_var_name.c_str(), 0);
 					}
 				}
 			}
 
-			ExportVar(package_name.c_str(), "copper", GetVar("copper." + std::string(itoa(objid))).c_str());
-			ExportVar(package_name.c_str(), "silver", GetVar("silver." + std::string(itoa(objid))).c_str());
-			ExportVar(package_name.c_str(), "gold", GetVar("gold." + std::string(itoa(objid))).c_str());
-			ExportVar(package_name.c_str(), "platinum", GetVar("platinum." + std::string(itoa(objid))).c_str());
-			std::string hashname = package_name + std::string("::itemcount");
-			perl->eval(std::string("%").append(hashname).append(" = ();").c_str());
-			perl->eval(std::string("++$").append(hashname).append("{$").append(package_name).append("::item1};").c_str());
-			perl->eval(std::string("++$").append(hashname).append("{$").append(package_name).append("::item2};").c_str());
-			perl->eval(std::string("++$").append(hashname).append("{$").append(package_name).append("::item3};").c_str());
-			perl->eval(std::string("++$").append(hashname).append("{$").append(package_name).append("::item4};").c_str());
+			ExportVar(pkg, "copper", GetVar("copper." + std::string(itoa(objid))).c_str());
+			ExportVar(pkg, "silver", GetVar("silver." + std::string(itoa(objid))).c_str());
+			ExportVar(pkg, "gold", GetVar("gold." + std::string(itoa(objid))).c_str());
+			ExportVar(pkg, "platinum", GetVar("platinum." + std::string(itoa(objid))).c_str());
+			//++$itemcount{$item1} through $item4
+			GV *itemcount = GetExportGV(pkg, "itemcount");
+			if(itemcount) {
+				HV *hv = GvHVn(itemcount);
+				hv_clear(hv);
+				size_t sz = extra_pointers ? std::min<size_t>(extra_pointers->size(), 4) : 0;
+				for(size_t i = 0; i < sz; ++i) {
+					ItemInst *inst = EQEmu::any_cast<ItemInst*>(extra_pointers->at(i));
+					char key_buf[16];
+					int key_len = snprintf(key_buf, sizeof(key_buf), "%u", inst ? inst->GetItem()->ID : 0);
+					SV **count = hv_fetch(hv, key_buf, key_len, 1);
+					if(count)
+						sv_setiv(*count, SvOK(*count) ? SvIV(*count) + 1 : 1);
+				}
+			}
 			break;
 		}
 
 		case EVENT_WAYPOINT_ARRIVE:
 		case EVENT_WAYPOINT_DEPART: {
-			ExportVar(package_name.c_str(), "wp", data);
+			ExportVar(pkg, "wp", data);
 			break;
 		}
 
 		case EVENT_HP: {
 			if (extradata == 1) {
-				ExportVar(package_name.c_str(), "hpevent", "-1");
-				ExportVar(package_name.c_str(), "inchpevent", data);
+				ExportVar(pkg, "hpevent", "-1");
+				ExportVar(pkg, "inchpevent", data);
 			}
 			else
 			{
-				ExportVar(package_name.c_str(), "hpevent", data);
-				ExportVar(package_name.c_str(), "inchpevent", "-1");
+				ExportVar(pkg, "hpevent", data);
+				ExportVar(pkg, "inchpevent", "-1");
 			}
 			break;
 		}
 
 		case EVENT_TIMER: {
-			ExportVar(package_name.c_str(), "timer", data);
+			ExportVar(pkg, "timer", data);
 			break;
 		}
 
 		case EVENT_SIGNAL: {
-			ExportVar(package_name.c_str(), "signal", data);
+			ExportVar(pkg, "signal", data);
 			break;
 		}
 
 		case EVENT_NPC_SLAY: {
-			ExportVar(package_name.c_str(), "killed", mob->GetNPCTypeID());
+			ExportVar(pkg, "killed", mob->GetNPCTypeID());
 			break;
 		}
 
 		case EVENT_COMBAT: {
-			ExportVar(package_name.c_str(), "combat_state", data);
+			ExportVar(pkg, "combat_state", data);
 			break;
 		}
 
 		case EVENT_CLICK_DOOR: {
-			ExportVar(package_name.c_str(), "doorid", data);
-			ExportVar(package_name.c_str(), "version", zone->GetInstanceVersion());
+			ExportVar(pkg, "doorid", data);
+			ExportVar(pkg, "version", zone->GetInstanceVersion());
 			break;
 		}
 
 		case EVENT_LOOT: {
 			Seperator sep(data);
-			ExportVar(package_name.c_str(), "looted_id", sep.arg[0]);
-			ExportVar(package_name.c_str(), "looted_charges", sep.arg[1]);
-			ExportVar(package_name.c_str(), "corpse", sep.arg[2]);
+			ExportVar(pkg, "looted_id", sep.arg[0]);
+			ExportVar(pkg, "looted_charges", sep.arg[1]);
+			ExportVar(pkg, "corpse", sep.arg[2]);
 			break;
 		}
 
 		case EVENT_ZONE:{
-			ExportVar(package_name.c_str(), "target_zone_id", data);
+			ExportVar(pkg, "target_zone_id", data);
 			break;
 		}
 		
 		case EVENT_CAST_ON:
 		case EVENT_CAST:
 		case EVENT_CAST_BEGIN: {
-			ExportVar(package_name.c_str(), "spell_id", data);
+			ExportVar(pkg, "spell_id", data);
 			break;
 		}
 
 		case EVENT_TASK_ACCEPTED:{
-			ExportVar(package_name.c_str(), "task_id", data);
+			ExportVar(pkg, "task_id", data);
 			break;
 		}
 
 		case EVENT_TASK_STAGE_COMPLETE:{
 			Seperator sep(data);
-			ExportVar(package_name.c_str(), "task_id", sep.arg[0]);
-			ExportVar(package_name.c_str(), "activity_id", sep.arg[1]);
+			ExportVar(pkg, "task_id", sep.arg[0]);
+			ExportVar(pkg, "activity_id", sep.arg[1]);
 			break;
 		}
 
 		case EVENT_TASK_FAIL:{
 			Seperator sep(data);
-			ExportVar(package_name.c_str(), "task_id", sep.arg[0]);
+			ExportVar(pkg, "task_id", sep.arg[0]);
 			break;
 		}
 
 		case EVENT_TASK_COMPLETE:
 		case EVENT_TASK_UPDATE:{
 			Seperator sep(data);
-			ExportVar(package_name.c_str(), "donecount", sep.arg[0]);
-			ExportVar(package_name.c_str(), "activity_id", sep.arg[1]);
-			ExportVar(package_name.c_str(), "task_id", sep.arg[2]);
+			ExportVar(pkg, "donecount", sep.arg[0]);
+			ExportVar(pkg, "activity_id", sep.arg[1]);
+			ExportVar(pkg, "task_id", sep.arg[2]);
 			break;
 		}
 
 		case EVENT_PLAYER_PICKUP:{
-			ExportVar(package_name.c_str(), "picked_up_id", data);
+			ExportVar(pkg, "picked_up_id", data);
 			break;		
 		}
 
 		case EVENT_AGGRO_SAY: {
-			ExportVar(package_name.c_str(), "data", objid);
-			ExportVar(package_name.c_str(), "text", data);
-			ExportVar(package_name.c_str(), "langid", extradata);
+			ExportVar(pkg, "data", objid);
+			ExportVar(pkg, "text", data);
+			ExportVar(pkg, "langid", extradata);
 			break;
 		}
 
 		case EVENT_POPUP_RESPONSE:{
-			ExportVar(package_name.c_str(), "popupid", data);
+			ExportVar(pkg, "popupid", data);
 			break;
 		}
 		case EVENT_ENVIRONMENTAL_DAMAGE:{
 			Seperator sep(data);
-			ExportVar(package_name.c_str(), "env_damage", sep.arg[0]);
-			ExportVar(package_name.c_str(), "env_damage_type", sep.arg[1]);
-			ExportVar(package_name.c_str(), "env_final_damage", sep.arg[2]);
+			ExportVar(pkg, "env_damage", sep.arg[0]);
+			ExportVar(pkg, "env_damage_type", sep.arg[1]);
+			ExportVar(pkg, "env_final_damage", sep.arg[2]);
 			break;
 		}
 
 		case EVENT_PROXIMITY_SAY: {
-			ExportVar(package_name.c_str(), "data", objid);
-			ExportVar(package_name.c_str(), "text", data);
-			ExportVar(package_name.c_str(), "langid", extradata);
+			ExportVar(pkg, "data", objid);
+			ExportVar(pkg, "text", data);
+			ExportVar(pkg, "langid", extradata);
 			break;
 		}
 
 		case EVENT_SCALE_CALC:
 		case EVENT_ITEM_ENTER_ZONE: {
 			// need a valid ItemInst pointer check here..unsure how to cancel this process
-			ExportVar(package_name.c_str(), "itemid", objid);
-			ExportVar(package_name.c_str(), "itemname", iteminst->GetItem()->Name);
+			ExportVar(pkg, "itemid", objid);
+			ExportVar(pkg, "itemname", iteminst->GetItem()->Name);
 			break;
 		}
 
 		case EVENT_ITEM_CLICK_CAST:
 		case EVENT_ITEM_CLICK: {
 			// need a valid ItemInst pointer check here..unsure how to cancel this process
-			ExportVar(package_name.c_str(), "itemid", objid);
-			ExportVar(package_name.c_str(), "itemname", iteminst->GetItem()->Name);
-			ExportVar(package_name.c_str(), "slotid", extradata);
+			ExportVar(pkg, "itemid", objid);
+			ExportVar(pkg, "itemname", iteminst->GetItem()->Name);
+			ExportVar(pkg, "slotid", extradata);
 			break;
 		}
 
 		case EVENT_GROUP_CHANGE: {
 			if(mob && mob->IsClient())
 			{
-				ExportVar(package_name.c_str(), "grouped", mob->IsGrouped());
-				ExportVar(package_name.c_str(), "raided", mob->IsRaidGrouped());
+				ExportVar(pkg, "grouped", mob->IsGrouped());
+				ExportVar(pkg, "raided", mob->IsRaidGrouped());
 			}
 			break;
 		}
 
 		case EVENT_HATE_LIST: {
-			ExportVar(package_name.c_str(), "hate_state", data);
+			ExportVar(pkg, "hate_state", data);
 			break;
 		}
 
@@ -1342,7 +1306,7 @@ void PerlembParser::ExportEventVariables(std::string &package_name, QuestEventID
 		case EVENT_SPELL_BUFF_TIC_CLIENT:
 		case EVENT_SPELL_BUFF_TIC_NPC:
 		{
-			ExportVar(package_name.c_str(), "caster_id", extradata);
+			ExportVar(pkg, "caster_id", extradata);
 			break;
 		}
 
@@ -1350,51 +1314,51 @@ void PerlembParser::ExportEventVariables(std::string &package_name, QuestEventID
 		case EVENT_COMBINE_SUCCESS:
 		case EVENT_COMBINE_FAILURE:
 		{
-			ExportVar(package_name.c_str(), "recipe_id", extradata);
-			ExportVar(package_name.c_str(), "recipe_name", data);
+			ExportVar(pkg, "recipe_id", extradata);
+			ExportVar(pkg, "recipe_name", data);
 			break;
 		}
 
 		case EVENT_FORAGE_SUCCESS: {
-			ExportVar(package_name.c_str(), "foraged_item", extradata);
+			ExportVar(pkg, "foraged_item", extradata);
 			break; 
 		}
 
 		case EVENT_FISH_SUCCESS: {
-			ExportVar(package_name.c_str(), "fished_item", extradata);
+			ExportVar(pkg, "fished_item", extradata);
 			break; 
 		}
 
 		case EVENT_CLICK_OBJECT: {
-			ExportVar(package_name.c_str(), "objectid", data);
+			ExportVar(pkg, "objectid", data);
 			break;
 		}
 
 		case EVENT_DISCOVER_ITEM: {
-			ExportVar(package_name.c_str(), "itemid", extradata);
+			ExportVar(pkg, "itemid", extradata);
 			break;
 		}
 
 		case EVENT_COMMAND: {
-			ExportVar(package_name.c_str(), "text", data);
-			ExportVar(package_name.c_str(), "data", "0");
-			ExportVar(package_name.c_str(), "langid", "0");
+			ExportVar(pkg, "text", data);
+			ExportVar(pkg, "data", "0");
+			ExportVar(pkg, "langid", "0");
 			break;
 		}
 
 		case EVENT_RESPAWN: {
-			ExportVar(package_name.c_str(), "option", data);
-			ExportVar(package_name.c_str(), "resurrect", extradata);
+			ExportVar(pkg, "option", data);
+			ExportVar(pkg, "resurrect", extradata);
 			break;
 		}
 
 		case EVENT_DEATH:
 		case EVENT_DEATH_COMPLETE: {
 			Seperator sep(data);
-			ExportVar(package_name.c_str(), "killer_id", sep.arg[0]);
-			ExportVar(package_name.c_str(), "killer_damage", sep.arg[1]);
-			ExportVar(package_name.c_str(), "killer_spell", sep.arg[2]);
-			ExportVar(package_name.c_str(), "killer_skill", sep.arg[3]);
+			ExportVar(pkg, "killer_id", sep.arg[0]);
+			ExportVar(pkg, "killer_damage", sep.arg[1]);
+			ExportVar(pkg, "killer_spell", sep.arg[2]);
+			ExportVar(pkg, "killer_skill", sep.arg[3]);
 			break;
 		}
 
@@ -25,12 +25,17 @@
 #include <string>
 #include <queue>
 #include <map>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "embperl.h"
 
 class ItemInst;
 class Mob;
 class Client;
 class NPC;
+struct QGlobal;
 
 typedef enum 
 {
@@ -39,6 +44,47 @@ typedef enum
 	questFailedToLoad
 } PerlQuestStatus;
 
+typedef enum
+{
+	perlPackageNPC,
+	perlPackageGlobalNPC,
+	perlPackagePlayer,
+	perlPackageGlobalPlayer,
+	perlPackageItem,
+	perlPackageSpell
+} PerlPackageType;
+
+struct PerlVarNameHash {
+	size_t operator()(const char *name) const {
+		size_t hash = 5381;
+		while(*name)
+			hash = hash * 33 ^ static_cast<unsigned char>(*name++);
+		return hash;
+	}
+};
+
+struct PerlVarNameEqual {
+	bool operator()(const char *a, const char *b) const { return strcmp(a, b) == 0; }
+};
+
+//What the parser has looked up in one quest package, so events don't look it up by name again.
+//Everything here belongs to the interpreter and goes away on ReloadQuests or when the script is loaded again.
+struct PerlQuestPackage {
+	std::string name;
+	//the compiled sub for each event, nullptr if the package has none
+	CV *subs[_LargestEventID];
+	//exported variables by name, nullptr for ones the package never refers to
+	std::unordered_map<const char*, GV*, PerlVarNameHash, PerlVarNameEqual> vars;
+	//owns the names vars is keyed by
+	std::deque<std::string> var_names;
+	//set when the script may find variables at run time, then every variable is exported
+	bool export_all;
+	GV *client;
+	GV *npc;
+	GV *questitem;
+	GV *entity_list;
+};
+
 class PerlembParser : public QuestInterface {
 public:
 	PerlembParser();
@@ -78,31 +124,34 @@ public:
 private:
 	Embperl *perl;
 	
-	void ExportHash(const char *pkgprefix, const char *hashname, std::map<std::string, std::string> &vals);
-	void ExportVar(const char *pkgprefix, const char *varname, const char *value);
-	void ExportVar(const char *pkgprefix, const char *varname, int32 value);
-	void ExportVar(const char *pkgprefix, const char *varname, uint32 value);
-	void ExportVar(const char *pkgprefix, const char *varname, float value);
+	PerlQuestPackage *GetPackage(PerlPackageType type, uint32 id);
+	void ResetPackage(PerlPackageType type, uint32 id, const std::string &filename, bool loaded);
+	void ReleasePackage(PerlQuestPackage &pkg);
+	GV *GetExportGV(PerlQuestPackage *pkg, const char *varname, bool always = false);
+
+	void ExportVar(PerlQuestPackage *pkg, const char *varname, const char *value);
+	void ExportVar(PerlQuestPackage *pkg, const char *varname, int32 value);
+	void ExportVar(PerlQuestPackage *pkg, const char *varname, uint32 value);
+	void ExportVar(PerlQuestPackage *pkg, const char *varname, float value);
 	void ExportVarComplex(const char *pkgprefix, const char *varname, const char *value);
 
 	int EventCommon(QuestEventID event, uint32 objid, const char * data, NPC* npcmob, ItemInst* iteminst, Mob* mob, 
 		uint32 extradata, bool global, std::vector<EQEmu::Any> *extra_pointers);
-	int SendCommands(const char *pkgprefix, const char *event, uint32 npcid, Mob* other, Mob* mob, ItemInst *iteminst);
+	int SendCommands(PerlQuestPackage *pkg, QuestEventID event, uint32 npcid, Mob* other, Mob* mob, ItemInst *iteminst);
 	void MapFunctions();
 
 	void GetQuestTypes(bool &isPlayerQuest, bool &isGlobalPlayerQuest, bool &isGlobalNPC, bool &isItemQuest, 
 		bool &isSpellQuest, QuestEventID event, NPC* npcmob, ItemInst* iteminst, Mob* mob, bool global);
-	void GetQuestPackageName(bool &isPlayerQuest, bool &isGlobalPlayerQuest, bool &isGlobalNPC, bool &isItemQuest, 
-		bool &isSpellQuest, std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
-		NPC* npcmob, ItemInst* iteminst, bool global);
-	void ExportCharID(const std::string &package_name, int &char_id, NPC *npcmob, Mob *mob);
+	PerlQuestPackage *GetQuestPackage(bool &isPlayerQuest, bool &isGlobalPlayerQuest, bool &isGlobalNPC, bool &isItemQuest, 
+		bool &isSpellQuest, QuestEventID event, uint32 objid, const char * data, NPC* npcmob, ItemInst* iteminst, bool global);
+	void ExportCharID(PerlQuestPackage *pkg, int &char_id, NPC *npcmob, Mob *mob);
 	void ExportQGlobals(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
-		bool isSpellQuest, std::string &package_name, NPC *npcmob, Mob *mob, int char_id);
+		bool isSpellQuest, PerlQuestPackage *pkg, NPC *npcmob, Mob *mob, int char_id);
 	void ExportMobVariables(bool isPlayerQuest, bool isGlobalPlayerQuest, bool isGlobalNPC, bool isItemQuest, 
-		bool isSpellQuest, std::string &package_name, Mob *mob, NPC *npcmob);
-	void ExportZoneVariables(std::string &package_name);
-	void ExportItemVariables(std::string &package_name, Mob *mob);
-	void ExportEventVariables(std::string &package_name, QuestEventID event, uint32 objid, const char * data, 
+		bool isSpellQuest, PerlQuestPackage *pkg, Mob *mob, NPC *npcmob);
+	void ExportZoneVariables(PerlQuestPackage *pkg);
+	void ExportItemVariables(PerlQuestPackage *pkg, Mob *mob);
+	void ExportEventVariables(PerlQuestPackage *pkg, QuestEventID event, uint32 objid, const char * data, 
 		NPC* npcmob, ItemInst* iteminst, Mob* mob, uint32 extradata, std::vector<EQEmu::Any> *extra_pointers);
 	
 	std::map<uint32, PerlQuestStatus> npc_quest_status_;
@@ -114,7 +163,13 @@ private:
 
 	std::map<std::string, std::string> vars_;
 	SV *_empty_sv;
-	std::map<std::string, int> clear_vars_;
+	//$client, $npc, $questitem and $entity_list of packages with quests running, undef'd once the last one ends
+	std::unordered_set<GV*> clear_vars_;
+
+	//keyed by PerlPackageType << 32 | id
+	std::unordered_map<uint64, PerlQuestPackage> packages_;
+	//reused by ExportQGlobals
+	std::vector<const QGlobal*> qglobal_view_;
 };
 
 #endif
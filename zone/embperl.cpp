@@ -267,6 +267,16 @@ int Embperl::eval_file(const char * packagename, const char * filename)
 }
 
 int Embperl::dosub(const char * subname, const std::vector<std::string> * args, int mode)
+{
+	return call_sub(subname, nullptr, args, mode);
+}
+
+int Embperl::dosub(CV * sub, const std::vector<std::string> * args, int mode)
+{
+	return call_sub(nullptr, sub, args, mode);
+}
+
+int Embperl::call_sub(const char * subname, CV * sub, const std::vector<std::string> * args, int mode)
 {
 	dSP;
 	int ret_value = 0;
@@ -285,7 +295,10 @@ int Embperl::dosub(const char * subname, const std::vector<std::string> * args,
 	}
 	PUTBACK;
 
-	count = call_pv(subname, mode);
+	if(sub)
+		count = call_sv((SV*)sub, mode);
+	else
+		count = call_pv(subname, mode);
 	SPAGAIN;
 
 	if(SvTRUE(ERRSV))
@@ -334,6 +347,16 @@ bool Embperl::SubExists(const char *package, const char *sub) {
 	return(hv_exists(stash, sub, len));
 }
 
+CV * Embperl::get_sub(const char *package, const char *sub) {
+	if(!gv_stashpv(package, false))
+		return(nullptr);
+	std::string name = std::string(package).append("::").append(sub);
+	CV *cv = get_cv(name.c_str(), 0);
+	if(!cv || (!CvISXSUB(cv) && !CvROOT(cv)))
+		return(nullptr);	//declared or referenced but never defined
+	return(cv);
+}
+
 bool Embperl::VarExists(const char *package, const char *var) {
 	HV *stash = gv_stashpv(package, false);
 	if(!stash)
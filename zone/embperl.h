@@ -73,6 +73,8 @@ private:
 	//install a perl func
 	void init_eval_file(void);
 
+	int call_sub(const char * subname, CV * sub, const std::vector<std::string> * args, int mode);
+
 	bool in_use;	//true if perl is executing
 protected:
 	//the embedded interpreter
@@ -92,6 +94,10 @@ public:
 	int eval(const char * code);
 	//execute a subroutine. throws lasterr on failure
 	int dosub(const char * subname, const std::vector<std::string> * args = nullptr, int mode = G_SCALAR|G_EVAL);
+	//same as above with a sub already looked up, see get_sub
+	int dosub(CV * sub, const std::vector<std::string> * args = nullptr, int mode = G_SCALAR|G_EVAL);
+	//returns the compiled sub named package::sub, or nullptr if there is none. good until the package is reloaded
+	CV * get_sub(const char * package, const char * sub);
 
 	//Access to perl variables
 	//all varnames here should be of the form package::name
@@ -33,6 +33,7 @@
 #include "../common/guilds.h"
 
 #include "guild_mgr.h"
+#include "lua_parser.h"
 #include "net.h"
 #include "petitions.h"
 #include "quest_parser_collection.h"
@@ -68,7 +69,10 @@ Entity::Entity()
 
 Entity::~Entity()
 {
-
+#ifdef LUA_EQEMU
+	// drop the userdata quests were handed for this entity
+	lua_forget_entity(this);
+#endif
 }
 
 Client *Entity::CastToClient()
@@ -283,6 +287,8 @@ EntityList::EntityList()
 	// enough entities to exhaust this list
 	for (uint16 i = 1; i <= 1500; i++)
 		free_ids.push(i);
+
+	max_aggro_range = 0.0f;
 }
 
 EntityList::~EntityList()
@@ -317,6 +323,8 @@ void EntityList::AddClient(Client *client)
 	client->SetID(GetFreeID());
 	client_list.insert(std::pair<uint16, Client *>(client->GetID(), client));
 	mob_list.insert(std::pair<uint16, Mob *>(client->GetID(), client));
+	mob_grid.Insert(client, client->GetX(), client->GetY());
+	client_grid.Insert(client, client->GetX(), client->GetY());
 }
 
 
@@ -463,6 +471,7 @@ void EntityList::MobProcess()
 	if (numclients < 1)
 		return;
 #endif
+	float tick_aggro_range = 0.0f;
 	auto it = mob_list.begin();
 	while (it != mob_list.end()) {
 		uint16 id = it->first;
@@ -472,6 +481,13 @@ void EntityList::MobProcess()
 		bool p_val = mob->Process();
 		size_t a_sz = mob_list.size();
 
+		// catches every position change that didn't go through ProcessMove
+		if (p_val) {
+			UpdateSpatialPosition(mob, mob->GetX(), mob->GetY());
+			if (!mob->IsClient() && mob->GetAggroRange() > tick_aggro_range)
+				tick_aggro_range = mob->GetAggroRange();
+		}
+
 		if(a_sz > sz) {
 			//increased size can potentially screw with iterators so reset it to current value
 			//if buckets are re-orderered we may skip a process here and there but since
@@ -517,6 +533,8 @@ void EntityList::MobProcess()
 			entity_list.RemoveMob(id);
 		}
 	}
+
+	max_aggro_range = tick_aggro_range;
 }
 
 void EntityList::BeaconProcess()
@@ -632,6 +650,9 @@ void EntityList::AddNPC(NPC *npc, bool SendSpawnPacket, bool dontqueue)
 
 	npc_list.insert(std::pair<uint16, NPC *>(npc->GetID(), npc));
 	mob_list.insert(std::pair<uint16, Mob *>(npc->GetID(), npc));
+	mob_grid.Insert(npc, npc->GetX(), npc->GetY());
+	if (npc->GetAggroRange() > max_aggro_range)
+		max_aggro_range = npc->GetAggroRange();
 }
 
 void EntityList::AddMerc(Merc *merc, bool SendSpawnPacket, bool dontqueue)
@@ -661,6 +682,9 @@ void EntityList::AddMerc(Merc *merc, bool SendSpawnPacket, bool dontqueue)
 
 		merc_list.insert(std::pair<uint16, Merc *>(merc->GetID(), merc));
 		mob_list.insert(std::pair<uint16, Mob *>(merc->GetID(), merc));
+		mob_grid.Insert(merc, merc->GetX(), merc->GetY());
+		if (merc->GetAggroRange() > max_aggro_range)
+			max_aggro_range = merc->GetAggroRange();
 	}
 }
 
@@ -688,6 +712,9 @@ void EntityList::AddDoor(Doors *door)
 	door->SetEntityID(GetFreeID());
 	door_list.insert(std::pair<uint16, Doors *>(door->GetEntityID(), door));
 
+	if (zone && zone->pathing)
+		zone->pathing->InvalidateRoutes();
+
 	if (!net.door_timer.Enabled())
 		net.door_timer.Start();
 }
@@ -1329,6 +1356,8 @@ void EntityList::RefreshClientXTargets(Client *c)
 void EntityList::QueueClientsByTarget(Mob *sender, const EQApplicationPacket *app,
 		bool iSendToSender, Mob *SkipThisMob, bool ackreq, bool HoTT, uint32 ClientVersionBits, bool inspect_buffs)
 {
+	client_broadcast.Clear();
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *c = it->second;
@@ -1380,8 +1409,10 @@ void EntityList::QueueClientsByTarget(Mob *sender, const EQApplicationPacket *ap
 		}
 
 		if (Send && (c->GetClientVersionBit() & ClientVersionBits))
-			c->QueuePacket(app, ackreq);
+			c->QueueBroadcastPacket(client_broadcast, app, ackreq);
 	}
+
+	client_broadcast.Send(app, ackreq);
 }
 
 void EntityList::QueueClientsByXTarget(Mob *sender, const EQApplicationPacket *app, bool iSendToSender)
@@ -1413,9 +1444,14 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 		dist = 600;
 	float dist2 = dist * dist; //pow(dist, 2);
 
-	auto it = client_list.begin();
-	while (it != client_list.end()) {
-		Client *ent = it->second;
+	client_broadcast.Clear();
+
+	std::vector<Client *> close_clients;
+	GetCloseClients(sender->GetX(), sender->GetY(), dist, close_clients);
+
+	auto it = close_clients.begin();
+	while (it != close_clients.end()) {
+		Client *ent = *it;
 
 		if ((!ignore_sender || ent != sender) && (ent != SkipThisMob)) {
 			eqFilterMode filter2 = ent->GetFilter(filter);
@@ -1426,40 +1462,50 @@ void EntityList::QueueCloseClients(Mob *sender, const EQApplicationPacket *app,
 					(ent->GetGroup() && ent->GetGroup()->IsGroupMember(sender))))
 				|| (filter2 == FilterShowSelfOnly && ent == sender))
 			&& (DistanceSquared(ent->GetPosition(), sender->GetPosition()) <= dist2)) {
-				ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+				ent->QueueBroadcastPacket(client_broadcast, app, ackreq, Client::CLIENT_CONNECTED);
 			}
 		}
 		++it;
 	}
+
+	client_broadcast.Send(app, ackreq);
 }
 
 //sender can be null
 void EntityList::QueueClients(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	client_broadcast.Clear();
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueueBroadcastPacket(client_broadcast, app, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
+
+	client_broadcast.Send(app, ackreq);
 }
 
 void EntityList::QueueManaged(Mob *sender, const EQApplicationPacket *app,
 		bool ignore_sender, bool ackreq)
 {
+	client_broadcast.Clear();
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		Client *ent = it->second;
 
 		if ((!ignore_sender || ent != sender))
-			ent->QueuePacket(app, ackreq, Client::CLIENT_CONNECTED);
+			ent->QueueBroadcastPacket(client_broadcast, app, ackreq, Client::CLIENT_CONNECTED);
 
 		++it;
 	}
+
+	client_broadcast.Send(app, ackreq);
 }
 
 
@@ -1976,6 +2022,7 @@ void EntityList::MessageClose(Mob* sender, bool skipsender, float dist, uint32 t
 
 void EntityList::RemoveAllMobs()
 {
+	mob_grid.Clear();
 	auto it = mob_list.begin();
 	while (it != mob_list.end()) {
 		safe_delete(it->second);
@@ -1988,6 +2035,7 @@ void EntityList::RemoveAllClients()
 {
 	// doesn't clear the data
 	client_list.clear();
+	client_grid.Clear();
 }
 
 void EntityList::RemoveAllNPCs()
@@ -2033,6 +2081,9 @@ void EntityList::RemoveAllDoors()
 		it = door_list.erase(it);
 	}
 	DespawnAllDoors();
+
+	if (zone && zone->pathing)
+		zone->pathing->InvalidateRoutes();
 }
 
 void EntityList::DespawnAllDoors()
@@ -2044,6 +2095,10 @@ void EntityList::DespawnAllDoors()
 
 void EntityList::RespawnAllDoors()
 {
+	// doors are respawned after one has been moved, routes through it may be stale
+	if (zone && zone->pathing)
+		zone->pathing->InvalidateRoutes();
+
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		if (it->second) {
@@ -2154,6 +2209,7 @@ bool EntityList::RemoveClient(uint16 delete_id)
 {
 	auto it = client_list.find(delete_id);
 	if (it != client_list.end()) {
+		client_grid.Remove(it->second);
 		client_list.erase(it); // Already deleted
 		return true;
 	}
@@ -2166,6 +2222,7 @@ bool EntityList::RemoveClient(Client *delete_client)
 	auto it = client_list.begin();
 	while (it != client_list.end()) {
 		if (it->second == delete_client) {
+			client_grid.Remove(delete_client);
 			client_list.erase(it);
 			return true;
 		}
@@ -2205,6 +2262,9 @@ bool EntityList::RemoveDoor(uint16 delete_id)
 		safe_delete(it->second);
 		free_ids.push(it->first);
 		door_list.erase(it);
+
+		if (zone && zone->pathing)
+			zone->pathing->InvalidateRoutes();
 		return true;
 	}
 	return false;
@@ -2284,12 +2344,8 @@ void EntityList::UpdateWho(bool iSendFullUpdate)
 			} else {
 				if (sclka->numupdates >= tmpNumUpdates) {
 					tmpNumUpdates += 10;
-					uint8* tmp = pack->pBuffer;
-					pack->pBuffer = new uint8[sizeof(ServerClientListKeepAlive_Struct) + (tmpNumUpdates * 4)];
-					memset(pack->pBuffer, 0, sizeof(ServerClientListKeepAlive_Struct) + (tmpNumUpdates * 4));
-					memcpy(pack->pBuffer, tmp, pack->size);
-					pack->size = sizeof(ServerClientListKeepAlive_Struct) + (tmpNumUpdates * 4);
-					safe_delete_array(tmp);
+					pack->Resize(sizeof(ServerClientListKeepAlive_Struct) + (tmpNumUpdates * 4));
+					sclka = (ServerClientListKeepAlive_Struct*) pack->pBuffer;
 				}
 				sclka->wid[sclka->numupdates] = it->second->GetWID();
 				sclka->numupdates++;
@@ -2394,17 +2450,26 @@ void EntityList::SendTraders(Client *client)
 	}
 }
 
+// the NPCs in npc_list that have mob on their hate list
+std::vector<NPC *> EntityList::GetNPCsHating(Mob *mob)
+{
+	std::vector<NPC *> haters;
+	for (auto hater : mob->GetHatedBy()) {
+		NPC *npc = GetNPCByID(hater->GetID());
+		if (npc && npc == hater)
+			haters.push_back(npc);
+	}
+	return haters;
+}
+
 void EntityList::RemoveFromHateLists(Mob *mob, bool settoone)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(mob)) {
-			if (!settoone)
-				it->second->RemoveFromHateList(mob);
-			else
-				it->second->SetHateAmountOnEnt(mob, 1);
-		}
-		++it;
+	auto haters = GetNPCsHating(mob);
+	for (auto npc : haters) {
+		if (!settoone)
+			npc->RemoveFromHateList(mob);
+		else
+			npc->SetHateAmountOnEnt(mob, 1);
 	}
 }
 
@@ -2420,38 +2485,22 @@ void EntityList::RemoveDebuffs(Mob *caster)
 // Currently, a new packet is sent per entity.
 // @todo: Come back and use FLAG_COMBINED to pack
 // all updates into one packet.
-void EntityList::SendPositionUpdates(Client *client, uint32 cLastUpdate,
-		float range, Entity *alwayssend, bool iSendEvenIfNotChanged)
+void EntityList::SendPositionUpdates(Client *client)
 {
-	range = range * range;
-
-	EQApplicationPacket *outapp = 0;
-	PlayerPositionUpdateServer_Struct *ppu = 0;
-	Mob *mob = 0;
+	// Only other clients' updates were ever sent from here, and clients always skipped the range
+	// and last change checks, so walk client_list instead of every mob in the zone. One packet is
+	// reused since QueuePacket copies it.
+	EQApplicationPacket *outapp = new EQApplicationPacket(OP_ClientUpdate, sizeof(PlayerPositionUpdateServer_Struct));
+	PlayerPositionUpdateServer_Struct *ppu = (PlayerPositionUpdateServer_Struct*)outapp->pBuffer;
 
-	auto it = mob_list.begin();
-	while (it != mob_list.end()) {
-		if (outapp == 0) {
-			outapp = new EQApplicationPacket(OP_ClientUpdate, sizeof(PlayerPositionUpdateServer_Struct));
-			ppu = (PlayerPositionUpdateServer_Struct*)outapp->pBuffer;
-		}
-		mob = it->second;
-		if (mob && !mob->IsCorpse() && (it->second != client)
-			&& (mob->IsClient() || iSendEvenIfNotChanged || (mob->LastChange() >= cLastUpdate))
-			&& (!it->second->IsClient() || !it->second->CastToClient()->GMHideMe(client))) {
-
-			//bool Grouped = client->HasGroup() && mob->IsClient() && (client->GetGroup() == mob->CastToClient()->GetGroup());
-
-			//if (range == 0 || (iterator.GetData() == alwayssend) || Grouped || (mob->DistNoRootNoZ(*client) <= range)) {
-			if (range == 0 || (it->second == alwayssend) || mob->IsClient() || (DistanceSquared(mob->GetPosition(), client->GetPosition()) <= range)) {
-				mob->MakeSpawnUpdate(ppu);
-			}
-			if(mob && mob->IsClient() && mob->GetID()>0) {
-				client->QueuePacket(outapp, false, Client::CLIENT_CONNECTED);
-			}
+	auto it = client_list.begin();
+	while (it != client_list.end()) {
+		Client *c = it->second;
+		if (c && c != client && c->GetID() > 0 && !c->GMHideMe(client)) {
+			memset(ppu, 0, sizeof(PlayerPositionUpdateServer_Struct));
+			c->MakeSpawnUpdate(ppu);
+			client->QueuePacket(outapp, false, Client::CLIENT_CONNECTED);
 		}
-		safe_delete(outapp);
-		outapp = 0;
 		++it;
 	}
 
@@ -2784,40 +2833,30 @@ void BulkZoneSpawnPacket::SendBuffer()
 
 void EntityList::DoubleAggro(Mob *who)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(who))
-			it->second->SetHateAmountOnEnt(who, it->second->CastToNPC()->GetHateAmount(who),
-					it->second->CastToNPC()->GetHateAmount(who) * 2);
-		++it;
-	}
+	auto haters = GetNPCsHating(who);
+	for (auto npc : haters)
+		npc->SetHateAmountOnEnt(who, npc->GetHateAmount(who), npc->GetHateAmount(who) * 2);
 }
 
 void EntityList::HalveAggro(Mob *who)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CastToNPC()->CheckAggro(who))
-			it->second->CastToNPC()->SetHateAmountOnEnt(who, it->second->CastToNPC()->GetHateAmount(who) / 2);
-		++it;
-	}
+	auto haters = GetNPCsHating(who);
+	for (auto npc : haters)
+		npc->SetHateAmountOnEnt(who, npc->GetHateAmount(who) / 2);
 }
 
 void EntityList::Evade(Mob *who)
 {
 	uint32 flatval = who->GetLevel() * 13;
 	int amt = 0;
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CastToNPC()->CheckAggro(who)) {
-			amt = it->second->CastToNPC()->GetHateAmount(who);
-			amt -= flatval;
-			if (amt > 0)
-				it->second->CastToNPC()->SetHateAmountOnEnt(who, amt);
-			else
-				it->second->CastToNPC()->SetHateAmountOnEnt(who, 0);
-		}
-		++it;
+	auto haters = GetNPCsHating(who);
+	for (auto npc : haters) {
+		amt = npc->GetHateAmount(who);
+		amt -= flatval;
+		if (amt > 0)
+			npc->SetHateAmountOnEnt(who, amt);
+		else
+			npc->SetHateAmountOnEnt(who, 0);
 	}
 }
 
@@ -2985,13 +3024,7 @@ void EntityList::MessageGroup(Mob *sender, bool skipclose, uint32 type, const ch
 
 bool EntityList::Fighting(Mob *targ)
 {
-	auto it = npc_list.begin();
-	while (it != npc_list.end()) {
-		if (it->second->CheckAggro(targ))
-			return true;
-		++it;
-	}
-	return false;
+	return !GetNPCsHating(targ).empty();
 }
 
 void EntityList::AddHealAggro(Mob *target, Mob *caster, uint16 thedam)
@@ -3121,8 +3154,25 @@ struct quest_proximity_event {
 	int area_type;
 };
 
+void EntityList::UpdateSpatialPosition(Mob *mob, float x, float y)
+{
+	// only moves mobs that are already tracked, anything not in mob_list stays out of the grids
+	if (!mob_grid.Relocate(mob, x, y))
+		return;
+
+	if (mob->IsClient())
+		client_grid.Relocate(mob->CastToClient(), x, y);
+}
+
+void EntityList::RemoveFromSpatialGrid(Mob *mob)
+{
+	mob_grid.Remove(mob);
+}
+
 void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 {
+	UpdateSpatialPosition(c, location.x, location.y);
+
 	float last_x = c->ProximityX();
 	float last_y = c->ProximityY();
 	float last_z = c->ProximityZ();
@@ -3221,6 +3271,8 @@ void EntityList::ProcessMove(Client *c, const glm::vec3& location)
 
 void EntityList::ProcessMove(NPC *n, float x, float y, float z)
 {
+	UpdateSpatialPosition(n, x, y);
+
 	float last_x = n->GetX();
 	float last_y = n->GetY();
 	float last_z = n->GetZ();
@@ -4525,9 +4577,12 @@ Mob *EntityList::GetClosestMobByBodyType(Mob *sender, bodyType BodyType)
 
 void EntityList::GetTargetsForConeArea(Mob *start, float min_radius, float radius, float height, std::list<Mob*> &m_list)
 {
-	auto it = mob_list.begin();
-	while (it !=  mob_list.end()) {
-		Mob *ptr = it->second;
+	std::vector<Mob *> close_mobs;
+	GetCloseMobs(start->GetX(), start->GetY(), radius, close_mobs);
+
+	auto it = close_mobs.begin();
+	while (it != close_mobs.end()) {
+		Mob *ptr = *it;
 		if (ptr == start) {
 			++it;
 			continue;
@@ -26,6 +26,8 @@
 #include "../common/servertalk.h"
 #include "../common/bodytypes.h"
 #include "../common/eq_constants.h"
+#include "../common/eq_stream_broadcast.h"
+#include "../common/spatial_grid.h"
 
 #include "position.h"
 #include "zonedump.h"
@@ -205,6 +207,11 @@ public:
 	void	BeaconProcess();
 	void	ProcessMove(Client *c, const glm::vec3& location);
 	void	ProcessMove(NPC *n, float x, float y, float z);
+	void	UpdateSpatialPosition(Mob *mob, float x, float y);
+	void	RemoveFromSpatialGrid(Mob *mob);
+	// candidates in the grid cells around a point, callers still need their own exact range checks
+	void	GetCloseMobs(float x, float y, float range, std::vector<Mob *> &out) const { mob_grid.QueryRadius(x, y, range, out); }
+	void	GetCloseClients(float x, float y, float range, std::vector<Client *> &out) const { client_grid.QueryRadius(x, y, range, out); }
 	void	AddArea(int id, int type, float min_x, float max_x, float min_y, float max_y, float min_z, float max_z);
 	void	RemoveArea(int id);
 	void	ClearAreas();
@@ -330,7 +337,7 @@ public:
 	Mob*	FindDefenseNPC(uint32 npcid);
 	void	OpenDoorsNear(NPC* opener);
 	void	UpdateWho(bool iSendFullUpdate = false);
-	void	SendPositionUpdates(Client* client, uint32 cLastUpdate = 0, float range = 0, Entity* alwayssend = 0, bool iSendEvenIfNotChanged = false);
+	void	SendPositionUpdates(Client* client);
 	char*	MakeNameUnique(char* name);
 	static char* RemoveNumbers(char* name);
 	void	SignalMobsByNPCID(uint32 npc_type, int signal_id);
@@ -360,6 +367,7 @@ public:
 
 	bool	Fighting(Mob* targ);
 	void	RemoveFromHateLists(Mob* mob, bool settoone = false);
+	std::vector<NPC *>	GetNPCsHating(Mob* mob);
 	void	RemoveDebuffs(Mob* caster);
 
 
@@ -453,6 +461,10 @@ private:
 	std::list<Raid *> raid_list;
 	std::list<Area> area_list;
 	std::queue<uint16> free_ids;
+	EQStreamBroadcast client_broadcast; // reused by the Queue* broadcasts so we encode once per client version
+	EQEmu::SpatialGrid<Mob *> mob_grid; // every entry of mob_list bucketed by x/y
+	EQEmu::SpatialGrid<Client *> client_grid; // every entry of client_list bucketed by x/y
+	float max_aggro_range; // largest aggro range of any non client mob as of the last MobProcess
 
 	// Please Do Not Declare Any EntityList Class Members After This Comment
 #ifdef BOTS
@@ -22,8 +22,10 @@
 
 #include "guild_mgr.h"
 #include "worldserver.h"
+#include "zone.h"
 
 extern WorldServer worldserver;
+extern Zone* zone;
 
 void Client::SendGuildMOTD(bool GetGuildMOTDReply) {
 	EQApplicationPacket *outapp = new EQApplicationPacket(OP_GuildMOTD, sizeof(GuildMOTD_Struct));
@@ -431,6 +433,9 @@ bool ZoneDatabase::SetGuildDoor(uint8 doorid,uint16 guild_id, const char* zone)
 		return false;
 	}
 
+	if (::zone)
+		::zone->DropContentPack();
+
 	return (results.RowsAffected() > 0);
 }
 
@@ -37,74 +37,185 @@ extern Zone *zone;
 HateList::HateList()
 {
 	hate_owner = nullptr;
+	top_slot = -1;
+	top_hate = 0;
+	frenzy_count = 0;
 }
 
 HateList::~HateList()
 {
+	for (auto &e : list)
+		e.entity_on_hatelist->RemoveHatedBy(hate_owner);
 }
 
 // added for frenzy support
 // checks if target still is in frenzy mode
 void HateList::IsEntityInFrenzyMode()
 {
+	if (frenzy_count == 0)
+		return;
+
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		if ((*iterator)->entity_on_hatelist->GetHPRatio() >= 20)
-			(*iterator)->is_entity_frenzy = false;
+		if (iterator->is_entity_frenzy && iterator->entity_on_hatelist->GetHPRatio() >= 20)
+			SetFrenzy(&(*iterator), false);
 		++iterator;
 	}
 }
 
 void HateList::WipeHateList()
 {
-	auto iterator = list.begin();
-
-	while (iterator != list.end())
+	// the events below can end up back in here, so empty the list before sending them
+	std::vector<struct_HateList> wiped;
+	wiped.swap(list);
+	index.clear();
+	top_slot = -1;
+	frenzy_count = 0;
+
+	auto iterator = wiped.begin();
+	while (iterator != wiped.end())
 	{
-		Mob* m = (*iterator)->entity_on_hatelist;
-		if (m)
-		{
-			parse->EventNPC(EVENT_HATE_LIST, hate_owner->CastToNPC(), m, "0", 0);
-
-			if (m->IsClient())
-				m->CastToClient()->DecrementAggroCount();
-		}
-		delete (*iterator);
-		iterator = list.erase(iterator);
+		Mob* m = iterator->entity_on_hatelist;
+		m->RemoveHatedBy(hate_owner);
+		parse->EventNPC(EVENT_HATE_LIST, hate_owner->CastToNPC(), m, "0", 0);
 
+		if (m->IsClient())
+			m->CastToClient()->DecrementAggroCount();
+		++iterator;
 	}
 }
 
 bool HateList::IsEntOnHateList(Mob *mob)
 {
-	if (Find(mob))
-		return true;
-	return false;
+	return FindSlot(mob) >= 0;
+}
+
+int HateList::FindSlot(Mob *in_entity)
+{
+	if (!index.empty()) {
+		auto iter = index.find(in_entity);
+		return iter != index.end() ? iter->second : -1;
+	}
+
+	for (size_t i = 0; i < list.size(); ++i) {
+		if (list[i].entity_on_hatelist == in_entity)
+			return i;
+	}
+	return -1;
 }
 
 struct_HateList *HateList::Find(Mob *in_entity)
 {
-	auto iterator = list.begin();
-	while (iterator != list.end())
-	{
-		if ((*iterator)->entity_on_hatelist == in_entity)
-			return (*iterator);
-		++iterator;
+	int slot = FindSlot(in_entity);
+	return slot >= 0 ? &list[slot] : nullptr;
+}
+
+void HateList::RemoveSlot(int slot)
+{
+	list[slot].entity_on_hatelist->RemoveHatedBy(hate_owner);
+	if (list[slot].is_entity_frenzy)
+		--frenzy_count;
+
+	if (!index.empty()) {
+		index.erase(list[slot].entity_on_hatelist);
+		if (list.size() - 1 <= HATE_LIST_INDEX_SIZE / 2) {
+			index.clear();
+		}
+		else {
+			for (size_t i = slot + 1; i < list.size(); ++i)
+				index[list[i].entity_on_hatelist] = i - 1;
+		}
+	}
+
+	list.erase(list.begin() + slot);
+
+	if (slot == top_slot)
+		top_slot = -1;
+	else if (slot < top_slot)
+		--top_slot;
+}
+
+// keeps the cached top hate entry right after the hate on a slot changed
+void HateList::HateChanged(int slot)
+{
+	if (top_slot < 0)
+		return;
+
+	uint32 hate = list[slot].stored_hate_amount;
+	if (slot == top_slot) {
+		if (hate < top_hate)
+			top_slot = -1;
+		else
+			top_hate = hate;
+	}
+	else if (hate > top_hate || (hate == top_hate && slot < top_slot)) {
+		top_slot = slot;
+		top_hate = hate;
 	}
-	return nullptr;
+}
+
+// first entry with the most hate, the same one a walk of the list would pick
+int HateList::GetTopSlot()
+{
+	if (top_slot < 0 && !list.empty()) {
+		top_slot = 0;
+		for (size_t i = 1; i < list.size(); ++i) {
+			if (list[i].stored_hate_amount > list[top_slot].stored_hate_amount)
+				top_slot = i;
+		}
+		top_hate = list[top_slot].stored_hate_amount;
+	}
+	return top_slot;
+}
+
+void HateList::SetFrenzy(struct_HateList *entry, bool in_is_frenzied)
+{
+	if (entry->is_entity_frenzy != in_is_frenzied)
+		frenzy_count += in_is_frenzied ? 1 : -1;
+	entry->is_entity_frenzy = in_is_frenzied;
 }
 
 void HateList::SetHateAmountOnEnt(Mob* other, uint32 in_hate, uint32 in_damage)
 {
-	struct_HateList *entity = Find(other);
-	if (entity)
+	int slot = FindSlot(other);
+	if (slot >= 0)
 	{
 		if (in_damage > 0)
-			entity->hatelist_damage = in_damage;
-		if (in_hate > 0)
-			entity->stored_hate_amount = in_hate;
+			list[slot].hatelist_damage = in_damage;
+		if (in_hate > 0) {
+			list[slot].stored_hate_amount = in_hate;
+			HateChanged(slot);
+		}
+	}
+}
+
+void HateList::SetEntHateEntry(Mob *ent, uint32 in_hate, int32 in_damage, bool in_is_frenzied)
+{
+	int slot = FindSlot(ent);
+	if (slot < 0)
+		return;
+
+	list[slot].stored_hate_amount = in_hate;
+	list[slot].hatelist_damage = in_damage;
+	SetFrenzy(&list[slot], in_is_frenzied);
+	HateChanged(slot);
+}
+
+bool HateList::ReplaceEntOnHateList(Mob *ent, Mob *new_ent)
+{
+	int slot = FindSlot(ent);
+	if (slot < 0 || !new_ent || FindSlot(new_ent) >= 0)
+		return false;
+
+	ent->RemoveHatedBy(hate_owner);
+	new_ent->AddHatedBy(hate_owner);
+	list[slot].entity_on_hatelist = new_ent;
+	if (!index.empty()) {
+		index.erase(ent);
+		index[new_ent] = slot;
 	}
+	return true;
 }
 
 Mob* HateList::GetDamageTopOnHateList(Mob* hater)
@@ -120,31 +231,31 @@ Mob* HateList::GetDamageTopOnHateList(Mob* hater)
 		grp = nullptr;
 		r = nullptr;
 
-		if ((*iterator)->entity_on_hatelist && (*iterator)->entity_on_hatelist->IsClient()){
-			r = entity_list.GetRaidByClient((*iterator)->entity_on_hatelist->CastToClient());
+		if (iterator->entity_on_hatelist && iterator->entity_on_hatelist->IsClient()){
+			r = entity_list.GetRaidByClient(iterator->entity_on_hatelist->CastToClient());
 		}
 
-		grp = entity_list.GetGroupByMob((*iterator)->entity_on_hatelist);
+		grp = entity_list.GetGroupByMob(iterator->entity_on_hatelist);
 
-		if ((*iterator)->entity_on_hatelist && r){
+		if (iterator->entity_on_hatelist && r){
 			if (r->GetTotalRaidDamage(hater) >= dmg_amt)
 			{
-				current = (*iterator)->entity_on_hatelist;
+				current = iterator->entity_on_hatelist;
 				dmg_amt = r->GetTotalRaidDamage(hater);
 			}
 		}
-		else if ((*iterator)->entity_on_hatelist != nullptr && grp != nullptr)
+		else if (iterator->entity_on_hatelist != nullptr && grp != nullptr)
 		{
 			if (grp->GetTotalGroupDamage(hater) >= dmg_amt)
 			{
-				current = (*iterator)->entity_on_hatelist;
+				current = iterator->entity_on_hatelist;
 				dmg_amt = grp->GetTotalGroupDamage(hater);
 			}
 		}
-		else if ((*iterator)->entity_on_hatelist != nullptr && (uint32)(*iterator)->hatelist_damage >= dmg_amt)
+		else if (iterator->entity_on_hatelist != nullptr && (uint32)iterator->hatelist_damage >= dmg_amt)
 		{
-			current = (*iterator)->entity_on_hatelist;
-			dmg_amt = (*iterator)->hatelist_damage;
+			current = iterator->entity_on_hatelist;
+			dmg_amt = iterator->hatelist_damage;
 		}
 		++iterator;
 	}
@@ -158,10 +269,10 @@ Mob* HateList::GetClosestEntOnHateList(Mob *hater) {
 
 	auto iterator = list.begin();
 	while (iterator != list.end()) {
-		this_distance = DistanceSquaredNoZ((*iterator)->entity_on_hatelist->GetPosition(), hater->GetPosition());
-		if ((*iterator)->entity_on_hatelist != nullptr && this_distance <= close_distance) {
+		this_distance = DistanceSquaredNoZ(iterator->entity_on_hatelist->GetPosition(), hater->GetPosition());
+		if (iterator->entity_on_hatelist != nullptr && this_distance <= close_distance) {
 			close_distance = this_distance;
-			close_entity = (*iterator)->entity_on_hatelist;
+			close_entity = iterator->entity_on_hatelist;
 		}
 		++iterator;
 	}
@@ -183,20 +294,42 @@ void HateList::AddEntToHateList(Mob *in_entity, int32 in_hate, int32 in_damage,
 	if (in_entity->IsClient() && in_entity->CastToClient()->IsDead())
 		return;
 
-	struct_HateList *entity = Find(in_entity);
-	if (entity)
+	int slot = FindSlot(in_entity);
+	if (slot >= 0)
 	{
+		struct_HateList *entity = &list[slot];
 		entity->hatelist_damage += (in_damage >= 0) ? in_damage : 0;
 		entity->stored_hate_amount += in_hate;
-		entity->is_entity_frenzy = in_is_entity_frenzied;
+		SetFrenzy(entity, in_is_entity_frenzied);
+		HateChanged(slot);
 	}
 	else if (iAddIfNotExist) {
-		entity = new struct_HateList;
-		entity->entity_on_hatelist = in_entity;
-		entity->hatelist_damage = (in_damage >= 0) ? in_damage : 0;
-		entity->stored_hate_amount = in_hate;
-		entity->is_entity_frenzy = in_is_entity_frenzied;
+		struct_HateList entity;
+		entity.entity_on_hatelist = in_entity;
+		entity.hatelist_damage = (in_damage >= 0) ? in_damage : 0;
+		entity.stored_hate_amount = in_hate;
+		entity.is_entity_frenzy = false;
 		list.push_back(entity);
+
+		slot = list.size() - 1;
+		SetFrenzy(&list[slot], in_is_entity_frenzied);
+		if (!index.empty()) {
+			index[in_entity] = slot;
+		}
+		else if (list.size() > HATE_LIST_INDEX_SIZE) {
+			for (size_t i = 0; i < list.size(); ++i)
+				index[list[i].entity_on_hatelist] = i;
+		}
+
+		if (slot == 0) {
+			top_slot = 0;
+			top_hate = entity.stored_hate_amount;
+		}
+		else {
+			HateChanged(slot);
+		}
+
+		in_entity->AddHatedBy(hate_owner);
 		parse->EventNPC(EVENT_HATE_LIST, hate_owner->CastToNPC(), in_entity, "1", 0);
 
 		if (in_entity->IsClient()) {
@@ -212,29 +345,24 @@ bool HateList::RemoveEntFromHateList(Mob *in_entity)
 	if (!in_entity)
 		return false;
 
-	bool is_found = false;
-	auto iterator = list.begin();
-
-	while (iterator != list.end())
-	{
-		if ((*iterator)->entity_on_hatelist == in_entity)
-		{
-			is_found = true;
+	int slot = FindSlot(in_entity);
+	if (slot < 0)
+		return false;
 
-			if (in_entity && in_entity->IsClient())
-				in_entity->CastToClient()->DecrementAggroCount();
+	if (in_entity->IsClient())
+		in_entity->CastToClient()->DecrementAggroCount();
 
-			delete (*iterator);
-			iterator = list.erase(iterator);
+	RemoveSlot(slot);
 
-			if (in_entity)
-				parse->EventNPC(EVENT_HATE_LIST, hate_owner->CastToNPC(), in_entity, "0", 0);
+	parse->EventNPC(EVENT_HATE_LIST, hate_owner->CastToNPC(), in_entity, "0", 0);
+	return true;
+}
 
-		}
-		else
-			++iterator;
-	}
-	return is_found;
+void HateList::ForgetEnt(Mob *in_entity)
+{
+	int slot = FindSlot(in_entity);
+	if (slot >= 0)
+		RemoveSlot(slot);
 }
 
 void HateList::DoFactionHits(int32 npc_faction_level_id) {
@@ -245,8 +373,8 @@ void HateList::DoFactionHits(int32 npc_faction_level_id) {
 	{
 		Client *client;
 
-		if ((*iterator)->entity_on_hatelist && (*iterator)->entity_on_hatelist->IsClient())
-			client = (*iterator)->entity_on_hatelist->CastToClient();
+		if (iterator->entity_on_hatelist && iterator->entity_on_hatelist->IsClient())
+			client = iterator->entity_on_hatelist->CastToClient();
 		else
 			client = nullptr;
 
@@ -264,7 +392,7 @@ int HateList::GetSummonedPetCountOnHateList(Mob *hater) {
 	auto iterator = list.begin();
 	while (iterator != list.end()) {
 
-		if ((*iterator)->entity_on_hatelist != nullptr && (*iterator)->entity_on_hatelist->IsNPC() && ((*iterator)->entity_on_hatelist->CastToNPC()->IsPet() || ((*iterator)->entity_on_hatelist->CastToNPC()->GetSwarmOwner() > 0)))
+		if (iterator->entity_on_hatelist != nullptr && iterator->entity_on_hatelist->IsNPC() && (iterator->entity_on_hatelist->CastToNPC()->IsPet() || (iterator->entity_on_hatelist->CastToNPC()->GetSwarmOwner() > 0)))
 		{
 			++pet_count;
 		}
@@ -287,15 +415,21 @@ Mob *HateList::GetEntWithMostHateOnList(Mob *center)
 	if (center == nullptr)
 		return nullptr;
 
+	bool underwater_only = center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap();
+
 	if (RuleB(Aggro, SmartAggroList)){
 		Mob* top_client_type_in_range = nullptr;
 		int64 hate_client_type_in_range = -1;
 		int skipped_count = 0;
+		int sitting_aggro_mod = RuleI(Aggro, SittingAggroMod);
+		int current_target_aggro_mod = RuleI(Aggro, CurrentTargetAggroMod);
+		int melee_range_aggro_mod = RuleI(Aggro, MeleeRangeAggroMod);
+		int critically_wounded_aggro_mod = RuleI(Aggro, CriticallyWoundedAggroMod);
 
 		auto iterator = list.begin();
 		while (iterator != list.end())
 		{
-			struct_HateList *cur = (*iterator);
+			struct_HateList *cur = &(*iterator);
 			int16 aggro_mod = 0;
 
 			if (!cur){
@@ -308,8 +442,8 @@ Mob *HateList::GetEntWithMostHateOnList(Mob *center)
 				continue;
 			}
 
-            auto hateEntryPosition = glm::vec3(cur->entity_on_hatelist->GetX(), cur->entity_on_hatelist->GetY(), cur->entity_on_hatelist->GetZ());
-			if (center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
+			if (underwater_only) {
+				auto hateEntryPosition = glm::vec3(cur->entity_on_hatelist->GetX(), cur->entity_on_hatelist->GetY(), cur->entity_on_hatelist->GetZ());
 				if (!zone->watermap->InLiquid(hateEntryPosition)) {
 					skipped_count++;
 					++iterator;
@@ -342,16 +476,16 @@ Mob *HateList::GetEntWithMostHateOnList(Mob *center)
 			if (cur->entity_on_hatelist->IsClient()){
 
 				if (cur->entity_on_hatelist->CastToClient()->IsSitting()){
-					aggro_mod += RuleI(Aggro, SittingAggroMod);
+					aggro_mod += sitting_aggro_mod;
 				}
 
 				if (center){
 					if (center->GetTarget() == cur->entity_on_hatelist)
-						aggro_mod += RuleI(Aggro, CurrentTargetAggroMod);
-					if (RuleI(Aggro, MeleeRangeAggroMod) != 0)
+						aggro_mod += current_target_aggro_mod;
+					if (melee_range_aggro_mod != 0)
 					{
 						if (center->CombatRange(cur->entity_on_hatelist)){
-							aggro_mod += RuleI(Aggro, MeleeRangeAggroMod);
+							aggro_mod += melee_range_aggro_mod;
 
 							if (current_hate > hate_client_type_in_range || cur->is_entity_frenzy){
 								hate_client_type_in_range = current_hate;
@@ -365,18 +499,18 @@ Mob *HateList::GetEntWithMostHateOnList(Mob *center)
 			else{
 				if (center){
 					if (center->GetTarget() == cur->entity_on_hatelist)
-						aggro_mod += RuleI(Aggro, CurrentTargetAggroMod);
-					if (RuleI(Aggro, MeleeRangeAggroMod) != 0)
+						aggro_mod += current_target_aggro_mod;
+					if (melee_range_aggro_mod != 0)
 					{
 						if (center->CombatRange(cur->entity_on_hatelist)){
-							aggro_mod += RuleI(Aggro, MeleeRangeAggroMod);
+							aggro_mod += melee_range_aggro_mod;
 						}
 					}
 				}
 			}
 
 			if (cur->entity_on_hatelist->GetMaxHP() != 0 && ((cur->entity_on_hatelist->GetHP() * 100 / cur->entity_on_hatelist->GetMaxHP()) < 20)){
-				aggro_mod += RuleI(Aggro, CriticallyWoundedAggroMod);
+				aggro_mod += critically_wounded_aggro_mod;
 			}
 
 			if (aggro_mod){
@@ -429,12 +563,16 @@ Mob *HateList::GetEntWithMostHateOnList(Mob *center)
 		}
 	}
 	else{
+		// without frenzied entries or a water check this is just the cached top
+		if (!underwater_only && frenzy_count == 0)
+			return GetEntWithMostHateOnList();
+
 		auto iterator = list.begin();
 		int skipped_count = 0;
 		while (iterator != list.end())
 		{
-			struct_HateList *cur = (*iterator);
-			if (center->IsNPC() && center->CastToNPC()->IsUnderwaterOnly() && zone->HasWaterMap()) {
+			struct_HateList *cur = &(*iterator);
+			if (underwater_only) {
 				if(!zone->watermap->InLiquid(glm::vec3(cur->entity_on_hatelist->GetPosition()))) {
 					skipped_count++;
 					++iterator;
@@ -458,21 +596,8 @@ Mob *HateList::GetEntWithMostHateOnList(Mob *center)
 }
 
 Mob *HateList::GetEntWithMostHateOnList(){
-	Mob* top = nullptr;
-	int64 hate = -1;
-
-	auto iterator = list.begin();
-	while (iterator != list.end())
-	{
-		struct_HateList *cur = (*iterator);
-		if (cur && cur->entity_on_hatelist != nullptr && (cur->stored_hate_amount > hate))
-		{
-			top = cur->entity_on_hatelist;
-			hate = cur->stored_hate_amount;
-		}
-		++iterator;
-	}
-	return top;
+	int slot = GetTopSlot();
+	return slot >= 0 ? list[slot].entity_on_hatelist : nullptr;
 }
 
 
@@ -483,19 +608,9 @@ Mob *HateList::GetRandomEntOnHateList()
 		return NULL;
 
 	if (count == 1) //No need to do all that extra work if we only have one hate entry
-	{
-		if (*list.begin()) // Just in case tHateEntry is invalidated somehow...
-			return (*list.begin())->entity_on_hatelist;
-
-		return NULL;
-	}
-
-	auto iterator = list.begin();
-	int random = zone->random.Int(0, count - 1);
-	for (int i = 0; i < random; i++)
-		++iterator;
+		return list[0].entity_on_hatelist;
 
-	return (*iterator)->entity_on_hatelist;
+	return list[zone->random.Int(0, count - 1)].entity_on_hatelist;
 }
 
 int32 HateList::GetEntHateAmount(Mob *in_entity, bool damage)
@@ -521,7 +636,7 @@ void HateList::PrintHateListToClient(Client *c)
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		struct_HateList *e = (*iterator);
+		struct_HateList *e = &(*iterator);
 		c->Message(0, "- name: %s, damage: %d, hate: %d",
 			(e->entity_on_hatelist && e->entity_on_hatelist->GetName()) ? e->entity_on_hatelist->GetName() : "(null)",
 			e->hatelist_damage, e->stored_hate_amount);
@@ -540,7 +655,7 @@ int HateList::AreaRampage(Mob *caster, Mob *target, int count, ExtraAttackOption
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		struct_HateList *h = (*iterator);
+		struct_HateList *h = &(*iterator);
 		++iterator;
 		if (h && h->entity_on_hatelist && h->entity_on_hatelist != caster)
 		{
@@ -589,7 +704,7 @@ void HateList::SpellCast(Mob *caster, uint32 spell_id, float range, Mob* ae_cent
 	auto iterator = list.begin();
 	while (iterator != list.end())
 	{
-		struct_HateList *h = (*iterator);
+		struct_HateList *h = &(*iterator);
 		if (range > 0)
 		{
 			dist_targ = DistanceSquared(center->GetPosition(), h->entity_on_hatelist->GetPosition());
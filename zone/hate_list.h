@@ -19,6 +19,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 #ifndef HATELIST_H
 #define HATELIST_H
 
+#include <unordered_map>
+#include <vector>
+
 class Client;
 class Group;
 class Mob;
@@ -33,6 +36,17 @@ struct struct_HateList
 	bool is_entity_frenzy;
 };
 
+/*
+	Entries live by value in one vector, in the order they were added, so walking the list
+	doesn't chase a heap node per entry. Lists that grow past HATE_LIST_INDEX_SIZE also keep an
+	index from mob to slot so Find() doesn't have to walk them. The entry with the most hate is
+	cached and only recalculated after it lost hate or was removed. Every mob on a list knows
+	whose lists it is on (Mob::GetHatedBy), which this class keeps up to date.
+
+	Entries move when the list changes, don't keep pointers to them.
+*/
+#define HATE_LIST_INDEX_SIZE 16
+
 class HateList
 {
 public:
@@ -54,13 +68,17 @@ public:
 
 	int32 GetEntHateAmount(Mob *ent, bool in_damage = false);
 
-	std::list<struct_HateList*>& GetHateList() { return list; }
+	const std::vector<struct_HateList>& GetEntries() { return list; }
+	const struct_HateList *GetEntHateEntry(Mob *ent) { return Find(ent); }
 
 	void AddEntToHateList(Mob *ent, int32 in_hate = 0, int32 in_damage = 0, bool in_is_frenzied = false, bool add_to_hate_list_if_not_exist = true);
 	void DoFactionHits(int32 npc_faction_level_id);
 	void IsEntityInFrenzyMode();
 	void PrintHateListToClient(Client *c);
 	void SetHateAmountOnEnt(Mob *other, uint32 in_hate, uint32 in_damage);
+	void SetEntHateEntry(Mob *ent, uint32 in_hate, int32 in_damage, bool in_is_frenzied);
+	bool ReplaceEntOnHateList(Mob *ent, Mob *new_ent);
+	void ForgetEnt(Mob *ent); // removes without events, for mobs being deleted
 	void SetHateOwner(Mob *new_hate_owner) { hate_owner = new_hate_owner; }
 	void SpellCast(Mob *caster, uint32 spell_id, float range, Mob *ae_center = nullptr);
 	void WipeHateList();
@@ -69,7 +87,17 @@ public:
 protected:
 	struct_HateList* Find(Mob *ent);
 private:
-	std::list<struct_HateList*> list;
+	int FindSlot(Mob *ent);
+	void RemoveSlot(int slot);
+	void HateChanged(int slot);
+	int GetTopSlot();
+	void SetFrenzy(struct_HateList *entry, bool in_is_frenzied);
+
+	std::vector<struct_HateList> list;
+	std::unordered_map<Mob *, int> index; // only kept while list is larger than HATE_LIST_INDEX_SIZE
+	int top_slot; // -1 when it needs to be found again
+	uint32 top_hate;
+	int frenzy_count;
 	Mob *hate_owner;
 };
 
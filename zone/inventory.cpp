@@ -2562,7 +2562,7 @@ void Client::CreateBandolier(const EQApplicationPacket *app)
 void Client::RemoveBandolier(const EQApplicationPacket *app)
 {
 	BandolierDelete_Struct *bds = (BandolierDelete_Struct*)app->pBuffer;
-	Log.Out(Logs::Detail, Logs::Inventory, "Char: %s removing set", GetName(), bds->Number);
+	Log.Out(Logs::Detail, Logs::Inventory, "Char: %s removing set %i", GetName(), bds->Number);
 	memset(m_pp.bandoliers[bds->Number].Name, 0, 32);
 	for(int i = bandolierPrimary; i <= bandolierAmmo; i++) {
 		m_pp.bandoliers[bds->Number].Items[i].ID = 0;
@@ -12,42 +12,52 @@
 
 Lua_Mob Lua_HateEntry::GetEnt() {
 	Lua_Safe_Call_Class(Lua_Mob);
-	return Lua_Mob(self->entity_on_hatelist);
+	return Lua_Mob(self->GetEntHateEntry(ent_) ? ent_ : nullptr);
 }
 
 void Lua_HateEntry::SetEnt(Lua_Mob e) {
 	Lua_Safe_Call_Void();
-	self->entity_on_hatelist = e;
+	if(self->ReplaceEntOnHateList(ent_, e))
+		ent_ = e;
 }
 
 int Lua_HateEntry::GetDamage() {
 	Lua_Safe_Call_Int();
-	return self->hatelist_damage;
+	const struct_HateList *entry = self->GetEntHateEntry(ent_);
+	return entry ? entry->hatelist_damage : 0;
 }
 
 void Lua_HateEntry::SetDamage(int value) {
 	Lua_Safe_Call_Void();
-	self->hatelist_damage = value;
+	const struct_HateList *entry = self->GetEntHateEntry(ent_);
+	if(entry)
+		self->SetEntHateEntry(ent_, entry->stored_hate_amount, value, entry->is_entity_frenzy);
 }
 
 int Lua_HateEntry::GetHate() {
 	Lua_Safe_Call_Int();
-	return self->stored_hate_amount;
+	const struct_HateList *entry = self->GetEntHateEntry(ent_);
+	return entry ? entry->stored_hate_amount : 0;
 }
 
 void Lua_HateEntry::SetHate(int value) {
 	Lua_Safe_Call_Void();
-	self->stored_hate_amount = value;
+	const struct_HateList *entry = self->GetEntHateEntry(ent_);
+	if(entry)
+		self->SetEntHateEntry(ent_, value, entry->hatelist_damage, entry->is_entity_frenzy);
 }
 
 int Lua_HateEntry::GetFrenzy() {
 	Lua_Safe_Call_Int();
-	return self->is_entity_frenzy;
+	const struct_HateList *entry = self->GetEntHateEntry(ent_);
+	return entry ? entry->is_entity_frenzy : 0;
 }
 
 void Lua_HateEntry::SetFrenzy(bool value) {
 	Lua_Safe_Call_Void();
-	self->is_entity_frenzy = value;
+	const struct_HateList *entry = self->GetEntHateEntry(ent_);
+	if(entry)
+		self->SetEntHateEntry(ent_, entry->stored_hate_amount, entry->hatelist_damage, value);
 }
 
 luabind::scope lua_register_hate_entry() {
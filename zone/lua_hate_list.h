@@ -5,17 +5,20 @@
 #include "lua_ptr.h"
 
 class Lua_Mob;
+class HateList;
+class Mob;
 struct struct_HateList;
 
 luabind::scope lua_register_hate_entry();
 luabind::scope lua_register_hate_list();
 
-class Lua_HateEntry : public Lua_Ptr<struct_HateList>
+// Looks the entry up on the hate list each time, entries move around as the list changes.
+class Lua_HateEntry : public Lua_Ptr<HateList>
 {
-	typedef struct_HateList NativeType;
+	typedef HateList NativeType;
 public:
-	Lua_HateEntry() : Lua_Ptr(nullptr) { }
-	Lua_HateEntry(struct_HateList *d) : Lua_Ptr(d) { }
+	Lua_HateEntry() : Lua_Ptr(nullptr), ent_(nullptr) { }
+	Lua_HateEntry(HateList *d, Mob *ent) : Lua_Ptr(d), ent_(ent) { }
 	virtual ~Lua_HateEntry() { }
 	
 	Lua_Mob GetEnt();
@@ -26,6 +29,9 @@ public:
 	void SetHate(int value);
 	int GetFrenzy();
 	void SetFrenzy(bool value);
+
+private:
+	Mob *ent_;
 };
 
 struct Lua_HateList
@@ -842,10 +842,11 @@ Lua_HateList Lua_Mob::GetHateList() {
 	Lua_Safe_Call_Class(Lua_HateList);
 	Lua_HateList ret;
 
-	auto h_list = self->GetHateList();
-	auto iter = h_list.begin();
-	while(iter != h_list.end()) {
-		Lua_HateEntry e(*iter);
+	auto &h_list = self->GetHateList();
+	auto &entries = h_list.GetEntries();
+	auto iter = entries.begin();
+	while(iter != entries.end()) {
+		Lua_HateEntry e(&h_list, iter->entity_on_hatelist);
 		ret.entries.push_back(e);
 		++iter;
 	}
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <unordered_map>
 
 #include "masterentity.h"
 #include "../common/spdat.h"
@@ -129,12 +130,39 @@ struct lua_registered_event {
 std::map<std::string, std::list<lua_registered_event>> lua_encounter_events_registered;
 std::map<std::string, bool> lua_encounters_loaded;
 
+//A loaded script's event functions, looked up once when it loads so sending an event doesn't
+//have to build its package name and find the function by name in the registry
+struct lua_quest_package {
+	std::string name;
+	luabind::adl::object events[_LargestEventID];
+};
+
+std::unordered_map<uint64, lua_quest_package> lua_quest_packages;
+
+static inline uint64 lua_package_key(LuaPackageType type, uint32 id) {
+	return (static_cast<uint64>(type) << 32) | id;
+}
+
+static int lua_count_fields(lua_State *L, int index) {
+	int count = 0;
+	lua_pushnil(L);
+	while(lua_next(L, index)) {
+		++count;
+		lua_pop(L, 1);
+	}
+	return count;
+}
+
 LuaParser::LuaParser() {
 	for(int i = 0; i < _LargestEventID; ++i) {
 		NPCArgumentDispatch[i] = handle_npc_null;
 		PlayerArgumentDispatch[i] = handle_player_null;
 		ItemArgumentDispatch[i] = handle_item_null;
 		SpellArgumentDispatch[i] = handle_spell_null;
+		NPCArgumentFields[i] = 0;
+		PlayerArgumentFields[i] = 0;
+		ItemArgumentFields[i] = 0;
+		SpellArgumentFields[i] = 0;
 	}
 
 	NPCArgumentDispatch[EVENT_SAY] = handle_npc_event_say;
@@ -214,12 +242,15 @@ LuaParser::LuaParser() {
 	SpellArgumentDispatch[EVENT_SPELL_EFFECT_TRANSLOCATE_COMPLETE] = handle_translocate_finish;
 
 	L = nullptr;
+	entity_wrappers = lua_create_entity_wrappers();
 }
 
 LuaParser::~LuaParser() {
 	if(L) {
+		ClearPackages();
 		lua_close(L);
 	}
+	lua_destroy_entity_wrappers(entity_wrappers);
 }
 
 int LuaParser::EventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
@@ -233,12 +264,12 @@ int LuaParser::EventNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data,
 		return 0;
 	}
 
-	if(!HasQuestSub(npc->GetNPCTypeID(), evt)) {
+	lua_quest_package *package = GetPackage(LuaPackageNPC, npc->GetNPCTypeID(), evt);
+	if(!package) {
 		return 0;
 	}
 
-	std::string package_name = "npc_" + std::to_string(npc->GetNPCTypeID());
-	return _EventNPC(package_name, evt, npc, init, data, extra_data, extra_pointers);
+	return _EventNPC(package->name, evt, npc, init, data, extra_data, extra_pointers, &package->events[evt]);
 }
 
 int LuaParser::EventGlobalNPC(QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
@@ -252,14 +283,15 @@ int LuaParser::EventGlobalNPC(QuestEventID evt, NPC* npc, Mob *init, std::string
 		return 0;
 	}
 
-	if(!HasGlobalQuestSub(evt)) {
+	lua_quest_package *package = GetPackage(LuaPackageGlobalNPC, 0, evt);
+	if(!package) {
 		return 0;
 	}
 
-	return _EventNPC("global_npc", evt, npc, init, data, extra_data, extra_pointers);
+	return _EventNPC(package->name, evt, npc, init, data, extra_data, extra_pointers, &package->events[evt]);
 }
 
-int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+int LuaParser::_EventNPC(const std::string &package_name, QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						 std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func) {
 	const char *sub_name = LuaEvents[evt];
 
@@ -275,21 +307,24 @@ int LuaParser::_EventNPC(std::string package_name, QuestEventID evt, NPC* npc, M
 			npop = 2;
 		}
 		
-		lua_createtable(L, 0, 0);
+		int &fields = NPCArgumentFields[evt];
+		lua_createtable(L, 0, fields);
 		//always push self
-		Lua_NPC l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		lua_push_npc(L, npc);
 		lua_setfield(L, -2, "self");
 
 		auto arg_function = NPCArgumentDispatch[evt];
 		arg_function(this, L, npc, init, data, extra_data, extra_pointers);
+		if(!fields) {
+			fields = lua_count_fields(L, lua_gettop(L));
+		}
 		Client *c = (init && init->IsClient()) ? init->CastToClient() : nullptr;
 		
 		quest_manager.StartQuest(npc, c, nullptr);
 		if(lua_pcall(L, 1, 1, 0)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
+			lua_pop(L, npop);
 			quest_manager.EndQuest();
 			return 0;
 		}
@@ -329,11 +364,12 @@ int LuaParser::EventPlayer(QuestEventID evt, Client *client, std::string data, u
 		return 0;
 	}
 
-	if(!PlayerHasQuestSub(evt)) {
+	lua_quest_package *package = GetPackage(LuaPackagePlayer, 0, evt);
+	if(!package) {
 		return 0;
 	}
 
-	return _EventPlayer("player", evt, client, data, extra_data, extra_pointers);
+	return _EventPlayer(package->name, evt, client, data, extra_data, extra_pointers, &package->events[evt]);
 }
 
 int LuaParser::EventGlobalPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
@@ -347,14 +383,15 @@ int LuaParser::EventGlobalPlayer(QuestEventID evt, Client *client, std::string d
 		return 0;
 	}
 
-	if(!GlobalPlayerHasQuestSub(evt)) {
+	lua_quest_package *package = GetPackage(LuaPackageGlobalPlayer, 0, evt);
+	if(!package) {
 		return 0;
 	}
 
-	return _EventPlayer("global_player", evt, client, data, extra_data, extra_pointers);
+	return _EventPlayer(package->name, evt, client, data, extra_data, extra_pointers, &package->events[evt]);
 }
 
-int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+int LuaParser::_EventPlayer(const std::string &package_name, QuestEventID evt, Client *client, std::string data, uint32 extra_data,
 							std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func) {
 	const char *sub_name = LuaEvents[evt];
 	int start = lua_gettop(L);
@@ -369,20 +406,23 @@ int LuaParser::_EventPlayer(std::string package_name, QuestEventID evt, Client *
 			npop = 2;
 		}
 	
-		lua_createtable(L, 0, 0);
+		int &fields = PlayerArgumentFields[evt];
+		lua_createtable(L, 0, fields);
 		//push self
-		Lua_Client l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		lua_push_client(L, client);
 		lua_setfield(L, -2, "self");
 		
 		auto arg_function = PlayerArgumentDispatch[evt];
 		arg_function(this, L, client, data, extra_data, extra_pointers);
+		if(!fields) {
+			fields = lua_count_fields(L, lua_gettop(L));
+		}
 	
 		quest_manager.StartQuest(client, client, nullptr);
 		if(lua_pcall(L, 1, 1, 0)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
+			lua_pop(L, npop);
 			quest_manager.EndQuest();
 			return 0;
 		}
@@ -422,16 +462,15 @@ int LuaParser::EventItem(QuestEventID evt, Client *client, ItemInst *item, Mob *
 		return 0;
 	}
 	
-	if(!ItemHasQuestSub(item, evt)) {
+	lua_quest_package *package = GetPackage(LuaPackageItem, item->GetID(), evt);
+	if(!package) {
 		return 0;
 	}
-	
-	std::string package_name = "item_";
-	package_name += std::to_string(item->GetID());
-	return _EventItem(package_name, evt, client, item, mob, data, extra_data, extra_pointers);
+
+	return _EventItem(package->name, evt, client, item, mob, data, extra_data, extra_pointers, &package->events[evt]);
 }
 
-int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *client, ItemInst *item, Mob *mob,
+int LuaParser::_EventItem(const std::string &package_name, QuestEventID evt, Client *client, ItemInst *item, Mob *mob,
 						  std::string data, uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func) {
 	const char *sub_name = LuaEvents[evt];
 
@@ -444,28 +483,32 @@ int LuaParser::_EventItem(std::string package_name, QuestEventID evt, Client *cl
 		} else {
 			lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
 			lua_getfield(L, -1, sub_name);
+			npop = 2;
 		}
 		
-		lua_createtable(L, 0, 0);
+		int &fields = ItemArgumentFields[evt];
+		lua_createtable(L, 0, fields);
 		//always push self
 		Lua_ItemInst l_item(item);
 		luabind::adl::object l_item_o = luabind::adl::object(L, l_item);
 		l_item_o.push(L);
 		lua_setfield(L, -2, "self");
 
-		Lua_Client l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		lua_push_client(L, client);
 		lua_setfield(L, -2, "owner");
 
 		//redo this arg function
 		auto arg_function = ItemArgumentDispatch[evt];
 		arg_function(this, L, client, item, mob, data, extra_data, extra_pointers);
+		if(!fields) {
+			fields = lua_count_fields(L, lua_gettop(L));
+		}
 		
 		quest_manager.StartQuest(client, client, item);
 		if(lua_pcall(L, 1, 1, 0)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
+			lua_pop(L, npop);
 			quest_manager.EndQuest();
 			return 0;
 		}
@@ -501,16 +544,15 @@ int LuaParser::EventSpell(QuestEventID evt, NPC* npc, Client *client, uint32 spe
 		return 0;
 	}
 
-	std::string package_name = "spell_" + std::to_string(spell_id);
-
-	if(!SpellHasQuestSub(spell_id, evt)) {
+	lua_quest_package *package = GetPackage(LuaPackageSpell, spell_id, evt);
+	if(!package) {
 		return 0;
 	}
 
-	return _EventSpell(package_name, evt, npc, client, spell_id, extra_data, extra_pointers);
+	return _EventSpell(package->name, evt, npc, client, spell_id, extra_data, extra_pointers, &package->events[evt]);
 }
 
-int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
+int LuaParser::_EventSpell(const std::string &package_name, QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
 						   std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func) {
 	const char *sub_name = LuaEvents[evt];
 	
@@ -526,7 +568,8 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 			npop = 2;
 		}
 		
-		lua_createtable(L, 0, 0);
+		int &fields = SpellArgumentFields[evt];
+		lua_createtable(L, 0, fields);
 
 		//always push self even if invalid
 		if(IsValidSpell(spell_id)) {
@@ -542,11 +585,15 @@ int LuaParser::_EventSpell(std::string package_name, QuestEventID evt, NPC* npc,
 		
 		auto arg_function = SpellArgumentDispatch[evt];
 		arg_function(this, L, npc, client, spell_id, extra_data, extra_pointers);
+		if(!fields) {
+			fields = lua_count_fields(L, lua_gettop(L));
+		}
 		
 		quest_manager.StartQuest(npc, client, nullptr);
 		if(lua_pcall(L, 1, 1, 0)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
+			lua_pop(L, npop);
 			quest_manager.EndQuest();
 			return 0;
 		}
@@ -590,7 +637,7 @@ int LuaParser::EventEncounter(QuestEventID evt, std::string encounter_name, uint
 	return _EventEncounter(package_name, evt, encounter_name, extra_data, extra_pointers);
 }
 
-int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::string encounter_name, uint32 extra_data,
+int LuaParser::_EventEncounter(const std::string &package_name, QuestEventID evt, std::string encounter_name, uint32 extra_data,
 							   std::vector<EQEmu::Any> *extra_pointers) {
 	const char *sub_name = LuaEvents[evt];
 	
@@ -614,6 +661,7 @@ int LuaParser::_EventEncounter(std::string package_name, QuestEventID evt, std::
 		if(lua_pcall(L, 1, 1, 0)) {
 			std::string error = lua_tostring(L, -1);
 			AddError(error);
+			lua_pop(L, 2);
 			quest_manager.EndQuest();
 			return 0;
 		}
@@ -648,10 +696,7 @@ bool LuaParser::HasQuestSub(uint32 npc_id, QuestEventID evt) {
 		return false;
 	}
 
-	std::string package_name = "npc_" + std::to_string(npc_id);
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return GetPackage(LuaPackageNPC, npc_id, evt) != nullptr;
 }
 
 bool LuaParser::HasGlobalQuestSub(QuestEventID evt) {
@@ -660,8 +705,7 @@ bool LuaParser::HasGlobalQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "global_npc");
+	return GetPackage(LuaPackageGlobalNPC, 0, evt) != nullptr;
 }
 
 bool LuaParser::PlayerHasQuestSub(QuestEventID evt) {
@@ -670,8 +714,7 @@ bool LuaParser::PlayerHasQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "player");
+	return GetPackage(LuaPackagePlayer, 0, evt) != nullptr;
 }
 
 bool LuaParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
@@ -680,8 +723,7 @@ bool LuaParser::GlobalPlayerHasQuestSub(QuestEventID evt) {
 		return false;
 	}
 
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, "global_player");
+	return GetPackage(LuaPackageGlobalPlayer, 0, evt) != nullptr;
 }
 
 bool LuaParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
@@ -690,10 +732,7 @@ bool LuaParser::SpellHasQuestSub(uint32 spell_id, QuestEventID evt) {
 		return false;
 	}
 
-	std::string package_name = "spell_" + std::to_string(spell_id);
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return GetPackage(LuaPackageSpell, spell_id, evt) != nullptr;
 }
 
 bool LuaParser::ItemHasQuestSub(ItemInst *itm, QuestEventID evt) {
@@ -705,11 +744,7 @@ bool LuaParser::ItemHasQuestSub(ItemInst *itm, QuestEventID evt) {
 		return false;
 	}
 
-	std::string package_name = "item_";
-	package_name += std::to_string(itm->GetID());
-
-	const char *subname = LuaEvents[evt];
-	return HasFunction(subname, package_name);
+	return GetPackage(LuaPackageItem, itm->GetID(), evt) != nullptr;
 }
 
 bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID evt) {
@@ -727,19 +762,27 @@ bool LuaParser::EncounterHasQuestSub(std::string encounter_name, QuestEventID ev
 void LuaParser::LoadNPCScript(std::string filename, int npc_id) {
 	std::string package_name = "npc_" + std::to_string(npc_id);
 
-	LoadScript(filename, package_name);
+	if(LoadScript(filename, package_name)) {
+		CachePackage(LuaPackageNPC, npc_id, package_name);
+	}
 }
 
 void LuaParser::LoadGlobalNPCScript(std::string filename) {
-	LoadScript(filename, "global_npc");
+	if(LoadScript(filename, "global_npc")) {
+		CachePackage(LuaPackageGlobalNPC, 0, "global_npc");
+	}
 }
 
 void LuaParser::LoadPlayerScript(std::string filename) {
-	LoadScript(filename, "player");
+	if(LoadScript(filename, "player")) {
+		CachePackage(LuaPackagePlayer, 0, "player");
+	}
 }
 
 void LuaParser::LoadGlobalPlayerScript(std::string filename) {
-	LoadScript(filename, "global_player");
+	if(LoadScript(filename, "global_player")) {
+		CachePackage(LuaPackageGlobalPlayer, 0, "global_player");
+	}
 }
 
 void LuaParser::LoadItemScript(std::string filename, ItemInst *item) {
@@ -748,13 +791,17 @@ void LuaParser::LoadItemScript(std::string filename, ItemInst *item) {
 	std::string package_name = "item_";
 	package_name += std::to_string(item->GetID());
 
-	LoadScript(filename, package_name);
+	if(LoadScript(filename, package_name)) {
+		CachePackage(LuaPackageItem, item->GetID(), package_name);
+	}
 }
 
 void LuaParser::LoadSpellScript(std::string filename, uint32 spell_id) {
 	std::string package_name = "spell_" + std::to_string(spell_id);
 
-	LoadScript(filename, package_name);
+	if(LoadScript(filename, package_name)) {
+		CachePackage(LuaPackageSpell, spell_id, package_name);
+	}
 }
 
 void LuaParser::LoadEncounterScript(std::string filename, std::string encounter_name) {
@@ -787,6 +834,7 @@ void LuaParser::ReloadQuests() {
 	lua_encounters_loaded.clear();
 
 	if(L) {
+		ClearPackages();
 		lua_close(L);
 	}
 
@@ -894,17 +942,17 @@ void LuaParser::ReloadQuests() {
 	}
 }
 
-void LuaParser::LoadScript(std::string filename, std::string package_name) {
+bool LuaParser::LoadScript(std::string filename, std::string package_name) {
 	auto iter = loaded_.find(package_name);
 	if(iter != loaded_.end()) {
-		return;
+		return false;
 	}
 	
 	if(luaL_loadfile(L, filename.c_str())) {
 		std::string error = lua_tostring(L, -1);
 		AddError(error);
 		lua_pop(L, 1);
-		return;
+		return false;
 	}
 
 	//This makes an env table named: package_name
@@ -927,10 +975,11 @@ void LuaParser::LoadScript(std::string filename, std::string package_name) {
 		std::string error = lua_tostring(L, -1);
 		AddError(error);
 		lua_pop(L, 1);
-		return;
+		return false;
 	}
 
 	loaded_[package_name] = true;
+	return true;
 }
 
 bool LuaParser::HasFunction(std::string subname, std::string package_name) {
@@ -953,6 +1002,37 @@ bool LuaParser::HasFunction(std::string subname, std::string package_name) {
 	return false;
 }
 
+void LuaParser::CachePackage(LuaPackageType type, uint32 id, const std::string &package_name) {
+	lua_quest_package &package = lua_quest_packages[lua_package_key(type, id)];
+	package.name = package_name;
+
+	//the same lookup HasFunction does, so functions the env only sees through _G count too
+	lua_getfield(L, LUA_REGISTRYINDEX, package_name.c_str());
+	for(int i = 0; i < _LargestEventID; ++i) {
+		lua_getfield(L, -1, LuaEvents[i]);
+		if(lua_isfunction(L, -1)) {
+			package.events[i] = luabind::adl::object(luabind::from_stack(L, -1));
+		}
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+}
+
+lua_quest_package *LuaParser::GetPackage(LuaPackageType type, uint32 id, QuestEventID evt) {
+	auto iter = lua_quest_packages.find(lua_package_key(type, id));
+	if(iter == lua_quest_packages.end() || !iter->second.events[evt].is_valid()) {
+		return nullptr;
+	}
+
+	return &iter->second;
+}
+
+void LuaParser::ClearPackages() {
+	//everything here holds references into L, so it has to go before L is closed
+	lua_quest_packages.clear();
+	lua_clear_entity_wrappers();
+}
+
 void LuaParser::MapFunctions(lua_State *L) {
 
 	try {
@@ -9,6 +9,7 @@
 #include <map>
 
 struct lua_State;
+class Entity;
 class ItemInst;
 class Client;
 class NPC;
@@ -16,12 +17,22 @@ class NPC;
 #include "lua_parser_events.h"
 
 struct lua_registered_event;
+struct lua_quest_package;
 namespace luabind {
 	namespace adl {
 		class object;
 	}
 }
 
+typedef enum {
+	LuaPackageNPC,
+	LuaPackageGlobalNPC,
+	LuaPackagePlayer,
+	LuaPackageGlobalPlayer,
+	LuaPackageItem,
+	LuaPackageSpell
+} LuaPackageType;
+
 class LuaParser : public QuestInterface {
 public:
 	LuaParser();
@@ -74,19 +85,22 @@ public:
 		std::vector<EQEmu::Any> *extra_pointers);
 
 private:
-	int _EventNPC(std::string package_name, QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
+	int _EventNPC(const std::string &package_name, QuestEventID evt, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func = nullptr);
-	int _EventPlayer(std::string package_name, QuestEventID evt, Client *client, std::string data, uint32 extra_data,
+	int _EventPlayer(const std::string &package_name, QuestEventID evt, Client *client, std::string data, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func = nullptr);
-	int _EventItem(std::string package_name, QuestEventID evt, Client *client, ItemInst *item, Mob *mob, std::string data,
+	int _EventItem(const std::string &package_name, QuestEventID evt, Client *client, ItemInst *item, Mob *mob, std::string data,
 		uint32 extra_data, std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func = nullptr);
-	int _EventSpell(std::string package_name, QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
+	int _EventSpell(const std::string &package_name, QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers, luabind::adl::object *l_func = nullptr);
-	int _EventEncounter(std::string package_name, QuestEventID evt, std::string encounter_name, uint32 extra_data,
+	int _EventEncounter(const std::string &package_name, QuestEventID evt, std::string encounter_name, uint32 extra_data,
 		std::vector<EQEmu::Any> *extra_pointers);
 
-	void LoadScript(std::string filename, std::string package_name);
+	bool LoadScript(std::string filename, std::string package_name);
 	bool HasFunction(std::string function, std::string package_name);
+	void CachePackage(LuaPackageType type, uint32 id, const std::string &package_name);
+	lua_quest_package *GetPackage(LuaPackageType type, uint32 id, QuestEventID evt);
+	void ClearPackages();
 	void ClearStates();
 	void MapFunctions(lua_State *L);
 	QuestEventID ConvertLuaEvent(QuestEventID evt);
@@ -95,10 +109,20 @@ private:
 	std::map<std::string, bool> loaded_;
 	lua_State *L;
 
+	//the userdata handed to scripts for each entity, made on first use and dropped with the entity or L
+	lua_entity_wrappers *entity_wrappers;
+
 	NPCArgumentHandler NPCArgumentDispatch[_LargestEventID];
 	PlayerArgumentHandler PlayerArgumentDispatch[_LargestEventID];
 	ItemArgumentHandler ItemArgumentDispatch[_LargestEventID];
 	SpellArgumentHandler SpellArgumentDispatch[_LargestEventID];
+
+	//how many fields each event's argument table ended up with the first time it was sent,
+	//later tables are made that size up front
+	int NPCArgumentFields[_LargestEventID];
+	int PlayerArgumentFields[_LargestEventID];
+	int ItemArgumentFields[_LargestEventID];
+	int SpellArgumentFields[_LargestEventID];
 };
 
 #endif
@@ -1,5 +1,6 @@
 #ifdef LUA_EQEMU
 #include <sstream>
+#include <unordered_map>
 
 #include "lua.hpp"
 #include <luabind/luabind.hpp>
@@ -25,14 +26,93 @@
 #include "zone.h"
 #include "lua_parser_events.h"
 
+//Entity wrappers
+//An entity gets one userdata per wrapper type the first time an event hands it to a script and keeps it
+//until the entity is destroyed or the lua state is closed, so busy npcs and players don't make new ones every event.
+enum LuaEntityWrapper {
+	LuaWrapperMob,
+	LuaWrapperClient,
+	LuaWrapperNPC,
+	_LuaWrapperCount
+};
+
+struct lua_entity_wrappers {
+	std::unordered_map<const Entity*, luabind::adl::object> wrappers[_LuaWrapperCount];
+};
+
+//The maps belong to the LuaParser that owns L. This is only a plain pointer to them, so there is nothing here
+//for static teardown to destroy before the entities that still remove themselves in ~Entity.
+static lua_entity_wrappers *lua_current_wrappers = nullptr;
+
+lua_entity_wrappers *lua_create_entity_wrappers() {
+	lua_current_wrappers = new lua_entity_wrappers;
+	return lua_current_wrappers;
+}
+
+void lua_destroy_entity_wrappers(lua_entity_wrappers *wrappers) {
+	if(lua_current_wrappers == wrappers) {
+		lua_current_wrappers = nullptr;
+	}
+	delete wrappers;
+}
+
+template<typename T, typename E>
+static void lua_push_entity(lua_State *L, LuaEntityWrapper type, E *ent) {
+	if(!ent || !lua_current_wrappers) {
+		T l_ent(ent);
+		luabind::adl::object l_ent_o = luabind::adl::object(L, l_ent);
+		l_ent_o.push(L);
+		return;
+	}
+
+	auto &wrappers = lua_current_wrappers->wrappers[type];
+	auto iter = wrappers.find(ent);
+	if(iter == wrappers.end()) {
+		T l_ent(ent);
+		iter = wrappers.insert(std::make_pair(static_cast<const Entity*>(ent), luabind::adl::object(L, l_ent))).first;
+	}
+
+	iter->second.push(L);
+}
+
+void lua_push_mob(lua_State *L, Mob *mob) {
+	lua_push_entity<Lua_Mob>(L, LuaWrapperMob, mob);
+}
+
+void lua_push_client(lua_State *L, Client *client) {
+	lua_push_entity<Lua_Client>(L, LuaWrapperClient, client);
+}
+
+void lua_push_npc(lua_State *L, NPC *npc) {
+	lua_push_entity<Lua_NPC>(L, LuaWrapperNPC, npc);
+}
+
+void lua_forget_entity(Entity *ent) {
+	if(!lua_current_wrappers) {
+		return;
+	}
+
+	for(int i = 0; i < _LuaWrapperCount; ++i) {
+		lua_current_wrappers->wrappers[i].erase(ent);
+	}
+}
+
+void lua_clear_entity_wrappers() {
+	if(!lua_current_wrappers) {
+		return;
+	}
+
+	for(int i = 0; i < _LuaWrapperCount; ++i) {
+		lua_current_wrappers->wrappers[i].clear();
+	}
+}
+
 //NPC
 void handle_npc_event_say(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
 	npc->DoQuestPause(init);
 
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	lua_push_client(L, reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 
 	lua_pushstring(L, data.c_str());
@@ -44,9 +124,7 @@ void handle_npc_event_say(QuestInterface *parse, lua_State* L, NPC* npc, Mob *in
 
 void handle_npc_event_trade(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	lua_push_client(L, reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 	
 	lua_createtable(L, 0, 0);
@@ -100,33 +178,25 @@ void handle_npc_event_hp(QuestInterface *parse, lua_State* L, NPC* npc, Mob *ini
 
 void handle_npc_single_mob(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, init);
 	lua_setfield(L, -2, "other");
 }
 
 void handle_npc_single_client(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	lua_push_client(L, reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 }
 
 void handle_npc_single_npc(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_NPC l_npc(reinterpret_cast<NPC*>(init));
-	luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-	l_npc_o.push(L);
+	lua_push_npc(L, reinterpret_cast<NPC*>(init));
 	lua_setfield(L, -2, "other");
 }
 
 void handle_npc_task_accepted(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Client l_client(reinterpret_cast<Client*>(init));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	lua_push_client(L, reinterpret_cast<Client*>(init));
 	lua_setfield(L, -2, "other");
 
 	lua_pushinteger(L, std::stoi(data));
@@ -135,9 +205,7 @@ void handle_npc_task_accepted(QuestInterface *parse, lua_State* L, NPC* npc, Mob
 
 void handle_npc_popup(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, init);
 	lua_setfield(L, -2, "other");
 
 	lua_pushinteger(L, std::stoi(data));
@@ -146,9 +214,7 @@ void handle_npc_popup(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init,
 
 void handle_npc_waypoint(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, init);
 	lua_setfield(L, -2, "other");
 
 	lua_pushinteger(L, std::stoi(data));
@@ -157,9 +223,7 @@ void handle_npc_waypoint(QuestInterface *parse, lua_State* L, NPC* npc, Mob *ini
 
 void handle_npc_hate(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, init);
 	lua_setfield(L, -2, "other");
 
 	lua_pushboolean(L, std::stoi(data) == 0 ? false : true);
@@ -181,9 +245,7 @@ void handle_npc_timer(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init,
 
 void handle_npc_death(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Mob l_mob(init);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, init);
 	lua_setfield(L, -2, "other");
 
 	Seperator sep(data.c_str());
@@ -264,9 +326,7 @@ void handle_player_death(QuestInterface *parse, lua_State* L, Client* client, st
 	Seperator sep(data.c_str());
 
 	Mob *o = entity_list.GetMobID(std::stoi(sep.arg[0]));
-	Lua_Mob l_mob(o);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, o);
 	lua_setfield(L, -2, "other");
 
 	lua_pushinteger(L, std::stoi(sep.arg[1]));
@@ -385,17 +445,13 @@ void handle_player_zone(QuestInterface *parse, lua_State* L, Client* client, std
 
 void handle_player_duel_win(QuestInterface *parse, lua_State* L, Client* client, std::string data, uint32 extra_data,
 							std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Client l_client(EQEmu::any_cast<Client*>(extra_pointers->at(1)));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	lua_push_client(L, EQEmu::any_cast<Client*>(extra_pointers->at(1)));
 	lua_setfield(L, -2, "other");
 }
 
 void handle_player_duel_loss(QuestInterface *parse, lua_State* L, Client* client, std::string data, uint32 extra_data,
 							 std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_Client l_client(EQEmu::any_cast<Client*>(extra_pointers->at(0)));
-	luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-	l_client_o.push(L);
+	lua_push_client(L, EQEmu::any_cast<Client*>(extra_pointers->at(0)));
 	lua_setfield(L, -2, "other");
 }
 
@@ -465,9 +521,7 @@ void handle_player_combine(QuestInterface *parse, lua_State* L, Client* client,
 
 void handle_player_feign(QuestInterface *parse, lua_State* L, Client* client, std::string data, uint32 extra_data,
 						std::vector<EQEmu::Any> *extra_pointers) {
-	Lua_NPC l_npc(EQEmu::any_cast<NPC*>(extra_pointers->at(0)));
-	luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-	l_npc_o.push(L);
+	lua_push_npc(L, EQEmu::any_cast<NPC*>(extra_pointers->at(0)));
 	lua_setfield(L, -2, "other");
 }
 
@@ -520,9 +574,7 @@ void handle_item_timer(QuestInterface *parse, lua_State* L, Client* client, Item
 void handle_item_proc(QuestInterface *parse, lua_State* L, Client* client, ItemInst* item, Mob *mob, std::string data, uint32 extra_data,
 					   std::vector<EQEmu::Any> *extra_pointers) {
 
-	Lua_Mob l_mob(mob);
-	luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-	l_mob_o.push(L);
+	lua_push_mob(L, mob);
 	lua_setfield(L, -2, "target");
 
 	if(IsValidSpell(extra_data)) {
@@ -603,17 +655,11 @@ void handle_item_null(QuestInterface *parse, lua_State* L, Client* client, ItemI
 void handle_spell_effect(QuestInterface *parse, lua_State* L, NPC* npc, Client* client, uint32 spell_id, uint32 extra_data,
 						 std::vector<EQEmu::Any> *extra_pointers) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		lua_push_mob(L, npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		lua_push_mob(L, client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		lua_push_mob(L, nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -628,17 +674,11 @@ void handle_spell_effect(QuestInterface *parse, lua_State* L, NPC* npc, Client*
 void handle_spell_tic(QuestInterface *parse, lua_State* L, NPC* npc, Client* client, uint32 spell_id, uint32 extra_data,
 						 std::vector<EQEmu::Any> *extra_pointers) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		lua_push_mob(L, npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		lua_push_mob(L, client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		lua_push_mob(L, nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -659,17 +699,11 @@ void handle_spell_tic(QuestInterface *parse, lua_State* L, NPC* npc, Client* cli
 void handle_spell_fade(QuestInterface *parse, lua_State* L, NPC* npc, Client* client, uint32 spell_id, uint32 extra_data,
 					   std::vector<EQEmu::Any> *extra_pointers) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		lua_push_mob(L, npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		lua_push_mob(L, client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		lua_push_mob(L, nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -684,17 +718,11 @@ void handle_spell_fade(QuestInterface *parse, lua_State* L, NPC* npc, Client* cl
 void handle_translocate_finish(QuestInterface *parse, lua_State* L, NPC* npc, Client* client, uint32 spell_id, uint32 extra_data,
 					   std::vector<EQEmu::Any> *extra_pointers) {
 	if(npc) {
-		Lua_Mob l_npc(npc);
-		luabind::adl::object l_npc_o = luabind::adl::object(L, l_npc);
-		l_npc_o.push(L);
+		lua_push_mob(L, npc);
 	} else if(client) {
-		Lua_Mob l_client(client);
-		luabind::adl::object l_client_o = luabind::adl::object(L, l_client);
-		l_client_o.push(L);
+		lua_push_mob(L, client);
 	} else {
-		Lua_Mob l_mob(nullptr);
-		luabind::adl::object l_mob_o = luabind::adl::object(L, l_mob);
-		l_mob_o.push(L);
+		lua_push_mob(L, nullptr);
 	}
 
 	lua_setfield(L, -2, "target");
@@ -7,6 +7,16 @@ typedef void(*PlayerArgumentHandler)(QuestInterface*, lua_State*, Client*, std::
 typedef void(*ItemArgumentHandler)(QuestInterface*, lua_State*, Client*, ItemInst*, Mob*, std::string, uint32, std::vector<EQEmu::Any>*);
 typedef void(*SpellArgumentHandler)(QuestInterface*, lua_State*, NPC*, Client*, uint32, uint32, std::vector<EQEmu::Any>*);
 
+//Entity wrappers
+struct lua_entity_wrappers;
+lua_entity_wrappers *lua_create_entity_wrappers();
+void lua_destroy_entity_wrappers(lua_entity_wrappers *wrappers);
+void lua_push_mob(lua_State *L, Mob *mob);
+void lua_push_client(lua_State *L, Client *client);
+void lua_push_npc(lua_State *L, NPC *npc);
+void lua_forget_entity(Entity *ent);
+void lua_clear_entity_wrappers();
+
 //NPC
 void handle_npc_event_say(QuestInterface *parse, lua_State* L, NPC* npc, Mob *init, std::string data, uint32 extra_data,
 						  std::vector<EQEmu::Any> *extra_pointers);
@@ -1,4 +1,5 @@
 #include "../common/global_define.h"
+#include "../common/memory_mapped_file.h"
 #include "../common/misc_functions.h"
 
 #include "map.h"
@@ -6,11 +7,15 @@
 #include "zone.h"
 
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <tuple>
 #include <vector>
 #include <zlib.h>
+#include <sys/stat.h>
+
+extern Zone* zone;
 
 uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_len_max) {
 	z_stream zstream;
@@ -49,6 +54,21 @@ uint32 InflateData(const char* buffer, uint32 len, char* out_buffer, uint32 out_
 struct Map::impl
 {
 	RaycastMesh *rm;
+	//backing memory of a precompiled map, the mesh points straight into it
+	std::unique_ptr<EQEmu::MemoryMappedFile> mapped;
+};
+
+#define COMPILED_MAP_MAGIC "EQEMUCMAP"
+#define COMPILED_MAP_VERSION 1
+
+//a precompiled map is this header followed by the serialized raycast mesh
+struct CompiledMapHeader
+{
+	char magic[12];
+	uint32 version;
+	uint32 source_size; //size and modify time of the .map it was built from
+	uint32 source_time;
+	uint32 mesh_size;
 };
 
 Map::Map() {
@@ -71,28 +91,79 @@ float Map::FindBestZ(glm::vec3 &start, glm::vec3 *result) const {
 		result = &tmp;
 
 	start.z += RuleI(Map, FindBestZHeightAdjust);
+
 	glm::vec3 from(start.x, start.y, start.z);
 	glm::vec3 to(start.x, start.y, BEST_Z_INVALID);
-	float hit_distance;
-	bool hit = false;
 
-	hit = imp->rm->raycast((const RmReal*)&from, (const RmReal*)&to, (RmReal*)result, nullptr, &hit_distance);
+	bool hit;
+
+	// the ray down nearly always hits, only trace up when it doesn't. a one ray batch still
+	// gets the SSE triangle and box tests, which beats raycast even for a single ray
+	imp->rm->raycastBatch(1, (const RmReal*)&from, (const RmReal*)&to, &hit, (RmReal*)result, nullptr);
 	if(hit) {
 		return result->z;
 	}
-	
+
 	// Find nearest Z above us
-	
 	to.z = -BEST_Z_INVALID;
-	hit = imp->rm->raycast((const RmReal*)&from, (const RmReal*)&to, (RmReal*)result, nullptr, &hit_distance);
-	if (hit)
-	{
+	imp->rm->raycastBatch(1, (const RmReal*)&from, (const RmReal*)&to, &hit, (RmReal*)result, nullptr);
+	if(hit) {
 		return result->z;
 	}
-	
+
 	return BEST_Z_INVALID;
 }
 
+void Map::FindBestZBatch(const glm::vec3 *points, uint32 count, float *results) const {
+	if (!imp) {
+		for (uint32 i = 0; i < count; ++i)
+			results[i] = BEST_Z_INVALID;
+		return;
+	}
+
+	float adjust = RuleI(Map, FindBestZHeightAdjust);
+	glm::vec3 from[FIND_BEST_Z_BATCH];
+	glm::vec3 to[FIND_BEST_Z_BATCH];
+	glm::vec3 hit_location[FIND_BEST_Z_BATCH];
+	bool hit[FIND_BEST_Z_BATCH];
+	uint32 missed[FIND_BEST_Z_BATCH];
+
+	for (uint32 first = 0; first < count; first += FIND_BEST_Z_BATCH) {
+		uint32 n = std::min(count - first, (uint32)FIND_BEST_Z_BATCH);
+
+		// neighbouring points are close together so each packet of rays down walks the same nodes
+		for (uint32 i = 0; i < n; ++i) {
+			const glm::vec3 &p = points[first + i];
+			from[i] = glm::vec3(p.x, p.y, p.z + adjust);
+			to[i] = glm::vec3(p.x, p.y, BEST_Z_INVALID);
+		}
+
+		imp->rm->raycastBatch(n, (const RmReal*)from, (const RmReal*)to, hit, (RmReal*)hit_location, nullptr);
+
+		uint32 misses = 0;
+		for (uint32 i = 0; i < n; ++i) {
+			if (hit[i])
+				results[first + i] = hit_location[i].z;
+			else
+				missed[misses++] = i;
+		}
+
+		if (misses == 0)
+			continue;
+
+		// then up, only for the points with nothing below them
+		for (uint32 j = 0; j < misses; ++j) {
+			from[j] = from[missed[j]];
+			to[j] = glm::vec3(from[j].x, from[j].y, -BEST_Z_INVALID);
+		}
+
+		imp->rm->raycastBatch(misses, (const RmReal*)from, (const RmReal*)to, hit, (RmReal*)hit_location, nullptr);
+
+		for (uint32 j = 0; j < misses; ++j)
+			results[first + missed[j]] = hit[j] ? hit_location[j].z : BEST_Z_INVALID;
+	}
+}
+
 bool Map::LineIntersectsZone(glm::vec3 start, glm::vec3 end, float step, glm::vec3 *result) const {
 	if(!imp)
 		return false;
@@ -134,49 +205,65 @@ bool Map::LineIntersectsZoneNoZLeaps(glm::vec3 start, glm::vec3 end, float step_
 	if (step.z < 0 && step.z > -0.001f)
 		step.z = -0.001f;
 
+	//the line itself doesn't change as we walk it so it only has to be tested once; it is
+	//checked after the first step which can never be a z leap.
+	bool line_tested = false;
+
+	//the positions along the line don't depend on what we find at them, so collect a run
+	//of them and find the ground under all of them at once.
+	glm::vec3 points[FIND_BEST_Z_BATCH];
+	float best_z[FIND_BEST_Z_BATCH];
+
 	//while we are not past end
-	//always do this once, even if start == end.
 	while(cur.x != end.x || cur.y != end.y || cur.z != end.z)
 	{
-		steps++;
-		glm::vec3 me;
-		me.x = cur.x;
-		me.y = cur.y;
-		me.z = cur.z;
-		glm::vec3 hit;
-
-		float best_z = FindBestZ(me, &hit);
-		float diff = best_z - z;
-		diff = diff < 0 ? -diff : diff;
-
-		if (z <= BEST_Z_INVALID || best_z <= BEST_Z_INVALID || diff < 12.0)
-			z = best_z;
-		else
-			return true;
-
-		//look at current location
-		if(LineIntersectsZone(start, end, step_mag, result))
+		uint32 count = 0;
+		while (count < FIND_BEST_Z_BATCH && (cur.x != end.x || cur.y != end.y || cur.z != end.z))
 		{
-			return true;
+			points[count++] = cur;
+
+			//move 1 step
+			if (cur.x != end.x)
+				cur.x += step.x;
+			if (cur.y != end.y)
+				cur.y += step.y;
+			if (cur.z != end.z)
+				cur.z += step.z;
+
+			//watch for end conditions
+			if ( (cur.x > end.x && end.x >= start.x) || (cur.x < end.x && end.x <= start.x) || (step.x == 0) ) {
+				cur.x = end.x;
+			}
+			if ( (cur.y > end.y && end.y >= start.y) || (cur.y < end.y && end.y <= start.y) || (step.y == 0) ) {
+				cur.y = end.y;
+			}
+			if ( (cur.z > end.z && end.z >= start.z) || (cur.z < end.z && end.z < start.z) || (step.z == 0) ) {
+				cur.z = end.z;
+			}
 		}
 
-		//move 1 step
-		if (cur.x != end.x)
-			cur.x += step.x;
-		if (cur.y != end.y)
-			cur.y += step.y;
-		if (cur.z != end.z)
-			cur.z += step.z;
-
-		//watch for end conditions
-		if ( (cur.x > end.x && end.x >= start.x) || (cur.x < end.x && end.x <= start.x) || (step.x == 0) ) {
-			cur.x = end.x;
-		}
-		if ( (cur.y > end.y && end.y >= start.y) || (cur.y < end.y && end.y <= start.y) || (step.y == 0) ) {
-			cur.y = end.y;
-		}
-		if ( (cur.z > end.z && end.z >= start.z) || (cur.z < end.z && end.z < start.z) || (step.z == 0) ) {
-			cur.z = end.z;
+		FindBestZBatch(points, count, best_z);
+
+		for (uint32 i = 0; i < count; ++i)
+		{
+			steps++;
+			float diff = best_z[i] - z;
+			diff = diff < 0 ? -diff : diff;
+
+			if (z <= BEST_Z_INVALID || best_z[i] <= BEST_Z_INVALID || diff < 12.0)
+				z = best_z[i];
+			else
+				return true;
+
+			//look at current location
+			if (!line_tested)
+			{
+				line_tested = true;
+				if (LineIntersectsZone(start, end, step_mag, result))
+				{
+					return true;
+				}
+			}
 		}
 	}
 
@@ -191,15 +278,124 @@ bool Map::CheckLoS(glm::vec3 myloc, glm::vec3 oloc) const {
 	return !imp->rm->raycast((const RmReal*)&myloc, (const RmReal*)&oloc, nullptr, nullptr, nullptr);
 }
 
-Map *Map::LoadMapFile(std::string file) {
+void Map::CheckLoSBatch(const glm::vec3 *from, const glm::vec3 *to, uint32 count, bool *results) const {
+	if (!imp) {
+		for (uint32 i = 0; i < count; ++i)
+			results[i] = false;
+		return;
+	}
+
+	imp->rm->raycastBatch(count, (const RmReal*)from, (const RmReal*)to, results, nullptr, nullptr);
+	for (uint32 i = 0; i < count; ++i)
+		results[i] = !results[i];
+}
+
+void Map::RaycastBenchmark(uint32 ray_count, RaycastBenchmarkStats &los, RaycastBenchmarkStats &best_z) const {
+	memset(&los, 0, sizeof(RaycastBenchmarkStats));
+	memset(&best_z, 0, sizeof(RaycastBenchmarkStats));
+	if (!imp || ray_count == 0)
+		return;
+
+	const RmReal *bmin = imp->rm->getBoundMin();
+	const RmReal *bmax = imp->rm->getBoundMax();
+
+	// line of sight: pairs of points a short distance apart standing on the ground, like mobs checking each other
+	std::vector<glm::vec3> from(ray_count);
+	std::vector<glm::vec3> to(ray_count);
+	for (uint32 i = 0; i < ray_count; ++i) {
+		glm::vec3 a(zone->random.Real(bmin[0], bmax[0]), zone->random.Real(bmin[1], bmax[1]), bmax[2]);
+		glm::vec3 b(a.x + zone->random.Real(-150.0, 150.0), a.y + zone->random.Real(-150.0, 150.0), bmax[2]);
+		a.z = FindBestZ(a, nullptr);
+		b.z = FindBestZ(b, nullptr);
+		if (a.z <= BEST_Z_INVALID)
+			a.z = zone->random.Real(bmin[2], bmax[2]);
+		if (b.z <= BEST_Z_INVALID)
+			b.z = zone->random.Real(bmin[2], bmax[2]);
+		from[i] = glm::vec3(a.x, a.y, a.z + 6.0f);
+		to[i] = glm::vec3(b.x, b.y, b.z + 6.0f);
+	}
+
+	std::unique_ptr<bool[]> scalar_los(new bool[ray_count]);
+	std::unique_ptr<bool[]> batch_los(new bool[ray_count]);
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < ray_count; ++i)
+		scalar_los[i] = CheckLoS(from[i], to[i]);
+	los.scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	CheckLoSBatch(&from[0], &to[0], ray_count, batch_los.get());
+	los.batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	los.rays = ray_count;
+	for (uint32 i = 0; i < ray_count; ++i) {
+		if (scalar_los[i] != batch_los[i])
+			los.mismatches++;
+	}
+
+	// best z: points walked along short lines, the way LineIntersectsZoneNoZLeaps samples the ground
+	std::vector<glm::vec3> points(ray_count);
+	for (uint32 i = 0; i < ray_count; ) {
+		glm::vec3 p(zone->random.Real(bmin[0], bmax[0]), zone->random.Real(bmin[1], bmax[1]), zone->random.Real(bmin[2], bmax[2]));
+		float dx = zone->random.Real(-2.0, 2.0);
+		float dy = zone->random.Real(-2.0, 2.0);
+		for (uint32 j = 0; j < 50 && i < ray_count; ++j, ++i)
+			points[i] = glm::vec3(p.x + dx * j, p.y + dy * j, p.z);
+	}
+
+	std::vector<float> scalar_z(ray_count);
+	std::vector<float> batch_z(ray_count);
+	float adjust = RuleI(Map, FindBestZHeightAdjust);
+
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < ray_count; ++i) {
+		// one ray at a time, down and then up only if nothing was below
+		glm::vec3 p(points[i].x, points[i].y, points[i].z + adjust);
+		glm::vec3 down(p.x, p.y, BEST_Z_INVALID);
+		glm::vec3 up(p.x, p.y, -BEST_Z_INVALID);
+		glm::vec3 hit;
+		if (imp->rm->raycast((const RmReal*)&p, (const RmReal*)&down, (RmReal*)&hit, nullptr, nullptr))
+			scalar_z[i] = hit.z;
+		else if (imp->rm->raycast((const RmReal*)&p, (const RmReal*)&up, (RmReal*)&hit, nullptr, nullptr))
+			scalar_z[i] = hit.z;
+		else
+			scalar_z[i] = BEST_Z_INVALID;
+	}
+	best_z.scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	FindBestZBatch(&points[0], ray_count, &batch_z[0]);
+	best_z.batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	best_z.rays = ray_count;
+	for (uint32 i = 0; i < ray_count; ++i) {
+		float diff = scalar_z[i] - batch_z[i];
+		if (diff > 0.01f || diff < -0.01f)
+			best_z.mismatches++;
+	}
+}
+
+std::string Map::GetMapFileName(std::string file, const char *extension) {
 	std::string filename = MAP_DIR;
 	filename += "/";
 	std::transform(file.begin(), file.end(), file.begin(), ::tolower);
 	filename += file;
-	filename += ".map";
+	filename += extension;
+	return filename;
+}
+
+Map *Map::LoadMapFile(std::string file) {
+	std::string filename = GetMapFileName(file, ".map");
 
 	Map *m = new Map();
+	if (RuleB(Map, UseCompiledMaps) && m->LoadCompiled(GetMapFileName(file, ".cmap"), filename)) {
+		return m;
+	}
+
 	if (m->Load(filename)) {
+		if (RuleB(Map, UseCompiledMaps) && RuleB(Map, WriteCompiledMaps)) {
+			m->SaveCompiled(GetMapFileName(file, ".cmap"), filename);
+		}
 		return m;
 	}
 
@@ -207,6 +403,101 @@ Map *Map::LoadMapFile(std::string file) {
 	return nullptr;
 }
 
+bool Map::IsCompiled() const {
+	return imp && imp->mapped;
+}
+
+bool Map::LoadCompiled(std::string filename, std::string source_filename) {
+	struct stat compiled_stat;
+	if (stat(filename.c_str(), &compiled_stat) != 0 || compiled_stat.st_size < (off_t)(sizeof(uint32) + sizeof(CompiledMapHeader))) {
+		return false;
+	}
+
+	std::unique_ptr<EQEmu::MemoryMappedFile> mapped;
+	try {
+		mapped.reset(new EQEmu::MemoryMappedFile(filename));
+	} catch(std::exception &ex) {
+		Log.Out(Logs::General, Logs::Error, "Unable to map %s: %s", filename.c_str(), ex.what());
+		return false;
+	}
+
+	//the file starts with the size of the data after it, make sure that much really is there
+	if (mapped->Size() < sizeof(CompiledMapHeader) || mapped->Size() > compiled_stat.st_size - sizeof(uint32)) {
+		Log.Out(Logs::General, Logs::Error, "Compiled map %s is truncated, ignoring it.", filename.c_str());
+		return false;
+	}
+
+	const CompiledMapHeader *header = reinterpret_cast<const CompiledMapHeader*>(mapped->Get());
+	if (strncmp(header->magic, COMPILED_MAP_MAGIC, sizeof(header->magic)) || header->version != COMPILED_MAP_VERSION ||
+		header->mesh_size != mapped->Size() - sizeof(CompiledMapHeader)) {
+		Log.Out(Logs::General, Logs::Error, "%s is not a compiled map this server understands, ignoring it.", filename.c_str());
+		return false;
+	}
+
+	//a compiled map built from another version of the .map is stale
+	struct stat source_stat;
+	if (stat(source_filename.c_str(), &source_stat) == 0 &&
+		(header->source_size != (uint32)source_stat.st_size || header->source_time != (uint32)source_stat.st_mtime)) {
+		Log.Out(Logs::General, Logs::Status, "Compiled map %s is older than %s, ignoring it.", filename.c_str(), source_filename.c_str());
+		return false;
+	}
+
+	RaycastMesh *rm = loadRaycastMesh(header + 1, header->mesh_size);
+	if (!rm) {
+		Log.Out(Logs::General, Logs::Error, "Compiled map %s is corrupt, ignoring it.", filename.c_str());
+		return false;
+	}
+
+	if (imp) {
+		imp->rm->release();
+	} else {
+		imp = new impl;
+	}
+
+	imp->rm = rm;
+	imp->mapped = std::move(mapped);
+	return true;
+}
+
+bool Map::SaveCompiled(std::string filename, std::string source_filename) const {
+	if (!imp)
+		return false;
+
+	struct stat source_stat;
+	memset(&source_stat, 0, sizeof(source_stat));
+	stat(source_filename.c_str(), &source_stat);
+
+	uint32 mesh_size = imp->rm->getSerializedSize();
+
+	//write to a temporary file first so a zone booting at the same time never maps half a file
+	std::string temp_filename = filename + ".tmp";
+	try {
+		EQEmu::MemoryMappedFile mmf(temp_filename, sizeof(CompiledMapHeader) + mesh_size);
+		mmf.ZeroFile();
+
+		CompiledMapHeader *header = reinterpret_cast<CompiledMapHeader*>(mmf.Get());
+		strn0cpy(header->magic, COMPILED_MAP_MAGIC, sizeof(header->magic));
+		header->version = COMPILED_MAP_VERSION;
+		header->source_size = (uint32)source_stat.st_size;
+		header->source_time = (uint32)source_stat.st_mtime;
+		header->mesh_size = mesh_size;
+		imp->rm->serialize(header + 1);
+	} catch(std::exception &ex) {
+		Log.Out(Logs::General, Logs::Error, "Unable to write compiled map %s: %s", filename.c_str(), ex.what());
+		return false;
+	}
+
+	remove(filename.c_str());
+	if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+		Log.Out(Logs::General, Logs::Error, "Unable to rename %s to %s.", temp_filename.c_str(), filename.c_str());
+		remove(temp_filename.c_str());
+		return false;
+	}
+
+	Log.Out(Logs::General, Logs::Status, "Compiled map written to %s (%u bytes).", filename.c_str(), mesh_size);
+	return true;
+}
+
 bool Map::Load(std::string filename) {
 	FILE *f = fopen(filename.c_str(), "rb");
 	if(f) {
@@ -287,6 +578,7 @@ bool Map::LoadV1(FILE *f) {
 	if(imp) {
 		imp->rm->release();
 		imp->rm = nullptr;
+		imp->mapped.reset();
 	} else {
 		imp = new impl;
 	}
@@ -843,6 +1135,7 @@ bool Map::LoadV2(FILE *f) {
 	if (imp) {
 		imp->rm->release();
 		imp->rm = nullptr;
+		imp->mapped.reset();
 	}
 	else {
 		imp = new impl;
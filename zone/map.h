@@ -22,11 +22,26 @@
 #ifndef ZONE_MAP_H
 #define ZONE_MAP_H
 
+#include "../common/types.h"
 #include "position.h"
 #include <stdio.h>
 
 #define BEST_Z_INVALID -99999
 
+// number of points FindBestZBatch traces per call into the raycast mesh
+#define FIND_BEST_Z_BATCH 16
+
+// number of line of sight rays Mob::CheckLosFNBatch traces per call into the raycast mesh
+#define LOS_BATCH 16
+
+struct RaycastBenchmarkStats
+{
+	uint32 rays;
+	uint32 mismatches;
+	double scalar_seconds;
+	double batch_seconds;
+};
+
 class Map
 {
 public:
@@ -34,10 +49,17 @@ public:
 	~Map();
 
 	float FindBestZ(glm::vec3 &start, glm::vec3 *result) const;
+	void FindBestZBatch(const glm::vec3 *points, uint32 count, float *results) const;
 	bool LineIntersectsZone(glm::vec3 start, glm::vec3 end, float step, glm::vec3 *result) const;
 	bool LineIntersectsZoneNoZLeaps(glm::vec3 start, glm::vec3 end, float step_mag, glm::vec3 *result) const;
 	bool CheckLoS(glm::vec3 myloc, glm::vec3 oloc) const;
+	void CheckLoSBatch(const glm::vec3 *from, const glm::vec3 *to, uint32 count, bool *results) const;
+	void RaycastBenchmark(uint32 ray_count, RaycastBenchmarkStats &los, RaycastBenchmarkStats &best_z) const;
 	bool Load(std::string filename);
+	bool LoadCompiled(std::string filename, std::string source_filename);
+	bool SaveCompiled(std::string filename, std::string source_filename) const;
+	bool IsCompiled() const;
+	static std::string GetMapFileName(std::string file, const char *extension);
 	static Map *LoadMapFile(std::string file);
 private:
 	void RotateVertex(glm::vec3 &v, float rx, float ry, float rz);
@@ -191,6 +191,7 @@ public:
 	// stat functions
 	virtual void ScaleStats(int scalepercent, bool setmax = false);
 	virtual void CalcBonuses();
+	virtual void CalcBuffBonuses() { CalcBonuses(); } // NPC's buff only recalc would skip our stat rebuild
 	int32 GetEndurance() const {return cur_end;} //This gets our current endurance
 	inline virtual int32 GetAC() const { return AC; }
 	inline virtual int32 GetATK() const { return ATK; }
@@ -23,6 +23,7 @@
 #include "string_ids.h"
 #include "worldserver.h"
 
+#include <algorithm>
 #include <limits.h>
 #include <math.h>
 #include <sstream>
@@ -93,13 +94,13 @@ Mob::Mob(const char* in_name,
 		attack_timer(2000),
 		attack_dw_timer(2000),
 		ranged_timer(2000),
-		tic_timer(6000),
-		mana_timer(2000),
+		tic_timer(GetTimerWheel(), 6000),
+		mana_timer(GetTimerWheel(), 2000),
 		spellend_timer(0),
 		rewind_timer(30000), //Timer used for determining amount of time between actual player position updates for /rewind.
 		bindwound_timer(10000),
-		stunned_timer(0),
-		spun_timer(0),
+		stunned_timer(GetTimerWheel(), 0),
+		spun_timer(GetTimerWheel(), 0),
 		bardsong_timer(6000),
 		gravity_timer(1000),
 		viral_timer(0),
@@ -423,6 +424,14 @@ Mob::~Mob()
 		entity_list.QueueClients(this, &app, true);
 
 	entity_list.RemoveFromTargets(this, true);
+	entity_list.RemoveFromSpatialGrid(this);
+
+	// RemoveFromTargets only reaches mobs in the entity list, drop whatever is left quietly
+	while (!hated_by.empty()) {
+		Mob *hater = hated_by.back();
+		hater->hate_list.ForgetEnt(this);
+		RemoveHatedBy(hater);
+	}
 
 	if(trade) {
 		Mob *with = trade->With();
@@ -2520,6 +2529,15 @@ bool Mob::RemoveFromHateList(Mob* mob)
 	return bFound;
 }
 
+void Mob::RemoveHatedBy(Mob *hater)
+{
+	auto iter = std::find(hated_by.begin(), hated_by.end(), hater);
+	if (iter != hated_by.end()) {
+		*iter = hated_by.back();
+		hated_by.pop_back();
+	}
+}
+
 void Mob::WipeHateList()
 {
 	if(IsEngaged())
@@ -2542,6 +2560,10 @@ uint32 Mob::RandomTimer(int min,int max) {
 	return r;
 }
 
+EQEmu::TimerWheel *Mob::GetTimerWheel() {
+	return zone ? &zone->timer_wheel : nullptr;
+}
+
 uint32 NPC::GetEquipment(uint8 material_slot) const
 {
 	if(material_slot > 8)
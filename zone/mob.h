@@ -23,6 +23,7 @@
 #include "hate_list.h"
 #include "pathing.h"
 #include "position.h"
+#include "../common/timer_wheel.h"
 #include <set>
 #include <vector>
 #include <memory>
@@ -483,9 +484,14 @@ public:
 	void RemoveFromFeignMemory(Client* attacker);
 	void ClearFeignMemory();
 	void PrintHateListToClient(Client *who) { hate_list.PrintHateListToClient(who); }
-	std::list<struct_HateList*>& GetHateList() { return hate_list.GetHateList(); }
+	HateList& GetHateList() { return hate_list; }
+	// mobs that have this one on their hate list, kept up to date by HateList
+	const std::vector<Mob*>& GetHatedBy() { return hated_by; }
+	void AddHatedBy(Mob *hater) { hated_by.push_back(hater); }
+	void RemoveHatedBy(Mob *hater);
 	bool CheckLosFN(Mob* other);
 	bool CheckLosFN(float posX, float posY, float posZ, float mobSize);
+	void CheckLosFNBatch(Mob *const *others, uint32 count, bool *results);
 	inline void SetChanged() { pLastChange = Timer::GetCurrentTime(); }
 	inline const uint32 LastChange() const { return pLastChange; }
 	inline void SetLastLosState(bool value) { last_los_check = value; }
@@ -507,6 +513,8 @@ public:
 
 	//Util
 	static uint32 RandomTimer(int min, int max);
+	//! The loaded zone's timer wheel, nullptr when there is no zone yet.
+	static EQEmu::TimerWheel *GetTimerWheel();
 	static uint8 GetDefaultGender(uint16 in_race, uint8 in_gender = 0xFF);
 	static bool IsPlayerRace(uint16 in_race);
 	uint16 GetSkillByItemType(int ItemType);
@@ -894,8 +902,8 @@ public:
 	virtual FACTION_VALUE GetReverseFactionCon(Mob* iOther) { return FACTION_INDIFFERENT; }
 
 	inline bool IsTrackable() const { return(trackable); }
-	Timer* GetAIThinkTimer() { return AIthink_timer.get(); }
-	Timer* GetAIMovementTimer() { return AImovement_timer.get(); }
+	EQEmu::WheelTimer* GetAIThinkTimer() { return AIthink_timer.get(); }
+	EQEmu::WheelTimer* GetAIMovementTimer() { return AImovement_timer.get(); }
 	Timer GetAttackTimer() { return attack_timer; }
 	Timer GetAttackDWTimer() { return attack_dw_timer; }
 	inline bool IsFindable() { return findable; }
@@ -1048,6 +1056,7 @@ protected:
 	bool focused;
 	void CalcSpellBonuses(StatBonuses* newbon);
 	virtual void CalcBonuses();
+	virtual void CalcBuffBonuses() { CalcBonuses(); } // only buffs changed since the last CalcBonuses
 	void TrySkillProc(Mob *on, uint16 skill, uint16 ReuseTime, bool Success = false, uint16 hand = 0, bool IsDefensive = false); // hand = MainCharm?
 	bool PassLimitToSkill(uint16 spell_id, uint16 skill);
 	bool PassLimitClass(uint32 Classes_, uint16 Class_);
@@ -1101,8 +1110,8 @@ protected:
 	float attack_speed; //% increase/decrease in attack speed (not haste)
 	int8 attack_delay; //delay between attacks in 10ths of seconds
 	int16 slow_mitigation; // Allows for a slow mitigation (100 = 100%, 50% = 50%)
-	Timer tic_timer;
-	Timer mana_timer;
+	EQEmu::WheelTimer tic_timer;
+	EQEmu::WheelTimer mana_timer;
 
 	//spell casting vars
 	Timer spellend_timer;
@@ -1176,8 +1185,8 @@ protected:
 	Timer bindwound_timer;
 	Mob* bindwound_target;
 
-	Timer stunned_timer;
-	Timer spun_timer;
+	EQEmu::WheelTimer stunned_timer;
+	EQEmu::WheelTimer spun_timer;
 	Timer bardsong_timer;
 	Timer gravity_timer;
 	Timer viral_timer;
@@ -1189,16 +1198,17 @@ protected:
 	uint32 maxLastFightingDelayMoving;
 	float pAggroRange;
 	float pAssistRange;
-	std::unique_ptr<Timer> AIthink_timer;
-	std::unique_ptr<Timer> AImovement_timer;
-	std::unique_ptr<Timer> AItarget_check_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AIthink_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AImovement_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AItarget_check_timer;
 	bool movetimercompleted;
 	bool permarooted;
-	std::unique_ptr<Timer> AIscanarea_timer;
-	std::unique_ptr<Timer> AIwalking_timer;
-	std::unique_ptr<Timer> AIfeignremember_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AIscanarea_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AIwalking_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AIfeignremember_timer;
 	uint32 pLastFightingDelayMoving;
 	HateList hate_list;
+	std::vector<Mob*> hated_by;
 	std::set<uint32> feign_memory_list;
 	// This is to keep track of mobs we cast faction mod spells on
 	std::map<uint32,int32> faction_bonuses; // Primary FactionID, Bonus
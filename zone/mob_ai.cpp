@@ -474,13 +474,13 @@ void Mob::AI_Start(uint32 iMoveDelay) {
 		pLastFightingDelayMoving = 0;
 
 	pAIControlled = true;
-	AIthink_timer = std::unique_ptr<Timer>(new Timer(AIthink_duration));
+	AIthink_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), AIthink_duration));
 	AIthink_timer->Trigger();
-	AIwalking_timer = std::unique_ptr<Timer>(new Timer(0));
-	AImovement_timer = std::unique_ptr<Timer>(new Timer(AImovement_duration));
-	AItarget_check_timer = std::unique_ptr<Timer>(new Timer(AItarget_check_duration));
-	AIfeignremember_timer = std::unique_ptr<Timer>(new Timer(AIfeignremember_delay));
-	AIscanarea_timer = std::unique_ptr<Timer>(new Timer(AIscanarea_delay));
+	AIwalking_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), 0));
+	AImovement_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), AImovement_duration));
+	AItarget_check_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), AItarget_check_duration));
+	AIfeignremember_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), AIfeignremember_delay));
+	AIscanarea_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), AIscanarea_delay));
 #ifdef REVERSE_AGGRO
 	if(IsNPC() && !CastToNPC()->WillAggroNPCs())
 		AIscanarea_timer->Disable();
@@ -516,10 +516,10 @@ void NPC::AI_Start(uint32 iMoveDelay) {
 		return;
 
 	if (AIspells.size() == 0) {
-		AIautocastspell_timer = std::unique_ptr<Timer>(new Timer(1000));
+		AIautocastspell_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), 1000));
 		AIautocastspell_timer->Disable();
 	} else {
-		AIautocastspell_timer = std::unique_ptr<Timer>(new Timer(750));
+		AIautocastspell_timer = std::unique_ptr<EQEmu::WheelTimer>(new EQEmu::WheelTimer(GetTimerWheel(), 750));
 		AIautocastspell_timer->Start(RandomTimer(0, 15000), false);
 	}
 
@@ -731,7 +731,7 @@ void Client::AI_Process()
 	if (!IsAIControlled())
 		return;
 
-	if (!(AIthink_timer->Check() || attack_timer.Check(false)))
+	if (!(AIthink_timer->CheckDue() || attack_timer.Check(false)))
 		return;
 
 	if (IsCasting())
@@ -780,7 +780,7 @@ void Client::AI_Process()
 				//continue on to attack code, ensuring that we execute the engaged code
 				engaged = true;
 			} else {
-				if(AImovement_timer->Check()) {
+				if(AImovement_timer->CheckDue()) {
 					animation = GetRunspeed() * 21;
 					// Check if we have reached the last fear point
 					if ((std::abs(GetX() - m_FearWalkTarget.x) < 0.1) &&
@@ -814,7 +814,7 @@ void Client::AI_Process()
 			SetTarget(hate_list.GetClosestEntOnHateList(this));
 		else
 		{
-			if(AItarget_check_timer->Check())
+			if(AItarget_check_timer->CheckDue())
 			{
 				SetTarget(hate_list.GetEntWithMostHateOnList(this));
 			}
@@ -838,7 +838,7 @@ void Client::AI_Process()
 				DoClassAttacks(GetTarget());
 			}
 
-			if (AImovement_timer->Check()) {
+			if (AImovement_timer->CheckDue()) {
 				SetRunAnimSpeed(0);
 			}
 			if(IsMoving()) {
@@ -972,7 +972,7 @@ void Client::AI_Process()
 	}
 	else
 	{
-		if(AIfeignremember_timer->Check()) {
+		if(AIfeignremember_timer->CheckDue()) {
 			std::set<uint32>::iterator RememberedCharID;
 			RememberedCharID = feign_memory_list.begin();
 			while (RememberedCharID != feign_memory_list.end()) {
@@ -1023,7 +1023,7 @@ void Mob::AI_Process() {
 	if (!IsAIControlled())
 		return;
 
-	if (!(AIthink_timer->Check() || attack_timer.Check(false)))
+	if (!(AIthink_timer->CheckDue() || attack_timer.Check(false)))
 		return;
 
 	if (IsCasting())
@@ -1050,7 +1050,7 @@ void Mob::AI_Process() {
 				//continue on to attack code, ensuring that we execute the engaged code
 				engaged = true;
 			} else {
-				if(AImovement_timer->Check()) {
+				if(AImovement_timer->CheckDue()) {
 					// Check if we have reached the last fear point
 					if ((std::abs(GetX() - m_FearWalkTarget.x) < 0.1) &&
 					    (std::abs(GetY() - m_FearWalkTarget.y) < 0.1)) {
@@ -1090,7 +1090,7 @@ void Mob::AI_Process() {
 			SetTarget(hate_list.GetClosestEntOnHateList(this));
 		else
 		{
-			if(AItarget_check_timer->Check())
+			if(AItarget_check_timer->CheckDue())
 			{
 				if (IsFocused()) {
 					if (!target) {
@@ -1152,7 +1152,7 @@ void Mob::AI_Process() {
 
 		if (is_combat_range)
 		{
-			if (AImovement_timer->Check())
+			if (AImovement_timer->CheckDue())
 			{
 				SetRunAnimSpeed(0);
 			}
@@ -1401,7 +1401,7 @@ void Mob::AI_Process() {
 				if(AI_PursueCastCheck()){
 					//we did something, so do not process movement.
 				}
-				else if (AImovement_timer->Check())
+				else if (AImovement_timer->CheckDue())
 				{
 					if(!IsRooted()) {
 						Log.Out(Logs::Detail, Logs::AI, "Pursuing %s while engaged.", target->GetName());
@@ -1435,7 +1435,7 @@ void Mob::AI_Process() {
 	}
 	else
 	{
-		if(AIfeignremember_timer->Check()) {
+		if(AIfeignremember_timer->CheckDue()) {
 			// 6/14/06
 			// Improved Feign Death Memory
 			// check to see if any of our previous feigned targets have gotten up.
@@ -1460,7 +1460,7 @@ void Mob::AI_Process() {
 		{
 			//we processed a spell action, so do nothing else.
 		}
-		else if (AIscanarea_timer->Check())
+		else if (AIscanarea_timer->CheckDue())
 		{
 			/*
 			* This is where NPCs look around to see if they want to attack anybody.
@@ -1475,7 +1475,7 @@ void Mob::AI_Process() {
 			if (tmptar)
 				AddToHateList(tmptar);
 		}
-		else if (AImovement_timer->Check() && !IsRooted())
+		else if (AImovement_timer->CheckDue() && !IsRooted())
 		{
 			SetRunAnimSpeed(0);
 			if (IsPet())
@@ -1594,7 +1594,7 @@ void Mob::AI_Process() {
 				}
 
 			}
-		} // else if (AImovement_timer->Check())
+		} // else if (AImovement_timer->CheckDue())
 	}
 
 	//Do Ranged attack here
@@ -1651,7 +1651,7 @@ void NPC::AI_DoMovement() {
 	}
 	else if (roamer)
 	{
-		if (AIwalking_timer->Check())
+		if (AIwalking_timer->CheckDue())
 		{
 			movetimercompleted=true;
 			AIwalking_timer->Disable();
@@ -1931,7 +1931,7 @@ void NPC::AI_Event_SpellCastFinished(bool iCastSucceeded, uint16 slot) {
 
 
 bool NPC::AI_EngagedCastCheck() {
-	if (AIautocastspell_timer->Check(false)) {
+	if (AIautocastspell_timer->CheckDue(false)) {
 		AIautocastspell_timer->Disable();	//prevent the timer from going off AGAIN while we are casting.
 
 		Log.Out(Logs::Detail, Logs::AI, "Engaged autocast check triggered. Trying to cast healing spells then maybe offensive spells.");
@@ -1954,7 +1954,7 @@ bool NPC::AI_EngagedCastCheck() {
 }
 
 bool NPC::AI_PursueCastCheck() {
-	if (AIautocastspell_timer->Check(false)) {
+	if (AIautocastspell_timer->CheckDue(false)) {
 		AIautocastspell_timer->Disable();	//prevent the timer from going off AGAIN while we are casting.
 
 		Log.Out(Logs::Detail, Logs::AI, "Engaged (pursuing) autocast check triggered. Trying to cast offensive spells.");
@@ -1968,7 +1968,7 @@ bool NPC::AI_PursueCastCheck() {
 }
 
 bool NPC::AI_IdleCastCheck() {
-	if (AIautocastspell_timer->Check(false)) {
+	if (AIautocastspell_timer->CheckDue(false)) {
 #if MobAI_DEBUG_Spells >= 25
 		std::cout << "Non-Engaged autocast check triggered: " << this->GetName() << std::endl;
 #endif
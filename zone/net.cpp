@@ -44,6 +44,9 @@
 #include "../common/eqemu_exception.h"
 #include "../common/spdat.h"
 #include "../common/eqemu_logsys.h"
+#include "../common/event_waiter.h"
+#include "../common/loop_profiler.h"
+#include "../common/scope_profiler.h"
 
 
 #include "zone_config.h"
@@ -73,6 +76,7 @@
 #include <signal.h>
 #include <time.h>
 #include <ctime>
+#include <algorithm>
 
 #ifdef _CRTDBG_MAP_ALLOC
 	#undef new
@@ -105,6 +109,7 @@ QueryServ *QServ = 0;
 TaskManager *taskmanager = 0;
 QuestParserCollection *parse = 0;
 EQEmuLogSys Log;
+EQEmu::ScopeProfiler zone_profiler;
 
 const SPDat_Spell_Struct* spells;
 void LoadSpells(EQEmu::MemoryMappedFile **mmf);
@@ -113,6 +118,32 @@ int32 SPDAT_RECORDS = -1;
 void Shutdown();
 extern void MapOpcodes();
 
+//stages of the main loop timed by the loop profiler
+enum LoopPhase {
+	LoopPhaseWorld,
+	LoopPhaseDatabase,
+	LoopPhaseStreams,
+	LoopPhaseTimeouts,
+	LoopPhaseEntityTimers,
+	LoopPhaseEntities,
+	LoopPhaseMobs,
+	LoopPhaseZone,
+	LoopPhaseQuests,
+	LoopPhaseInterserver,
+	LoopPhaseCount
+};
+
+static const char *const LoopPhaseNames[LoopPhaseCount] = {
+	"world", "database", "streams", "timeouts", "entity timers", "entities", "mobs", "zone", "quests", "interserver"
+};
+
+//Timer::Check only fires once a timer is past due, while GetRemainingTime is already 0 on the due ms.
+//Waiting the extra ms keeps the loop from spinning through that ms with nothing to do.
+static uint32 TimeUntilCheck(Timer &timer) {
+	uint32 remaining = timer.GetRemainingTime();
+	return remaining == 0xFFFFFFFF ? remaining : remaining + 1;
+}
+
 int main(int argc, char** argv) {
 	RegisterExecutablePlatform(ExePlatformZone); 
 	Log.LoadLogSettingsDefaults();
@@ -208,12 +239,21 @@ int main(int argc, char** argv) {
 	Log.Out(Logs::General, Logs::Zone_Server, "Loading zone names");
 	database.LoadZoneNames();
 	
+	if (!database.CheckContentVersionTriggers())
+		Log.Out(Logs::General, Logs::Zone_Server, "Content version triggers are missing, zones will not use content packs");
+	
 	Log.Out(Logs::General, Logs::Zone_Server, "Loading items");
 	if (!database.LoadItems()) {
 		Log.Out(Logs::General, Logs::Error, "Loading items FAILED!");
 		Log.Out(Logs::General, Logs::Error, "Failed. But ignoring error and going on...");
 	}
 
+	Log.Out(Logs::General, Logs::Zone_Server, "Loading npc types");
+	if (!database.LoadNPCTypes()) {
+		Log.Out(Logs::General, Logs::Error, "Loading npc types FAILED!");
+		Log.Out(Logs::General, Logs::Error, "Failed. But ignoring error and going on, npc types will be read from the database...");
+	}
+
 	Log.Out(Logs::General, Logs::Zone_Server, "Loading npc faction lists");
 	if (!database.LoadNPCFactionLists()) {
 		Log.Out(Logs::General, Logs::Error, "Loading npcs faction lists FAILED!");
@@ -277,11 +317,15 @@ int main(int argc, char** argv) {
 			if(!RuleManager::Instance()->LoadRules(&database, "default")) {
 				Log.Out(Logs::General, Logs::Zone_Server, "No rule set configured, using default rules");
 			} else {
-				Log.Out(Logs::General, Logs::Zone_Server, "Loaded default rule set 'default'", tmp);
+				Log.Out(Logs::General, Logs::Zone_Server, "Loaded default rule set 'default'");
 			}
 		}
 	}
 
+	//writes nobody waits on go through these so they don't stall the main loop
+	if (RuleI(Zone, AsyncDatabaseWorkers) > 0)
+		database.StartAsyncWorkers(RuleI(Zone, AsyncDatabaseWorkers));
+
 	if(RuleB(TaskSystem, EnableTaskSystem)) {
 		Log.Out(Logs::General, Logs::Tasks, "[INIT] Loading Tasks");
 		taskmanager = new TaskManager;
@@ -326,7 +370,7 @@ int main(int argc, char** argv) {
 	RegisterAllPatches(stream_identifier);
 
 #ifndef WIN32
-	Log.Out(Logs::Detail, Logs::None,  "Main thread running with thread id %d", pthread_self());
+	Log.Out(Logs::Detail, Logs::None,  "Main thread running with thread id %lu", (unsigned long)pthread_self());
 #endif
 
 	Timer quest_timers(100);
@@ -338,16 +382,40 @@ int main(int argc, char** argv) {
 	uint8 ZONEUPDATE = 10;
 	Timer zoneupdate_timer(ZONEUPDATE);
 	zoneupdate_timer.Start();
+
+	//new streams and packets from world wake the loop up, otherwise it sleeps until the next timer is due
+	EQEmu::EventWaiter loop_waiter;
+	eqsf.SetWakeup(&loop_waiter);
+	worldserver.SetWakeup(&loop_waiter);
+	database.SetAsyncWakeup(&loop_waiter);
+	EQEmu::LoopProfiler loop_profiler(LoopPhaseNames, LoopPhaseCount);
+	loop_profiler.SetScopeProfiler(&zone_profiler);
+	zone_profiler.SetEnabled(RuleB(Zone, ProfileScopes));
+
 	while(RunLoops) {
 		{	//profiler block to omit the sleep from times
 
 		//Advance the timer to our current point in time
 		Timer::SetCurrentTime();
 
+		uint32 profile_interval = RuleI(Zone, LoopProfileInterval);
+		if (profile_interval > 0 && loop_profiler.GetElapsedUS() >= profile_interval * 1000000ull) {
+			Log.Out(Logs::General, Logs::Zone_Server, "Main loop: %s", loop_profiler.Report().c_str());
+			loop_profiler.Reset();
+		}
+
+		loop_profiler.Phase(LoopPhaseWorld);
 		worldserver.Process();
 
+		//completions of queries that ran on the async database workers
+		loop_profiler.Phase(LoopPhaseDatabase);
+		database.ProcessAsyncQueries();
+
+		loop_profiler.Phase(LoopPhaseStreams);
+
 		if (!eqsf.IsOpen() && Config->ZonePort!=0) {
 			Log.Out(Logs::General, Logs::Zone_Server, "Starting EQ Network server on port %d",Config->ZonePort);
+			eqsf.SetReaderThreads(RuleI(Network, StreamReaderThreads));
 			if (!eqsf.Open(Config->ZonePort)) {
 				Log.Out(Logs::General, Logs::Error, "Failed to open port %d",Config->ZonePort);
 				ZoneConfig::SetZonePort(0);
@@ -389,6 +457,7 @@ int main(int argc, char** argv) {
 		}
 
 		//check for timeouts in other threads
+		loop_profiler.Phase(LoopPhaseTimeouts);
 		timeout_manager.CheckTimeouts();
 
 		if (worldserver.Connected()) {
@@ -402,6 +471,11 @@ int main(int argc, char** argv) {
 
 		if (ZoneLoaded && zoneupdate_timer.Check()) {
 			{
+				loop_profiler.Phase(LoopPhaseEntityTimers);
+				//mark the mob and spawn timers that ran out before anything looks at them
+				if (zone)
+					zone->timer_wheel.Advance(Timer::GetCurrentTime());
+
 				if(net.group_timer.Enabled() && net.group_timer.Check())
 					entity_list.GroupProcess();
 
@@ -420,21 +494,27 @@ int main(int argc, char** argv) {
 				if(net.raid_timer.Enabled() && net.raid_timer.Check())
 					entity_list.RaidProcess();
 
+				loop_profiler.Phase(LoopPhaseEntities);
 				entity_list.Process(); 
+
+				loop_profiler.Phase(LoopPhaseMobs);
 				entity_list.MobProcess(); 
 				entity_list.BeaconProcess();
 
+				loop_profiler.Phase(LoopPhaseZone);
 				if (zone) {
 					if(!zone->Process()) {
 						Zone::Shutdown();
 					}
 				}
 
+				loop_profiler.Phase(LoopPhaseQuests);
 				if(quest_timers.Check())
 					quest_manager.Process();
 
 			}
 		}
+		loop_profiler.Phase(LoopPhaseInterserver);
 		if (InterserverTimer.Check()) {
 			InterserverTimer.Start();
 			database.ping();
@@ -452,7 +532,25 @@ int main(int argc, char** argv) {
 #endif
 #endif
 		}	//end extra profiler block 
-		Sleep(ZoneTimerResolution);
+		loop_profiler.Wait();
+
+		if (!RuleB(Zone, EventDrivenLoop)) {
+			Sleep(ZoneTimerResolution);
+			continue;
+		}
+
+		//sleep until the next thing we poll is due, or until another thread hands us work
+		Timer::SetCurrentTime();
+		uint32 wait = RuleI(Zone, LoopMaxWait);
+		if (ZoneLoaded)
+			wait = std::min(wait, TimeUntilCheck(zoneupdate_timer));
+		wait = std::min(wait, TimeUntilCheck(InterserverTimer));
+
+		//nothing signals us when a new stream's first packets arrive or when the port can be retried, keep polling for those
+		if (stream_identifier.HasPending() || (!eqsf.IsOpen() && Config->ZonePort != 0))
+			wait = std::min(wait, (uint32)ZoneTimerResolution);
+
+		loop_waiter.Wait(wait);
 	}
 
 	entity_list.Clear();
@@ -472,6 +570,10 @@ int main(int argc, char** argv) {
 
 	if (zone != 0)
 		Zone::Shutdown(true);
+	database.StopAsyncWorkers();
+	database.SetAsyncWakeup(nullptr);
+	eqsf.SetWakeup(nullptr);
+	worldserver.SetWakeup(nullptr);
 	//Fix for Linux world server problem.
 	eqsf.Close();
 	worldserver.Disconnect();
@@ -115,8 +115,8 @@ NPC::NPC(const NPCType* d, Spawn2* in_respawn, const glm::vec4& position, int if
 	knightattack_timer(1000),
 	assist_timer(AIassistcheck_delay),
 	qglobal_purge_timer(30000),
-	sendhpupdate_timer(1000),
-	enraged_timer(1000),
+	sendhpupdate_timer(GetTimerWheel(), 1000),
+	enraged_timer(GetTimerWheel(), 1000),
 	taunt_timer(TauntReuseTime * 1000),
 	m_SpawnPoint(position),
 	m_GuardPoint(-1,-1,-1,0),
@@ -567,7 +567,7 @@ void NPC::RemoveCash() {
 
 bool NPC::Process()
 {
-	if (IsStunned() && stunned_timer.Check())
+	if (IsStunned() && stunned_timer.CheckDue())
 	{
 		this->stunned = false;
 		this->stunned_timer.Disable();
@@ -589,7 +589,7 @@ bool NPC::Process()
 
 	SpellProcess();
 
-	if(tic_timer.Check())
+	if(tic_timer.CheckDue())
 	{
 		BuffProcess();
 
@@ -651,7 +651,7 @@ bool NPC::Process()
 		}
 	}
 
-	if (sendhpupdate_timer.Check() && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient()))) {
+	if (sendhpupdate_timer.CheckDue() && (IsTargeted() || (IsPet() && GetOwner() && GetOwner()->IsClient()))) {
 		if(!IsFullHP || cur_hp<max_hp){
 			SendHPUpdate();
 		}
@@ -689,12 +689,12 @@ bool NPC::Process()
 		return true;
 
 	if(IsStunned()) {
-		if(spun_timer.Check())
+		if(spun_timer.CheckDue())
 			Spin();
 		return true;
 	}
 
-	if (enraged_timer.Check()){
+	if (enraged_timer.CheckDue()){
 		ProcessEnrage();
 	}
 
@@ -1270,6 +1270,10 @@ uint32 ZoneDatabase::AddNPCTypes(const char *zone, uint32 zone_version, Client *
 
 uint32 ZoneDatabase::NPCSpawnDB(uint8 command, const char* zone, uint32 zone_version, Client *c, NPC* spawn, uint32 extra) {
 
+	// the spawn rows change under the zone's content pack
+	if (::zone)
+		::zone->DropContentPack();
+
 	switch (command) {
 		case 0: { // Create a new NPC and add all spawn related data
 			return CreateNewNPCCommand(zone, zone_version, c, spawn, extra);
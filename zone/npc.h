@@ -140,6 +140,7 @@ public:
 
 	void CalcItemBonuses(StatBonuses *newbon);
 	virtual void CalcBonuses();
+	virtual void CalcBuffBonuses();
 	virtual int GetCurrentBuffSlots() const { return RuleI(Spells, MaxBuffSlotsNPC); }
 	virtual int GetCurrentSongSlots() const { return RuleI(Spells, MaxSongSlotsNPC); }
 	virtual int GetCurrentDiscSlots() const { return RuleI(Spells, MaxDiscSlotsNPC); }
@@ -433,13 +434,13 @@ protected:
 	Timer	qglobal_purge_timer;
 
 	bool	combat_event;	//true if we are in combat, false otherwise
-	Timer	sendhpupdate_timer;
-	Timer	enraged_timer;
+	EQEmu::WheelTimer	sendhpupdate_timer;
+	EQEmu::WheelTimer	enraged_timer;
 	Timer *reface_timer;
 
 	uint32	npc_spells_id;
 	uint8	casting_spell_AIindex;
-	std::unique_ptr<Timer> AIautocastspell_timer;
+	std::unique_ptr<EQEmu::WheelTimer> AIautocastspell_timer;
 	uint32*	pDontCastBefore_casting_spell;
 	std::vector<AISpells_Struct> AIspells;
 	bool HasAISpell;
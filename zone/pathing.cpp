@@ -1,4 +1,5 @@
 #include "../common/global_define.h"
+#include "../common/crc32.h"
 
 #include "client.h"
 #include "doors.h"
@@ -6,9 +7,13 @@
 #include "water_map.h"
 #include "zone.h"
 
+#include <algorithm>
+#include <chrono>
+#include <float.h>
 #include <fstream>
 #include <list>
 #include <math.h>
+#include <queue>
 #include <sstream>
 #include <string.h>
 
@@ -58,10 +63,29 @@ PathManager* PathManager::LoadPathFile(const char* ZoneName)
 	{
 		Ret = new PathManager();
 
+		Ret->FileBaseName = LowerCaseZoneName;
+
 		if(Ret->loadPaths(PathFile))
 		{
 			Log.Out(Logs::General, Logs::Status, "Path File %s loaded.", ZonePathFileName);
 
+			if(RuleB(Pathing, UseNextHopTable))
+			{
+				FILE *NextHopFile = nullptr;
+
+				snprintf(ZonePathFileName, 250, MAP_DIR "/%s.nexthop", LowerCaseZoneName);
+
+				if((NextHopFile = fopen(ZonePathFileName, "rb")))
+				{
+					if(Ret->LoadNextHopTable(NextHopFile))
+						Log.Out(Logs::General, Logs::Status, "Next hop table %s loaded.", ZonePathFileName);
+					else
+						Log.Out(Logs::General, Logs::Error, "Next hop table %s does not match the path file, ignoring it.", ZonePathFileName);
+
+					fclose(NextHopFile);
+				}
+			}
+
 		}
 		else
 		{
@@ -81,7 +105,14 @@ PathManager* PathManager::LoadPathFile(const char* ZoneName)
 PathManager::PathManager()
 {
 	PathNodes = nullptr;
-	ClosedListFlag = nullptr;
+	CurrentSearch = 0;
+	NodeIndexDirty = true;
+	NodeGridMinX = 0.0f;
+	NodeGridMinY = 0.0f;
+	NodeGridColumns = 0;
+	NodeGridRows = 0;
+	RouteCacheHits = 0;
+	RouteCacheMisses = 0;
 	Head.PathNodeCount = 0;
 	Head.version = 2;
 	QuickConnectTarget = -1;
@@ -90,7 +121,6 @@ PathManager::PathManager()
 PathManager::~PathManager()
 {
 	safe_delete_array(PathNodes);
-	safe_delete_array(ClosedListFlag);
 }
 
 bool PathManager::loadPaths(FILE *PathFile)
@@ -121,7 +151,8 @@ bool PathManager::loadPaths(FILE *PathFile)
 
 	fread(PathNodes, sizeof(PathNode), Head.PathNodeCount, PathFile);
 
-	ClosedListFlag = new int[Head.PathNodeCount];
+	ResetSearchState();
+	BuildNodeIndex();
 
 #ifdef PATHDEBUG
 	PrintPathing();
@@ -204,128 +235,439 @@ glm::vec3 PathManager::GetPathNodeCoordinates(int NodeNumber, bool BestZ)
 
 }
 
+void PathManager::ResetSearchState()
+{
+	SearchNodes.assign(Head.PathNodeCount, AStarNode());
+	SearchGeneration.assign(Head.PathNodeCount, 0);
+	OpenHeapIndex.assign(Head.PathNodeCount, -1);
+	OpenHeap.clear();
+	OpenHeap.reserve(Head.PathNodeCount);
+	CurrentSearch = 0;
+}
+
+// The open list is a binary min-heap on FCost (GCost + HCost) of node ids, OpenHeapIndex
+// tracks where each node sits so a cheaper route to an open node can be sifted up in place.
+void PathManager::OpenHeapPush(int NodeID)
+{
+	OpenHeap.push_back(NodeID);
+	OpenHeapIndex[NodeID] = OpenHeap.size() - 1;
+	OpenHeapSiftUp(OpenHeap.size() - 1);
+}
+
+int PathManager::OpenHeapPop()
+{
+	int Top = OpenHeap[0];
+	OpenHeapIndex[Top] = -1;
+
+	int Last = OpenHeap.back();
+	OpenHeap.pop_back();
+
+	if(!OpenHeap.empty())
+	{
+		OpenHeap[0] = Last;
+		OpenHeapIndex[Last] = 0;
+		OpenHeapSiftDown(0);
+	}
+
+	return Top;
+}
+
+void PathManager::OpenHeapSiftUp(int Position)
+{
+	int NodeID = OpenHeap[Position];
+	float Cost = OpenCost(NodeID);
+
+	while(Position > 0)
+	{
+		int Parent = (Position - 1) / 2;
+
+		if(OpenCost(OpenHeap[Parent]) <= Cost)
+			break;
+
+		OpenHeap[Position] = OpenHeap[Parent];
+		OpenHeapIndex[OpenHeap[Position]] = Position;
+		Position = Parent;
+	}
+
+	OpenHeap[Position] = NodeID;
+	OpenHeapIndex[NodeID] = Position;
+}
+
+void PathManager::OpenHeapSiftDown(int Position)
+{
+	int Size = OpenHeap.size();
+	int NodeID = OpenHeap[Position];
+	float Cost = OpenCost(NodeID);
+
+	while(true)
+	{
+		int Child = Position * 2 + 1;
+
+		if(Child >= Size)
+			break;
+
+		if((Child + 1 < Size) && (OpenCost(OpenHeap[Child + 1]) < OpenCost(OpenHeap[Child])))
+			++Child;
+
+		if(Cost <= OpenCost(OpenHeap[Child]))
+			break;
+
+		OpenHeap[Position] = OpenHeap[Child];
+		OpenHeapIndex[OpenHeap[Position]] = Position;
+		Position = Child;
+	}
+
+	OpenHeap[Position] = NodeID;
+	OpenHeapIndex[NodeID] = Position;
+}
+
 std::deque<int> PathManager::FindRoute(int startID, int endID)
-{ 
-	Log.Out(Logs::Detail, Logs::None, "FindRoute from node %i to %i", startID, endID);
+{
+	if((startID < 0) || (endID < 0) || (startID >= (int)Head.PathNodeCount) || (endID >= (int)Head.PathNodeCount))
+		return std::deque<int>();
 
-	memset(ClosedListFlag, 0, sizeof(int) * Head.PathNodeCount); 
+	if(!NextHop.empty())
+		return NextHopRoute(startID, endID);
 
-	std::deque<AStarNode> OpenList, ClosedList;
+	uint64 Key = ((uint64)startID << 32) | (uint32)endID;
 
-	std::deque<int>Route;
+	auto Cached = RouteCacheIndex.find(Key);
+
+	if(Cached != RouteCacheIndex.end())
+	{
+		// Move it to the front, it's now the most recently used
+		RouteCache.splice(RouteCache.begin(), RouteCache, Cached->second);
+		++RouteCacheHits;
+		return Cached->second->Route;
+	}
+
+	++RouteCacheMisses;
+
+	std::deque<int> Route = SearchRoute(startID, endID);
+
+	int MaxCachedRoutes = RuleI(Pathing, RouteCacheSize);
+
+	if(MaxCachedRoutes > 0)
+	{
+		RouteCacheEntry Entry;
+		Entry.Key = Key;
+		Entry.Route = Route;
+		RouteCache.push_front(Entry);
+		RouteCacheIndex[Key] = RouteCache.begin();
+
+		while(RouteCache.size() > (size_t)MaxCachedRoutes)
+		{
+			RouteCacheIndex.erase(RouteCache.back().Key);
+			RouteCache.pop_back();
+		}
+	}
+
+	return Route;
+}
+
+void PathManager::InvalidateRoutes()
+{
+	// Called whenever the doors in the zone change, cached routes may go through a door that is gone.
+	// The node graph is the same, so the next hop table is still good.
+	RouteCache.clear();
+	RouteCacheIndex.clear();
+}
+
+std::deque<int> PathManager::NextHopRoute(int startID, int endID)
+{
+	std::deque<int> Route;
+
+	if(startID == endID)
+		return Route;
+
+	Route.push_back(startID);
+
+	int Current = startID;
+	uint32 Steps = 0;
+
+	while(Current != endID)
+	{
+		int Next = NextHop[Current * Head.PathNodeCount + endID];
+
+		// The table only ever holds shortest paths, the step limit just guards against a corrupt file
+		if((Next < 0) || (++Steps > Head.PathNodeCount))
+		{
+			Route.clear();
+			return Route;
+		}
+
+		for(int i = 0; i < PATHNODENEIGHBOURS; ++i)
+		{
+			if(PathNodes[Current].Neighbours[i].id == -1)
+				break;
+
+			if(PathNodes[Current].Neighbours[i].id == Next)
+			{
+				if(PathNodes[Current].Neighbours[i].Teleport)
+					Route.push_back(-1);
+				break;
+			}
+		}
+
+		Route.push_back(Next);
+
+		Current = Next;
+	}
+
+	return Route;
+}
+
+uint32 PathManager::PathGraphChecksum()
+{
+	return CRC32::Generate((const uint8 *)PathNodes, sizeof(PathNode) * Head.PathNodeCount);
+}
+
+uint32 PathManager::GetNextHopMaxNodes()
+{
+	int MaxNodes = RuleI(Pathing, NextHopMaxNodes);
 
-	AStarNode AStarEntry, CurrentNode;
+	// Table entries are int16
+	if((MaxNodes < 0) || (MaxNodes > NextHopNodeLimit))
+		return NextHopNodeLimit;
+
+	return MaxNodes;
+}
+
+bool PathManager::BuildNextHopTable()
+{
+	uint32 NodeCount = Head.PathNodeCount;
+
+	if((NodeCount == 0) || (NodeCount > GetNextHopMaxNodes()))
+		return false;
 
-	AStarEntry.PathNodeID = startID;
-	AStarEntry.Parent = -1;
-	AStarEntry.HCost = 0;
-	AStarEntry.GCost = 0;
-	AStarEntry.Teleport = false;
+	std::vector<int16> Table(NodeCount * NodeCount, -1);
+	std::vector<float> Distance(NodeCount);
+	std::vector<int16> FirstHop(NodeCount);
 
-	OpenList.push_back(AStarEntry);
+	typedef std::pair<float, int> QueueEntry;
 
-	while(OpenList.size() > 0)
+	// One Dijkstra search per start node, remembering which neighbour of the start each node was reached through
+	for(uint32 Start = 0; Start < NodeCount; ++Start)
 	{
-		// The OpenList is maintained in sorted order, lowest to highest cost.
+		std::fill(Distance.begin(), Distance.end(), FLT_MAX);
+		std::fill(FirstHop.begin(), FirstHop.end(), -1);
 
-		CurrentNode = (*OpenList.begin());
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> Queue;
 
-		ClosedList.push_back(CurrentNode);
+		Distance[Start] = 0.0f;
+		Queue.push(QueueEntry(0.0f, Start));
 
-		ClosedListFlag[CurrentNode.PathNodeID] = true;
+		while(!Queue.empty())
+		{
+			QueueEntry Top = Queue.top();
+			Queue.pop();
+
+			int Current = Top.second;
+
+			if(Top.first > Distance[Current])
+				continue;
+
+			for(int i = 0; i < PATHNODENEIGHBOURS; ++i)
+			{
+				NeighbourNode &Neighbour = PathNodes[Current].Neighbours[i];
 
-		OpenList.pop_front();
+				if(Neighbour.id == -1)
+					break;
+
+				float NewDistance = Top.first + Neighbour.distance;
+
+				if(NewDistance < Distance[Neighbour.id])
+				{
+					Distance[Neighbour.id] = NewDistance;
+					FirstHop[Neighbour.id] = (Current == (int)Start) ? Neighbour.id : FirstHop[Current];
+					Queue.push(QueueEntry(NewDistance, Neighbour.id));
+				}
+			}
+		}
+
+		std::copy(FirstHop.begin(), FirstHop.end(), Table.begin() + Start * NodeCount);
+	}
+
+	NextHop.swap(Table);
+	RouteCache.clear();
+	RouteCacheIndex.clear();
+
+	return true;
+}
+
+bool PathManager::SaveNextHopTable()
+{
+	char NextHopFileName[256];
+
+	if(NextHop.empty() || FileBaseName.empty())
+		return false;
+
+	snprintf(NextHopFileName, 250, MAP_DIR "/%s.nexthop", FileBaseName.c_str());
+
+	FILE *NextHopFile = fopen(NextHopFileName, "wb");
+
+	if(!NextHopFile)
+	{
+		Log.Out(Logs::General, Logs::Error, "Unable to open %s for writing.", NextHopFileName);
+		return false;
+	}
+
+	uint32 Version = 1;
+	uint32 Checksum = PathGraphChecksum();
+
+	fwrite("EQEMUNHOP", 9, 1, NextHopFile);
+	fwrite(&Version, sizeof(Version), 1, NextHopFile);
+	fwrite(&Head.PathNodeCount, sizeof(Head.PathNodeCount), 1, NextHopFile);
+	fwrite(&Checksum, sizeof(Checksum), 1, NextHopFile);
+	fwrite(&NextHop[0], sizeof(int16), NextHop.size(), NextHopFile);
+
+	fclose(NextHopFile);
+
+	Log.Out(Logs::General, Logs::Status, "Next hop table for %i path nodes written to %s.", Head.PathNodeCount, NextHopFileName);
+
+	return true;
+}
+
+bool PathManager::LoadNextHopTable(FILE *NextHopFile)
+{
+	char Magic[10];
+
+	uint32 Version = 0, NodeCount = 0, Checksum = 0;
+
+	if((fread(&Magic, 9, 1, NextHopFile) != 1) || strncmp(Magic, "EQEMUNHOP", 9))
+		return false;
+
+	if((fread(&Version, sizeof(Version), 1, NextHopFile) != 1) || (Version != 1))
+		return false;
+
+	// A table built from a different version of the .path file is useless
+	if((fread(&NodeCount, sizeof(NodeCount), 1, NextHopFile) != 1) || (NodeCount != Head.PathNodeCount) || (NodeCount > NextHopNodeLimit))
+		return false;
+
+	if((fread(&Checksum, sizeof(Checksum), 1, NextHopFile) != 1) || (Checksum != PathGraphChecksum()))
+		return false;
+
+	std::vector<int16> Table(NodeCount * NodeCount);
+
+	if(fread(&Table[0], sizeof(int16), Table.size(), NextHopFile) != Table.size())
+		return false;
+
+	NextHop.swap(Table);
+
+	return true;
+}
+
+std::deque<int> PathManager::SearchRoute(int startID, int endID)
+{ 
+	Log.Out(Logs::Detail, Logs::None, "FindRoute from node %i to %i", startID, endID);
+
+	std::deque<int>Route;
+
+	if(SearchNodes.size() != Head.PathNodeCount)
+		ResetSearchState();
+
+	// Start a new generation, every node stamped with an older one counts as unvisited.
+	if(++CurrentSearch == 0)
+	{
+		std::fill(SearchGeneration.begin(), SearchGeneration.end(), 0);
+		CurrentSearch = 1;
+	}
+
+	OpenHeap.clear();
+
+	AStarNode &StartNode = SearchNodes[startID];
+	StartNode.PathNodeID = startID;
+	StartNode.Parent = -1;
+	StartNode.HCost = 0;
+	StartNode.GCost = 0;
+	StartNode.Teleport = false;
+	SearchGeneration[startID] = CurrentSearch;
+
+	OpenHeapPush(startID);
+
+	while(!OpenHeap.empty())
+	{
+		// Popping a node closes it, its OpenHeapIndex goes back to -1.
+		int CurrentID = OpenHeapPop();
+
+		AStarNode &CurrentNode = SearchNodes[CurrentID];
 
 		for(int i = 0; i < PATHNODENEIGHBOURS; ++i)
 		{
-			if(PathNodes[CurrentNode.PathNodeID].Neighbours[i].id == -1)
+			NeighbourNode &Neighbour = PathNodes[CurrentID].Neighbours[i];
+
+			if(Neighbour.id == -1)
 				break;
 
-			if(PathNodes[CurrentNode.PathNodeID].Neighbours[i].id == CurrentNode.Parent)
+			if(Neighbour.id == CurrentNode.Parent)
 				continue;
 
-			if(PathNodes[CurrentNode.PathNodeID].Neighbours[i].id == endID)
+			if(Neighbour.id == endID)
 			{
-				Route.push_back(CurrentNode.PathNodeID);
+				Route.push_back(CurrentID);
 
 				Route.push_back(endID);
 
-				std::deque<AStarNode>::iterator RouteIterator;
+				int RouteNode = CurrentID;
 
-				while(CurrentNode.PathNodeID != startID)
+				while(RouteNode != startID)
 				{
-					for(RouteIterator = ClosedList.begin(); RouteIterator != ClosedList.end(); ++RouteIterator)
-					{
-						if((*RouteIterator).PathNodeID == CurrentNode.Parent)
-						{
-							if(CurrentNode.Teleport)
-								Route.insert(Route.begin(), -1);
+					if(SearchNodes[RouteNode].Teleport)
+						Route.push_front(-1);
 
-							CurrentNode = (*RouteIterator);
+					RouteNode = SearchNodes[RouteNode].Parent;
 
-							Route.insert(Route.begin(), CurrentNode.PathNodeID);
-
-							break;
-						}
-					}
+					Route.push_front(RouteNode);
 				}
 
 				return Route;
 			}
-			if(ClosedListFlag[PathNodes[CurrentNode.PathNodeID].Neighbours[i].id])
-				continue;
 
-			AStarEntry.PathNodeID = PathNodes[CurrentNode.PathNodeID].Neighbours[i].id;
+			float GCostToNode = CurrentNode.GCost + Neighbour.distance;
+
+			AStarNode &NeighbourEntry = SearchNodes[Neighbour.id];
 
-			AStarEntry.Parent = CurrentNode.PathNodeID;
+			if(SearchGeneration[Neighbour.id] != CurrentSearch)
+			{
+				SearchGeneration[Neighbour.id] = CurrentSearch;
 
-			AStarEntry.Teleport = PathNodes[CurrentNode.PathNodeID].Neighbours[i].Teleport;
+				NeighbourEntry.PathNodeID = Neighbour.id;
 
-			// HCost is the estimated cost to get from this node to the end.
-			AStarEntry.HCost = VectorDistance(PathNodes[PathNodes[CurrentNode.PathNodeID].Neighbours[i].id].v,
-											PathNodes[endID].v);
+				NeighbourEntry.Parent = CurrentID;
 
-			AStarEntry.GCost = CurrentNode.GCost + PathNodes[CurrentNode.PathNodeID].Neighbours[i].distance;
+				NeighbourEntry.Teleport = Neighbour.Teleport;
 
-			float FCost = AStarEntry.HCost + AStarEntry.GCost;
+				// HCost is the estimated cost to get from this node to the end.
+				NeighbourEntry.HCost = VectorDistance(PathNodes[Neighbour.id].v, PathNodes[endID].v);
+
+				NeighbourEntry.GCost = GCostToNode;
 #ifdef PATHDEBUG
-			printf("Node: %i, Open Neighbour %i has HCost %8.3f, GCost %8.3f (Total Cost: %8.3f)\n",
-					CurrentNode.PathNodeID,
-					PathNodes[CurrentNode.PathNodeID].Neighbours[i].id,
-					AStarEntry.HCost,
-					AStarEntry.GCost,
-					AStarEntry.HCost + AStarEntry.GCost);
+				printf("Node: %i, Open Neighbour %i has HCost %8.3f, GCost %8.3f (Total Cost: %8.3f)\n",
+						CurrentID,
+						Neighbour.id,
+						NeighbourEntry.HCost,
+						NeighbourEntry.GCost,
+						NeighbourEntry.HCost + NeighbourEntry.GCost);
 #endif
+				OpenHeapPush(Neighbour.id);
 
-			bool AlreadyInOpenList = false;
+				continue;
+			}
 
-			std::deque<AStarNode>::iterator OpenListIterator, InsertionPoint = OpenList.end();
+			// Already closed
+			if(OpenHeapIndex[Neighbour.id] < 0)
+				continue;
 
-			for(OpenListIterator = OpenList.begin(); OpenListIterator != OpenList.end(); ++OpenListIterator)
+			if(GCostToNode < NeighbourEntry.GCost)
 			{
-				if((*OpenListIterator).PathNodeID == PathNodes[CurrentNode.PathNodeID].Neighbours[i].id)
-				{
-					AlreadyInOpenList = true;
+				NeighbourEntry.Parent = CurrentID;
 
-					float GCostToNode = CurrentNode.GCost + PathNodes[CurrentNode.PathNodeID].Neighbours[i].distance;
+				NeighbourEntry.GCost = GCostToNode;
 
-					if(GCostToNode < (*OpenListIterator).GCost)
-					{
-						(*OpenListIterator).Parent = CurrentNode.PathNodeID;
-
-						(*OpenListIterator).GCost = GCostToNode;
+				NeighbourEntry.Teleport = Neighbour.Teleport;
 
-						(*OpenListIterator).Teleport = PathNodes[CurrentNode.PathNodeID].Neighbours[i].Teleport;
-					}
-					break;
-				}
-				else if((InsertionPoint == OpenList.end()) && (((*OpenListIterator).HCost + (*OpenListIterator).GCost) > FCost))
-				{
-					InsertionPoint = OpenListIterator;
-				}
+				OpenHeapSiftUp(OpenHeapIndex[Neighbour.id]);
 			}
-			if(!AlreadyInOpenList)
-				OpenList.insert(InsertionPoint, AStarEntry);
 		}
 
 	}
@@ -362,36 +704,7 @@ std::deque<int> PathManager::FindRoute(glm::vec3 Start, glm::vec3 End)
 	// Find the nearest PathNode the Start has LOS to.
 	//
 	//
-	int ClosestPathNodeToStart = -1;
-
-	std::deque<PathNodeSortStruct> SortedByDistance;
-
-	PathNodeSortStruct TempNode;
-
-	for(uint32 i = 0 ; i < Head.PathNodeCount; ++i)
-	{
-		if ((std::abs(Start.x - PathNodes[i].v.x) <= CandidateNodeRangeXY) &&
-		    (std::abs(Start.y - PathNodes[i].v.y) <= CandidateNodeRangeXY) &&
-		    (std::abs(Start.z - PathNodes[i].v.z) <= CandidateNodeRangeZ)) {
-			TempNode.id = i;
-			TempNode.Distance = VectorDistanceNoRoot(Start, PathNodes[i].v);
-			SortedByDistance.push_back(TempNode);
-
-		}
-	}
-
-	std::sort(SortedByDistance.begin(), SortedByDistance.end(), path_compare);
-
-	for(auto Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
-	{
-		Log.Out(Logs::Detail, Logs::None, "Checking Reachability of Node %i from Start Position.", PathNodes[(*Iterator).id].id);
-
-		if(!zone->zonemap->LineIntersectsZone(Start, PathNodes[(*Iterator).id].v, 1.0f, nullptr))
-		{
-			ClosestPathNodeToStart = (*Iterator).id;
-			break;
-		}
-	}
+	int ClosestPathNodeToStart = FindNearestNodeWithLOS(Start, CandidateNodeRangeXY, CandidateNodeRangeZ);
 
 	if(ClosestPathNodeToStart <0 ) {
 		Log.Out(Logs::Detail, Logs::None, "No LOS to any starting Path Node within range.");
@@ -402,36 +715,7 @@ std::deque<int> PathManager::FindRoute(glm::vec3 Start, glm::vec3 End)
 
 	// Find the nearest PathNode the end point has LOS to
 
-	int ClosestPathNodeToEnd = -1;
-
-	SortedByDistance.clear();
-
-	for(uint32 i = 0 ; i < Head.PathNodeCount; ++i)
-	{
-		if ((std::abs(End.x - PathNodes[i].v.x) <= CandidateNodeRangeXY) &&
-		    (std::abs(End.y - PathNodes[i].v.y) <= CandidateNodeRangeXY) &&
-		    (std::abs(End.z - PathNodes[i].v.z) <= CandidateNodeRangeZ)) {
-			TempNode.id = i;
-			TempNode.Distance = VectorDistanceNoRoot(End, PathNodes[i].v);
-			SortedByDistance.push_back(TempNode);
-		}
-	}
-
-	std::sort(SortedByDistance.begin(), SortedByDistance.end(), path_compare);
-
-	for(auto Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
-	{
-		Log.Out(Logs::Detail, Logs::None, "Checking Reachability of Node %i from End Position.", PathNodes[(*Iterator).id].id);
-		Log.Out(Logs::Detail, Logs::None, " (%8.3f, %8.3f, %8.3f) to (%8.3f, %8.3f, %8.3f)",
-			End.x, End.y, End.z,
-			PathNodes[(*Iterator).id].v.x, PathNodes[(*Iterator).id].v.y, PathNodes[(*Iterator).id].v.z);
-
-		if(!zone->zonemap->LineIntersectsZone(End, PathNodes[(*Iterator).id].v, 1.0f, nullptr))
-		{
-			ClosestPathNodeToEnd = (*Iterator).id;
-			break;
-		}
-	}
+	int ClosestPathNodeToEnd = FindNearestNodeWithLOS(End, CandidateNodeRangeXY, CandidateNodeRangeZ);
 
 	if(ClosestPathNodeToEnd < 0) {
 		Log.Out(Logs::Detail, Logs::None, "No LOS to any end Path Node within range.");
@@ -649,6 +933,53 @@ void PathManager::SimpleMeshTest()
 	fflush(stdout);
 }
 
+void PathManager::RouteBenchmark(Client *c, uint32 MaxRoutes)
+{
+	// Times FindRoute between every pair of path nodes, or the first MaxRoutes pairs if non zero
+
+	uint32 TotalTests = 0;
+	uint32 NoConnections = 0;
+	uint64 TotalRouteNodes = 0;
+
+	auto Start = std::chrono::steady_clock::now();
+
+	for(uint32 i = 0; i < Head.PathNodeCount; ++i)
+	{
+		for(uint32 j = 0; j < Head.PathNodeCount; ++j)
+		{
+			if(j == i)
+				continue;
+
+			if(MaxRoutes && TotalTests >= MaxRoutes)
+				break;
+
+			std::deque<int> Route = FindRoute(i, j);
+
+			if(Route.size() == 0)
+				++NoConnections;
+
+			TotalRouteNodes += Route.size();
+			++TotalTests;
+		}
+	}
+
+	double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	double RoutesPerSecond = Elapsed > 0.0 ? TotalTests / Elapsed : 0.0;
+
+	printf("Route benchmark: %u nodes, %u route searches in %.3f seconds (%.0f routes/sec), %u without a route, %.1f nodes per route.\n",
+		Head.PathNodeCount, TotalTests, Elapsed, RoutesPerSecond, NoConnections,
+		TotalTests ? (double)TotalRouteNodes / TotalTests : 0.0);
+	fflush(stdout);
+
+	if(c)
+	{
+		c->Message(0, "Route benchmark: %u route searches over %u nodes in %.3f seconds, %.0f routes/sec, %u failed.",
+			TotalTests, Head.PathNodeCount, Elapsed, RoutesPerSecond, NoConnections);
+		c->Message(0, "Next hop table: %s, route cache: %u routes, %u hits, %u misses.",
+			NextHop.empty() ? "not loaded" : "loaded", (uint32)RouteCache.size(), RouteCacheHits, RouteCacheMisses);
+	}
+}
+
 glm::vec3 Mob::UpdatePath(float ToX, float ToY, float ToZ, float Speed, bool &WaypointChanged, bool &NodeReached)
 {
 	WaypointChanged = false;
@@ -678,7 +1009,7 @@ glm::vec3 Mob::UpdatePath(float ToX, float ToY, float ToZ, float Speed, bool &Wa
 
 		if((PathingLoopCount > 5) && !IsRooted())
 		{
-			Log.Out(Logs::Detail, Logs::None, "appears to be stuck. Teleporting them to next position.", GetName());
+			Log.Out(Logs::Detail, Logs::None, "%s appears to be stuck. Teleporting them to next position.", GetName());
 
 			if(Route.size() == 0)
 			{
@@ -1094,21 +1425,167 @@ int PathManager::FindNearestPathNode(glm::vec3 Position)
 
 	float CandidateNodeRangeZ = RuleR(Pathing, CandidateNodeRangeZ);
 
-	int ClosestPathNodeToStart = -1;
+	int ClosestPathNodeToStart = FindNearestNodeWithLOS(Position, CandidateNodeRangeXY, CandidateNodeRangeZ);
 
-	std::deque<PathNodeSortStruct> SortedByDistance;
+	if(ClosestPathNodeToStart <0 ) {
+		Log.Out(Logs::Detail, Logs::None, "No LOS to any starting Path Node within range.");
+		return -1;
+	}
+	return ClosestPathNodeToStart;
+}
+
+void PathManager::PathNodesChanged()
+{
+	NodeIndexDirty = true;
+	InvalidateRoutes();
+
+	if(!NextHop.empty())
+	{
+		Log.Out(Logs::General, Logs::Status, "Path nodes changed, discarding the next hop table.");
+		std::vector<int16>().swap(NextHop);
+	}
+}
+
+void PathManager::BuildNodeIndex()
+{
+	NodeIndexDirty = false;
+	NodeGridStart.clear();
+	NodeGridNodes.clear();
+	NodeGridColumns = 0;
+	NodeGridRows = 0;
+
+	if(!PathNodes || (Head.PathNodeCount == 0))
+		return;
+
+	float MaxX = PathNodes[0].v.x, MaxY = PathNodes[0].v.y;
+	NodeGridMinX = MaxX;
+	NodeGridMinY = MaxY;
+
+	for(uint32 i = 1; i < Head.PathNodeCount; ++i)
+	{
+		NodeGridMinX = std::min(NodeGridMinX, PathNodes[i].v.x);
+		NodeGridMinY = std::min(NodeGridMinY, PathNodes[i].v.y);
+		MaxX = std::max(MaxX, PathNodes[i].v.x);
+		MaxY = std::max(MaxY, PathNodes[i].v.y);
+	}
+
+	NodeGridColumns = (int)((MaxX - NodeGridMinX) / PATHNODE_GRID_CELL_SIZE) + 1;
+	NodeGridRows = (int)((MaxY - NodeGridMinY) / PATHNODE_GRID_CELL_SIZE) + 1;
+
+	// Count the nodes per cell, turn the counts into start offsets, then drop the ids in
+	std::vector<int> NodeCell(Head.PathNodeCount);
+	NodeGridStart.assign(NodeGridColumns * NodeGridRows + 1, 0);
+
+	for(uint32 i = 0; i < Head.PathNodeCount; ++i)
+	{
+		int Column = (int)((PathNodes[i].v.x - NodeGridMinX) / PATHNODE_GRID_CELL_SIZE);
+		int Row = (int)((PathNodes[i].v.y - NodeGridMinY) / PATHNODE_GRID_CELL_SIZE);
+		NodeCell[i] = Row * NodeGridColumns + Column;
+		++NodeGridStart[NodeCell[i] + 1];
+	}
+
+	for(size_t i = 1; i < NodeGridStart.size(); ++i)
+		NodeGridStart[i] += NodeGridStart[i - 1];
+
+	std::vector<int> Fill(NodeGridStart.begin(), NodeGridStart.end() - 1);
+	NodeGridNodes.resize(Head.PathNodeCount);
+
+	for(uint32 i = 0; i < Head.PathNodeCount; ++i)
+		NodeGridNodes[Fill[NodeCell[i]]++] = i;
+}
+
+int PathManager::FindNearestNodeWithLOS(glm::vec3 Position, float RangeXY, float RangeZ)
+{
+	// Hands out the nodes in the candidate box nearest first by scanning grid rings outward from
+	// Position. A node is only LOS checked once no unscanned cell could hold a closer one, so the
+	// usual case is a ring or two of cells and a single raycast instead of sorting every node.
+	if(NodeIndexDirty)
+		BuildNodeIndex();
+
+	if(NodeGridColumns == 0)
+		return -1;
+
+	typedef std::pair<float, int> Candidate;
+
+	std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> Candidates;
+
+	int CenterColumn = (int)floorf((Position.x - NodeGridMinX) / PATHNODE_GRID_CELL_SIZE);
+	int CenterRow = (int)floorf((Position.y - NodeGridMinY) / PATHNODE_GRID_CELL_SIZE);
+	int MaxRing = (int)(RangeXY / PATHNODE_GRID_CELL_SIZE) + 1;
+
+	for(int Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		for(int Row = CenterRow - Ring; Row <= CenterRow + Ring; ++Row)
+		{
+			if((Row < 0) || (Row >= NodeGridRows))
+				continue;
+
+			// Only the border of the square is new on this ring
+			int Step = ((Row == CenterRow - Ring) || (Row == CenterRow + Ring)) ? 1 : std::max(2 * Ring, 1);
+
+			for(int Column = CenterColumn - Ring; Column <= CenterColumn + Ring; Column += Step)
+			{
+				if((Column < 0) || (Column >= NodeGridColumns))
+					continue;
+
+				int Cell = Row * NodeGridColumns + Column;
+
+				for(int n = NodeGridStart[Cell]; n < NodeGridStart[Cell + 1]; ++n)
+				{
+					int i = NodeGridNodes[n];
+
+					if ((std::abs(Position.x - PathNodes[i].v.x) <= RangeXY) &&
+					    (std::abs(Position.y - PathNodes[i].v.y) <= RangeXY) &&
+					    (std::abs(Position.z - PathNodes[i].v.z) <= RangeZ)) {
+						Candidates.push(Candidate(VectorDistanceNoRoot(Position, PathNodes[i].v), i));
+					}
+				}
+			}
+		}
+
+		// Closest any node outside the rings scanned so far can be
+		float Reach = FLT_MAX;
+
+		if(Ring < MaxRing)
+		{
+			Reach = std::min(
+				std::min(Position.x - (NodeGridMinX + (CenterColumn - Ring) * PATHNODE_GRID_CELL_SIZE),
+					(NodeGridMinX + (CenterColumn + Ring + 1) * PATHNODE_GRID_CELL_SIZE) - Position.x),
+				std::min(Position.y - (NodeGridMinY + (CenterRow - Ring) * PATHNODE_GRID_CELL_SIZE),
+					(NodeGridMinY + (CenterRow + Ring + 1) * PATHNODE_GRID_CELL_SIZE) - Position.y));
+			Reach *= Reach;
+		}
+
+		while(!Candidates.empty() && (Candidates.top().first <= Reach))
+		{
+			int i = Candidates.top().second;
+			Candidates.pop();
+
+			Log.Out(Logs::Detail, Logs::None, "Checking Reachability of Node %i from Position.", PathNodes[i].id);
+
+			if(!zone->zonemap->LineIntersectsZone(Position, PathNodes[i].v, 1.0f, nullptr))
+				return i;
+		}
+	}
+
+	return -1;
+}
+
+int PathManager::FindNearestNodeBySort(glm::vec3 Position, float RangeXY, float RangeZ)
+{
+	// The lookup FindNearestNodeWithLOS replaced, kept for NearestNodeBenchmark
+	std::vector<PathNodeSortStruct> SortedByDistance;
 
 	PathNodeSortStruct TempNode;
 
 	for(uint32 i = 0 ; i < Head.PathNodeCount; ++i)
 	{
-		if ((std::abs(Position.x - PathNodes[i].v.x) <= CandidateNodeRangeXY) &&
-		    (std::abs(Position.y - PathNodes[i].v.y) <= CandidateNodeRangeXY) &&
-		    (std::abs(Position.z - PathNodes[i].v.z) <= CandidateNodeRangeZ)) {
+		if ((std::abs(Position.x - PathNodes[i].v.x) <= RangeXY) &&
+		    (std::abs(Position.y - PathNodes[i].v.y) <= RangeXY) &&
+		    (std::abs(Position.z - PathNodes[i].v.z) <= RangeZ)) {
 			TempNode.id = i;
 			TempNode.Distance = VectorDistanceNoRoot(Position, PathNodes[i].v);
 			SortedByDistance.push_back(TempNode);
-
 		}
 	}
 
@@ -1116,20 +1593,66 @@ int PathManager::FindNearestPathNode(glm::vec3 Position)
 
 	for(auto Iterator = SortedByDistance.begin(); Iterator != SortedByDistance.end(); ++Iterator)
 	{
-		Log.Out(Logs::Detail, Logs::None, "Checking Reachability of Node %i from Start Position.", PathNodes[(*Iterator).id].id);
-
 		if(!zone->zonemap->LineIntersectsZone(Position, PathNodes[(*Iterator).id].v, 1.0f, nullptr))
-		{
-			ClosestPathNodeToStart = (*Iterator).id;
-			break;
-		}
+			return (*Iterator).id;
 	}
 
-	if(ClosestPathNodeToStart <0 ) {
-		Log.Out(Logs::Detail, Logs::None, "No LOS to any starting Path Node within range.");
-		return -1;
+	return -1;
+}
+
+void PathManager::NearestNodeBenchmark(Client *c, uint32 Lookups)
+{
+	// Times nearest path node lookups from points scattered around random nodes with the grid index and with a full sort
+
+	if(!c || !zone->zonemap || (Head.PathNodeCount == 0))
+		return;
+
+	if(Lookups == 0)
+		Lookups = 10000;
+
+	float RangeXY = RuleR(Pathing, CandidateNodeRangeXY);
+	float RangeZ = RuleR(Pathing, CandidateNodeRangeZ);
+
+	std::vector<glm::vec3> Points;
+	Points.reserve(Lookups);
+
+	for(uint32 i = 0; i < Lookups; ++i)
+	{
+		glm::vec3 Point = PathNodes[zone->random.Int(0, Head.PathNodeCount - 1)].v;
+		Point.x += zone->random.Real(-RangeXY / 2, RangeXY / 2);
+		Point.y += zone->random.Real(-RangeXY / 2, RangeXY / 2);
+		Points.push_back(Point);
 	}
-	return ClosestPathNodeToStart;
+
+	std::vector<int> Indexed(Lookups), Sorted(Lookups);
+
+	auto Start = std::chrono::steady_clock::now();
+
+	for(uint32 i = 0; i < Lookups; ++i)
+		Indexed[i] = FindNearestNodeWithLOS(Points[i], RangeXY, RangeZ);
+
+	double IndexedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	Start = std::chrono::steady_clock::now();
+
+	for(uint32 i = 0; i < Lookups; ++i)
+		Sorted[i] = FindNearestNodeBySort(Points[i], RangeXY, RangeZ);
+
+	double SortedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	uint32 Mismatches = 0;
+
+	// Nodes at exactly the same distance may come out in either order
+	for(uint32 i = 0; i < Lookups; ++i)
+	{
+		if((Indexed[i] != Sorted[i]) && ((Indexed[i] < 0) || (Sorted[i] < 0) ||
+			(VectorDistanceNoRoot(Points[i], PathNodes[Indexed[i]].v) != VectorDistanceNoRoot(Points[i], PathNodes[Sorted[i]].v))))
+			++Mismatches;
+	}
+
+	c->Message(0, "Nearest node benchmark: %u lookups over %u nodes. Grid index %.3f seconds (%.0f/sec), sort %.3f seconds (%.0f/sec), %u mismatches.",
+		Lookups, Head.PathNodeCount, IndexedTime, IndexedTime > 0.0 ? Lookups / IndexedTime : 0.0,
+		SortedTime, SortedTime > 0.0 ? Lookups / SortedTime : 0.0, Mismatches);
 }
 
 bool PathManager::NoHazards(glm::vec3 From, glm::vec3 To)
@@ -1460,6 +1983,8 @@ void PathManager::DumpPath(std::string filename)
 
 int32 PathManager::AddNode(float x, float y, float z, float best_z, int32 requested_id)
 {
+	PathNodesChanged();
+
 	int32 new_id = -1;
 	if(requested_id != 0)
 	{
@@ -1577,8 +2102,7 @@ int32 PathManager::AddNode(float x, float y, float z, float best_z, int32 reques
 		npc->GiveNPCTypeData(npc_type);
 		entity_list.AddNPC(npc, true, true);
 
-		safe_delete_array(ClosedListFlag);
-		ClosedListFlag = new int[Head.PathNodeCount];
+		ResetSearchState();
 		return new_id;
 	}
 	else
@@ -1638,7 +2162,7 @@ int32 PathManager::AddNode(float x, float y, float z, float best_z, int32 reques
 		npc->GiveNPCTypeData(npc_type);
 		entity_list.AddNPC(npc, true, true);
 
-		ClosedListFlag = new int[Head.PathNodeCount];
+		ResetSearchState();
 
 		return new_id;
 	}
@@ -1668,6 +2192,8 @@ bool PathManager::DeleteNode(Client *c)
 
 bool PathManager::DeleteNode(int32 id)
 {
+	PathNodesChanged();
+
 	//if the current list is > 1 in size create a new list of size current size - 1
 	//transfer all but the current node to this new list and delete our current list
 	//set this new list to be our current list
@@ -1714,8 +2240,7 @@ bool PathManager::DeleteNode(int32 id)
 				}
 			}
 		}
-		safe_delete_array(ClosedListFlag);
-		ClosedListFlag = new int[Head.PathNodeCount];
+		ResetSearchState();
 	}
 	else
 	{
@@ -1754,6 +2279,8 @@ void PathManager::ConnectNodeToNode(Client *c, int32 Node2, int32 teleport, int3
 
 void PathManager::ConnectNodeToNode(int32 Node1, int32 Node2, int32 teleport, int32 doorid)
 {
+	PathNodesChanged();
+
 	PathNode *a = nullptr;
 	PathNode *b = nullptr;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
@@ -1844,6 +2371,8 @@ void PathManager::ConnectNode(Client *c, int32 Node2, int32 teleport, int32 door
 
 void PathManager::ConnectNode(int32 Node1, int32 Node2, int32 teleport, int32 doorid)
 {
+	PathNodesChanged();
+
 	PathNode *a = nullptr;
 	PathNode *b = nullptr;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
@@ -1909,6 +2438,8 @@ void PathManager::DisconnectNodeToNode(Client *c, int32 Node2)
 
 void PathManager::DisconnectNodeToNode(int32 Node1, int32 Node2)
 {
+	PathNodesChanged();
+
 	PathNode *a = nullptr;
 	PathNode *b = nullptr;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
@@ -1971,6 +2502,8 @@ void PathManager::DisconnectNodeToNode(int32 Node1, int32 Node2)
 
 void PathManager::MoveNode(Client *c)
 {
+	PathNodesChanged();
+
 	if(!c)
 	{
 		return;
@@ -2005,6 +2538,8 @@ void PathManager::MoveNode(Client *c)
 
 void PathManager::DisconnectAll(Client *c)
 {
+	PathNodesChanged();
+
 	if(!c)
 	{
 		return;
@@ -2134,6 +2669,8 @@ void PathManager::ProcessNodesAndSave(std::string filename)
 
 void PathManager::ResortConnections()
 {
+	PathNodesChanged();
+
 	NeighbourNode Neigh[PATHNODENEIGHBOURS];
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
 	{
@@ -2217,6 +2754,8 @@ struct InternalPathSort
 
 void PathManager::SortNodes()
 {
+	PathNodesChanged();
+
 	std::vector<InternalPathSort> sorted_vals;
 	for(uint32 x = 0; x < Head.PathNodeCount; ++x)
 	{
@@ -4,11 +4,15 @@
 #include "map.h"
 
 #include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 class Client;
 class Mob;
 
 #define PATHNODENEIGHBOURS 50
+#define PATHNODE_GRID_CELL_SIZE 100.0f
 
 #pragma pack(1)
 
@@ -42,6 +46,12 @@ struct PathFileHeader {
 
 #pragma pack()
 
+struct RouteCacheEntry
+{
+	uint64 Key;
+	std::deque<int> Route;
+};
+
 struct PathNodeSortStruct
 {
 	int id;
@@ -68,7 +78,15 @@ public:
 	void SpawnPathNodes();
 	void MeshTest();
 	void SimpleMeshTest();
+	void RouteBenchmark(Client *c, uint32 MaxRoutes = 0);
+	void InvalidateRoutes();
+	static uint32 GetNextHopMaxNodes();
+	bool BuildNextHopTable();
+	bool SaveNextHopTable();
+	bool LoadNextHopTable(FILE *fp);
+	bool HasNextHopTable() const { return !NextHop.empty(); }
 	int FindNearestPathNode(glm::vec3 Position);
+	void NearestNodeBenchmark(Client *c, uint32 Lookups);
 	bool NoHazards(glm::vec3 From, glm::vec3 To);
 	bool NoHazardsAccurate(glm::vec3 From, glm::vec3 To);
 	void OpenDoors(int Node1, int Node2, Mob* ForWho);
@@ -97,11 +115,56 @@ public:
 	void SortNodes();
 
 private:
+	enum { NextHopNodeLimit = 32767 }; // largest node id an int16 next hop entry can hold
+
 	PathFileHeader Head;
 	PathNode *PathNodes;
 	int QuickConnectTarget;
-
-	int *ClosedListFlag;
+	std::string FileBaseName; // lower case map name the .path file was loaded for
+
+	// A* scratch space, one entry per path node. A node's entry is only valid when its
+	// SearchGeneration matches CurrentSearch, so nothing needs clearing between searches.
+	std::vector<AStarNode> SearchNodes;
+	std::vector<uint32> SearchGeneration;
+	std::vector<int> OpenHeapIndex; // position in OpenHeap, -1 once the node is closed
+	std::vector<int> OpenHeap;
+	uint32 CurrentSearch;
+
+	void ResetSearchState();
+	float OpenCost(int NodeID) const { return SearchNodes[NodeID].GCost + SearchNodes[NodeID].HCost; }
+	void OpenHeapPush(int NodeID);
+	int OpenHeapPop();
+	void OpenHeapSiftUp(int Position);
+	void OpenHeapSiftDown(int Position);
+
+	void PathNodesChanged();
+	void BuildNodeIndex();
+	int FindNearestNodeWithLOS(glm::vec3 Position, float RangeXY, float RangeZ);
+	int FindNearestNodeBySort(glm::vec3 Position, float RangeXY, float RangeZ);
+
+	// Uniform XY grid over the path nodes, the ids of the nodes in cell c are
+	// NodeGridNodes[NodeGridStart[c]] up to NodeGridNodes[NodeGridStart[c + 1]].
+	bool NodeIndexDirty;
+	float NodeGridMinX;
+	float NodeGridMinY;
+	int NodeGridColumns;
+	int NodeGridRows;
+	std::vector<int> NodeGridStart;
+	std::vector<int> NodeGridNodes;
+
+	std::deque<int> SearchRoute(int startID, int endID);
+	std::deque<int> NextHopRoute(int startID, int endID);
+	uint32 PathGraphChecksum();
+
+	// Most recently used routes first, keyed on (startID << 32) | endID. Failed searches are cached too.
+	std::list<RouteCacheEntry> RouteCache;
+	std::unordered_map<uint64, std::list<RouteCacheEntry>::iterator> RouteCacheIndex;
+	uint32 RouteCacheHits;
+	uint32 RouteCacheMisses;
+
+	// Optional precomputed shortest path table, NextHop[startID * PathNodeCount + endID] is the
+	// node to move to next from startID, -1 when endID can't be reached.
+	std::vector<int16> NextHop;
 };
 
 
@@ -111,6 +111,30 @@ XS(XS_HateEntry_GetDamage)
 	XSRETURN(1);
 }
 
+XS(XS_HateEntry_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS(XS_HateEntry_DESTROY)
+{
+	dXSARGS;
+	if (items != 1)
+		Perl_croak(aTHX_ "Usage: HateEntry::DESTROY(THIS)");
+	{
+		struct_HateList * THIS;
+
+		if (SvROK(ST(0))) {
+			IV tmp = SvIV((SV*)SvRV(ST(0)));
+			THIS = INT2PTR(struct_HateList *,tmp);
+		}
+		else
+			Perl_croak(aTHX_ "THIS is not a reference");
+		if(THIS == nullptr)
+			Perl_croak(aTHX_ "THIS is nullptr, avoiding crash.");
+
+		// Mob::GetHateList hands out copies
+		delete THIS;
+	}
+	XSRETURN_EMPTY;
+}
+
 #ifdef __cplusplus
 extern "C"
 #endif
@@ -131,6 +155,7 @@ XS(boot_HateEntry)
 
 	XS_VERSION_BOOTCHECK ;
 
+		newXSproto(strcpy(buf, "DESTROY"), XS_HateEntry_DESTROY, file, "$");
 		newXSproto(strcpy(buf, "GetEnt"), XS_HateEntry_GetEnt, file, "$");
 		newXSproto(strcpy(buf, "GetDamage"), XS_HateEntry_GetDamage, file, "$");
 		newXSproto(strcpy(buf, "GetHate"), XS_HateEntry_GetHate, file, "$");
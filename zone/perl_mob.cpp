@@ -6620,12 +6620,13 @@ XS(XS_Mob_GetHateList)
 		if(THIS == nullptr)
 			Perl_croak(aTHX_ "THIS is nullptr, avoiding crash.");
 
-		auto hate_list = THIS->GetHateList();
+		// entries move as the hate list changes, so each HateEntry gets its own copy
+		auto &hate_list = THIS->GetHateList().GetEntries();
 		auto iter = hate_list.begin();
 
 		while(iter != hate_list.end())
 		{
-			struct_HateList *entry = (*iter);
+			struct_HateList *entry = new struct_HateList(*iter);
 			ST(0) = sv_newmortal();
 			sv_setref_pv(ST(0), "HateEntry", (void*)entry);
 			XPUSHs(ST(0));
@@ -29,22 +29,27 @@ void QGlobalCache::RemoveGlobal(std::string name, uint32 npcID, uint32 charID, u
 	}
 }
 
-void QGlobalCache::Combine(std::list<QGlobal> &cacheA, std::list<QGlobal> cacheB, uint32 npcID, uint32 charID, uint32 zoneID)
+static inline bool QGlobalMatches(const QGlobal &cur, uint32 npcID, uint32 charID, uint32 zoneID)
 {
-	std::list<QGlobal>::iterator iter = cacheB.begin();
-	while(iter != cacheB.end())
+	return (cur.npc_id == npcID || cur.npc_id == 0) && (cur.char_id == charID || cur.char_id == 0) &&
+		(cur.zone_id == zoneID || cur.zone_id == 0) && Timer::GetTimeSeconds() < cur.expdate;
+}
+
+void QGlobalCache::Combine(std::list<QGlobal> &cacheA, const std::list<QGlobal> &cacheB, uint32 npcID, uint32 charID, uint32 zoneID)
+{
+	for(auto iter = cacheB.begin(); iter != cacheB.end(); ++iter)
 	{
-		QGlobal cur = (*iter);
+		if(QGlobalMatches(*iter, npcID, charID, zoneID))
+			cacheA.push_back(*iter);
+	}
+}
 
-		if((cur.npc_id == npcID || cur.npc_id == 0) && (cur.char_id == charID || cur.char_id == 0) &&
-			(cur.zone_id == zoneID || cur.zone_id == 0))
-		{
-			if(Timer::GetTimeSeconds() < cur.expdate)
-			{
-				cacheA.push_back(cur);
-			}
-		}
-		++iter;
+void QGlobalCache::Combine(std::vector<const QGlobal*> &view, const std::list<QGlobal> &cacheB, uint32 npcID, uint32 charID, uint32 zoneID)
+{
+	for(auto iter = cacheB.begin(); iter != cacheB.end(); ++iter)
+	{
+		if(QGlobalMatches(*iter, npcID, charID, zoneID))
+			view.push_back(&(*iter));
 	}
 }
 
@@ -126,8 +131,7 @@ void QGlobalCache::PurgeExpiredGlobals()
 	std::list<QGlobal>::iterator iter = qGlobalBucket.begin();
 	while(iter != qGlobalBucket.end())
 	{
-		QGlobal cur = (*iter);
-		if(Timer::GetTimeSeconds() > cur.expdate)
+		if(Timer::GetTimeSeconds() > iter->expdate)
 		{
 			iter = qGlobalBucket.erase(iter);
 			continue;
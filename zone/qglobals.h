@@ -2,6 +2,7 @@
 #define __QGLOBALS__H
 
 #include <list>
+#include <vector>
 
 class NPC;
 class Client;
@@ -26,10 +27,12 @@ class QGlobalCache
 public:
 	void AddGlobal(uint32 id, QGlobal global);
 	void RemoveGlobal(std::string name, uint32 npcID, uint32 charID, uint32 zoneID);
-	std::list<QGlobal> GetBucket() { return qGlobalBucket; }
+	const std::list<QGlobal> &GetBucket() const { return qGlobalBucket; }
 
 	//assumes cacheA is already a valid or empty list and doesn't check for valid items.
-	static void Combine(std::list<QGlobal> &cacheA, std::list<QGlobal> cacheB, uint32 npcID, uint32 charID, uint32 zoneID);
+	static void Combine(std::list<QGlobal> &cacheA, const std::list<QGlobal> &cacheB, uint32 npcID, uint32 charID, uint32 zoneID);
+	//same as above without copying, the view points into cacheB and is only good until cacheB changes.
+	static void Combine(std::vector<const QGlobal*> &view, const std::list<QGlobal> &cacheB, uint32 npcID, uint32 charID, uint32 zoneID);
 	static void GetQGlobals(std::list<QGlobal> &globals, NPC *n, Client *c, Zone *z);
 	static bool GetQGlobal(QGlobal &g, std::string name, NPC *n, Client *c, Zone *z);
 
@@ -19,6 +19,8 @@
 #include "../common/global_define.h"
 #include "../common/misc_functions.h"
 #include "../common/features.h"
+#include "../common/scope_profiler.h"
+#include "../common/string_util.h"
 
 #include "quest_parser_collection.h"
 #include "quest_interface.h"
@@ -235,8 +237,33 @@ bool QuestParserCollection::ItemHasQuestSub(ItemInst *itm, QuestEventID evt) {
 	return false;
 }
 
+extern EQEmu::ScopeProfiler zone_profiler;
+#ifdef EMBPERL
+extern const char *QuestEventSubroutines[_LargestEventID];
+#endif
+
+// kind is the quest type ("npc", "player", ...), each one gets its own family of scopes
+static uint32 QuestEventScope(uint32 &family, const char *kind, QuestEventID evt) {
+	if(!zone_profiler.IsEnabled())
+		return EQEmu::ScopeProfiler::NoScope;
+
+	if(family == EQEmu::ScopeProfiler::NoScope)
+		family = zone_profiler.AddFamily();
+
+	return zone_profiler.GetScope(family, evt, [kind](uint32 key) {
+#ifdef EMBPERL
+		if(key < _LargestEventID)
+			return StringFormat("quest %s %s", kind, QuestEventSubroutines[key]);
+#endif
+		return StringFormat("quest %s event %u", kind, key);
+	});
+}
+
 int QuestParserCollection::EventNPC(QuestEventID evt, NPC *npc, Mob *init, std::string data, uint32 extra_data,
 									std::vector<EQEmu::Any> *extra_pointers) {
+	static uint32 family = EQEmu::ScopeProfiler::NoScope;
+	EQEmu::ScopeProfiler::Timer profile_timer(zone_profiler, QuestEventScope(family, "npc", evt));
+
 	int rd = DispatchEventNPC(evt, npc, init, data, extra_data, extra_pointers);
 	int rl = EventNPCLocal(evt, npc, init, data, extra_data, extra_pointers);
 	int rg = EventNPCGlobal(evt, npc, init, data, extra_data, extra_pointers);
@@ -297,6 +324,9 @@ int QuestParserCollection::EventNPCGlobal(QuestEventID evt, NPC* npc, Mob *init,
 
 int QuestParserCollection::EventPlayer(QuestEventID evt, Client *client, std::string data, uint32 extra_data,
 									   std::vector<EQEmu::Any> *extra_pointers) {
+	static uint32 family = EQEmu::ScopeProfiler::NoScope;
+	EQEmu::ScopeProfiler::Timer profile_timer(zone_profiler, QuestEventScope(family, "player", evt));
+
 	int rd = DispatchEventPlayer(evt, client, data, extra_data, extra_pointers);
 	int rl = EventPlayerLocal(evt, client, data, extra_data, extra_pointers);
 	int rg = EventPlayerGlobal(evt, client, data, extra_data, extra_pointers);
@@ -353,6 +383,9 @@ int QuestParserCollection::EventPlayerGlobal(QuestEventID evt, Client *client, s
 
 int QuestParserCollection::EventItem(QuestEventID evt, Client *client, ItemInst *item, Mob *mob, std::string data, uint32 extra_data,
 									 std::vector<EQEmu::Any> *extra_pointers) {
+	static uint32 family = EQEmu::ScopeProfiler::NoScope;
+	EQEmu::ScopeProfiler::Timer profile_timer(zone_profiler, QuestEventScope(family, "item", evt));
+
 	// needs pointer validation check on 'item' argument
 	
 	std::string item_script;
@@ -401,6 +434,9 @@ int QuestParserCollection::EventItem(QuestEventID evt, Client *client, ItemInst
 
 int QuestParserCollection::EventSpell(QuestEventID evt, NPC* npc, Client *client, uint32 spell_id, uint32 extra_data,
 									  std::vector<EQEmu::Any> *extra_pointers) {
+	static uint32 family = EQEmu::ScopeProfiler::NoScope;
+	EQEmu::ScopeProfiler::Timer profile_timer(zone_profiler, QuestEventScope(family, "spell", evt));
+
 	std::map<uint32, uint32>::iterator iter = _spell_quest_status.find(spell_id);
 	if(iter != _spell_quest_status.end()) {
 		//loaded or failed to load
@@ -436,6 +472,9 @@ int QuestParserCollection::EventSpell(QuestEventID evt, NPC* npc, Client *client
 
 int QuestParserCollection::EventEncounter(QuestEventID evt, std::string encounter_name, uint32 extra_data,
 										  std::vector<EQEmu::Any> *extra_pointers) {
+	static uint32 family = EQEmu::ScopeProfiler::NoScope;
+	EQEmu::ScopeProfiler::Timer profile_timer(zone_profiler, QuestEventScope(family, "encounter", evt));
+
 	auto iter = _encounter_quest_status.find(encounter_name);
 	if(iter != _encounter_quest_status.end()) {
 		//loaded or failed to load
@@ -6,6 +6,11 @@
 #include <string.h>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAYCAST_MESH_SSE2
+#include <emmintrin.h>
+#endif
+
 // This code snippet allows you to create an axis aligned bounding volume tree for a triangle mesh so that you can do
 // high-speed raycasting.
 //
@@ -643,98 +648,46 @@ public:
 			}
 		}
 
-
-		virtual void raycast(bool &hit,
-							const RmReal *from,
-							const RmReal *to,
-							const RmReal *dir,
-							RmReal *hitLocation,
-							RmReal *hitNormal,
-							RmReal *hitDistance,
-							const RmReal *vertices,
-							const RmUint32 *indices,
-							RmReal &nearestDistance,
-							NodeInterface *callback,
-							RmUint32 *raycastTriangles,
-							RmUint32 raycastFrame,
-							const TriVector &leafTriangles,
-							RmUint32 &nearestTriIndex)
-		{
-			RmReal sect[3];
-			RmReal nd = nearestDistance;
-			if ( !intersectLineSegmentAABB(mBounds.mMin,mBounds.mMax,from,dir,nd,sect) )
-			{
-				return;	
-			}
-			if ( mLeafTriangleIndex != TRI_EOF )
-			{
-				const RmUint32 *scan = &leafTriangles[mLeafTriangleIndex];
-				RmUint32 count = *scan++;
-				for (RmUint32 i=0; i<count; i++)
-				{
-					RmUint32 tri = *scan++;
-					if ( raycastTriangles[tri] != raycastFrame )
-					{
-						raycastTriangles[tri] = raycastFrame;
-						RmUint32 i1 = indices[tri*3+0];
-						RmUint32 i2 = indices[tri*3+1];
-						RmUint32 i3 = indices[tri*3+2];
-
-						const RmReal *p1 = &vertices[i1*3];
-						const RmReal *p2 = &vertices[i2*3];
-						const RmReal *p3 = &vertices[i3*3];
-
-						RmReal t;
-						if ( rayIntersectsTriangle(from,dir,p1,p2,p3,t))
-						{
-							bool accept = false;
-							if ( t == nearestDistance && tri < nearestTriIndex )
-							{
-								accept = true;
-							}
-							if ( t < nearestDistance || accept )
-							{
-								nearestDistance = t;
-								if ( hitLocation )
-								{
-									hitLocation[0] = from[0]+dir[0]*t;
-									hitLocation[1] = from[1]+dir[1]*t;
-									hitLocation[2] = from[2]+dir[2]*t;
-								}
-								if ( hitNormal )
-								{
-									callback->getFaceNormal(tri,hitNormal);
-								}
-								if ( hitDistance )
-								{
-									*hitDistance = t;
-								}
-								nearestTriIndex = tri;
-								hit = true;
-							}
-						}
-					}
-				}
-			}
-			else
-			{
-				if ( mLeft )
-				{
-					mLeft->raycast(hit,from,to,dir,hitLocation,hitNormal,hitDistance,vertices,indices,nearestDistance,callback,raycastTriangles,raycastFrame,leafTriangles,nearestTriIndex);
-				}
-				if ( mRight )
-				{
-					mRight->raycast(hit,from,to,dir,hitLocation,hitNormal,hitDistance,vertices,indices,nearestDistance,callback,raycastTriangles,raycastFrame,leafTriangles,nearestTriIndex);
-				}
-			}
-		}
-
 		NodeAABB		*mLeft;			// left node
 		NodeAABB		*mRight;		// right node
 		BoundsAABB		mBounds;		// bounding volume of node
 		RmUint32		mLeafTriangleIndex;	// if it is a leaf node; then these are the triangle indices.
 	};
 
+// Once built the tree is copied into a flat array in depth first order so traversal walks
+// contiguous memory instead of chasing node pointers.  Children are referenced by index.
+struct FlatNodeAABB
+{
+	RmReal			mMin[3];
+	RmReal			mMax[3];
+	RmUint32		mLeft;				// index of the left child or TRI_EOF
+	RmUint32		mRight;				// index of the right child or TRI_EOF
+	RmUint32		mLeafTriangleIndex;	// offset into the leaf triangle list or TRI_EOF
+};
+
+typedef std::vector< FlatNodeAABB > FlatNodeVector;
+
+// Layout written by serialize: this header followed by the vertices, the triangle indices,
+// the flattened nodes and the leaf triangle lists, each packed one after the other.
+#define RAYCAST_MESH_SERIALIZE_VERSION 1
+
+struct SerializedMeshHeader
+{
+	RmUint32		mVersion;
+	RmUint32		mVcount;
+	RmUint32		mTcount;
+	RmUint32		mNodeCount;
+	RmUint32		mLeafCount;
+	RmUint32		mReserved[3];
+};
+
+// a node at depth d (the root is 1) leaves at most d+1 entries on the traversal stack. built
+// trees are capped at depth 15, loadRaycastMesh rejects serialized trees too deep for the stack
+#define RAYCAST_STACK_SIZE 64
+
+// number of rays traced together by raycastBatch
+#define RAYCAST_PACKET_SIZE 4
+
 class MyRaycastMesh : public RaycastMesh, public NodeInterface
 {
 public:
@@ -769,13 +722,73 @@ public:
 		mRoot = getNode();
 		mFaceNormals = NULL;
 		new ( mRoot ) NodeAABB(mVcount,mVertices,mTcount,mIndices,maxDepth,minLeafSize,minAxisSize,this,mLeafTriangles);
+
+		// the pointer tree is only needed while building
+		mFlatNodes.reserve(mNodeCount);
+		flatten(mRoot);
+		delete []mNodes;
+		mNodes = NULL;
+		mRoot = NULL;
+
+		mNodeArray = &mFlatNodes[0];
+		mNodeArrayCount = (RmUint32)mFlatNodes.size();
+		mLeafArray = mLeafTriangles.empty() ? NULL : &mLeafTriangles[0];
+		mLeafArrayCount = (RmUint32)mLeafTriangles.size();
+		mOwnsData = true;
+	}
+
+	// Wraps a mesh written by serialize without copying it; the caller keeps the data alive.
+	MyRaycastMesh(const SerializedMeshHeader *header)
+	{
+		const char *data = (const char *)(header+1);
+		mRaycastFrame = 0;
+		mVcount = header->mVcount;
+		mTcount = header->mTcount;
+		mVertices = (RmReal *)data;
+		data+=sizeof(RmReal)*3*mVcount;
+		mIndices = (RmUint32 *)data;
+		data+=sizeof(RmUint32)*3*mTcount;
+		mNodeArray = (const FlatNodeAABB *)data;
+		mNodeArrayCount = header->mNodeCount;
+		data+=sizeof(FlatNodeAABB)*mNodeArrayCount;
+		mLeafArray = (const RmUint32 *)data;
+		mLeafArrayCount = header->mLeafCount;
+		mOwnsData = false;
+
+		mRaycastTriangles = (RmUint32 *)::malloc(mTcount*sizeof(RmUint32));
+		memset(mRaycastTriangles,0,mTcount*sizeof(RmUint32));
+		mFaceNormals = NULL;
+		mRoot = NULL;
+		mNodes = NULL;
+		mNodeCount = 0;
+		mMaxNodeCount = 0;
+	}
+
+	RmUint32 flatten(const NodeAABB *node)
+	{
+		RmUint32 index = (RmUint32)mFlatNodes.size();
+		mFlatNodes.push_back(FlatNodeAABB());
+
+		RmUint32 left = node->mLeft ? flatten(node->mLeft) : TRI_EOF;
+		RmUint32 right = node->mRight ? flatten(node->mRight) : TRI_EOF;
+
+		FlatNodeAABB &flat = mFlatNodes[index];
+		memcpy(flat.mMin,node->mBounds.mMin,sizeof(flat.mMin));
+		memcpy(flat.mMax,node->mBounds.mMax,sizeof(flat.mMax));
+		flat.mLeft = left;
+		flat.mRight = right;
+		flat.mLeafTriangleIndex = node->mLeafTriangleIndex;
+		return index;
 	}
 
 	~MyRaycastMesh(void)
 	{
 		delete []mNodes;
-		::free(mVertices);
-		::free(mIndices);
+		if ( mOwnsData )
+		{
+			::free(mVertices);
+			::free(mIndices);
+		}
 		::free(mFaceNormals);
 		::free(mRaycastTriangles);
 	}
@@ -796,10 +809,336 @@ public:
 		dir[2]*=recipDistance;
 		mRaycastFrame++;
 		RmUint32 nearestTriIndex=TRI_EOF;
-		mRoot->raycast(ret,from,to,dir,hitLocation,hitNormal,hitDistance,mVertices,mIndices,distance,this,mRaycastTriangles,mRaycastFrame,mLeafTriangles,nearestTriIndex);
+
+		// walks the flattened tree in the same order the recursive walk did; the right child is
+		// pushed first so the whole left subtree is visited before it.
+		RmUint32 stack[RAYCAST_STACK_SIZE];
+		RmUint32 stackCount = 0;
+		stack[stackCount++] = 0;
+		while ( stackCount )
+		{
+			const FlatNodeAABB &node = mNodeArray[stack[--stackCount]];
+			RmReal sect[3];
+			RmReal nd = distance;
+			if ( !intersectLineSegmentAABB(node.mMin,node.mMax,from,dir,nd,sect) )
+			{
+				continue;
+			}
+			if ( node.mLeafTriangleIndex != TRI_EOF )
+			{
+				const RmUint32 *scan = &mLeafArray[node.mLeafTriangleIndex];
+				RmUint32 count = *scan++;
+				for (RmUint32 i=0; i<count; i++)
+				{
+					RmUint32 tri = *scan++;
+					if ( mRaycastTriangles[tri] != mRaycastFrame )
+					{
+						mRaycastTriangles[tri] = mRaycastFrame;
+						const RmReal *p1 = &mVertices[mIndices[tri*3+0]*3];
+						const RmReal *p2 = &mVertices[mIndices[tri*3+1]*3];
+						const RmReal *p3 = &mVertices[mIndices[tri*3+2]*3];
+
+						RmReal t;
+						if ( rayIntersectsTriangle(from,dir,p1,p2,p3,t))
+						{
+							bool accept = false;
+							if ( t == distance && tri < nearestTriIndex )
+							{
+								accept = true;
+							}
+							if ( t < distance || accept )
+							{
+								distance = t;
+								if ( hitLocation )
+								{
+									hitLocation[0] = from[0]+dir[0]*t;
+									hitLocation[1] = from[1]+dir[1]*t;
+									hitLocation[2] = from[2]+dir[2]*t;
+								}
+								if ( hitNormal )
+								{
+									getFaceNormal(tri,hitNormal);
+								}
+								if ( hitDistance )
+								{
+									*hitDistance = t;
+								}
+								nearestTriIndex = tri;
+								ret = true;
+							}
+						}
+					}
+				}
+			}
+			else
+			{
+				assert( stackCount + 2 <= RAYCAST_STACK_SIZE );
+				if ( node.mRight != TRI_EOF )
+				{
+					stack[stackCount++] = node.mRight;
+				}
+				if ( node.mLeft != TRI_EOF )
+				{
+					stack[stackCount++] = node.mLeft;
+				}
+			}
+		}
 		return ret;
 	}
 
+	virtual void raycastBatch(RmUint32 count,const RmReal *from,const RmReal *to,bool *hit,RmReal *hitLocation,RmReal *hitDistance)
+	{
+#ifdef RAYCAST_MESH_SSE2
+		for (RmUint32 i=0; i<count; i+=RAYCAST_PACKET_SIZE)
+		{
+			RmUint32 packetCount = count - i;
+			if ( packetCount > RAYCAST_PACKET_SIZE )
+			{
+				packetCount = RAYCAST_PACKET_SIZE;
+			}
+			raycastPacket(packetCount,&from[i*3],&to[i*3],&hit[i],hitLocation ? &hitLocation[i*3] : NULL,hitDistance ? &hitDistance[i] : NULL);
+		}
+#else
+		for (RmUint32 i=0; i<count; i++)
+		{
+			hit[i] = raycast(&from[i*3],&to[i*3],hitLocation ? &hitLocation[i*3] : NULL,NULL,hitDistance ? &hitDistance[i] : NULL);
+		}
+#endif
+	}
+
+#ifdef RAYCAST_MESH_SSE2
+	// Traces up to four rays through the tree together, one ray per SSE lane.  A node is
+	// descended while any lane still overlaps it and triangles are tested against all four
+	// lanes at once.  Boxes are grown slightly so a lane is never culled where the scalar
+	// test would have accepted it; the triangle test is the same one raycast uses.
+	void raycastPacket(RmUint32 count,const RmReal *from,const RmReal *to,bool *hit,RmReal *hitLocation,RmReal *hitDistance)
+	{
+		RmReal origin[3][RAYCAST_PACKET_SIZE];
+		RmReal dir[3][RAYCAST_PACKET_SIZE];
+		RmReal invDir[3][RAYCAST_PACKET_SIZE];
+		RmReal maxDistance[RAYCAST_PACKET_SIZE];
+		int activeBits = 0;
+
+		for (RmUint32 i=0; i<RAYCAST_PACKET_SIZE; i++)
+		{
+			maxDistance[i] = 0;
+			for (RmUint32 k=0; k<3; k++)
+			{
+				origin[k][i] = 0;
+				dir[k][i] = 0;
+			}
+			if ( i < count )
+			{
+				hit[i] = false;
+				RmReal d[3];
+				d[0] = to[i*3+0] - from[i*3+0];
+				d[1] = to[i*3+1] - from[i*3+1];
+				d[2] = to[i*3+2] - from[i*3+2];
+				RmReal distance = sqrtf( d[0]*d[0] + d[1]*d[1]+d[2]*d[2] );
+				if ( distance >= 0.0000000001f )
+				{
+					RmReal recipDistance = 1.0f / distance;
+					for (RmUint32 k=0; k<3; k++)
+					{
+						origin[k][i] = from[i*3+k];
+						dir[k][i] = d[k]*recipDistance;
+					}
+					maxDistance[i] = distance;
+					activeBits |= 1<<i;
+				}
+			}
+			for (RmUint32 k=0; k<3; k++)
+			{
+				// keep the reciprocal finite so the slab test never multiplies zero by infinity
+				RmReal dk = dir[k][i];
+				if ( fabsf(dk) < 1e-30f )
+				{
+					dk = dk < 0 ? -1e-30f : 1e-30f;
+				}
+				invDir[k][i] = 1.0f / dk;
+			}
+		}
+
+		if ( activeBits == 0 )
+		{
+			return;
+		}
+
+		const __m128 ox = _mm_loadu_ps(origin[0]);
+		const __m128 oy = _mm_loadu_ps(origin[1]);
+		const __m128 oz = _mm_loadu_ps(origin[2]);
+		const __m128 dx = _mm_loadu_ps(dir[0]);
+		const __m128 dy = _mm_loadu_ps(dir[1]);
+		const __m128 dz = _mm_loadu_ps(dir[2]);
+		const __m128 ix = _mm_loadu_ps(invDir[0]);
+		const __m128 iy = _mm_loadu_ps(invDir[1]);
+		const __m128 iz = _mm_loadu_ps(invDir[2]);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 eps = _mm_set1_ps(0.00001f);
+		const __m128 negEps = _mm_set1_ps(-0.00001f);
+		const __m128 boxEps = _mm_set1_ps(0.01f);
+		const __m128 active = _mm_castsi128_ps(_mm_setr_epi32(activeBits & 1 ? -1 : 0,activeBits & 2 ? -1 : 0,activeBits & 4 ? -1 : 0,activeBits & 8 ? -1 : 0));
+		__m128 nearest = _mm_loadu_ps(maxDistance);
+		__m128 hitMask = zero;
+
+		RmUint32 stack[RAYCAST_STACK_SIZE];
+		RmUint32 stackCount = 0;
+		stack[stackCount++] = 0;
+		while ( stackCount )
+		{
+			const FlatNodeAABB &node = mNodeArray[stack[--stackCount]];
+
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(node.mMin[0]),boxEps),ox),ix);
+			__m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_set1_ps(node.mMax[0]),boxEps),ox),ix);
+			__m128 tnear = _mm_min_ps(t1,t2);
+			__m128 tfar = _mm_max_ps(t1,t2);
+			t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(node.mMin[1]),boxEps),oy),iy);
+			t2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_set1_ps(node.mMax[1]),boxEps),oy),iy);
+			tnear = _mm_max_ps(tnear,_mm_min_ps(t1,t2));
+			tfar = _mm_min_ps(tfar,_mm_max_ps(t1,t2));
+			t1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(node.mMin[2]),boxEps),oz),iz);
+			t2 = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_set1_ps(node.mMax[2]),boxEps),oz),iz);
+			tnear = _mm_max_ps(tnear,_mm_min_ps(t1,t2));
+			tfar = _mm_min_ps(tfar,_mm_max_ps(t1,t2));
+
+			__m128 boxMask = _mm_and_ps(_mm_cmple_ps(tnear,tfar),_mm_cmpge_ps(tfar,zero));
+			boxMask = _mm_and_ps(boxMask,_mm_cmple_ps(tnear,nearest));
+			boxMask = _mm_and_ps(boxMask,active);
+			if ( _mm_movemask_ps(boxMask) == 0 )
+			{
+				continue;
+			}
+
+			if ( node.mLeafTriangleIndex != TRI_EOF )
+			{
+				const RmUint32 *scan = &mLeafArray[node.mLeafTriangleIndex];
+				RmUint32 triCount = *scan++;
+				for (RmUint32 i=0; i<triCount; i++)
+				{
+					RmUint32 tri = *scan++;
+					const RmReal *v0 = &mVertices[mIndices[tri*3+0]*3];
+					const RmReal *v1 = &mVertices[mIndices[tri*3+1]*3];
+					const RmReal *v2 = &mVertices[mIndices[tri*3+2]*3];
+
+					const __m128 e1x = _mm_set1_ps(v1[0]-v0[0]);
+					const __m128 e1y = _mm_set1_ps(v1[1]-v0[1]);
+					const __m128 e1z = _mm_set1_ps(v1[2]-v0[2]);
+					const __m128 e2x = _mm_set1_ps(v2[0]-v0[0]);
+					const __m128 e2y = _mm_set1_ps(v2[1]-v0[1]);
+					const __m128 e2z = _mm_set1_ps(v2[2]-v0[2]);
+
+					// h = dir x e2, a = e1 . h
+					__m128 hx = _mm_sub_ps(_mm_mul_ps(dy,e2z),_mm_mul_ps(e2y,dz));
+					__m128 hy = _mm_sub_ps(_mm_mul_ps(dz,e2x),_mm_mul_ps(e2z,dx));
+					__m128 hz = _mm_sub_ps(_mm_mul_ps(dx,e2y),_mm_mul_ps(e2x,dy));
+					__m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x,hx),_mm_mul_ps(e1y,hy)),_mm_mul_ps(e1z,hz));
+					__m128 valid = _mm_and_ps(boxMask,_mm_or_ps(_mm_cmple_ps(a,negEps),_mm_cmpge_ps(a,eps)));
+					if ( _mm_movemask_ps(valid) == 0 )
+					{
+						continue;
+					}
+
+					__m128 f = _mm_div_ps(one,a);
+					__m128 sx = _mm_sub_ps(ox,_mm_set1_ps(v0[0]));
+					__m128 sy = _mm_sub_ps(oy,_mm_set1_ps(v0[1]));
+					__m128 sz = _mm_sub_ps(oz,_mm_set1_ps(v0[2]));
+					__m128 u = _mm_mul_ps(f,_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx,hx),_mm_mul_ps(sy,hy)),_mm_mul_ps(sz,hz)));
+					valid = _mm_and_ps(valid,_mm_and_ps(_mm_cmpge_ps(u,zero),_mm_cmple_ps(u,one)));
+					if ( _mm_movemask_ps(valid) == 0 )
+					{
+						continue;
+					}
+
+					// q = s x e1
+					__m128 qx = _mm_sub_ps(_mm_mul_ps(sy,e1z),_mm_mul_ps(e1y,sz));
+					__m128 qy = _mm_sub_ps(_mm_mul_ps(sz,e1x),_mm_mul_ps(e1z,sx));
+					__m128 qz = _mm_sub_ps(_mm_mul_ps(sx,e1y),_mm_mul_ps(e1x,sy));
+					__m128 v = _mm_mul_ps(f,_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx,qx),_mm_mul_ps(dy,qy)),_mm_mul_ps(dz,qz)));
+					valid = _mm_and_ps(valid,_mm_and_ps(_mm_cmpge_ps(v,zero),_mm_cmple_ps(_mm_add_ps(u,v),one)));
+
+					__m128 t = _mm_mul_ps(f,_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x,qx),_mm_mul_ps(e2y,qy)),_mm_mul_ps(e2z,qz)));
+					valid = _mm_and_ps(valid,_mm_and_ps(_mm_cmpgt_ps(t,zero),_mm_cmplt_ps(t,nearest)));
+					if ( _mm_movemask_ps(valid) == 0 )
+					{
+						continue;
+					}
+
+					nearest = _mm_or_ps(_mm_and_ps(valid,t),_mm_andnot_ps(valid,nearest));
+					hitMask = _mm_or_ps(hitMask,valid);
+				}
+			}
+			else
+			{
+				assert( stackCount + 2 <= RAYCAST_STACK_SIZE );
+				if ( node.mRight != TRI_EOF )
+				{
+					stack[stackCount++] = node.mRight;
+				}
+				if ( node.mLeft != TRI_EOF )
+				{
+					stack[stackCount++] = node.mLeft;
+				}
+			}
+		}
+
+		int hitBits = _mm_movemask_ps(hitMask);
+		RmReal distances[RAYCAST_PACKET_SIZE];
+		_mm_storeu_ps(distances,nearest);
+		for (RmUint32 i=0; i<count; i++)
+		{
+			if ( !(hitBits & (1<<i)) )
+			{
+				continue;
+			}
+			RmReal t = distances[i];
+			hit[i] = true;
+			if ( hitLocation )
+			{
+				hitLocation[i*3+0] = origin[0][i]+dir[0][i]*t;
+				hitLocation[i*3+1] = origin[1][i]+dir[1][i]*t;
+				hitLocation[i*3+2] = origin[2][i]+dir[2][i]*t;
+			}
+			if ( hitDistance )
+			{
+				hitDistance[i] = t;
+			}
+		}
+	}
+#endif
+
+	virtual RmUint32 getSerializedSize(void) const
+	{
+		return sizeof(SerializedMeshHeader)+
+			sizeof(RmReal)*3*mVcount+
+			sizeof(RmUint32)*3*mTcount+
+			sizeof(FlatNodeAABB)*mNodeArrayCount+
+			sizeof(RmUint32)*mLeafArrayCount;
+	}
+
+	virtual void serialize(void *dest) const
+	{
+		SerializedMeshHeader *header = (SerializedMeshHeader *)dest;
+		memset(header,0,sizeof(SerializedMeshHeader));
+		header->mVersion = RAYCAST_MESH_SERIALIZE_VERSION;
+		header->mVcount = mVcount;
+		header->mTcount = mTcount;
+		header->mNodeCount = mNodeArrayCount;
+		header->mLeafCount = mLeafArrayCount;
+
+		char *data = (char *)(header+1);
+		memcpy(data,mVertices,sizeof(RmReal)*3*mVcount);
+		data+=sizeof(RmReal)*3*mVcount;
+		memcpy(data,mIndices,sizeof(RmUint32)*3*mTcount);
+		data+=sizeof(RmUint32)*3*mTcount;
+		memcpy(data,mNodeArray,sizeof(FlatNodeAABB)*mNodeArrayCount);
+		data+=sizeof(FlatNodeAABB)*mNodeArrayCount;
+		if ( mLeafArrayCount )
+		{
+			memcpy(data,mLeafArray,sizeof(RmUint32)*mLeafArrayCount);
+		}
+	}
+
 	virtual void release(void)
 	{
 		delete this;
@@ -807,11 +1146,11 @@ public:
 
 	virtual const RmReal * getBoundMin(void) const // return the minimum bounding box
 	{
-		return mRoot->mBounds.mMin;
+		return mNodeArray[0].mMin;
 	}
 	virtual const RmReal * getBoundMax(void) const // return the maximum bounding box.
 	{
-		return mRoot->mBounds.mMax;
+		return mNodeArray[0].mMax;
 	}
 
 	virtual NodeAABB * getNode(void) 
@@ -915,7 +1254,13 @@ public:
 	RmUint32		mNodeCount;
 	RmUint32		mMaxNodeCount;
 	NodeAABB		*mNodes;
+	FlatNodeVector	mFlatNodes;
 	TriVector		mLeafTriangles;
+	const FlatNodeAABB	*mNodeArray;		// either mFlatNodes or the serialized data
+	RmUint32		mNodeArrayCount;
+	const RmUint32	*mLeafArray;		// either mLeafTriangles or the serialized data
+	RmUint32		mLeafArrayCount;
+	bool			mOwnsData;			// false when the arrays live in memory handed to loadRaycastMesh
 };
 
 };
@@ -938,4 +1283,86 @@ RaycastMesh * createRaycastMesh(RmUint32 vcount,		// The number of vertices in t
 	return static_cast< RaycastMesh * >(m);
 }
 
+RaycastMesh * loadRaycastMesh(const void *data,RmUint32 size)
+{
+	if ( data == NULL || size < sizeof(SerializedMeshHeader) )
+	{
+		return NULL;
+	}
+	const SerializedMeshHeader *header = (const SerializedMeshHeader *)data;
+	if ( header->mVersion != RAYCAST_MESH_SERIALIZE_VERSION || header->mNodeCount == 0 )
+	{
+		return NULL;
+	}
+
+	// work in 64 bits so corrupt counts can't wrap around the size check
+	unsigned long long expected = sizeof(SerializedMeshHeader);
+	expected += (unsigned long long)sizeof(RmReal)*3*header->mVcount;
+	expected += (unsigned long long)sizeof(RmUint32)*3*header->mTcount;
+	expected += (unsigned long long)sizeof(FlatNodeAABB)*header->mNodeCount;
+	expected += (unsigned long long)sizeof(RmUint32)*header->mLeafCount;
+	if ( expected != size )
+	{
+		return NULL;
+	}
+
+	// make sure every index the traversal follows stays inside the data
+	const RmUint32 *indices = (const RmUint32 *)((const char *)(header+1)+sizeof(RmReal)*3*header->mVcount);
+	for (RmUint32 i=0; i<header->mTcount*3; i++)
+	{
+		if ( indices[i] >= header->mVcount )
+		{
+			return NULL;
+		}
+	}
+	const FlatNodeAABB *nodes = (const FlatNodeAABB *)(indices+header->mTcount*3);
+	const RmUint32 *leafTriangles = (const RmUint32 *)(nodes+header->mNodeCount);
+	// depth of each node reachable from the root, 0 for the rest
+	std::vector< RmUint32 > depth(header->mNodeCount,0);
+	depth[0] = 1;
+	for (RmUint32 i=0; i<header->mNodeCount; i++)
+	{
+		const FlatNodeAABB &node = nodes[i];
+		// nodes are stored depth first so children always come after their parent
+		if ( (node.mLeft != TRI_EOF && (node.mLeft <= i || node.mLeft >= header->mNodeCount)) ||
+			(node.mRight != TRI_EOF && (node.mRight <= i || node.mRight >= header->mNodeCount)) )
+		{
+			return NULL;
+		}
+		// so every parent's depth is final before its children are checked
+		if ( depth[i] && node.mLeafTriangleIndex == TRI_EOF && (node.mLeft != TRI_EOF || node.mRight != TRI_EOF) )
+		{
+			if ( depth[i]+1 > RAYCAST_STACK_SIZE )
+			{
+				return NULL;
+			}
+			if ( node.mLeft != TRI_EOF && depth[node.mLeft] < depth[i]+1 )
+			{
+				depth[node.mLeft] = depth[i]+1;
+			}
+			if ( node.mRight != TRI_EOF && depth[node.mRight] < depth[i]+1 )
+			{
+				depth[node.mRight] = depth[i]+1;
+			}
+		}
+		if ( node.mLeafTriangleIndex != TRI_EOF )
+		{
+			if ( node.mLeafTriangleIndex >= header->mLeafCount || leafTriangles[node.mLeafTriangleIndex] > header->mLeafCount-node.mLeafTriangleIndex-1 )
+			{
+				return NULL;
+			}
+			const RmUint32 *scan = &leafTriangles[node.mLeafTriangleIndex];
+			RmUint32 count = *scan++;
+			for (RmUint32 j=0; j<count; j++)
+			{
+				if ( scan[j] >= header->mTcount )
+				{
+					return NULL;
+				}
+			}
+		}
+	}
 
+	MyRaycastMesh *m = new MyRaycastMesh(header);
+	return static_cast< RaycastMesh * >(m);
+}
@@ -38,6 +38,12 @@ class RaycastMesh
 public:
 	virtual bool raycast(const RmReal *from,const RmReal *to,RmReal *hitLocation,RmReal *hitNormal,RmReal *hitDistance) = 0;
 	virtual bool bruteForceRaycast(const RmReal *from,const RmReal *to,RmReal *hitLocation,RmReal *hitNormal,RmReal *hitDistance) = 0;
+	// Casts 'count' rays at once; from and to hold count x,y,z triples. hit receives one result per ray,
+	// hitLocation (count triples) and hitDistance (count values) are optional and only written for rays that hit.
+	virtual void raycastBatch(RmUint32 count,const RmReal *from,const RmReal *to,bool *hit,RmReal *hitLocation,RmReal *hitDistance) = 0;
+
+	virtual RmUint32 getSerializedSize(void) const = 0; // number of bytes serialize writes
+	virtual void serialize(void *dest) const = 0; // writes the built mesh so loadRaycastMesh can use it without rebuilding the tree
 
 	virtual const RmReal * getBoundMin(void) const = 0; // return the minimum bounding box
 	virtual const RmReal * getBoundMax(void) const = 0; // return the maximum bounding box.
@@ -56,5 +62,9 @@ RaycastMesh * createRaycastMesh(RmUint32 vcount,		// The number of vertices in t
 								RmReal	minAxisSize=0.01f	// once a particular axis is less than this size, stop sub-dividing.
 								);
 
+// Uses a mesh written by RaycastMesh::serialize in place, nothing is copied so the data must outlive the mesh.
+// Returns NULL if the data isn't a serialized mesh.
+RaycastMesh * loadRaycastMesh(const void *data,RmUint32 size);
+
 
 #endif
\ No newline at end of file
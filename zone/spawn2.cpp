@@ -70,8 +70,10 @@ Spawn2::Spawn2(uint32 in_spawn2_id, uint32 spawngroup_id,
 	float in_x, float in_y, float in_z, float in_heading,
 	uint32 respawn, uint32 variance, uint32 timeleft, uint32 grid,
 	uint16 in_cond_id, int16 in_min_value, bool in_enabled, EmuAppearance anim)
-: timer(100000), killcount(0)
+: timer(zone ? &zone->timer_wheel : nullptr, 100000), queued(false), killcount(0)
 {
+	timer.Entry().SetCallback([this]() { if (zone) zone->QueueSpawn2(this); });
+
 	spawn2_id = in_spawn2_id;
 	spawngroup_id_ = spawngroup_id;
 	x = in_x;
@@ -102,6 +104,8 @@ Spawn2::Spawn2(uint32 in_spawn2_id, uint32 spawngroup_id,
 
 Spawn2::~Spawn2()
 {
+	if (zone)
+		zone->UnqueueSpawn2(this);
 }
 
 uint32 Spawn2::resetTimer()
@@ -386,6 +390,23 @@ bool ZoneDatabase::PopulateZoneSpawnList(uint32 zoneid, LinkedList<Spawn2*> &spa
 		}
 	}
 
+	const EQEmu::ZoneContentPack *pack = zone->GetContentPack();
+	if (pack) {
+		uint32 count = 0;
+		const EQEmu::ZoneContentPack::Spawn2Row *row = pack->GetSpawn2(count);
+		for (uint32 i = 0; i < count; ++i, ++row) {
+			uint32 spawn_time_left = 0;
+			if (spawn_times.count(row->id) != 0)
+				spawn_time_left = spawn_times[row->id];
+
+			spawn2_list.Insert(new Spawn2(row->id, row->spawngroup_id, row->x, row->y, row->z, row->heading,
+				row->respawn, row->variance, spawn_time_left, row->grid, row->condition_id,
+				row->condition_min_value, row->enabled != 0, (EmuAppearance)row->animation));
+		}
+
+		return true;
+	}
+
 	const char *zone_name = database.GetZoneName(zoneid);
 	std::string query = StringFormat(
 		"SELECT "
@@ -491,6 +512,9 @@ bool ZoneDatabase::CreateSpawn2(Client *client, uint32 spawngroup, const char* z
     if (results.RowsAffected() != 1)
         return false;
 
+	if (::zone)
+		::zone->DropContentPack();
+
     return true;
 }
 
@@ -1145,7 +1169,7 @@ void SpawnConditionManager::ToggleEvent(uint32 event_id, bool enabled, bool stri
 		//advance the next time by our period
 		EQTime::AddMinutes(e.period, &e.next);
 	} else {
-		Log.Out(Logs::Detail, Logs::Spawns, "Spawn event %d is in zone %s. State changed. Notifying world.", event_id, zone_short_name.c_str(), e.period);
+		Log.Out(Logs::Detail, Logs::Spawns, "Spawn event %d is in zone %s. State changed. Notifying world.", event_id, zone_short_name.c_str());
 	}
 	//save the event in the DB
 	UpdateDBEvent(e);
@@ -19,6 +19,7 @@
 #define SPAWN2_H
 
 #include "../common/timer.h"
+#include "../common/timer_wheel.h"
 #include "npc.h"
 
 #define SC_AlwaysEnabled 0
@@ -70,7 +71,8 @@ public:
 	uint32  GetKillCount() { return killcount; }
 protected:
 	friend class Zone;
-	Timer	timer;
+	EQEmu::WheelTimer	timer;		// queues us on the zone when it goes off, see Zone::Process
+	bool	queued;
 private:
 	uint32	spawn2_id;
 	uint32	respawn_;
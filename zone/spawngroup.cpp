@@ -139,8 +139,39 @@ bool SpawnGroupList::RemoveSpawnGroup(uint32 in_id) {
 	return(true);
 }
 
+static void AddPackSpawnGroup(const EQEmu::ZoneContentPack *pack, const EQEmu::ZoneContentPack::SpawnGroupRow *row, SpawnGroupList *spawn_group_list) {
+	char name[sizeof(row->name)];
+	strn0cpy(name, row->name, sizeof(name));
+
+	SpawnGroup *sg = new SpawnGroup(row->id, name, row->spawn_limit, row->dist, row->max_x, row->min_x, row->max_y,
+		row->min_y, row->delay, row->despawn, row->despawn_timer, row->min_delay);
+
+	uint32 count = 0;
+	const EQEmu::ZoneContentPack::SpawnEntryRow *entry = pack->GetSpawnEntries(row->id, count);
+	for (uint32 i = 0; i < count; ++i, ++entry)
+		sg->AddSpawnEntry(new SpawnEntry(entry->npc_id, entry->chance, entry->npc_spawn_limit));
+
+	spawn_group_list->AddSpawnGroup(sg);
+}
+
 bool ZoneDatabase::LoadSpawnGroups(const char* zone_name, uint16 version, SpawnGroupList* spawn_group_list) {
 
+	const EQEmu::ZoneContentPack *pack = zone ? zone->GetContentPack() : nullptr;
+	if (pack) {
+		uint32 count = 0;
+		const EQEmu::ZoneContentPack::Spawn2Row *spawn = pack->GetSpawn2(count);
+		for (uint32 i = 0; i < count; ++i, ++spawn) {
+			if (spawn_group_list->GetSpawnGroup(spawn->spawngroup_id))
+				continue;
+
+			const EQEmu::ZoneContentPack::SpawnGroupRow *row = pack->FindSpawnGroup(spawn->spawngroup_id);
+			if (row)
+				AddPackSpawnGroup(pack, row, spawn_group_list);
+		}
+
+		return true;
+	}
+
 	std::string query = StringFormat("SELECT DISTINCT(spawngroupID), spawngroup.name, spawngroup.spawn_limit, "
                                     "spawngroup.dist, spawngroup.max_x, spawngroup.min_x, "
                                     "spawngroup.max_y, spawngroup.min_y, spawngroup.delay, "
@@ -167,7 +198,7 @@ bool ZoneDatabase::LoadSpawnGroups(const char* zone_name, uint16 version, SpawnG
                         "AND zone = '%s'", zone_name);
     results = QueryDatabase(query);
     if (!results.Success()) {
-        Log.Out(Logs::General, Logs::Error, "Error2 in PopulateZoneLists query '%'", query.c_str());
+        Log.Out(Logs::General, Logs::Error, "Error2 in PopulateZoneLists query '%s'", query.c_str());
 		return false;
     }
 
@@ -187,6 +218,12 @@ bool ZoneDatabase::LoadSpawnGroups(const char* zone_name, uint16 version, SpawnG
 
 bool ZoneDatabase::LoadSpawnGroupsByID(int spawngroupid, SpawnGroupList* spawn_group_list) {
 
+	const EQEmu::ZoneContentPack *pack = zone ? zone->GetContentPack() : nullptr;
+	const EQEmu::ZoneContentPack::SpawnGroupRow *row = pack ? pack->FindSpawnGroup(spawngroupid) : nullptr;
+	if (row) {
+		AddPackSpawnGroup(pack, row, spawn_group_list);
+		return true;
+	}
 
 	std::string query = StringFormat("SELECT DISTINCT(spawngroup.id), spawngroup.name, spawngroup.spawn_limit, "
                                     "spawngroup.dist, spawngroup.max_x, spawngroup.min_x, "
@@ -147,7 +147,7 @@ bool Mob::SpellEffect(Mob* caster, uint16 spell_id, float partial)
 		args.push_back(&buffslot);
 		int i = parse->EventSpell(EVENT_SPELL_EFFECT_NPC, CastToNPC(), nullptr, spell_id, caster ? caster->GetID() : 0, &args);
 		if(i != 0){
-			CalcBonuses();
+			CalcBuffBonuses();
 			return true;
 		}
 	}
@@ -157,7 +157,7 @@ bool Mob::SpellEffect(Mob* caster, uint16 spell_id, float partial)
 		args.push_back(&buffslot);
 		int i = parse->EventSpell(EVENT_SPELL_EFFECT_CLIENT, nullptr, CastToClient(), spell_id, caster ? caster->GetID() : 0, &args);
 		if(i != 0){
-			CalcBonuses();
+			CalcBuffBonuses();
 			return true;
 		}
 	}
@@ -3017,7 +3017,7 @@ bool Mob::SpellEffect(Mob* caster, uint16 spell_id, float partial)
 #endif
 	}
 
-	CalcBonuses();
+	CalcBuffBonuses();
 
 	if (SummonedItem) {
 		Client *c=CastToClient();
@@ -4182,7 +4182,7 @@ void Mob::BuffFadeBySlot(int slot, bool iRecalcBonuses)
 	}
 
 	if (iRecalcBonuses)
-		CalcBonuses();
+		CalcBuffBonuses();
 }
 
 int32 Client::GetAAEffectDataBySlot(uint32 aa_ID, uint32 slot_id, bool GetEffect, bool GetBase1, bool GetBase2)
@@ -392,7 +392,7 @@ bool Mob::DoCastSpell(uint16 spell_id, uint16 target_id, uint16 slot,
 
 	// we checked for spells not requiring targets above
 	if(target_id == 0) {
-		Log.Out(Logs::Detail, Logs::Spells, "Spell Error: no target. spell=%d\n", GetName(), spell_id);
+		Log.Out(Logs::Detail, Logs::Spells, "%s: Spell Error: no target. spell=%d\n", GetName(), spell_id);
 		if(IsClient()) {
 			//clients produce messages... npcs should not for this case
 			Message_StringID(13, SPELL_NEED_TAR);
@@ -430,7 +430,7 @@ bool Mob::DoCastSpell(uint16 spell_id, uint16 target_id, uint16 slot,
 			{
 				mana_cost = 0;
 			} else {
-				Log.Out(Logs::Detail, Logs::Spells, "Spell Error not enough mana spell=%d mymana=%d cost=%d\n", GetName(), spell_id, my_curmana, mana_cost);
+				Log.Out(Logs::Detail, Logs::Spells, "%s: Spell Error not enough mana spell=%d mymana=%d cost=%d\n", GetName(), spell_id, my_curmana, mana_cost);
 				if(IsClient()) {
 					//clients produce messages... npcs should not for this case
 					Message_StringID(13, INSUFFICIENT_MANA);
@@ -952,7 +952,7 @@ void Mob::CastedSpellFinished(uint16 spell_id, uint32 target_id, uint16 slot,
 	{
 		if (IsBardSong(spell_id)) {
 			if(spells[spell_id].buffduration == 0xFFFF || spells[spell_id].recast_time != 0) {
-				Log.Out(Logs::Detail, Logs::Spells, "Bard song %d not applying bard logic because duration or recast is wrong: dur=%d, recast=%d", spells[spell_id].buffduration, spells[spell_id].recast_time);
+				Log.Out(Logs::Detail, Logs::Spells, "Bard song %d not applying bard logic because duration or recast is wrong: dur=%d, recast=%d", spell_id, spells[spell_id].buffduration, spells[spell_id].recast_time);
 			} else {
 				bardsong = spell_id;
 				bardsong_slot = slot;
@@ -1968,7 +1968,7 @@ bool Mob::SpellFinished(uint16 spell_id, Mob *spell_target, uint16 slot, uint16
 		Mob *beacon_loc = spell_target ? spell_target : this;
 		Beacon *beacon = new Beacon(beacon_loc, spells[spell_id].AEDuration);
 		entity_list.AddBeacon(beacon);
-		Log.Out(Logs::Detail, Logs::Spells, "Spell %d: AE duration beacon created, entity id %d", spell_id, beacon->GetName());
+		Log.Out(Logs::Detail, Logs::Spells, "Spell %d: AE duration beacon created, entity id %d", spell_id, beacon->GetID());
 		spell_target = nullptr;
 		ae_center = beacon;
 		CastAction = AECaster;
@@ -2348,7 +2348,7 @@ bool Mob::ApplyNextBardPulse(uint16 spell_id, Mob *spell_target, uint16 slot) {
 	// check line of sight to target if it's a detrimental spell
 	if(spell_target && IsDetrimentalSpell(spell_id) && !CheckLosFN(spell_target))
 	{
-		Log.Out(Logs::Detail, Logs::Spells, "Bard Song Pulse %d: cannot see target %s", spell_target->GetName());
+		Log.Out(Logs::Detail, Logs::Spells, "Bard Song Pulse %d: cannot see target %s", spell_id, spell_target->GetName());
 		Message_StringID(13, CANT_SEE_TARGET);
 		return(false);
 	}
@@ -3207,7 +3207,7 @@ int Mob::AddBuff(Mob *caster, uint16 spell_id, int duration, int32 level_overrid
 	}
 
 	// recalculate bonuses since we stripped/added buffs
-	CalcBonuses();
+	CalcBuffBonuses();
 
 	return emptyslot;
 }
@@ -3903,7 +3903,7 @@ void Mob::BuffFadeAll()
 			BuffFadeBySlot(j, false);
 	}
 	//we tell BuffFadeBySlot not to recalc, so we can do it only once when were done
-	CalcBonuses();
+	CalcBuffBonuses();
 }
 
 void Mob::BuffFadeNonPersistDeath()
@@ -3914,7 +3914,7 @@ void Mob::BuffFadeNonPersistDeath()
 			BuffFadeBySlot(j, false);
 	}
 	//we tell BuffFadeBySlot not to recalc, so we can do it only once when were done
-	CalcBonuses();
+	CalcBuffBonuses();
 }
 
 void Mob::BuffFadeDetrimental() {
@@ -3926,7 +3926,7 @@ void Mob::BuffFadeDetrimental() {
 		}
 	}
 	//we tell BuffFadeBySlot not to recalc, so we can do it only once when were done
-	CalcBonuses();
+	CalcBuffBonuses();
 }
 
 void Mob::BuffFadeDetrimentalByCaster(Mob *caster)
@@ -3948,7 +3948,7 @@ void Mob::BuffFadeDetrimentalByCaster(Mob *caster)
 		}
 	}
 	//we tell BuffFadeBySlot not to recalc, so we can do it only once when were done
-	CalcBonuses();
+	CalcBuffBonuses();
 }
 
 void Mob::BuffFadeBySitModifier()
@@ -3969,7 +3969,7 @@ void Mob::BuffFadeBySitModifier()
 
 	if(r_bonus)
 	{
-		CalcBonuses();
+		CalcBuffBonuses();
 	}
 }
 
@@ -3984,7 +3984,7 @@ void Mob::BuffFadeBySpellID(uint16 spell_id)
 	}
 
 	//we tell BuffFadeBySlot not to recalc, so we can do it only once when were done
-	CalcBonuses();
+	CalcBuffBonuses();
 }
 
 // removes buffs containing effectid, skipping skipslot
@@ -4002,7 +4002,7 @@ void Mob::BuffFadeByEffect(int effectid, int skipslot)
 	}
 
 	//we tell BuffFadeBySlot not to recalc, so we can do it only once when were done
-	CalcBonuses();
+	CalcBuffBonuses();
 }
 
 // checks if 'this' can be affected by spell_id from caster
@@ -238,7 +238,7 @@ bool TaskManager::LoadTasks(int singleTask) {
         // ERR_NOTASK errors.
         // Change to (activityID != (Tasks[taskID]->ActivityCount + 1)) to index from 1
         if(activityID != Tasks[taskID]->ActivityCount) {
-            Log.Out(Logs::General, Logs::Error, "[TASKS]Activities for Task %i are not sequential starting at 0. Not loading task.", taskID, activityID);
+            Log.Out(Logs::General, Logs::Error, "[TASKS]Activities for Task %i are not sequential starting at 0. Not loading task.", taskID);
             Tasks[taskID] = nullptr;
             continue;
         }
@@ -904,7 +904,7 @@ void TaskManager::TaskSetSelector(Client *c, ClientTaskState *state, Mob *mob, i
 	int PlayerLevel = c->GetLevel();
 
 	Log.Out(Logs::General, Logs::Tasks, "[UPDATE] TaskSetSelector called for taskset %i. EnableTaskSize is %i", TaskSetID,
-				state->EnabledTasks.size());
+				(int)state->EnabledTasks.size());
 	if((TaskSetID<=0) || (TaskSetID>=MAXTASKSETS)) return;
 
 	if(TaskSets[TaskSetID].size() > 0) {
@@ -2418,7 +2418,7 @@ void TaskManager::SendCompletedTasksToClient(Client *c, ClientTaskState *State)
 		FirstTaskToSend = State->CompletedTasks.size() - 50;
 
 	Log.Out(Logs::General, Logs::Tasks, "[UPDATE] Completed Task Count: %i, First Task to send is %i, Last is %i",
-				State->CompletedTasks.size(), FirstTaskToSend, LastTaskToSend);
+				(int)State->CompletedTasks.size(), FirstTaskToSend, LastTaskToSend);
 	/*
 	for(iterator=State->CompletedTasks.begin(); iterator!=State->CompletedTasks.end(); iterator++) {
 		int TaskID = (*iterator).TaskID;
@@ -1223,7 +1223,7 @@ void Client::BulkSendTraderInventory(uint32 char_id) {
 				Log.Out(Logs::Detail, Logs::Trading, "Client::BulkSendTraderInventory nullptr inst pointer");
 		}
 		else
-			Log.Out(Logs::Detail, Logs::Trading, "Client::BulkSendTraderInventory nullptr item pointer or item is NODROP %8X",item);
+			Log.Out(Logs::Detail, Logs::Trading, "Client::BulkSendTraderInventory nullptr item pointer or item is NODROP %p",item);
 	}
 	safe_delete(TraderItems);
 }
@@ -1424,7 +1424,7 @@ void Client::FindAndNukeTraderItem(int32 SerialNumber, uint16 Quantity, Client*
 
 		if (!item)
 		{
-			Log.Out(Logs::Detail, Logs::Trading, "Could not find Item: %i on Trader: %s", SerialNumber, Quantity, this->GetName());
+			Log.Out(Logs::Detail, Logs::Trading, "Could not find Item: %i (quantity %i) on Trader: %s", SerialNumber, Quantity, this->GetName());
 			return;
 		}
 
@@ -1685,6 +1685,7 @@ void Client::BuyTraderItem(TraderBuy_Struct* tbs, Client* Trader, const EQApplic
 
 void Client::SendBazaarWelcome()
 {
+	database.FlushAsyncQueries();
 	const std::string query = "SELECT COUNT(DISTINCT char_id), count(char_id) FROM trader";
 	auto results = database.QueryDatabase(query);
 	if (results.Success() && results.RowCount() == 1){
@@ -1905,6 +1906,8 @@ void Client::SendBazaarResults(uint32 TraderID, uint32 Class_, uint32 Race, uint
     std::string query = StringFormat("SELECT %s, SUM(charges), items.stackable "
                                     "FROM trader, items %s GROUP BY items.id, charges, char_id LIMIT %i",
                                     searchValues.c_str(), searchCriteria.c_str(), RuleI(Bazaar, MaxSearchResults));
+	// trader updates are written in the background, the search has to see them
+	database.FlushAsyncQueries();
     auto results = database.QueryDatabase(query);
     if (!results.Success()) {
 		return;
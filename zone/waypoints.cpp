@@ -845,43 +845,74 @@ void NPC::AssignWaypoints(int32 grid)
 	Waypoints.clear();
 	roamer = false;
 
-	// Retrieve the wander and pause types for this grid
-	std::string query = StringFormat("SELECT `type`, `type2` FROM `grid` WHERE `id` = %i AND `zoneid` = %i", grid,
-					 zone->GetZoneID());
-	auto results = database.QueryDatabase(query);
-	if (!results.Success()) {
-		return;
+	std::vector<wplist> entries;
+	const EQEmu::ZoneContentPack *pack = zone->GetContentPack();
+	// grids the pack doesn't know about (added in game, say) come from the database
+	const EQEmu::ZoneContentPack::GridRow *row = pack ? pack->FindGrid(grid) : nullptr;
+	if (row) {
+		wandertype = row->wander_type;
+		pausetype = row->pause_type;
+
+		uint32 count = 0;
+		const EQEmu::ZoneContentPack::GridEntryRow *entry = pack->GetGridEntries(grid, count);
+		for (uint32 i = 0; i < count; ++i, ++entry) {
+			wplist newwp;
+			newwp.x = entry->x;
+			newwp.y = entry->y;
+			newwp.z = entry->z;
+			newwp.pause = entry->pause;
+			newwp.heading = entry->heading;
+			entries.push_back(newwp);
+		}
 	}
+	else {
+		// Retrieve the wander and pause types for this grid
+		std::string query = StringFormat("SELECT `type`, `type2` FROM `grid` WHERE `id` = %i AND `zoneid` = %i", grid,
+						 zone->GetZoneID());
+		auto results = database.QueryDatabase(query);
+		if (!results.Success()) {
+			return;
+		}
 
-	if (results.RowCount() == 0)
-		return;
+		if (results.RowCount() == 0)
+			return;
 
-	auto row = results.begin();
+		auto row = results.begin();
 
-	wandertype = atoi(row[0]);
-	pausetype = atoi(row[1]);
+		wandertype = atoi(row[0]);
+		pausetype = atoi(row[1]);
 
-	SetGrid(grid);	// Assign grid number
+		// Retrieve all waypoints for this grid
+		query = StringFormat("SELECT `x`,`y`,`z`,`pause`,`heading` "
+							"FROM grid_entries WHERE `gridid` = %i AND `zoneid` = %i "
+							"ORDER BY `number`", grid, zone->GetZoneID());
+		results = database.QueryDatabase(query);
+		if (!results.Success()) {
+			SetGrid(grid);
+			return;
+		}
 
-	// Retrieve all waypoints for this grid
-	query = StringFormat("SELECT `x`,`y`,`z`,`pause`,`heading` "
-						"FROM grid_entries WHERE `gridid` = %i AND `zoneid` = %i "
-						"ORDER BY `number`", grid, zone->GetZoneID());
-	results = database.QueryDatabase(query);
-	if (!results.Success()) {
-		return;
+		for (auto row = results.begin(); row != results.end(); ++row)
+		{
+			wplist newwp;
+			newwp.x = atof(row[0]);
+			newwp.y = atof(row[1]);
+			newwp.z = atof(row[2]);
+			newwp.pause = atoi(row[3]);
+			newwp.heading = atof(row[4]);
+			entries.push_back(newwp);
+		}
 	}
 
+	SetGrid(grid);	// Assign grid number
+
 	roamer = true;
 	max_wp = 0;	// Initialize it; will increment it for each waypoint successfully added to the list
 
-	for (auto row = results.begin(); row != results.end(); ++row, ++max_wp)
+	for (auto iter = entries.begin(); iter != entries.end(); ++iter, ++max_wp)
 	{
-		wplist newwp;
+		wplist newwp = *iter;
 		newwp.index = max_wp;
-		newwp.x = atof(row[0]);
-		newwp.y = atof(row[1]);
-		newwp.z = atof(row[2]);
 
 		if(zone->HasMap() && RuleB(Map, FixPathingZWhenLoading) )
 		{
@@ -897,8 +928,6 @@ void NPC::AssignWaypoints(int32 grid)
 			}
 		}
 
-		newwp.pause = atoi(row[3]);
-		newwp.heading = atof(row[4]);
 		Waypoints.push_back(newwp);
 	}
 
@@ -1044,6 +1073,8 @@ void ZoneDatabase::AssignGrid(Client *client, int grid, int spawn2id) {
 		return;
 	}
 
+	if (zone)
+		zone->DropContentPack();
 	client->Message(0, "Grid assign: spawn2 id = %d updated", spawn2id);
 }
 
@@ -1057,6 +1088,9 @@ void ZoneDatabase::AssignGrid(Client *client, int grid, int spawn2id) {
 */
 void ZoneDatabase::ModifyGrid(Client *client, bool remove, uint32 id, uint8 type, uint8 type2, uint16 zoneid) {
 
+	if (zone)
+		zone->DropContentPack();
+
 	if (!remove)
 	{
 		std::string query = StringFormat("INSERT INTO grid(id, zoneid, type, type2) "
@@ -1088,6 +1122,9 @@ void ZoneDatabase::AddWP(Client *client, uint32 gridid, uint32 wpnum, const glm:
 	if (!results.Success()) {
 		return;
 	}
+
+	if (zone)
+		zone->DropContentPack();
 }
 
 
@@ -1110,6 +1147,9 @@ void ZoneDatabase::DeleteWaypoint(Client *client, uint32 grid_num, uint32 wp_num
 	if(!results.Success()) {
 		return;
 	}
+
+	if (zone)
+		zone->DropContentPack();
 }
 
 
@@ -1177,6 +1217,9 @@ uint32 ZoneDatabase::AddWPForSpawn(Client *client, uint32 spawn2id, const glm::v
 						grid_num, zoneid, next_wp_num, position.x, position.y, position.z, pause, position.w);
 	results = QueryDatabase(query);
 
+	if (zone)
+		zone->DropContentPack();
+
 	return createdNewGrid? grid_num: 0;
 }
 
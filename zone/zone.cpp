@@ -16,6 +16,7 @@
 	Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 
+#include <algorithm>
 #include <float.h>
 #include <iostream>
 #include <math.h>
@@ -36,6 +37,9 @@
 #include "../common/seperator.h"
 #include "../common/string_util.h"
 #include "../common/eqemu_logsys.h"
+#include "../common/ipc_mutex.h"
+#include "../common/memory_mapped_file.h"
+#include "../common/zone_content_pack.h"
 
 #include "guild_mgr.h"
 #include "map.h"
@@ -656,7 +660,7 @@ void Zone::LoadMercSpells(){
         merc_spells_list[classid].push_back(tempMercSpellEntry);
     }
 
-	Log.Out(Logs::General, Logs::Mercenaries, "Loaded %i merc spells.", merc_spells_list[1].size() + merc_spells_list[2].size() + merc_spells_list[9].size() + merc_spells_list[12].size());
+	Log.Out(Logs::General, Logs::Mercenaries, "Loaded %i merc spells.", (int)(merc_spells_list[1].size() + merc_spells_list[2].size() + merc_spells_list[9].size() + merc_spells_list[12].size()));
 
 }
 
@@ -711,10 +715,91 @@ void Zone::Shutdown(bool quite)
 	Log.CloseFileLogs();
 }
 
+bool Zone::LoadContentPack()
+{
+	safe_delete(content_pack);
+	safe_delete(content_pack_mmf);
+
+	try {
+		EQEmu::IPCMutex mutex("zone_content");
+		mutex.Lock();
+		content_pack_mmf = new EQEmu::MemoryMappedFile(EQEmu::ZoneContentPack::FileName(short_name, instanceversion));
+		content_pack = new EQEmu::ZoneContentPack(content_pack_mmf->Get(), content_pack_mmf->Size());
+		mutex.Unlock();
+	} catch(std::exception &ex) {
+		Log.Out(Logs::General, Logs::Status, "No content pack for %s version %u, loading from the database: %s", short_name, instanceversion, ex.what());
+		safe_delete(content_pack);
+		safe_delete(content_pack_mmf);
+		return false;
+	}
+
+	uint32 content_version = 0;
+	if(content_pack->GetZoneID() != zoneid || content_pack->GetVersion() != instanceversion ||
+		!database.GetContentVersion(short_name, content_version) ||
+		content_version != content_pack->GetContentVersion()) {
+		Log.Out(Logs::General, Logs::Status, "Content pack for %s version %u is out of date, loading from the database.", short_name, instanceversion);
+		safe_delete(content_pack);
+		safe_delete(content_pack_mmf);
+		return false;
+	}
+
+	return true;
+}
+
+void Zone::DropContentPack()
+{
+	if(!content_pack)
+		return;
+
+	Log.Out(Logs::General, Logs::Status, "Content of %s version %u was edited, loading spawns, grids and doors from the database.", short_name, instanceversion);
+	safe_delete(content_pack);
+	safe_delete(content_pack_mmf);
+}
+
 void Zone::LoadZoneDoors(const char* zone, int16 version)
 {
 	Log.Out(Logs::General, Logs::Status, "Loading doors for %s ...", zone);
 
+	if(content_pack) {
+		uint32 count = 0;
+		const EQEmu::ZoneContentPack::DoorRow *row = content_pack->GetDoors(count);
+		for(uint32 r = 0; r < count; r++, row++) {
+			Door d;
+			memset(&d, 0, sizeof(Door));
+			d.db_id = row->db_id;
+			d.door_id = row->door_id;
+			strn0cpy(d.zone_name, zone, sizeof(d.zone_name));
+			strn0cpy(d.door_name, row->name, sizeof(d.door_name));
+			d.pos_x = row->x;
+			d.pos_y = row->y;
+			d.pos_z = row->z;
+			d.heading = row->heading;
+			d.opentype = row->open_type;
+			d.guild_id = row->guild_id;
+			d.lock_pick = row->lockpick;
+			d.keyitem = row->key_item;
+			d.nokeyring = row->no_keyring;
+			d.trigger_door = row->trigger_door;
+			d.trigger_type = row->trigger_type;
+			strn0cpy(d.dest_zone, row->dest_zone, sizeof(d.dest_zone));
+			d.dest_instance_id = row->dest_instance_id;
+			d.dest_x = row->dest_x;
+			d.dest_y = row->dest_y;
+			d.dest_z = row->dest_z;
+			d.dest_heading = row->dest_heading;
+			d.door_param = row->door_param;
+			d.invert_state = row->invert_state;
+			d.incline = row->incline;
+			d.size = row->size;
+			d.is_ldon_door = row->is_ldon_door;
+			d.client_version_mask = row->client_version_mask;
+
+			entity_list.AddDoor(new Doors(&d));
+			Log.Out(Logs::Detail, Logs::Doors, "Door Add to Entity List, index: %u db id: %u, door_id %u", r, d.db_id, d.door_id);
+		}
+		return;
+	}
+
 	uint32 maxid;
 	int32 count = database.GetDoorsCount(&maxid, zone, version);
 	if(count < 1) {
@@ -744,6 +829,7 @@ Zone::Zone(uint32 in_zoneid, uint32 in_instanceid, const char* in_short_name)
 :	initgrids_timer(10000),
 	autoshutdown_timer((RuleI(Zone, AutoShutdownDelay))),
 	clientauth_timer(AUTHENTICATION_TIMEOUT * 1000),
+	timer_wheel(Timer::GetCurrentTime()),
 	spawn2_timer(1000),
 	qglobal_purge_timer(30000),
 	hotzone_timer(120000),
@@ -778,6 +864,9 @@ Zone::Zone(uint32 in_zoneid, uint32 in_instanceid, const char* in_short_name)
 	pgraveyard_zoneid = 0;
 	pMaxClients = 0;
 	pQueuedMerchantsWorkID = 0;
+	npc_types_from_db = false;
+	content_pack_mmf = nullptr;
+	content_pack = nullptr;
 	pvpzone = false;
 	if(database.GetServerType() == 1)
 		pvpzone = true;
@@ -842,6 +931,9 @@ Zone::Zone(uint32 in_zoneid, uint32 in_instanceid, const char* in_short_name)
 }
 
 Zone::~Zone() {
+	for (auto spawn : due_spawns)
+		spawn->queued = false;
+	due_spawns.clear();
 	spawn2_list.Clear();
 	safe_delete(zonemap);
 	safe_delete(watermap);
@@ -874,6 +966,8 @@ Zone::~Zone() {
 	}
 
 	safe_delete(GuildBanks);
+	safe_delete(content_pack);
+	safe_delete(content_pack_mmf);
 }
 
 //Modified for timezones.
@@ -891,6 +985,9 @@ bool Zone::Init(bool iStaticZone) {
 		return false;
 	}
 
+	Log.Out(Logs::General, Logs::Status, "Loading zone content pack...");
+	LoadContentPack();
+
 	Log.Out(Logs::General, Logs::Status, "Loading spawn groups...");
 	if (!database.LoadSpawnGroups(short_name, GetInstanceVersion(), &spawn_group_list)) {
 		Log.Out(Logs::General, Logs::Error, "Loading spawn groups failed.");
@@ -1032,6 +1129,7 @@ void Zone::ReloadStaticData() {
 	}
 
 	entity_list.RemoveAllDoors();
+	LoadContentPack();
 	zone->LoadZoneDoors(zone->GetShortName(), zone->GetInstanceVersion());
 	entity_list.RespawnAllDoors();
 
@@ -1171,19 +1269,35 @@ bool Zone::Process() {
 	spawn_conditions.Process();
 
 	if(spawn2_timer.Check()) {
-		LinkedListIterator<Spawn2*> iterator(spawn2_list);
-
 		Inventory::CleanDirty();
 
-		iterator.Reset();
-		while (iterator.MoreElements()) {
-			if (iterator.GetData()->Process()) {
-				iterator.Advance();
-			}
-			else {
-				iterator.RemoveCurrent();
+		// only the spawns whose timer went off have anything to do
+		processing_spawns.swap(due_spawns);
+		for (size_t i = 0; i < processing_spawns.size(); ++i) {
+			Spawn2 *spawn = processing_spawns[i];
+			if (spawn == nullptr)
+				continue;
+
+			spawn->queued = false;
+			if (!spawn->Process()) {
+				LinkedListIterator<Spawn2*> iterator(spawn2_list);
+				iterator.Reset();
+				while (iterator.MoreElements()) {
+					if (iterator.GetData() == spawn) {
+						iterator.RemoveCurrent();
+						break;
+					}
+					iterator.Advance();
+				}
+				continue;
 			}
+
+			// Process() bails before checking the timer while the spawn is disabled or still up, keep trying
+			// it every pass like before until it does
+			if (spawn->timer.Enabled() && spawn->timer.GetRemainingTime() == 0)
+				QueueSpawn2(spawn);
 		}
+		processing_spawns.clear();
 		if(adv_data && !did_adventure_actions)
 		{
 			DoAdventureActions();
@@ -1433,11 +1547,14 @@ bool Zone::Depop(bool StartSpawnTimer) {
 		delete itr->second;
 		npctable.erase(itr);
 	}
+	npc_types_from_db = true;
 
 	return true;
 }
 
 void Zone::ClearNPCTypeCache(int id) {
+	npc_types_from_db = true;
+
 	if (id <= 0) {
 		auto iter = npctable.begin();
 		while (iter != npctable.end()) {
@@ -1459,6 +1576,29 @@ void Zone::ClearNPCTypeCache(int id) {
 	}
 }
 
+void Zone::QueueSpawn2(Spawn2 *spawn) {
+	if (spawn->queued)
+		return;
+
+	spawn->queued = true;
+	due_spawns.push_back(spawn);
+}
+
+void Zone::UnqueueSpawn2(Spawn2 *spawn) {
+	if (spawn->queued) {
+		auto iter = std::find(due_spawns.begin(), due_spawns.end(), spawn);
+		if (iter != due_spawns.end())
+			due_spawns.erase(iter);
+		spawn->queued = false;
+	}
+
+	// it may also be going away while we are processing spawns (a quest repopping the zone)
+	for (auto &p : processing_spawns) {
+		if (p == spawn)
+			p = nullptr;
+	}
+}
+
 void Zone::Repop(uint32 delay) {
 
 	if(!Depop())
@@ -1473,6 +1613,9 @@ void Zone::Repop(uint32 delay) {
 
 	quest_manager.ClearAllTimers();
 
+	// content may have been edited since the pack was checked
+	LoadContentPack();
+
 	if (!database.PopulateZoneSpawnList(zoneid, spawn2_list, GetInstanceVersion(), delay))
 		Log.Out(Logs::General, Logs::None, "Error in Zone::Repop: database.PopulateZoneSpawnList failed");
 
@@ -24,6 +24,7 @@
 #include "../common/types.h"
 #include "../common/random.h"
 #include "../common/string_util.h"
+#include "../common/timer_wheel.h"
 #include "qglobals.h"
 #include "spawn2.h"
 #include "spawngroup.h"
@@ -70,6 +71,11 @@ struct item_tick_struct {
 
 class Client;
 class Map;
+namespace EQEmu
+{
+	class MemoryMappedFile;
+	class ZoneContentPack;
+}
 class Mob;
 class PathManager;
 class WaterMap;
@@ -93,6 +99,7 @@ public:
 	inline const char*	GetLongName()	{ return long_name; }
 	inline const char*	GetFileName()	{ return file_name; }
 	inline const char*	GetShortName()	{ return short_name; }
+	inline const char*	GetMapName()	{ return map_name; }
 	inline const uint32	GetZoneID() const { return zoneid; }
 	inline const uint32	GetInstanceID() const { return instanceid; }
 	inline const uint16	GetInstanceVersion() const { return instanceversion; }
@@ -114,11 +121,16 @@ public:
 	SendAA_Struct*	FindAA(uint32 id);
 	uint8	GetTotalAALevels(uint32 skill_id);
 	void	LoadZoneDoors(const char* zone, int16 version);
+	bool	LoadContentPack();
+	void	DropContentPack(); // after spawn, grid or door rows are edited in game, the zone goes back to the database for them
+	const EQEmu::ZoneContentPack* GetContentPack() const { return content_pack; }
 	bool	LoadZoneObjects();
 	bool	LoadGroundSpawns();
 	void	ReloadStaticData();
 
 	uint32	CountSpawn2();
+	void	QueueSpawn2(Spawn2 *spawn);
+	void	UnqueueSpawn2(Spawn2 *spawn);
 	ZonePoint* GetClosestZonePoint(const glm::vec3& location, const char* to_name, Client *client, float max_distance = 40000.0f);
 	ZonePoint* GetClosestZonePoint(const glm::vec3& location, uint32	to, Client *client, float max_distance = 40000.0f);
 	ZonePoint* GetClosestZonePointWithoutZone(float x, float y, float z, Client *client, float max_distance = 40000.0f);
@@ -173,6 +185,7 @@ public:
 	void LoadAdventureFlavor();
 
 	std::map<uint32,NPCType *> npctable;
+	bool npc_types_from_db; // set once npctable has been refreshed, LoadNPCTypesData skips shared memory after that
 	std::map<uint32,NPCType *> merctable;
 	std::map<uint32,std::list<MerchantList> > merchanttable;
 	std::map<uint32,std::list<TempMerchantList> > tmpmerchanttable;
@@ -244,6 +257,7 @@ public:
 	void	DeleteQGlobal(std::string name, uint32 npcID, uint32 charID, uint32 zoneID);
 
 	LinkedList<Spawn2*> spawn2_list;
+	EQEmu::TimerWheel timer_wheel;
 	LinkedList<ZonePoint*> zone_point_list;
 	uint32	numzonepoints;
 
@@ -283,6 +297,8 @@ public:
 
 private:
 	uint32	zoneid;
+	EQEmu::MemoryMappedFile *content_pack_mmf;
+	EQEmu::ZoneContentPack *content_pack; // static spawn, grid and door rows, null when they come from the database
 	uint32	instanceid;
 	uint16	instanceversion;
 	bool pers_instance;
@@ -327,6 +343,8 @@ private:
 	Timer	autoshutdown_timer;
 	Timer	clientauth_timer;
 	Timer	spawn2_timer;
+	std::vector<Spawn2*> due_spawns;		// spawns whose timer went off, handled on the next spawn2_timer
+	std::vector<Spawn2*> processing_spawns;
 	Timer	qglobal_purge_timer;
 	Timer*	Weather_Timer;
 	Timer*	Instance_Timer;
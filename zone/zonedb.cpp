@@ -309,6 +309,9 @@ void ZoneDatabase::UpdateSpawn2Status(uint32 id, uint8 new_status)
 {
 	std::string query = StringFormat("UPDATE spawn2 SET enabled = %i WHERE id = %lu", new_status, (unsigned long)id);
 	QueryDatabase(query);
+
+	if (zone)
+		zone->DropContentPack();
 }
 
 bool ZoneDatabase::logevents(const char* accountname,uint32 accountid,uint8 status,const char* charname, const char* target,const char* descriptiontype, const char* description,int event_nid){
@@ -565,6 +568,7 @@ Trader_Struct* ZoneDatabase::LoadTraderItem(uint32 char_id)
 	Trader_Struct* loadti = new Trader_Struct;
 	memset(loadti,0,sizeof(Trader_Struct));
 
+	FlushAsyncQueries(char_id);
 	std::string query = StringFormat("SELECT * FROM trader WHERE char_id = %i ORDER BY slot_id LIMIT 80", char_id);
 	auto results = QueryDatabase(query);
 	if (!results.Success()) {
@@ -590,6 +594,7 @@ TraderCharges_Struct* ZoneDatabase::LoadTraderItemWithCharges(uint32 char_id)
 	TraderCharges_Struct* loadti = new TraderCharges_Struct;
 	memset(loadti,0,sizeof(TraderCharges_Struct));
 
+	FlushAsyncQueries(char_id);
 	std::string query = StringFormat("SELECT * FROM trader WHERE char_id=%i ORDER BY slot_id LIMIT 80", char_id);
 	auto results = QueryDatabase(query);
 	if (!results.Success()) {
@@ -612,6 +617,7 @@ TraderCharges_Struct* ZoneDatabase::LoadTraderItemWithCharges(uint32 char_id)
 }
 
 ItemInst* ZoneDatabase::LoadSingleTraderItem(uint32 CharID, int SerialNumber) {
+	FlushAsyncQueries(CharID);
 	std::string query = StringFormat("SELECT * FROM trader WHERE char_id = %i AND serialnumber = %i "
                                     "ORDER BY slot_id LIMIT 80", CharID, SerialNumber);
     auto results = QueryDatabase(query);
@@ -662,9 +668,10 @@ void ZoneDatabase::SaveTraderItem(uint32 CharID, uint32 ItemID, uint32 SerialNum
 
 	std::string query = StringFormat("REPLACE INTO trader VALUES(%i, %i, %i, %i, %i, %i)",
                                     CharID, ItemID, SerialNumber, Charges, ItemCost, Slot);
-    auto results = QueryDatabase(query);
-    if (!results.Success())
-        Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to save trader item: %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+	QueryDatabaseAsync(query, CharID, [ItemID, CharID](MySQLRequestResult &results) {
+		if (!results.Success())
+			Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to save trader item: %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+	});
 
 }
 
@@ -673,10 +680,11 @@ void ZoneDatabase::UpdateTraderItemCharges(int CharID, uint32 SerialNumber, int3
 
 	std::string query = StringFormat("UPDATE trader SET charges = %i WHERE char_id = %i AND serialnumber = %i",
                                     Charges, CharID, SerialNumber);
-    auto results = QueryDatabase(query);
-    if (!results.Success())
-		Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to update charges for trader item: %i for char_id: %i, the error was: %s\n",
+	QueryDatabaseAsync(query, CharID, [SerialNumber, CharID](MySQLRequestResult &results) {
+		if (!results.Success())
+			Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to update charges for trader item: %i for char_id: %i, the error was: %s\n",
                                 SerialNumber, CharID, results.ErrorMessage().c_str());
+	});
 
 }
 
@@ -693,9 +701,10 @@ void ZoneDatabase::UpdateTraderItemPrice(int CharID, uint32 ItemID, uint32 Charg
 		Log.Out(Logs::Detail, Logs::Trading, "Removing Trader items from the DB for CharID %i, ItemID %i", CharID, ItemID);
 
         std::string query = StringFormat("DELETE FROM trader WHERE char_id = %i AND item_id = %i",CharID, ItemID);
-        auto results = QueryDatabase(query);
-        if (!results.Success())
-			Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to remove trader item(s): %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+		QueryDatabaseAsync(query, CharID, [ItemID, CharID](MySQLRequestResult &results) {
+			if (!results.Success())
+				Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to remove trader item(s): %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+		});
 
 		return;
 	}
@@ -704,9 +713,10 @@ void ZoneDatabase::UpdateTraderItemPrice(int CharID, uint32 ItemID, uint32 Charg
         std::string query = StringFormat("UPDATE trader SET item_cost = %i "
                                         "WHERE char_id = %i AND item_id = %i AND charges=%i",
                                         NewPrice, CharID, ItemID, Charges);
-        auto results = QueryDatabase(query);
-        if (!results.Success())
-            Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to update price for trader item: %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+		QueryDatabaseAsync(query, CharID, [ItemID, CharID](MySQLRequestResult &results) {
+			if (!results.Success())
+				Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to update price for trader item: %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+		});
 
         return;
     }
@@ -714,13 +724,17 @@ void ZoneDatabase::UpdateTraderItemPrice(int CharID, uint32 ItemID, uint32 Charg
     std::string query = StringFormat("UPDATE trader SET item_cost = %i "
                                     "WHERE char_id = %i AND item_id = %i",
                                     NewPrice, CharID, ItemID);
-    auto results = QueryDatabase(query);
-    if (!results.Success())
-            Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to update price for trader item: %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+	QueryDatabaseAsync(query, CharID, [ItemID, CharID](MySQLRequestResult &results) {
+		if (!results.Success())
+			Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to update price for trader item: %i for char_id: %i, the error was: %s\n", ItemID, CharID, results.ErrorMessage().c_str());
+	});
 }
 
 void ZoneDatabase::DeleteTraderItem(uint32 char_id){
 
+	// queued writes for this trader must not land after the delete
+	FlushAsyncQueries(char_id);
+
 	if(char_id==0) {
         const std::string query = "DELETE FROM trader";
         auto results = QueryDatabase(query);
@@ -739,9 +753,10 @@ void ZoneDatabase::DeleteTraderItem(uint32 char_id){
 void ZoneDatabase::DeleteTraderItem(uint32 CharID,uint16 SlotID) {
 
 	std::string query = StringFormat("DELETE FROM trader WHERE char_id = %i And slot_id = %i", CharID, SlotID);
-	auto results = QueryDatabase(query);
-	if (!results.Success())
-		Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to delete trader item data for char_id: %i, the error was: %s\n",CharID, results.ErrorMessage().c_str());
+	QueryDatabaseAsync(query, CharID, [CharID](MySQLRequestResult &results) {
+		if (!results.Success())
+			Log.Out(Logs::Detail, Logs::None, "[CLIENT] Failed to delete trader item data for char_id: %i, the error was: %s\n",CharID, results.ErrorMessage().c_str());
+	});
 }
 
 void ZoneDatabase::DeleteBuyLines(uint32 CharID) {
@@ -1293,13 +1308,12 @@ bool ZoneDatabase::SaveCharacterLanguage(uint32 character_id, uint32 lang_id, ui
 }
 
 bool ZoneDatabase::SaveCharacterBindPoint(uint32 character_id, uint32 zone_id, uint32 instance_id, const glm::vec4& position, uint8 is_home){
-	if (zone_id <= 0) {
+	std::string query = CharacterBindPointQuery(character_id, zone_id, instance_id, position, is_home);
+	if (query.empty()) {
 		return false;
 	}
 
 	/* Save Home Bind Point */
-	std::string query = StringFormat("REPLACE INTO `character_bind` (id, zone_id, instance_id, x, y, z, heading, is_home)"
-		" VALUES (%u, %u, %u, %f, %f, %f, %f, %i)", character_id, zone_id, instance_id, position.x, position.y, position.z, position.w, is_home);
 	Log.Out(Logs::General, Logs::None, "ZoneDatabase::SaveCharacterBindPoint for character ID: %i zone_id: %u instance_id: %u position: %s ishome: %u", character_id, zone_id, instance_id, to_string(position).c_str(), is_home);
 	auto results = QueryDatabase(query);
 	if (!results.RowsAffected()) {
@@ -1308,6 +1322,15 @@ bool ZoneDatabase::SaveCharacterBindPoint(uint32 character_id, uint32 zone_id, u
 	return true;
 }
 
+std::string ZoneDatabase::CharacterBindPointQuery(uint32 character_id, uint32 zone_id, uint32 instance_id, const glm::vec4& position, uint8 is_home){
+	if (zone_id <= 0) {
+		return std::string();
+	}
+
+	return StringFormat("REPLACE INTO `character_bind` (id, zone_id, instance_id, x, y, z, heading, is_home)"
+		" VALUES (%u, %u, %u, %f, %f, %f, %f, %i)", character_id, zone_id, instance_id, position.x, position.y, position.z, position.w, is_home);
+}
+
 bool ZoneDatabase::SaveCharacterMaterialColor(uint32 character_id, uint32 slot_id, uint32 color){
 	uint8 red = (color & 0x00FF0000) >> 16;
 	uint8 green = (color & 0x0000FF00) >> 8;
@@ -1332,17 +1355,31 @@ bool ZoneDatabase::SaveCharacterDisc(uint32 character_id, uint32 slot_id, uint32
 }
 
 bool ZoneDatabase::SaveCharacterTribute(uint32 character_id, PlayerProfile_Struct* pp){
-	std::string query = StringFormat("DELETE FROM `character_tribute` WHERE `id` = %u", character_id);
-	QueryDatabase(query);
+	std::vector<std::string> queries;
+	CharacterTributeQueries(character_id, pp, queries);
+	for (auto &query : queries)
+		QueryDatabase(query);
+	Log.Out(Logs::General, Logs::None, "ZoneDatabase::SaveCharacterTribute for character ID: %i done", character_id);
+	return true;
+}
+
+void ZoneDatabase::CharacterTributeQueries(uint32 character_id, PlayerProfile_Struct* pp, std::vector<std::string> &queries){
+	queries.push_back(StringFormat("DELETE FROM `character_tribute` WHERE `id` = %u", character_id));
+
 	/* Save Tributes only if we have values... */
+	std::string query;
 	for (int i = 0; i < EmuConstants::TRIBUTE_SIZE; i++){
 		if (pp->tributes[i].tribute > 0 && pp->tributes[i].tribute != TRIBUTE_NONE){
-			std::string query = StringFormat("REPLACE INTO `character_tribute` (id, tier, tribute) VALUES (%u, %u, %u)", character_id, pp->tributes[i].tier, pp->tributes[i].tribute);
-			QueryDatabase(query);
-			Log.Out(Logs::General, Logs::None, "ZoneDatabase::SaveCharacterTribute for character ID: %i, tier:%u tribute:%u done", character_id, pp->tributes[i].tier, pp->tributes[i].tribute);
+			if (query.empty())
+				query = "REPLACE INTO `character_tribute` (id, tier, tribute) VALUES ";
+			else
+				query += ", ";
+			query += StringFormat("(%u, %u, %u)", character_id, pp->tributes[i].tier, pp->tributes[i].tribute);
 		}
 	}
-	return true;
+
+	if (!query.empty())
+		queries.push_back(query);
 }
 
 bool ZoneDatabase::SaveCharacterBandolier(uint32 character_id, uint8 bandolier_id, uint8 bandolier_slot, uint32 item_id, uint32 icon, const char* bandolier_name)
@@ -1379,7 +1416,13 @@ bool ZoneDatabase::SaveCharacterLeadershipAA(uint32 character_id, PlayerProfile_
 
 bool ZoneDatabase::SaveCharacterData(uint32 character_id, uint32 account_id, PlayerProfile_Struct* pp, ExtendedProfile_Struct* m_epp){
 	clock_t t = std::clock(); /* Function timer start */
-	std::string query = StringFormat(
+	auto results = database.QueryDatabase(CharacterDataQuery(character_id, account_id, pp, m_epp));
+	Log.Out(Logs::General, Logs::None, "ZoneDatabase::SaveCharacterData %i, done... Took %f seconds", character_id, ((float)(std::clock() - t)) / CLOCKS_PER_SEC);
+	return true;
+}
+
+std::string ZoneDatabase::CharacterDataQuery(uint32 character_id, uint32 account_id, PlayerProfile_Struct* pp, ExtendedProfile_Struct* m_epp){
+	return StringFormat(
 		"REPLACE INTO `character_data` ("
 		" id,                        "
 		" account_id,                "
@@ -1664,12 +1707,15 @@ bool ZoneDatabase::SaveCharacterData(uint32 character_id, uint32 account_id, Pla
 		m_epp->perAA,
 		m_epp->expended_aa
 	);
-	auto results = database.QueryDatabase(query);
-	Log.Out(Logs::General, Logs::None, "ZoneDatabase::SaveCharacterData %i, done... Took %f seconds", character_id, ((float)(std::clock() - t)) / CLOCKS_PER_SEC);
-	return true;
 }
 
 bool ZoneDatabase::SaveCharacterCurrency(uint32 character_id, PlayerProfile_Struct* pp){
+	auto results = database.QueryDatabase(CharacterCurrencyQuery(character_id, pp));
+	Log.Out(Logs::General, Logs::None, "Saving Currency for character ID: %i, done", character_id);
+	return true;
+}
+
+std::string ZoneDatabase::CharacterCurrencyQuery(uint32 character_id, PlayerProfile_Struct* pp){
 	if (pp->copper < 0) { pp->copper = 0; }
 	if (pp->silver < 0) { pp->silver = 0; }
 	if (pp->gold < 0) { pp->gold = 0; }
@@ -1682,7 +1728,7 @@ bool ZoneDatabase::SaveCharacterCurrency(uint32 character_id, PlayerProfile_Stru
 	if (pp->gold_cursor < 0) { pp->gold_cursor = 0; }
 	if (pp->silver_cursor < 0) { pp->silver_cursor = 0; }
 	if (pp->copper_cursor < 0) { pp->copper_cursor = 0; }
-	std::string query = StringFormat(
+	return StringFormat(
 		"REPLACE INTO `character_currency` (id, platinum, gold, silver, copper,"
 		"platinum_bank, gold_bank, silver_bank, copper_bank,"
 		"platinum_cursor, gold_cursor, silver_cursor, copper_cursor, "
@@ -1705,9 +1751,6 @@ bool ZoneDatabase::SaveCharacterCurrency(uint32 character_id, PlayerProfile_Stru
 		pp->careerRadCrystals,
 		pp->currentEbonCrystals,
 		pp->careerEbonCrystals);
-	auto results = database.QueryDatabase(query); 
-	Log.Out(Logs::General, Logs::None, "Saving Currency for character ID: %i, done", character_id); 
-	return true;
 }
 
 bool ZoneDatabase::SaveCharacterAA(uint32 character_id, uint32 aa_id, uint32 current_level){
@@ -1799,6 +1842,16 @@ const NPCType* ZoneDatabase::LoadNPCTypesData(uint32 npc_type_id, bool bulk_load
 	if(itr != zone->npctable.end())
 		return itr->second;
 
+	/* Then the shared memory copy, unless the zone has been told to get current info from the database */
+	if (npc_types_hash && !zone->npc_types_from_db) {
+		if (bulk_load)
+			return nullptr;
+
+		npc = GetNPCType(npc_type_id);
+		if (npc)
+			return npc;
+	}
+
 	std::string where_condition = "";
 
 	if (bulk_load){
@@ -1809,112 +1862,10 @@ const NPCType* ZoneDatabase::LoadNPCTypesData(uint32 npc_type_id, bool bulk_load
 			"WHERE spawn2.zone = '%s' and spawn2.version = %u GROUP BY npc_types.id", zone->GetShortName(), zone->GetInstanceVersion());
 	}
 	else{
-		where_condition = StringFormat("WHERE id = %u", npc_type_id);
+		where_condition = StringFormat("WHERE npc_types.id = %u", npc_type_id);
 	}
 
-	std::string query = StringFormat("SELECT "
-		"npc_types.id, "
-		"npc_types.name, "
-		"npc_types.level, "
-		"npc_types.race, "
-		"npc_types.class, "
-		"npc_types.hp, "
-		"npc_types.mana, "
-		"npc_types.gender, "
-		"npc_types.texture, "
-		"npc_types.helmtexture, "
-		"npc_types.herosforgemodel, "
-		"npc_types.size, "
-		"npc_types.loottable_id, "
-		"npc_types.merchant_id, "
-		"npc_types.alt_currency_id, "
-		"npc_types.adventure_template_id, "
-		"npc_types.trap_template, "
-		"npc_types.attack_speed, "
-		"npc_types.STR, "
-		"npc_types.STA, "
-		"npc_types.DEX, "
-		"npc_types.AGI, "
-		"npc_types._INT, "
-		"npc_types.WIS, "
-		"npc_types.CHA, "
-		"npc_types.MR, "
-		"npc_types.CR, "
-		"npc_types.DR, "
-		"npc_types.FR, "
-		"npc_types.PR, "
-		"npc_types.Corrup, "
-		"npc_types.PhR, "
-		"npc_types.mindmg, "
-		"npc_types.maxdmg, "
-		"npc_types.attack_count, "
-		"npc_types.special_abilities, "
-		"npc_types.npc_spells_id, "
-		"npc_types.npc_spells_effects_id, "
-		"npc_types.d_melee_texture1, "
-		"npc_types.d_melee_texture2, "
-		"npc_types.ammo_idfile, "
-		"npc_types.prim_melee_type, "
-		"npc_types.sec_melee_type, "
-		"npc_types.ranged_type, "
-		"npc_types.runspeed, "
-		"npc_types.findable, "
-		"npc_types.trackable, "
-		"npc_types.hp_regen_rate, "
-		"npc_types.mana_regen_rate, "
-		"npc_types.aggroradius, "
-		"npc_types.assistradius, "
-		"npc_types.bodytype, "
-		"npc_types.npc_faction_id, "
-		"npc_types.face, "
-		"npc_types.luclin_hairstyle, "
-		"npc_types.luclin_haircolor, "
-		"npc_types.luclin_eyecolor, "
-		"npc_types.luclin_eyecolor2, "
-		"npc_types.luclin_beardcolor, "
-		"npc_types.luclin_beard, "
-		"npc_types.drakkin_heritage, "
-		"npc_types.drakkin_tattoo, "
-		"npc_types.drakkin_details, "
-		"npc_types.armortint_id, "
-		"npc_types.armortint_red, "
-		"npc_types.armortint_green, "
-		"npc_types.armortint_blue, "
-		"npc_types.see_invis, "
-		"npc_types.see_invis_undead, "
-		"npc_types.lastname, "
-		"npc_types.qglobal, "
-		"npc_types.AC, "
-		"npc_types.npc_aggro, "
-		"npc_types.spawn_limit, "
-		"npc_types.see_hide, "
-		"npc_types.see_improved_hide, "
-		"npc_types.ATK, "
-		"npc_types.Accuracy, "
-		"npc_types.Avoidance, "
-		"npc_types.slow_mitigation, "
-		"npc_types.maxlevel, "
-		"npc_types.scalerate, "
-		"npc_types.private_corpse, "
-		"npc_types.unique_spawn_by_name, "
-		"npc_types.underwater, "
-		"npc_types.emoteid, "
-		"npc_types.spellscale, "
-		"npc_types.healscale, "
-		"npc_types.no_target_hotkey, "
-		"npc_types.raid_target, "
-		"npc_types.attack_delay, "
-		"npc_types.light, "
-		"npc_types.armtexture, "
-		"npc_types.bracertexture, "
-		"npc_types.handtexture, "
-		"npc_types.legtexture, "
-		"npc_types.feettexture "
-		"FROM npc_types %s", 
-		where_condition.c_str()
-	);
-
-    auto results = QueryDatabase(query);
+    auto results = QueryDatabase(GetNPCTypesQuery(where_condition));
     if (!results.Success()) {
         return nullptr;
     }
@@ -1922,168 +1873,7 @@ const NPCType* ZoneDatabase::LoadNPCTypesData(uint32 npc_type_id, bool bulk_load
     for (auto row = results.begin(); row != results.end(); ++row) {
 		NPCType *temp_npctype_data;
 		temp_npctype_data = new NPCType;
-		memset (temp_npctype_data, 0, sizeof *temp_npctype_data);
-
-		temp_npctype_data->npc_id = atoi(row[0]);
-
-		strn0cpy(temp_npctype_data->name, row[1], 50);
-
-		temp_npctype_data->level = atoi(row[2]);
-		temp_npctype_data->race = atoi(row[3]);
-		temp_npctype_data->class_ = atoi(row[4]);
-		temp_npctype_data->max_hp = atoi(row[5]);
-		temp_npctype_data->cur_hp = temp_npctype_data->max_hp;
-		temp_npctype_data->Mana = atoi(row[6]);
-		temp_npctype_data->gender = atoi(row[7]);
-		temp_npctype_data->texture = atoi(row[8]);
-		temp_npctype_data->helmtexture = atoi(row[9]);
-		temp_npctype_data->herosforgemodel = atoul(row[10]);
-		temp_npctype_data->size = atof(row[11]);
-        temp_npctype_data->loottable_id = atoi(row[12]);
-		temp_npctype_data->merchanttype = atoi(row[13]);
-		temp_npctype_data->alt_currency_type = atoi(row[14]);
-		temp_npctype_data->adventure_template = atoi(row[15]);
-		temp_npctype_data->trap_template = atoi(row[16]);
-		temp_npctype_data->attack_speed = atof(row[17]);
-		temp_npctype_data->STR = atoi(row[18]);
-		temp_npctype_data->STA = atoi(row[19]);
-		temp_npctype_data->DEX = atoi(row[20]);
-		temp_npctype_data->AGI = atoi(row[21]);
-		temp_npctype_data->INT = atoi(row[22]);
-		temp_npctype_data->WIS = atoi(row[23]);
-		temp_npctype_data->CHA = atoi(row[24]);
-		temp_npctype_data->MR = atoi(row[25]);
-		temp_npctype_data->CR = atoi(row[26]);
-		temp_npctype_data->DR = atoi(row[27]);
-		temp_npctype_data->FR = atoi(row[28]);
-		temp_npctype_data->PR = atoi(row[29]);
-		temp_npctype_data->Corrup = atoi(row[30]);
-		temp_npctype_data->PhR = atoi(row[31]);
-		temp_npctype_data->min_dmg = atoi(row[32]);
-		temp_npctype_data->max_dmg = atoi(row[33]);
-		temp_npctype_data->attack_count = atoi(row[34]);
-
-		if (row[35] != nullptr)
-			strn0cpy(temp_npctype_data->special_abilities, row[35], 512);
-		else
-			temp_npctype_data->special_abilities[0] = '\0';
-
-		temp_npctype_data->npc_spells_id = atoi(row[36]);
-		temp_npctype_data->npc_spells_effects_id = atoi(row[37]);
-		temp_npctype_data->d_melee_texture1 = atoi(row[38]);
-		temp_npctype_data->d_melee_texture2 = atoi(row[39]);
-		strn0cpy(temp_npctype_data->ammo_idfile, row[40], 30);
-		temp_npctype_data->prim_melee_type = atoi(row[41]);
-		temp_npctype_data->sec_melee_type = atoi(row[42]);
-		temp_npctype_data->ranged_type = atoi(row[43]);
-		temp_npctype_data->runspeed= atof(row[44]);
-		temp_npctype_data->findable = atoi(row[45]) == 0? false : true;
-		temp_npctype_data->trackable = atoi(row[46]) == 0? false : true;
-		temp_npctype_data->hp_regen = atoi(row[47]);
-		temp_npctype_data->mana_regen = atoi(row[48]);
-
-		// set default value for aggroradius
-        temp_npctype_data->aggroradius = (int32)atoi(row[49]);
-		if (temp_npctype_data->aggroradius <= 0)
-			temp_npctype_data->aggroradius = 70;
-
-		temp_npctype_data->assistradius = (int32)atoi(row[50]);
-		if (temp_npctype_data->assistradius <= 0)
-			temp_npctype_data->assistradius = temp_npctype_data->aggroradius;
-
-		if (row[51] && strlen(row[51]))
-            temp_npctype_data->bodytype = (uint8)atoi(row[51]);
-        else
-            temp_npctype_data->bodytype = 0;
-
-		temp_npctype_data->npc_faction_id = atoi(row[52]);
-
-		temp_npctype_data->luclinface = atoi(row[53]);
-		temp_npctype_data->hairstyle = atoi(row[54]);
-		temp_npctype_data->haircolor = atoi(row[55]);
-		temp_npctype_data->eyecolor1 = atoi(row[56]);
-		temp_npctype_data->eyecolor2 = atoi(row[57]);
-		temp_npctype_data->beardcolor = atoi(row[58]);
-		temp_npctype_data->beard = atoi(row[59]);
-		temp_npctype_data->drakkin_heritage = atoi(row[60]);
-		temp_npctype_data->drakkin_tattoo = atoi(row[61]);
-		temp_npctype_data->drakkin_details = atoi(row[62]);
-
-		uint32 armor_tint_id = atoi(row[63]);
-
-		temp_npctype_data->armor_tint[0] = (atoi(row[64]) & 0xFF) << 16;
-        temp_npctype_data->armor_tint[0] |= (atoi(row[65]) & 0xFF) << 8;
-		temp_npctype_data->armor_tint[0] |= (atoi(row[66]) & 0xFF);
-		temp_npctype_data->armor_tint[0] |= (temp_npctype_data->armor_tint[0]) ? (0xFF << 24) : 0;
-
-		if (armor_tint_id != 0) {
-			std::string armortint_query = StringFormat(
-				"SELECT red1h, grn1h, blu1h, "
-				"red2c, grn2c, blu2c, "
-				"red3a, grn3a, blu3a, "
-				"red4b, grn4b, blu4b, "
-				"red5g, grn5g, blu5g, "
-				"red6l, grn6l, blu6l, "
-				"red7f, grn7f, blu7f, "
-				"red8x, grn8x, blu8x, "
-				"red9x, grn9x, blu9x "
-				"FROM npc_types_tint WHERE id = %d",
-				armor_tint_id);
-            auto armortint_results = QueryDatabase(armortint_query);
-            if (!armortint_results.Success() || armortint_results.RowCount() == 0)
-                armor_tint_id = 0;
-            else {
-                auto armorTint_row = armortint_results.begin();
-
-                for (int index = EmuConstants::MATERIAL_BEGIN; index <= EmuConstants::MATERIAL_END; index++) {
-                    temp_npctype_data->armor_tint[index] = atoi(armorTint_row[index * 3]) << 16;
-					temp_npctype_data->armor_tint[index] |= atoi(armorTint_row[index * 3 + 1]) << 8;
-					temp_npctype_data->armor_tint[index] |= atoi(armorTint_row[index * 3 + 2]);
-					temp_npctype_data->armor_tint[index] |= (temp_npctype_data->armor_tint[index]) ? (0xFF << 24) : 0;
-                }
-            }
-        }
-		// Try loading npc_types tint fields if armor tint is 0 or query failed to get results
-		if (armor_tint_id == 0) {
-			for (int index = MaterialChest; index < _MaterialCount; index++) {
-				temp_npctype_data->armor_tint[index] = temp_npctype_data->armor_tint[0];
-			}
-		}
-
-		temp_npctype_data->see_invis = atoi(row[67]);
-		temp_npctype_data->see_invis_undead = atoi(row[68]) == 0? false: true;	// Set see_invis_undead flag
-
-		if (row[69] != nullptr)
-			strn0cpy(temp_npctype_data->lastname, row[69], 32);
-
-		temp_npctype_data->qglobal = atoi(row[70]) == 0? false: true;	// qglobal
-		temp_npctype_data->AC = atoi(row[71]);
-		temp_npctype_data->npc_aggro = atoi(row[72]) == 0? false: true;
-		temp_npctype_data->spawn_limit = atoi(row[73]);
-		temp_npctype_data->see_hide = atoi(row[74]) == 0? false: true;
-		temp_npctype_data->see_improved_hide = atoi(row[75]) == 0? false: true;
-		temp_npctype_data->ATK = atoi(row[76]);
-		temp_npctype_data->accuracy_rating = atoi(row[77]);
-		temp_npctype_data->avoidance_rating = atoi(row[78]);
-		temp_npctype_data->slow_mitigation = atoi(row[79]);
-		temp_npctype_data->maxlevel = atoi(row[80]);
-		temp_npctype_data->scalerate = atoi(row[81]);
-		temp_npctype_data->private_corpse = atoi(row[82]) == 1 ? true: false;
-		temp_npctype_data->unique_spawn_by_name = atoi(row[83]) == 1 ? true: false;
-		temp_npctype_data->underwater = atoi(row[84]) == 1 ? true: false;
-		temp_npctype_data->emoteid = atoi(row[85]);
-		temp_npctype_data->spellscale = atoi(row[86]);
-		temp_npctype_data->healscale = atoi(row[87]);
-		temp_npctype_data->no_target_hotkey = atoi(row[88]) == 1 ? true: false;
-		temp_npctype_data->raid_target = atoi(row[89]) == 0 ? false: true;
-		temp_npctype_data->attack_delay = atoi(row[90]);
-		temp_npctype_data->light = (atoi(row[91]) & 0x0F);
-
-		temp_npctype_data->armtexture = atoi(row[92]);
-		temp_npctype_data->bracertexture = atoi(row[93]);
-		temp_npctype_data->handtexture = atoi(row[94]);
-		temp_npctype_data->legtexture = atoi(row[95]);
-		temp_npctype_data->feettexture = atoi(row[96]);
+		LoadNPCTypeRow(temp_npctype_data, row);
 
 		// If NPC with duplicate NPC id already in table,
 		// free item we attempted to add.
@@ -2658,12 +2448,13 @@ void ZoneDatabase::SaveMerchantTemp(uint32 npcid, uint32 slot, uint32 item, uint
 
 	std::string query = StringFormat("REPLACE INTO merchantlist_temp (npcid, slot, itemid, charges) "
                                     "VALUES(%d, %d, %d, %d)", npcid, slot, item, charges);
-    QueryDatabase(query);
+	// only read back when the zone boots, nothing here waits on it
+	QueryDatabaseAsync(query, npcid);
 }
 
 void ZoneDatabase::DeleteMerchantTemp(uint32 npcid, uint32 slot){
 	std::string query = StringFormat("DELETE FROM merchantlist_temp WHERE npcid=%d AND slot=%d", npcid, slot);
-	QueryDatabase(query);
+	QueryDatabaseAsync(query, npcid);
 }
 
 bool ZoneDatabase::UpdateZoneSafeCoords(const char* zonename, const glm::vec3& location) {
@@ -2941,6 +2732,8 @@ void ZoneDatabase::InsertDoor(uint32 ddoordbid, uint16 ddoorid, const char* ddoo
                                     ddoor_name, position.x, position.y, position.z, position.w,
                                     dopentype, dguildid, dlockpick, dkeyitem, ddoor_param, dinvert, dincline, dsize);
     QueryDatabase(query);
+
+	zone->DropContentPack();
 }
 
 void ZoneDatabase::LoadAltCurrencyValues(uint32 char_id, std::map<uint32, uint32> &currency) {
@@ -2968,28 +2761,42 @@ void ZoneDatabase::UpdateAltCurrencyValue(uint32 char_id, uint32 currency_id, ui
 
 void ZoneDatabase::SaveBuffs(Client *client) {
 
-	std::string query = StringFormat("DELETE FROM `character_buffs` WHERE `character_id` = '%u'", client->CharacterID());
-	database.QueryDatabase(query);
+	// written in the background, LoadBuffs and the client's destructor wait for them
+	std::vector<std::string> queries;
+	BuffsQueries(client, queries);
+	QueryDatabaseBatchAsync(queries, client->CharacterID());
+}
+
+void ZoneDatabase::BuffsQueries(Client *client, std::vector<std::string> &queries) {
+
+	queries.push_back(StringFormat("DELETE FROM `character_buffs` WHERE `character_id` = '%u'", client->CharacterID()));
 
 	uint32 buff_count = client->GetMaxBuffSlots();
 	Buffs_Struct *buffs = client->GetBuffs();
 
+	std::string query;
 	for (int index = 0; index < buff_count; index++) {
 		if(buffs[index].spellid == SPELL_UNKNOWN)
             continue;
 
-		query = StringFormat("INSERT INTO `character_buffs` (character_id, slot_id, spell_id, "
+		if (query.empty())
+			query = "INSERT INTO `character_buffs` (character_id, slot_id, spell_id, "
                             "caster_level, caster_name, ticsremaining, counters, numhits, melee_rune, "
-                            "magic_rune, persistent, dot_rune, caston_x, caston_y, caston_z, ExtraDIChance) "
-                            "VALUES('%u', '%u', '%u', '%u', '%s', '%u', '%u', '%u', '%u', '%u', '%u', '%u', "
+                            "magic_rune, persistent, dot_rune, caston_x, caston_y, caston_z, ExtraDIChance) VALUES";
+		else
+			query += ",";
+
+		query += StringFormat("('%u', '%u', '%u', '%u', '%s', '%u', '%u', '%u', '%u', '%u', '%u', '%u', "
                             "'%i', '%i', '%i', '%i')", client->CharacterID(), index, buffs[index].spellid,
                             buffs[index].casterlevel, buffs[index].caster_name, buffs[index].ticsremaining,
                             buffs[index].counters, buffs[index].numhits, buffs[index].melee_rune,
                             buffs[index].magic_rune, buffs[index].persistant_buff, buffs[index].dot_rune,
                             buffs[index].caston_x, buffs[index].caston_y, buffs[index].caston_z,
                             buffs[index].ExtraDIChance);
-       QueryDatabase(query);
 	}
+
+	if (!query.empty())
+		queries.push_back(query);
 }
 
 void ZoneDatabase::LoadBuffs(Client *client) {
@@ -3000,6 +2807,8 @@ void ZoneDatabase::LoadBuffs(Client *client) {
 	for(int index = 0; index < max_slots; ++index)
 		buffs[index].spellid = SPELL_UNKNOWN;
 
+	FlushAsyncQueries(client->CharacterID());
+
 	std::string query = StringFormat("SELECT spell_id, slot_id, caster_level, caster_name, ticsremaining, "
                                     "counters, numhits, melee_rune, magic_rune, persistent, dot_rune, "
                                     "caston_x, caston_y, caston_z, ExtraDIChance "
@@ -3086,34 +2895,37 @@ void ZoneDatabase::LoadBuffs(Client *client) {
 
 void ZoneDatabase::SavePetInfo(Client *client)
 {
-	PetInfo *petinfo = nullptr;
+	std::vector<std::string> queries;
+	PetInfoQueries(client, queries);
 
-	std::string query = StringFormat("DELETE FROM `character_pet_buffs` WHERE `char_id` = %u", client->CharacterID());
-	auto results = database.QueryDatabase(query);
-	if (!results.Success())
-		return;
+	for (auto &query : queries) {
+		auto results = database.QueryDatabase(query);
+		if (!results.Success())
+			return;
+	}
+}
 
-	query = StringFormat("DELETE FROM `character_pet_inventory` WHERE `char_id` = %u", client->CharacterID());
-	results = database.QueryDatabase(query);
-	if (!results.Success())
-		return;
+void ZoneDatabase::PetInfoQueries(Client *client, std::vector<std::string> &queries)
+{
+	PetInfo *petinfo = nullptr;
 
+	queries.push_back(StringFormat("DELETE FROM `character_pet_buffs` WHERE `char_id` = %u", client->CharacterID()));
+	queries.push_back(StringFormat("DELETE FROM `character_pet_inventory` WHERE `char_id` = %u", client->CharacterID()));
+
+	std::string query;
 	for (int pet = 0; pet < 2; pet++) {
 		petinfo = client->GetPetInfo(pet);
 		if (!petinfo)
 			continue;
 
-		query = StringFormat("INSERT INTO `character_pet_info` "
+		queries.push_back(StringFormat("INSERT INTO `character_pet_info` "
 				"(`char_id`, `pet`, `petname`, `petpower`, `spell_id`, `hp`, `mana`, `size`) "
 				"VALUES (%u, %u, '%s', %i, %u, %u, %u, %f) "
 				"ON DUPLICATE KEY UPDATE `petname` = '%s', `petpower` = %i, `spell_id` = %u, "
 				"`hp` = %u, `mana` = %u, `size` = %f",
 				client->CharacterID(), pet, petinfo->Name, petinfo->petpower, petinfo->SpellID,
 				petinfo->HP, petinfo->Mana, petinfo->size, // and now the ON DUPLICATE ENTRIES
-				petinfo->Name, petinfo->petpower, petinfo->SpellID, petinfo->HP, petinfo->Mana, petinfo->size);
-		results = database.QueryDatabase(query);
-		if (!results.Success())
-			return;
+				petinfo->Name, petinfo->petpower, petinfo->SpellID, petinfo->HP, petinfo->Mana, petinfo->size));
 		query.clear();
 
 		// pet buffs!
@@ -3134,7 +2946,8 @@ void ZoneDatabase::SavePetInfo(Client *client)
 						petinfo->Buffs[index].level, petinfo->Buffs[index].duration,
 						petinfo->Buffs[index].counters);
 		}
-		database.QueryDatabase(query);
+		if (!query.empty())
+			queries.push_back(query);
 		query.clear();
 
 		// pet inventory!
@@ -3150,7 +2963,9 @@ void ZoneDatabase::SavePetInfo(Client *client)
 			else
 				query += StringFormat(", (%u, %u, %u, %u)", client->CharacterID(), pet, index, petinfo->Items[index]);
 		}
-		database.QueryDatabase(query);
+		if (!query.empty())
+			queries.push_back(query);
+		query.clear();
 	}
 }
 
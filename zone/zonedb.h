@@ -252,9 +252,11 @@ public:
 	uint32	GetServerFilters(char* name, ServerSideFilters_Struct *ssfs);
 
 	void SaveBuffs(Client *c);
+	void BuffsQueries(Client *c, std::vector<std::string> &queries);
 	void LoadBuffs(Client *c);
 	void LoadPetInfo(Client *c);
 	void SavePetInfo(Client *c);
+	void PetInfoQueries(Client *c, std::vector<std::string> &queries);
 	void RemoveTempFactions(Client *c);
 	void UpdateItemRecastTimestamps(uint32 char_id, uint32 recast_type, uint32 timestamp);
 
@@ -290,6 +292,12 @@ public:
 	bool	SaveCharacterPotionBelt(uint32 character_id, uint8 potion_id, uint32 item_id, uint32 icon);
 	bool	SaveCharacterLeadershipAA(uint32 character_id, PlayerProfile_Struct* pp);
 
+	/* Character Data Save Statements, for batching saves  */
+	std::string	CharacterBindPointQuery(uint32 character_id, uint32 zone_id, uint32 instance_id, const glm::vec4& position, uint8 is_home);
+	std::string	CharacterCurrencyQuery(uint32 character_id, PlayerProfile_Struct* pp);
+	std::string	CharacterDataQuery(uint32 character_id, uint32 account_id, PlayerProfile_Struct* pp, ExtendedProfile_Struct* m_epp);
+	void		CharacterTributeQueries(uint32 character_id, PlayerProfile_Struct* pp, std::vector<std::string> &queries);
+
 	/* Character Data Deletes   */
 	bool	DeleteCharacterSpell(uint32 character_id, uint32 spell_id, uint32 slot_id);
 	bool	DeleteCharacterMemorizedSpell(uint32 character_id, uint32 spell_id, uint32 slot_id);
@@ -44,7 +44,7 @@ void Client::Handle_OP_ZoneChange(const EQApplicationPacket *app) {
 
 	zoning = true;
 	if (app->size != sizeof(ZoneChange_Struct)) {
-		Log.Out(Logs::General, Logs::None, "Wrong size: OP_ZoneChange, size=%d, expected %d", app->size, sizeof(ZoneChange_Struct));
+		Log.Out(Logs::General, Logs::None, "Wrong size: OP_ZoneChange, size=%d, expected %d", app->size, (int)sizeof(ZoneChange_Struct));
 		return;
 	}
 
@@ -737,7 +737,9 @@ void Client::SetBindPoint(int to_zone, int to_instance, const glm::vec3& locatio
 		m_pp.binds[0].z = location.z;
 	}
 	auto regularBindPoint = glm::vec4(m_pp.binds[0].x, m_pp.binds[0].y, m_pp.binds[0].z, 0.0f);
-	database.SaveCharacterBindPoint(this->CharacterID(), m_pp.binds[0].zoneId, m_pp.binds[0].instance_id, regularBindPoint, 0);
+	save_tracker->Begin();
+	save_tracker->Add(SaveRegularBindSection, database.CharacterBindPointQuery(this->CharacterID(), m_pp.binds[0].zoneId, m_pp.binds[0].instance_id, regularBindPoint, 0));
+	CommitSave(false);
 }
 
 void Client::GoToBind(uint8 bindnum) {